@@ -0,0 +1,679 @@
+//------------------------------------------------------------------------------
+// export_kmd.hpp
+//
+// Copyright (C) 2026 Lost Empire Entertainment
+//
+// This is free source code, and you are welcome to redistribute it under certain conditions.
+// Read LICENSE.md for more information.
+//
+// Provides:
+//   - Writing kalamodeldata binaries from in-memory model blocks with one gathered write
+//   - Streaming writer for models too large to hold in memory at once
+//   - Uses the structs and layout of import_kmd.hpp, written files import back bit-exactly
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+#include <array>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/uio.h>
+	#include <cerrno>
+#endif
+
+#include "import_kmd.hpp"
+
+namespace KalaHeaders::KalaModelData
+{
+	using std::vector;
+	using std::array;
+	using std::string;
+	using std::ofstream;
+	using std::filesystem::path;
+	using std::filesystem::remove;
+	using std::error_code;
+	using std::memcpy;
+	using std::min;
+
+	using u64 = uint64_t;
+
+	//The model table and vertex layouts are written straight from memory
+	static_assert(sizeof(ModelTable) == CORRECT_MODEL_TABLE_SIZE);
+	static_assert(sizeof(Vertex) == 48);
+
+	enum class ExportResult : u8
+	{
+		RESULT_SUCCESS                  = 0,  //No errors, succeeded with export
+
+		//
+		// FILE OPERATIONS
+		//
+
+		RESULT_INVALID_EXTENSION        = 1,  //File is not '.kmd'
+		RESULT_UNAUTHORIZED_WRITE       = 2,  //Not authorized to create or write this file
+		RESULT_UNKNOWN_WRITE_ERROR      = 3,  //Unknown file error when writing file
+
+		//
+		// EXPORT ERRORS
+		//
+
+		RESULT_INVALID_MODEL_COUNT      = 4,  //model count must be within range and match the written blocks
+		RESULT_INVALID_DATA_FLAGS       = 5,  //data flags must be within range
+		RESULT_INVALID_RENDER_TYPE      = 6,  //render type must be within range
+		RESULT_INVALID_MODEL_POSITION   = 7,  //model position must be within range
+		RESULT_INVALID_MODEL_ROTATION   = 8,  //model rotation must be within range
+		RESULT_INVALID_MODEL_SIZE       = 9,  //model size must be within range
+		RESULT_INVALID_MODEL_BLOCK_SIZE = 10, //blocks must fit in MAX_MODEL_BLOCK_SIZE
+		RESULT_INVALID_WRITER_STATE     = 11  //streaming writer calls were made out of order
+	};
+
+	inline constexpr string ExportResultToString(ExportResult result)
+	{
+		switch (result)
+		{
+		default: return "RESULT_UNKNOWN";
+
+		case ExportResult::RESULT_SUCCESS:
+			return "RESULT_SUCCESS";
+
+		case ExportResult::RESULT_INVALID_EXTENSION:
+			return "RESULT_INVALID_EXTENSION";
+		case ExportResult::RESULT_UNAUTHORIZED_WRITE:
+			return "RESULT_UNAUTHORIZED_WRITE";
+		case ExportResult::RESULT_UNKNOWN_WRITE_ERROR:
+			return "RESULT_UNKNOWN_WRITE_ERROR";
+
+		case ExportResult::RESULT_INVALID_MODEL_COUNT:
+			return "RESULT_INVALID_MODEL_COUNT";
+		case ExportResult::RESULT_INVALID_DATA_FLAGS:
+			return "RESULT_INVALID_DATA_FLAGS";
+		case ExportResult::RESULT_INVALID_RENDER_TYPE:
+			return "RESULT_INVALID_RENDER_TYPE";
+		case ExportResult::RESULT_INVALID_MODEL_POSITION:
+			return "RESULT_INVALID_MODEL_POSITION";
+		case ExportResult::RESULT_INVALID_MODEL_ROTATION:
+			return "RESULT_INVALID_MODEL_ROTATION";
+		case ExportResult::RESULT_INVALID_MODEL_SIZE:
+			return "RESULT_INVALID_MODEL_SIZE";
+		case ExportResult::RESULT_INVALID_MODEL_BLOCK_SIZE:
+			return "RESULT_INVALID_MODEL_BLOCK_SIZE";
+		case ExportResult::RESULT_INVALID_WRITER_STATE:
+			return "RESULT_INVALID_WRITER_STATE";
+		}
+
+		return "RESULT_UNKNOWN";
+	}
+
+	//One contiguous range of bytes of a gathered write
+	struct WriteSegment
+	{
+		const void* data{};
+		size_t size{};
+	};
+
+	//Write-only file that writes a list of segments without joining them first.
+	//Uses writev on posix, on windows the segments go through one ofstream back to back
+	//since WriteFileGather only accepts page aligned unbuffered writes
+	class GatherFile
+	{
+	public:
+		GatherFile() = default;
+		~GatherFile() { Close(); }
+
+		GatherFile(const GatherFile&) = delete;
+		GatherFile& operator=(const GatherFile&) = delete;
+
+		//Creates or truncates outFile
+		ExportResult Open(const path& outFile)
+		{
+			Close();
+
+#ifdef _WIN32
+			out.open(outFile, ios::out | ios::binary | ios::trunc);
+			if (!out) return ExportResult::RESULT_UNAUTHORIZED_WRITE;
+#else
+			fd = ::open(
+				outFile.c_str(),
+				O_WRONLY | O_CREAT | O_TRUNC,
+				0644);
+			if (fd < 0)
+			{
+				return errno == EACCES || errno == EPERM || errno == EROFS
+					? ExportResult::RESULT_UNAUTHORIZED_WRITE
+					: ExportResult::RESULT_UNKNOWN_WRITE_ERROR;
+			}
+#endif
+			return ExportResult::RESULT_SUCCESS;
+		}
+
+		bool IsOpen() const
+		{
+#ifdef _WIN32
+			return out.is_open();
+#else
+			return fd >= 0;
+#endif
+		}
+
+		//Writes every segment in order at the current position
+		ExportResult Write(const vector<WriteSegment>& segments)
+		{
+			if (!IsOpen()) return ExportResult::RESULT_INVALID_WRITER_STATE;
+
+#ifdef _WIN32
+			for (const WriteSegment& s : segments)
+			{
+				out.write(
+					scast<const char*>(s.data),
+					scast<streamsize>(s.size));
+			}
+			if (!out) return ExportResult::RESULT_UNKNOWN_WRITE_ERROR;
+#else
+			vector<iovec> vecs{};
+			vecs.reserve(segments.size());
+			for (const WriteSegment& s : segments)
+			{
+				if (s.size == 0) continue;
+				vecs.push_back({ const_cast<void*>(s.data), s.size });
+			}
+
+			//writev takes at most IOV_MAX segments and may stop early, the rest is resubmitted
+			size_t first{};
+			while (first < vecs.size())
+			{
+				int count = scast<int>(min(vecs.size() - first, scast<size_t>(IOV_MAX)));
+
+				ssize_t written = ::writev(fd, vecs.data() + first, count);
+				if (written < 0)
+				{
+					if (errno == EINTR) continue;
+					return ExportResult::RESULT_UNKNOWN_WRITE_ERROR;
+				}
+
+				size_t remaining = scast<size_t>(written);
+				while (first < vecs.size()
+					&& remaining >= vecs[first].iov_len)
+				{
+					remaining -= vecs[first].iov_len;
+					++first;
+				}
+				if (remaining > 0)
+				{
+					vecs[first].iov_base = scast<u8*>(vecs[first].iov_base) + remaining;
+					vecs[first].iov_len -= remaining;
+				}
+			}
+#endif
+			return ExportResult::RESULT_SUCCESS;
+		}
+
+		//Moves the write position to offset from the start of the file
+		ExportResult Seek(u64 offset)
+		{
+			if (!IsOpen()) return ExportResult::RESULT_INVALID_WRITER_STATE;
+
+#ifdef _WIN32
+			out.seekp(scast<streamoff>(offset));
+			if (!out) return ExportResult::RESULT_UNKNOWN_WRITE_ERROR;
+#else
+			if (::lseek(fd, scast<off_t>(offset), SEEK_SET) < 0) return ExportResult::RESULT_UNKNOWN_WRITE_ERROR;
+#endif
+			return ExportResult::RESULT_SUCCESS;
+		}
+
+		//Flushes and closes the file, fails if buffered data could not be written
+		ExportResult Close()
+		{
+			ExportResult result = ExportResult::RESULT_SUCCESS;
+
+#ifdef _WIN32
+			if (out.is_open())
+			{
+				out.close();
+				if (out.fail()) result = ExportResult::RESULT_UNKNOWN_WRITE_ERROR;
+				out.clear();
+			}
+#else
+			if (fd >= 0)
+			{
+				if (::close(fd) != 0) result = ExportResult::RESULT_UNKNOWN_WRITE_ERROR;
+				fd = -1;
+			}
+#endif
+			return result;
+		}
+	private:
+#ifdef _WIN32
+		ofstream out{};
+#else
+		int fd = -1;
+#endif
+	};
+
+	//Checks the same ranges ParseBlockData rejects on import
+	inline ExportResult ValidateBlock(const ModelBlock& block)
+	{
+		if (block.dataTypeFlags & ~0b00011111) return ExportResult::RESULT_INVALID_DATA_FLAGS;
+		if (block.renderType > 2) return ExportResult::RESULT_INVALID_RENDER_TYPE;
+
+		for (f32 v : block.position)
+		{
+			if (v < MIN_POS || v > MAX_POS) return ExportResult::RESULT_INVALID_MODEL_POSITION;
+		}
+		for (f32 v : block.rotation)
+		{
+			if (v < MIN_ROT || v > MAX_ROT) return ExportResult::RESULT_INVALID_MODEL_ROTATION;
+		}
+		for (f32 v : block.size)
+		{
+			if (v < MIN_SIZE || v > MAX_SIZE) return ExportResult::RESULT_INVALID_MODEL_SIZE;
+		}
+
+		return ExportResult::RESULT_SUCCESS;
+	}
+
+	//Size of a block holding vertexCount vertices and indexCount indices
+	inline u64 GetBlockSize(
+		u64 vertexCount,
+		u64 indexCount)
+	{
+		return VERTICE_DATA_OFFSET
+			+ vertexCount * sizeof(Vertex)
+			+ indexCount * sizeof(u32);
+	}
+
+	//Serializes the top header into the first CORRECT_MODEL_HEADER_SIZE bytes of outData
+	inline void BuildHeaderData(
+		const ModelHeader& header,
+		u8* outData)
+	{
+		memcpy(outData + 0,  &header.magic,           sizeof(u32));
+		memcpy(outData + 4,  &header.version,         sizeof(u8));
+		memcpy(outData + 5,  &header.scaleFactor,     sizeof(u8));
+		memcpy(outData + 6,  &header.modelCount,      sizeof(u32));
+		memcpy(outData + 10, &header.modelTablesSize, sizeof(u32));
+		memcpy(outData + 14, &header.modelBlocksSize, sizeof(u32));
+	}
+
+	//Serializes everything of a block before its vertex data into the first VERTICE_DATA_OFFSET bytes
+	//of outData. The vertex and index sizes come from the counts, the stored offsets are kept as they are
+	inline void BuildBlockData(
+		const ModelBlock& block,
+		u32 vertexCount,
+		u32 indexCount,
+		u8* outData)
+	{
+		u32 verticesSize = vertexCount * scast<u32>(sizeof(Vertex));
+		u32 indicesSize = indexCount * scast<u32>(sizeof(u32));
+
+		memcpy(outData + 0,   block.nodeName,        20);
+		memcpy(outData + 20,  block.meshName,        20);
+		memcpy(outData + 40,  block.nodePath,        50);
+		memcpy(outData + 90,  &block.dataTypeFlags,  sizeof(u8));
+		memcpy(outData + 91,  &block.renderType,     sizeof(u8));
+		memcpy(outData + 92,  block.position,        sizeof(block.position));
+		memcpy(outData + 104, block.rotation,        sizeof(block.rotation));
+		memcpy(outData + 120, block.size,            sizeof(block.size));
+		memcpy(outData + 132, &block.verticesOffset, sizeof(u32));
+		memcpy(outData + 136, &verticesSize,         sizeof(u32));
+		memcpy(outData + 140, &block.indicesOffset,  sizeof(u32));
+		memcpy(outData + 144, &indicesSize,          sizeof(u32));
+	}
+
+	//Writes a kmd file from inBlocks with one gathered write. Vertex and index data
+	//is written straight from the blocks, only the header, tables and the fixed part
+	//of each block are built on the side. Removes the file again if anything fails
+	inline ExportResult ExportKMD(
+		const path& outFile,
+		const vector<ModelBlock>& inBlocks,
+		u8 scaleFactor = 0)
+	{
+		if (!outFile.has_extension()
+			|| outFile.extension() != ".kmd")
+		{
+			return ExportResult::RESULT_INVALID_EXTENSION;
+		}
+
+		if (inBlocks.empty()
+			|| inBlocks.size() > MAX_MODEL_COUNT)
+		{
+			return ExportResult::RESULT_INVALID_MODEL_COUNT;
+		}
+
+		ModelHeader header{};
+		header.scaleFactor = scaleFactor;
+		header.modelCount = scast<u32>(inBlocks.size());
+		header.modelTablesSize = header.modelCount * CORRECT_MODEL_TABLE_SIZE;
+
+		u64 blockOffset = CORRECT_MODEL_HEADER_SIZE + u64{ header.modelTablesSize };
+		u64 blocksSize{};
+
+		vector<ModelTable> tables(inBlocks.size());
+		vector<array<u8, VERTICE_DATA_OFFSET>> blockData(inBlocks.size());
+
+		for (size_t i = 0; i < inBlocks.size(); ++i)
+		{
+			const ModelBlock& b = inBlocks[i];
+
+			ExportResult validResult = ValidateBlock(b);
+			if (validResult != ExportResult::RESULT_SUCCESS) return validResult;
+
+			u64 blockSize = GetBlockSize(b.vertices.size(), b.indices.size());
+			if (blocksSize + blockSize > MAX_MODEL_BLOCK_SIZE) return ExportResult::RESULT_INVALID_MODEL_BLOCK_SIZE;
+
+			memcpy(tables[i].nodeName, b.nodeName, sizeof(tables[i].nodeName));
+			tables[i].blockOffset = scast<u32>(blockOffset + blocksSize);
+			tables[i].blockSize = scast<u32>(blockSize);
+
+			BuildBlockData(
+				b,
+				scast<u32>(b.vertices.size()),
+				scast<u32>(b.indices.size()),
+				blockData[i].data());
+
+			blocksSize += blockSize;
+		}
+
+		header.modelBlocksSize = scast<u32>(blocksSize);
+
+		array<u8, CORRECT_MODEL_HEADER_SIZE> headerData{};
+		BuildHeaderData(header, headerData.data());
+
+		vector<WriteSegment> segments{};
+		segments.reserve(2 + inBlocks.size() * 3);
+
+		segments.push_back({ headerData.data(), headerData.size() });
+		segments.push_back({ tables.data(), tables.size() * sizeof(ModelTable) });
+
+		for (size_t i = 0; i < inBlocks.size(); ++i)
+		{
+			const ModelBlock& b = inBlocks[i];
+
+			segments.push_back({ blockData[i].data(), blockData[i].size() });
+			segments.push_back({ b.vertices.data(), b.vertices.size() * sizeof(Vertex) });
+			segments.push_back({ b.indices.data(), b.indices.size() * sizeof(u32) });
+		}
+
+		try
+		{
+			GatherFile file{};
+
+			ExportResult result = file.Open(outFile);
+			if (result != ExportResult::RESULT_SUCCESS) return result;
+
+			result = file.Write(segments);
+			ExportResult closeResult = file.Close();
+			if (result == ExportResult::RESULT_SUCCESS) result = closeResult;
+
+			if (result != ExportResult::RESULT_SUCCESS)
+			{
+				error_code ec{};
+				remove(outFile, ec);
+			}
+
+			return result;
+		}
+		catch (...)
+		{
+			error_code ec{};
+			remove(outFile, ec);
+
+			return ExportResult::RESULT_UNKNOWN_WRITE_ERROR;
+		}
+	}
+
+	//Writes a kmd file one block at a time so only one block, or one chunk of a block,
+	//has to be in memory. The table region is reserved up front from the model count
+	//and filled in together with the header by Close. Either add whole blocks with AddBlock,
+	//or stream one with BeginBlock, any number of WriteVertices and WriteIndices calls and EndBlock.
+	//The file is removed again if the writer is destroyed or closed before every block was written
+	class KmdStreamWriter
+	{
+	public:
+		KmdStreamWriter() = default;
+		~KmdStreamWriter() { Abort(); }
+
+		KmdStreamWriter(const KmdStreamWriter&) = delete;
+		KmdStreamWriter& operator=(const KmdStreamWriter&) = delete;
+
+		ExportResult Open(
+			const path& outFile,
+			u32 modelCount,
+			u8 scaleFactor = 0)
+		{
+			if (file.IsOpen()) return ExportResult::RESULT_INVALID_WRITER_STATE;
+
+			if (!outFile.has_extension()
+				|| outFile.extension() != ".kmd")
+			{
+				return ExportResult::RESULT_INVALID_EXTENSION;
+			}
+
+			if (modelCount == 0
+				|| modelCount > MAX_MODEL_COUNT)
+			{
+				return ExportResult::RESULT_INVALID_MODEL_COUNT;
+			}
+
+			ExportResult result = file.Open(outFile);
+			if (result != ExportResult::RESULT_SUCCESS) return result;
+
+			filePath = outFile;
+
+			header = {};
+			header.scaleFactor = scaleFactor;
+			header.modelCount = modelCount;
+			header.modelTablesSize = modelCount * CORRECT_MODEL_TABLE_SIZE;
+
+			tables.clear();
+			tables.reserve(modelCount);
+
+			blocksSize = 0;
+			isInBlock = false;
+
+			//header and tables are written last, blocks start right after them
+			return Fail(file.Seek(CORRECT_MODEL_HEADER_SIZE + u64{ header.modelTablesSize }));
+		}
+
+		bool IsOpen() const { return file.IsOpen(); }
+
+		//Writes a whole block with one gathered write
+		ExportResult AddBlock(const ModelBlock& block)
+		{
+			ExportResult result = StartBlock(
+				block,
+				block.vertices.size(),
+				block.indices.size());
+			if (result != ExportResult::RESULT_SUCCESS) return result;
+
+			isInBlock = false;
+
+			return Fail(file.Write({
+				{ blockData.data(), blockData.size() },
+				{ block.vertices.data(), block.vertices.size() * sizeof(Vertex) },
+				{ block.indices.data(), block.indices.size() * sizeof(u32) } }));
+		}
+
+		//Starts a block that will hold exactly vertexCount vertices and indexCount indices,
+		//everything but the vertices and indices of info is written now
+		ExportResult BeginBlock(
+			const ModelBlock& info,
+			u32 vertexCount,
+			u32 indexCount)
+		{
+			ExportResult result = StartBlock(
+				info,
+				vertexCount,
+				indexCount);
+			if (result != ExportResult::RESULT_SUCCESS) return result;
+
+			return Fail(file.Write({ { blockData.data(), blockData.size() } }));
+		}
+
+		//Appends vertices to the open block, every vertex must come before the first index
+		ExportResult WriteVertices(
+			const Vertex* vertices,
+			size_t count)
+		{
+			if (!isInBlock
+				|| indicesLeft != totalIndices
+				|| count > verticesLeft)
+			{
+				return Fail(ExportResult::RESULT_INVALID_WRITER_STATE);
+			}
+
+			verticesLeft -= count;
+
+			return Fail(file.Write({ { vertices, count * sizeof(Vertex) } }));
+		}
+
+		//Appends indices to the open block
+		ExportResult WriteIndices(
+			const u32* indices,
+			size_t count)
+		{
+			if (!isInBlock
+				|| verticesLeft != 0
+				|| count > indicesLeft)
+			{
+				return Fail(ExportResult::RESULT_INVALID_WRITER_STATE);
+			}
+
+			indicesLeft -= count;
+
+			return Fail(file.Write({ { indices, count * sizeof(u32) } }));
+		}
+
+		//Fails if the block got fewer vertices or indices than BeginBlock promised
+		ExportResult EndBlock()
+		{
+			if (!isInBlock
+				|| verticesLeft != 0
+				|| indicesLeft != 0)
+			{
+				return Fail(ExportResult::RESULT_INVALID_WRITER_STATE);
+			}
+
+			isInBlock = false;
+
+			return ExportResult::RESULT_SUCCESS;
+		}
+
+		//Writes the header and tables and closes the file,
+		//fails and removes the file if fewer blocks than the model count were written
+		ExportResult Close()
+		{
+			if (!file.IsOpen()) return ExportResult::RESULT_INVALID_WRITER_STATE;
+
+			if (isInBlock
+				|| tables.size() != header.modelCount)
+			{
+				return Fail(ExportResult::RESULT_INVALID_MODEL_COUNT);
+			}
+
+			header.modelBlocksSize = scast<u32>(blocksSize);
+
+			array<u8, CORRECT_MODEL_HEADER_SIZE> headerData{};
+			BuildHeaderData(header, headerData.data());
+
+			ExportResult result = file.Seek(0);
+			if (result == ExportResult::RESULT_SUCCESS)
+			{
+				result = file.Write({
+					{ headerData.data(), headerData.size() },
+					{ tables.data(), tables.size() * sizeof(ModelTable) } });
+			}
+
+			ExportResult closeResult = file.Close();
+			if (result == ExportResult::RESULT_SUCCESS) result = closeResult;
+
+			if (result != ExportResult::RESULT_SUCCESS)
+			{
+				error_code ec{};
+				remove(filePath, ec);
+			}
+
+			return result;
+		}
+
+		//Closes and removes an unfinished file
+		void Abort()
+		{
+			if (!file.IsOpen()) return;
+
+			file.Close();
+
+			error_code ec{};
+			remove(filePath, ec);
+		}
+	private:
+		ExportResult StartBlock(
+			const ModelBlock& info,
+			u64 vertexCount,
+			u64 indexCount)
+		{
+			if (!file.IsOpen()
+				|| isInBlock)
+			{
+				return ExportResult::RESULT_INVALID_WRITER_STATE;
+			}
+			if (tables.size() == header.modelCount) return Fail(ExportResult::RESULT_INVALID_MODEL_COUNT);
+
+			ExportResult validResult = ValidateBlock(info);
+			if (validResult != ExportResult::RESULT_SUCCESS) return Fail(validResult);
+
+			u64 blockSize = GetBlockSize(vertexCount, indexCount);
+			if (blocksSize + blockSize > MAX_MODEL_BLOCK_SIZE) return Fail(ExportResult::RESULT_INVALID_MODEL_BLOCK_SIZE);
+
+			ModelTable& t = tables.emplace_back();
+			memcpy(t.nodeName, info.nodeName, sizeof(t.nodeName));
+			t.blockOffset = scast<u32>(CORRECT_MODEL_HEADER_SIZE + u64{ header.modelTablesSize } + blocksSize);
+			t.blockSize = scast<u32>(blockSize);
+
+			BuildBlockData(
+				info,
+				scast<u32>(vertexCount),
+				scast<u32>(indexCount),
+				blockData.data());
+
+			blocksSize += blockSize;
+
+			verticesLeft = vertexCount;
+			indicesLeft = indexCount;
+			totalIndices = indexCount;
+			isInBlock = true;
+
+			return ExportResult::RESULT_SUCCESS;
+		}
+
+		//Aborts the file on any error so a broken kmd is never left behind
+		ExportResult Fail(ExportResult result)
+		{
+			if (result != ExportResult::RESULT_SUCCESS) Abort();
+			return result;
+		}
+
+		GatherFile file{};
+		path filePath{};
+
+		ModelHeader header{};
+		vector<ModelTable> tables{};
+		u64 blocksSize{};
+
+		array<u8, VERTICE_DATA_OFFSET> blockData{};
+
+		bool isInBlock{};
+		u64 verticesLeft{};
+		u64 indicesLeft{};
+		u64 totalIndices{};
+	};
+}
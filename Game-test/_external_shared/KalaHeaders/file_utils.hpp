@@ -11,6 +11,7 @@
 //   - file metadata - file size, directory size, line count, set extension
 //   - text I/O - read/write data for text files with vector of string lines or string blob
 //   - binary I/O - read/write data for binary files with vector of bytes or buffer + size
+//   - file hashing - 64-bit content hash of a whole file through a read-only mapping
 //------------------------------------------------------------------------------
 
 #pragma once
@@ -24,6 +25,17 @@
 #include <cerrno>
 #include <cstring>
 
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#include "hash_utils.hpp"
+
 //reinterpret_cast
 #ifndef rcast
 	#define rcast reinterpret_cast
@@ -67,12 +79,15 @@ namespace KalaHeaders::KalaFile
 	using std::filesystem::status;
 	using std::filesystem::perms;
 	
+	using KalaHeaders::KalaHash::HashBytes64;
+
 	using u8 = uint8_t;
 	using u16 = uint16_t;
 	using u32 = uint32_t;
 	using i8 = int8_t;
 	using i16 = int16_t;
 	using i32 = int32_t;
+	using u64 = uint64_t;
 
 	inline constexpr size_t TEN_MB = 10ULL * 1024 * 1024;
 	inline constexpr size_t ONE_GB = 1ULL * 1024 * 1024 * 1024;
@@ -2423,4 +2438,176 @@ namespace KalaHeaders::KalaFile
 
 		return{};
 	}
+
+	//
+	// FILE HASHING
+	//
+
+	//Hash the whole target file with HashBytes64 from hash_utils.hpp. The file is mapped
+	//read-only instead of read into memory, so hashing runs at the speed the os pages it in.
+	//Gives the same hash as HashBytes64 over the file contents, empty files included
+	inline string HashFile(
+		const path& target,
+		u64& outHash,
+		u64 seed = 0)
+	{
+		ostringstream oss{};
+
+		if (!exists(target))
+		{
+			oss << "Failed to hash target file '" << target << "' because it does not exist!";
+
+			return oss.str();
+		}
+		if (!is_regular_file(target))
+		{
+			oss << "Failed to hash target file '" << target << "' because it is not a regular file!";
+
+			return oss.str();
+		}
+
+#ifdef _WIN32
+		HANDLE file = CreateFileW(
+			target.wstring().c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			oss << "Failed to hash target file '" << target
+				<< "' because it couldn't be opened! Reason: (error " << GetLastError() << ")";
+
+			return oss.str();
+		}
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size))
+		{
+			oss << "Failed to hash target file '" << target
+				<< "' because its size couldn't be read! Reason: (error " << GetLastError() << ")";
+
+			CloseHandle(file);
+			return oss.str();
+		}
+
+		//empty files can't be mapped
+		if (size.QuadPart == 0)
+		{
+			CloseHandle(file);
+
+			outHash = HashBytes64(nullptr, 0, seed);
+			return{};
+		}
+
+		HANDLE mapping = CreateFileMappingW(
+			file,
+			nullptr,
+			PAGE_READONLY,
+			0,
+			0,
+			nullptr);
+
+		if (!mapping)
+		{
+			oss << "Failed to hash target file '" << target
+				<< "' because it couldn't be mapped! Reason: (error " << GetLastError() << ")";
+
+			CloseHandle(file);
+			return oss.str();
+		}
+
+		const void* view = MapViewOfFile(
+			mapping,
+			FILE_MAP_READ,
+			0,
+			0,
+			0);
+
+		if (!view)
+		{
+			oss << "Failed to hash target file '" << target
+				<< "' because it couldn't be mapped! Reason: (error " << GetLastError() << ")";
+
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return oss.str();
+		}
+
+		outHash = HashBytes64(view, scast<size_t>(size.QuadPart), seed);
+
+		UnmapViewOfFile(view);
+		CloseHandle(mapping);
+		CloseHandle(file);
+#else
+		int fd = ::open(target.c_str(), O_RDONLY);
+		if (fd == -1)
+		{
+			int err = errno;
+
+			oss << "Failed to hash target file '" << target
+				<< "' because it couldn't be opened! "
+				<< "Reason: (errno " << err << "): " << strerror(err);
+
+			return oss.str();
+		}
+
+		struct stat info{};
+		if (::fstat(fd, &info) != 0)
+		{
+			int err = errno;
+
+			oss << "Failed to hash target file '" << target
+				<< "' because its size couldn't be read! "
+				<< "Reason: (errno " << err << "): " << strerror(err);
+
+			::close(fd);
+			return oss.str();
+		}
+
+		size_t size = scast<size_t>(info.st_size);
+
+		//empty files can't be mapped
+		if (size == 0)
+		{
+			::close(fd);
+
+			outHash = HashBytes64(nullptr, 0, seed);
+			return{};
+		}
+
+		void* view = ::mmap(
+			nullptr,
+			size,
+			PROT_READ,
+			MAP_PRIVATE,
+			fd,
+			0);
+
+		if (view == MAP_FAILED)
+		{
+			int err = errno;
+
+			oss << "Failed to hash target file '" << target
+				<< "' because it couldn't be mapped! "
+				<< "Reason: (errno " << err << "): " << strerror(err);
+
+			::close(fd);
+			return oss.str();
+		}
+
+		//the file is read front to back once
+		::madvise(view, size, MADV_SEQUENTIAL);
+
+		outHash = HashBytes64(view, size, seed);
+
+		::munmap(view, size);
+		::close(fd);
+#endif
+
+		return{};
+	}
 }
\ No newline at end of file
@@ -0,0 +1,997 @@
+//------------------------------------------------------------------------------
+// hash_utils.hpp
+//
+// Copyright (C) 2026 Lost Empire Entertainment
+//
+// This is free source code, and you are welcome to redistribute it under certain conditions.
+// Read LICENSE.md for more information.
+//
+// Provides:
+//   - 64-bit and 128-bit non-cryptographic content hashing, bit compatible with XXH3 of xxHash 0.8
+//   - one-shot hashing of buffers and strings, incremental hashing with HashStream
+//   - SSE2 and AVX2 paths for inputs over 240 bytes, AVX2 is picked at runtime when the cpu has it
+//   - stable results across runs, platforms and paths so hashes can be stored inside files
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <bit>
+
+#if (defined(_M_X64) || defined(__x86_64__)) && !defined(KALA_HASH_SCALAR)
+	#define KALA_HASH_X64 1
+	#include <immintrin.h>
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+		//msvc allows avx2 intrinsics in any function
+		#define KALA_HASH_TARGET_AVX2
+	#else
+		#define KALA_HASH_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+//reinterpret_cast
+#ifndef rcast
+	#define rcast reinterpret_cast
+#endif
+
+//static_cast
+#ifndef scast
+	#define scast static_cast
+#endif
+
+namespace KalaHeaders::KalaHash
+{
+	using std::string_view;
+	using std::memcpy;
+	using std::endian;
+
+	using u8 = uint8_t;
+	using u32 = uint32_t;
+	using u64 = uint64_t;
+
+	struct Hash128
+	{
+		u64 low{};
+		u64 high{};
+
+		bool operator==(const Hash128& other) const = default;
+	};
+
+	enum class HashPath : u8
+	{
+		PATH_SCALAR,
+		PATH_SSE2,
+		PATH_AVX2
+	};
+
+	namespace Detail
+	{
+		inline constexpr u32 PRIME32_1 = 0x9E3779B1U;
+		inline constexpr u32 PRIME32_2 = 0x85EBCA77U;
+		inline constexpr u32 PRIME32_3 = 0xC2B2AE3DU;
+
+		inline constexpr u64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+		inline constexpr u64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+		inline constexpr u64 PRIME64_3 = 0x165667B19E3779F9ULL;
+		inline constexpr u64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+		inline constexpr u64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+		inline constexpr u64 PRIME_MX1 = 0x165667919E3779F9ULL;
+		inline constexpr u64 PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+		inline constexpr size_t STRIPE_LEN = 64;
+		inline constexpr size_t SECRET_SIZE = 192;
+		inline constexpr size_t SECRET_CONSUME_RATE = 8;
+		inline constexpr size_t STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+		inline constexpr size_t BLOCK_LEN = STRIPE_LEN * STRIPES_PER_BLOCK;
+
+		inline constexpr size_t MIDSIZE_MAX = 240;
+		inline constexpr size_t MIDSIZE_STARTOFFSET = 3;
+		inline constexpr size_t MIDSIZE_LASTOFFSET = 17;
+		inline constexpr size_t SECRET_SIZE_MIN = 136;
+		inline constexpr size_t SECRET_LASTACC_START = 7;
+		inline constexpr size_t SECRET_MERGEACCS_START = 11;
+
+		//streaming input is buffered in whole blocks of stripes
+		inline constexpr size_t STREAM_BUFFER_SIZE = 256;
+		inline constexpr size_t STREAM_BUFFER_STRIPES = STREAM_BUFFER_SIZE / STRIPE_LEN;
+
+		alignas(64) inline constexpr u8 DEFAULT_SECRET[SECRET_SIZE] =
+		{
+			0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+			0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+			0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+			0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+			0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+			0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+			0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+			0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+			0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+			0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+			0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+			0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+		};
+
+		inline constexpr u64 INIT_ACC[8] =
+		{
+			PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+			PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1
+		};
+
+		inline constexpr u32 Swap32(u32 v)
+		{
+			return ((v << 24) & 0xFF000000U)
+				| ((v << 8) & 0x00FF0000U)
+				| ((v >> 8) & 0x0000FF00U)
+				| ((v >> 24) & 0x000000FFU);
+		}
+		inline constexpr u64 Swap64(u64 v)
+		{
+			return (scast<u64>(Swap32(scast<u32>(v))) << 32)
+				| Swap32(scast<u32>(v >> 32));
+		}
+
+		inline constexpr u32 Rotl32(u32 v, u32 r) { return (v << r) | (v >> (32 - r)); }
+		inline constexpr u64 Rotl64(u64 v, u32 r) { return (v << r) | (v >> (64 - r)); }
+
+		//the hash is defined on little endian reads
+		inline u32 Read32(const u8* p)
+		{
+			u32 v{};
+			memcpy(&v, p, sizeof(v));
+			if constexpr (endian::native == endian::big) v = Swap32(v);
+			return v;
+		}
+		inline u64 Read64(const u8* p)
+		{
+			u64 v{};
+			memcpy(&v, p, sizeof(v));
+			if constexpr (endian::native == endian::big) v = Swap64(v);
+			return v;
+		}
+		inline void Write64(u8* p, u64 v)
+		{
+			if constexpr (endian::native == endian::big) v = Swap64(v);
+			memcpy(p, &v, sizeof(v));
+		}
+
+		inline Hash128 Mult64To128(u64 lhs, u64 rhs)
+		{
+#if defined(__SIZEOF_INT128__)
+			unsigned __int128 product = scast<unsigned __int128>(lhs) * rhs;
+			return { scast<u64>(product), scast<u64>(product >> 64) };
+#elif defined(_MSC_VER) && defined(_M_X64)
+			u64 high{};
+			u64 low = _umul128(lhs, rhs, &high);
+			return { low, high };
+#else
+			u64 loLo = (lhs & 0xFFFFFFFFULL) * (rhs & 0xFFFFFFFFULL);
+			u64 hiLo = (lhs >> 32) * (rhs & 0xFFFFFFFFULL);
+			u64 loHi = (lhs & 0xFFFFFFFFULL) * (rhs >> 32);
+			u64 hiHi = (lhs >> 32) * (rhs >> 32);
+
+			u64 cross = (loLo >> 32) + (hiLo & 0xFFFFFFFFULL) + loHi;
+			u64 upper = (hiLo >> 32) + (cross >> 32) + hiHi;
+			u64 lower = (cross << 32) | (loLo & 0xFFFFFFFFULL);
+
+			return { lower, upper };
+#endif
+		}
+		inline u64 Mul128Fold64(u64 lhs, u64 rhs)
+		{
+			Hash128 product = Mult64To128(lhs, rhs);
+			return product.low ^ product.high;
+		}
+
+		inline constexpr u64 XorShift64(u64 v, u32 shift) { return v ^ (v >> shift); }
+
+		inline constexpr u64 Avalanche64(u64 h)
+		{
+			h ^= h >> 33;
+			h *= PRIME64_2;
+			h ^= h >> 29;
+			h *= PRIME64_3;
+			h ^= h >> 32;
+			return h;
+		}
+		inline constexpr u64 Avalanche(u64 h)
+		{
+			h = XorShift64(h, 37);
+			h *= PRIME_MX1;
+			h = XorShift64(h, 32);
+			return h;
+		}
+		inline constexpr u64 RrmxMx(u64 h, u64 len)
+		{
+			h ^= Rotl64(h, 49) ^ Rotl64(h, 24);
+			h *= PRIME_MX2;
+			h ^= (h >> 35) + len;
+			h *= PRIME_MX2;
+			return XorShift64(h, 28);
+		}
+
+		inline u64 Mix16B(
+			const u8* input,
+			const u8* secret,
+			u64 seed)
+		{
+			return Mul128Fold64(
+				Read64(input) ^ (Read64(secret) + seed),
+				Read64(input + 8) ^ (Read64(secret + 8) - seed));
+		}
+
+		inline Hash128 Mix32B(
+			Hash128 acc,
+			const u8* input1,
+			const u8* input2,
+			const u8* secret,
+			u64 seed)
+		{
+			acc.low += Mix16B(input1, secret, seed);
+			acc.low ^= Read64(input2) + Read64(input2 + 8);
+			acc.high += Mix16B(input2, secret + 16, seed);
+			acc.high ^= Read64(input1) + Read64(input1 + 8);
+			return acc;
+		}
+
+		//
+		// 64-BIT SHORT INPUTS
+		//
+
+		inline u64 Hash64_0To16(
+			const u8* input,
+			size_t len,
+			const u8* secret,
+			u64 seed)
+		{
+			if (len > 8)
+			{
+				u64 bitflip1 = (Read64(secret + 24) ^ Read64(secret + 32)) + seed;
+				u64 bitflip2 = (Read64(secret + 40) ^ Read64(secret + 48)) - seed;
+				u64 inputLo = Read64(input) ^ bitflip1;
+				u64 inputHi = Read64(input + len - 8) ^ bitflip2;
+				u64 acc = len
+					+ Swap64(inputLo)
+					+ inputHi
+					+ Mul128Fold64(inputLo, inputHi);
+				return Avalanche(acc);
+			}
+			if (len >= 4)
+			{
+				seed ^= scast<u64>(Swap32(scast<u32>(seed))) << 32;
+				u32 input1 = Read32(input);
+				u32 input2 = Read32(input + len - 4);
+				u64 bitflip = (Read64(secret + 8) ^ Read64(secret + 16)) - seed;
+				u64 input64 = input2 + (scast<u64>(input1) << 32);
+				return RrmxMx(input64 ^ bitflip, len);
+			}
+			if (len > 0)
+			{
+				u32 c1 = input[0];
+				u32 c2 = input[len >> 1];
+				u32 c3 = input[len - 1];
+				u32 combined = (c1 << 16) | (c2 << 24) | c3 | (scast<u32>(len) << 8);
+				u64 bitflip = (Read32(secret) ^ Read32(secret + 4)) + seed;
+				return Avalanche64(scast<u64>(combined) ^ bitflip);
+			}
+
+			return Avalanche64(seed ^ (Read64(secret + 56) ^ Read64(secret + 64)));
+		}
+
+		inline u64 Hash64_17To128(
+			const u8* input,
+			size_t len,
+			const u8* secret,
+			u64 seed)
+		{
+			u64 acc = len * PRIME64_1;
+
+			if (len > 32)
+			{
+				if (len > 64)
+				{
+					if (len > 96)
+					{
+						acc += Mix16B(input + 48, secret + 96, seed);
+						acc += Mix16B(input + len - 64, secret + 112, seed);
+					}
+					acc += Mix16B(input + 32, secret + 64, seed);
+					acc += Mix16B(input + len - 48, secret + 80, seed);
+				}
+				acc += Mix16B(input + 16, secret + 32, seed);
+				acc += Mix16B(input + len - 32, secret + 48, seed);
+			}
+			acc += Mix16B(input, secret, seed);
+			acc += Mix16B(input + len - 16, secret + 16, seed);
+
+			return Avalanche(acc);
+		}
+
+		inline u64 Hash64_129To240(
+			const u8* input,
+			size_t len,
+			const u8* secret,
+			u64 seed)
+		{
+			u64 acc = len * PRIME64_1;
+			size_t rounds = len / 16;
+
+			for (size_t i = 0; i < 8; ++i)
+			{
+				acc += Mix16B(input + 16 * i, secret + 16 * i, seed);
+			}
+			acc = Avalanche(acc);
+
+			for (size_t i = 8; i < rounds; ++i)
+			{
+				acc += Mix16B(input + 16 * i, secret + 16 * (i - 8) + MIDSIZE_STARTOFFSET, seed);
+			}
+			acc += Mix16B(input + len - 16, secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET, seed);
+
+			return Avalanche(acc);
+		}
+
+		//
+		// 128-BIT SHORT INPUTS
+		//
+
+		inline Hash128 Hash128_0To16(
+			const u8* input,
+			size_t len,
+			const u8* secret,
+			u64 seed)
+		{
+			if (len > 8)
+			{
+				u64 bitflipl = (Read64(secret + 32) ^ Read64(secret + 40)) - seed;
+				u64 bitfliph = (Read64(secret + 48) ^ Read64(secret + 56)) + seed;
+				u64 inputLo = Read64(input);
+				u64 inputHi = Read64(input + len - 8);
+
+				Hash128 m128 = Mult64To128(inputLo ^ inputHi ^ bitflipl, PRIME64_1);
+				m128.low += scast<u64>(len - 1) << 54;
+				inputHi ^= bitfliph;
+				m128.high += inputHi + scast<u64>(scast<u32>(inputHi)) * (PRIME32_2 - 1);
+				m128.low ^= Swap64(m128.high);
+
+				Hash128 h128 = Mult64To128(m128.low, PRIME64_2);
+				h128.high += m128.high * PRIME64_2;
+				h128.low = Avalanche(h128.low);
+				h128.high = Avalanche(h128.high);
+				return h128;
+			}
+			if (len >= 4)
+			{
+				seed ^= scast<u64>(Swap32(scast<u32>(seed))) << 32;
+				u32 inputLo = Read32(input);
+				u32 inputHi = Read32(input + len - 4);
+				u64 input64 = inputLo + (scast<u64>(inputHi) << 32);
+				u64 bitflip = (Read64(secret + 16) ^ Read64(secret + 24)) + seed;
+				u64 keyed = input64 ^ bitflip;
+
+				Hash128 m128 = Mult64To128(keyed, PRIME64_1 + (scast<u64>(len) << 2));
+				m128.high += m128.low << 1;
+				m128.low ^= m128.high >> 3;
+				m128.low = XorShift64(m128.low, 35);
+				m128.low *= PRIME_MX2;
+				m128.low = XorShift64(m128.low, 28);
+				m128.high = Avalanche(m128.high);
+				return m128;
+			}
+			if (len > 0)
+			{
+				u32 c1 = input[0];
+				u32 c2 = input[len >> 1];
+				u32 c3 = input[len - 1];
+				u32 combinedl = (c1 << 16) | (c2 << 24) | c3 | (scast<u32>(len) << 8);
+				u32 combinedh = Rotl32(Swap32(combinedl), 13);
+				u64 bitflipl = (Read32(secret) ^ Read32(secret + 4)) + seed;
+				u64 bitfliph = (Read32(secret + 8) ^ Read32(secret + 12)) - seed;
+				return
+				{
+					Avalanche64(scast<u64>(combinedl) ^ bitflipl),
+					Avalanche64(scast<u64>(combinedh) ^ bitfliph)
+				};
+			}
+
+			return
+			{
+				Avalanche64(seed ^ Read64(secret + 64) ^ Read64(secret + 72)),
+				Avalanche64(seed ^ Read64(secret + 80) ^ Read64(secret + 88))
+			};
+		}
+
+		inline Hash128 FinalizeMid128(
+			Hash128 acc,
+			size_t len,
+			u64 seed)
+		{
+			Hash128 h128{};
+			h128.low = Avalanche(acc.low + acc.high);
+			h128.high = 0 - Avalanche(
+				acc.low * PRIME64_1
+				+ acc.high * PRIME64_4
+				+ (len - seed) * PRIME64_2);
+			return h128;
+		}
+
+		inline Hash128 Hash128_17To128(
+			const u8* input,
+			size_t len,
+			const u8* secret,
+			u64 seed)
+		{
+			Hash128 acc{ len * PRIME64_1, 0 };
+
+			if (len > 32)
+			{
+				if (len > 64)
+				{
+					if (len > 96)
+					{
+						acc = Mix32B(acc, input + 48, input + len - 64, secret + 96, seed);
+					}
+					acc = Mix32B(acc, input + 32, input + len - 48, secret + 64, seed);
+				}
+				acc = Mix32B(acc, input + 16, input + len - 32, secret + 32, seed);
+			}
+			acc = Mix32B(acc, input, input + len - 16, secret, seed);
+
+			return FinalizeMid128(acc, len, seed);
+		}
+
+		inline Hash128 Hash128_129To240(
+			const u8* input,
+			size_t len,
+			const u8* secret,
+			u64 seed)
+		{
+			Hash128 acc{ len * PRIME64_1, 0 };
+			size_t rounds = len / 32;
+
+			for (size_t i = 0; i < 4; ++i)
+			{
+				acc = Mix32B(acc, input + 32 * i, input + 32 * i + 16, secret + 32 * i, seed);
+			}
+			acc.low = Avalanche(acc.low);
+			acc.high = Avalanche(acc.high);
+
+			for (size_t i = 4; i < rounds; ++i)
+			{
+				acc = Mix32B(
+					acc,
+					input + 32 * i,
+					input + 32 * i + 16,
+					secret + MIDSIZE_STARTOFFSET + 32 * (i - 4),
+					seed);
+			}
+			acc = Mix32B(
+				acc,
+				input + len - 16,
+				input + len - 32,
+				secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET - 16,
+				0 - seed);
+
+			return FinalizeMid128(acc, len, seed);
+		}
+
+		//
+		// LONG INPUTS
+		//
+
+		//Adds nbStripes stripes of 64 bytes into the accumulators, stripe n is keyed with secret + n * 8
+		using AccumulateFunc = void(*)(u64* acc, const u8* input, const u8* secret, size_t nbStripes);
+		//Scrambles the accumulators at the end of every block
+		using ScrambleFunc = void(*)(u64* acc, const u8* secret);
+
+		inline void AccumulateScalar(
+			u64* acc,
+			const u8* input,
+			const u8* secret,
+			size_t nbStripes)
+		{
+			for (size_t n = 0; n < nbStripes; ++n)
+			{
+				const u8* in = input + n * STRIPE_LEN;
+				const u8* key = secret + n * SECRET_CONSUME_RATE;
+
+				for (size_t i = 0; i < 8; ++i)
+				{
+					u64 dataVal = Read64(in + 8 * i);
+					u64 dataKey = dataVal ^ Read64(key + 8 * i);
+					acc[i ^ 1] += dataVal;
+					acc[i] += (dataKey & 0xFFFFFFFFULL) * (dataKey >> 32);
+				}
+			}
+		}
+
+		inline void ScrambleScalar(
+			u64* acc,
+			const u8* secret)
+		{
+			for (size_t i = 0; i < 8; ++i)
+			{
+				u64 a = acc[i];
+				a = XorShift64(a, 47);
+				a ^= Read64(secret + 8 * i);
+				a *= PRIME32_1;
+				acc[i] = a;
+			}
+		}
+
+#ifdef KALA_HASH_X64
+		//sse2 is part of x86-64, so this path needs no cpu check
+		inline void AccumulateSSE2(
+			u64* acc,
+			const u8* input,
+			const u8* secret,
+			size_t nbStripes)
+		{
+			__m128i xacc[4]{};
+			for (size_t i = 0; i < 4; ++i) xacc[i] = _mm_loadu_si128(rcast<const __m128i*>(acc) + i);
+
+			for (size_t n = 0; n < nbStripes; ++n)
+			{
+				const u8* in = input + n * STRIPE_LEN;
+				const u8* key = secret + n * SECRET_CONSUME_RATE;
+
+				for (size_t i = 0; i < 4; ++i)
+				{
+					__m128i dataVec = _mm_loadu_si128(rcast<const __m128i*>(in) + i);
+					__m128i keyVec = _mm_loadu_si128(rcast<const __m128i*>(key) + i);
+					__m128i dataKey = _mm_xor_si128(dataVec, keyVec);
+
+					//low half of each lane times its high half
+					__m128i product = _mm_mul_epu32(dataKey, _mm_srli_epi64(dataKey, 32));
+					//every lane also takes the raw input of its neighbour
+					__m128i dataSwap = _mm_shuffle_epi32(dataVec, _MM_SHUFFLE(1, 0, 3, 2));
+
+					xacc[i] = _mm_add_epi64(product, _mm_add_epi64(xacc[i], dataSwap));
+				}
+			}
+
+			for (size_t i = 0; i < 4; ++i) _mm_storeu_si128(rcast<__m128i*>(acc) + i, xacc[i]);
+		}
+
+		inline void ScrambleSSE2(
+			u64* acc,
+			const u8* secret)
+		{
+			const __m128i prime = _mm_set1_epi32(scast<int>(PRIME32_1));
+
+			for (size_t i = 0; i < 4; ++i)
+			{
+				__m128i accVec = _mm_loadu_si128(rcast<const __m128i*>(acc) + i);
+				__m128i dataVec = _mm_xor_si128(accVec, _mm_srli_epi64(accVec, 47));
+				__m128i dataKey = _mm_xor_si128(dataVec, _mm_loadu_si128(rcast<const __m128i*>(secret) + i));
+
+				//64-bit multiply by a 32-bit prime from two 32x32 products
+				__m128i productLo = _mm_mul_epu32(dataKey, prime);
+				__m128i productHi = _mm_mul_epu32(_mm_srli_epi64(dataKey, 32), prime);
+
+				_mm_storeu_si128(
+					rcast<__m128i*>(acc) + i,
+					_mm_add_epi64(productLo, _mm_slli_epi64(productHi, 32)));
+			}
+		}
+
+		KALA_HASH_TARGET_AVX2 inline void AccumulateAVX2(
+			u64* acc,
+			const u8* input,
+			const u8* secret,
+			size_t nbStripes)
+		{
+			__m256i xacc0 = _mm256_loadu_si256(rcast<const __m256i*>(acc));
+			__m256i xacc1 = _mm256_loadu_si256(rcast<const __m256i*>(acc) + 1);
+
+			for (size_t n = 0; n < nbStripes; ++n)
+			{
+				const __m256i* in = rcast<const __m256i*>(input + n * STRIPE_LEN);
+				const __m256i* key = rcast<const __m256i*>(secret + n * SECRET_CONSUME_RATE);
+
+				__m256i data0 = _mm256_loadu_si256(in);
+				__m256i data1 = _mm256_loadu_si256(in + 1);
+				__m256i dataKey0 = _mm256_xor_si256(data0, _mm256_loadu_si256(key));
+				__m256i dataKey1 = _mm256_xor_si256(data1, _mm256_loadu_si256(key + 1));
+
+				__m256i product0 = _mm256_mul_epu32(dataKey0, _mm256_srli_epi64(dataKey0, 32));
+				__m256i product1 = _mm256_mul_epu32(dataKey1, _mm256_srli_epi64(dataKey1, 32));
+
+				xacc0 = _mm256_add_epi64(product0, _mm256_add_epi64(xacc0, _mm256_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2))));
+				xacc1 = _mm256_add_epi64(product1, _mm256_add_epi64(xacc1, _mm256_shuffle_epi32(data1, _MM_SHUFFLE(1, 0, 3, 2))));
+			}
+
+			_mm256_storeu_si256(rcast<__m256i*>(acc), xacc0);
+			_mm256_storeu_si256(rcast<__m256i*>(acc) + 1, xacc1);
+		}
+
+		KALA_HASH_TARGET_AVX2 inline void ScrambleAVX2(
+			u64* acc,
+			const u8* secret)
+		{
+			const __m256i prime = _mm256_set1_epi32(scast<int>(PRIME32_1));
+
+			for (size_t i = 0; i < 2; ++i)
+			{
+				__m256i accVec = _mm256_loadu_si256(rcast<const __m256i*>(acc) + i);
+				__m256i dataVec = _mm256_xor_si256(accVec, _mm256_srli_epi64(accVec, 47));
+				__m256i dataKey = _mm256_xor_si256(dataVec, _mm256_loadu_si256(rcast<const __m256i*>(secret) + i));
+
+				__m256i productLo = _mm256_mul_epu32(dataKey, prime);
+				__m256i productHi = _mm256_mul_epu32(_mm256_srli_epi64(dataKey, 32), prime);
+
+				_mm256_storeu_si256(
+					rcast<__m256i*>(acc) + i,
+					_mm256_add_epi64(productLo, _mm256_slli_epi64(productHi, 32)));
+			}
+		}
+
+		inline bool HasAVX2()
+		{
+			static const bool hasAVX2 = []()
+				{
+#if defined(_MSC_VER) && !defined(__clang__)
+					int info[4]{};
+
+					__cpuid(info, 0);
+					if (info[0] < 7) return false;
+
+					//the os must save the ymm registers too
+					__cpuid(info, 1);
+					bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+					bool hasAVX = (info[2] & (1 << 28)) != 0;
+					if (!hasOSXSave
+						|| !hasAVX
+						|| (_xgetbv(0) & 0x6) != 0x6)
+					{
+						return false;
+					}
+
+					__cpuidex(info, 7, 0);
+					return (info[1] & (1 << 5)) != 0;
+#else
+					__builtin_cpu_init();
+					return __builtin_cpu_supports("avx2") != 0;
+#endif
+				}();
+
+			return hasAVX2;
+		}
+#endif
+
+		struct HashKernel
+		{
+			AccumulateFunc accumulate{};
+			ScrambleFunc scramble{};
+			HashPath path{};
+		};
+
+		//Picks the widest path the cpu supports once
+		inline const HashKernel& GetKernel()
+		{
+			static const HashKernel kernel = []()
+				{
+#ifdef KALA_HASH_X64
+					if (HasAVX2()) return HashKernel{ AccumulateAVX2, ScrambleAVX2, HashPath::PATH_AVX2 };
+					return HashKernel{ AccumulateSSE2, ScrambleSSE2, HashPath::PATH_SSE2 };
+#else
+					return HashKernel{ AccumulateScalar, ScrambleScalar, HashPath::PATH_SCALAR };
+#endif
+				}();
+
+			return kernel;
+		}
+
+		//Default secret with the seed folded in, inputs over 240 bytes hash with it
+		inline void InitSecret(
+			u64 seed,
+			u8* outSecret)
+		{
+			for (size_t i = 0; i < SECRET_SIZE / 16; ++i)
+			{
+				Write64(outSecret + 16 * i, Read64(DEFAULT_SECRET + 16 * i) + seed);
+				Write64(outSecret + 16 * i + 8, Read64(DEFAULT_SECRET + 16 * i + 8) - seed);
+			}
+		}
+
+		//Consumes nbStripes stripes, scrambling at every block boundary
+		inline void ConsumeStripes(
+			const HashKernel& kernel,
+			u64* acc,
+			size_t& stripesSoFar,
+			const u8* input,
+			size_t nbStripes,
+			const u8* secret)
+		{
+			if (STRIPES_PER_BLOCK - stripesSoFar <= nbStripes)
+			{
+				size_t stripesToEnd = STRIPES_PER_BLOCK - stripesSoFar;
+				size_t stripesAfter = nbStripes - stripesToEnd;
+
+				kernel.accumulate(acc, input, secret + stripesSoFar * SECRET_CONSUME_RATE, stripesToEnd);
+				kernel.scramble(acc, secret + SECRET_SIZE - STRIPE_LEN);
+				kernel.accumulate(acc, input + stripesToEnd * STRIPE_LEN, secret, stripesAfter);
+
+				stripesSoFar = stripesAfter;
+			}
+			else
+			{
+				kernel.accumulate(acc, input, secret + stripesSoFar * SECRET_CONSUME_RATE, nbStripes);
+				stripesSoFar += nbStripes;
+			}
+		}
+
+		//Hashes every full block and stripe but the last stripe, which the caller adds
+		inline void HashLongAccumulate(
+			const HashKernel& kernel,
+			u64* acc,
+			const u8* input,
+			size_t len,
+			const u8* secret)
+		{
+			size_t blocks = (len - 1) / BLOCK_LEN;
+
+			for (size_t n = 0; n < blocks; ++n)
+			{
+				kernel.accumulate(acc, input + n * BLOCK_LEN, secret, STRIPES_PER_BLOCK);
+				kernel.scramble(acc, secret + SECRET_SIZE - STRIPE_LEN);
+			}
+
+			size_t stripes = ((len - 1) - BLOCK_LEN * blocks) / STRIPE_LEN;
+			kernel.accumulate(acc, input + blocks * BLOCK_LEN, secret, stripes);
+
+			kernel.accumulate(acc, input + len - STRIPE_LEN, secret + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START, 1);
+		}
+
+		inline u64 MergeAccs(
+			const u64* acc,
+			const u8* secret,
+			u64 start)
+		{
+			u64 result = start;
+			for (size_t i = 0; i < 4; ++i)
+			{
+				result += Mul128Fold64(
+					acc[2 * i] ^ Read64(secret + 16 * i),
+					acc[2 * i + 1] ^ Read64(secret + 16 * i + 8));
+			}
+			return Avalanche(result);
+		}
+
+		inline u64 Digest64(
+			const u64* acc,
+			const u8* secret,
+			u64 len)
+		{
+			return MergeAccs(acc, secret + SECRET_MERGEACCS_START, len * PRIME64_1);
+		}
+		inline Hash128 Digest128(
+			const u64* acc,
+			const u8* secret,
+			u64 len)
+		{
+			return
+			{
+				MergeAccs(acc, secret + SECRET_MERGEACCS_START, len * PRIME64_1),
+				MergeAccs(acc, secret + SECRET_SIZE - STRIPE_LEN - SECRET_MERGEACCS_START, ~(len * PRIME64_2))
+			};
+		}
+
+		inline const u8* GetLongSecret(
+			u64 seed,
+			u8* customSecret)
+		{
+			if (seed == 0) return DEFAULT_SECRET;
+
+			InitSecret(seed, customSecret);
+			return customSecret;
+		}
+	}
+
+	//Path used for inputs over 240 bytes on this cpu
+	inline HashPath GetHashPath() { return Detail::GetKernel().path; }
+
+	inline u64 HashBytes64(
+		const void* data,
+		size_t size,
+		u64 seed = 0)
+	{
+		using namespace Detail;
+
+		const u8* input = scast<const u8*>(data);
+
+		if (size <= 16) return Hash64_0To16(input, size, DEFAULT_SECRET, seed);
+		if (size <= 128) return Hash64_17To128(input, size, DEFAULT_SECRET, seed);
+		if (size <= MIDSIZE_MAX) return Hash64_129To240(input, size, DEFAULT_SECRET, seed);
+
+		alignas(64) u8 customSecret[SECRET_SIZE];
+		const u8* secret = GetLongSecret(seed, customSecret);
+
+		alignas(64) u64 acc[8];
+		memcpy(acc, INIT_ACC, sizeof(acc));
+
+		HashLongAccumulate(GetKernel(), acc, input, size, secret);
+
+		return Digest64(acc, secret, size);
+	}
+
+	inline Hash128 HashBytes128(
+		const void* data,
+		size_t size,
+		u64 seed = 0)
+	{
+		using namespace Detail;
+
+		const u8* input = scast<const u8*>(data);
+
+		if (size <= 16) return Hash128_0To16(input, size, DEFAULT_SECRET, seed);
+		if (size <= 128) return Hash128_17To128(input, size, DEFAULT_SECRET, seed);
+		if (size <= MIDSIZE_MAX) return Hash128_129To240(input, size, DEFAULT_SECRET, seed);
+
+		alignas(64) u8 customSecret[SECRET_SIZE];
+		const u8* secret = GetLongSecret(seed, customSecret);
+
+		alignas(64) u64 acc[8];
+		memcpy(acc, INIT_ACC, sizeof(acc));
+
+		HashLongAccumulate(GetKernel(), acc, input, size, secret);
+
+		return Digest128(acc, secret, size);
+	}
+
+	inline u64 HashString64(
+		string_view text,
+		u64 seed = 0)
+	{
+		return HashBytes64(text.data(), text.size(), seed);
+	}
+
+	inline Hash128 HashString128(
+		string_view text,
+		u64 seed = 0)
+	{
+		return HashBytes128(text.data(), text.size(), seed);
+	}
+
+	//Incremental hashing, feeding the same bytes in any number of Update calls
+	//gives the same digests as HashBytes64 and HashBytes128 over all of them at once
+	class HashStream
+	{
+	public:
+		explicit HashStream(u64 newSeed = 0) { Reset(newSeed); }
+
+		void Reset(u64 newSeed = 0)
+		{
+			using namespace Detail;
+
+			seed = newSeed;
+			InitSecret(seed, secret);
+			memcpy(acc, INIT_ACC, sizeof(acc));
+
+			totalLen = 0;
+			bufferedSize = 0;
+			stripesSoFar = 0;
+		}
+
+		void Update(
+			const void* data,
+			size_t size)
+		{
+			using namespace Detail;
+
+			if (size == 0) return;
+
+			const u8* input = scast<const u8*>(data);
+			const u8* end = input + size;
+
+			totalLen += size;
+
+			//input is only consumed once more follows, so the last stripe is always in the buffer
+			if (bufferedSize + size <= STREAM_BUFFER_SIZE)
+			{
+				memcpy(buffer + bufferedSize, input, size);
+				bufferedSize += size;
+				return;
+			}
+
+			const HashKernel& kernel = GetKernel();
+
+			if (bufferedSize > 0)
+			{
+				size_t loadSize = STREAM_BUFFER_SIZE - bufferedSize;
+				memcpy(buffer + bufferedSize, input, loadSize);
+				input += loadSize;
+
+				ConsumeStripes(kernel, acc, stripesSoFar, buffer, STREAM_BUFFER_STRIPES, secret);
+				bufferedSize = 0;
+			}
+
+			//large updates are consumed in place instead of through the buffer
+			if (scast<size_t>(end - input) > STREAM_BUFFER_SIZE)
+			{
+				const u8* limit = end - STREAM_BUFFER_SIZE;
+				do
+				{
+					ConsumeStripes(kernel, acc, stripesSoFar, input, STREAM_BUFFER_STRIPES, secret);
+					input += STREAM_BUFFER_SIZE;
+				} while (input < limit);
+
+				//the digest may need the stripe before the buffered tail
+				memcpy(buffer + STREAM_BUFFER_SIZE - STRIPE_LEN, input - STRIPE_LEN, STRIPE_LEN);
+			}
+
+			bufferedSize = scast<size_t>(end - input);
+			memcpy(buffer, input, bufferedSize);
+		}
+
+		u64 Digest64() const
+		{
+			using namespace Detail;
+
+			if (totalLen <= MIDSIZE_MAX) return HashBytes64(buffer, scast<size_t>(totalLen), seed);
+
+			alignas(64) u64 finalAcc[8];
+			FinishLong(finalAcc);
+
+			return Detail::Digest64(finalAcc, secret, totalLen);
+		}
+
+		Hash128 Digest128() const
+		{
+			using namespace Detail;
+
+			if (totalLen <= MIDSIZE_MAX) return HashBytes128(buffer, scast<size_t>(totalLen), seed);
+
+			alignas(64) u64 finalAcc[8];
+			FinishLong(finalAcc);
+
+			return Detail::Digest128(finalAcc, secret, totalLen);
+		}
+
+		u64 GetSize() const { return totalLen; }
+	private:
+		//Accumulates the buffered tail into a copy so the stream can keep going after a digest
+		void FinishLong(u64* outAcc) const
+		{
+			using namespace Detail;
+
+			const HashKernel& kernel = GetKernel();
+
+			memcpy(outAcc, acc, sizeof(acc));
+
+			alignas(64) u8 lastStripe[STRIPE_LEN];
+			const u8* lastStripePtr{};
+
+			if (bufferedSize >= STRIPE_LEN)
+			{
+				size_t stripes = (bufferedSize - 1) / STRIPE_LEN;
+				size_t stripesCopy = stripesSoFar;
+
+				ConsumeStripes(kernel, outAcc, stripesCopy, buffer, stripes, secret);
+				lastStripePtr = buffer + bufferedSize - STRIPE_LEN;
+			}
+			else
+			{
+				//the last stripe straddles the end of the previous buffer and the tail
+				size_t catchup = STRIPE_LEN - bufferedSize;
+				memcpy(lastStripe, buffer + STREAM_BUFFER_SIZE - catchup, catchup);
+				memcpy(lastStripe + catchup, buffer, bufferedSize);
+				lastStripePtr = lastStripe;
+			}
+
+			kernel.accumulate(outAcc, lastStripePtr, secret + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START, 1);
+		}
+
+		alignas(64) u64 acc[8]{};
+		alignas(64) u8 secret[Detail::SECRET_SIZE]{};
+		alignas(64) u8 buffer[Detail::STREAM_BUFFER_SIZE]{};
+
+		u64 seed{};
+		u64 totalLen{};
+		size_t bufferedSize{};
+		size_t stripesSoFar{};
+	};
+}
@@ -8,6 +8,7 @@
 //
 // Provides:
 //   - Helpers for streaming individual models or loading the full kalamodeldata binary into memory
+//   - Parsing the same data from an in-memory buffer when the file comes from an archive
 //------------------------------------------------------------------------------
 
 /*------------------------------------------------------------------------------
@@ -368,6 +369,47 @@ namespace KalaHeaders::KalaModelData
 		}
 	}
 	
+	//Parses and validates the top header from the first CORRECT_MODEL_HEADER_SIZE bytes of inData
+	inline ImportResult ParseHeaderData(
+		const u8* inData,
+		ModelHeader& outHeader)
+	{
+		ModelHeader header{};
+		
+		//model header
+		
+		memcpy(&header.magic, inData + 0, sizeof(u32));
+		if (header.magic != KMD_MAGIC) return ImportResult::RESULT_INVALID_MAGIC;
+		
+		memcpy(&header.version, inData + 4, sizeof(u8));
+		if (header.version != KMD_VERSION) return ImportResult::RESULT_INVALID_VERSION;
+		
+		memcpy(&header.scaleFactor, inData + 5,  sizeof(u8));
+		//clamp to 0 for out of range values
+		if (header.scaleFactor > 8) header.scaleFactor = 0;
+		
+		memcpy(&header.modelCount, inData + 6,  sizeof(u32));
+		if (header.modelCount > MAX_MODEL_COUNT) return ImportResult::RESULT_INVALID_MODEL_COUNT;
+
+		memcpy(&header.modelTablesSize, inData + 10, sizeof(u32));
+		if (header.modelTablesSize < CORRECT_MODEL_TABLE_SIZE
+			|| header.modelTablesSize > MAX_MODEL_TABLE_SIZE)
+		{
+			return ImportResult::RESULT_INVALID_MODEL_TABLE_SIZE;
+		}
+		
+		memcpy(&header.modelBlocksSize, inData + 14, sizeof(u32));
+		if (header.modelBlocksSize < VERTICE_DATA_OFFSET
+			|| header.modelBlocksSize > MAX_MODEL_BLOCK_SIZE)
+		{
+			return ImportResult::RESULT_INVALID_MODEL_BLOCK_SIZE;
+		}
+		
+		outHeader = header;
+		
+		return ImportResult::RESULT_SUCCESS;
+	}
+	
 	//Returns header data of the file,
 	//set skipChecks to true if the file has already been checked
 	inline ImportResult GetHeaderData(
@@ -398,34 +440,8 @@ namespace KalaHeaders::KalaModelData
 			
 			ModelHeader header{};
 			
-			//model header
-			
-			memcpy(&header.magic, headerData.data() + 0, sizeof(u32));
-			if (header.magic != KMD_MAGIC) return ImportResult::RESULT_INVALID_MAGIC;
-			
-			memcpy(&header.version, headerData.data() + 4, sizeof(u8));
-			if (header.version != KMD_VERSION) return ImportResult::RESULT_INVALID_VERSION;
-			
-			memcpy(&header.scaleFactor, headerData.data() + 5,  sizeof(u8));
-			//clamp to 0 for out of range values
-			if (header.scaleFactor > 8) header.scaleFactor = 0;
-			
-			memcpy(&header.modelCount, headerData.data() + 6,  sizeof(u32));
-			if (header.modelCount > MAX_MODEL_COUNT) return ImportResult::RESULT_INVALID_MODEL_COUNT;
-
-			memcpy(&header.modelTablesSize, headerData.data() + 10, sizeof(u32));
-			if (header.modelTablesSize < CORRECT_MODEL_TABLE_SIZE
-				|| header.modelTablesSize > MAX_MODEL_TABLE_SIZE)
-			{
-				return ImportResult::RESULT_INVALID_MODEL_TABLE_SIZE;
-			}
-			
-			memcpy(&header.modelBlocksSize, headerData.data() + 14, sizeof(u32));
-			if (header.modelBlocksSize < VERTICE_DATA_OFFSET
-				|| header.modelBlocksSize > MAX_MODEL_BLOCK_SIZE)
-			{
-				return ImportResult::RESULT_INVALID_MODEL_BLOCK_SIZE;
-			}
+			ImportResult parseResult = ParseHeaderData(headerData.data(), header);
+			if (parseResult != ImportResult::RESULT_SUCCESS) return parseResult;
 			
 			outHeader = header;
 			
@@ -437,6 +453,31 @@ namespace KalaHeaders::KalaModelData
 		}
 	}
 	
+	//Parses the model tables from inData, which must hold header.modelTablesSize bytes
+	inline void ParseTableData(
+		const u8* inData,
+		const ModelHeader& header,
+		vector<ModelTable>& outTables)
+	{
+		vector<ModelTable> tables{};
+		tables.reserve(header.modelCount);
+		
+		for (size_t i = 0; 
+			i < header.modelTablesSize; 
+			i += CORRECT_MODEL_TABLE_SIZE)
+		{
+			ModelTable t{};
+			
+			memcpy(t.nodeName,     inData + i + 0, sizeof(t.nodeName));
+			memcpy(&t.blockOffset, inData + i + 20, sizeof(u32));
+			memcpy(&t.blockSize,   inData + i + 24, sizeof(u32));
+			
+			tables.push_back(t);
+		}
+		
+		outTables = move(tables);
+	}
+	
 	//Loads the kmd tables for streaming models at runtime,
 	//set skipChecks to true if the file has already been checked
 	inline ImportResult GetTableData(
@@ -478,23 +519,10 @@ namespace KalaHeaders::KalaModelData
 				
 			in.close();	
 		
-			vector<ModelTable> tables{};
-			tables.reserve(header.modelCount);
-			
-			for (size_t i = 0; 
-				i < header.modelTablesSize; 
-				i += CORRECT_MODEL_TABLE_SIZE)
-			{
-				ModelTable t{};
-				
-				memcpy(t.nodeName,     tablesData.data() + i + 0, sizeof(t.nodeName));
-				memcpy(&t.blockOffset, tablesData.data() + i + 20, sizeof(u32));
-				memcpy(&t.blockSize,   tablesData.data() + i + 24, sizeof(u32));
-				
-				tables.push_back(t);
-			}
-			
-			outTables = move(tables);
+			ParseTableData(
+				tablesData.data(),
+				header,
+				outTables);
 			
 			return ImportResult::RESULT_SUCCESS;
 		}
@@ -658,6 +686,134 @@ namespace KalaHeaders::KalaModelData
 		}
 	}
 	
+	//Parses the model blocks of inTables from inData, which holds the block region
+	//of a kmd file that starts at blockRegionStart bytes from the start of the file
+	inline ImportResult ParseBlockData(
+		const u8* inData,
+		size_t inSize,
+		size_t blockRegionStart,
+		const vector<ModelTable>& inTables,
+		vector<ModelBlock>& outBlocks)
+	{
+		vector<ModelBlock> blocks{};
+		blocks.reserve(inTables.size());
+		
+		for (const auto& t : inTables)
+		{
+			ModelBlock b{};
+			size_t relativeOffset = t.blockOffset - blockRegionStart;
+			
+			//verify that block size is not OOB
+			if (relativeOffset + t.blockSize > inSize)
+			{
+				return ImportResult::RESULT_UNEXPECTED_EOF;
+			}
+			
+			memcpy(b.nodeName, inData + relativeOffset + 0, 20);
+			memcpy(b.meshName, inData + relativeOffset + 20, 20);
+			memcpy(b.nodePath, inData + relativeOffset + 40, 50);
+			
+			//data flags go from 0 to 4
+			memcpy(&b.dataTypeFlags, inData + relativeOffset + 90, sizeof(u8));
+			if (b.dataTypeFlags & ~0b00011111) return ImportResult::RESULT_INVALID_DATA_FLAGS;
+			
+			//render type goes from 0 to 2
+			memcpy(&b.renderType, inData + relativeOffset + 91, sizeof(u8));
+			if (b.renderType > 2) return ImportResult::RESULT_INVALID_RENDER_TYPE;
+			
+			f32 newPos[3]{};
+			memcpy(&newPos[0], inData + relativeOffset + 92, sizeof(f32));
+			memcpy(&newPos[1], inData + relativeOffset + 96, sizeof(f32));
+			memcpy(&newPos[2], inData + relativeOffset + 100, sizeof(f32));
+			
+			if (newPos[0] < MIN_POS
+				|| newPos[0] > MAX_POS
+				|| newPos[1] < MIN_POS
+				|| newPos[1] > MAX_POS
+				|| newPos[2] < MIN_POS
+				|| newPos[2] > MAX_POS)
+			{
+				return ImportResult::RESULT_INVALID_MODEL_POSITION;
+			}
+			
+			memcpy(b.position, newPos, sizeof(b.position));
+			
+			f32 newRot[4]{};
+			memcpy(&newRot[0], inData + relativeOffset + 104, sizeof(f32));
+			memcpy(&newRot[1], inData + relativeOffset + 108, sizeof(f32));
+			memcpy(&newRot[2], inData + relativeOffset + 112, sizeof(f32));
+			memcpy(&newRot[3], inData + relativeOffset + 116, sizeof(f32));
+			
+			if (newRot[0] < MIN_ROT
+				|| newRot[0] > MAX_ROT
+				|| newRot[1] < MIN_ROT
+				|| newRot[1] > MAX_ROT
+				|| newRot[2] < MIN_ROT
+				|| newRot[2] > MAX_ROT
+				|| newRot[3] < MIN_ROT
+				|| newRot[3] > MAX_ROT)
+			{
+				return ImportResult::RESULT_INVALID_MODEL_ROTATION;
+			}
+			
+			memcpy(b.rotation, newRot, sizeof(b.rotation));
+			
+			f32 newSize[3]{};
+			memcpy(&newSize[0], inData + relativeOffset + 120, sizeof(f32));
+			memcpy(&newSize[1], inData + relativeOffset + 124, sizeof(f32));
+			memcpy(&newSize[2], inData + relativeOffset + 128, sizeof(f32));
+			
+			if (newSize[0] < MIN_SIZE
+				|| newSize[0] > MAX_SIZE
+				|| newSize[1] < MIN_SIZE
+				|| newSize[1] > MAX_SIZE
+				|| newSize[2] < MIN_SIZE
+				|| newSize[2] > MAX_SIZE)
+			{
+				return ImportResult::RESULT_INVALID_MODEL_SIZE;
+			}
+			
+			memcpy(b.size, newSize, sizeof(b.size));
+			
+			memcpy(&b.verticesOffset, inData + relativeOffset + 132, sizeof(u32));
+			memcpy(&b.verticesSize,   inData + relativeOffset + 136, sizeof(u32));
+			memcpy(&b.indicesOffset,  inData + relativeOffset + 140, sizeof(u32));
+			memcpy(&b.indicesSize,    inData + relativeOffset + 144, sizeof(u32));
+			
+			//verify that vertices are not OOB
+			if (relativeOffset + scast<u32>(VERTICE_DATA_OFFSET) + b.verticesSize > inSize)
+			{
+				return ImportResult::RESULT_UNEXPECTED_EOF;
+			}
+			
+			//vertices
+			
+			size_t vertexCount = b.verticesSize / sizeof(Vertex);
+			
+			b.vertices.resize(vertexCount);
+			memcpy(b.vertices.data(), inData + relativeOffset + VERTICE_DATA_OFFSET, b.verticesSize);
+			
+			//verify that indices are not OOB
+			if (relativeOffset + scast<u32>(VERTICE_DATA_OFFSET) + b.verticesSize + b.indicesSize > inSize)
+			{
+				return ImportResult::RESULT_UNEXPECTED_EOF;
+			}
+			
+			//indices
+			
+			size_t indexCount = b.indicesSize / sizeof(u32);
+			
+			b.indices.resize(indexCount);
+			memcpy(b.indices.data(), inData + relativeOffset + VERTICE_DATA_OFFSET + b.verticesSize, b.indicesSize);
+			
+			blocks.push_back(move(b));
+		}
+		
+		outBlocks = move(blocks);
+		
+		return ImportResult::RESULT_SUCCESS;
+	}
+	
 	//Returns the entire kmd file binary content in structs
 	inline ImportResult ImportKMD(
 		const path& inFile,
@@ -715,119 +871,86 @@ namespace KalaHeaders::KalaModelData
 			//model block data
 			
 			vector<ModelBlock> blocks{};
-			blocks.reserve(header.modelCount);
 			
-			for (const auto& t : tables)
-			{
-				ModelBlock b{};
-				size_t relativeOffset = t.blockOffset - blockRegionStart;
-				
-				//verify that block size is not OOB
-				if (relativeOffset + t.blockSize > blockData.size())
-				{
-					return ImportResult::RESULT_UNEXPECTED_EOF;
-				}
-				
-				memcpy(b.nodeName, blockData.data() + relativeOffset + 0, 20);
-				memcpy(b.meshName, blockData.data() + relativeOffset + 20, 20);
-				memcpy(b.nodePath, blockData.data() + relativeOffset + 40, 50);
+			ImportResult blockResult = ParseBlockData(
+				blockData.data(),
+				blockData.size(),
+				blockRegionStart,
+				tables,
+				blocks);
 				
-				//data flags go from 0 to 4
-				memcpy(&b.dataTypeFlags, blockData.data() + relativeOffset + 90, sizeof(u8));
-				if (b.dataTypeFlags & ~0b00011111) return ImportResult::RESULT_INVALID_DATA_FLAGS;
-				
-				//render type goes from 0 to 2
-				memcpy(&b.renderType, blockData.data() + relativeOffset + 91, sizeof(u8));
-				if (b.renderType > 2) return ImportResult::RESULT_INVALID_RENDER_TYPE;
-				
-				f32 newPos[3]{};
-				memcpy(&newPos[0], blockData.data() + relativeOffset + 92, sizeof(f32));
-				memcpy(&newPos[1], blockData.data() + relativeOffset + 96, sizeof(f32));
-				memcpy(&newPos[2], blockData.data() + relativeOffset + 100, sizeof(f32));
-				
-				if (newPos[0] < MIN_POS
-					|| newPos[0] > MAX_POS
-					|| newPos[1] < MIN_POS
-					|| newPos[1] > MAX_POS
-					|| newPos[2] < MIN_POS
-					|| newPos[2] > MAX_POS)
-				{
-					return ImportResult::RESULT_INVALID_MODEL_POSITION;
-				}
-				
-				memcpy(b.position, newPos, sizeof(b.position));
-				
-				f32 newRot[4]{};
-				memcpy(&newRot[0], blockData.data() + relativeOffset + 104, sizeof(f32));
-				memcpy(&newRot[1], blockData.data() + relativeOffset + 108, sizeof(f32));
-				memcpy(&newRot[2], blockData.data() + relativeOffset + 112, sizeof(f32));
-				memcpy(&newRot[3], blockData.data() + relativeOffset + 116, sizeof(f32));
-				
-				if (newRot[0] < MIN_ROT
-					|| newRot[0] > MAX_ROT
-					|| newRot[1] < MIN_ROT
-					|| newRot[1] > MAX_ROT
-					|| newRot[2] < MIN_ROT
-					|| newRot[2] > MAX_ROT
-					|| newRot[3] < MIN_ROT
-					|| newRot[3] > MAX_ROT)
-				{
-					return ImportResult::RESULT_INVALID_MODEL_ROTATION;
-				}
-				
-				memcpy(b.rotation, newRot, sizeof(b.rotation));
-				
-				f32 newSize[3]{};
-				memcpy(&newSize[0], blockData.data() + relativeOffset + 120, sizeof(f32));
-				memcpy(&newSize[1], blockData.data() + relativeOffset + 124, sizeof(f32));
-				memcpy(&newSize[2], blockData.data() + relativeOffset + 128, sizeof(f32));
-				
-				if (newSize[0] < MIN_SIZE
-					|| newSize[0] > MAX_SIZE
-					|| newSize[1] < MIN_SIZE
-					|| newSize[1] > MAX_SIZE
-					|| newSize[2] < MIN_SIZE
-					|| newSize[2] > MAX_SIZE)
-				{
-					return ImportResult::RESULT_INVALID_MODEL_SIZE;
-				}
-				
-				memcpy(b.size, newSize, sizeof(b.size));
-				
-				memcpy(&b.verticesOffset, blockData.data() + relativeOffset + 132, sizeof(u32));
-				memcpy(&b.verticesSize,   blockData.data() + relativeOffset + 136, sizeof(u32));
-				memcpy(&b.indicesOffset,  blockData.data() + relativeOffset + 140, sizeof(u32));
-				memcpy(&b.indicesSize,    blockData.data() + relativeOffset + 144, sizeof(u32));
-				
-				//verify that vertices are not OOB
-				if (relativeOffset + scast<u32>(VERTICE_DATA_OFFSET) + b.verticesSize > blockData.size())
-				{
-					return ImportResult::RESULT_UNEXPECTED_EOF;
-				}
-				
-				//vertices
-				
-				size_t vertexCount = b.verticesSize / sizeof(Vertex);
-				
-				b.vertices.resize(vertexCount);
-				memcpy(b.vertices.data(), blockData.data() + relativeOffset + VERTICE_DATA_OFFSET, b.verticesSize);
-				
-				//verify that indices are not OOB
-				if (relativeOffset + scast<u32>(VERTICE_DATA_OFFSET) + b.verticesSize + b.indicesSize > blockData.size())
-				{
-					return ImportResult::RESULT_UNEXPECTED_EOF;
-				}
-				
-				//indices
-				
-				size_t indexCount = b.indicesSize / sizeof(u32);
-				
-				b.indices.resize(indexCount);
-				memcpy(b.indices.data(), blockData.data() + relativeOffset + VERTICE_DATA_OFFSET + b.verticesSize, b.indicesSize);
-				
-				blocks.push_back(move(b));
+			if (blockResult != ImportResult::RESULT_SUCCESS) return blockResult;
+			
+			outHeader = header;
+			outTables = move(tables);
+			outBlocks = move(blocks);
+			
+			return ImportResult::RESULT_SUCCESS;
+		}
+		catch (...)
+		{
+			return ImportResult::RESULT_UNKNOWN_READ_ERROR;
+		}
+	}
+	
+	//Returns the entire kmd binary content in structs from a buffer that already
+	//holds the whole file, used when the file is read from an archive instead of disk
+	inline ImportResult ImportKMD(
+		const u8* inData,
+		size_t inSize,
+		ModelHeader& outHeader,
+		vector<ModelTable>& outTables,
+		vector<ModelBlock>& outBlocks)
+	{
+		if (!inData
+			|| inSize == 0)
+		{
+			return ImportResult::RESULT_FILE_EMPTY;
+		}
+		if (inSize < MIN_TOTAL_SIZE
+			|| inSize > MAX_TOTAL_SIZE)
+		{
+			return ImportResult::RESULT_UNSUPPORTED_FILE_SIZE;
+		}
+		
+		try
+		{
+			//header data
+			
+			ModelHeader header{};
+			
+			ImportResult headerResult = ParseHeaderData(inData, header);
+			if (headerResult != ImportResult::RESULT_SUCCESS) return headerResult;
+			
+			size_t blockRegionStart = CORRECT_MODEL_HEADER_SIZE + header.modelTablesSize;
+			
+			if (blockRegionStart + header.modelBlocksSize > inSize)
+			{
+				return ImportResult::RESULT_UNEXPECTED_EOF;
 			}
 			
+			//model table data
+			
+			vector<ModelTable> tables{};
+			
+			ParseTableData(
+				inData + CORRECT_MODEL_HEADER_SIZE,
+				header,
+				tables);
+			
+			//model block data
+			
+			vector<ModelBlock> blocks{};
+			
+			ImportResult blockResult = ParseBlockData(
+				inData + blockRegionStart,
+				header.modelBlocksSize,
+				blockRegionStart,
+				tables,
+				blocks);
+				
+			if (blockResult != ImportResult::RESULT_SUCCESS) return blockResult;
+			
 			outHeader = header;
 			outTables = move(tables);
 			outBlocks = move(blocks);
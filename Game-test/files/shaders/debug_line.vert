@@ -1,18 +1,28 @@
 #version 330 core
 
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in float aDist;
+layout (location = 1) in vec4 aColor;
 
-out float vDist;
+//per instance, only read when uInstanced is 1
+layout (location = 2) in vec4 iCenterRadius; //center in xyz, radius in w
+layout (location = 3) in vec4 iColor;
+
+out vec4 vColor;
 
-uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProjection;
-uniform float uThickness; //pixel width
+uniform int uInstanced; //1 scales the unit mesh in aPos per instance
 
 void main()
 {
-	vDist = aDist;
+	vec3 pos = aPos;
+	vColor = aColor;
+	
+	if (uInstanced == 1)
+	{
+		pos = iCenterRadius.xyz + aPos * iCenterRadius.w;
+		vColor = iColor;
+	}
 	
-	gl_Position = uProjection * uView * uModel * vec4(aPos, 1.0f);
+	gl_Position = uProjection * uView * vec4(pos, 1.0f);
 }
\ No newline at end of file
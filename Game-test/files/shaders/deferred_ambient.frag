@@ -0,0 +1,21 @@
+#version 330 core
+
+in vec2 vTexCoord;
+
+out vec4 FragColor;
+
+uniform sampler2D uEmissiveTex; //ambient and emissive light from the g-buffer
+uniform sampler2D uDepthTex;    //g-buffer depth
+
+void main()
+{
+	float depth = texture(uDepthTex, vTexCoord).r;
+
+	//nothing was drawn here, keep the clear color
+	if (depth >= 1.0) discard;
+
+	FragColor = vec4(texture(uEmissiveTex, vTexCoord).rgb, 1.0);
+
+	//forward passes after this one depth test against the deferred geometry
+	gl_FragDepth = depth;
+}
@@ -0,0 +1,109 @@
+#version 330 core
+
+flat in int vLightIndex;
+flat in mat4 vInverseViewProjection;
+
+out vec4 FragColor;
+
+#define MAX_PL_COUNT 128
+
+struct PointLight
+{
+	vec4 position;
+
+	int canRender;
+	float intensity;
+	float maxRange;
+	float _pad1;
+
+	vec4 color;
+
+	float constant;
+	float linear;
+	float quadratic;
+	float _pad2;
+
+	vec4 shadowResolution;
+
+	float shadowStrength;
+	float filterRadius;
+
+	float bias;
+	float slopeBias;
+
+	float nearPlane;
+	float farPlane;
+	float _pad3[2];
+};
+
+uniform PointLightBlock
+{
+	PointLight uPointLights[MAX_PL_COUNT];
+};
+
+uniform vec3 uViewPos;    //camera position
+uniform vec2 uScreenSize; //g-buffer size in pixels
+
+uniform sampler2D uAlbedoTex;
+uniform sampler2D uNormalTex;
+uniform sampler2D uSpecularTex;
+uniform sampler2D uDepthTex;
+
+void main()
+{
+	vec2 uv = gl_FragCoord.xy / uScreenSize;
+
+	float depth = texture(uDepthTex, uv).r;
+	if (depth >= 1.0) discard;
+
+	vec4 clipPos = vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+	vec4 worldPos = vInverseViewProjection * clipPos;
+	vec3 fragPos = worldPos.xyz / worldPos.w;
+
+	PointLight light = uPointLights[vLightIndex];
+
+	vec3 toLight = light.position.xyz - fragPos;
+
+	//the volume only bounds the light, pixels inside it can still be out of range
+	float distance = length(toLight);
+	if (distance > light.maxRange) discard;
+
+	vec3 baseColor = texture(uAlbedoTex, uv).rgb;
+	vec3 worldNormal = normalize(texture(uNormalTex, uv).xyz);
+	vec4 specularData = texture(uSpecularTex, uv);
+
+	vec3 lightDir = normalize(toLight);
+	vec3 viewDir = normalize(uViewPos - fragPos);
+
+	//
+	// same terms as ComputePointLight in model.frag
+	//
+
+	float diff = max(dot(worldNormal, lightDir), 0.0);
+	vec3 diffuse = diff * baseColor * light.color.rgb;
+
+	vec3 halfDir = normalize(lightDir + viewDir);
+
+	float spec = pow(max(dot(worldNormal, halfDir), 0.0), specularData.a * 64.0);
+	spec = max(spec, 1e-4);
+
+	vec3 specular = spec * specularData.rgb * light.color.rgb;
+
+	float attenuation = 1.0 / (
+		light.constant
+		+ light.linear * distance
+		+ light.quadratic * (distance * distance));
+
+	attenuation = max(attenuation, 1e-4);
+
+	float fade = 1.0 - smoothstep(
+		light.maxRange * 0.5,
+		light.maxRange,
+		distance);
+
+	fade = max(fade, 0.01);
+
+	attenuation *= fade;
+
+	FragColor = vec4((diffuse + specular) * attenuation * light.intensity, 1.0);
+}
@@ -0,0 +1,68 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+
+#define MAX_PL_COUNT 128
+
+//same layout as PointLightBlock in model.frag, one light volume per instance
+struct PointLight
+{
+	vec4 position;
+
+	int canRender;
+	float intensity;
+	float maxRange;
+	float _pad1;
+
+	vec4 color;
+
+	float constant;
+	float linear;
+	float quadratic;
+	float _pad2;
+
+	vec4 shadowResolution;
+
+	float shadowStrength;
+	float filterRadius;
+
+	float bias;
+	float slopeBias;
+
+	float nearPlane;
+	float farPlane;
+	float _pad3[2];
+};
+
+uniform PointLightBlock
+{
+	PointLight uPointLights[MAX_PL_COUNT];
+};
+
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+//the unit mesh is inscribed in the unit sphere, this pushes its faces outside the light range
+uniform float uVolumeScale;
+
+flat out int vLightIndex;
+flat out mat4 vInverseViewProjection;
+
+void main()
+{
+	vLightIndex = gl_InstanceID;
+
+	mat4 viewProjection = uProjection * uView;
+	vInverseViewProjection = inverse(viewProjection);
+
+	PointLight light = uPointLights[gl_InstanceID];
+
+	//disabled lights collapse into a point and produce no fragments
+	float radius = light.canRender == 0
+		? 0.0
+		: light.maxRange * uVolumeScale;
+
+	vec3 worldPos = light.position.xyz + aPos * radius;
+
+	gl_Position = viewProjection * vec4(worldPos, 1.0);
+}
@@ -8,7 +8,9 @@ in vec3 vBitangent;
 
 in vec3 vFragPos;
 
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
+//only written to while the weighted OIT targets are bound
+layout (location = 1) out vec4 FragWeight;
 
 //
 // MATERIAL
@@ -18,6 +20,7 @@ uniform vec3 uViewPos;    //camera position
 uniform float uShininess; //affects how much light something reflects
 uniform float uOpacity;   //makes the model transparent if below 1.0
 uniform bool uTwoSided;   //set to true for flat models and planes
+uniform bool uWeightedOIT; //set to true while drawing into the weighted OIT targets
 
 uniform vec3 uDiffuseColor; //base color of the model
 uniform bool uHasDiffuseTex;
@@ -180,7 +183,20 @@ void main()
 	// END RESULT
 	//
 
-	FragColor = vec4(result, alpha);
+	if (uWeightedOIT)
+	{
+		//near and more opaque layers weigh more, clamped so half floats can't overflow
+		float weight = clamp(
+			pow(min(1.0, alpha * 10.0) + 0.01, 3.0)
+			* 1e8
+			* pow(1.0 - gl_FragCoord.z * 0.9, 3.0),
+			1e-2,
+			3e3);
+
+		FragColor = vec4(result * alpha * weight, alpha);
+		FragWeight = vec4(alpha * weight);
+	}
+	else FragColor = vec4(result, alpha);
 }
 
 vec3 ComputePointLight(
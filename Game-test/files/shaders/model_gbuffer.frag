@@ -0,0 +1,76 @@
+#version 330 core
+
+in vec2 vTexCoord;
+
+in vec3 vNormal;
+in vec3 vTangent;
+in vec3 vBitangent;
+
+in vec3 vFragPos;
+
+layout (location = 0) out vec4 GAlbedo;   //rgb base color
+layout (location = 1) out vec4 GNormal;   //xyz world normal
+layout (location = 2) out vec4 GSpecular; //rgb specular color, a shininess / 64
+layout (location = 3) out vec4 GEmissive; //rgb ambient and emissive light
+
+//
+// MATERIAL
+//
+
+uniform float uShininess; //affects how much light something reflects
+uniform float uOpacity;   //only used to drop fully transparent fragments here
+uniform bool uTwoSided;   //set to true for flat models and planes
+
+uniform vec3 uDiffuseColor; //base color of the model
+uniform bool uHasDiffuseTex;
+uniform sampler2D uDiffuseTex;
+
+uniform bool uHasNormalTex;
+uniform sampler2D uNormalTex;
+
+uniform vec3 uSpecularColor;
+uniform bool uHasSpecularTex;
+uniform sampler2D uSpecularTex;
+
+uniform vec3 uEmissiveColor;
+uniform bool uHasEmissiveTex;
+uniform sampler2D uEmissiveTex;
+
+void main()
+{
+	//same material inputs as model.frag, the point lights run later per light volume
+
+	if (clamp(uOpacity, 0.0, 1.0) < 0.001) discard;
+
+	vec3 baseColor = clamp(uDiffuseColor, 0.0, 1.0);
+	if (uHasDiffuseTex) baseColor *= texture(uDiffuseTex, vTexCoord).rgb;
+
+	vec3 worldNormal = normalize(vNormal);
+
+	if (uHasNormalTex)
+	{
+		vec3 tangentNormal = texture(uNormalTex, vTexCoord).xyz * 2.0 - 1.0;
+
+		mat3 TBN = mat3(vTangent, vBitangent, vNormal);
+		worldNormal = normalize(TBN * tangentNormal);
+	}
+
+	//back faces of two-sided models are lit from their own side
+	if (uTwoSided
+		&& !gl_FrontFacing)
+	{
+		worldNormal = -worldNormal;
+	}
+
+	vec3 specularMap = vec3(1.0);
+	if (uHasSpecularTex) specularMap = texture(uSpecularTex, vTexCoord).xyz;
+
+	vec3 emissive = uHasEmissiveTex
+		? texture(uEmissiveTex, vTexCoord).rgb
+		: uEmissiveColor;
+
+	GAlbedo = vec4(baseColor, 1.0);
+	GNormal = vec4(worldNormal, 0.0);
+	GSpecular = vec4(specularMap * uSpecularColor, clamp(uShininess, 1.0, 64.0) / 64.0);
+	GEmissive = vec4(baseColor * 0.01 + emissive, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+
+in vec2 vTexCoord;
+
+out vec4 FragColor;
+
+uniform sampler2D uAccumTex;  //weighted color sum in rgb, revealage in a
+uniform sampler2D uWeightTex; //weighted alpha sum in r
+
+void main()
+{
+	vec4 accum = texture(uAccumTex, vTexCoord);
+	float revealage = accum.a;
+
+	//nothing transparent covers this pixel
+	if (revealage >= 0.9999) discard;
+
+	float weight = texture(uWeightTex, vTexCoord).r;
+
+	//the weighted average of every layer, blended by how much of the background they hide
+	vec3 averageColor = accum.rgb / max(weight, 1e-5);
+
+	FragColor = vec4(averageColor, 1.0 - revealage);
+}
@@ -0,0 +1,15 @@
+#version 330 core
+
+in vec2 vCorner;
+in vec4 vColor;
+
+out vec4 FragColor;
+
+void main()
+{
+	//round soft edged sprite instead of a texture
+	float falloff = 1.0 - smoothstep(0.5, 1.0, length(vCorner));
+	if (falloff <= 0.0) discard;
+
+	FragColor = vec4(vColor.rgb, vColor.a * falloff);
+}
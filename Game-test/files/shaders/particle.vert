@@ -0,0 +1,30 @@
+#version 330 core
+
+//per instance, the quad corners come from gl_VertexID
+layout (location = 0) in vec4 iCenterSize; //center in xyz, world size in w
+layout (location = 1) in vec4 iColor;
+
+out vec2 vCorner;
+out vec4 vColor;
+
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+void main()
+{
+	//triangle strip order
+	vec2 corner = vec2(
+		(gl_VertexID & 1) == 0 ? -0.5 : 0.5,
+		(gl_VertexID & 2) == 0 ? -0.5 : 0.5);
+
+	//camera right and up are the first two rows of the view rotation
+	vec3 right = vec3(uView[0][0], uView[1][0], uView[2][0]);
+	vec3 up = vec3(uView[0][1], uView[1][1], uView[2][1]);
+
+	vec3 pos = iCenterSize.xyz + (right * corner.x + up * corner.y) * iCenterSize.w;
+
+	vCorner = corner * 2.0;
+	vColor = iColor;
+
+	gl_Position = uProjection * uView * vec4(pos, 1.0);
+}
@@ -0,0 +1,146 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+/*------------------------------------------------------------------------------
+
+# KPK pack header
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+0      | 4    | KPK magic word, always 'K', 'P', 'K', '\0'
+4      | 1    | kpk binary version
+5      | 3    | reserved
+8      | 4    | entry count
+12     | 4    | toc offset from start
+16     | 4    | name table offset from start
+20     | 4    | name table size
+24     | 8    | offset of the first data block
+
+# KPK toc entry, sorted by path hash
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+??     | 8    | hash of the virtual path
+??+8   | 8    | hash of the uncompressed content
+??+16  | 8    | data offset from start, always aligned to PACK_ALIGNMENT
+??+24  | 8    | stored size in the pack
+??+32  | 8    | uncompressed size
+??+40  | 4    | virtual path offset in the name table
+??+44  | 2    | virtual path length
+??+46  | 1    | entry flags
+??+47  | 1    | reserved
+
+Entry flags:
+	0 - compressed with the lz4 block format
+	1-7 - unused
+
+Virtual paths are relative to the 'files' folder with forward slashes,
+for example 'shaders/model.vert' or 'models/crusher.kmd'.
+
+------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Core
+{
+	using std::string;
+	using std::string_view;
+	using std::vector;
+	using std::filesystem::path;
+
+	constexpr u32 PACK_MAGIC = 0x004B504B;
+	constexpr u8 PACK_VERSION = 2;
+
+	constexpr u32 PACK_HEADER_SIZE = 32u;
+	constexpr u32 PACK_ENTRY_SIZE = 48u;
+
+	//every entry starts at a page boundary so it can be mapped directly
+	constexpr u64 PACK_ALIGNMENT = 4096u;
+
+	constexpr u8 PACK_FLAG_COMPRESSED = 1u << 0;
+
+	struct PackEntry
+	{
+		u64 pathHash{};
+		u64 contentHash{};
+		u64 offset{};
+		u64 storedSize{};
+		u64 rawSize{};
+		u32 nameOffset{};
+		u16 nameLength{};
+		u8 flags{};
+	};
+
+	//Optional settings for building a new pack
+	struct PackBuildSettings
+	{
+		//try to compress each entry, only kept if it actually saves space
+		bool compress = true;
+		//entries smaller than this are always stored raw
+		u64 minCompressSize = 512u;
+		//extensions that are already compressed and never worth compressing again
+		vector<string> storeOnlyExtensions = { ".flac", ".png", ".jpg", ".jpeg" };
+	};
+
+	class AssetPack
+	{
+	public:
+		//Maps the pack into memory and routes all Read* calls through it,
+		//anything not found inside the pack falls back to loose files
+		static bool Mount(const path& packPath);
+		static void Unmount();
+		static bool IsMounted();
+
+		//Root folder that virtual paths are relative to, defaults to current_path()/"files"
+		static void SetRootPath(const path& newRoot);
+		static const path& GetRootPath();
+
+		//Converts a loose file path into the virtual path used as the toc key
+		static string ToVirtualPath(const path& filePath);
+
+		//Returns the toc entry of this file or nullptr if it is not packed
+		static const PackEntry* FindEntry(const path& filePath);
+
+		//Returns true if this file exists inside the pack or as a loose file
+		static bool Exists(const path& filePath);
+
+		//Returns every file under dirPath inside the pack and on disk,
+		//as paths under the root path, each file listed once
+		static vector<path> ListFiles(const path& dirPath);
+
+		//Read a whole file from the pack or from disk,
+		//returns an empty string on success and the reason on failure
+		static string ReadText(
+			const path& filePath,
+			string& outText);
+		static string ReadBinary(
+			const path& filePath,
+			vector<u8>& outData);
+
+		//Returns a pointer straight into the mapped pack for uncompressed entries,
+		//stays valid until Unmount, returns nullptr if the entry is compressed or missing
+		static const u8* GetMappedData(
+			const path& filePath,
+			u64& outSize);
+
+		//Packs every regular file under sourceDir into a new pack at targetPack,
+		//returns an empty string on success and the reason on failure
+		static string BuildPack(
+			const path& sourceDir,
+			const path& targetPack,
+			const PackBuildSettings& settings = {});
+
+		//Reads every entry of an unmounted pack and compares it against its content hash
+		static string VerifyPack(const path& packPath);
+	};
+}
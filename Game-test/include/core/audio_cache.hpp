@@ -0,0 +1,72 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <filesystem>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Core
+{
+	using std::string;
+	using std::filesystem::path;
+
+	//sounds longer than this are streamed instead of decoded up front
+	constexpr f32 STREAM_THRESHOLD_SECONDS = 4.0f;
+
+	//size of each pool chunk in floats, larger sounds get a chunk of their own
+	constexpr size_t PCM_POOL_CHUNK_SAMPLES = 1024u * 1024u;
+
+	enum class AudioLoadMode
+	{
+		LOAD_AUTO,    //decoded or streamed based on STREAM_THRESHOLD_SECONDS
+		LOAD_DECODED, //always decoded to pcm at load time
+		LOAD_STREAMED //always stream-decoded during playback
+	};
+
+	//Fully decoded interleaved f32 pcm, owned by the cache
+	struct PcmBuffer
+	{
+		const f32* samples{};
+		u64 frameCount{};
+		u32 sampleRate{};
+		u8 channels{};
+	};
+
+	//Loads FLAC files once and keeps short sounds decoded in a pooled pcm arena,
+	//long sounds keep only their encoded bytes for AudioStream to decode on demand.
+	//Sounds are keyed by their virtual path, so packed and loose files are interchangeable.
+	class AudioCache
+	{
+	public:
+		static string Load(
+			const path& filePath,
+			AudioLoadMode mode = AudioLoadMode::LOAD_AUTO);
+
+		//Loads every .flac under dirPath, decoding across all hardware threads
+		static string LoadDirectory(const path& dirPath);
+
+		static bool IsLoaded(const path& filePath);
+		static bool IsStreamed(const path& filePath);
+
+		//Returns nullptr if the sound is not loaded or is streamed
+		static const PcmBuffer* GetBuffer(const path& filePath);
+
+		//Returns the encoded bytes of a streamed sound, nullptr if it is not loaded or is decoded
+		static const u8* GetStreamSource(
+			const path& filePath,
+			u64& outSize);
+
+		//Bytes reserved by the pcm pool and bytes handed out to sounds
+		static u64 GetPoolCapacity();
+		static u64 GetPoolUsage();
+
+		//Releases every sound, no stream may still be reading from the cache
+		static void Clear();
+	};
+}
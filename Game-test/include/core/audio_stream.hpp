@@ -0,0 +1,97 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <filesystem>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "core/flac_decoder.hpp"
+
+namespace GameTest::Core
+{
+	using std::string;
+	using std::vector;
+	using std::atomic;
+	using std::jthread;
+	using std::stop_token;
+	using std::filesystem::path;
+
+	//frames decoded per worker pass
+	constexpr u32 STREAM_CHUNK_FRAMES = 4096u;
+	//ring capacity in chunks, 8 chunks at 44.1KHz is roughly 0.75 seconds of lead
+	constexpr u32 STREAM_RING_CHUNKS = 8u;
+
+	//Decodes a FLAC source on its own worker thread into a lock-free
+	//single producer single consumer ring of interleaved f32 frames.
+	//Read is the only call meant for the playback thread.
+	class AudioStream
+	{
+	public:
+		AudioStream() = default;
+		~AudioStream();
+
+		AudioStream(const AudioStream&) = delete;
+		AudioStream& operator=(const AudioStream&) = delete;
+
+		//Streams a sound that AudioCache loaded as streamed
+		string Open(
+			const path& filePath,
+			bool isLooping);
+
+		//Streams raw FLAC bytes, the data must outlive the stream
+		string Open(
+			const u8* data,
+			size_t size,
+			bool isLooping);
+
+		void Close();
+
+		//Copies up to frameCount frames into outSamples and zero-fills the rest,
+		//returns how many real frames were copied
+		size_t Read(
+			f32* outSamples,
+			size_t frameCount);
+
+		u32 GetSampleRate() const { return decoder.GetInfo().sampleRate; }
+		u8 GetChannels() const { return decoder.GetInfo().channels; }
+
+		//True once a non-looping stream has handed out its last frame
+		bool HasFinished() const;
+
+		//How many Read calls came up short before the end of the stream
+		u64 GetUnderrunCount() const { return underruns.load(std::memory_order_relaxed); }
+		//Frames currently decoded ahead of the reader
+		size_t GetBufferedFrames() const;
+	private:
+		void DecodeLoop(stop_token stop);
+
+		FlacDecoder decoder{};
+		bool isLooping{};
+
+		vector<f32> ring{};
+		size_t ringFrames{};
+
+		//monotonic frame counters, the ring index is the counter modulo ringFrames
+		alignas(64) atomic<u64> writeFrame{};
+		alignas(64) atomic<u64> readFrame{};
+
+		//bumped by every Read and by Close so a waiting worker always wakes up
+		alignas(64) atomic<u32> wakeSignal{};
+
+		atomic<bool> isDecodeDone{};
+		atomic<u64> underruns{};
+
+		string decodeError{};
+
+		jthread worker{};
+	};
+}
@@ -0,0 +1,42 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string_view>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+#include "KalaHeaders/hash_utils.hpp"
+
+namespace GameTest::Core
+{
+	using std::string_view;
+
+	using KalaHeaders::KalaHash::HashBytes64;
+
+	//64-bit non-cryptographic hash used for asset paths and asset contents,
+	//stable across runs and platforms so it can be stored inside files.
+	//Hashes are xxh3 from hash_utils.hpp, changing the hash means bumping
+	//the version of every file format that stores one
+	class ContentHash
+	{
+	public:
+		static inline u64 HashBytes(
+			const void* data,
+			size_t size,
+			u64 seed = 0)
+		{
+			return HashBytes64(data, size, seed);
+		}
+
+		static inline u64 HashString(
+			string_view text,
+			u64 seed = 0)
+		{
+			return HashBytes64(text.data(), text.size(), seed);
+		}
+	};
+}
@@ -0,0 +1,345 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <type_traits>
+#include <typeinfo>
+#include <new>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "core/thread_pool.hpp"
+
+namespace GameTest::Core
+{
+	using std::vector;
+	using std::array;
+	using std::unique_ptr;
+	using std::unordered_map;
+	using std::function;
+	using std::is_trivially_destructible_v;
+	using std::is_standard_layout_v;
+
+	//most component types there can be, each one is a bit in an archetype mask
+	constexpr u32 ECS_MAX_COMPONENTS = 64u;
+
+	//bytes of one chunk, how many entities fit follows from the row size of the archetype
+	constexpr size_t ECS_CHUNK_BYTES = 16u * 1024u;
+
+	//column index of a component the archetype doesn't have
+	constexpr u8 ECS_NO_COLUMN = 0xFFu;
+
+	using EcsComponentID = u32;
+	using EcsMask = u64;
+
+	//Generational entity handle, a handle to a destroyed and reused slot is simply not alive
+	struct EcsEntity
+	{
+		u32 index{};
+		u32 generation{};
+
+		bool IsValid() const { return generation != 0; }
+
+		bool operator==(const EcsEntity& other) const
+		{
+			return index == other.index
+				&& generation == other.generation;
+		}
+	};
+
+	struct EcsComponentInfo
+	{
+		size_t size{};
+		size_t alignment{};
+		const char* name{};
+	};
+
+	//Component ids are shared by every world and handed out the first time a type is used
+	class EcsComponents
+	{
+	public:
+		template<typename T>
+		static EcsComponentID GetID()
+		{
+			//rows are relocated with memcpy and never destroyed, so components can't own resources.
+			//math types have user copy constructors but are plain floats, so trivial copyability isn't required
+			static_assert(is_trivially_destructible_v<T>, "ecs components must be trivially destructible");
+			static_assert(is_standard_layout_v<T>, "ecs components must be standard layout");
+			static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "ecs components can't be over-aligned");
+
+			static const EcsComponentID id = Register(
+				sizeof(T),
+				alignof(T),
+				typeid(T).name());
+
+			return id;
+		}
+
+		template<typename... T>
+		static EcsMask GetMask()
+		{
+			return (EcsMask{} | ... | (EcsMask{ 1 } << GetID<T>()));
+		}
+
+		static const EcsComponentInfo& GetInfo(EcsComponentID id);
+		static u32 GetCount();
+	private:
+		//force closes when ECS_MAX_COMPONENTS is exceeded
+		static EcsComponentID Register(
+			size_t size,
+			size_t alignment,
+			const char* name);
+	};
+
+	//Rows of one archetype, every component is its own column
+	struct EcsChunk
+	{
+		unique_ptr<u8[]> data{};
+		u32 count{};
+
+		//world tick of the last write to each column
+		vector<u32> changedTicks{};
+	};
+
+	//Every entity with exactly the same set of components
+	struct EcsArchetype
+	{
+		EcsMask mask{};
+		vector<EcsComponentID> components{};
+
+		//byte offset of each column inside a chunk, the entity column is at 0
+		vector<size_t> columnOffsets{};
+		vector<size_t> columnSizes{};
+		//column of each component id, ECS_NO_COLUMN if the archetype lacks it
+		array<u8, ECS_MAX_COMPONENTS> columnOf{};
+
+		u32 chunkCapacity{};
+		size_t chunkBytes{};
+
+		//every chunk but the last is full
+		vector<unique_ptr<EcsChunk>> chunks{};
+	};
+
+	//Access to one matching chunk while a query runs
+	class EcsChunkView
+	{
+	public:
+		u32 GetCount() const { return chunk->count; }
+		const EcsEntity* GetEntities() const { return reinterpret_cast<const EcsEntity*>(chunk->data.get()); }
+
+		//rows of every matching chunk before this one, for writing results into one flat array
+		size_t GetQueryOffset() const { return queryOffset; }
+
+		template<typename T>
+		bool Has() const { return archetype->columnOf[EcsComponents::GetID<T>()] != ECS_NO_COLUMN; }
+
+		//Null if the archetype lacks T
+		template<typename T>
+		const T* Read() const { return scast<const T*>(GetColumn(EcsComponents::GetID<T>())); }
+
+		//Marks the column as changed at the current tick, null if the archetype lacks T
+		template<typename T>
+		T* Write()
+		{
+			EcsComponentID id = EcsComponents::GetID<T>();
+			MarkChanged(id);
+
+			return scast<T*>(GetColumn(id));
+		}
+
+		//Writable access that leaves the change tick alone, call MarkChanged if anything was modified
+		template<typename T>
+		T* Peek() { return scast<T*>(GetColumn(EcsComponents::GetID<T>())); }
+
+		template<typename T>
+		void MarkChanged() { MarkChanged(EcsComponents::GetID<T>()); }
+
+		//True if T was written after sinceTick
+		template<typename T>
+		bool HasChanged(u32 sinceTick) const
+		{
+			u8 column = archetype->columnOf[EcsComponents::GetID<T>()];
+			return column != ECS_NO_COLUMN
+				&& chunk->changedTicks[column] > sinceTick;
+		}
+	private:
+		friend class EcsWorld;
+
+		void* GetColumn(EcsComponentID id) const;
+		void MarkChanged(EcsComponentID id);
+
+		EcsArchetype* archetype{};
+		EcsChunk* chunk{};
+		size_t queryOffset{};
+		u32 tick{};
+	};
+
+	//Archetype based entity storage. Entities with the same components share chunks,
+	//and each component of a chunk is one tightly packed column, so a query only pulls
+	//the columns it asks for through the cache. Structural changes (create, destroy,
+	//adding and removing components) must happen on one thread outside of queries,
+	//chunks of a parallel query are processed by one worker each.
+	class EcsWorld
+	{
+	public:
+		EcsWorld();
+
+		EcsWorld(const EcsWorld&) = delete;
+		EcsWorld& operator=(const EcsWorld&) = delete;
+
+		//Creates an entity without components
+		EcsEntity Create();
+
+		//Creates an entity directly in the archetype of T...
+		template<typename... T>
+		EcsEntity Create(const T&... values)
+		{
+			EcsEntity entity = CreateWithMask(EcsComponents::GetMask<T...>());
+			(new (GetComponent(entity, EcsComponents::GetID<T>())) T(values), ...);
+
+			return entity;
+		}
+
+		void Destroy(EcsEntity entity);
+		bool IsAlive(EcsEntity entity) const;
+
+		//Adds or overwrites T, moves the entity to a new archetype if it didn't have T
+		template<typename T>
+		void Add(
+			EcsEntity entity,
+			const T& value)
+		{
+			void* dst = AddComponent(entity, EcsComponents::GetID<T>());
+			if (dst) new (dst) T(value);
+		}
+
+		template<typename T>
+		void Remove(EcsEntity entity) { RemoveComponent(entity, EcsComponents::GetID<T>()); }
+
+		template<typename T>
+		bool Has(EcsEntity entity) const { return GetComponent(entity, EcsComponents::GetID<T>()) != nullptr; }
+
+		//Null if the entity is dead or lacks T, reading doesn't count as a change
+		template<typename T>
+		const T* Get(EcsEntity entity) const { return scast<const T*>(GetComponent(entity, EcsComponents::GetID<T>())); }
+
+		//Overwrites T and marks its column as changed, false if the entity lacks T
+		template<typename T>
+		bool Set(
+			EcsEntity entity,
+			const T& value)
+		{
+			EcsComponentID id = EcsComponents::GetID<T>();
+
+			void* dst = GetComponent(entity, id);
+			if (!dst) return false;
+
+			*scast<T*>(dst) = value;
+			MarkChanged(entity, id);
+
+			return true;
+		}
+
+		//Runs func on every chunk that has all of T... and none of exclude
+		template<typename... T>
+		void ForEachChunk(
+			const function<void(EcsChunkView&)>& func,
+			EcsMask exclude = 0)
+		{
+			RunQuery(EcsComponents::GetMask<T...>(), exclude, nullptr, func);
+		}
+
+		//Same as ForEachChunk but spreads the chunks over workers, null workers runs on the calling thread
+		template<typename... T>
+		void ParallelForEachChunk(
+			ThreadPool* workers,
+			const function<void(EcsChunkView&)>& func,
+			EcsMask exclude = 0)
+		{
+			RunQuery(EcsComponents::GetMask<T...>(), exclude, workers, func);
+		}
+
+		//Entities that have all of T...
+		template<typename... T>
+		size_t Count(EcsMask exclude = 0) const { return CountMatching(EcsComponents::GetMask<T...>(), exclude); }
+
+		//Systems call this before they run, it returns the tick that just ended.
+		//A system remembers it and on its next run skips chunks that didn't change after it
+		u32 AdvanceTick();
+		u32 GetTick() const { return tick; }
+
+		size_t GetEntityCount() const { return aliveCount; }
+		size_t GetArchetypeCount() const { return archetypes.size(); }
+
+		//Destroys every entity and archetype
+		void Clear();
+	private:
+		struct EntityRecord
+		{
+			u32 archetype{};
+			u32 chunk{};
+			u32 row{};
+			u32 generation{};
+		};
+
+		EcsEntity CreateWithMask(EcsMask mask);
+
+		void* GetComponent(
+			EcsEntity entity,
+			EcsComponentID id) const;
+		void* AddComponent(
+			EcsEntity entity,
+			EcsComponentID id);
+		void RemoveComponent(
+			EcsEntity entity,
+			EcsComponentID id);
+		void MarkChanged(
+			EcsEntity entity,
+			EcsComponentID id);
+
+		u32 GetOrCreateArchetype(EcsMask mask);
+
+		//Appends a row for entity to the last chunk of the archetype
+		void AllocateRow(
+			u32 archetypeIndex,
+			EcsEntity entity);
+
+		//Fills the hole with the last row of the archetype so every chunk but the last stays full
+		void FreeRow(
+			u32 archetypeIndex,
+			u32 chunkIndex,
+			u32 row);
+
+		//Moves entity into the archetype of newMask, keeping the components both have
+		void MoveEntity(
+			EcsEntity entity,
+			EcsMask newMask);
+
+		void RunQuery(
+			EcsMask include,
+			EcsMask exclude,
+			ThreadPool* workers,
+			const function<void(EcsChunkView&)>& func);
+		size_t CountMatching(
+			EcsMask include,
+			EcsMask exclude) const;
+
+		vector<unique_ptr<EcsArchetype>> archetypes{};
+		unordered_map<EcsMask, u32> archetypeLookup{};
+
+		vector<EntityRecord> records{};
+		vector<u32> freeRecords{};
+		size_t aliveCount{};
+
+		u32 tick = 1;
+	};
+}
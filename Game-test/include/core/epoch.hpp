@@ -0,0 +1,49 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Core
+{
+	//most threads that can be inside a read section at once over the lifetime of the program,
+	//slots of exited threads are reused
+	constexpr u32 EPOCH_MAX_READERS = 128u;
+
+	//Epoch based reclamation shared by every reader of published data.
+	//A reader pins the current epoch for the length of its read section, a writer that
+	//replaces published data advances the epoch and may free the old data once every
+	//pinned epoch is newer than the one it was retired at. Reading never locks,
+	//entering and leaving a section is one store each to a slot owned by the thread
+	class Epoch
+	{
+	public:
+		//Sections nest, only the outermost one pins an epoch
+		static void EnterRead();
+		static void ExitRead();
+
+		//Starts a new epoch and returns the one that ended,
+		//data unpublished before this call is retired at the returned epoch
+		static u64 Advance();
+
+		//Oldest epoch still pinned by a reader, or the current epoch when nobody reads.
+		//Data retired at an epoch older than this can no longer be reached
+		static u64 GetOldestActive();
+
+		static u64 GetCurrent();
+	};
+
+	//Pins the epoch for the lifetime of the guard
+	class EpochReadGuard
+	{
+	public:
+		EpochReadGuard() { Epoch::EnterRead(); }
+		~EpochReadGuard() { Epoch::ExitRead(); }
+
+		EpochReadGuard(const EpochReadGuard&) = delete;
+		EpochReadGuard& operator=(const EpochReadGuard&) = delete;
+	};
+}
@@ -0,0 +1,77 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Core
+{
+	using std::string;
+	using std::vector;
+
+	//FLAC allows up to 8 channels but everything in 'files/audio' is mono or stereo
+	constexpr u8 FLAC_MAX_CHANNELS = 8;
+
+	struct FlacInfo
+	{
+		u32 sampleRate{};
+		u8 channels{};
+		u8 bitsPerSample{};
+		u16 maxBlockSize{};
+
+		//0 if unknown
+		u64 totalFrames{};
+
+		u8 md5[16]{};
+	};
+
+	//Decodes a FLAC stream from memory into interleaved f32 samples in [-1, 1].
+	//The source bytes are not copied and must outlive the decoder.
+	//A frame here is one sample per channel, the same as a PCM frame.
+	class FlacDecoder
+	{
+	public:
+		//Parses the stream header and metadata blocks,
+		//returns an empty string on success and the reason on failure
+		string Open(
+			const u8* data,
+			size_t size);
+
+		bool IsOpen() const { return data != nullptr; }
+		const FlacInfo& GetInfo() const { return info; }
+
+		//Decodes up to frameCount frames into outSamples, which must hold
+		//frameCount * channels floats. outFramesRead is 0 once the stream has ended
+		string ReadFrames(
+			f32* outSamples,
+			size_t frameCount,
+			size_t& outFramesRead);
+
+		//Returns to the first audio frame
+		void Rewind();
+
+		bool IsAtEnd() const;
+	private:
+		string DecodeBlock();
+
+		const u8* data{};
+		size_t size{};
+
+		size_t firstFrameOffset{};
+		size_t readOffset{};
+
+		FlacInfo info{};
+
+		//decoded samples of the current block per channel, and how many were handed out
+		vector<i32> blockSamples[FLAC_MAX_CHANNELS]{};
+		u32 blockSize{};
+		u32 blockCursor{};
+	};
+}
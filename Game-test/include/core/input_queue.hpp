@@ -0,0 +1,79 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Core
+{
+	using KalaHeaders::KalaMath::vec2;
+
+	//ring capacity, must stay a power of two
+	constexpr u32 INPUT_QUEUE_SIZE = 1024;
+
+	enum class InputEventType : u8
+	{
+		EVENT_INVALID = 0,
+
+		EVENT_KEY_DOWN,
+		EVENT_KEY_UP,
+
+		EVENT_MOUSE_DOWN,
+		EVENT_MOUSE_UP,
+
+		//raw mouse movement, stored in delta
+		EVENT_MOUSE_MOVE,
+		//scrollwheel movement, stored in delta.y
+		EVENT_MOUSE_SCROLL
+	};
+
+	struct InputEvent
+	{
+		InputEventType type{};
+		//KeyboardButton or MouseButton value depending on type
+		u32 code{};
+		vec2 delta{};
+		//steady clock time in nanoseconds when the window message behind the event was handled
+		u64 timestamp{};
+	};
+
+	//Lock-free single-producer single-consumer queue of timestamped input events.
+	//The producer is whichever thread pumps window messages,
+	//the consumer is whichever thread runs the simulation.
+	class InputQueue
+	{
+	public:
+		//Producer side: hooks the main window procedure so every key, mouse button,
+		//movement and scroll change is pushed in message order with the time its
+		//message was handled. Call once after the main window and its input exist
+		static void HookWindow();
+
+		//Puts the original window procedure back, call before the main window or its input are destroyed.
+		//If something else subclassed the window after HookWindow the hook stays in place
+		//and keeps forwarding, since removing it would cut that subclass off too
+		static void UnhookWindow();
+
+		//Producer side: pushes whatever changed since the last handled message,
+		//everything if the window isn't hooked, and resets the per-frame input state
+		static void Pump();
+
+		//Producer side: returns false and counts the drop if the queue is full
+		static bool Push(const InputEvent& e);
+
+		//Consumer side: returns false if the queue is empty
+		static bool Pop(InputEvent& out);
+
+		//Current steady clock time in nanoseconds
+		static u64 Now();
+
+		//How many events were dropped because the consumer fell behind
+		static u32 GetDroppedCount();
+
+		//Drops all queued events, only call while neither side is running
+		static void Clear();
+	};
+}
@@ -0,0 +1,42 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <filesystem>
+
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Core
+{
+	using std::filesystem::path;
+
+	//Read-only view of a whole file
+	struct MappedFile
+	{
+		const u8* data{};
+		u64 size{};
+
+#ifdef _WIN32
+		//file and mapping handles, kept as void* so windows.h stays out of headers
+		void* file = reinterpret_cast<void*>(-1);
+		void* mapping{};
+#else
+		int fd = -1;
+#endif
+	};
+
+	class FileMapping
+	{
+	public:
+		//Maps the whole file read-only, false if it is missing, empty or can't be mapped
+		static bool Map(
+			const path& target,
+			MappedFile& outFile);
+
+		//Unmaps the file and resets it, safe to call on a file that was never mapped
+		static void Unmap(MappedFile& file);
+	};
+}
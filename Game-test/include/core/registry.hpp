@@ -10,6 +10,15 @@
 #include <memory>
 #include <algorithm>
 #include <type_traits>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "core/epoch.hpp"
 
 namespace GameTest::Core
 {
@@ -17,12 +26,186 @@ namespace GameTest::Core
 	using std::vector;
 	using std::unique_ptr;
 	using std::make_unique;
+	using std::move;
 	using std::find;
 	using std::remove;
 	using std::remove_if;
+	using std::sort;
+	using std::unique;
+	using std::binary_search;
 	using std::is_class_v;
+	using std::function;
+	using std::mutex;
+	using std::lock_guard;
+	using std::atomic;
+	using std::memory_order_relaxed;
+	using std::memory_order_seq_cst;
+	using std::to_string;
+
+	using KalaHeaders::KalaLog::Log;
+	using KalaHeaders::KalaLog::LogType;
 	
+	using u8 = uint8_t;
 	using u32 = uint32_t;
+	using u64 = uint64_t;
+
+	template<typename T>
+		requires is_class_v<T>
+	struct Registry;
+
+	//Immutable copy of runtimeContent published for readers on other threads
+	template<typename T>
+		requires is_class_v<T>
+	struct RegistrySnapshot
+	{
+		vector<T*> content{};
+		//increases by one with every publish
+		u64 version{};
+	};
+
+	//Lock-free read access to the latest published snapshot. The list and every object in it
+	//stay valid for the lifetime of the view even if the owning thread removes them meanwhile,
+	//keep views short since nothing retired after they opened can be freed until they close
+	template<typename T>
+		requires is_class_v<T>
+	class RegistryReadView
+	{
+	public:
+		explicit RegistryReadView(const atomic<const RegistrySnapshot<T>*>& published)
+			: snapshot(published.load(memory_order_seq_cst)) {}
+
+		RegistryReadView(const RegistryReadView&) = delete;
+		RegistryReadView& operator=(const RegistryReadView&) = delete;
+
+		T* const* begin() const { return snapshot ? snapshot->content.data() : nullptr; }
+		T* const* end() const { return snapshot ? snapshot->content.data() + snapshot->content.size() : nullptr; }
+
+		size_t size() const { return snapshot ? snapshot->content.size() : 0; }
+		bool empty() const { return size() == 0; }
+		T* operator[](size_t index) const { return snapshot->content[index]; }
+
+		//0 if nothing was published yet
+		u64 GetVersion() const { return snapshot ? snapshot->version : 0; }
+	private:
+		//declared first so the epoch is pinned before the snapshot pointer is loaded
+		EpochReadGuard guard{};
+		const RegistrySnapshot<T>* snapshot{};
+	};
+
+	enum class RegistryCommandType : u8
+	{
+		COMMAND_CREATE,
+		COMMAND_DESTROY,
+		COMMAND_SET_PARENT,
+		COMMAND_REMOVE_PARENT
+	};
+
+	//Structural changes recorded by one thread while others iterate the registry,
+	//nothing is touched until Registry<T>::PlaybackCommands runs at a sync point.
+	//Get the calling thread's buffer with Registry<T>::GetCommandBuffer,
+	//a buffer must only be written by the thread that owns it
+	template<typename T>
+		requires is_class_v<T>
+	class RegistryCommandBuffer
+	{
+	public:
+		//Queues new content, its pointer is already valid for recording parent changes
+		//and destroys in the same batch but it isn't in the registry until playback.
+		//The returned pointer only outlives playback if the create was applied,
+		//creates whose ID is already taken or that are destroyed in the same batch are freed there
+		inline T* Create(
+			u32 targetID,
+			unique_ptr<T> targetContent)
+		{
+			if (!targetContent
+				|| targetID == 0)
+			{
+				return nullptr;
+			}
+
+			T* raw = targetContent.get();
+
+			Command command{};
+			command.type = RegistryCommandType::COMMAND_CREATE;
+			command.targetID = targetID;
+			command.target = raw;
+			command.content = move(targetContent);
+			Push(move(command));
+
+			return raw;
+		}
+
+		inline void Destroy(T* targetPtr)
+		{
+			if (!targetPtr) return;
+
+			Command command{};
+			command.type = RegistryCommandType::COMMAND_DESTROY;
+			command.target = targetPtr;
+			Push(move(command));
+		}
+		//Resolved at playback, so content queued for creation in the same batch can be destroyed by ID too
+		inline void Destroy(u32 targetID)
+		{
+			if (targetID == 0) return;
+
+			Command command{};
+			command.type = RegistryCommandType::COMMAND_DESTROY;
+			command.targetID = targetID;
+			Push(move(command));
+		}
+
+		//Only the last parent change of a child in a batch is applied
+		inline void SetParent(
+			T* child,
+			T* parent)
+		{
+			if (!child
+				|| !parent
+				|| child == parent)
+			{
+				return;
+			}
+
+			Command command{};
+			command.type = RegistryCommandType::COMMAND_SET_PARENT;
+			command.target = child;
+			command.parent = parent;
+			Push(move(command));
+		}
+		inline void RemoveParent(T* child)
+		{
+			if (!child) return;
+
+			Command command{};
+			command.type = RegistryCommandType::COMMAND_REMOVE_PARENT;
+			command.target = child;
+			Push(move(command));
+		}
+
+		inline size_t GetCommandCount() const { return commands.size(); }
+	private:
+		friend struct Registry<T>;
+
+		struct Command
+		{
+			RegistryCommandType type{};
+			//global record order, decides which of two conflicting commands wins
+			u64 sequence{};
+			u32 targetID{};
+			T* target{};
+			T* parent{};
+			unique_ptr<T> content{};
+		};
+
+		inline void Push(Command&& command)
+		{
+			command.sequence = Registry<T>::commandSequence.fetch_add(1, std::memory_order_relaxed);
+			commands.push_back(move(command));
+		}
+
+		vector<Command> commands{};
+	};
 	
 	//Stores local non-owning pointers per T instance inside the Registry struct
 	template<typename T>
@@ -250,6 +433,15 @@ namespace GameTest::Core
 		//Hierarchy content for storing parent-child relations per instance of this class
 		static inline unordered_map<T*, Hierarchy<T>> hierarchy{};
 
+		//Command buffer of every thread that has recorded structural changes,
+		//buffers live as long as the program so their threads can cache them
+		static inline vector<unique_ptr<RegistryCommandBuffer<T>>> commandBuffers{};
+		static inline mutex commandMutex{};
+		static inline atomic<u64> commandSequence{};
+
+		//Content list readers on other threads see, replaced as a whole by PublishSnapshot
+		static inline atomic<const RegistrySnapshot<T>*> publishedSnapshot{};
+
 		//Get non-owning value by ID
 		static inline T* GetContent(u32 targetID)
 		{
@@ -279,6 +471,8 @@ namespace GameTest::Core
 			hierarchy[raw] = Hierarchy<T>{};
 			hierarchy[raw].thisObject = raw;
 
+			isSnapshotDirty = true;
+
 			return true;
 		}
 
@@ -315,7 +509,10 @@ namespace GameTest::Core
 					}),
 				runtimeContent.end());
 
-			createdContent.erase(targetID);
+			auto owned = createdContent.find(targetID);
+			if (owned != createdContent.end()) ReleaseContent(owned);
+
+			isSnapshotDirty = true;
 
 			return true;
 		}
@@ -358,20 +555,324 @@ namespace GameTest::Core
 				targetPtr),
 				runtimeContent.end());
 
-			if (createdContent.contains(targetPtr->GetID()))
-			{
-				createdContent.erase(targetPtr->GetID());
-			}
+			auto owned = createdContent.find(targetPtr->GetID());
+			if (owned != createdContent.end()) ReleaseContent(owned);
+
+			isSnapshotDirty = true;
 
 			return true;
 		}
 
+		//Also frees every snapshot, no reader may be inside a view
 		static inline void RemoveAllContent()
 		{
+			{
+				lock_guard<mutex> lock(commandMutex);
+				for (auto& buffer : commandBuffers) buffer->commands.clear();
+			}
+
+			delete publishedSnapshot.exchange(nullptr, memory_order_seq_cst);
+			retiredSnapshots.clear();
+			unpublishedRemovals.clear();
+			isSnapshotEnabled = false;
+			isSnapshotDirty = false;
+
 			hierarchy.clear();
 			createdContent.clear();
 			runtimeContent.clear();
 		}
+
+		//
+		// SNAPSHOTS
+		//
+
+		//Opens a lock-free view of the last published content list,
+		//safe to call from any thread while the owning thread keeps mutating the registry
+		static inline RegistryReadView<T> ReadSnapshot() { return RegistryReadView<T>(publishedSnapshot); }
+
+		//Publishes runtimeContent for readers if it changed since the last publish, then frees
+		//every old snapshot and removed object that no reader can reach anymore.
+		//The first call turns on snapshot mode, from then on removed content outlives
+		//the registry entry until it has been unpublished and every older reader is gone.
+		//Must only be called from the thread that mutates the registry
+		static inline void PublishSnapshot()
+		{
+			isSnapshotEnabled = true;
+
+			if (isSnapshotDirty
+				|| !publishedSnapshot.load(memory_order_relaxed))
+			{
+				auto next = make_unique<RegistrySnapshot<T>>();
+				next->content = runtimeContent;
+				next->version = ++snapshotVersion;
+
+				const RegistrySnapshot<T>* previous = publishedSnapshot.exchange(
+					next.release(),
+					memory_order_seq_cst);
+
+				//readers that could still see previous pinned this epoch or an older one
+				RetiredSnapshot retired{};
+				retired.epoch = Epoch::Advance();
+				retired.snapshot.reset(previous);
+				retired.content = move(unpublishedRemovals);
+				unpublishedRemovals.clear();
+
+				retiredSnapshots.push_back(move(retired));
+				isSnapshotDirty = false;
+			}
+
+			ReclaimSnapshots();
+		}
+
+		//Frees retired snapshots and content that no reader can reach anymore
+		static inline void ReclaimSnapshots()
+		{
+			if (retiredSnapshots.empty()) return;
+
+			u64 oldestActive = Epoch::GetOldestActive();
+
+			retiredSnapshots.erase(remove_if(
+				retiredSnapshots.begin(),
+				retiredSnapshots.end(),
+				[oldestActive](const RetiredSnapshot& retired)
+				{
+					return retired.epoch < oldestActive;
+				}),
+				retiredSnapshots.end());
+		}
+
+		static inline size_t GetRetiredSnapshotCount() { return retiredSnapshots.size(); }
+
+		//
+		// DEFERRED STRUCTURAL CHANGES
+		//
+
+		//Returns the command buffer of the calling thread
+		static inline RegistryCommandBuffer<T>& GetCommandBuffer()
+		{
+			static thread_local RegistryCommandBuffer<T>* localBuffer{};
+
+			if (!localBuffer)
+			{
+				lock_guard<mutex> lock(commandMutex);
+
+				commandBuffers.push_back(make_unique<RegistryCommandBuffer<T>>());
+				localBuffer = commandBuffers.back().get();
+			}
+
+			return *localBuffer;
+		}
+
+		//Applies every recorded command as one batch, must run at a sync point
+		//where no thread iterates the registry or records commands.
+		//Commands are sorted and coalesced first: content created and destroyed in the same batch
+		//is never added, creates with an ID that is already taken are logged and freed,
+		//repeated destroys collapse into one and only the last parent change of each child is kept.
+		//Destroys then sweep the hierarchy and compact runtimeContent in a single pass each,
+		//so removing many objects costs the same as removing one.
+		//onDestroyed runs while the content is still alive, onCreated after it was added
+		static inline void PlaybackCommands(
+			const function<void(T*)>& onCreated = {},
+			const function<void(T*)>& onDestroyed = {})
+		{
+			using Command = typename RegistryCommandBuffer<T>::Command;
+
+			vector<Command> creates{};
+			vector<Command> destroys{};
+			vector<Command> parentChanges{};
+
+			{
+				lock_guard<mutex> lock(commandMutex);
+
+				for (auto& buffer : commandBuffers)
+				{
+					for (Command& command : buffer->commands)
+					{
+						switch (command.type)
+						{
+						case RegistryCommandType::COMMAND_CREATE:
+							creates.push_back(move(command));
+							break;
+						case RegistryCommandType::COMMAND_DESTROY:
+							destroys.push_back(move(command));
+							break;
+						default:
+							parentChanges.push_back(move(command));
+							break;
+						}
+					}
+
+					buffer->commands.clear();
+				}
+			}
+
+			if (creates.empty()
+				&& destroys.empty()
+				&& parentChanges.empty())
+			{
+				return;
+			}
+
+			auto bySequence = [](const Command& a, const Command& b) { return a.sequence < b.sequence; };
+
+			//first create of an ID wins, later ones with the same ID are dropped
+			sort(creates.begin(), creates.end(), bySequence);
+
+			unordered_map<u32, T*> pendingIDs{};
+			pendingIDs.reserve(creates.size());
+			for (const Command& command : creates) pendingIDs.try_emplace(command.targetID, command.target);
+
+			//resolve destroys by ID to pointers, IDs that match nothing are dropped
+			vector<T*> doomed{};
+			doomed.reserve(destroys.size());
+
+			for (const Command& command : destroys)
+			{
+				T* target = command.target;
+
+				if (!target)
+				{
+					auto pending = pendingIDs.find(command.targetID);
+
+					target = pending != pendingIDs.end()
+						? pending->second
+						: GetContent(command.targetID);
+				}
+
+				if (target) doomed.push_back(target);
+			}
+
+			sort(doomed.begin(), doomed.end());
+			doomed.erase(unique(doomed.begin(), doomed.end()), doomed.end());
+
+			auto isDoomed = [&doomed](T* target)
+			{
+				return binary_search(doomed.begin(), doomed.end(), target);
+			};
+
+			//destroys only apply to content that is already in the registry,
+			//pending content that is also doomed is simply never added
+			vector<T*> removed{};
+			removed.reserve(doomed.size());
+
+			for (T* target : doomed)
+			{
+				if (hierarchy.contains(target)) removed.push_back(target);
+			}
+
+			if (!removed.empty())
+			{
+				if (onDestroyed)
+				{
+					for (T* target : removed) onDestroyed(target);
+				}
+
+				auto isRemoved = [&removed](T* target)
+				{
+					return binary_search(removed.begin(), removed.end(), target);
+				};
+
+				for (T* target : removed) hierarchy.erase(target);
+
+				for (auto& [obj, node] : hierarchy)
+				{
+					if (node.parent
+						&& isRemoved(node.parent))
+					{
+						node.parent = nullptr;
+					}
+
+					node.children.erase(remove_if(
+						node.children.begin(),
+						node.children.end(),
+						isRemoved),
+						node.children.end());
+				}
+
+				runtimeContent.erase(remove_if(
+					runtimeContent.begin(),
+					runtimeContent.end(),
+					isRemoved),
+					runtimeContent.end());
+
+				//content is freed last so callbacks and the sweeps above never see dangling pointers
+				for (T* target : removed)
+				{
+					auto owned = createdContent.find(target->GetID());
+					if (owned != createdContent.end()) ReleaseContent(owned);
+				}
+
+				isSnapshotDirty = true;
+			}
+
+			vector<T*> added{};
+			added.reserve(creates.size());
+
+			for (Command& command : creates)
+			{
+				//created and destroyed in the same batch, freed with the command
+				if (isDoomed(command.target)) continue;
+
+				if (createdContent.contains(command.targetID))
+				{
+					Log::Print(
+						"Rejected queued create for ID '" + to_string(command.targetID) + "' because the ID is already taken! "
+						"The pointer returned by RegistryCommandBuffer::Create is no longer valid.",
+						"REGISTRY",
+						LogType::LOG_ERROR,
+						2);
+
+					continue;
+				}
+
+				T* raw = command.target;
+				createdContent[command.targetID] = move(command.content);
+				runtimeContent.push_back(raw);
+
+				hierarchy[raw] = Hierarchy<T>{};
+				hierarchy[raw].thisObject = raw;
+
+				added.push_back(raw);
+			}
+
+			if (!added.empty()) isSnapshotDirty = true;
+
+			//group parent changes per child with the newest last, only that one is applied
+			sort(parentChanges.begin(), parentChanges.end(),
+				[](const Command& a, const Command& b)
+				{
+					return a.target != b.target
+						? a.target < b.target
+						: a.sequence < b.sequence;
+				});
+
+			size_t kept{};
+			for (size_t i = 0; i < parentChanges.size(); ++i)
+			{
+				if (i + 1 < parentChanges.size()
+					&& parentChanges[i + 1].target == parentChanges[i].target)
+				{
+					continue;
+				}
+
+				parentChanges[kept++] = move(parentChanges[i]);
+			}
+			parentChanges.resize(kept);
+
+			//survivors run in record order so conflicting moves resolve the same way every time
+			sort(parentChanges.begin(), parentChanges.end(), bySequence);
+
+			for (const Command& command : parentChanges)
+			{
+				if (command.type == RegistryCommandType::COMMAND_SET_PARENT) ApplyParent(command.target, command.parent);
+				else ApplyParent(command.target, nullptr);
+			}
+
+			if (onCreated)
+			{
+				for (T* raw : added) onCreated(raw);
+			}
+		}
 		
 		//
 		// WINDOW-RELATED ACTIONS
@@ -435,10 +936,71 @@ namespace GameTest::Core
 			{
 				if (it->second->GetWindowID() == windowID)
 				{
-					it = createdContent.erase(it);
+					it = ReleaseContent(it);
 				}
 				else ++it;
 			}
+
+			isSnapshotDirty = true;
+		}
+	private:
+		struct RetiredSnapshot
+		{
+			u64 epoch{};
+			unique_ptr<const RegistrySnapshot<T>> snapshot{};
+			//content removed while snapshot was the published one
+			vector<unique_ptr<T>> content{};
+		};
+
+		static inline vector<RetiredSnapshot> retiredSnapshots{};
+		static inline vector<unique_ptr<T>> unpublishedRemovals{};
+		static inline u64 snapshotVersion{};
+		static inline bool isSnapshotEnabled{};
+		static inline bool isSnapshotDirty{};
+
+		//Erases owned content, in snapshot mode it is kept alive until no snapshot can reach it
+		static inline typename unordered_map<u32, unique_ptr<T>>::iterator ReleaseContent(
+			typename unordered_map<u32, unique_ptr<T>>::iterator it)
+		{
+			if (isSnapshotEnabled) unpublishedRemovals.push_back(move(it->second));
+			return createdContent.erase(it);
+		}
+
+		//Moves child under parent or detaches it when parent is null,
+		//ignored if either is missing or the move would create a cycle
+		static inline void ApplyParent(
+			T* child,
+			T* parent)
+		{
+			auto childIt = hierarchy.find(child);
+			if (childIt == hierarchy.end()) return;
+
+			if (parent)
+			{
+				if (!hierarchy.contains(parent)) return;
+
+				for (T* ancestor = parent; ancestor; ancestor = hierarchy[ancestor].parent)
+				{
+					if (ancestor == child) return;
+				}
+			}
+
+			Hierarchy<T>& node = childIt->second;
+			if (node.parent == parent) return;
+
+			if (node.parent)
+			{
+				vector<T*>& oldChildren = hierarchy[node.parent].children;
+
+				oldChildren.erase(remove(
+					oldChildren.begin(),
+					oldChildren.end(),
+					child),
+					oldChildren.end());
+			}
+
+			node.parent = parent;
+			if (parent) hierarchy[parent].children.push_back(child);
 		}
 	};
 }
\ No newline at end of file
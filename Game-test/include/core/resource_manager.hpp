@@ -0,0 +1,155 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <any>
+#include <functional>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Core
+{
+	using std::string;
+	using std::vector;
+	using std::any;
+	using std::function;
+
+	//how many frames the gpu may still be reading a resource after its last handle is gone
+	constexpr u32 RESOURCE_FRAMES_IN_FLIGHT = 3u;
+	//how many loaded resources may be finalized on the main thread per frame
+	constexpr u32 RESOURCE_FINALIZE_BUDGET = 8u;
+
+	enum class ResourceState : u8
+	{
+		STATE_QUEUED,  //waiting for a worker
+		STATE_LOADING, //worker stage running or waiting on dependencies and the main thread
+		STATE_READY,
+		STATE_FAILED
+	};
+
+	//Ref-counted handle to a resource of any type.
+	//Handles are generational, so a handle to a destroyed and reused slot is simply invalid.
+	//Handles may be copied, queried and dropped on any thread,
+	//the last release is only queued and the resource is destroyed later by ResourceManager::Update
+	class ResourceRef
+	{
+	public:
+		ResourceRef() = default;
+		~ResourceRef();
+
+		ResourceRef(const ResourceRef& other);
+		ResourceRef& operator=(const ResourceRef& other);
+		ResourceRef(ResourceRef&& other) noexcept;
+		ResourceRef& operator=(ResourceRef&& other) noexcept;
+
+		bool IsValid() const;
+		ResourceState GetState() const;
+		bool IsReady() const { return GetState() == ResourceState::STATE_READY; }
+
+		const string& GetKey() const;
+		//Returns the failure reason of a failed resource
+		const string& GetError() const;
+
+		//Returns nullptr until the resource is ready
+		void* GetObject() const;
+
+		//Drops this reference early
+		void Reset();
+
+		bool operator==(const ResourceRef& other) const
+		{
+			return index == other.index
+				&& generation == other.generation;
+		}
+	private:
+		friend class ResourceManager;
+
+		//takes over a reference that was already counted
+		ResourceRef(
+			u32 index,
+			u32 generation);
+
+		u32 index{};
+		u32 generation{};
+	};
+
+	template<typename T>
+	class ResourceHandle : public ResourceRef
+	{
+	public:
+		ResourceHandle() = default;
+		explicit ResourceHandle(ResourceRef ref) : ResourceRef(std::move(ref)) {}
+
+		T* Get() const { return scast<T*>(GetObject()); }
+		T* operator->() const { return Get(); }
+	};
+
+	//How a resource is loaded, every stage is optional except finalize
+	struct ResourceDesc
+	{
+		//unique key, loading the same key twice returns the same resource
+		string key{};
+
+		//resources that must be ready before finalize runs,
+		//the new resource keeps them alive until it is destroyed
+		vector<ResourceRef> dependencies{};
+
+		//runs on a worker thread, must not touch the gl context.
+		//returns an empty string on success and the reason on failure
+		function<string(any& outData)> load{};
+
+		//runs on the main thread once load and all dependencies are done,
+		//creates the runtime object from the loaded data and the ready dependencies
+		function<string(
+			any& data,
+			const vector<ResourceRef>& dependencies,
+			void*& outObject)> finalize{};
+
+		//runs on the main thread RESOURCE_FRAMES_IN_FLIGHT frames after the last handle is released
+		function<void(void* object)> destroy{};
+	};
+
+	//Owns every resource created through a ResourceDesc and drives their loading.
+	//All calls are main thread only, only ResourceRef itself may be used on other threads.
+	class ResourceManager
+	{
+	public:
+		//0 uses one worker per hardware thread
+		static void Initialize(u32 threadCount = 0);
+		static bool IsInitialized();
+
+		//Queues a new resource or returns the existing one with the same key
+		static ResourceRef Load(ResourceDesc desc);
+
+		template<typename T>
+		static ResourceHandle<T> Load(ResourceDesc desc)
+		{
+			return ResourceHandle<T>(Load(std::move(desc)));
+		}
+
+		//Returns the resource with this key, or an invalid handle
+		static ResourceRef Find(const string& key);
+
+		//Finalizes finished loads and destroys released resources,
+		//call once per frame on the main thread
+		static void Update();
+
+		//Runs Update until nothing is queued or loading
+		static void WaitAll();
+
+		static u32 GetCount(ResourceState state);
+		//released resources not destroyed yet, including releases Update hasn't picked up
+		static u32 GetPendingDestroyCount();
+		static u64 GetFrameIndex();
+
+		//Waits for all workers, then destroys every resource immediately.
+		//Resources that still have handles are reported as leaks
+		static void Shutdown();
+	};
+}
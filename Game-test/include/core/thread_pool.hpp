@@ -0,0 +1,61 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Core
+{
+	using std::vector;
+	using std::deque;
+	using std::thread;
+	using std::mutex;
+	using std::condition_variable;
+	using std::function;
+
+	//Fixed-size pool of worker threads that run submitted jobs in FIFO order
+	class ThreadPool
+	{
+	public:
+		//0 uses one thread per hardware thread
+		explicit ThreadPool(u32 threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		void Submit(function<void()> job);
+
+		//Blocks until every submitted job has finished
+		void WaitIdle();
+
+		//Runs func(i) for every i in [0, count) across the pool and waits for all of them
+		void ParallelFor(
+			size_t count,
+			const function<void(size_t)>& func);
+
+		u32 GetThreadCount() const;
+	private:
+		void WorkerLoop();
+
+		vector<thread> workers{};
+		deque<function<void()>> jobs{};
+
+		mutex jobMutex{};
+		condition_variable jobCV{};
+		condition_variable idleCV{};
+
+		size_t activeJobs{};
+		bool isStopping{};
+	};
+}
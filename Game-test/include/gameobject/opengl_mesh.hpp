@@ -0,0 +1,156 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "KalaHeaders/math_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "graphics/meshlet.hpp"
+
+namespace GameTest::GameObject
+{
+	using std::vector;
+	using std::shared_ptr;
+	using std::string;
+	using std::string_view;
+
+	using KalaHeaders::KalaMath::vec3;
+	using KalaHeaders::KalaModelData::Vertex;
+	using KalaHeaders::KalaModelData::ModelTable;
+
+	using GameTest::Graphics::Meshlet;
+
+	//The .kmd block a mesh was loaded from, its cpu copy is paged back in from here
+	struct MeshSource
+	{
+		string path{};
+		ModelTable table{};
+	};
+
+	//The .kmd file a set of blocks was read from
+	struct MeshFile
+	{
+		string path{};
+		//content hash of the whole file, 0 if the file wasn't hashed
+		u64 hash{};
+		//table of every block, in the same order as the blocks
+		vector<ModelTable> tables{};
+	};
+
+	//Vertex and index buffers with their meshlets and bounds, shared by every model
+	//drawn with the same geometry. Meshes are cached by a load key, the content hash of the
+	//source file with the block offset and mesh name, and by the content hash of the geometry itself, so
+	//loading a file twice or spawning copies of a model uploads the geometry once.
+	//
+	//The cpu copy of the geometry is released right after upload. GetVertices and GetIndices
+	//page it back in from the mapped source .kmd, or from the gpu buffers for meshes built
+	//from memory, and TrimCpuData releases it again unless a model asked for cpu access.
+	//Everything here is main thread only, a mesh is destroyed together with its last model.
+	class OpenGL_Mesh
+	{
+	public:
+		//Returns the mesh cached under key or under the content hash of vertices and indices,
+		//otherwise uploads a new one. A key of 0 only matches by content
+		static shared_ptr<OpenGL_Mesh> Acquire(
+			u64 key,
+			vector<Vertex> vertices,
+			vector<u32> indices,
+			const MeshSource* source = nullptr);
+
+		//Returns the mesh cached under key, or nullptr
+		static shared_ptr<OpenGL_Mesh> Find(u64 key);
+
+		//Load key of one block of a model file. The offset tells apart blocks whose names
+		//are the same or only differ past the 19 stored characters
+		static u64 MakeKey(
+			u64 fileHash,
+			u32 blockOffset,
+			string_view meshName);
+
+		//meshes that are alive
+		static u32 GetCount();
+
+		//Releases the paged in cpu copies of every mesh without cpu access, call once per frame
+		static void TrimCpuData();
+		//bytes of vertices and indices currently held on the cpu
+		static u64 GetCpuBytes();
+
+		//Copies the first size bytes of a gpu buffer into outData, stalls until the gpu is done with it
+		static bool ReadBuffer(
+			u32 buffer,
+			size_t size,
+			void* outData);
+
+		OpenGL_Mesh(const OpenGL_Mesh&) = delete;
+		OpenGL_Mesh& operator=(const OpenGL_Mesh&) = delete;
+
+		//Content hash of the vertex and index data, identifies the mesh asset across runs
+		u64 GetAssetHash() const { return assetHash; }
+
+		u32 GetVAO() const { return VAO; }
+		u32 GetVBO() const { return VBO; }
+		u32 GetEBO() const { return EBO; }
+
+		u32 GetVertexCount() const { return vertexCount; }
+		u32 GetIndexCount() const { return indexCount; }
+
+		//Pages the cpu copy in if it was released, empty if it can't be read back
+		const vector<Vertex>& GetVertices() const;
+		const vector<u32>& GetIndices() const;
+
+		//Keeps the cpu copy resident while any model needs it, for picking or collision
+		void AddCpuAccess();
+		void RemoveCpuAccess();
+		bool IsCpuResident() const { return isCpuResident; }
+
+		//empty for meshes below MESHLET_MIN_TRIANGLES, which are drawn whole
+		const vector<Meshlet>& GetMeshlets() const { return meshlets; }
+
+		//model space bounds of every vertex
+		const vec3& GetBoundsMin() const { return boundsMin; }
+		const vec3& GetBoundsMax() const { return boundsMax; }
+
+		~OpenGL_Mesh();
+	private:
+		OpenGL_Mesh() = default;
+
+		//Reads the cpu copy back from the source or the gpu buffers
+		bool PageIn() const;
+		void ReleaseCpuData() const;
+
+		//every load key this mesh is cached under
+		vector<u64> keys{};
+		u64 assetHash{};
+
+		//empty path if the mesh was built from memory
+		MeshSource source{};
+
+		u32 VAO{};
+		u32 VBO{};
+		u32 EBO{};
+
+		u32 vertexCount{};
+		u32 indexCount{};
+
+		//paged in and released from const getters
+		mutable vector<Vertex> vertices{};
+		mutable vector<u32> indices{};
+		mutable bool isCpuResident{};
+
+		//models that asked for the cpu copy to stay resident
+		u32 cpuAccessCount{};
+
+		vector<Meshlet> meshlets{};
+
+		vec3 boundsMin{};
+		vec3 boundsMax{};
+	};
+}
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
 #include "KalaHeaders/math_utils.hpp"
 #include "KalaHeaders/import_kmd.hpp"
@@ -15,12 +16,16 @@
 #include "opengl/kw_opengl_shader.hpp"
 
 #include "graphics/opengl_texture.hpp"
+#include "graphics/stream_ring.hpp"
+#include "graphics/meshlet.hpp"
+#include "gameobject/opengl_mesh.hpp"
 #include "core/registry.hpp"
 
 namespace GameTest::GameObject
 {
 	using std::vector;
 	using std::string;
+	using std::shared_ptr;
 	
 	using KalaHeaders::KalaMath::vec3;
 	using KalaHeaders::KalaMath::mat4;
@@ -30,17 +35,25 @@ namespace GameTest::GameObject
 	using KalaHeaders::KalaMath::RotTarget;
 	using KalaHeaders::KalaMath::SizeTarget;
 	using KalaHeaders::KalaModelData::ModelTable;
+	using KalaHeaders::KalaModelData::ModelBlock;
 	using KalaHeaders::KalaModelData::Vertex;
 
 	using KalaWindow::OpenGL::OpenGL_Context;
 	using KalaWindow::OpenGL::OpenGL_Shader;
 
 	using GameTest::Graphics::OpenGL_Texture;
+	using GameTest::Graphics::StreamRing;
+	using GameTest::Graphics::Meshlet;
+	using GameTest::Graphics::MeshletCullStats;
 	using GameTest::Core::Registry;
 	
 	struct OpenGL_Model_Render
 	{
 		bool canUpdate = true;
+		//static models never move and may be merged into a static batch
+		bool isStatic{};
+		//keeps the cpu copy of the mesh resident, for picking or collision
+		bool hasCpuAccess{};
 		
 		//the transparency of this model
 		f32 opacity = 1.0f;
@@ -49,12 +62,8 @@ namespace GameTest::GameObject
 		//can this model render on both sides of each face
 		bool twoSided{};
 		
-		u32 VAO{};
-		u32 VBO{};
-		u32 EBO{};
-
-		vector<Vertex> vertices{};
-		vector<u32> indices{};
+		//geometry shared with every other model drawn with the same mesh
+		shared_ptr<OpenGL_Mesh> mesh{};
 		
 		OpenGL_Shader* shader{};
 		
@@ -77,18 +86,34 @@ namespace GameTest::GameObject
 
 		//get global point light UBO
 		static u32 GetPointLightUBO();
+		//number of lights written by the last UploadPointLights
+		static u32 GetPointLightCount();
+
+		//Uploads every point light once per frame and binds the light block,
+		//writes into the ring if it has room, otherwise into the point light UBO
+		static void UploadPointLights(StreamRing* ring = nullptr);
 		
 		//
 		// CORE
 		//
 		
-		//Create a single model from basic data
+		//Create a single model from basic data, reusing the cached mesh if the same geometry is loaded.
+		//A queued model goes through the registry command buffer of the calling thread
+		//and joins the registry at the next playback
 		static OpenGL_Model* InitializeSingle(
 			const string& name,
 			OpenGL_Context* context,
 			const vector<Vertex>& vertices,
 			const vector<u32>& indices,
-			OpenGL_Shader* shader);
+			OpenGL_Shader* shader,
+			bool isQueued = false);
+
+		//Create a model that draws the mesh of source with a copy of its material,
+		//copies share one set of buffers no matter how many are spawned
+		static OpenGL_Model* InitializeInstance(
+			const string& name,
+			const OpenGL_Model& source,
+			bool isQueued = false);
 		
 		//Initialize all models from a .kmd file. Returns a vector of non-owning pointers
 		//because a .kmd file may hold more than one model
@@ -96,6 +121,35 @@ namespace GameTest::GameObject
 			const string& modelPath,
 			OpenGL_Context* context,
 			OpenGL_Shader* shader);
+
+		//Reads and parses a .kmd file without touching the gl context and returns the path,
+		//content hash and tables of the file for the mesh keys. With skipCached blocks whose mesh is
+		//already cached are returned with only their names and sizes, which needs the main thread.
+		//Safe to call from worker threads otherwise
+		static string ImportFile(
+			const string& modelPath,
+			vector<ModelBlock>& outBlocks,
+			MeshFile& outFile,
+			bool skipCached = false);
+
+		//Reads only the blocks of modelTables from a .kmd file without touching the gl context,
+		//packed models must be stored uncompressed. Safe to call from worker threads
+		static string StreamFile(
+			const string& modelPath,
+			const vector<ModelTable>& modelTables,
+			vector<ModelBlock>& outBlocks);
+
+		//Creates one model per block returned by ImportFile or StreamFile,
+		//queued models join the registry at the next command playback.
+		//Meshes are cached by the file hash, block offset and mesh name, a hash of 0 or missing
+		//tables match by content only. A cached mesh whose vertex count differs from the block is logged and not used.
+		//Meshes page their cpu copy back in from the file tables, without them from the gpu
+		static vector<OpenGL_Model*> InitializeBlocks(
+			vector<ModelBlock> blocks,
+			OpenGL_Context* context,
+			OpenGL_Shader* shader,
+			bool isQueued = false,
+			const MeshFile& file = {});
 		
 		//Stream models based off of the provided tables
 		static vector<OpenGL_Model*> StreamModels(
@@ -113,6 +167,9 @@ namespace GameTest::GameObject
 
 		u32 GetID() const;
 
+		//Content hash of the vertex and index data, identifies the mesh asset across runs
+		u64 GetAssetHash() const;
+
 		OpenGL_Context* GetContext() const;
 
 		void SetName(const string& newName);
@@ -121,8 +178,26 @@ namespace GameTest::GameObject
 		void SetUpdateState(bool newValue);
 		bool CanUpdate() const;
 		
+		//Flag models that never move after loading so StaticBatcher may merge them
+		void SetStaticState(bool newValue);
+		bool IsStatic() const;
+		
+		const shared_ptr<OpenGL_Mesh>& GetMesh() const;
+
+		//Keeps the cpu copy of the mesh resident for picking or collision,
+		//without it the copy is released after upload and paged in by GetVertices
+		void SetCpuAccess(bool newValue);
+		bool HasCpuAccess() const;
+
+		u32 GetVertexCount() const;
+		u32 GetIndexCount() const;
+
 		const vector<Vertex>& GetVertices() const;
 		const vector<u32>& GetIndices() const;
+
+		const vector<Meshlet>& GetMeshlets() const;
+		//What the meshlet culler rejected in the last Render call
+		const MeshletCullStats& GetMeshletStats() const;
 		
 		//
 		// TRANSFORM
@@ -162,6 +237,10 @@ namespace GameTest::GameObject
 			SizeTarget type,
 			const vec3& newSize);
 		vec3 GetSize(SizeTarget type);
+
+		//Snaps every position, rotation and size at once
+		void SetTransform(const Transform3D& newTransform);
+		const Transform3D& GetTransform() const;
 		
 		//
 		// GRAPHICS
@@ -176,24 +255,33 @@ namespace GameTest::GameObject
 		void SetOpacity(f32 newValue);
 		f32 GetOpacity() const;
 
+		//True if the opacity is below 1 or the diffuse texture has an alpha channel
+		bool IsTransparent() const;
+
 		u32 GetVAO() const;
 		u32 GetVBO() const;
 		u32 GetEBO() const;
 
+		OpenGL_Shader* GetShader();
 		const OpenGL_Shader* GetShader() const;
 
 		void SetDiffuseTexture(OpenGL_Texture* newTexture);
 		void ClearDiffuseTexture();
 		const OpenGL_Texture* GetDiffuseTexture() const;
+
+		//True if both models draw with the same shader, textures, colors and render state
+		bool HasSameMaterial(const OpenGL_Model& other) const;
+		//Copies shader, textures, colors and render state but not geometry or transform
+		void CopyMaterial(const OpenGL_Model& other);
 		
 		~OpenGL_Model();
 	private:	
 		static OpenGL_Model* Initialize(
 			string name,
-			vector<Vertex> vertices,
-			vector<u32> indices,
+			shared_ptr<OpenGL_Mesh> mesh,
 			OpenGL_Context* context,
-			OpenGL_Shader* shader);
+			OpenGL_Shader* shader,
+			bool isQueued = false);
 
 		//Initialize global point light UBO
 		static void InitializePointLightUBO(OpenGL_Shader* shader);
@@ -208,5 +296,7 @@ namespace GameTest::GameObject
 		
 		OpenGL_Model_Render render{};
 		Transform3D transform{};
+
+		MeshletCullStats meshletStats{};
 	};
 }
\ No newline at end of file
@@ -91,7 +91,8 @@ namespace GameTest::GameObject
 		f32 _pad3[2];
 	};
 	
-	//Debug renderer settings for this light source
+	//Debug renderer settings for this light source,
+	//the shape is drawn as an instanced DebugDraw gizmo sized by the transform
 	struct OpenGL_PointLight_Render
 	{
 		bool canUpdate = true;
@@ -103,8 +104,9 @@ namespace GameTest::GameObject
 		u32 VBO{};
 		u32 EBO{};
 
-		vector<vec3> vertices{};
-		vector<u32> indices{};
+		//the debug shape is only kept on the gpu
+		u32 vertexCount{};
+		u32 indexCount{};
 		
 		OpenGL_Shader* shader{};
 	};
@@ -136,10 +138,6 @@ namespace GameTest::GameObject
 			OpenGL_Shader* shader = {});
 
 		bool IsInitialized() const;
-			
-		bool Render(
-			const mat4& view,
-			const mat4& projection);
 
 		u32 GetID() const;
 
@@ -154,8 +152,12 @@ namespace GameTest::GameObject
 		void SetRenderLightState(bool newValue);
 		bool CanRenderLight() const;
 		
-		const vector<vec3>& GetVertices() const;
-		const vector<u32>& GetIndices() const;
+		u32 GetVertexCount() const;
+		u32 GetIndexCount() const;
+
+		//Reads the debug shape back from the gpu buffers, stalls until the gpu is done with them
+		vector<vec3> GetVertices() const;
+		vector<u32> GetIndices() const;
 			
 		//
 		// TRANSFORM
@@ -195,6 +197,10 @@ namespace GameTest::GameObject
 			SizeTarget type,
 			const vec3& newSize);
 		vec3 GetSize(SizeTarget type);
+
+		//Snaps every position, rotation and size at once
+		void SetTransform(const Transform3D& newTransform);
+		const Transform3D& GetTransform() const;
 		
 		//
 		// GRAPHICS
@@ -240,6 +246,8 @@ namespace GameTest::GameObject
 		void SetQuadratic(f32 newValue);
 		f32 GetQuadratic() const;
 		
+		//Replaces every light setting at once, the position still follows the transform
+		void SetData(const OpenGL_PointLight_Data& newData);
 		const OpenGL_PointLight_Data* GetDataPtr() const;
 		
 		~OpenGL_PointLight();
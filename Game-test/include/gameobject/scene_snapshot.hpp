@@ -0,0 +1,253 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+/*------------------------------------------------------------------------------
+
+Binary scene snapshot, every section is a tightly packed array of fixed size
+records so saving is one write and loading reads the records straight from
+a mapped file. Numbers are little endian, sections start 8 byte aligned.
+
+# KSN header (64 bytes)
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+0      | 4    | KSN magic word, always 'K', 'S', 'N', '\0'
+4      | 2    | ksn binary version
+6      | 2    | header size in bytes
+8      | 4    | model record count
+12     | 4    | light record count
+16     | 4    | camera record count
+20     | 4    | string table size in bytes
+24     | 8    | model records offset
+32     | 8    | light records offset
+40     | 8    | camera records offset
+48     | 8    | string table offset
+56     | 8    | content hash of everything after the header
+
+# KSN transform (120 bytes), Transform3D as floats
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+0      | 36   | world, local and combined position XYZ
+36     | 48   | world, local and combined rotation quaternion WXYZ
+84     | 36   | world, local and combined size XYZ
+
+# KSN model record (160 bytes)
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+0      | 8    | asset hash, content hash of the model vertices and indices
+8      | 4    | name offset in the string table
+12     | 4    | name length
+16     | 4    | flags (0 - static, 1 - can update)
+20     | 4    | opacity
+24     | 12   | normalized diffuse color
+36     | 4    | reserved
+40     | 120  | transform
+
+# KSN light record (264 bytes)
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+0      | 4    | name offset in the string table
+4      | 4    | name length
+8      | 4    | flags (0 - renders debug shape)
+12     | 4    | debug shape opacity
+16     | 12   | normalized debug shape color
+28     | 4    | reserved
+32     | 112  | OpenGL_PointLight_Data as floats, same layout as the light UBO
+144    | 120  | transform
+
+# KSN camera record (56 bytes)
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+0      | 4    | name offset in the string table
+4      | 4    | name length
+8      | 12   | position XYZ
+20     | 12   | rotation in euler degrees XYZ
+32     | 4    | field of view
+36     | 4    | speed
+40     | 4    | near clip
+44     | 4    | far clip
+48     | 4    | sensitivity
+52     | 4    | reserved
+
+------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "core/mapped_file.hpp"
+
+namespace GameTest::GameObject
+{
+	using std::string;
+	using std::string_view;
+	using std::vector;
+	using std::filesystem::path;
+
+	using GameTest::Core::MappedFile;
+
+	constexpr u32 KSN_MAGIC = 0x004E534B;
+	constexpr u16 KSN_VERSION = 2;
+	constexpr u32 KSN_HEADER_SIZE = 64u;
+	constexpr u32 KSN_SECTION_ALIGNMENT = 8u;
+
+	constexpr u32 KSN_MODEL_FLAG_STATIC = 1u << 0;
+	constexpr u32 KSN_MODEL_FLAG_CAN_UPDATE = 1u << 1;
+
+	constexpr u32 KSN_LIGHT_FLAG_DEBUG_SHAPE = 1u << 0;
+
+	//floats in OpenGL_PointLight_Data
+	constexpr u32 KSN_LIGHT_DATA_FLOATS = 28u;
+
+	struct SceneSnapshotHeader
+	{
+		u32 magic = KSN_MAGIC;
+		u16 version = KSN_VERSION;
+		u16 headerSize = KSN_HEADER_SIZE;
+		u32 modelCount{};
+		u32 lightCount{};
+		u32 cameraCount{};
+		u32 stringTableSize{};
+		u64 modelsOffset{};
+		u64 lightsOffset{};
+		u64 camerasOffset{};
+		u64 stringTableOffset{};
+		u64 contentHash{};
+	};
+	static_assert(sizeof(SceneSnapshotHeader) == KSN_HEADER_SIZE);
+
+	struct SceneTransformRecord
+	{
+		f32 pos[3][3]{};
+		f32 rot[3][4]{};
+		f32 size[3][3]{};
+	};
+	static_assert(sizeof(SceneTransformRecord) == 120u);
+
+	struct SceneModelRecord
+	{
+		u64 assetHash{};
+		u32 nameOffset{};
+		u32 nameLength{};
+		u32 flags{};
+		f32 opacity{};
+		f32 diffuseColor[3]{};
+		u32 _reserved{};
+		SceneTransformRecord transform{};
+	};
+	static_assert(sizeof(SceneModelRecord) == 160u);
+
+	struct SceneLightRecord
+	{
+		u32 nameOffset{};
+		u32 nameLength{};
+		u32 flags{};
+		f32 debugOpacity{};
+		f32 debugColor[3]{};
+		u32 _reserved{};
+		f32 data[KSN_LIGHT_DATA_FLOATS]{};
+		SceneTransformRecord transform{};
+	};
+	static_assert(sizeof(SceneLightRecord) == 264u);
+
+	struct SceneCameraRecord
+	{
+		u32 nameOffset{};
+		u32 nameLength{};
+		f32 pos[3]{};
+		f32 rot[3]{};
+		f32 fov{};
+		f32 speed{};
+		f32 nearClip{};
+		f32 farClip{};
+		f32 sensitivity{};
+		u32 _reserved{};
+	};
+	static_assert(sizeof(SceneCameraRecord) == 56u);
+
+	//Everything one snapshot file holds, names live in the string table
+	struct SceneSnapshotData
+	{
+		vector<SceneModelRecord> models{};
+		vector<SceneLightRecord> lights{};
+		vector<SceneCameraRecord> cameras{};
+		string strings{};
+
+		//Appends name to the string table and returns its offset
+		u32 AddString(string_view name)
+		{
+			u32 offset = scast<u32>(strings.size());
+			strings.append(name);
+
+			return offset;
+		}
+	};
+
+	//Validated read-only view of a mapped snapshot file, records point straight into the mapping
+	class SceneSnapshotReader
+	{
+	public:
+		SceneSnapshotReader() = default;
+		~SceneSnapshotReader() { Close(); }
+
+		SceneSnapshotReader(const SceneSnapshotReader&) = delete;
+		SceneSnapshotReader& operator=(const SceneSnapshotReader&) = delete;
+
+		//Maps the file and checks the header, section bounds and content hash
+		string Open(const path& snapshotPath);
+		void Close();
+
+		bool IsOpen() const { return file.data != nullptr; }
+
+		const SceneSnapshotHeader& GetHeader() const { return header; }
+
+		const SceneModelRecord* GetModels() const { return models; }
+		const SceneLightRecord* GetLights() const { return lights; }
+		const SceneCameraRecord* GetCameras() const { return cameras; }
+
+		//Empty if the range is outside of the string table
+		string_view GetString(
+			u32 offset,
+			u32 length) const;
+	private:
+		MappedFile file{};
+		SceneSnapshotHeader header{};
+
+		const SceneModelRecord* models{};
+		const SceneLightRecord* lights{};
+		const SceneCameraRecord* cameras{};
+		const char* strings{};
+	};
+
+	//Saves and restores models, point lights and cameras of the running scene
+	class SceneSnapshot
+	{
+	public:
+		//Writes data to a temporary file with one write and renames it over snapshotPath
+		static string Write(
+			const path& snapshotPath,
+			const SceneSnapshotData& data);
+
+		//Captures every registered model, point light and camera and writes them
+		static string Save(const path& snapshotPath);
+
+		//Restores the scene from a snapshot. Models are matched to live models by asset hash,
+		//records without a free match are created as copies of a live model with the same hash
+		//and live models without a record are destroyed, both through the model registry command buffer
+		//so they apply at the next playback. Lights and cameras are restored onto the live ones in
+		//registry order since they aren't assets, extra records on either side are left alone
+		static string Load(const path& snapshotPath);
+	};
+}
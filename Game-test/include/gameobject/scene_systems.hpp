@@ -0,0 +1,79 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "core/ecs.hpp"
+#include "core/thread_pool.hpp"
+#include "gameobject/opengl_model.hpp"
+
+namespace GameTest::GameObject
+{
+	using std::vector;
+
+	using KalaHeaders::KalaMath::vec3;
+	using KalaHeaders::KalaMath::quat;
+	using KalaHeaders::KalaMath::mat4;
+
+	using GameTest::Core::EcsWorld;
+	using GameTest::Core::EcsEntity;
+	using GameTest::Core::ThreadPool;
+
+	//Combined transform of a model, copied from the model every frame
+	struct TransformComponent
+	{
+		vec3 pos{};
+		quat rot{};
+		vec3 size = vec3(1.0f);
+	};
+
+	struct WorldMatrixComponent
+	{
+		mat4 value{};
+	};
+
+	//Model drawn by the entity and the per-frame state the render loop sorts it by
+	struct RenderableComponent
+	{
+		OpenGL_Model* model{};
+		bool isOccluder{};
+		bool isTransparent{};
+	};
+
+	//One model to draw this frame
+	struct RenderItem
+	{
+		OpenGL_Model* model{};
+		mat4 world{};
+		bool isOccluder{};
+		bool isTransparent{};
+	};
+
+	//Runs the per-frame model systems on an ecs world:
+	//  sync       - copies transforms and flags out of every model, only marks chunks that changed
+	//  transform  - rebuilds world matrices of chunks whose transforms changed
+	//  extraction - writes the draw list, chunks with no new matrices or flags keep last frame's items
+	//Every system runs its chunks in parallel on the given workers.
+	class SceneSystems
+	{
+	public:
+		static EcsEntity AddModel(OpenGL_Model* model);
+		static void RemoveModel(OpenGL_Model* model);
+
+		//Runs every system and returns the draw list, valid until the next Update
+		static const vector<RenderItem>& Update(ThreadPool* workers = nullptr);
+
+		static EcsWorld& GetWorld();
+
+		//chunks whose world matrices were rebuilt in the last Update
+		static u32 GetLastTransformChunkCount();
+
+		static void Clear();
+	};
+}
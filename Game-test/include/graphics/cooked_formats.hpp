@@ -0,0 +1,209 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+/*------------------------------------------------------------------------------
+
+Runtime-ready artifacts written by the asset cooker.
+
+# KMS cooked mesh header
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+0      | 4    | KMS magic word, always 'K', 'M', 'S', '\0'
+4      | 1    | kms binary version
+5      | 3    | reserved
+8      | 4    | mesh count
+
+# KMS cooked mesh block, repeated mesh count times
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+??     | 20   | fixed-length name of the mesh (19 characters + null terminator)
+??+20  | 4    | vertex count
+??+24  | 4    | index count
+??+28  | 1    | index size in bytes (2 or 4)
+??+29  | 1    | vertex stride in bytes
+??+30  | 2    | reserved
+??+32  | 12   | bounds min in floats in XYZ axis
+??+44  | 12   | bounds max in floats in XYZ axis
+??+56  | 16   | bounding sphere center XYZ and radius
+??+72  | 12   | model position in floats in XYZ axis
+??+84  | 16   | model rotation in floats in quaternion
+??+100 | 12   | model size in floats in XYZ axis
+??+112 | 4    | vertex data size
+??+116 | 4    | index data size
+??+120 | ???  | vertex data
+??+??  | ???  | index data, padded to 4 bytes
+
+# KMS cooked vertex (20 bytes)
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+0      | 6    | position as unorm16 XYZ inside bounds min/max
+6      | 2    | tangent handedness as snorm16 (-1 or +1)
+8      | 4    | normal as octahedral snorm16 XY
+12     | 4    | texcoord as half float UV
+16     | 4    | tangent as octahedral snorm16 XY
+
+# KTX cooked texture header
+
+Offset | Size | Field
+-------|------|--------------------------------------------
+0      | 4    | KTX magic word, always 'K', 'T', 'X', '\0'
+4      | 1    | ktx binary version
+5      | 1    | block format (0 - RGBA8, 1 - BC1, 2 - BC3)
+6      | 1    | flags (0 - sRGB, 1 - flipped vertically)
+7      | 1    | mip count
+8      | 4    | width of mip 0
+12     | 4    | height of mip 0
+16     | 8*n  | offset and size of each mip from the start of the file
+??     | ???  | mip data, largest mip first
+
+------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Graphics
+{
+	using KalaHeaders::KalaMath::vec2;
+	using KalaHeaders::KalaMath::vec3;
+
+	constexpr u32 KMS_MAGIC = 0x00534D4B;
+	constexpr u8 KMS_VERSION = 1;
+	constexpr u32 KMS_HEADER_SIZE = 12u;
+	constexpr u32 KMS_BLOCK_HEADER_SIZE = 120u;
+	constexpr u8 KMS_VERTEX_STRIDE = 20u;
+
+	constexpr u32 KTX_MAGIC = 0x0058544B;
+	constexpr u8 KTX_VERSION = 1;
+	constexpr u32 KTX_HEADER_SIZE = 16u;
+
+	constexpr u8 KTX_FLAG_SRGB = 1u << 0;
+	constexpr u8 KTX_FLAG_FLIPPED = 1u << 1;
+
+	enum class CookedTextureFormat : u8
+	{
+		FORMAT_RGBA8 = 0,
+		FORMAT_BC1   = 1, //opaque, 8 bytes per 4x4 block
+		FORMAT_BC3   = 2  //with alpha, 16 bytes per 4x4 block
+	};
+
+	struct CookedVertex
+	{
+		u16 position[3]{};
+		i16 tangentSign{};
+		i16 normal[2]{};
+		u16 texCoord[2]{};
+		i16 tangent[2]{};
+	};
+	static_assert(sizeof(CookedVertex) == KMS_VERTEX_STRIDE);
+
+	//
+	// ENCODING HELPERS
+	//
+
+	inline i16 ToSnorm16(f32 v)
+	{
+		v = v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);
+		return scast<i16>(std::lround(v * 32767.0f));
+	}
+	inline f32 FromSnorm16(i16 v)
+	{
+		f32 f = scast<f32>(v) / 32767.0f;
+		return f < -1.0f ? -1.0f : f;
+	}
+
+	//Maps a unit vector onto the octahedron and unfolds it into [-1, 1]^2
+	inline vec2 OctEncode(const vec3& n)
+	{
+		f32 l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+		if (l1 <= 0.0f) return vec2(0.0f);
+
+		vec2 p(n.x / l1, n.y / l1);
+		if (n.z < 0.0f)
+		{
+			f32 px = p.x;
+			p.x = (1.0f - std::fabs(p.y)) * (px >= 0.0f ? 1.0f : -1.0f);
+			p.y = (1.0f - std::fabs(px)) * (p.y >= 0.0f ? 1.0f : -1.0f);
+		}
+		return p;
+	}
+	inline vec3 OctDecode(vec2 p)
+	{
+		vec3 n(p.x, p.y, 1.0f - std::fabs(p.x) - std::fabs(p.y));
+		f32 t = n.z < 0.0f ? -n.z : 0.0f;
+		n.x += n.x >= 0.0f ? -t : t;
+		n.y += n.y >= 0.0f ? -t : t;
+
+		f32 len = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+		return len > 0.0f ? vec3(n.x / len, n.y / len, n.z / len) : vec3(0.0f, 0.0f, 1.0f);
+	}
+
+	//IEEE 754 half precision, round to nearest even, no denormal output
+	inline u16 FloatToHalf(f32 value)
+	{
+		u32 bits{};
+		memcpy(&bits, &value, sizeof(u32));
+
+		u32 sign = (bits >> 16) & 0x8000u;
+		i32 exponent = scast<i32>((bits >> 23) & 0xFFu) - 127 + 15;
+		u32 mantissa = bits & 0x7FFFFFu;
+
+		//nan and inf
+		if (((bits >> 23) & 0xFFu) == 0xFFu)
+		{
+			return scast<u16>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+		}
+		//too small, flush to zero
+		if (exponent <= 0) return scast<u16>(sign);
+		//too large, clamp to inf
+		if (exponent >= 31) return scast<u16>(sign | 0x7C00u);
+
+		u32 half = sign | (scast<u32>(exponent) << 10) | (mantissa >> 13);
+		u32 rest = mantissa & 0x1FFFu;
+		if (rest > 0x1000u
+			|| (rest == 0x1000u && (half & 1u)))
+		{
+			++half;
+		}
+		return scast<u16>(half);
+	}
+	inline f32 HalfToFloat(u16 half)
+	{
+		u32 sign = (scast<u32>(half) & 0x8000u) << 16;
+		u32 exponent = (half >> 10) & 0x1Fu;
+		u32 mantissa = half & 0x3FFu;
+
+		u32 bits{};
+		if (exponent == 0)
+		{
+			if (mantissa == 0) bits = sign;
+			else
+			{
+				//denormal, renormalize
+				exponent = 127 - 15 + 1;
+				while (!(mantissa & 0x400u))
+				{
+					mantissa <<= 1;
+					--exponent;
+				}
+				mantissa &= 0x3FFu;
+				bits = sign | (exponent << 23) | (mantissa << 13);
+			}
+		}
+		else if (exponent == 31) bits = sign | 0x7F800000u | (mantissa << 13);
+		else bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+
+		f32 value{};
+		memcpy(&value, &bits, sizeof(f32));
+		return value;
+	}
+}
@@ -0,0 +1,105 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl_shader.hpp"
+
+#include "gameobject/opengl_point_light.hpp"
+#include "graphics/stream_ring.hpp"
+
+namespace GameTest::Graphics
+{
+	using KalaHeaders::KalaMath::vec3;
+	using KalaHeaders::KalaMath::mat4;
+
+	using KalaWindow::OpenGL::OpenGL_Shader;
+
+	using GameTest::GameObject::OpenGL_PointLight;
+
+	//line segments per wire circle, a wire sphere is three circles
+	constexpr u32 DEBUG_SPHERE_SEGMENTS = 32u;
+
+	//primitives past these per-frame limits are dropped
+	//so a runaway debug loop can't stall the frame
+	constexpr u32 DEBUG_MAX_LINE_VERTICES = 1u << 20;
+	constexpr u32 DEBUG_MAX_INSTANCES = 1u << 16;
+
+	//Immediate mode debug drawing. Every call only appends to cpu arrays,
+	//Flush uploads them once and draws each primitive type with a single draw call.
+	//All calls are no-ops while debug drawing is disabled or not initialized.
+	class DebugDraw
+	{
+	public:
+		//Creates the gl buffers, requires the debug_line shader.
+		//Queued data goes into ring while it has room and into own streaming buffers after that
+		static bool Initialize(
+			OpenGL_Shader* shader,
+			StreamRing* ring = nullptr);
+		static bool IsInitialized();
+
+		static void SetEnabled(bool newValue);
+		static bool IsEnabled();
+
+		//
+		// PRIMITIVES
+		//
+
+		//color is normalized rgb
+		static void Line(
+			const vec3& start,
+			const vec3& end,
+			const vec3& color);
+
+		//Axis aligned box in world space
+		static void Box(
+			const vec3& boundsMin,
+			const vec3& boundsMax,
+			const vec3& color);
+
+		//Model space box transformed by model
+		static void Box(
+			const vec3& boundsMin,
+			const vec3& boundsMax,
+			const mat4& model,
+			const vec3& color);
+
+		//Wire sphere drawn as three instanced circles
+		static void Sphere(
+			const vec3& center,
+			f32 radius,
+			const vec3& color);
+
+		//Edges of the volume that viewProjection maps to clip space
+		static void Frustum(
+			const mat4& viewProjection,
+			const vec3& color);
+
+		//Small solid marker at a light source position
+		static void LightGizmo(
+			const vec3& center,
+			f32 size,
+			const vec3& color);
+
+		//Gizmo and max range sphere of a point light, this is how light shapes are drawn,
+		//the gizmo is skipped if the light's debug shape is hidden
+		static void LightRange(OpenGL_PointLight* light);
+
+		//Draws everything queued this frame and clears the queues,
+		//must run with the context current and before the buffers are swapped
+		static void Flush(
+			const mat4& view,
+			const mat4& projection);
+
+		//primitive counts of the last flush
+		static u32 GetLineCount();
+		static u32 GetSphereCount();
+		static u32 GetGizmoCount();
+
+		static void Shutdown();
+	};
+}
@@ -0,0 +1,69 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl_shader.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::string;
+
+	using KalaHeaders::KalaMath::vec2;
+	using KalaHeaders::KalaMath::vec3;
+	using KalaHeaders::KalaMath::mat4;
+
+	using KalaWindow::OpenGL::OpenGL_Shader;
+
+	//Shaders used by the deferred path, all of them are required
+	struct DeferredShaders
+	{
+		//model.vert with model_gbuffer.frag, writes material data instead of lighting
+		OpenGL_Shader* geometry{};
+		//fullscreen ambient and emissive resolve, also copies the g-buffer depth
+		OpenGL_Shader* ambient{};
+		//instanced light volumes that read the point light block
+		OpenGL_Shader* light{};
+	};
+
+	//Deferred shading as an alternative to the forward lighting in model.frag.
+	//Opaque models write albedo, normal, specular with shininess and emissive into a g-buffer,
+	//then every point light is drawn once as an instanced sphere that only shades the pixels inside its range.
+	//Transparent models stay forward lit. The path can be switched at runtime with SetEnabled.
+	class DeferredRenderer
+	{
+	public:
+		static string Initialize(
+			const DeferredShaders& shaders,
+			const vec2& size);
+		static bool IsInitialized();
+
+		//Forward lighting is used while disabled or not initialized
+		static void SetEnabled(bool newValue);
+		static bool IsEnabled();
+
+		//Recreates the g-buffer, call when the default framebuffer is resized
+		static void Resize(const vec2& size);
+
+		//Binds and clears the g-buffer, opaque models draw with the geometry shader until EndGeometryPass
+		static void BeginGeometryPass();
+		static bool IsGeometryPassActive();
+		static OpenGL_Shader* GetGeometryShader();
+
+		//Goes back to the default framebuffer, resolves ambient light and depth and adds every point light.
+		//lightCount is the number of lights in the bound point light block
+		static void EndGeometryPass(
+			const mat4& view,
+			const mat4& projection,
+			const vec3& cameraPos,
+			u32 lightCount);
+
+		static void Shutdown();
+	};
+}
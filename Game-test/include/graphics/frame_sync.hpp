@@ -0,0 +1,69 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+
+namespace GameTest::Graphics
+{
+	using KalaWindow::OpenGL::OpenGL_Context;
+
+	//highest allowed frames in flight
+	constexpr u32 FRAME_SYNC_MAX_FRAMES = 3u;
+
+	//frames averaged by GetAverageTimings and between two reports
+	constexpr u32 FRAME_SYNC_HISTORY = 120u;
+
+	//Where the cpu spent one frame, all times in milliseconds
+	struct FrameTimings
+	{
+		//whole frame, from one BeginFrame to the next
+		f64 frameMs{};
+		//cpu work between BeginFrame and Present
+		f64 cpuMs{};
+		//blocked in BeginFrame on the fence of an older frame, the gpu is behind
+		f64 fenceWaitMs{};
+		//blocked in the buffer swap, usually vsync
+		f64 swapMs{};
+		//frames submitted but not yet finished by the gpu when this frame started
+		u32 framesInFlight{};
+	};
+
+	//Limits how many frames the cpu may run ahead of the gpu. Every presented frame is fenced
+	//and BeginFrame waits on the oldest fence once the limit is reached, which trades
+	//throughput for input latency. The time blocked on fences and on the swap is tracked per frame.
+	class FrameSync
+	{
+	public:
+		static void Initialize(u32 maxFramesInFlight = 2);
+		static bool IsInitialized();
+
+		//Clamped to [1, FRAME_SYNC_MAX_FRAMES], 1 waits for the gpu every frame
+		static void SetMaxFramesInFlight(u32 newValue);
+		static u32 GetMaxFramesInFlight();
+
+		//Call before the first gl command of a frame with the context current
+		static void BeginFrame();
+
+		//Swaps the buffers and fences the frame, replaces OpenGL_Context::SwapOpenGLBuffers
+		static void Present(
+			OpenGL_Context* context,
+			uintptr_t handle);
+
+		//Logs the averaged timings once every FRAME_SYNC_HISTORY frames
+		static void SetReportState(bool newValue);
+		static bool IsReportEnabled();
+
+		static const FrameTimings& GetLastTimings();
+		//Average of the last FRAME_SYNC_HISTORY frames
+		static FrameTimings GetAverageTimings();
+
+		//Deletes the pending fences, the context must still be current
+		static void Shutdown();
+	};
+}
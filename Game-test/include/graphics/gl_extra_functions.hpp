@@ -0,0 +1,89 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include "OpenGL/glcorearb.h"
+#include "OpenGL/glext.h"
+
+#include "KalaHeaders/core_utils.hpp"
+
+namespace GameTest::Graphics
+{
+	//OpenGL functions used by Game-test that KalaWindow does not load into GL_Core
+	struct GL_Extra
+	{
+		//
+		// INSTANCING
+		//
+
+		//Sets how many instances share one value of a vertex attribute
+		PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
+
+		//Draws multiple instances of a range of array elements
+		PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced;
+
+		//Draws multiple instances of a set of indexed elements
+		PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
+
+		//Draws several ranges of indexed elements in one call
+		PFNGLMULTIDRAWELEMENTSPROC glMultiDrawElements;
+
+		//
+		// BUFFERS
+		//
+
+		//Releases a mapping made with glMapBufferRange
+		PFNGLUNMAPBUFFERPROC glUnmapBuffer;
+
+		//Binds a range of a buffer object to an indexed buffer target
+		PFNGLBINDBUFFERRANGEPROC glBindBufferRange;
+
+		//
+		// FRAMEBUFFERS
+		//
+
+		//Selects the color attachments written by fragment shader outputs
+		PFNGLDRAWBUFFERSPROC glDrawBuffers;
+
+		//Clears one attachment of the bound framebuffer to a float value
+		PFNGLCLEARBUFFERFVPROC glClearBufferfv;
+
+		//Copies a rectangle of pixels from the read to the draw framebuffer
+		PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer;
+
+		//Deletes framebuffer objects
+		PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers;
+
+		//Deletes renderbuffer objects
+		PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers;
+
+		//Sets separate blend factors for the color and alpha channels
+		PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate;
+
+		//
+		// SYNC
+		//
+
+		//Creates a fence that is signaled once all previous commands have completed
+		PFNGLFENCESYNCPROC glFenceSync;
+
+		//Blocks until a fence is signaled or the timeout expires
+		PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+
+		//Deletes a fence
+		PFNGLDELETESYNCPROC glDeleteSync;
+	};
+
+	class OpenGL_Functions_Extra
+	{
+	public:
+		static const GL_Extra* GetGLExtra();
+
+		//Loads every GL_Extra function from the current context,
+		//must be called after a context has been made current
+		static void LoadAllExtraFunctions();
+	};
+}
@@ -0,0 +1,94 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+
+#include "KalaHeaders/math_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::vector;
+
+	using KalaHeaders::KalaMath::vec3;
+	using KalaHeaders::KalaMath::mat4;
+	using KalaHeaders::KalaModelData::Vertex;
+
+	//most unique vertices referenced by one meshlet
+	constexpr u32 MESHLET_MAX_VERTICES = 64u;
+
+	//most triangles in one meshlet
+	constexpr u32 MESHLET_MAX_TRIANGLES = 124u;
+
+	//meshes below this many triangles are drawn whole, culling clusters would cost more than it saves
+	constexpr u32 MESHLET_MIN_TRIANGLES = 8192u;
+
+	//A run of consecutive triangles in the index buffer with its bounds and normal cone
+	struct Meshlet
+	{
+		//range in the source index buffer
+		u32 firstIndex{};
+		u32 indexCount{};
+
+		//unique vertices referenced by the range
+		u32 vertexCount{};
+
+		//model space bounding sphere
+		vec3 center{};
+		f32 radius{};
+
+		//average facing of the triangles and the sine of the widest angle between a triangle and the axis,
+		//a cutoff of 1 disables the backface test for this meshlet
+		vec3 coneAxis{};
+		f32 coneCutoff = 1.0f;
+	};
+
+	//Index buffer range to draw, neighbouring visible meshlets are merged into one range
+	struct MeshletDrawRange
+	{
+		u32 firstIndex{};
+		u32 indexCount{};
+	};
+
+	struct MeshletCullStats
+	{
+		u32 meshletCount{};
+		u32 frustumCulled{};
+		u32 coneCulled{};
+		u32 rangeCount{};
+	};
+
+	//Splits an index buffer into meshlets. Triangles are taken in index buffer order,
+	//which is already vertex cache ordered for cooked meshes, so neighbouring triangles end up together.
+	//Nothing here touches the gl context.
+	class MeshletBuilder
+	{
+	public:
+		static vector<Meshlet> Build(
+			const vector<Vertex>& vertices,
+			const vector<u32>& indices,
+			u32 maxVertices = MESHLET_MAX_VERTICES,
+			u32 maxTriangles = MESHLET_MAX_TRIANGLES);
+	};
+
+	//Per-frame cpu culling of meshlets against the view frustum and their normal cones
+	class MeshletCuller
+	{
+	public:
+		//Clears outRanges and fills it with the visible index ranges in index buffer order.
+		//Backface culling is skipped for two-sided models and for models with non-uniform scale,
+		//which would bend the normal cones
+		static void Cull(
+			const vector<Meshlet>& meshlets,
+			const mat4& viewProjection,
+			const mat4& model,
+			const vec3& cameraPos,
+			bool canConeCull,
+			vector<MeshletDrawRange>& outRanges,
+			MeshletCullStats* outStats = nullptr);
+	};
+}
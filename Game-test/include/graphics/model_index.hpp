@@ -0,0 +1,105 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <mutex>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "core/mapped_file.hpp"
+#include "gameobject/opengl_mesh.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::string;
+	using std::string_view;
+	using std::vector;
+	using std::unordered_map;
+	using std::mutex;
+	using std::filesystem::path;
+
+	using KalaHeaders::KalaModelData::ModelTable;
+	using KalaHeaders::KalaModelData::ModelBlock;
+
+	using GameTest::Core::MappedFile;
+	using GameTest::GameObject::MeshFile;
+
+	//One block of an indexed .kmd file
+	struct ModelIndexEntry
+	{
+		string nodeName{};
+		string meshName{};
+		ModelTable table{};
+	};
+
+	//Node and mesh name index of a .kmd file. Opening reads the header, the tables and
+	//the mesh name of every block through a mapping of the file, so single models of a
+	//large library can be found by name and read without touching the other blocks.
+	//Lookups and ReadBlocks are safe from several threads once the index is open
+	class ModelIndex
+	{
+	public:
+		ModelIndex() = default;
+		~ModelIndex() { Close(); }
+
+		ModelIndex(const ModelIndex&) = delete;
+		ModelIndex& operator=(const ModelIndex&) = delete;
+
+		//Maps the file and builds the name lookups, compressed packed files are decoded whole
+		string Open(const path& modelPath);
+		void Close();
+
+		bool IsOpen() const { return data != nullptr; }
+
+		const string& GetPath() const { return filePath; }
+		const vector<ModelIndexEntry>& GetEntries() const { return entries; }
+
+		//Indices of every block whose node name matches exactly, empty if there is none
+		const vector<u32>& FindNode(string_view nodeName) const;
+		//Indices of every block whose mesh name matches exactly, empty if there is none
+		const vector<u32>& FindMesh(string_view meshName) const;
+
+		//Indices of every block whose node or mesh name matches pattern in table order,
+		//'*' matches any run of characters and '?' matches one
+		vector<u32> FindMatching(string_view pattern) const;
+
+		//Parses only the blocks at indices, in the same order
+		string ReadBlocks(
+			const vector<u32>& indices,
+			vector<ModelBlock>& outBlocks) const;
+
+		//Content hash of the whole file, the same one OpenGL_Model::ImportFile keys meshes with.
+		//Computed on the first call since it is the only thing that reads every block
+		u64 GetHash() const;
+
+		//Source of the blocks at indices for OpenGL_Model::InitializeBlocks, so their
+		//meshes page their geometry back in from this file and share the mesh cache with ImportFile
+		MeshFile GetFile(const vector<u32>& indices) const;
+	private:
+		string filePath{};
+
+		//points into the mapped loose file, the mounted pack or decoded
+		const u8* data{};
+		u64 size{};
+
+		MappedFile file{};
+		vector<u8> decoded{};
+
+		//0 until GetHash runs
+		mutable mutex hashMutex{};
+		mutable u64 hash{};
+
+		vector<ModelIndexEntry> entries{};
+		unordered_map<string, vector<u32>> nodeLookup{};
+		unordered_map<string, vector<u32>> meshLookup{};
+	};
+}
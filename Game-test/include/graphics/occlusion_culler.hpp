@@ -0,0 +1,116 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+
+#include "KalaHeaders/math_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "core/thread_pool.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::vector;
+
+	using KalaHeaders::KalaMath::vec3;
+	using KalaHeaders::KalaMath::vec4;
+	using KalaHeaders::KalaMath::mat4;
+	using KalaHeaders::KalaModelData::Vertex;
+
+	using GameTest::Core::ThreadPool;
+
+	//pixels per side of one hierarchical depth tile
+	constexpr u32 OCCLUSION_TILE_SIZE = 8u;
+
+	//Simplified occluder geometry in model space
+	struct OccluderMesh
+	{
+		vector<vec3> positions{};
+		vector<u32> indices{};
+	};
+
+	//Software occlusion culling against a low resolution depth buffer.
+	//Occluders are rasterized on the cpu in horizontal bands, one band per worker,
+	//then every 8x8 tile keeps its farthest depth so most box tests end at the tile level.
+	//Nothing here touches the gl context.
+	class OcclusionCuller
+	{
+	public:
+		//width and height are rounded up to whole tiles
+		explicit OcclusionCuller(
+			u32 width = 320,
+			u32 height = 192);
+
+		//Keeps the largest triangles of a mesh up to maxTriangles.
+		//A subset of the surface can never hide more than the full mesh,
+		//so simplified occluders never cull something that is visible
+		static OccluderMesh BuildOccluder(
+			const vector<Vertex>& vertices,
+			const vector<u32>& indices,
+			u32 maxTriangles = 512);
+
+		//Clears the depth buffer and drops last frame's occluders
+		void BeginFrame(const mat4& viewProjection);
+
+		//Transforms, clips and queues the triangles of an occluder
+		void AddOccluder(
+			const OccluderMesh& mesh,
+			const mat4& model);
+
+		//Rasterizes every queued occluder, runs inline without workers
+		void Rasterize(ThreadPool* workers = nullptr);
+
+		//Returns false if the model space box is outside the view
+		//or fully behind the rasterized occluders
+		bool IsVisible(
+			const vec3& boundsMin,
+			const vec3& boundsMax,
+			const mat4& model) const;
+
+		u32 GetWidth() const { return width; }
+		u32 GetHeight() const { return height; }
+
+		//Depth in [0, 1] per pixel with the origin at the bottom left, 1 is the far plane
+		const vector<f32>& GetDepth() const { return depth; }
+
+		u32 GetTriangleCount() const { return static_cast<u32>(triangles.size()); }
+	private:
+		//screen space triangle, counter clockwise
+		struct ScreenTriangle
+		{
+			f32 x[3]{};
+			f32 y[3]{};
+			f32 z[3]{};
+			f32 minY{};
+			f32 maxY{};
+		};
+
+		void AddClipTriangle(const vec4 (&clip)[3]);
+
+		void RasterizeBand(
+			u32 firstRow,
+			u32 endRow);
+
+		void RasterizeTriangle(
+			const ScreenTriangle& tri,
+			u32 firstRow,
+			u32 endRow);
+
+		u32 width{};
+		u32 height{};
+		u32 tilesX{};
+		u32 tilesY{};
+
+		mat4 viewProjection{};
+
+		vector<f32> depth{};
+		//farthest depth of each tile
+		vector<f32> tileMaxDepth{};
+
+		vector<ScreenTriangle> triangles{};
+	};
+}
@@ -37,6 +37,14 @@ namespace GameTest::Graphics
 	using GameTest::Core::Registry;
 	using KalaWindow::OpenGL::OpenGL_Context;
 
+	//Decoded pixels of a texture that has not been uploaded yet
+	struct TexturePixels
+	{
+		vector<u8> data{};
+		vec2 size{};
+		TextureFormat format{};
+	};
+
 	class OpenGL_Texture
 	{
 	public:
@@ -53,9 +61,37 @@ namespace GameTest::Graphics
 			TextureFormat format = TextureFormat::Format_Auto,
 			bool flipVertically = false,
 			u8 mipMapLevels = 1);
+
+		//Decodes a texture file without touching the gl context,
+		//safe to call from worker threads
+		static string DecodeFile(
+			const string& name,
+			const string& path,
+			TextureFormat format,
+			bool flipVertically,
+			TexturePixels& outPixels);
+
+		//Uploads pixels from DecodeFile, must be called on the gl thread.
+		//If isAsync is true and TextureUploader is running, the pixels are uploaded
+		//through a pixel buffer over the next frames instead of blocking here.
+		//Returns a fallback texture if uploading fails.
+		static OpenGL_Texture* InitializeFromPixels(
+			OpenGL_Context* glContext,
+			const string& name,
+			const string& path,
+			TexturePixels pixels,
+			u8 mipMapLevels = 1,
+			bool isAsync = false);
 			
 		bool IsInitialized() const;
 
+		//False while an asynchronous upload is still in flight,
+		//sampling the texture before that shows undefined contents
+		bool IsUploaded() const;
+
+		//Returns this texture's OpenGL ID once uploaded, the fallback texture's until then
+		u32 GetSampleID() const;
+
 		//Returns the fallback texture,
 		//used when a texture fails to load through OpenGL_Texture::LoadTexture
 		static OpenGL_Texture* GetFallbackTexture();
@@ -85,6 +121,8 @@ namespace GameTest::Graphics
 		//Do not destroy manually, erase from registry instead
 		~OpenGL_Texture();
 	private:
+		friend class TextureUploader;
+
 		static OpenGL_Texture* TextureBody(
 			OpenGL_Context* glContext,
 			const string& name,
@@ -92,6 +130,7 @@ namespace GameTest::Graphics
 			TextureFormat format,
 			bool flipVertically,
 			u8 mipMapLevels,
+			bool isAsync,
 			const function<bool(
 				u32& outTextureID,
 				vector<vector<u8>>& outData,
@@ -103,6 +142,7 @@ namespace GameTest::Graphics
 		string filePath{};
 		
 		bool isInitialized{};
+		bool isUploaded{};
 		
 		u32 ID{};
 		u32 textureID{};
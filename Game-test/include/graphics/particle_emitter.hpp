@@ -0,0 +1,148 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <array>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "core/thread_pool.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::vector;
+	using std::array;
+
+	using KalaHeaders::KalaMath::vec3;
+	using KalaHeaders::KalaMath::vec4;
+
+	using GameTest::Core::ThreadPool;
+
+	//particles are simulated and compacted in chunks of this many, one chunk per job,
+	//must stay a multiple of 4 so every chunk starts on a full simd group
+	constexpr u32 PARTICLE_CHUNK_SIZE = 4096u;
+
+	struct ParticleEmitterSettings
+	{
+		vec3 position{};
+		//new particles start anywhere in the box position +- spawnExtents
+		vec3 spawnExtents{};
+
+		//every velocity component is picked uniformly between min and max
+		vec3 velocityMin{};
+		vec3 velocityMax{};
+
+		vec3 gravity = vec3(0.0f, -9.81f, 0.0f);
+		//share of velocity lost per second
+		f32 drag{};
+
+		//seconds
+		f32 lifeMin = 1.0f;
+		f32 lifeMax = 2.0f;
+
+		//color and size blend from start to end over the life of a particle
+		vec4 startColor = vec4(1.0f);
+		vec4 endColor = vec4(1.0f, 1.0f, 1.0f, 0.0f);
+		f32 startSize = 0.1f;
+		f32 endSize = 0.1f;
+
+		//particles per second, one-off bursts go through Burst
+		f32 spawnRate{};
+
+		//pool size, rounded up to whole chunks
+		u32 maxParticles = 1u << 16;
+	};
+
+	//One camera facing quad, center in position and world size in size
+	struct ParticleInstance
+	{
+		f32 position[3];
+		f32 size;
+		u8 color[4];
+	};
+
+	//Particle pool with one array per attribute. Spawning, simulation and compaction
+	//run four particles at a time with sse2 where available, chunks are updated in parallel
+	//and every chunk keeps its alive particles packed at its start,
+	//so chunks never have to be merged and WriteInstances gathers them into one buffer.
+	//Has no gl state, rendering goes through ParticleRenderer.
+	class ParticleEmitter
+	{
+	public:
+		explicit ParticleEmitter(
+			const ParticleEmitterSettings& settings,
+			u64 seed = 0x9E3779B97F4A7C15ull);
+
+		//the pool keeps the capacity it was created with
+		void SetSettings(const ParticleEmitterSettings& newSettings);
+		const ParticleEmitterSettings& GetSettings() const;
+
+		void SetPosition(const vec3& newPos);
+
+		//Spawns count extra particles on the next Update
+		void Burst(u32 count);
+
+		//Simulates and compacts every chunk, then spawns this frame's particles,
+		//null workers runs everything on the calling thread
+		void Update(
+			f32 deltaTime,
+			ThreadPool* workers = nullptr);
+
+		//Writes every alive particle, out must have room for GetAliveCount() instances
+		void WriteInstances(
+			ParticleInstance* out,
+			ThreadPool* workers = nullptr) const;
+
+		//Kills every particle and drops pending spawns
+		void Clear();
+
+		u32 GetAliveCount() const;
+		u32 GetCapacity() const;
+
+		//particles that didn't spawn because the pool was full
+		u64 GetDroppedCount() const;
+	private:
+		void SimulateChunk(
+			u32 chunk,
+			f32 deltaTime);
+
+		void SpawnRange(
+			u32 first,
+			u32 count);
+
+		ParticleEmitterSettings settings{};
+
+		u32 capacity{};
+		u32 aliveCount{};
+
+		//alive particles at the start of each chunk and where each chunk goes in WriteInstances
+		vector<u32> chunkCounts{};
+		vector<u32> chunkOffsets{};
+
+		vector<f32> posX{};
+		vector<f32> posY{};
+		vector<f32> posZ{};
+		vector<f32> velX{};
+		vector<f32> velY{};
+		vector<f32> velZ{};
+		//seconds left and one over the starting life
+		vector<f32> life{};
+		vector<f32> invLifetime{};
+		vector<f32> colorR{};
+		vector<f32> colorG{};
+		vector<f32> colorB{};
+		vector<f32> colorA{};
+		vector<f32> size{};
+
+		//xoshiro128+ state, four words for each of the four lanes
+		alignas(16) array<u32, 16> rngState{};
+
+		f32 spawnRemainder{};
+		u32 pendingBurst{};
+		u64 droppedCount{};
+	};
+}
@@ -0,0 +1,54 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl_shader.hpp"
+
+#include "core/thread_pool.hpp"
+#include "graphics/particle_emitter.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::string;
+	using std::vector;
+
+	using KalaHeaders::KalaMath::mat4;
+
+	using KalaWindow::OpenGL::OpenGL_Shader;
+
+	using GameTest::Core::ThreadPool;
+
+	//Draws emitters as additive camera facing quads, one instanced draw per emitter.
+	//Emitters write their instances straight into a stream ring owned by the renderer,
+	//so a frame of particles is never copied on the cpu.
+	class ParticleRenderer
+	{
+	public:
+		//maxParticles is how many instances all emitters can draw together in one frame
+		static string Initialize(
+			OpenGL_Shader* shader,
+			u32 maxParticles);
+		static bool IsInitialized();
+
+		//Uploads and draws every emitter, call once per frame after the opaque models.
+		//Depth is tested but not written, emitters that don't fit this frame are skipped
+		static void Render(
+			const vector<ParticleEmitter*>& emitters,
+			const mat4& view,
+			const mat4& projection,
+			ThreadPool* workers = nullptr);
+
+		//instances drawn by the last Render
+		static u32 GetLastParticleCount();
+
+		static void Shutdown();
+	};
+}
@@ -43,7 +43,15 @@ namespace GameTest::Graphics
 		static vector<Camera*>& GetCameras();
 		static vector<OpenGL_Model*>& GetModels();
 		static vector<OpenGL_PointLight*>& GetPointLights();
+
+		//Rebuilds the static batches after the next model command playback,
+		//call whenever static models were moved, created or destroyed
+		static void RequestStaticBatchRebuild();
 		
 		static void Update();
+
+		//Drops the handles to everything loaded in Initialize,
+		//the resource manager destroys them once nothing else uses them
+		static void ReleaseResources();
 	};
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_shader.hpp"
+
+#include "core/resource_manager.hpp"
+#include "graphics/opengl_texture.hpp"
+#include "gameobject/opengl_model.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::string;
+	using std::vector;
+	using std::filesystem::path;
+
+	using KalaWindow::OpenGL::OpenGL_Context;
+	using KalaWindow::OpenGL::OpenGL_Shader;
+
+	using GameTest::Core::ResourceHandle;
+	using GameTest::GameObject::OpenGL_Model;
+
+	//Every model created from one .kmd file
+	struct ModelSet
+	{
+		vector<OpenGL_Model*> models{};
+	};
+
+	//ResourceManager descriptions for the render resource types.
+	//File reads and decoding run on the loader threads, gl work runs in ResourceManager::Update
+	class ResourceLoaders
+	{
+	public:
+		static ResourceHandle<OpenGL_Shader> LoadShader(
+			OpenGL_Context* context,
+			const string& name,
+			const path& vertPath,
+			const path& fragPath);
+
+		static ResourceHandle<OpenGL_Texture> LoadTexture(
+			OpenGL_Context* context,
+			const string& name,
+			const path& texturePath,
+			TextureFormat format = TextureFormat::Format_Auto,
+			bool flipVertically = false,
+			u8 mipMapLevels = 1);
+
+		//The model is finalized once its shader and optional diffuse texture are ready,
+		//and keeps both alive until it is released.
+		//Level geometry that never moves is loaded with isStatic so StaticBatcher can merge it
+		static ResourceHandle<ModelSet> LoadModel(
+			OpenGL_Context* context,
+			const path& modelPath,
+			const ResourceHandle<OpenGL_Shader>& shader,
+			const ResourceHandle<OpenGL_Texture>& diffuseTexture = {},
+			bool isStatic = false);
+	};
+}
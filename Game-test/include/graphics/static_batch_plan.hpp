@@ -0,0 +1,47 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::vector;
+
+	using KalaHeaders::KalaMath::vec3;
+
+	//world space edge length of one batching cell
+	constexpr f32 STATIC_BATCH_CHUNK_SIZE = 32.0f;
+
+	//vertices merged into one batch before a cell is split into another batch
+	constexpr u32 STATIC_BATCH_MAX_VERTICES = 1u << 20;
+
+	//What the planner needs to know about one static model
+	struct StaticBatchSource
+	{
+		//sources with the same material index may share a batch
+		u32 material{};
+		//center of the world space bounds, picks the cell
+		vec3 worldCenter{};
+		u32 vertexCount{};
+	};
+
+	//Decides which static models are merged together without touching any model or gl state,
+	//StaticBatcher::Build feeds it the eligible models and uploads the result
+	class StaticBatchPlan
+	{
+	public:
+		//Groups sources by material and cell, splitting a cell when it passes maxVertices.
+		//Returns the source indices of every batch with more than one source,
+		//sources that end up alone are left out since they already are one draw
+		static vector<vector<u32>> Plan(
+			const vector<StaticBatchSource>& sources,
+			f32 chunkSize = STATIC_BATCH_CHUNK_SIZE,
+			u32 maxVertices = STATIC_BATCH_MAX_VERTICES);
+	};
+}
@@ -0,0 +1,54 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+
+#include "gameobject/opengl_model.hpp"
+#include "graphics/static_batch_plan.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::vector;
+
+	using KalaHeaders::KalaMath::vec3;
+
+	using KalaWindow::OpenGL::OpenGL_Context;
+
+	using GameTest::GameObject::OpenGL_Model;
+
+	//One merged model and the world space box around its geometry
+	struct StaticBatch
+	{
+		OpenGL_Model* model{};
+		vec3 boundsMin{};
+		vec3 boundsMax{};
+		//source models drawn by this batch, they take its place again when it is rebuilt
+		vector<OpenGL_Model*> sources{};
+	};
+
+	//Merges static models that share a material into one draw per spatial cell,
+	//StaticBatchPlan picks the groups and this uploads them.
+	//Vertices are pre-transformed into world space so the batch model keeps an identity transform,
+	//and since every cell becomes its own model, the batches are still culled one cell at a time.
+	class StaticBatcher
+	{
+	public:
+		//Replaces every batched source model in models with its batch, models that are not static
+		//or alone in their cell are left untouched, transparent ones too unless weighted OIT is running.
+		//The source models stay alive with their owner.
+		//The returned batches are owned by the model registry and have to be removed by the caller
+		static vector<StaticBatch> Build(
+			vector<OpenGL_Model*>& models,
+			OpenGL_Context* context,
+			f32 chunkSize = STATIC_BATCH_CHUNK_SIZE,
+			u32 maxVertices = STATIC_BATCH_MAX_VERTICES);
+	};
+}
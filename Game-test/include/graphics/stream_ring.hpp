@@ -0,0 +1,164 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "OpenGL/glcorearb.h"
+#include "OpenGL/glext.h"
+
+namespace GameTest::Graphics
+{
+	using std::string;
+	using std::vector;
+	using std::array;
+
+	//most frame regions a ring can be split into
+	constexpr u32 STREAM_RING_MAX_FRAMES = 3u;
+
+	//frame regions are padded to this so every region starts at the same alignment
+	constexpr size_t STREAM_RING_REGION_ALIGNMENT = 256u;
+
+	enum class StreamRingMode
+	{
+		//persistent if the context supports ARB_buffer_storage, otherwise orphan
+		STREAM_AUTO,
+		//one coherent mapping for the lifetime of the ring, regions are guarded by fences
+		STREAM_PERSISTENT,
+		//a single region that is orphaned every frame and filled with glBufferSubData
+		STREAM_ORPHAN
+	};
+
+	//Sub-allocation of the current frame region, valid until the next BeginFrame
+	struct StreamAllocation
+	{
+		//cpu write pointer, null if the allocation failed
+		u8* data{};
+		//gl buffer to bind and the byte offset of this allocation inside it
+		u32 buffer{};
+		size_t offset{};
+		size_t size{};
+
+		bool IsValid() const { return data != nullptr; }
+	};
+
+	struct StreamRingStats
+	{
+		u64 frameCount{};
+		u64 allocationCount{};
+		//allocations that did not fit into their frame region
+		u64 overflowCount{};
+		//frames where the region was still in use by the gpu
+		u64 stallCount{};
+		f64 stallMilliseconds{};
+		//most bytes used by a single frame
+		size_t peakFrameBytes{};
+	};
+
+	//Every gl entry point a stream ring calls. The ring only talks to gl through this table,
+	//so its fence, wrap and orphan bookkeeping can run against a stub without a context
+	struct StreamRingGL
+	{
+		PFNGLGENBUFFERSPROC glGenBuffers;
+		PFNGLDELETEBUFFERSPROC glDeleteBuffers;
+		PFNGLBINDBUFFERPROC glBindBuffer;
+		PFNGLBUFFERDATAPROC glBufferData;
+		PFNGLBUFFERSUBDATAPROC glBufferSubData;
+		PFNGLBUFFERSTORAGEPROC glBufferStorage;
+		PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+		PFNGLUNMAPBUFFERPROC glUnmapBuffer;
+		PFNGLGETINTEGERVPROC glGetIntegerv;
+
+		PFNGLFENCESYNCPROC glFenceSync;
+		PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+		PFNGLDELETESYNCPROC glDeleteSync;
+
+		//the context supports ARB_buffer_storage, only read by STREAM_AUTO
+		bool hasBufferStorage;
+	};
+
+	//Upload ring for per-frame dynamic gpu data. One buffer is split into a region per frame in flight,
+	//each frame writes straight into its mapped region and a fence keeps the cpu
+	//from overwriting a region the gpu still reads from.
+	class StreamRing
+	{
+	public:
+		//Table of the current context from the loaded GL_Core and GL_Extra,
+		//defined in stream_ring_gl.cpp so stub builds don't link the loaders
+		static StreamRingGL GetContextGL();
+
+		//regionSize is rounded up to STREAM_RING_REGION_ALIGNMENT,
+		//the gl table is copied and used for every call until Shutdown
+		string Initialize(
+			size_t regionSize,
+			u32 framesInFlight = STREAM_RING_MAX_FRAMES,
+			StreamRingMode mode = StreamRingMode::STREAM_AUTO,
+			const StreamRingGL& glTable = GetContextGL());
+
+		bool IsInitialized() const { return isInitialized; }
+		bool IsPersistent() const { return isPersistent; }
+
+		//Moves to the next region and waits for its fence if the gpu is still using it
+		void BeginFrame();
+
+		//Returns an invalid allocation if the region has no room left,
+		//alignment must be a power of two
+		StreamAllocation Allocate(
+			size_t size,
+			size_t alignment = 16);
+
+		//Makes everything written since the last flush visible to the gpu,
+		//only needed in orphan mode, persistent mappings are coherent
+		void Flush();
+
+		//Fences the current region, call after the last draw that reads from it
+		void EndFrame();
+
+		u32 GetBuffer() const { return buffer; }
+		size_t GetRegionSize() const { return regionSize; }
+		size_t GetFrameBytes() const { return used; }
+		u32 GetFramesInFlight() const { return frameCount; }
+
+		//GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT of the context
+		size_t GetUniformAlignment() const { return uniformAlignment; }
+
+		const StreamRingStats& GetStats() const { return stats; }
+
+		//Deletes fences and the buffer, the context must still be current
+		void Shutdown();
+	private:
+		bool isInitialized{};
+		bool isPersistent{};
+		bool isInFrame{};
+
+		StreamRingGL gl{};
+
+		u32 buffer{};
+		size_t regionSize{};
+		size_t uniformAlignment = STREAM_RING_REGION_ALIGNMENT;
+
+		u32 frameCount{};
+		u32 region{};
+
+		//bytes used in the current region and how many of them were already flushed
+		size_t used{};
+		size_t flushed{};
+
+		//persistent mapping of the whole buffer
+		u8* mapped{};
+		//cpu copy of the single region in orphan mode
+		vector<u8> shadow{};
+
+		array<GLsync, STREAM_RING_MAX_FRAMES> fences{};
+
+		StreamRingStats stats{};
+	};
+}
@@ -0,0 +1,59 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "graphics/opengl_texture.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::string;
+
+	//bytes of the persistently mapped pixel unpack staging ring
+	constexpr size_t TEXTURE_STAGING_SIZE = 64u << 20;
+
+	//threads that copy decoded pixels into staging memory
+	constexpr u32 TEXTURE_UPLOAD_THREADS = 2u;
+
+	//Asynchronous texture uploads through pixel unpack buffers.
+	//Decoded pixels are copied into mapped staging memory on worker threads,
+	//the gl thread then uploads from the buffer offset and a fence tells when the texture can be sampled.
+	//Textures report IsUploaded false until then and are drawn with the fallback texture.
+	class TextureUploader
+	{
+	public:
+		//Uses one persistently mapped staging ring with ARB_buffer_storage,
+		//otherwise a mapped pixel buffer per upload
+		static string Initialize(
+			size_t stagingSize = TEXTURE_STAGING_SIZE,
+			u32 threadCount = TEXTURE_UPLOAD_THREADS);
+		static bool IsInitialized();
+
+		//Queues the level 0 upload of a texture whose storage already exists,
+		//returns false if the caller has to upload it synchronously
+		static bool Queue(
+			OpenGL_Texture* texture,
+			u32 glFormat,
+			u32 glType,
+			u8 mipMapLevels);
+
+		//Uploads finished copies and retires uploads whose fence has signaled,
+		//call once per frame with the context current
+		static void Update();
+
+		//Drops every pending upload of a texture, waits for its copy if one is running
+		static void Cancel(OpenGL_Texture* texture);
+
+		static u32 GetPendingCount();
+
+		//Waits for the copy threads and releases the staging memory,
+		//textures that were still pending are never uploaded
+		static void Shutdown();
+	};
+}
@@ -0,0 +1,48 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl_shader.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::string;
+
+	using KalaHeaders::KalaMath::vec2;
+
+	using KalaWindow::OpenGL::OpenGL_Shader;
+
+	//Weighted blended order-independent transparency.
+	//Transparent surfaces add their weighted color into an accumulation target and multiply
+	//their coverage into a revealage target in any order, one fullscreen pass then resolves
+	//both over the opaque scene. No depth sorting is needed, so transparent draws batch like opaque ones.
+	class WeightedOIT
+	{
+	public:
+		//Creates the render targets at the size of the default framebuffer
+		static string Initialize(
+			OpenGL_Shader* compositeShader,
+			const vec2& size);
+		static bool IsInitialized();
+
+		//Recreates the render targets, call when the default framebuffer is resized
+		static void Resize(const vec2& size);
+
+		//Copies the opaque depth, clears the targets and sets the blend state for transparent draws
+		static void Begin();
+		//True between Begin and Composite, models write weighted outputs while this is set
+		static bool IsActive();
+
+		//Blends the resolved transparency over the default framebuffer and restores opaque state
+		static void Composite();
+
+		static void Shutdown();
+	};
+}
@@ -0,0 +1,84 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <filesystem>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_shader.hpp"
+
+namespace GameTest::Graphics
+{
+	using std::string;
+	using std::filesystem::path;
+
+	using KalaHeaders::KalaMath::vec3;
+
+	using KalaWindow::OpenGL::OpenGL_Context;
+	using KalaWindow::OpenGL::OpenGL_Shader;
+
+	struct WorldPartitionSettings
+	{
+		//width of one square cell on the xz plane
+		f32 cellSize = 64.0f;
+
+		//cells closer than loadRadius to the camera are loaded,
+		//loaded cells are only unloaded once they are further than unloadRadius
+		f32 loadRadius = 128.0f;
+		f32 unloadRadius = 192.0f;
+
+		//models created and destroyed per frame, spreads a cell over several frames
+		u32 uploadBudget = 8u;
+		u32 destroyBudget = 16u;
+
+		//cells read on the loader threads at once, bounds the cpu memory of loads in flight
+		u32 maxLoadingCells = 4u;
+	};
+
+	enum class WorldCellState : u8
+	{
+		CELL_UNLOADED,
+		CELL_LOADING,   //blocks are read on a loader thread
+		CELL_UPLOADING, //models are created a budget at a time
+		CELL_RESIDENT,
+		CELL_UNLOADING  //models are destroyed a budget at a time
+	};
+
+	//Streams the models of one large .kmd file around the camera. Every block is binned
+	//into a grid cell by its position, cells near the camera read only their own blocks
+	//through the model tables on the loader threads and far cells destroy their models,
+	//so resident memory depends on the radius and not on the size of the world.
+	//Models are created and destroyed through the model registry command buffer.
+	class WorldPartition
+	{
+	public:
+		//Reads the header, tables and block positions of worldPath and builds the cell grid,
+		//no model data is read until a cell is in range
+		static string Open(
+			const path& worldPath,
+			OpenGL_Context* context,
+			OpenGL_Shader* shader,
+			const WorldPartitionSettings& settings = {});
+		static bool IsOpen();
+
+		//Loads and unloads cells around cameraPos and spends this frame's budgets,
+		//call once per frame on the main thread before the model commands are played back
+		static void Update(const vec3& cameraPos);
+
+		static const WorldPartitionSettings& GetSettings();
+
+		static u32 GetCellCount();
+		static u32 GetCellCount(WorldCellState state);
+		//streamed models that currently exist
+		static u32 GetModelCount();
+
+		//Queues every streamed model for destruction and drops all cells
+		static void Close();
+	};
+}
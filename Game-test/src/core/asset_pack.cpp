@@ -0,0 +1,897 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+#include <unordered_set>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cctype>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/file_utils.hpp"
+
+#include "core/asset_pack.hpp"
+#include "core/content_hash.hpp"
+#include "core/mapped_file.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaFile::ReadTextFromFile;
+using KalaHeaders::KalaFile::ReadBinaryLinesFromFile;
+using KalaHeaders::KalaFile::WriteU8;
+using KalaHeaders::KalaFile::WriteU16;
+using KalaHeaders::KalaFile::WriteU32;
+
+using GameTest::Core::AssetPack;
+using GameTest::Core::PackEntry;
+using GameTest::Core::PackBuildSettings;
+using GameTest::Core::ContentHash;
+using GameTest::Core::MappedFile;
+using GameTest::Core::FileMapping;
+using GameTest::Core::PACK_MAGIC;
+using GameTest::Core::PACK_VERSION;
+using GameTest::Core::PACK_HEADER_SIZE;
+using GameTest::Core::PACK_ENTRY_SIZE;
+using GameTest::Core::PACK_ALIGNMENT;
+using GameTest::Core::PACK_FLAG_COMPRESSED;
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::unordered_set;
+using std::ofstream;
+using std::ostringstream;
+using std::ios;
+using std::streamsize;
+using std::sort;
+using std::lower_bound;
+using std::exception;
+using std::move;
+using std::to_string;
+using std::filesystem::path;
+using std::filesystem::current_path;
+using std::filesystem::exists;
+using std::filesystem::is_directory;
+using std::filesystem::is_regular_file;
+using std::filesystem::recursive_directory_iterator;
+
+//an lz4 length byte expands to at most 255 output bytes, so no valid block
+//decompresses to more than 255 times its stored size
+constexpr u64 PACK_MAX_COMPRESSION_RATIO = 255u;
+
+struct MountedPack
+{
+	MappedFile file{};
+	vector<PackEntry> entries{};
+	const char* names{};
+	u32 namesSize{};
+};
+
+static bool isMounted{};
+static MountedPack mounted{};
+
+static path& RootPath()
+{
+	static path root = current_path() / "files";
+	return root;
+}
+
+static void AppendU64(vector<u8>& data, u64 value);
+static u64 ReadU64At(const u8* data);
+static u32 ReadU32At(const u8* data);
+static u16 ReadU16At(const u8* data);
+
+static vector<u8> CompressBlock(const u8* src, size_t srcSize);
+static bool DecompressBlock(
+	const u8* src,
+	size_t srcSize,
+	u8* dst,
+	size_t dstSize);
+
+static bool ParseToc(
+	const u8* data,
+	u64 size,
+	vector<PackEntry>& outEntries,
+	u32& outNamesOffset,
+	u32& outNamesSize,
+	string& outError);
+
+static string ReadEntry(
+	const u8* packData,
+	const PackEntry& entry,
+	vector<u8>& outData);
+
+namespace GameTest::Core
+{
+	bool AssetPack::Mount(const path& packPath)
+	{
+		if (isMounted) Unmount();
+
+		MappedFile file{};
+		if (!FileMapping::Map(packPath, file))
+		{
+			Log::Print(
+				"Failed to map asset pack '" + packPath.string() + "'!",
+				"ASSET_PACK",
+				LogType::LOG_ERROR,
+				2);
+
+			return false;
+		}
+
+		vector<PackEntry> entries{};
+		u32 namesOffset{};
+		u32 namesSize{};
+		string error{};
+
+		if (!ParseToc(
+			file.data,
+			file.size,
+			entries,
+			namesOffset,
+			namesSize,
+			error))
+		{
+			FileMapping::Unmap(file);
+
+			Log::Print(
+				"Failed to mount asset pack '" + packPath.string() + "'! Reason: " + error,
+				"ASSET_PACK",
+				LogType::LOG_ERROR,
+				2);
+
+			return false;
+		}
+
+		mounted.file = file;
+		mounted.entries = move(entries);
+		mounted.names = rcast<const char*>(file.data + namesOffset);
+		mounted.namesSize = namesSize;
+
+		isMounted = true;
+
+		Log::Print(
+			"Mounted asset pack '" + packPath.string() + "' with "
+			+ to_string(mounted.entries.size()) + " entries.",
+			"ASSET_PACK",
+			LogType::LOG_SUCCESS);
+
+		return true;
+	}
+
+	void AssetPack::Unmount()
+	{
+		if (!isMounted) return;
+
+		FileMapping::Unmap(mounted.file);
+		mounted = {};
+
+		isMounted = false;
+	}
+
+	bool AssetPack::IsMounted() { return isMounted; }
+
+	void AssetPack::SetRootPath(const path& newRoot) { RootPath() = newRoot; }
+	const path& AssetPack::GetRootPath() { return RootPath(); }
+
+	string AssetPack::ToVirtualPath(const path& filePath)
+	{
+		path rel = filePath.lexically_normal().lexically_relative(RootPath().lexically_normal());
+
+		//not under the root, use the path as-is
+		if (rel.empty()
+			|| *rel.begin() == "..")
+		{
+			return filePath.lexically_normal().generic_string();
+		}
+
+		return rel.generic_string();
+	}
+
+	const PackEntry* AssetPack::FindEntry(const path& filePath)
+	{
+		if (!isMounted) return nullptr;
+
+		string virtualPath = ToVirtualPath(filePath);
+		u64 hash = ContentHash::HashString(virtualPath);
+
+		auto it = lower_bound(
+			mounted.entries.begin(),
+			mounted.entries.end(),
+			hash,
+			[](const PackEntry& e, u64 h) { return e.pathHash < h; });
+
+		//hash collisions are resolved by comparing the stored name
+		for (; it != mounted.entries.end() && it->pathHash == hash; ++it)
+		{
+			string_view name(mounted.names + it->nameOffset, it->nameLength);
+			if (name == virtualPath) return &(*it);
+		}
+
+		return nullptr;
+	}
+
+	bool AssetPack::Exists(const path& filePath)
+	{
+		if (FindEntry(filePath)) return true;
+
+		return exists(filePath);
+	}
+
+	vector<path> AssetPack::ListFiles(const path& dirPath)
+	{
+		vector<path> files{};
+		unordered_set<string> seen{};
+
+		//the root itself lists everything
+		string virtualDir = ToVirtualPath(dirPath);
+		if (virtualDir == ".") virtualDir.clear();
+		if (!virtualDir.empty()
+			&& virtualDir.back() != '/')
+		{
+			virtualDir += '/';
+		}
+
+		for (const auto& e : mounted.entries)
+		{
+			string_view name(mounted.names + e.nameOffset, e.nameLength);
+			if (!name.starts_with(virtualDir)) continue;
+
+			if (seen.emplace(name).second) files.push_back(RootPath() / path(name));
+		}
+
+		if (exists(dirPath)
+			&& is_directory(dirPath))
+		{
+			for (const auto& entry : recursive_directory_iterator(dirPath))
+			{
+				if (!entry.is_regular_file()) continue;
+
+				if (seen.emplace(ToVirtualPath(entry.path())).second) files.push_back(entry.path());
+			}
+		}
+
+		return files;
+	}
+
+	string AssetPack::ReadText(
+		const path& filePath,
+		string& outText)
+	{
+		const PackEntry* entry = FindEntry(filePath);
+		if (!entry) return ReadTextFromFile(filePath, outText);
+
+		vector<u8> data{};
+		string result = ReadEntry(mounted.file.data, *entry, data);
+		if (!result.empty()) return result;
+
+		if (data.empty())
+		{
+			return "Failed to read text from packed file '" + ToVirtualPath(filePath) + "' because it was empty!";
+		}
+
+		outText.assign(rcast<const char*>(data.data()), data.size());
+
+		return{};
+	}
+
+	string AssetPack::ReadBinary(
+		const path& filePath,
+		vector<u8>& outData)
+	{
+		const PackEntry* entry = FindEntry(filePath);
+		if (!entry) return ReadBinaryLinesFromFile(filePath, outData);
+
+		return ReadEntry(mounted.file.data, *entry, outData);
+	}
+
+	const u8* AssetPack::GetMappedData(
+		const path& filePath,
+		u64& outSize)
+	{
+		const PackEntry* entry = FindEntry(filePath);
+		if (!entry
+			|| entry->flags & PACK_FLAG_COMPRESSED)
+		{
+			return nullptr;
+		}
+
+		outSize = entry->rawSize;
+		return mounted.file.data + entry->offset;
+	}
+
+	string AssetPack::BuildPack(
+		const path& sourceDir,
+		const path& targetPack,
+		const PackBuildSettings& settings)
+	{
+		ostringstream oss{};
+
+		if (!exists(sourceDir)
+			|| !is_directory(sourceDir))
+		{
+			oss << "Failed to build pack because source '" << sourceDir << "' is not a directory!";
+			return oss.str();
+		}
+
+		struct PendingEntry
+		{
+			path file{};
+			string virtualPath{};
+			PackEntry entry{};
+		};
+
+		//collect files and names first so the data offset is known up front
+
+		vector<PendingEntry> pending{};
+
+		try
+		{
+			for (const auto& it : recursive_directory_iterator(sourceDir))
+			{
+				if (!it.is_regular_file()) continue;
+
+				PendingEntry p{};
+				p.file = it.path();
+				p.virtualPath = it.path().lexically_relative(sourceDir).generic_string();
+
+				if (p.virtualPath.size() > UINT16_MAX)
+				{
+					oss << "Failed to build pack because path '" << p.virtualPath << "' is too long!";
+					return oss.str();
+				}
+
+				p.entry.pathHash = ContentHash::HashString(p.virtualPath);
+
+				pending.push_back(move(p));
+			}
+		}
+		catch (exception& e)
+		{
+			oss << "Failed to build pack while scanning '" << sourceDir << "'! Reason: " << e.what();
+			return oss.str();
+		}
+
+		if (pending.empty())
+		{
+			oss << "Failed to build pack because source '" << sourceDir << "' has no files!";
+			return oss.str();
+		}
+
+		sort(
+			pending.begin(),
+			pending.end(),
+			[](const PendingEntry& a, const PendingEntry& b)
+			{
+				if (a.entry.pathHash != b.entry.pathHash) return a.entry.pathHash < b.entry.pathHash;
+				return a.virtualPath < b.virtualPath;
+			});
+
+		vector<u8> names{};
+		for (auto& p : pending)
+		{
+			p.entry.nameOffset = scast<u32>(names.size());
+			p.entry.nameLength = scast<u16>(p.virtualPath.size());
+
+			names.insert(names.end(), p.virtualPath.begin(), p.virtualPath.end());
+		}
+
+		u32 entryCount = scast<u32>(pending.size());
+		u32 tocOffset = PACK_HEADER_SIZE;
+		u32 namesOffset = tocOffset + entryCount * PACK_ENTRY_SIZE;
+		u32 namesSize = scast<u32>(names.size());
+
+		auto AlignUp = [](u64 v) { return (v + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1); };
+
+		u64 dataOffset = AlignUp(scast<u64>(namesOffset) + namesSize);
+
+		try
+		{
+			ofstream out(targetPack, ios::out | ios::binary | ios::trunc);
+			if (out.fail())
+			{
+				oss << "Failed to build pack because '" << targetPack << "' couldn't be opened for writing!";
+				return oss.str();
+			}
+
+			//toc is written last once every offset and size is known,
+			//reserve its space with zeroes for now
+
+			vector<u8> zeroes(scast<size_t>(dataOffset), 0);
+			out.write(rcast<const char*>(zeroes.data()), scast<streamsize>(zeroes.size()));
+
+			u64 cursor = dataOffset;
+
+			for (auto& p : pending)
+			{
+				vector<u8> raw{};
+				string readResult = ReadBinaryLinesFromFile(p.file, raw);
+
+				//ReadBinaryLinesFromFile refuses empty files, those are stored as zero-length entries
+				if (!readResult.empty()
+					&& std::filesystem::file_size(p.file) != 0)
+				{
+					return readResult;
+				}
+
+				p.entry.rawSize = raw.size();
+				p.entry.contentHash = ContentHash::HashBytes(raw.data(), raw.size());
+				p.entry.offset = cursor;
+
+				string ext = p.file.extension().string();
+				std::transform(ext.begin(), ext.end(), ext.begin(),
+					[](unsigned char c) { return scast<char>(std::tolower(c)); });
+
+				bool storeOnly = std::find(
+					settings.storeOnlyExtensions.begin(),
+					settings.storeOnlyExtensions.end(),
+					ext) != settings.storeOnlyExtensions.end();
+
+				vector<u8> compressed{};
+				if (settings.compress
+					&& !storeOnly
+					&& raw.size() >= settings.minCompressSize
+					&& raw.size() <= UINT32_MAX)
+				{
+					compressed = CompressBlock(raw.data(), raw.size());
+				}
+
+				const vector<u8>* stored = &raw;
+				if (!compressed.empty()
+					&& compressed.size() < raw.size())
+				{
+					stored = &compressed;
+					p.entry.flags |= PACK_FLAG_COMPRESSED;
+				}
+
+				p.entry.storedSize = stored->size();
+
+				out.write(rcast<const char*>(stored->data()), scast<streamsize>(stored->size()));
+
+				u64 next = AlignUp(cursor + stored->size());
+				u64 padding = next - cursor - stored->size();
+				if (padding > 0)
+				{
+					vector<u8> pad(scast<size_t>(padding), 0);
+					out.write(rcast<const char*>(pad.data()), scast<streamsize>(pad.size()));
+				}
+
+				cursor = next;
+			}
+
+			//header, toc and names
+
+			vector<u8> head{};
+			head.reserve(scast<size_t>(namesOffset) + namesSize);
+
+			WriteU32(head, scast<size_t>(-1), PACK_MAGIC);
+			WriteU8(head, scast<size_t>(-1), PACK_VERSION);
+			WriteU8(head, scast<size_t>(-1), 0);
+			WriteU16(head, scast<size_t>(-1), 0);
+			WriteU32(head, scast<size_t>(-1), entryCount);
+			WriteU32(head, scast<size_t>(-1), tocOffset);
+			WriteU32(head, scast<size_t>(-1), namesOffset);
+			WriteU32(head, scast<size_t>(-1), namesSize);
+			AppendU64(head, dataOffset);
+
+			for (const auto& p : pending)
+			{
+				AppendU64(head, p.entry.pathHash);
+				AppendU64(head, p.entry.contentHash);
+				AppendU64(head, p.entry.offset);
+				AppendU64(head, p.entry.storedSize);
+				AppendU64(head, p.entry.rawSize);
+				WriteU32(head, scast<size_t>(-1), p.entry.nameOffset);
+				WriteU16(head, scast<size_t>(-1), p.entry.nameLength);
+				WriteU8(head, scast<size_t>(-1), p.entry.flags);
+				WriteU8(head, scast<size_t>(-1), 0);
+			}
+
+			head.insert(head.end(), names.begin(), names.end());
+
+			out.seekp(0);
+			out.write(rcast<const char*>(head.data()), scast<streamsize>(head.size()));
+
+			if (out.fail())
+			{
+				oss << "Failed to write pack '" << targetPack << "'!";
+				return oss.str();
+			}
+
+			out.close();
+		}
+		catch (exception& e)
+		{
+			oss << "Failed to build pack '" << targetPack << "'! Reason: " << e.what();
+			return oss.str();
+		}
+
+		return{};
+	}
+
+	string AssetPack::VerifyPack(const path& packPath)
+	{
+		MappedFile file{};
+		if (!FileMapping::Map(packPath, file))
+		{
+			return "Failed to verify pack '" + packPath.string() + "' because it couldn't be mapped!";
+		}
+
+		vector<PackEntry> entries{};
+		u32 namesOffset{};
+		u32 namesSize{};
+		string error{};
+
+		if (!ParseToc(
+			file.data,
+			file.size,
+			entries,
+			namesOffset,
+			namesSize,
+			error))
+		{
+			FileMapping::Unmap(file);
+			return error;
+		}
+
+		for (const auto& e : entries)
+		{
+			vector<u8> data{};
+			string result = ReadEntry(file.data, e, data);
+			if (!result.empty())
+			{
+				FileMapping::Unmap(file);
+				return result;
+			}
+		}
+
+		FileMapping::Unmap(file);
+
+		return{};
+	}
+}
+
+void AppendU64(vector<u8>& data, u64 value)
+{
+	WriteU32(data, scast<size_t>(-1), scast<u32>(value & 0xFFFFFFFF));
+	WriteU32(data, scast<size_t>(-1), scast<u32>(value >> 32));
+}
+
+u64 ReadU64At(const u8* data)
+{
+	u64 v{};
+	memcpy(&v, data, sizeof(u64));
+	return v;
+}
+u32 ReadU32At(const u8* data)
+{
+	u32 v{};
+	memcpy(&v, data, sizeof(u32));
+	return v;
+}
+u16 ReadU16At(const u8* data)
+{
+	u16 v{};
+	memcpy(&v, data, sizeof(u16));
+	return v;
+}
+
+bool ParseToc(
+	const u8* data,
+	u64 size,
+	vector<PackEntry>& outEntries,
+	u32& outNamesOffset,
+	u32& outNamesSize,
+	string& outError)
+{
+	if (size < PACK_HEADER_SIZE)
+	{
+		outError = "file is smaller than the pack header";
+		return false;
+	}
+
+	if (ReadU32At(data + 0) != PACK_MAGIC)
+	{
+		outError = "invalid magic";
+		return false;
+	}
+	if (data[4] != PACK_VERSION)
+	{
+		outError = "unsupported version";
+		return false;
+	}
+
+	u32 entryCount = ReadU32At(data + 8);
+	u32 tocOffset = ReadU32At(data + 12);
+	u32 namesOffset = ReadU32At(data + 16);
+	u32 namesSize = ReadU32At(data + 20);
+
+	if (scast<u64>(tocOffset) + scast<u64>(entryCount) * PACK_ENTRY_SIZE > size
+		|| scast<u64>(namesOffset) + namesSize > size)
+	{
+		outError = "toc or name table is out of bounds";
+		return false;
+	}
+
+	vector<PackEntry> entries{};
+	entries.reserve(entryCount);
+
+	for (u32 i = 0; i < entryCount; ++i)
+	{
+		const u8* e = data + tocOffset + scast<u64>(i) * PACK_ENTRY_SIZE;
+
+		PackEntry entry{};
+		entry.pathHash    = ReadU64At(e + 0);
+		entry.contentHash = ReadU64At(e + 8);
+		entry.offset      = ReadU64At(e + 16);
+		entry.storedSize  = ReadU64At(e + 24);
+		entry.rawSize     = ReadU64At(e + 32);
+		entry.nameOffset  = ReadU32At(e + 40);
+		entry.nameLength  = ReadU16At(e + 44);
+		entry.flags       = e[46];
+
+		if (entry.offset % PACK_ALIGNMENT != 0
+			|| entry.offset > size
+			|| entry.storedSize > size - entry.offset
+			|| scast<u64>(entry.nameOffset) + entry.nameLength > namesSize)
+		{
+			outError = "entry " + to_string(i) + " is out of bounds";
+			return false;
+		}
+
+		//rawSize decides the read allocation, so it is capped by what the stored bytes can expand to
+		bool isCompressed = entry.flags & PACK_FLAG_COMPRESSED;
+		if (isCompressed
+			? entry.rawSize / PACK_MAX_COMPRESSION_RATIO > entry.storedSize
+			: entry.rawSize != entry.storedSize)
+		{
+			outError = "entry " + to_string(i) + " has an invalid raw size";
+			return false;
+		}
+
+		if (!entries.empty()
+			&& entries.back().pathHash > entry.pathHash)
+		{
+			outError = "toc is not sorted";
+			return false;
+		}
+
+		entries.push_back(entry);
+	}
+
+	outEntries = move(entries);
+	outNamesOffset = namesOffset;
+	outNamesSize = namesSize;
+
+	return true;
+}
+
+string ReadEntry(
+	const u8* packData,
+	const PackEntry& entry,
+	vector<u8>& outData)
+{
+	const u8* src = packData + entry.offset;
+
+	vector<u8> data(scast<size_t>(entry.rawSize));
+
+	if (entry.flags & PACK_FLAG_COMPRESSED)
+	{
+		if (!DecompressBlock(
+			src,
+			scast<size_t>(entry.storedSize),
+			data.data(),
+			data.size()))
+		{
+			return "Failed to decompress packed entry at offset " + to_string(entry.offset) + "!";
+		}
+	}
+	else
+	{
+		if (entry.storedSize != entry.rawSize)
+		{
+			return "Packed entry at offset " + to_string(entry.offset) + " has mismatching sizes!";
+		}
+
+		if (!data.empty()) memcpy(data.data(), src, data.size());
+	}
+
+	if (ContentHash::HashBytes(data.data(), data.size()) != entry.contentHash)
+	{
+		return "Packed entry at offset " + to_string(entry.offset) + " failed its content hash check!";
+	}
+
+	outData = move(data);
+
+	return{};
+}
+
+//
+// LZ4 BLOCK FORMAT
+//
+
+//matches need 4 bytes, the last 5 bytes are always literals
+//and the last match must start at least 12 bytes before the end
+constexpr size_t LZ_MIN_MATCH = 4;
+constexpr size_t LZ_LAST_LITERALS = 5;
+constexpr size_t LZ_MF_LIMIT = 12;
+constexpr size_t LZ_MAX_OFFSET = 65535;
+constexpr u32 LZ_HASH_LOG = 16;
+
+static void WriteLength(vector<u8>& out, size_t length)
+{
+	while (length >= 255)
+	{
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back(scast<u8>(length));
+}
+
+static void WriteSequence(
+	vector<u8>& out,
+	const u8* literals,
+	size_t literalLength,
+	size_t offset,
+	size_t matchLength)
+{
+	size_t tokenPos = out.size();
+	out.push_back(0);
+
+	u8 token = scast<u8>((literalLength >= 15 ? 15 : literalLength) << 4);
+	if (literalLength >= 15) WriteLength(out, literalLength - 15);
+
+	out.insert(out.end(), literals, literals + literalLength);
+
+	//final sequence has no match
+	if (matchLength > 0)
+	{
+		out.push_back(scast<u8>(offset & 0xFF));
+		out.push_back(scast<u8>(offset >> 8));
+
+		size_t ml = matchLength - LZ_MIN_MATCH;
+		token |= scast<u8>(ml >= 15 ? 15 : ml);
+		if (ml >= 15) WriteLength(out, ml - 15);
+	}
+
+	out[tokenPos] = token;
+}
+
+vector<u8> CompressBlock(const u8* src, size_t srcSize)
+{
+	vector<u8> out{};
+	out.reserve(srcSize + srcSize / 255 + 16);
+
+	size_t anchor = 0;
+
+	if (srcSize > LZ_MF_LIMIT)
+	{
+		vector<u32> table(scast<size_t>(1) << LZ_HASH_LOG, 0);
+
+		size_t ip = 1;
+		size_t limit = srcSize - LZ_MF_LIMIT;
+
+		while (ip < limit)
+		{
+			u32 sequence = ReadU32At(src + ip);
+			u32 h = (sequence * 2654435761u) >> (32 - LZ_HASH_LOG);
+
+			size_t ref = table[h];
+			table[h] = scast<u32>(ip);
+
+			if (ip - ref > LZ_MAX_OFFSET
+				|| ReadU32At(src + ref) != sequence)
+			{
+				++ip;
+				continue;
+			}
+
+			size_t matchLength = LZ_MIN_MATCH;
+			size_t maxMatch = srcSize - LZ_LAST_LITERALS - ip;
+			while (matchLength < maxMatch
+				&& src[ref + matchLength] == src[ip + matchLength])
+			{
+				++matchLength;
+			}
+
+			WriteSequence(
+				out,
+				src + anchor,
+				ip - anchor,
+				ip - ref,
+				matchLength);
+
+			ip += matchLength;
+			anchor = ip;
+		}
+	}
+
+	WriteSequence(
+		out,
+		src + anchor,
+		srcSize - anchor,
+		0,
+		0);
+
+	return out;
+}
+
+bool DecompressBlock(
+	const u8* src,
+	size_t srcSize,
+	u8* dst,
+	size_t dstSize)
+{
+	size_t ip = 0;
+	size_t op = 0;
+
+	auto ReadLength = [&](size_t& length) -> bool
+	{
+		u8 b{};
+		do
+		{
+			if (ip >= srcSize) return false;
+			b = src[ip++];
+			length += b;
+		} while (b == 255);
+
+		return true;
+	};
+
+	while (ip < srcSize)
+	{
+		u8 token = src[ip++];
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15
+			&& !ReadLength(literalLength))
+		{
+			return false;
+		}
+
+		if (ip + literalLength > srcSize
+			|| op + literalLength > dstSize)
+		{
+			return false;
+		}
+
+		memcpy(dst + op, src + ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		//final sequence
+		if (ip == srcSize) break;
+
+		if (ip + 2 > srcSize) return false;
+
+		size_t offset = scast<size_t>(src[ip]) | (scast<size_t>(src[ip + 1]) << 8);
+		ip += 2;
+
+		if (offset == 0
+			|| offset > op)
+		{
+			return false;
+		}
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15
+			&& !ReadLength(matchLength))
+		{
+			return false;
+		}
+		matchLength += LZ_MIN_MATCH;
+
+		if (op + matchLength > dstSize) return false;
+
+		//matches may overlap their own output so copy forwards byte by byte
+		const u8* match = dst + op - offset;
+		for (size_t i = 0; i < matchLength; ++i) dst[op + i] = match[i];
+
+		op += matchLength;
+	}
+
+	return op == dstSize;
+}
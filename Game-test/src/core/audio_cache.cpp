@@ -0,0 +1,392 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <algorithm>
+#include <cctype>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "core/audio_cache.hpp"
+#include "core/flac_decoder.hpp"
+#include "core/asset_pack.hpp"
+#include "core/thread_pool.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using GameTest::Core::AudioCache;
+using GameTest::Core::AudioLoadMode;
+using GameTest::Core::PcmBuffer;
+using GameTest::Core::FlacDecoder;
+using GameTest::Core::AssetPack;
+using GameTest::Core::ThreadPool;
+using GameTest::Core::STREAM_THRESHOLD_SECONDS;
+using GameTest::Core::PCM_POOL_CHUNK_SAMPLES;
+
+using std::string;
+using std::vector;
+using std::unique_ptr;
+using std::make_unique;
+using std::unordered_map;
+using std::move;
+using std::to_string;
+using std::transform;
+using std::tolower;
+using std::filesystem::path;
+
+struct CachedSound
+{
+	PcmBuffer buffer{};
+	bool isStreamed{};
+
+	//encoded bytes of streamed sounds, either owned or pointing into the mapped pack
+	vector<u8> ownedSource{};
+	const u8* source{};
+	u64 sourceSize{};
+};
+
+//a sound between reading its header and being added to the cache
+struct PendingSound
+{
+	path filePath{};
+	string key{};
+
+	vector<u8> ownedSource{};
+	const u8* source{};
+	u64 sourceSize{};
+
+	FlacDecoder decoder{};
+	bool isStreamed{};
+
+	f32* samples{};
+	string error{};
+};
+
+struct AlignedDelete
+{
+	void operator()(f32* samples) const { ::operator delete[](samples, std::align_val_t(64)); }
+};
+
+struct PcmChunk
+{
+	unique_ptr<f32[], AlignedDelete> samples{};
+	size_t capacity{};
+	size_t used{};
+};
+
+static unordered_map<string, unique_ptr<CachedSound>> sounds{};
+static vector<PcmChunk> pool{};
+
+static u64 poolCapacity{};
+static u64 poolUsage{};
+
+static f32* AllocatePCM(size_t sampleCount);
+
+static string PrepareSound(
+	const path& filePath,
+	AudioLoadMode mode,
+	PendingSound& outSound);
+static string DecodeSound(PendingSound& sound);
+static void CommitSound(PendingSound& sound);
+
+namespace GameTest::Core
+{
+	string AudioCache::Load(
+		const path& filePath,
+		AudioLoadMode mode)
+	{
+		if (IsLoaded(filePath)) return{};
+
+		PendingSound sound{};
+
+		string result = PrepareSound(filePath, mode, sound);
+		if (!result.empty()) return result;
+
+		if (!sound.isStreamed)
+		{
+			result = DecodeSound(sound);
+			if (!result.empty()) return result;
+		}
+
+		CommitSound(sound);
+
+		return{};
+	}
+
+	string AudioCache::LoadDirectory(const path& dirPath)
+	{
+		//headers are read and pcm is reserved up front on this thread
+		//so the workers only ever write into their own slice of the pool
+
+		vector<unique_ptr<PendingSound>> pending{};
+		string errors{};
+
+		for (const auto& file : AssetPack::ListFiles(dirPath))
+		{
+			string extension = file.extension().string();
+			transform(
+				extension.begin(),
+				extension.end(),
+				extension.begin(),
+				[](unsigned char c) { return scast<char>(tolower(c)); });
+
+			if (extension != ".flac"
+				|| IsLoaded(file))
+			{
+				continue;
+			}
+
+			auto sound = make_unique<PendingSound>();
+
+			string result = PrepareSound(file, AudioLoadMode::LOAD_AUTO, *sound);
+			if (!result.empty())
+			{
+				errors += result + "\n";
+				continue;
+			}
+
+			pending.push_back(move(sound));
+		}
+
+		ThreadPool workers{};
+		workers.ParallelFor(
+			pending.size(),
+			[&pending](size_t i)
+			{
+				PendingSound& sound = *pending[i];
+				if (!sound.isStreamed) sound.error = DecodeSound(sound);
+			});
+
+		u32 decodedCount{};
+		u32 streamedCount{};
+
+		for (auto& sound : pending)
+		{
+			if (!sound->error.empty())
+			{
+				errors += sound->error + "\n";
+				continue;
+			}
+
+			if (sound->isStreamed) ++streamedCount;
+			else ++decodedCount;
+
+			CommitSound(*sound);
+		}
+
+		Log::Print(
+			"Loaded " + to_string(decodedCount) + " decoded and "
+			+ to_string(streamedCount) + " streamed sounds from '"
+			+ AssetPack::ToVirtualPath(dirPath) + "', pcm pool uses "
+			+ to_string(poolUsage / 1024) + " of " + to_string(poolCapacity / 1024) + " KB.",
+			"AUDIO_CACHE",
+			LogType::LOG_INFO);
+
+		if (!errors.empty()) errors.pop_back();
+		return errors;
+	}
+
+	bool AudioCache::IsLoaded(const path& filePath)
+	{
+		return sounds.contains(AssetPack::ToVirtualPath(filePath));
+	}
+
+	bool AudioCache::IsStreamed(const path& filePath)
+	{
+		auto it = sounds.find(AssetPack::ToVirtualPath(filePath));
+		return it != sounds.end() && it->second->isStreamed;
+	}
+
+	const PcmBuffer* AudioCache::GetBuffer(const path& filePath)
+	{
+		auto it = sounds.find(AssetPack::ToVirtualPath(filePath));
+		if (it == sounds.end()
+			|| it->second->isStreamed)
+		{
+			return nullptr;
+		}
+
+		return &it->second->buffer;
+	}
+
+	const u8* AudioCache::GetStreamSource(
+		const path& filePath,
+		u64& outSize)
+	{
+		auto it = sounds.find(AssetPack::ToVirtualPath(filePath));
+		if (it == sounds.end()
+			|| !it->second->isStreamed)
+		{
+			return nullptr;
+		}
+
+		outSize = it->second->sourceSize;
+		return it->second->source;
+	}
+
+	u64 AudioCache::GetPoolCapacity() { return poolCapacity; }
+	u64 AudioCache::GetPoolUsage() { return poolUsage; }
+
+	void AudioCache::Clear()
+	{
+		sounds.clear();
+		pool.clear();
+
+		poolCapacity = 0;
+		poolUsage = 0;
+	}
+}
+
+f32* AllocatePCM(size_t sampleCount)
+{
+	//keep every sound 64 byte aligned for simd mixing
+	constexpr size_t ALIGN_SAMPLES = 64 / sizeof(f32);
+	size_t reserved = (sampleCount + ALIGN_SAMPLES - 1) & ~(ALIGN_SAMPLES - 1);
+
+	if (pool.empty()
+		|| pool.back().capacity - pool.back().used < reserved)
+	{
+		PcmChunk chunk{};
+		chunk.capacity = reserved > PCM_POOL_CHUNK_SAMPLES ? reserved : PCM_POOL_CHUNK_SAMPLES;
+		chunk.samples.reset(new (std::align_val_t(64)) f32[chunk.capacity]);
+
+		poolCapacity += chunk.capacity * sizeof(f32);
+
+		//a dedicated chunk is slotted in behind the current one so its free space isn't lost
+		if (reserved > PCM_POOL_CHUNK_SAMPLES
+			&& !pool.empty())
+		{
+			pool.insert(pool.end() - 1, move(chunk));
+
+			PcmChunk& dedicated = pool[pool.size() - 2];
+			dedicated.used = reserved;
+			poolUsage += reserved * sizeof(f32);
+			return dedicated.samples.get();
+		}
+
+		pool.push_back(move(chunk));
+	}
+
+	PcmChunk& chunk = pool.back();
+	f32* samples = chunk.samples.get() + chunk.used;
+	chunk.used += reserved;
+	poolUsage += reserved * sizeof(f32);
+
+	return samples;
+}
+
+string PrepareSound(
+	const path& filePath,
+	AudioLoadMode mode,
+	PendingSound& outSound)
+{
+	outSound.filePath = filePath;
+	outSound.key = AssetPack::ToVirtualPath(filePath);
+
+	//flac is stored uncompressed in packs, so it can usually be decoded straight from the mapping
+	outSound.source = AssetPack::GetMappedData(filePath, outSound.sourceSize);
+	if (!outSound.source)
+	{
+		string result = AssetPack::ReadBinary(filePath, outSound.ownedSource);
+		if (!result.empty())
+		{
+			return "Failed to load audio '" + outSound.key + "'! Reason: " + result;
+		}
+
+		outSound.source = outSound.ownedSource.data();
+		outSound.sourceSize = outSound.ownedSource.size();
+	}
+
+	string result = outSound.decoder.Open(
+		outSound.source,
+		scast<size_t>(outSound.sourceSize));
+
+	if (!result.empty())
+	{
+		return "Failed to load audio '" + outSound.key + "'! Reason: " + result;
+	}
+
+	const auto& info = outSound.decoder.GetInfo();
+
+	//without a known length there is nothing to reserve, so it has to stream
+	f32 seconds = scast<f32>(info.totalFrames) / scast<f32>(info.sampleRate);
+	switch (mode)
+	{
+	case AudioLoadMode::LOAD_AUTO:
+		outSound.isStreamed =
+			info.totalFrames == 0
+			|| seconds > STREAM_THRESHOLD_SECONDS;
+		break;
+	case AudioLoadMode::LOAD_DECODED:
+		if (info.totalFrames == 0)
+		{
+			return "Failed to load audio '" + outSound.key + "'! Reason: Length is unknown so it can only be streamed.";
+		}
+		outSound.isStreamed = false;
+		break;
+	case AudioLoadMode::LOAD_STREAMED:
+		outSound.isStreamed = true;
+		break;
+	}
+
+	if (!outSound.isStreamed)
+	{
+		outSound.samples = AllocatePCM(scast<size_t>(info.totalFrames) * info.channels);
+	}
+
+	return{};
+}
+
+string DecodeSound(PendingSound& sound)
+{
+	const auto& info = sound.decoder.GetInfo();
+
+	size_t framesRead{};
+	string result = sound.decoder.ReadFrames(
+		sound.samples,
+		scast<size_t>(info.totalFrames),
+		framesRead);
+
+	if (!result.empty())
+	{
+		return "Failed to decode audio '" + sound.key + "'! Reason: " + result;
+	}
+	if (framesRead != info.totalFrames)
+	{
+		return "Failed to decode audio '" + sound.key + "'! Reason: Decoded "
+			+ to_string(framesRead) + " of " + to_string(info.totalFrames) + " frames.";
+	}
+
+	return{};
+}
+
+void CommitSound(PendingSound& sound)
+{
+	const auto& info = sound.decoder.GetInfo();
+
+	auto cached = make_unique<CachedSound>();
+	cached->isStreamed = sound.isStreamed;
+
+	cached->buffer.frameCount = info.totalFrames;
+	cached->buffer.sampleRate = info.sampleRate;
+	cached->buffer.channels = info.channels;
+
+	if (sound.isStreamed)
+	{
+		//moving the vector keeps its heap block, so the data pointer stays valid
+		bool isOwned = !sound.ownedSource.empty();
+		cached->ownedSource = move(sound.ownedSource);
+		cached->source = isOwned ? cached->ownedSource.data() : sound.source;
+		cached->sourceSize = sound.sourceSize;
+	}
+	else cached->buffer.samples = sound.samples;
+
+	sounds[sound.key] = move(cached);
+}
@@ -0,0 +1,202 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "core/audio_stream.hpp"
+#include "core/audio_cache.hpp"
+#include "core/asset_pack.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using GameTest::Core::AudioStream;
+using GameTest::Core::AudioCache;
+using GameTest::Core::AssetPack;
+using GameTest::Core::STREAM_CHUNK_FRAMES;
+using GameTest::Core::STREAM_RING_CHUNKS;
+
+using std::string;
+using std::min;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+
+namespace GameTest::Core
+{
+	AudioStream::~AudioStream() { Close(); }
+
+	string AudioStream::Open(
+		const path& filePath,
+		bool looping)
+	{
+		u64 size{};
+		const u8* data = AudioCache::GetStreamSource(filePath, size);
+		if (!data)
+		{
+			return "Failed to open audio stream '" + AssetPack::ToVirtualPath(filePath)
+				+ "' because it was not loaded as a streamed sound!";
+		}
+
+		return Open(data, scast<size_t>(size), looping);
+	}
+
+	string AudioStream::Open(
+		const u8* data,
+		size_t size,
+		bool looping)
+	{
+		Close();
+
+		string result = decoder.Open(data, size);
+		if (!result.empty()) return result;
+
+		isLooping = looping;
+
+		ringFrames = scast<size_t>(STREAM_CHUNK_FRAMES) * STREAM_RING_CHUNKS;
+		ring.assign(ringFrames * decoder.GetInfo().channels, 0.0f);
+
+		writeFrame.store(0, memory_order_relaxed);
+		readFrame.store(0, memory_order_relaxed);
+		isDecodeDone.store(false, memory_order_relaxed);
+		underruns.store(0, memory_order_relaxed);
+		decodeError.clear();
+
+		worker = jthread([this](stop_token stop) { DecodeLoop(stop); });
+
+		return{};
+	}
+
+	void AudioStream::Close()
+	{
+		if (!worker.joinable()) return;
+
+		worker.request_stop();
+
+		wakeSignal.fetch_add(1, memory_order_release);
+		wakeSignal.notify_one();
+
+		worker.join();
+
+		if (!decodeError.empty())
+		{
+			Log::Print(
+				"Audio stream stopped early! Reason: " + decodeError,
+				"AUDIO_STREAM",
+				LogType::LOG_ERROR,
+				2);
+		}
+	}
+
+	size_t AudioStream::Read(
+		f32* outSamples,
+		size_t frameCount)
+	{
+		const u8 channels = decoder.GetInfo().channels;
+
+		if (ringFrames == 0)
+		{
+			memset(outSamples, 0, frameCount * channels * sizeof(f32));
+			return 0;
+		}
+
+		u64 read = readFrame.load(memory_order_relaxed);
+		u64 write = writeFrame.load(memory_order_acquire);
+
+		size_t count = scast<size_t>(min(scast<u64>(frameCount), write - read));
+
+		//copy in at most two spans because of the wrap-around
+		size_t start = scast<size_t>(read % ringFrames);
+		size_t first = min(count, ringFrames - start);
+
+		memcpy(outSamples, ring.data() + start * channels, first * channels * sizeof(f32));
+		memcpy(outSamples + first * channels, ring.data(), (count - first) * channels * sizeof(f32));
+
+		if (count < frameCount)
+		{
+			memset(outSamples + count * channels, 0, (frameCount - count) * channels * sizeof(f32));
+
+			if (!isDecodeDone.load(memory_order_acquire)) underruns.fetch_add(1, memory_order_relaxed);
+		}
+
+		if (count > 0)
+		{
+			readFrame.store(read + count, memory_order_release);
+
+			wakeSignal.fetch_add(1, memory_order_release);
+			wakeSignal.notify_one();
+		}
+
+		return count;
+	}
+
+	bool AudioStream::HasFinished() const
+	{
+		return isDecodeDone.load(memory_order_acquire)
+			&& readFrame.load(memory_order_acquire) == writeFrame.load(memory_order_acquire);
+	}
+
+	size_t AudioStream::GetBufferedFrames() const
+	{
+		return scast<size_t>(writeFrame.load(memory_order_acquire) - readFrame.load(memory_order_acquire));
+	}
+
+	void AudioStream::DecodeLoop(stop_token stop)
+	{
+		const u8 channels = decoder.GetInfo().channels;
+
+		while (!stop.stop_requested())
+		{
+			//read the signal before checking for space, any Read after this point changes it
+			u32 signal = wakeSignal.load(memory_order_acquire);
+
+			u64 write = writeFrame.load(memory_order_relaxed);
+			u64 read = readFrame.load(memory_order_acquire);
+
+			size_t space = ringFrames - scast<size_t>(write - read);
+			if (space < STREAM_CHUNK_FRAMES)
+			{
+				wakeSignal.wait(signal, memory_order_acquire);
+				continue;
+			}
+
+			//decode straight into the ring, never across the wrap-around
+			size_t start = scast<size_t>(write % ringFrames);
+			size_t count = min(scast<size_t>(STREAM_CHUNK_FRAMES), ringFrames - start);
+
+			size_t decoded{};
+			string result = decoder.ReadFrames(
+				ring.data() + start * channels,
+				count,
+				decoded);
+
+			if (!result.empty())
+			{
+				decodeError = result;
+				break;
+			}
+
+			if (decoded > 0) writeFrame.store(write + decoded, memory_order_release);
+
+			if (decoded < count)
+			{
+				//an empty source would otherwise loop forever
+				if (!isLooping
+					|| (decoded == 0 && write == 0))
+				{
+					break;
+				}
+
+				decoder.Rewind();
+			}
+		}
+
+		isDecodeDone.store(true, memory_order_release);
+	}
+}
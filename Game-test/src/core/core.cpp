@@ -5,6 +5,7 @@
 
 #include <iostream>
 #include <string>
+#include <filesystem>
 
 #include "KalaHeaders/log_utils.hpp"
 
@@ -20,6 +21,10 @@
 
 #include "core/core.hpp"
 #include "core/input.hpp"
+#include "core/input_queue.hpp"
+#include "core/asset_pack.hpp"
+#include "core/audio_cache.hpp"
+#include "core/resource_manager.hpp"
 #include "graphics/render.hpp"
 #include "graphics/opengl_texture.hpp"
 #include "gameobject/camera.hpp"
@@ -38,6 +43,10 @@ using KalaPhysics::Core::KalaPhysicsCore;
 
 using KalaAudio::Core::KalaAudioCore;
 
+using GameTest::Core::AssetPack;
+using GameTest::Core::AudioCache;
+using GameTest::Core::InputQueue;
+using GameTest::Core::ResourceManager;
 using GameTest::Graphics::Render;
 using GameTest::Graphics::OpenGL_Texture;
 using GameTest::GameObject::Camera;
@@ -46,6 +55,9 @@ using GameTest::GameObject::OpenGL_PointLight;
 
 using std::cin;
 using std::string;
+using std::filesystem::path;
+using std::filesystem::current_path;
+using std::filesystem::exists;
 
 namespace GameTest::Core
 {
@@ -60,6 +72,23 @@ namespace GameTest::Core
 		
 		KalaWindowCore::SetUserShutdownFunction(Shutdown);
 		
+		//packed assets are preferred when present, loose files in 'files' are the fallback
+		path packPath = current_path() / "files.kpak";
+		if (exists(packPath)) AssetPack::Mount(packPath);
+		
+		//short sounds are decoded up front, long ones only keep their flac bytes for streaming
+		string audioResult = AudioCache::LoadDirectory(current_path() / "files" / "audio");
+		if (!audioResult.empty())
+		{
+			Log::Print(
+				audioResult,
+				"CORE",
+				LogType::LOG_ERROR,
+				2);
+		}
+		
+		ResourceManager::Initialize();
+
 		Render::Initialize();
 		
 		Update();
@@ -109,6 +138,13 @@ namespace GameTest::Core
 			"Shutting down game...",
 			"CORE",
 			LogType::LOG_INFO);
+
+		//the hook reads the main window input, so it goes before anything it points at
+		InputQueue::UnhookWindow();
+
+		//managed resources go first so their destroy callbacks still find their registries
+		Render::ReleaseResources();
+		ResourceManager::Shutdown();
 		
 		Camera::GetRegistry().RemoveAllContent();
 		OpenGL_Model::GetRegistry().RemoveAllContent();
@@ -116,6 +152,10 @@ namespace GameTest::Core
 
 		OpenGL_Texture::GetRegistry().RemoveAllContent();
 		
+		//streamed sounds may point into the mapped pack
+		AudioCache::Clear();
+		AssetPack::Unmount();
+		
 		KalaUICore::CleanAllResources();
 		KalaPhysicsCore::CleanAllResources();
 		KalaAudioCore::CleanAllResources();
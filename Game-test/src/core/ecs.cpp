@@ -0,0 +1,490 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+#include "KalaHeaders/core_utils.hpp"
+
+#include "core/kw_core.hpp"
+
+#include "core/ecs.hpp"
+
+using KalaWindow::Core::KalaWindowCore;
+
+using GameTest::Core::EcsComponents;
+using GameTest::Core::EcsComponentInfo;
+using GameTest::Core::EcsComponentID;
+using GameTest::Core::EcsMask;
+using GameTest::Core::EcsEntity;
+using GameTest::Core::EcsChunk;
+using GameTest::Core::EcsArchetype;
+using GameTest::Core::EcsChunkView;
+using GameTest::Core::EcsWorld;
+using GameTest::Core::ThreadPool;
+using GameTest::Core::ECS_MAX_COMPONENTS;
+using GameTest::Core::ECS_CHUNK_BYTES;
+using GameTest::Core::ECS_NO_COLUMN;
+
+using std::vector;
+using std::array;
+using std::unique_ptr;
+using std::make_unique;
+using std::mutex;
+using std::scoped_lock;
+using std::string;
+using std::to_string;
+using std::max;
+using std::memcpy;
+using std::memset;
+using std::move;
+
+static mutex componentMutex{};
+static vector<EcsComponentInfo> componentInfos{};
+
+static size_t AlignUp(
+	size_t value,
+	size_t alignment);
+
+namespace GameTest::Core
+{
+	//
+	// COMPONENTS
+	//
+
+	EcsComponentID EcsComponents::Register(
+		size_t size,
+		size_t alignment,
+		const char* name)
+	{
+		scoped_lock lock(componentMutex);
+
+		//GetInfo hands out references, so the table never reallocates
+		componentInfos.reserve(ECS_MAX_COMPONENTS);
+
+		if (componentInfos.size() >= ECS_MAX_COMPONENTS)
+		{
+			KalaWindowCore::ForceClose(
+				"ECS error",
+				"Cannot register component '" + string(name) + "' because there are already "
+				+ to_string(ECS_MAX_COMPONENTS) + " component types!");
+
+			return 0;
+		}
+
+		componentInfos.push_back({ size, alignment, name });
+
+		return scast<EcsComponentID>(componentInfos.size() - 1);
+	}
+
+	const EcsComponentInfo& EcsComponents::GetInfo(EcsComponentID id)
+	{
+		scoped_lock lock(componentMutex);
+		return componentInfos[id];
+	}
+
+	u32 EcsComponents::GetCount()
+	{
+		scoped_lock lock(componentMutex);
+		return scast<u32>(componentInfos.size());
+	}
+
+	//
+	// CHUNK VIEW
+	//
+
+	void* EcsChunkView::GetColumn(EcsComponentID id) const
+	{
+		u8 column = archetype->columnOf[id];
+		if (column == ECS_NO_COLUMN) return nullptr;
+
+		return chunk->data.get() + archetype->columnOffsets[column];
+	}
+
+	void EcsChunkView::MarkChanged(EcsComponentID id)
+	{
+		u8 column = archetype->columnOf[id];
+		if (column != ECS_NO_COLUMN) chunk->changedTicks[column] = tick;
+	}
+
+	//
+	// WORLD
+	//
+
+	EcsWorld::EcsWorld()
+	{
+		//entities without components live in archetype 0
+		GetOrCreateArchetype(0);
+	}
+
+	EcsEntity EcsWorld::Create() { return CreateWithMask(0); }
+
+	EcsEntity EcsWorld::CreateWithMask(EcsMask mask)
+	{
+		u32 index{};
+		if (!freeRecords.empty())
+		{
+			index = freeRecords.back();
+			freeRecords.pop_back();
+		}
+		else
+		{
+			index = scast<u32>(records.size());
+			records.push_back({});
+		}
+
+		//generation 0 marks an invalid handle, so a fresh record starts at 1
+		EntityRecord& record = records[index];
+		record.generation = max(record.generation, 1u);
+
+		EcsEntity entity{ index, record.generation };
+
+		AllocateRow(GetOrCreateArchetype(mask), entity);
+		++aliveCount;
+
+		return entity;
+	}
+
+	void EcsWorld::Destroy(EcsEntity entity)
+	{
+		if (!IsAlive(entity)) return;
+
+		EntityRecord& record = records[entity.index];
+
+		FreeRow(record.archetype, record.chunk, record.row);
+
+		++record.generation;
+		if (record.generation == 0) record.generation = 1;
+
+		freeRecords.push_back(entity.index);
+		--aliveCount;
+	}
+
+	bool EcsWorld::IsAlive(EcsEntity entity) const
+	{
+		return entity.IsValid()
+			&& entity.index < records.size()
+			&& records[entity.index].generation == entity.generation;
+	}
+
+	void* EcsWorld::GetComponent(
+		EcsEntity entity,
+		EcsComponentID id) const
+	{
+		if (!IsAlive(entity)) return nullptr;
+
+		const EntityRecord& record = records[entity.index];
+		const EcsArchetype& archetype = *archetypes[record.archetype];
+
+		u8 column = archetype.columnOf[id];
+		if (column == ECS_NO_COLUMN) return nullptr;
+
+		return archetype.chunks[record.chunk]->data.get()
+			+ archetype.columnOffsets[column]
+			+ record.row * archetype.columnSizes[column];
+	}
+
+	void* EcsWorld::AddComponent(
+		EcsEntity entity,
+		EcsComponentID id)
+	{
+		if (!IsAlive(entity)) return nullptr;
+
+		EcsMask bit = EcsMask{ 1 } << id;
+		EcsMask mask = archetypes[records[entity.index].archetype]->mask;
+
+		if ((mask & bit) == 0) MoveEntity(entity, mask | bit);
+		else MarkChanged(entity, id);
+
+		return GetComponent(entity, id);
+	}
+
+	void EcsWorld::RemoveComponent(
+		EcsEntity entity,
+		EcsComponentID id)
+	{
+		if (!IsAlive(entity)) return;
+
+		EcsMask bit = EcsMask{ 1 } << id;
+		EcsMask mask = archetypes[records[entity.index].archetype]->mask;
+
+		if ((mask & bit) != 0) MoveEntity(entity, mask & ~bit);
+	}
+
+	void EcsWorld::MarkChanged(
+		EcsEntity entity,
+		EcsComponentID id)
+	{
+		const EntityRecord& record = records[entity.index];
+		const EcsArchetype& archetype = *archetypes[record.archetype];
+
+		u8 column = archetype.columnOf[id];
+		if (column != ECS_NO_COLUMN) archetype.chunks[record.chunk]->changedTicks[column] = tick;
+	}
+
+	u32 EcsWorld::AdvanceTick()
+	{
+		u32 ended = tick++;
+
+		//0 is reserved for systems that never ran
+		if (tick == 0) tick = 1;
+
+		return ended;
+	}
+
+	void EcsWorld::Clear()
+	{
+		archetypes.clear();
+		archetypeLookup.clear();
+		records.clear();
+		freeRecords.clear();
+		aliveCount = 0;
+
+		GetOrCreateArchetype(0);
+	}
+
+	u32 EcsWorld::GetOrCreateArchetype(EcsMask mask)
+	{
+		auto it = archetypeLookup.find(mask);
+		if (it != archetypeLookup.end()) return it->second;
+
+		auto archetype = make_unique<EcsArchetype>();
+		archetype->mask = mask;
+		archetype->columnOf.fill(ECS_NO_COLUMN);
+
+		size_t rowBytes = sizeof(EcsEntity);
+		for (EcsComponentID id = 0; id < ECS_MAX_COMPONENTS; ++id)
+		{
+			if ((mask & (EcsMask{ 1 } << id)) == 0) continue;
+
+			archetype->components.push_back(id);
+			rowBytes += EcsComponents::GetInfo(id).size;
+		}
+
+		//small components get more rows per chunk, a huge one still gets one row
+		archetype->chunkCapacity = scast<u32>(max<size_t>(ECS_CHUNK_BYTES / rowBytes, 1));
+
+		//entity column first, then one column per component
+		size_t offset = sizeof(EcsEntity) * archetype->chunkCapacity;
+		for (size_t c = 0; c < archetype->components.size(); ++c)
+		{
+			const EcsComponentInfo& info = EcsComponents::GetInfo(archetype->components[c]);
+
+			offset = AlignUp(offset, info.alignment);
+
+			archetype->columnOf[archetype->components[c]] = scast<u8>(c);
+			archetype->columnOffsets.push_back(offset);
+			archetype->columnSizes.push_back(info.size);
+
+			offset += info.size * archetype->chunkCapacity;
+		}
+		archetype->chunkBytes = offset;
+
+		u32 index = scast<u32>(archetypes.size());
+		archetypes.push_back(move(archetype));
+		archetypeLookup.emplace(mask, index);
+
+		return index;
+	}
+
+	void EcsWorld::AllocateRow(
+		u32 archetypeIndex,
+		EcsEntity entity)
+	{
+		EcsArchetype& archetype = *archetypes[archetypeIndex];
+
+		if (archetype.chunks.empty()
+			|| archetype.chunks.back()->count == archetype.chunkCapacity)
+		{
+			auto chunk = make_unique<EcsChunk>();
+			chunk->data = make_unique<u8[]>(max<size_t>(archetype.chunkBytes, 1));
+			chunk->changedTicks.assign(archetype.components.size(), tick);
+
+			archetype.chunks.push_back(move(chunk));
+		}
+
+		EcsChunk& chunk = *archetype.chunks.back();
+
+		u32 row = chunk.count++;
+		reinterpret_cast<EcsEntity*>(chunk.data.get())[row] = entity;
+
+		//a new row counts as a change of every column
+		for (u32& changed : chunk.changedTicks) changed = tick;
+
+		EntityRecord& record = records[entity.index];
+		record.archetype = archetypeIndex;
+		record.chunk = scast<u32>(archetype.chunks.size() - 1);
+		record.row = row;
+	}
+
+	void EcsWorld::FreeRow(
+		u32 archetypeIndex,
+		u32 chunkIndex,
+		u32 row)
+	{
+		EcsArchetype& archetype = *archetypes[archetypeIndex];
+
+		u32 lastChunkIndex = scast<u32>(archetype.chunks.size() - 1);
+		EcsChunk& lastChunk = *archetype.chunks[lastChunkIndex];
+		u32 lastRow = lastChunk.count - 1;
+
+		if (chunkIndex != lastChunkIndex
+			|| row != lastRow)
+		{
+			EcsChunk& chunk = *archetype.chunks[chunkIndex];
+
+			EcsEntity* entities = reinterpret_cast<EcsEntity*>(chunk.data.get());
+			const EcsEntity* lastEntities = reinterpret_cast<const EcsEntity*>(lastChunk.data.get());
+
+			EcsEntity moved = lastEntities[lastRow];
+			entities[row] = moved;
+
+			for (size_t c = 0; c < archetype.components.size(); ++c)
+			{
+				size_t size = archetype.columnSizes[c];
+				size_t offset = archetype.columnOffsets[c];
+
+				memcpy(
+					chunk.data.get() + offset + row * size,
+					lastChunk.data.get() + offset + lastRow * size,
+					size);
+
+				chunk.changedTicks[c] = tick;
+			}
+
+			EntityRecord& record = records[moved.index];
+			record.chunk = chunkIndex;
+			record.row = row;
+		}
+
+		--lastChunk.count;
+		if (lastChunk.count == 0) archetype.chunks.pop_back();
+	}
+
+	void EcsWorld::MoveEntity(
+		EcsEntity entity,
+		EcsMask newMask)
+	{
+		EntityRecord oldRecord = records[entity.index];
+		u32 newIndex = GetOrCreateArchetype(newMask);
+
+		//the archetype vector may have grown, so both are looked up after creating the new one
+		const EcsArchetype& oldArchetype = *archetypes[oldRecord.archetype];
+		const EcsChunk& oldChunk = *oldArchetype.chunks[oldRecord.chunk];
+
+		AllocateRow(newIndex, entity);
+
+		const EcsArchetype& newArchetype = *archetypes[newIndex];
+		const EntityRecord& newRecord = records[entity.index];
+		EcsChunk& newChunk = *newArchetype.chunks[newRecord.chunk];
+
+		for (size_t c = 0; c < oldArchetype.components.size(); ++c)
+		{
+			EcsComponentID id = oldArchetype.components[c];
+
+			u8 newColumn = newArchetype.columnOf[id];
+			if (newColumn == ECS_NO_COLUMN) continue;
+
+			size_t size = oldArchetype.columnSizes[c];
+
+			memcpy(
+				newChunk.data.get() + newArchetype.columnOffsets[newColumn] + newRecord.row * size,
+				oldChunk.data.get() + oldArchetype.columnOffsets[c] + oldRecord.row * size,
+				size);
+		}
+
+		//components only the new archetype has start zeroed until the caller writes them
+		for (size_t c = 0; c < newArchetype.components.size(); ++c)
+		{
+			EcsComponentID id = newArchetype.components[c];
+			if (oldArchetype.columnOf[id] != ECS_NO_COLUMN) continue;
+
+			size_t size = newArchetype.columnSizes[c];
+			memset(
+				newChunk.data.get() + newArchetype.columnOffsets[c] + newRecord.row * size,
+				0,
+				size);
+		}
+
+		FreeRow(oldRecord.archetype, oldRecord.chunk, oldRecord.row);
+	}
+
+	void EcsWorld::RunQuery(
+		EcsMask include,
+		EcsMask exclude,
+		ThreadPool* workers,
+		const function<void(EcsChunkView&)>& func)
+	{
+		vector<EcsChunkView> views{};
+		size_t queryOffset{};
+
+		for (const auto& archetype : archetypes)
+		{
+			if ((archetype->mask & include) != include
+				|| (archetype->mask & exclude) != 0)
+			{
+				continue;
+			}
+
+			for (const auto& chunk : archetype->chunks)
+			{
+				EcsChunkView view{};
+				view.archetype = archetype.get();
+				view.chunk = chunk.get();
+				view.queryOffset = queryOffset;
+				view.tick = tick;
+
+				views.push_back(view);
+				queryOffset += chunk->count;
+			}
+		}
+
+		//every chunk is owned by one worker, so writes to its columns and change ticks never race
+		if (workers
+			&& views.size() > 1)
+		{
+			workers->ParallelFor(
+				views.size(),
+				[&views, &func](size_t i) { func(views[i]); });
+		}
+		else
+		{
+			for (EcsChunkView& view : views) func(view);
+		}
+	}
+
+	size_t EcsWorld::CountMatching(
+		EcsMask include,
+		EcsMask exclude) const
+	{
+		size_t count{};
+
+		for (const auto& archetype : archetypes)
+		{
+			if ((archetype->mask & include) != include
+				|| (archetype->mask & exclude) != 0)
+			{
+				continue;
+			}
+
+			for (const auto& chunk : archetype->chunks) count += chunk->count;
+		}
+
+		return count;
+	}
+}
+
+size_t AlignUp(
+	size_t value,
+	size_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
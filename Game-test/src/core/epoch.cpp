@@ -0,0 +1,139 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <algorithm>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/log_utils.hpp"
+
+#include "core/epoch.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using GameTest::Core::Epoch;
+using GameTest::Core::EPOCH_MAX_READERS;
+
+using std::array;
+using std::atomic;
+using std::to_string;
+using std::min;
+using std::this_thread::yield;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::memory_order_seq_cst;
+
+//epoch a slot has pinned, 0 while its thread is outside any read section
+constexpr u64 EPOCH_IDLE = 0;
+
+//one cache line per slot so readers never write to a line another reader owns
+struct alignas(64) ReaderSlot
+{
+	atomic<u64> epoch{};
+	atomic<bool> isClaimed{};
+};
+
+//Claims a slot the first time a thread reads and hands it back when the thread exits
+struct ThreadSlot
+{
+	ReaderSlot* slot{};
+	u32 depth{};
+
+	~ThreadSlot()
+	{
+		if (!slot) return;
+
+		slot->epoch.store(EPOCH_IDLE, memory_order_release);
+		slot->isClaimed.store(false, memory_order_release);
+	}
+};
+
+//starts at 1 so a pinned epoch is never mistaken for an idle slot
+static atomic<u64> globalEpoch{ 1 };
+static array<ReaderSlot, EPOCH_MAX_READERS> readerSlots{};
+
+static thread_local ThreadSlot threadSlot{};
+
+static ReaderSlot* ClaimSlot();
+
+namespace GameTest::Core
+{
+	void Epoch::EnterRead()
+	{
+		if (threadSlot.depth++ > 0) return;
+
+		if (!threadSlot.slot) threadSlot.slot = ClaimSlot();
+
+		//the pin has to be visible before any published pointer is loaded,
+		//seq_cst orders this store against the loads of the read section
+		threadSlot.slot->epoch.store(
+			globalEpoch.load(memory_order_seq_cst),
+			memory_order_seq_cst);
+	}
+
+	void Epoch::ExitRead()
+	{
+		if (threadSlot.depth == 0
+			|| --threadSlot.depth > 0)
+		{
+			return;
+		}
+
+		threadSlot.slot->epoch.store(EPOCH_IDLE, memory_order_release);
+	}
+
+	u64 Epoch::Advance()
+	{
+		return globalEpoch.fetch_add(1, memory_order_seq_cst);
+	}
+
+	u64 Epoch::GetOldestActive()
+	{
+		u64 oldest = globalEpoch.load(memory_order_seq_cst);
+
+		for (const ReaderSlot& slot : readerSlots)
+		{
+			u64 pinned = slot.epoch.load(memory_order_seq_cst);
+			if (pinned != EPOCH_IDLE) oldest = min(oldest, pinned);
+		}
+
+		return oldest;
+	}
+
+	u64 Epoch::GetCurrent() { return globalEpoch.load(memory_order_relaxed); }
+}
+
+ReaderSlot* ClaimSlot()
+{
+	static atomic<bool> hasWarnedFull{};
+
+	//slots only free up when their threads exit, so running out means too many reader threads
+	while (true)
+	{
+		for (ReaderSlot& slot : readerSlots)
+		{
+			bool expected = false;
+			if (!slot.isClaimed.load(memory_order_relaxed)
+				&& slot.isClaimed.compare_exchange_strong(expected, true))
+			{
+				return &slot;
+			}
+		}
+
+		if (!hasWarnedFull.exchange(true))
+		{
+			Log::Print(
+				"All " + to_string(EPOCH_MAX_READERS) + " epoch reader slots are taken, new readers wait for a thread to exit!",
+				"EPOCH",
+				LogType::LOG_WARNING);
+		}
+
+		yield();
+	}
+}
@@ -0,0 +1,632 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <bit>
+#include <cstring>
+#include <algorithm>
+
+#include "core/flac_decoder.hpp"
+
+using GameTest::Core::FlacDecoder;
+using GameTest::Core::FlacInfo;
+using GameTest::Core::FLAC_MAX_CHANNELS;
+
+using std::string;
+using std::vector;
+using std::to_string;
+using std::countl_zero;
+using std::min;
+
+//big-endian msb-first bit reader over a byte range,
+//reading past the end yields zeroes and reports an overrun
+struct BitReader
+{
+	const u8* data{};
+	size_t size{};
+	size_t bytePos{};
+
+	u64 cache{};
+	u32 cacheBits{};
+
+	void Refill()
+	{
+		while (cacheBits <= 56)
+		{
+			u64 byte = bytePos < size ? data[bytePos] : 0;
+
+			++bytePos;
+			cache |= byte << (56 - cacheBits);
+			cacheBits += 8;
+		}
+	}
+
+	//n must be in [0, 32]
+	u32 ReadBits(u32 n)
+	{
+		if (n == 0) return 0;
+		if (cacheBits < n) Refill();
+
+		u32 value = scast<u32>(cache >> (64 - n));
+		cache <<= n;
+		cacheBits -= n;
+		return value;
+	}
+
+	i32 ReadSigned(u32 n)
+	{
+		if (n == 0) return 0;
+
+		u32 value = ReadBits(n);
+		u32 shift = 32 - n;
+		return scast<i32>(value << shift) >> shift;
+	}
+
+	u32 ReadUnary()
+	{
+		u32 count = 0;
+		while (true)
+		{
+			if (cacheBits == 0) Refill();
+
+			//only the valid bits of the cache may be counted
+			u64 valid = cache | (cacheBits < 64 ? (~0ull >> cacheBits) : 0ull);
+			u32 zeroes = scast<u32>(countl_zero(valid));
+
+			if (zeroes < cacheBits)
+			{
+				count += zeroes;
+				cache <<= zeroes + 1;
+				cacheBits -= zeroes + 1;
+				return count;
+			}
+
+			count += cacheBits;
+			cache = 0;
+			cacheBits = 0;
+
+			if (IsOverrun()) return count;
+		}
+	}
+
+	i32 ReadRice(u32 param)
+	{
+		u32 msb = ReadUnary();
+		u32 value = (msb << param) | ReadBits(param);
+		return scast<i32>(value >> 1) ^ -scast<i32>(value & 1u);
+	}
+
+	void AlignToByte()
+	{
+		u32 drop = cacheBits % 8;
+		cache <<= drop;
+		cacheBits -= drop;
+	}
+
+	//byte offset of the next unread bit, only valid when byte aligned
+	size_t GetByteOffset() const { return bytePos - cacheBits / 8; }
+
+	//prefetched bytes past the end don't count, only consumed bits do
+	bool IsOverrun() const { return bytePos * 8 - cacheBits > size * 8; }
+};
+
+static const u32 BLOCK_SIZES[16] =
+{
+	0, 192, 576, 1152, 2304, 4608, 0, 0,
+	256, 512, 1024, 2048, 4096, 8192, 16384, 32768
+};
+static const u8 SAMPLE_SIZES[8] = { 0, 8, 12, 0, 16, 20, 24, 32 };
+
+enum class ChannelLayout : u8
+{
+	LAYOUT_INDEPENDENT,
+	LAYOUT_LEFT_SIDE,
+	LAYOUT_SIDE_RIGHT,
+	LAYOUT_MID_SIDE
+};
+
+static string DecodeSubframe(
+	BitReader& reader,
+	u32 blockSize,
+	u32 bitsPerSample,
+	i32* out);
+static string DecodeResidual(
+	BitReader& reader,
+	u32 blockSize,
+	u32 predictorOrder,
+	i32* out);
+static void RestoreFixed(
+	u32 order,
+	u32 blockSize,
+	i32* samples);
+static void RestoreLPC(
+	const i32* coefficients,
+	u32 order,
+	i32 shift,
+	u32 blockSize,
+	i32* samples);
+static u8 GetCRC8(
+	const u8* data,
+	size_t size);
+static u16 GetCRC16(
+	const u8* data,
+	size_t size);
+
+namespace GameTest::Core
+{
+	string FlacDecoder::Open(
+		const u8* inData,
+		size_t inSize)
+	{
+		data = nullptr;
+		size = 0;
+		info = {};
+
+		if (!inData
+			|| inSize < 42
+			|| memcmp(inData, "fLaC", 4) != 0)
+		{
+			return "Data is not a FLAC stream!";
+		}
+
+		size_t offset = 4;
+		bool hasStreamInfo{};
+		bool isLast{};
+
+		while (!isLast)
+		{
+			if (offset + 4 > inSize) return "FLAC metadata is truncated!";
+
+			u8 blockHeader = inData[offset];
+			isLast = (blockHeader & 0x80u) != 0;
+			u8 blockType = blockHeader & 0x7Fu;
+			u32 blockLength =
+				(scast<u32>(inData[offset + 1]) << 16)
+				| (scast<u32>(inData[offset + 2]) << 8)
+				| inData[offset + 3];
+
+			offset += 4;
+			if (offset + blockLength > inSize) return "FLAC metadata is truncated!";
+
+			//only STREAMINFO matters for playback, tags and pictures are skipped
+			if (blockType == 0)
+			{
+				if (blockLength < 34) return "FLAC STREAMINFO block is too small!";
+
+				BitReader r{};
+				r.data = inData + offset;
+				r.size = blockLength;
+
+				r.ReadBits(16); //min block size
+				info.maxBlockSize = scast<u16>(r.ReadBits(16));
+				r.ReadBits(24); //min frame size
+				r.ReadBits(24); //max frame size
+				info.sampleRate = r.ReadBits(20);
+				info.channels = scast<u8>(r.ReadBits(3) + 1);
+				info.bitsPerSample = scast<u8>(r.ReadBits(5) + 1);
+				info.totalFrames = (scast<u64>(r.ReadBits(4)) << 32) | r.ReadBits(32);
+				memcpy(info.md5, inData + offset + 18, 16);
+
+				hasStreamInfo = true;
+			}
+
+			offset += blockLength;
+		}
+
+		if (!hasStreamInfo) return "FLAC stream has no STREAMINFO block!";
+		if (info.sampleRate == 0) return "FLAC stream has an invalid sample rate!";
+		if (info.bitsPerSample < 4
+			|| info.bitsPerSample > 32)
+		{
+			return "FLAC stream has an unsupported bit depth of " + to_string(info.bitsPerSample) + "!";
+		}
+
+		data = inData;
+		size = inSize;
+		firstFrameOffset = offset;
+
+		u32 reserve = info.maxBlockSize != 0 ? info.maxBlockSize : 4608u;
+		for (u8 c = 0; c < info.channels; ++c) blockSamples[c].resize(reserve);
+
+		Rewind();
+
+		return{};
+	}
+
+	string FlacDecoder::ReadFrames(
+		f32* outSamples,
+		size_t frameCount,
+		size_t& outFramesRead)
+	{
+		outFramesRead = 0;
+		if (!data) return "FLAC decoder is not open!";
+
+		const u8 channels = info.channels;
+		const f32 scale = 1.0f / scast<f32>(1ull << (info.bitsPerSample - 1));
+
+		while (outFramesRead < frameCount)
+		{
+			if (blockCursor == blockSize)
+			{
+				if (IsAtEnd()) break;
+
+				string result = DecodeBlock();
+				if (!result.empty()) return result;
+			}
+
+			u32 count = scast<u32>(min(
+				scast<size_t>(blockSize - blockCursor),
+				frameCount - outFramesRead));
+
+			f32* out = outSamples + outFramesRead * channels;
+
+			for (u8 c = 0; c < channels; ++c)
+			{
+				const i32* in = blockSamples[c].data() + blockCursor;
+				for (u32 i = 0; i < count; ++i)
+				{
+					out[i * channels + c] = scast<f32>(in[i]) * scale;
+				}
+			}
+
+			blockCursor += count;
+			outFramesRead += count;
+		}
+
+		return{};
+	}
+
+	void FlacDecoder::Rewind()
+	{
+		readOffset = firstFrameOffset;
+		blockSize = 0;
+		blockCursor = 0;
+	}
+
+	bool FlacDecoder::IsAtEnd() const
+	{
+		//the smallest possible frame header plus footer
+		return readOffset + 8 > size;
+	}
+
+	string FlacDecoder::DecodeBlock()
+	{
+		BitReader r{};
+		r.data = data + readOffset;
+		r.size = size - readOffset;
+
+		//
+		// FRAME HEADER
+		//
+
+		if (r.ReadBits(14) != 0x3FFEu) return "FLAC frame sync code was not found!";
+		r.ReadBits(1); //reserved
+		r.ReadBits(1); //blocking strategy
+
+		u32 blockSizeCode = r.ReadBits(4);
+		u32 sampleRateCode = r.ReadBits(4);
+		u32 channelCode = r.ReadBits(4);
+		u32 sampleSizeCode = r.ReadBits(3);
+		r.ReadBits(1); //reserved
+
+		//utf-8 style coded frame or sample number, only skipped.
+		//the sample rate always comes from STREAMINFO
+		u32 first = r.ReadBits(8);
+		u32 extraBytes = 0;
+		while (extraBytes < 7
+			&& (first & (0x80u >> extraBytes)))
+		{
+			++extraBytes;
+		}
+		if (extraBytes == 1) return "FLAC frame number is malformed!";
+		for (u32 i = 1; i < extraBytes; ++i) r.ReadBits(8);
+
+		u32 newBlockSize = BLOCK_SIZES[blockSizeCode];
+		if (blockSizeCode == 6) newBlockSize = r.ReadBits(8) + 1;
+		else if (blockSizeCode == 7) newBlockSize = r.ReadBits(16) + 1;
+		if (newBlockSize == 0) return "FLAC frame has a reserved block size!";
+
+		if (sampleRateCode == 12) r.ReadBits(8);
+		else if (sampleRateCode == 13
+			|| sampleRateCode == 14)
+		{
+			r.ReadBits(16);
+		}
+		else if (sampleRateCode == 15) return "FLAC frame has an invalid sample rate!";
+
+		u32 bitsPerSample = sampleSizeCode == 0
+			? info.bitsPerSample
+			: SAMPLE_SIZES[sampleSizeCode];
+		if (bitsPerSample == 0) return "FLAC frame has a reserved sample size!";
+
+		u32 channels{};
+		ChannelLayout layout = ChannelLayout::LAYOUT_INDEPENDENT;
+		if (channelCode < 8) channels = channelCode + 1;
+		else if (channelCode <= 10)
+		{
+			channels = 2;
+			layout = scast<ChannelLayout>(channelCode - 7);
+		}
+		else return "FLAC frame has a reserved channel assignment!";
+
+		if (channels != info.channels) return "FLAC frame channel count does not match STREAMINFO!";
+
+		size_t headerSize = r.GetByteOffset();
+		u8 headerCRC = scast<u8>(r.ReadBits(8));
+		if (headerCRC != GetCRC8(r.data, headerSize)) return "FLAC frame header CRC mismatch!";
+
+		//
+		// SUBFRAMES
+		//
+
+		for (u32 c = 0; c < channels; ++c)
+		{
+			if (blockSamples[c].size() < newBlockSize) blockSamples[c].resize(newBlockSize);
+		}
+
+		for (u32 c = 0; c < channels; ++c)
+		{
+			//the side channel carries one extra bit
+			u32 channelBits = bitsPerSample;
+			if ((layout == ChannelLayout::LAYOUT_LEFT_SIDE && c == 1)
+				|| (layout == ChannelLayout::LAYOUT_SIDE_RIGHT && c == 0)
+				|| (layout == ChannelLayout::LAYOUT_MID_SIDE && c == 1))
+			{
+				++channelBits;
+			}
+
+			string result = DecodeSubframe(
+				r,
+				newBlockSize,
+				channelBits,
+				blockSamples[c].data());
+
+			if (!result.empty()) return result;
+		}
+
+		if (r.IsOverrun()) return "FLAC frame is truncated!";
+
+		//
+		// STEREO DECORRELATION
+		//
+
+		i32* left = blockSamples[0].data();
+		i32* right = channels > 1 ? blockSamples[1].data() : nullptr;
+
+		switch (layout)
+		{
+		case ChannelLayout::LAYOUT_INDEPENDENT:
+			break;
+		case ChannelLayout::LAYOUT_LEFT_SIDE:
+			for (u32 i = 0; i < newBlockSize; ++i) right[i] = left[i] - right[i];
+			break;
+		case ChannelLayout::LAYOUT_SIDE_RIGHT:
+			for (u32 i = 0; i < newBlockSize; ++i) left[i] += right[i];
+			break;
+		case ChannelLayout::LAYOUT_MID_SIDE:
+			for (u32 i = 0; i < newBlockSize; ++i)
+			{
+				i32 side = right[i];
+				i32 mid = scast<i32>(scast<u32>(left[i]) << 1) | (side & 1);
+				left[i] = (mid + side) >> 1;
+				right[i] = (mid - side) >> 1;
+			}
+			break;
+		}
+
+		//
+		// FRAME FOOTER
+		//
+
+		r.AlignToByte();
+		size_t frameSize = r.GetByteOffset();
+		u16 frameCRC = scast<u16>(r.ReadBits(16));
+		if (frameCRC != GetCRC16(r.data, frameSize)) return "FLAC frame CRC mismatch!";
+
+		readOffset += frameSize + 2;
+		blockSize = newBlockSize;
+		blockCursor = 0;
+
+		return{};
+	}
+}
+
+string DecodeSubframe(
+	BitReader& r,
+	u32 blockSize,
+	u32 bitsPerSample,
+	i32* out)
+{
+	if (r.ReadBits(1) != 0) return "FLAC subframe padding bit is set!";
+
+	u32 type = r.ReadBits(6);
+
+	//wasted bits are trailing zero bits shared by every sample in the subframe
+	u32 wasted = 0;
+	if (r.ReadBits(1)) wasted = r.ReadUnary() + 1;
+	if (wasted >= bitsPerSample) return "FLAC subframe has too many wasted bits!";
+
+	u32 bits = bitsPerSample - wasted;
+
+	if (type == 0)
+	{
+		i32 value = r.ReadSigned(bits);
+		for (u32 i = 0; i < blockSize; ++i) out[i] = value;
+	}
+	else if (type == 1)
+	{
+		for (u32 i = 0; i < blockSize; ++i) out[i] = r.ReadSigned(bits);
+	}
+	else if (type >= 8
+		&& type <= 12)
+	{
+		u32 order = type & 7u;
+		if (order > blockSize) return "FLAC fixed predictor order exceeds block size!";
+
+		for (u32 i = 0; i < order; ++i) out[i] = r.ReadSigned(bits);
+
+		string result = DecodeResidual(r, blockSize, order, out + order);
+		if (!result.empty()) return result;
+
+		RestoreFixed(order, blockSize, out);
+	}
+	else if (type >= 32)
+	{
+		u32 order = (type & 31u) + 1;
+		if (order > blockSize) return "FLAC LPC order exceeds block size!";
+
+		for (u32 i = 0; i < order; ++i) out[i] = r.ReadSigned(bits);
+
+		u32 precision = r.ReadBits(4) + 1;
+		if (precision == 16) return "FLAC LPC precision is invalid!";
+
+		i32 shift = r.ReadSigned(5);
+		if (shift < 0) return "FLAC LPC shift is negative!";
+
+		i32 coefficients[32]{};
+		for (u32 i = 0; i < order; ++i) coefficients[i] = r.ReadSigned(precision);
+
+		string result = DecodeResidual(r, blockSize, order, out + order);
+		if (!result.empty()) return result;
+
+		RestoreLPC(coefficients, order, shift, blockSize, out);
+	}
+	else return "FLAC subframe has a reserved type " + to_string(type) + "!";
+
+	if (wasted > 0)
+	{
+		for (u32 i = 0; i < blockSize; ++i) out[i] = scast<i32>(scast<u32>(out[i]) << wasted);
+	}
+
+	return{};
+}
+
+string DecodeResidual(
+	BitReader& r,
+	u32 blockSize,
+	u32 predictorOrder,
+	i32* out)
+{
+	u32 method = r.ReadBits(2);
+	if (method > 1) return "FLAC residual uses a reserved coding method!";
+
+	u32 paramBits = method == 0 ? 4u : 5u;
+	u32 escapeParam = method == 0 ? 15u : 31u;
+
+	u32 partitionOrder = r.ReadBits(4);
+	u32 partitions = 1u << partitionOrder;
+	u32 partitionSize = blockSize >> partitionOrder;
+
+	if (partitionSize < predictorOrder
+		|| (partitionSize << partitionOrder) != blockSize)
+	{
+		return "FLAC residual partition order is invalid!";
+	}
+
+	for (u32 p = 0; p < partitions; ++p)
+	{
+		u32 count = p == 0 ? partitionSize - predictorOrder : partitionSize;
+		u32 param = r.ReadBits(paramBits);
+
+		if (param == escapeParam)
+		{
+			u32 rawBits = r.ReadBits(5);
+			for (u32 i = 0; i < count; ++i) out[i] = r.ReadSigned(rawBits);
+		}
+		else
+		{
+			for (u32 i = 0; i < count; ++i) out[i] = r.ReadRice(param);
+		}
+
+		out += count;
+
+		if (r.IsOverrun()) return "FLAC residual is truncated!";
+	}
+
+	return{};
+}
+
+void RestoreFixed(
+	u32 order,
+	u32 blockSize,
+	i32* s)
+{
+	//residuals sit after the warm-up samples, add the prediction on top of them in place
+	switch (order)
+	{
+	case 0:
+		break;
+	case 1:
+		for (u32 i = 1; i < blockSize; ++i) s[i] += s[i - 1];
+		break;
+	case 2:
+		for (u32 i = 2; i < blockSize; ++i) s[i] += 2 * s[i - 1] - s[i - 2];
+		break;
+	case 3:
+		for (u32 i = 3; i < blockSize; ++i) s[i] += 3 * s[i - 1] - 3 * s[i - 2] + s[i - 3];
+		break;
+	case 4:
+		for (u32 i = 4; i < blockSize; ++i) s[i] += 4 * s[i - 1] - 6 * s[i - 2] + 4 * s[i - 3] - s[i - 4];
+		break;
+	}
+}
+
+void RestoreLPC(
+	const i32* c,
+	u32 order,
+	i32 shift,
+	u32 blockSize,
+	i32* s)
+{
+	//24-bit sources overflow a 32-bit accumulator, so always sum in 64 bits
+	for (u32 i = order; i < blockSize; ++i)
+	{
+		i64 sum = 0;
+		const i32* history = s + i;
+		for (u32 j = 0; j < order; ++j) sum += scast<i64>(c[j]) * history[-1 - scast<i32>(j)];
+
+		s[i] += scast<i32>(sum >> shift);
+	}
+}
+
+u8 GetCRC8(
+	const u8* data,
+	size_t size)
+{
+	//polynomial x^8 + x^2 + x + 1
+	u8 crc = 0;
+	for (size_t i = 0; i < size; ++i)
+	{
+		crc ^= data[i];
+		for (u32 b = 0; b < 8; ++b) crc = scast<u8>(crc & 0x80u ? (crc << 1) ^ 0x07u : crc << 1);
+	}
+	return crc;
+}
+
+u16 GetCRC16(
+	const u8* data,
+	size_t size)
+{
+	//polynomial x^16 + x^15 + x^2 + 1, table built on first use
+	static const auto table = []()
+		{
+			struct { u16 values[256]; } t{};
+			for (u32 i = 0; i < 256; ++i)
+			{
+				u16 crc = scast<u16>(i << 8);
+				for (u32 b = 0; b < 8; ++b) crc = scast<u16>(crc & 0x8000u ? (crc << 1) ^ 0x8005u : crc << 1);
+				t.values[i] = crc;
+			}
+			return t;
+		}();
+
+	u16 crc = 0;
+	for (size_t i = 0; i < size; ++i)
+	{
+		crc = scast<u16>((crc << 8) ^ table.values[(crc >> 8) ^ data[i]]);
+	}
+	return crc;
+}
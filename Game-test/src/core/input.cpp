@@ -5,6 +5,8 @@
 
 #include <string>
 #include <array>
+#include <algorithm>
+#include <filesystem>
 
 #include "KalaHeaders/log_utils.hpp"
 #include "KalaHeaders/math_utils.hpp"
@@ -15,11 +17,15 @@
 #include "graphics/kw_window.hpp"
 
 #include "core/input.hpp"
+#include "core/input_queue.hpp"
 #include "core/core.hpp"
 #include "graphics/render.hpp"
+#include "graphics/deferred_renderer.hpp"
+#include "graphics/frame_sync.hpp"
 #include "gameobject/camera.hpp"
 #include "gameobject/opengl_model.hpp"
 #include "gameobject/opengl_point_light.hpp"
+#include "gameobject/scene_snapshot.hpp"
 
 using KalaHeaders::KalaLog::Log;
 using KalaHeaders::KalaLog::LogType;
@@ -29,32 +35,58 @@ using KalaHeaders::KalaMath::vec3;
 using KalaHeaders::KalaMath::DIR_UP;
 
 using KalaHeaders::KalaKeyStandards::KeyboardButton;
-using KalaHeaders::KalaKeyStandards::MouseButton;
+using KalaHeaders::KalaKeyStandards::KeyToIndex;
+using KalaHeaders::KalaKeyStandards::keyboardButtons;
 
 using KalaWindow::Core::KalaWindowCore;
 using KalaWindow::Core::ShutdownState;
 using KalaWindow::Core::Input;
-using KalaWindow::Core::InputCode;
 using KalaWindow::Graphics::Window;
 
 using GameTest::GameObject::Camera;
 using GameTest::GameObject::OpenGL_Model;
 using GameTest::GameObject::OpenGL_PointLight;
+using GameTest::GameObject::SceneSnapshot;
 
 using GameTest::Core::GameTestInput;
+using GameTest::Core::InputQueue;
+using GameTest::Core::InputEvent;
+using GameTest::Core::InputEventType;
 using GameTest::Graphics::Render;
+using GameTest::Graphics::DeferredRenderer;
+using GameTest::Graphics::FrameSync;
 
 using std::to_string;
 using std::array;
+using std::max;
+using std::min;
+using std::string;
+using std::filesystem::path;
+using std::filesystem::current_path;
 
-constexpr array<InputCode, 2> quitCombo =
+constexpr array<KeyboardButton, 2> quitCombo =
 {
-	InputCode::FromKey(KeyboardButton::K_LEFT_CTRL),
-	InputCode::FromKey(KeyboardButton::K_SPACE)
+	KeyboardButton::K_LEFT_CTRL,
+	KeyboardButton::K_SPACE
 };
 
 static void TogglePause(bool pauseState);
 
+//saves or restores the scene next to the executable, outside of the files folder that builds replace
+static void SaveSceneSnapshot();
+static void LoadSceneSnapshot();
+
+static bool IsHeld(KeyboardButton k);
+//how long this key was held down between the previous and current update
+static f32 GetHeldSeconds(KeyboardButton k);
+
+//consumer-side key state rebuilt from the event queue
+static array<bool, keyboardButtons.size()> keyHeld{};
+static array<u64, keyboardButtons.size()> keyHeldSince{};
+static array<u64, keyboardButtons.size()> keyHeldTime{};
+
+static u64 lastUpdateTime{};
+
 namespace GameTest::Core
 {
 	static bool isPaused = true;
@@ -67,66 +99,132 @@ namespace GameTest::Core
 		
 		Camera* c = Render::GetCameras()[0];
 
-		if (i->IsComboPressed(quitCombo)) KalaWindowCore::Shutdown(ShutdownState::SHUTDOWN_CLEAN);
-		
-		if (i->IsKeyPressed(KeyboardButton::K_ESC)) TogglePause(!isPaused);
+		u64 now = InputQueue::Now();
+		u64 from = lastUpdateTime == 0 ? now : lastUpdateTime;
+		lastUpdateTime = now;
+
+		keyHeldTime.fill(0);
+
+		vec2 mouseDelta{};
+
+		//events are consumed in the order they were sampled so that
+		//press, release and movement inside one frame keep their timing
+
+		InputEvent e{};
+		while (InputQueue::Pop(e))
+		{
+			u64 time = min(max(e.timestamp, from), now);
+
+			switch (e.type)
+			{
+			case InputEventType::EVENT_KEY_DOWN:
+			{
+				size_t index = KeyToIndex(scast<KeyboardButton>(e.code));
+				if (index >= keyHeld.size()
+					|| keyHeld[index])
+				{
+					break;
+				}
+
+				keyHeld[index] = true;
+				keyHeldSince[index] = time;
+
+				bool quit = true;
+				for (KeyboardButton k : quitCombo)
+				{
+					if (!IsHeld(k)) quit = false;
+				}
+				if (quit) KalaWindowCore::Shutdown(ShutdownState::SHUTDOWN_CLEAN);
+
+				if (scast<KeyboardButton>(e.code) == KeyboardButton::K_ESC) TogglePause(!isPaused);
+
+				//switch between forward and deferred lighting, frame timing reports show the cost of each
+				if (scast<KeyboardButton>(e.code) == KeyboardButton::K_F2) DeferredRenderer::SetEnabled(!DeferredRenderer::IsEnabled());
+				if (scast<KeyboardButton>(e.code) == KeyboardButton::K_F3) FrameSync::SetReportState(!FrameSync::IsReportEnabled());
+
+				if (scast<KeyboardButton>(e.code) == KeyboardButton::K_F5) SaveSceneSnapshot();
+				if (scast<KeyboardButton>(e.code) == KeyboardButton::K_F9) LoadSceneSnapshot();
+
+				break;
+			}
+			case InputEventType::EVENT_KEY_UP:
+			{
+				size_t index = KeyToIndex(scast<KeyboardButton>(e.code));
+				if (index >= keyHeld.size()
+					|| !keyHeld[index])
+				{
+					break;
+				}
+
+				keyHeld[index] = false;
+				keyHeldTime[index] += time - keyHeldSince[index];
+
+				break;
+			}
+			case InputEventType::EVENT_MOUSE_MOVE:
+				mouseDelta += e.delta;
+				break;
+			default:
+				break;
+			}
+		}
+
+		//keys still down count until now and continue from now next update
+		for (size_t k = 0; k < keyHeld.size(); ++k)
+		{
+			if (!keyHeld[k]) continue;
+
+			keyHeldTime[k] += now - keyHeldSince[k];
+			keyHeldSince[k] = now;
+		}
 		
 		if (!isPaused
 			&& canMove)
 		{
-			f32 deltaTime = static_cast<f32>(KalaWindowCore::GetDeltaTime());
-			
 			if (c)
 			{
 				//camera rotation
 				
-				static vec2 lastMouseDelta{};
-				vec2 mouseDelta = i->GetRawMouseDelta();
-				if (mouseDelta != lastMouseDelta)
-				{
-					lastMouseDelta = mouseDelta;
-					c->UpdateCameraRotation(mouseDelta);
-				}
+				if (mouseDelta != vec2(0.0f)) c->UpdateCameraRotation(mouseDelta);
 				
 				//camera position
 				
 				const vec3& front = c->GetFront();
 				const vec3& right = c->GetRight();
-				const vec3& up = c->GetUp();
 				
-				f32 velocity = c->GetSpeed() * deltaTime;
+				f32 speed = c->GetSpeed();
 				f32 moveSpeed = c->GetSpeed(); //placeholder for future sprint
 				
 				vec3 pos = c->GetPos();
 				
-				if (i->IsKeyHeld(KeyboardButton::K_Q)) pos -= DIR_UP * velocity * moveSpeed;
-				if (i->IsKeyHeld(KeyboardButton::K_E)) pos += DIR_UP * velocity * moveSpeed;
+				pos -= DIR_UP * speed * GetHeldSeconds(KeyboardButton::K_Q) * moveSpeed;
+				pos += DIR_UP * speed * GetHeldSeconds(KeyboardButton::K_E) * moveSpeed;
 				
-				if (i->IsKeyHeld(KeyboardButton::K_W)) pos += front * velocity * moveSpeed;
-				if (i->IsKeyHeld(KeyboardButton::K_S)) pos -= front * velocity * moveSpeed;
-				if (i->IsKeyHeld(KeyboardButton::K_A)) pos -= right * velocity * moveSpeed;
-				if (i->IsKeyHeld(KeyboardButton::K_D)) pos += right * velocity * moveSpeed;
+				pos += front * speed * GetHeldSeconds(KeyboardButton::K_W) * moveSpeed;
+				pos -= front * speed * GetHeldSeconds(KeyboardButton::K_S) * moveSpeed;
+				pos -= right * speed * GetHeldSeconds(KeyboardButton::K_A) * moveSpeed;
+				pos += right * speed * GetHeldSeconds(KeyboardButton::K_D) * moveSpeed;
 				
 				c->SetPos(pos);
 			}
-			
+
 			/*
 			if (Render::models.size() > 0
 				&& Render::models[0])
 			{
 				OpenGL_Model* m = Render::models[0];
 				
-				if (i->IsKeyHeld(KeyboardButton::K_ARROW_LEFT)) 
+				if (IsHeld(KeyboardButton::K_ARROW_LEFT)) 
 				{
 					f32 opacity = m->GetOpacity();
-					opacity -= 0.5f * deltaTime;
+					opacity -= 0.5f * GetHeldSeconds(KeyboardButton::K_ARROW_LEFT);
 					
 					m->SetOpacity(opacity);
 				}
-				if (i->IsKeyHeld(KeyboardButton::K_ARROW_RIGHT))
+				if (IsHeld(KeyboardButton::K_ARROW_RIGHT))
 				{
 					f32 opacity = m->GetOpacity();
-					opacity += 0.5f * deltaTime;
+					opacity += 0.5f * GetHeldSeconds(KeyboardButton::K_ARROW_RIGHT);
 					
 					m->SetOpacity(opacity);
 				}
@@ -140,38 +238,38 @@ namespace GameTest::Core
 			{
 				OpenGL_PointLight* pl = pls[0];
 				
-				if (i->IsKeyHeld(KeyboardButton::K_ARROW_LEFT))
+				if (IsHeld(KeyboardButton::K_ARROW_LEFT))
 				{
 					f32 intensity = pl->GetIntensity();
-					intensity -= 0.5f * deltaTime;
+					intensity -= 0.5f * GetHeldSeconds(KeyboardButton::K_ARROW_LEFT);
 					
 					pl->SetIntensity(intensity);
 					
 					Log::Print("intensity: " + to_string(pl->GetIntensity()));
 				}
-				if (i->IsKeyHeld(KeyboardButton::K_ARROW_RIGHT))
+				if (IsHeld(KeyboardButton::K_ARROW_RIGHT))
 				{
 					f32 intensity = pl->GetIntensity();
-					intensity += 0.5f * deltaTime;
+					intensity += 0.5f * GetHeldSeconds(KeyboardButton::K_ARROW_RIGHT);
 					
 					pl->SetIntensity(intensity);
 					
 					Log::Print("intensity: " + to_string(pl->GetIntensity()));
 				}
 				
-				if (i->IsKeyHeld(KeyboardButton::K_ARROW_UP))
+				if (IsHeld(KeyboardButton::K_ARROW_UP))
 				{
 					f32 maxRange = pl->GetMaxRange();
-					maxRange += 0.5f * deltaTime;
+					maxRange += 0.5f * GetHeldSeconds(KeyboardButton::K_ARROW_UP);
 					
 					pl->SetMaxRange(maxRange);
 					
 					Log::Print("max range: " + to_string(pl->GetMaxRange()));
 				}
-				if (i->IsKeyHeld(KeyboardButton::K_ARROW_DOWN))
+				if (IsHeld(KeyboardButton::K_ARROW_DOWN))
 				{
 					f32 maxRange = pl->GetMaxRange();
-					maxRange -= 0.5f * deltaTime;
+					maxRange -= 0.5f * GetHeldSeconds(KeyboardButton::K_ARROW_DOWN);
 					
 					pl->SetMaxRange(maxRange);
 					
@@ -188,6 +286,20 @@ namespace GameTest::Core
 	bool GameTestInput::CanMove() { return canMove; }
 }
 
+bool IsHeld(KeyboardButton k)
+{
+	size_t index = KeyToIndex(k);
+	return index < keyHeld.size() && keyHeld[index];
+}
+
+f32 GetHeldSeconds(KeyboardButton k)
+{
+	size_t index = KeyToIndex(k);
+	if (index >= keyHeldTime.size()) return 0.0f;
+
+	return scast<f32>(scast<f64>(keyHeldTime[index]) / 1e9);
+}
+
 void TogglePause(bool pauseState)
 {
 	Input* i = Render::GetMainWindow().input;
@@ -216,4 +328,35 @@ void TogglePause(bool pauseState)
 			"INPUT",
 			LogType::LOG_DEBUG);
 	}
-}
\ No newline at end of file
+}
+
+void SaveSceneSnapshot()
+{
+	string result = SceneSnapshot::Save(current_path() / "scene.ksn");
+	if (!result.empty())
+	{
+		Log::Print(
+			result,
+			"INPUT",
+			LogType::LOG_ERROR,
+			2);
+	}
+}
+
+void LoadSceneSnapshot()
+{
+	string result = SceneSnapshot::Load(current_path() / "scene.ksn");
+	if (!result.empty())
+	{
+		Log::Print(
+			result,
+			"INPUT",
+			LogType::LOG_ERROR,
+			2);
+
+		return;
+	}
+
+	//restored transforms and static flags only reach the batches through a rebuild
+	Render::RequestStaticBatchRebuild();
+}
@@ -0,0 +1,316 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#ifdef _WIN32
+	#include <windows.h>
+#endif
+
+#include <array>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "KalaHeaders/key_standards.hpp"
+
+#include "core/kw_input.hpp"
+#include "graphics/kw_window.hpp"
+
+#include "core/input_queue.hpp"
+#include "graphics/render.hpp"
+
+using KalaHeaders::KalaKeyStandards::KeyboardButton;
+using KalaHeaders::KalaKeyStandards::MouseButton;
+using KalaHeaders::KalaMath::vec2;
+
+using KalaWindow::Core::Input;
+using KalaWindow::Graphics::Window;
+
+using GameTest::Core::InputQueue;
+using GameTest::Core::InputEvent;
+using GameTest::Core::InputEventType;
+using GameTest::Core::INPUT_QUEUE_SIZE;
+using GameTest::Graphics::Render;
+
+using std::array;
+using std::vector;
+using std::atomic;
+using std::find;
+using std::move;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+
+static_assert((INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) == 0,
+	"INPUT_QUEUE_SIZE must be a power of two");
+
+//head and tail live on their own cache lines so producer and consumer dont false share
+alignas(64) static atomic<u32> head{}; //next slot the producer writes
+alignas(64) static atomic<u32> tail{}; //next slot the consumer reads
+alignas(64) static atomic<u32> dropped{};
+
+static array<InputEvent, INPUT_QUEUE_SIZE> events{};
+
+//producer-side state as of the last pushed events, only touched by the pumping thread
+static vector<KeyboardButton> pushedKeys{};
+static vector<MouseButton> pushedButtons{};
+static vec2 pushedRawDelta{};
+static f32 pushedScroll{};
+
+#ifdef _WIN32
+static HWND hookedWindow{};
+static WNDPROC originalProc{};
+
+static LRESULT CALLBACK InputWindowProc(
+	HWND hwnd,
+	UINT msg,
+	WPARAM wParam,
+	LPARAM lParam);
+#endif
+
+//Keys down right now, pressed and released in the same frame counts as up
+static vector<KeyboardButton> GetDownKeys(Input* i);
+static vector<MouseButton> GetDownButtons(Input* i);
+
+//Pushes every change since the last call with one timestamp. Called after each
+//input message, so a single call normally sees one key or button change
+static void PushChanges(
+	Input* i,
+	u64 timestamp);
+
+template<typename T>
+static bool Contains(const vector<T>& values, T value)
+{
+	return find(values.begin(), values.end(), value) != values.end();
+}
+
+namespace GameTest::Core
+{
+	void InputQueue::HookWindow()
+	{
+#ifdef _WIN32
+		Window* w = Render::GetMainWindow().window;
+		if (!w
+			|| originalProc)
+		{
+			return;
+		}
+
+		HWND hwnd = rcast<HWND>(w->GetWindowData().hwnd);
+
+		originalProc = rcast<WNDPROC>(SetWindowLongPtrW(
+			hwnd,
+			GWLP_WNDPROC,
+			rcast<LONG_PTR>(InputWindowProc)));
+
+		if (originalProc) hookedWindow = hwnd;
+#endif
+	}
+
+	void InputQueue::UnhookWindow()
+	{
+#ifdef _WIN32
+		if (!originalProc) return;
+
+		//a destroyed window takes its procedure chain with it
+		if (IsWindow(hookedWindow))
+		{
+			WNDPROC current = rcast<WNDPROC>(GetWindowLongPtrW(
+				hookedWindow,
+				GWLP_WNDPROC));
+
+			if (current != InputWindowProc) return;
+
+			SetWindowLongPtrW(
+				hookedWindow,
+				GWLP_WNDPROC,
+				rcast<LONG_PTR>(originalProc));
+		}
+
+		hookedWindow = nullptr;
+		originalProc = nullptr;
+#endif
+	}
+
+	void InputQueue::Pump()
+	{
+		Input* i = Render::GetMainWindow().input;
+		if (!i) return;
+
+		//catches changes made outside of input messages, and all of them without the hook
+		PushChanges(i, Now());
+
+		//raw delta is consumed here and zeroed so that keep-delta mode
+		//cant replay the same movement on the next pump
+
+		if (i->GetRawMouseDelta() != vec2(0.0f)) i->SetRawMouseDelta(vec2(0.0f));
+		if (i->GetScrollwheelDelta() != 0.0f) i->SetScrollwheelDelta(0.0f);
+
+		pushedRawDelta = vec2(0.0f);
+		pushedScroll = 0.0f;
+
+		//per-frame input state no longer depends on whether anything was drawn,
+		//pushedKeys and pushedButtons carry the held state into the next frame
+		i->EndFrameUpdate();
+	}
+
+	bool InputQueue::Push(const InputEvent& e)
+	{
+		u32 h = head.load(memory_order_relaxed);
+		u32 t = tail.load(memory_order_acquire);
+
+		if (h - t == INPUT_QUEUE_SIZE)
+		{
+			dropped.fetch_add(1, memory_order_relaxed);
+			return false;
+		}
+
+		events[h & (INPUT_QUEUE_SIZE - 1)] = e;
+		head.store(h + 1, memory_order_release);
+
+		return true;
+	}
+
+	bool InputQueue::Pop(InputEvent& out)
+	{
+		u32 t = tail.load(memory_order_relaxed);
+		u32 h = head.load(memory_order_acquire);
+
+		if (t == h) return false;
+
+		out = events[t & (INPUT_QUEUE_SIZE - 1)];
+		tail.store(t + 1, memory_order_release);
+
+		return true;
+	}
+
+	u64 InputQueue::Now()
+	{
+		return scast<u64>(duration_cast<nanoseconds>(
+			steady_clock::now().time_since_epoch()).count());
+	}
+
+	u32 InputQueue::GetDroppedCount() { return dropped.load(memory_order_relaxed); }
+
+	void InputQueue::Clear()
+	{
+		tail.store(head.load(memory_order_acquire), memory_order_release);
+	}
+}
+
+#ifdef _WIN32
+LRESULT CALLBACK InputWindowProc(
+	HWND hwnd,
+	UINT msg,
+	WPARAM wParam,
+	LPARAM lParam)
+{
+	//stamped before the window reacts so the time is when the message was handled
+	u64 timestamp = InputQueue::Now();
+
+	LRESULT result = CallWindowProcW(
+		originalProc,
+		hwnd,
+		msg,
+		wParam,
+		lParam);
+
+	bool isInputMessage =
+		(msg >= WM_KEYFIRST && msg <= WM_KEYLAST)
+		|| (msg >= WM_MOUSEFIRST && msg <= WM_MOUSELAST)
+		|| msg == WM_INPUT
+		|| msg == WM_KILLFOCUS;
+
+	if (isInputMessage)
+	{
+		Input* i = Render::GetMainWindow().input;
+		if (i) PushChanges(i, timestamp);
+	}
+
+	return result;
+}
+#endif
+
+vector<KeyboardButton> GetDownKeys(Input* i)
+{
+	vector<KeyboardButton> held = i->GetHeldKeys();
+	vector<KeyboardButton> released = i->GetReleasedKeys();
+
+	for (KeyboardButton k : i->GetPressedKeys())
+	{
+		if (!Contains(held, k)
+			&& !Contains(released, k))
+		{
+			held.push_back(k);
+		}
+	}
+
+	return held;
+}
+
+vector<MouseButton> GetDownButtons(Input* i)
+{
+	vector<MouseButton> held = i->GetHeldMouseButtons();
+	vector<MouseButton> released = i->GetReleasedMouseButtons();
+
+	for (MouseButton m : i->GetPressedMouseButtons())
+	{
+		if (!Contains(held, m)
+			&& !Contains(released, m))
+		{
+			held.push_back(m);
+		}
+	}
+
+	return held;
+}
+
+void PushChanges(
+	Input* i,
+	u64 timestamp)
+{
+	vector<KeyboardButton> keys = GetDownKeys(i);
+	vector<MouseButton> buttons = GetDownButtons(i);
+
+	for (KeyboardButton k : pushedKeys)
+	{
+		if (!Contains(keys, k)) InputQueue::Push({ InputEventType::EVENT_KEY_UP, scast<u32>(k), {}, timestamp });
+	}
+	for (KeyboardButton k : keys)
+	{
+		if (!Contains(pushedKeys, k)) InputQueue::Push({ InputEventType::EVENT_KEY_DOWN, scast<u32>(k), {}, timestamp });
+	}
+
+	for (MouseButton m : pushedButtons)
+	{
+		if (!Contains(buttons, m)) InputQueue::Push({ InputEventType::EVENT_MOUSE_UP, scast<u32>(m), {}, timestamp });
+	}
+	for (MouseButton m : buttons)
+	{
+		if (!Contains(pushedButtons, m)) InputQueue::Push({ InputEventType::EVENT_MOUSE_DOWN, scast<u32>(m), {}, timestamp });
+	}
+
+	pushedKeys = move(keys);
+	pushedButtons = move(buttons);
+
+	//movement and scroll accumulate over the frame, only the part not pushed yet is new
+
+	vec2 rawDelta = i->GetRawMouseDelta();
+	if (rawDelta != pushedRawDelta)
+	{
+		InputQueue::Push({ InputEventType::EVENT_MOUSE_MOVE, 0, rawDelta - pushedRawDelta, timestamp });
+		pushedRawDelta = rawDelta;
+	}
+
+	f32 scroll = i->GetScrollwheelDelta();
+	if (scroll != pushedScroll)
+	{
+		InputQueue::Push({ InputEventType::EVENT_MOUSE_SCROLL, 0, vec2(0.0f, scroll - pushedScroll), timestamp });
+		pushedScroll = scroll;
+	}
+}
@@ -0,0 +1,137 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#include "KalaHeaders/core_utils.hpp"
+
+#include "core/mapped_file.hpp"
+
+using GameTest::Core::MappedFile;
+using GameTest::Core::FileMapping;
+
+using std::filesystem::path;
+using std::filesystem::exists;
+using std::filesystem::is_regular_file;
+
+namespace GameTest::Core
+{
+	bool FileMapping::Map(
+		const path& target,
+		MappedFile& outFile)
+	{
+		if (!exists(target)
+			|| !is_regular_file(target))
+		{
+			return false;
+		}
+
+		MappedFile file{};
+
+#ifdef _WIN32
+		file.file = CreateFileW(
+			target.wstring().c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+			nullptr);
+
+		if (file.file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file.file, &size)
+			|| size.QuadPart == 0)
+		{
+			CloseHandle(file.file);
+			return false;
+		}
+
+		file.mapping = CreateFileMappingW(
+			file.file,
+			nullptr,
+			PAGE_READONLY,
+			0,
+			0,
+			nullptr);
+
+		if (!file.mapping)
+		{
+			CloseHandle(file.file);
+			return false;
+		}
+
+		file.data = scast<const u8*>(MapViewOfFile(
+			file.mapping,
+			FILE_MAP_READ,
+			0,
+			0,
+			0));
+
+		if (!file.data)
+		{
+			CloseHandle(file.mapping);
+			CloseHandle(file.file);
+			return false;
+		}
+
+		file.size = scast<u64>(size.QuadPart);
+#else
+		file.fd = open(target.c_str(), O_RDONLY);
+		if (file.fd < 0) return false;
+
+		struct stat st{};
+		if (fstat(file.fd, &st) != 0
+			|| st.st_size == 0)
+		{
+			close(file.fd);
+			return false;
+		}
+
+		void* view = mmap(
+			nullptr,
+			scast<size_t>(st.st_size),
+			PROT_READ,
+			MAP_PRIVATE,
+			file.fd,
+			0);
+
+		if (view == MAP_FAILED)
+		{
+			close(file.fd);
+			return false;
+		}
+
+		file.data = scast<const u8*>(view);
+		file.size = scast<u64>(st.st_size);
+#endif
+
+		outFile = file;
+
+		return true;
+	}
+
+	void FileMapping::Unmap(MappedFile& file)
+	{
+#ifdef _WIN32
+		if (file.data) UnmapViewOfFile(file.data);
+		if (file.mapping) CloseHandle(file.mapping);
+		if (file.file != INVALID_HANDLE_VALUE) CloseHandle(file.file);
+#else
+		if (file.data) munmap(const_cast<u8*>(file.data), scast<size_t>(file.size));
+		if (file.fd >= 0) close(file.fd);
+#endif
+
+		file = {};
+	}
+}
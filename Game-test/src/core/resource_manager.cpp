@@ -0,0 +1,697 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <algorithm>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "core/resource_manager.hpp"
+#include "core/thread_pool.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using GameTest::Core::ResourceManager;
+using GameTest::Core::ResourceRef;
+using GameTest::Core::ResourceDesc;
+using GameTest::Core::ResourceState;
+using GameTest::Core::ThreadPool;
+using GameTest::Core::RESOURCE_FRAMES_IN_FLIGHT;
+using GameTest::Core::RESOURCE_FINALIZE_BUDGET;
+
+using std::string;
+using std::vector;
+using std::any;
+using std::unique_ptr;
+using std::make_unique;
+using std::atomic;
+using std::mutex;
+using std::lock_guard;
+using std::unordered_map;
+using std::move;
+using std::swap;
+using std::sort;
+using std::find;
+using std::find_if;
+using std::to_string;
+using std::this_thread::yield;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::memory_order_acq_rel;
+
+struct ResourceSlot
+{
+	string key{};
+	//read by GetSlot on any thread, only changed on the main thread
+	atomic<u32> generation{ 1 };
+
+	atomic<u32> refCount{};
+	atomic<ResourceState> state{ ResourceState::STATE_QUEUED };
+
+	//true while a worker owns data and error
+	atomic<bool> isWorkerBusy{};
+
+	//creation order, dependencies are always older than the resources that use them
+	u64 sequence{};
+
+	ResourceDesc desc{};
+	any data{};
+	void* object{};
+	string error{};
+
+	atomic<bool> isActive{};
+};
+
+struct PendingDestroy
+{
+	u32 index{};
+	u32 generation{};
+	u64 frame{};
+};
+
+//slot 0 is never used so a default handle is always invalid.
+//only the main thread adds or removes slots, slotsMutex guards that against GetSlot on other threads,
+//the slots themselves are heap allocated and never move
+static vector<unique_ptr<ResourceSlot>> slots{};
+static mutex slotsMutex{};
+static vector<u32> freeSlots{};
+static unordered_map<string, u32> keyToSlot{};
+
+static unique_ptr<ThreadPool> workers{};
+
+//filled by workers, drained by Update
+static mutex completedMutex{};
+static vector<u32> completed{};
+
+//last releases of handles from any thread, drained by Update
+static mutex releasedMutex{};
+static vector<PendingDestroy> released{};
+
+//main thread only
+static vector<u32> awaitingFinalize{};
+static vector<PendingDestroy> destroyQueue{};
+
+static u64 frameIndex{};
+static u64 nextSequence{};
+static atomic<bool> isInitialized{};
+
+static ResourceSlot* GetSlot(
+	u32 index,
+	u32 generation);
+static void AddRef(
+	u32 index,
+	u32 generation);
+static void Release(
+	u32 index,
+	u32 generation);
+
+static void QueueReleased();
+static bool FinalizeSlot(u32 index);
+static void DestroySlot(u32 index);
+
+namespace GameTest::Core
+{
+	//
+	// RESOURCE REF
+	//
+
+	ResourceRef::ResourceRef(
+		u32 newIndex,
+		u32 newGeneration)
+		: index(newIndex),
+		generation(newGeneration) {}
+
+	ResourceRef::~ResourceRef() { Reset(); }
+
+	ResourceRef::ResourceRef(const ResourceRef& other)
+		: index(other.index),
+		generation(other.generation)
+	{
+		AddRef(index, generation);
+	}
+
+	ResourceRef& ResourceRef::operator=(const ResourceRef& other)
+	{
+		if (this == &other) return *this;
+
+		AddRef(other.index, other.generation);
+		Reset();
+
+		index = other.index;
+		generation = other.generation;
+
+		return *this;
+	}
+
+	ResourceRef::ResourceRef(ResourceRef&& other) noexcept
+		: index(other.index),
+		generation(other.generation)
+	{
+		other.index = 0;
+		other.generation = 0;
+	}
+
+	ResourceRef& ResourceRef::operator=(ResourceRef&& other) noexcept
+	{
+		if (this == &other) return *this;
+
+		Reset();
+
+		index = other.index;
+		generation = other.generation;
+
+		other.index = 0;
+		other.generation = 0;
+
+		return *this;
+	}
+
+	bool ResourceRef::IsValid() const
+	{
+		return GetSlot(index, generation) != nullptr;
+	}
+
+	ResourceState ResourceRef::GetState() const
+	{
+		ResourceSlot* slot = GetSlot(index, generation);
+		return slot
+			? slot->state.load(memory_order_acquire)
+			: ResourceState::STATE_FAILED;
+	}
+
+	const string& ResourceRef::GetKey() const
+	{
+		static const string empty{};
+
+		ResourceSlot* slot = GetSlot(index, generation);
+		return slot ? slot->key : empty;
+	}
+
+	const string& ResourceRef::GetError() const
+	{
+		static const string invalid = "Invalid resource handle.";
+
+		ResourceSlot* slot = GetSlot(index, generation);
+		if (!slot) return invalid;
+
+		//error is owned by the worker until it is done
+		static const string empty{};
+		return slot->isWorkerBusy.load(memory_order_acquire)
+			? empty
+			: slot->error;
+	}
+
+	void* ResourceRef::GetObject() const
+	{
+		ResourceSlot* slot = GetSlot(index, generation);
+		if (!slot
+			|| slot->state.load(memory_order_acquire) != ResourceState::STATE_READY)
+		{
+			return nullptr;
+		}
+
+		return slot->object;
+	}
+
+	void ResourceRef::Reset()
+	{
+		if (index == 0) return;
+
+		Release(index, generation);
+
+		index = 0;
+		generation = 0;
+	}
+
+	//
+	// RESOURCE MANAGER
+	//
+
+	void ResourceManager::Initialize(u32 threadCount)
+	{
+		if (isInitialized) return;
+
+		workers = make_unique<ThreadPool>(threadCount);
+
+		{
+			lock_guard<mutex> lock(slotsMutex);
+			slots.clear();
+			slots.push_back(nullptr);
+		}
+
+		frameIndex = 0;
+		nextSequence = 0;
+		isInitialized = true;
+
+		Log::Print(
+			"Initialized resource manager with " + to_string(workers->GetThreadCount()) + " loader threads.",
+			"RESOURCE_MANAGER",
+			LogType::LOG_SUCCESS);
+	}
+
+	bool ResourceManager::IsInitialized() { return isInitialized; }
+
+	ResourceRef ResourceManager::Load(ResourceDesc desc)
+	{
+		if (!isInitialized)
+		{
+			Log::Print(
+				"Cannot load resource '" + desc.key + "' because the resource manager is not initialized!",
+				"RESOURCE_MANAGER",
+				LogType::LOG_ERROR,
+				2);
+
+			return{};
+		}
+
+		if (!desc.finalize)
+		{
+			Log::Print(
+				"Cannot load resource '" + desc.key + "' because it has no finalize stage!",
+				"RESOURCE_MANAGER",
+				LogType::LOG_ERROR,
+				2);
+
+			return{};
+		}
+
+		ResourceRef existing = Find(desc.key);
+		if (existing.IsValid()) return existing;
+
+		u32 index{};
+		if (!freeSlots.empty())
+		{
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			lock_guard<mutex> lock(slotsMutex);
+
+			index = scast<u32>(slots.size());
+			slots.push_back(make_unique<ResourceSlot>());
+		}
+
+		ResourceSlot* slot = slots[index].get();
+		slot->key = desc.key;
+		slot->sequence = nextSequence++;
+		slot->desc = move(desc);
+		slot->refCount.store(1, memory_order_relaxed);
+		//published last so other threads never see an active slot that is still being filled
+		slot->isActive.store(true, memory_order_release);
+
+		if (!slot->key.empty()) keyToSlot[slot->key] = index;
+
+		if (slot->desc.load)
+		{
+			slot->state.store(ResourceState::STATE_QUEUED, memory_order_release);
+			slot->isWorkerBusy.store(true, memory_order_release);
+
+			//slots are heap allocated, so the pointer stays valid while the vector grows
+			workers->Submit([slot, index]()
+				{
+					slot->state.store(ResourceState::STATE_LOADING, memory_order_release);
+					slot->error = slot->desc.load(slot->data);
+
+					{
+						lock_guard<mutex> lock(completedMutex);
+						completed.push_back(index);
+					}
+
+					slot->isWorkerBusy.store(false, memory_order_release);
+				});
+		}
+		else
+		{
+			slot->state.store(ResourceState::STATE_LOADING, memory_order_release);
+			awaitingFinalize.push_back(index);
+		}
+
+		return ResourceRef(index, slot->generation.load(memory_order_relaxed));
+	}
+
+	ResourceRef ResourceManager::Find(const string& key)
+	{
+		if (key.empty()) return{};
+
+		auto it = keyToSlot.find(key);
+		if (it == keyToSlot.end()) return{};
+
+		u32 generation = slots[it->second]->generation.load(memory_order_relaxed);
+		AddRef(it->second, generation);
+
+		return ResourceRef(it->second, generation);
+	}
+
+	void ResourceManager::Update()
+	{
+		if (!isInitialized) return;
+
+		++frameIndex;
+
+		{
+			lock_guard<mutex> lock(completedMutex);
+			awaitingFinalize.insert(
+				awaitingFinalize.end(),
+				completed.begin(),
+				completed.end());
+			completed.clear();
+		}
+
+		QueueReleased();
+
+		//finalize in load order, anything still waiting on a dependency stays queued
+		u32 finalized{};
+		vector<u32> waiting{};
+		for (u32 index : awaitingFinalize)
+		{
+			if (finalized >= RESOURCE_FINALIZE_BUDGET
+				|| !FinalizeSlot(index))
+			{
+				waiting.push_back(index);
+				continue;
+			}
+
+			++finalized;
+		}
+		awaitingFinalize = move(waiting);
+
+		//released resources wait until the gpu can no longer be reading them
+		vector<PendingDestroy> due{};
+		swap(due, destroyQueue);
+		for (const auto& pending : due)
+		{
+			ResourceSlot* slot = slots[pending.index].get();
+			if (slot->generation.load(memory_order_relaxed) != pending.generation) continue;
+
+			if (frameIndex < pending.frame + RESOURCE_FRAMES_IN_FLIGHT
+				|| slot->isWorkerBusy.load(memory_order_acquire))
+			{
+				destroyQueue.push_back(pending);
+				continue;
+			}
+
+			DestroySlot(pending.index);
+		}
+	}
+
+	void ResourceManager::WaitAll()
+	{
+		while (GetCount(ResourceState::STATE_QUEUED) > 0
+			|| GetCount(ResourceState::STATE_LOADING) > 0)
+		{
+			Update();
+			yield();
+		}
+	}
+
+	u32 ResourceManager::GetCount(ResourceState state)
+	{
+		u32 count{};
+		for (const auto& slot : slots)
+		{
+			if (slot
+				&& slot->isActive.load(memory_order_relaxed)
+				&& slot->state.load(memory_order_acquire) == state)
+			{
+				++count;
+			}
+		}
+
+		return count;
+	}
+
+	u32 ResourceManager::GetPendingDestroyCount()
+	{
+		lock_guard<mutex> lock(releasedMutex);
+		return scast<u32>(destroyQueue.size() + released.size());
+	}
+
+	u64 ResourceManager::GetFrameIndex() { return frameIndex; }
+
+	void ResourceManager::Shutdown()
+	{
+		if (!isInitialized) return;
+
+		workers->WaitIdle();
+		workers.reset();
+
+		//handles released from here on are no-ops
+		isInitialized = false;
+
+		//references held by other resources are released with them and are not leaks
+		unordered_map<u32, u32> internalRefs{};
+		for (const auto& slot : slots)
+		{
+			if (!slot
+				|| !slot->isActive.load(memory_order_relaxed))
+			{
+				continue;
+			}
+
+			for (const auto& dependency : slot->desc.dependencies) ++internalRefs[dependency.index];
+		}
+
+		vector<ResourceSlot*> live{};
+		for (u32 i = 1; i < slots.size(); ++i)
+		{
+			ResourceSlot* slot = slots[i].get();
+			if (!slot->isActive.load(memory_order_relaxed)) continue;
+
+			u32 refs = slot->refCount.load(memory_order_acquire) - internalRefs[i];
+			if (refs > 0)
+			{
+				Log::Print(
+					"Resource '" + slot->key + "' still has " + to_string(refs) + " handles at shutdown!",
+					"RESOURCE_MANAGER",
+					LogType::LOG_WARNING);
+			}
+
+			live.push_back(slot);
+		}
+
+		//newest first, so nothing is destroyed before the resources that use it
+		sort(
+			live.begin(),
+			live.end(),
+			[](const ResourceSlot* a, const ResourceSlot* b) { return a->sequence > b->sequence; });
+
+		for (ResourceSlot* slot : live)
+		{
+			if (slot->object
+				&& slot->desc.destroy)
+			{
+				slot->desc.destroy(slot->object);
+			}
+			slot->object = nullptr;
+		}
+
+		{
+			lock_guard<mutex> lock(slotsMutex);
+			slots.clear();
+		}
+		{
+			lock_guard<mutex> lock(releasedMutex);
+			released.clear();
+		}
+
+		freeSlots.clear();
+		keyToSlot.clear();
+		completed.clear();
+		awaitingFinalize.clear();
+		destroyQueue.clear();
+
+		Log::Print(
+			"Destroyed " + to_string(live.size()) + " resources.",
+			"RESOURCE_MANAGER",
+			LogType::LOG_INFO);
+	}
+}
+
+ResourceSlot* GetSlot(
+	u32 index,
+	u32 generation)
+{
+	if (index == 0) return nullptr;
+
+	ResourceSlot* slot{};
+	{
+		lock_guard<mutex> lock(slotsMutex);
+		if (index >= slots.size()) return nullptr;
+
+		slot = slots[index].get();
+	}
+
+	return slot
+		&& slot->isActive.load(memory_order_acquire)
+		&& slot->generation.load(memory_order_acquire) == generation
+		? slot
+		: nullptr;
+}
+
+void AddRef(
+	u32 index,
+	u32 generation)
+{
+	ResourceSlot* slot = GetSlot(index, generation);
+	if (slot) slot->refCount.fetch_add(1, memory_order_relaxed);
+}
+
+void Release(
+	u32 index,
+	u32 generation)
+{
+	if (!isInitialized) return;
+
+	ResourceSlot* slot = GetSlot(index, generation);
+	if (!slot
+		|| slot->refCount.fetch_sub(1, memory_order_acq_rel) != 1)
+	{
+		return;
+	}
+
+	//the key and destroy queues are main thread only, Update picks this up
+	lock_guard<mutex> lock(releasedMutex);
+	released.push_back({ index, generation, 0 });
+}
+
+void QueueReleased()
+{
+	vector<PendingDestroy> drained{};
+	{
+		lock_guard<mutex> lock(releasedMutex);
+		swap(drained, released);
+	}
+
+	for (const auto& pending : drained)
+	{
+		ResourceSlot* slot = slots[pending.index].get();
+
+		//Find can hand out a new handle before the release is drained,
+		//and a slot released twice that way must only be queued once
+		if (!slot->isActive.load(memory_order_relaxed)
+			|| slot->generation.load(memory_order_relaxed) != pending.generation
+			|| slot->refCount.load(memory_order_acquire) != 0
+			|| find_if(
+				destroyQueue.begin(),
+				destroyQueue.end(),
+				[&pending](const PendingDestroy& queued)
+				{
+					return queued.index == pending.index
+						&& queued.generation == pending.generation;
+				}) != destroyQueue.end())
+		{
+			continue;
+		}
+
+		//forget the key so loading it again starts a fresh resource
+		auto it = keyToSlot.find(slot->key);
+		if (it != keyToSlot.end()
+			&& it->second == pending.index)
+		{
+			keyToSlot.erase(it);
+		}
+
+		destroyQueue.push_back({ pending.index, pending.generation, frameIndex });
+	}
+}
+
+bool FinalizeSlot(u32 index)
+{
+	ResourceSlot* slot = slots[index].get();
+
+	//released before it ever finished, the destroy queue takes care of it
+	if (slot->refCount.load(memory_order_acquire) == 0)
+	{
+		slot->state.store(ResourceState::STATE_FAILED, memory_order_release);
+		slot->error = "Released before it finished loading.";
+		slot->data.reset();
+		return true;
+	}
+
+	if (slot->error.empty())
+	{
+		for (const auto& dependency : slot->desc.dependencies)
+		{
+			ResourceState depState = dependency.GetState();
+			if (depState == ResourceState::STATE_FAILED)
+			{
+				slot->error = "Dependency '" + dependency.GetKey() + "' failed! Reason: " + dependency.GetError();
+				break;
+			}
+			if (depState != ResourceState::STATE_READY) return false;
+		}
+	}
+
+	if (slot->error.empty())
+	{
+		slot->error = slot->desc.finalize(
+			slot->data,
+			slot->desc.dependencies,
+			slot->object);
+	}
+
+	//cpu side data is no longer needed once the runtime object exists
+	slot->data.reset();
+
+	if (!slot->error.empty())
+	{
+		Log::Print(
+			"Failed to load resource '" + slot->key + "'! Reason: " + slot->error,
+			"RESOURCE_MANAGER",
+			LogType::LOG_ERROR,
+			2);
+
+		slot->state.store(ResourceState::STATE_FAILED, memory_order_release);
+		return true;
+	}
+
+	slot->state.store(ResourceState::STATE_READY, memory_order_release);
+	return true;
+}
+
+void DestroySlot(u32 index)
+{
+	ResourceSlot* slot = slots[index].get();
+
+	//a load that never finalized is still waiting in the queue
+	auto waiting = find(awaitingFinalize.begin(), awaitingFinalize.end(), index);
+	if (waiting != awaitingFinalize.end()) awaitingFinalize.erase(waiting);
+	{
+		lock_guard<mutex> lock(completedMutex);
+		auto done = find(completed.begin(), completed.end(), index);
+		if (done != completed.end()) completed.erase(done);
+	}
+
+	if (slot->object
+		&& slot->desc.destroy)
+	{
+		slot->desc.destroy(slot->object);
+	}
+
+	//releasing the dependencies may queue them for destruction in turn
+	ResourceDesc desc = move(slot->desc);
+	slot->desc = {};
+
+	slot->key.clear();
+	slot->object = nullptr;
+	slot->error.clear();
+	slot->data.reset();
+	slot->isActive.store(false, memory_order_release);
+	slot->state.store(ResourceState::STATE_QUEUED, memory_order_relaxed);
+	slot->generation.fetch_add(1, memory_order_release);
+
+	freeSlots.push_back(index);
+
+	desc.dependencies.clear();
+}
@@ -0,0 +1,126 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+#include <atomic>
+
+#include "KalaHeaders/thread_utils.hpp"
+
+#include "core/thread_pool.hpp"
+
+using KalaHeaders::KalaThread::jthread;
+
+using std::unique_lock;
+using std::lock_guard;
+using std::atomic;
+using std::max;
+using std::min;
+using std::move;
+
+namespace GameTest::Core
+{
+	ThreadPool::ThreadPool(u32 threadCount)
+	{
+		if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+
+		workers.reserve(threadCount);
+		for (u32 i = 0; i < threadCount; ++i)
+		{
+			workers.push_back(jthread([this]() { WorkerLoop(); }));
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			lock_guard<mutex> lock(jobMutex);
+			isStopping = true;
+		}
+		jobCV.notify_all();
+
+		for (auto& w : workers)
+		{
+			if (w.joinable()) w.join();
+		}
+	}
+
+	void ThreadPool::Submit(function<void()> job)
+	{
+		{
+			lock_guard<mutex> lock(jobMutex);
+			jobs.push_back(move(job));
+		}
+		jobCV.notify_one();
+	}
+
+	void ThreadPool::WaitIdle()
+	{
+		unique_lock<mutex> lock(jobMutex);
+		idleCV.wait(lock, [this]() { return jobs.empty() && activeJobs == 0; });
+	}
+
+	void ThreadPool::ParallelFor(
+		size_t count,
+		const function<void(size_t)>& func)
+	{
+		if (count == 0) return;
+
+		//one job per worker pulling indexes from a shared counter,
+		//so uneven work per index still balances out
+		atomic<size_t> next{};
+		size_t jobCount = min(count, workers.size());
+
+		for (size_t j = 0; j < jobCount; ++j)
+		{
+			Submit([&next, count, &func]()
+				{
+					for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+					{
+						func(i);
+					}
+				});
+		}
+
+		WaitIdle();
+	}
+
+	u32 ThreadPool::GetThreadCount() const { return scast<u32>(workers.size()); }
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			function<void()> job{};
+
+			{
+				unique_lock<mutex> lock(jobMutex);
+				jobCV.wait(lock, [this]() { return isStopping || !jobs.empty(); });
+
+				if (isStopping
+					&& jobs.empty())
+				{
+					return;
+				}
+
+				job = move(jobs.front());
+				jobs.pop_front();
+				++activeJobs;
+			}
+
+			job();
+
+			{
+				lock_guard<mutex> lock(jobMutex);
+				--activeJobs;
+
+				if (jobs.empty()
+					&& activeJobs == 0)
+				{
+					idleCV.notify_all();
+				}
+			}
+		}
+	}
+}
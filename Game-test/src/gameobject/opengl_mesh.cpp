@@ -0,0 +1,545 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "core/kw_core.hpp"
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_functions_core.hpp"
+
+#include "gameobject/opengl_mesh.hpp"
+#include "graphics/gl_extra_functions.hpp"
+#include "core/content_hash.hpp"
+#include "core/asset_pack.hpp"
+#include "core/mapped_file.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaModelData::Vertex;
+using KalaHeaders::KalaModelData::ModelBlock;
+using KalaHeaders::KalaModelData::ImportResult;
+using KalaHeaders::KalaModelData::ResultToString;
+using KalaHeaders::KalaModelData::ParseBlockData;
+
+using KalaWindow::Core::KalaWindowCore;
+using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
+using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
+
+using GameTest::GameObject::OpenGL_Mesh;
+using GameTest::GameObject::MeshSource;
+using GameTest::Core::ContentHash;
+using GameTest::Core::AssetPack;
+using GameTest::Core::MappedFile;
+using GameTest::Core::FileMapping;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+using GameTest::Graphics::MeshletBuilder;
+using GameTest::Graphics::MESHLET_MIN_TRIANGLES;
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::shared_ptr;
+using std::weak_ptr;
+using std::unordered_map;
+using std::unordered_set;
+using std::string_view;
+using std::min;
+using std::max;
+using std::move;
+using std::memcpy;
+
+//both lookups point at the same meshes, entries are erased when their mesh is destroyed
+static unordered_map<u64, weak_ptr<OpenGL_Mesh>> keyLookup{};
+static unordered_map<u64, weak_ptr<OpenGL_Mesh>> assetLookup{};
+
+//meshes whose cpu copy is paged in
+static unordered_set<const OpenGL_Mesh*> residentMeshes{};
+
+static u32 meshCount{};
+
+static u64 HashGeometry(
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices);
+
+//Parses the source block out of the mapped pack or a mapped loose file
+static string ReadSourceGeometry(
+	const MeshSource& source,
+	vector<Vertex>& outVertices,
+	vector<u32>& outIndices);
+
+static void CreateModelGeometry(
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices,
+	u32& outVAO,
+	u32& outVBO,
+	u32& outEBO);
+
+namespace GameTest::GameObject
+{
+	shared_ptr<OpenGL_Mesh> OpenGL_Mesh::Acquire(
+		u64 key,
+		vector<Vertex> vertices,
+		vector<u32> indices,
+		const MeshSource* source)
+	{
+		if (key != 0)
+		{
+			shared_ptr<OpenGL_Mesh> cached = Find(key);
+			if (cached) return cached;
+		}
+
+		u64 assetHash = HashGeometry(vertices, indices);
+
+		//same geometry under another key, the new key becomes an alias of it
+		auto it = assetLookup.find(assetHash);
+		if (it != assetLookup.end())
+		{
+			shared_ptr<OpenGL_Mesh> cached = it->second.lock();
+			if (cached)
+			{
+				//a file is cheaper to page in from than the gpu
+				if (source
+					&& cached->source.path.empty())
+				{
+					cached->source = *source;
+				}
+
+				if (key != 0)
+				{
+					keyLookup[key] = cached;
+					cached->keys.push_back(key);
+				}
+
+				return cached;
+			}
+		}
+
+		shared_ptr<OpenGL_Mesh> mesh(new OpenGL_Mesh());
+
+		mesh->assetHash = assetHash;
+		mesh->vertices = move(vertices);
+		mesh->indices = move(indices);
+		mesh->vertexCount = scast<u32>(mesh->vertices.size());
+		mesh->indexCount = scast<u32>(mesh->indices.size());
+		if (source) mesh->source = *source;
+
+		if (!mesh->vertices.empty())
+		{
+			mesh->boundsMin = vec3(1e30f);
+			mesh->boundsMax = vec3(-1e30f);
+
+			for (const Vertex& v : mesh->vertices)
+			{
+				mesh->boundsMin = vec3(
+					min(mesh->boundsMin.x, v.position[0]),
+					min(mesh->boundsMin.y, v.position[1]),
+					min(mesh->boundsMin.z, v.position[2]));
+				mesh->boundsMax = vec3(
+					max(mesh->boundsMax.x, v.position[0]),
+					max(mesh->boundsMax.y, v.position[1]),
+					max(mesh->boundsMax.z, v.position[2]));
+			}
+		}
+
+		//large meshes are culled per cluster, small ones are cheaper to draw whole
+		if (mesh->indices.size() / 3 >= MESHLET_MIN_TRIANGLES)
+		{
+			mesh->meshlets = MeshletBuilder::Build(
+				mesh->vertices,
+				mesh->indices);
+		}
+
+		CreateModelGeometry(
+			mesh->vertices,
+			mesh->indices,
+			mesh->VAO,
+			mesh->VBO,
+			mesh->EBO);
+
+		//the gpu holds the geometry now, the cpu copy is paged back in when something reads it
+		mesh->ReleaseCpuData();
+
+		assetLookup[assetHash] = mesh;
+		if (key != 0)
+		{
+			keyLookup[key] = mesh;
+			mesh->keys.push_back(key);
+		}
+
+		++meshCount;
+
+		return mesh;
+	}
+
+	shared_ptr<OpenGL_Mesh> OpenGL_Mesh::Find(u64 key)
+	{
+		auto it = keyLookup.find(key);
+		if (it == keyLookup.end()) return nullptr;
+
+		return it->second.lock();
+	}
+
+	u64 OpenGL_Mesh::MakeKey(
+		u64 fileHash,
+		u32 blockOffset,
+		string_view meshName)
+	{
+		//mesh names are null padded, only the name itself is hashed
+		size_t length = meshName.find('\0');
+		if (length != string_view::npos) meshName = meshName.substr(0, length);
+
+		u64 blockHash = ContentHash::HashBytes(
+			&blockOffset,
+			sizeof(blockOffset),
+			fileHash);
+
+		u64 key = ContentHash::HashString(meshName, blockHash);
+
+		//0 is reserved for content-only lookups
+		return key != 0 ? key : 1;
+	}
+
+	u32 OpenGL_Mesh::GetCount() { return meshCount; }
+
+	void OpenGL_Mesh::TrimCpuData()
+	{
+		for (auto it = residentMeshes.begin(); it != residentMeshes.end();)
+		{
+			const OpenGL_Mesh* mesh = *it;
+			if (mesh->cpuAccessCount > 0)
+			{
+				++it;
+				continue;
+			}
+
+			mesh->ReleaseCpuData();
+			it = residentMeshes.erase(it);
+		}
+	}
+
+	u64 OpenGL_Mesh::GetCpuBytes()
+	{
+		u64 bytes{};
+		for (const OpenGL_Mesh* mesh : residentMeshes)
+		{
+			bytes += mesh->vertices.size() * sizeof(Vertex)
+				+ mesh->indices.size() * sizeof(u32);
+		}
+
+		return bytes;
+	}
+
+	bool OpenGL_Mesh::ReadBuffer(
+		u32 buffer,
+		size_t size,
+		void* outData)
+	{
+		if (buffer == 0
+			|| size == 0)
+		{
+			return false;
+		}
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		coreFunc->glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+
+		void* mapped = coreFunc->glMapBufferRange(
+			GL_COPY_READ_BUFFER,
+			0,
+			size,
+			GL_MAP_READ_BIT);
+
+		if (mapped)
+		{
+			memcpy(outData, mapped, size);
+			OpenGL_Functions_Extra::GetGLExtra()->glUnmapBuffer(GL_COPY_READ_BUFFER);
+		}
+
+		coreFunc->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+		return mapped != nullptr;
+	}
+
+	const vector<Vertex>& OpenGL_Mesh::GetVertices() const
+	{
+		PageIn();
+		return vertices;
+	}
+	const vector<u32>& OpenGL_Mesh::GetIndices() const
+	{
+		PageIn();
+		return indices;
+	}
+
+	void OpenGL_Mesh::AddCpuAccess()
+	{
+		++cpuAccessCount;
+		PageIn();
+	}
+	void OpenGL_Mesh::RemoveCpuAccess()
+	{
+		//released by the next TrimCpuData
+		if (cpuAccessCount > 0) --cpuAccessCount;
+	}
+
+	bool OpenGL_Mesh::PageIn() const
+	{
+		if (isCpuResident) return true;
+
+		vector<Vertex> newVertices{};
+		vector<u32> newIndices{};
+		string result{};
+
+		if (!source.path.empty())
+		{
+			result = ReadSourceGeometry(
+				source,
+				newVertices,
+				newIndices);
+		}
+		else
+		{
+			newVertices.resize(vertexCount);
+			newIndices.resize(indexCount);
+
+			if (!ReadBuffer(VBO, newVertices.size() * sizeof(Vertex), newVertices.data())
+				|| !ReadBuffer(EBO, newIndices.size() * sizeof(u32), newIndices.data()))
+			{
+				result = "its buffers could not be mapped";
+			}
+		}
+
+		//the source file may have been replaced since the mesh was uploaded
+		if (result.empty()
+			&& HashGeometry(newVertices, newIndices) != assetHash)
+		{
+			result = "the geometry no longer matches the uploaded mesh";
+		}
+
+		if (!result.empty())
+		{
+			Log::Print(
+				"Failed to page in mesh '" + to_string(assetHash) + "'! Reason: " + result,
+				"OPENGL_MESH",
+				LogType::LOG_ERROR,
+				2);
+
+			return false;
+		}
+
+		vertices = move(newVertices);
+		indices = move(newIndices);
+		isCpuResident = true;
+
+		residentMeshes.insert(this);
+
+		return true;
+	}
+
+	void OpenGL_Mesh::ReleaseCpuData() const
+	{
+		//swapping with empty vectors gives the memory back, clear would keep the capacity
+		vector<Vertex>().swap(vertices);
+		vector<u32>().swap(indices);
+
+		isCpuResident = false;
+	}
+
+	OpenGL_Mesh::~OpenGL_Mesh()
+	{
+		//a newer mesh may already be cached under the same hash, only expired entries are ours
+		for (u64 key : keys)
+		{
+			auto it = keyLookup.find(key);
+			if (it != keyLookup.end()
+				&& it->second.expired())
+			{
+				keyLookup.erase(it);
+			}
+		}
+
+		auto it = assetLookup.find(assetHash);
+		if (it != assetLookup.end()
+			&& it->second.expired())
+		{
+			assetLookup.erase(it);
+		}
+
+		residentMeshes.erase(this);
+
+		--meshCount;
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		if (VAO != 0) coreFunc->glDeleteVertexArrays(1, &VAO);
+		if (VBO != 0) coreFunc->glDeleteBuffers(1, &VBO);
+		if (EBO != 0) coreFunc->glDeleteBuffers(1, &EBO);
+	}
+}
+
+void CreateModelGeometry(
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices,
+	u32& outVAO,
+	u32& outVBO,
+	u32& outEBO)
+{
+	if (vertices.empty()
+		|| indices.empty())
+	{
+		KalaWindowCore::ForceClose(
+			"OpenGL model error",
+			"Failed to create model geometry because vertices or indices were empty");
+	}
+
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+	
+	coreFunc->glGenVertexArrays(1, &outVAO);
+	coreFunc->glGenBuffers(1, &outVBO);
+	coreFunc->glGenBuffers(1, &outEBO);
+	
+	coreFunc->glBindVertexArray(outVAO);
+	
+	//VBO
+	coreFunc->glBindBuffer(GL_ARRAY_BUFFER, outVBO);
+	coreFunc->glBufferData(
+		GL_ARRAY_BUFFER,
+		vertices.size() * sizeof(Vertex),
+		vertices.data(),
+		GL_STATIC_DRAW);
+		
+	//EBO
+	coreFunc->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, outEBO);
+	coreFunc->glBufferData(
+		GL_ELEMENT_ARRAY_BUFFER,
+		indices.size() * sizeof(u32),
+		indices.data(),
+		GL_STATIC_DRAW);
+		
+	//position - layout 0
+	coreFunc->glEnableVertexAttribArray(0);
+	coreFunc->glVertexAttribPointer(
+		0, 3, GL_FLOAT, GL_FALSE,
+		sizeof(Vertex),
+		(void*)offsetof(Vertex, position));
+		
+	//normal - layout 1
+	coreFunc->glEnableVertexAttribArray(1);
+	coreFunc->glVertexAttribPointer(
+		1, 3, GL_FLOAT, GL_FALSE,
+		sizeof(Vertex),
+		(void*)offsetof(Vertex, normal));
+		
+	//texcoord - layout 2
+	coreFunc->glEnableVertexAttribArray(2);
+	coreFunc->glVertexAttribPointer(
+		2, 2, GL_FLOAT, GL_FALSE,
+		sizeof(Vertex),
+		(void*)offsetof(Vertex, texCoord));
+		
+	//tangent - layout 3
+	coreFunc->glEnableVertexAttribArray(3);
+	coreFunc->glVertexAttribPointer(
+		3, 4, GL_FLOAT, GL_FALSE,
+		sizeof(Vertex),
+		(void*)offsetof(Vertex, tangent));
+		
+	coreFunc->glBindVertexArray(0);
+}
+
+u64 HashGeometry(
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices)
+{
+	return ContentHash::HashBytes(
+		vertices.data(),
+		vertices.size() * sizeof(Vertex),
+		ContentHash::HashBytes(
+			indices.data(),
+			indices.size() * sizeof(u32)));
+}
+
+string ReadSourceGeometry(
+	const MeshSource& source,
+	vector<Vertex>& outVertices,
+	vector<u32>& outIndices)
+{
+	vector<ModelBlock> blocks{};
+	ImportResult result{};
+
+	try
+	{
+		//packed files are read straight from the mounted pack, compressed entries have to be decoded whole
+		if (AssetPack::FindEntry(source.path))
+		{
+			u64 size{};
+			const u8* data = AssetPack::GetMappedData(source.path, size);
+
+			vector<u8> decoded{};
+			if (!data)
+			{
+				string readResult = AssetPack::ReadBinary(source.path, decoded);
+				if (!readResult.empty()) return readResult;
+
+				data = decoded.data();
+				size = decoded.size();
+			}
+
+			result = ParseBlockData(
+				data,
+				scast<size_t>(size),
+				0,
+				{ source.table },
+				blocks);
+		}
+		else
+		{
+			MappedFile file{};
+			if (!FileMapping::Map(source.path, file)) return "source '" + source.path + "' could not be mapped";
+
+			try
+			{
+				result = ParseBlockData(
+					file.data,
+					scast<size_t>(file.size),
+					0,
+					{ source.table },
+					blocks);
+			}
+			catch (...)
+			{
+				FileMapping::Unmap(file);
+				throw;
+			}
+
+			FileMapping::Unmap(file);
+		}
+	}
+	catch (...)
+	{
+		return "source '" + source.path + "' could not be parsed";
+	}
+
+	if (result != ImportResult::RESULT_SUCCESS) return ResultToString(result);
+	if (blocks.empty()) return "source '" + source.path + "' has no block";
+
+	outVertices = move(blocks.front().vertices);
+	outIndices = move(blocks.front().indices);
+
+	return{};
+}
@@ -8,6 +8,8 @@
 #include <memory>
 #include <filesystem>
 #include <algorithm>
+#include <string_view>
+#include <cstring>
 
 #include "KalaHeaders/log_utils.hpp"
 #include "KalaHeaders/import_kmd.hpp"
@@ -17,8 +19,13 @@
 #include "opengl/kw_opengl.hpp"
 #include "opengl/kw_opengl_functions_core.hpp"
 
+#include "core/asset_pack.hpp"
+#include "core/content_hash.hpp"
 #include "gameobject/opengl_model.hpp"
 #include "gameobject/opengl_point_light.hpp"
+#include "graphics/gl_extra_functions.hpp"
+#include "graphics/weighted_oit.hpp"
+#include "graphics/deferred_renderer.hpp"
 
 using KalaHeaders::KalaLog::Log;
 using KalaHeaders::KalaLog::LogType;
@@ -43,6 +50,14 @@ using KalaHeaders::KalaModelData::ModelTable;
 using KalaHeaders::KalaModelData::ModelBlock;
 using KalaHeaders::KalaModelData::Vertex;
 using KalaHeaders::KalaModelData::ImportResult;
+using KalaHeaders::KalaModelData::ParseBlockData;
+using KalaHeaders::KalaModelData::ParseHeaderData;
+using KalaHeaders::KalaModelData::ParseTableData;
+using KalaHeaders::KalaModelData::PreReadCheck;
+using KalaHeaders::KalaModelData::CORRECT_MODEL_HEADER_SIZE;
+using KalaHeaders::KalaModelData::VERTICE_DATA_OFFSET;
+using KalaHeaders::KalaModelData::MIN_TOTAL_SIZE;
+using KalaHeaders::KalaModelData::MAX_TOTAL_SIZE;
 using KalaHeaders::KalaModelData::ResultToString;
 
 using KalaWindow::Core::KalaWindowCore;
@@ -50,26 +65,48 @@ using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
 using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
 using KalaWindow::OpenGL::OpenGL_Global;
 
+using GameTest::Core::AssetPack;
+using GameTest::Core::ContentHash;
 using GameTest::GameObject::OpenGL_Model;
+using GameTest::GameObject::OpenGL_Mesh;
 using GameTest::GameObject::OpenGL_PointLight;
 using GameTest::GameObject::OpenGL_PointLight_Data;
 using GameTest::GameObject::MAX_PL_COUNT;
 using GameTest::Graphics::TextureFormat;
+using GameTest::Graphics::StreamRing;
+using GameTest::Graphics::StreamAllocation;
+using GameTest::Graphics::GL_Extra;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+using GameTest::Graphics::WeightedOIT;
+using GameTest::Graphics::DeferredRenderer;
+using GameTest::Graphics::MeshletCuller;
+using GameTest::Graphics::MeshletDrawRange;
 
 using std::string;
 using std::to_string;
 using std::vector;
 using std::make_unique;
 using std::unique_ptr;
+using std::shared_ptr;
+using std::string_view;
+using std::memcpy;
 using std::filesystem::path;
 using std::clamp;
+using std::min;
+
+//byte offsets inside a kmd model block, and the size of its name fields
+constexpr u32 BLOCK_MESH_NAME_OFFSET = 20u;
+constexpr u32 BLOCK_VERTICES_SIZE_OFFSET = 136u;
+constexpr u32 BLOCK_INDICES_SIZE_OFFSET = 144u;
+constexpr u32 BLOCK_NAME_SIZE = 20u;
 	
-static void CreateModelGeometry(
-	const vector<Vertex>& vertices,
-	const vector<u32>& indices,
-	u32& outVAO,
-	u32& outVBO,
-	u32& outEBO);
+//Parses every block of a kmd file in memory whose mesh isn't cached yet, cached blocks
+//are returned in table order with only their names and vertex and index sizes
+static ImportResult ImportUncachedBlocks(
+	const vector<u8>& data,
+	u64 fileHash,
+	vector<ModelBlock>& outBlocks,
+	vector<ModelTable>& outTables);
 
 namespace GameTest::GameObject
 {	
@@ -77,17 +114,101 @@ namespace GameTest::GameObject
 
 	//point light UBO reused by all point lights
 	static u32 plUBO{};
+	//lights written by the last UploadPointLights call
+	static u8 plCount{};
+
+	//meshlet draw lists reused by every model, models are only drawn on the gl thread
+	static vector<MeshletDrawRange> meshletRanges{};
+	static vector<GLsizei> meshletCounts{};
+	static vector<const void*> meshletOffsets{};
 
 	Registry<OpenGL_Model>& OpenGL_Model::GetRegistry() { return registry; }
 
 	u32 OpenGL_Model::GetPointLightUBO() { return plUBO; }
+	u32 OpenGL_Model::GetPointLightCount() { return plCount; }
+
+	void OpenGL_Model::UploadPointLights(StreamRing* ring)
+	{
+		plCount = 0;
+
+		if (plUBO == 0) return;
+
+		const auto& lights = OpenGL_PointLight::GetRegistry().runtimeContent;
+		u8 count = scast<u8>(min(lights.size(), scast<size_t>(MAX_PL_COUNT)));
+
+		//the bound range has to cover the whole block, not only the used lights
+		constexpr size_t blockSize = sizeof(OpenGL_PointLight_Data) * MAX_PL_COUNT;
+
+		StreamAllocation allocation{};
+		if (ring) allocation = ring->Allocate(blockSize, ring->GetUniformAlignment());
+
+		OpenGL_PointLight_Data* target = allocation.IsValid()
+			? reinterpret_cast<OpenGL_PointLight_Data*>(allocation.data)
+			: nullptr;
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		if (!target) coreFunc->glBindBuffer(GL_UNIFORM_BUFFER, plUBO);
+
+		for (u8 i = 0; i < count; i++)
+		{
+			OpenGL_PointLight* pl = lights[i];
+
+			OpenGL_PointLight_Data data{};
+
+			//skip invalid lights
+			if (!pl
+				|| !pl->CanRenderLight()
+				|| isnear(pl->GetIntensity())
+				|| isnear(pl->GetMaxRange()))
+			{
+				data.canRender = 0;
+			}
+			else data = *pl->GetDataPtr();
+
+			if (target)
+			{
+				target[i] = data;
+				continue;
+			}
+
+			coreFunc->glBufferSubData(
+				GL_UNIFORM_BUFFER,
+				sizeof(OpenGL_PointLight_Data) * i,
+				sizeof(OpenGL_PointLight_Data),
+				&data);
+		}
+
+		if (target)
+		{
+			ring->Flush();
+
+			OpenGL_Functions_Extra::GetGLExtra()->glBindBufferRange(
+				GL_UNIFORM_BUFFER,
+				0,
+				allocation.buffer,
+				scast<GLintptr>(allocation.offset),
+				scast<GLsizeiptr>(blockSize));
+		}
+		else
+		{
+			coreFunc->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			coreFunc->glBindBufferBase(
+				GL_UNIFORM_BUFFER,
+				0,
+				plUBO);
+		}
+
+		plCount = count;
+	}
 
 	OpenGL_Model* OpenGL_Model::InitializeSingle(
 		const string& name,
 		OpenGL_Context* context,
 		const vector<Vertex>& vertices,
 		const vector<u32>& indices,
-		OpenGL_Shader* shader)
+		OpenGL_Shader* shader,
+		bool isQueued)
 	{
 		if (!OpenGL_Global::IsContextValid(context))
 		{
@@ -115,10 +236,39 @@ namespace GameTest::GameObject
 		
 		return Initialize(
 			name,
-			vertices,
-			indices,
+			OpenGL_Mesh::Acquire(0, vertices, indices),
 			context,
-			shader);
+			shader,
+			isQueued);
+	}
+
+	OpenGL_Model* OpenGL_Model::InitializeInstance(
+		const string& name,
+		const OpenGL_Model& source,
+		bool isQueued)
+	{
+		if (!source.isInitialized
+			|| !source.render.mesh)
+		{
+			Log::Print(
+				"Failed to load model '" + name + "' because its source model is not initialized!",
+				"OPENGL_MODEL",
+				LogType::LOG_ERROR,
+				2);
+
+			return nullptr;
+		}
+
+		OpenGL_Model* model = Initialize(
+			name,
+			source.render.mesh,
+			source.context,
+			source.render.shader,
+			isQueued);
+
+		model->CopyMaterial(source);
+
+		return model;
 	}
 		
 	vector<OpenGL_Model*> OpenGL_Model::InitializeAll(
@@ -150,41 +300,234 @@ namespace GameTest::GameObject
 			return {};
 		}
 		
-		ModelHeader header{};
-		vector<ModelTable> tables{};
 		vector<ModelBlock> blocks{};
+		MeshFile file{};
+
+		//blocks that are already loaded are not parsed again
+		string result = ImportFile(
+			modelPath,
+			blocks,
+			file,
+			true);
+		if (!result.empty())
+		{
+			Log::Print(
+				result,
+				"OPENGL_MODEL",
+				LogType::LOG_ERROR,
+				2);
+			
+			return {};
+		}
 		
-		ImportResult result = ImportKMD(
-			path(modelPath),
-			header,
-			tables,
-			blocks);
+		return InitializeBlocks(
+			move(blocks),
+			context,
+			shader,
+			false,
+			file);
+	}
+
+	string OpenGL_Model::ImportFile(
+		const string& modelPath,
+		vector<ModelBlock>& outBlocks,
+		MeshFile& outFile,
+		bool skipCached)
+	{
+		//loose models keep the file checks, both are decoded from memory so the file can be hashed
+		if (!AssetPack::FindEntry(modelPath))
+		{
+			ImportResult checkResult = PreReadCheck(path(modelPath));
+			if (checkResult != ImportResult::RESULT_SUCCESS)
+			{
+				return "Failed to import model from path '" + modelPath + "'! Reason: " + ResultToString(checkResult);
+			}
+		}
+
+		vector<u8> data{};
+		string readResult = AssetPack::ReadBinary(modelPath, data);
+		if (!readResult.empty())
+		{
+			return "Failed to read model from path '" + modelPath + "'! Reason: " + readResult;
+		}
+
+		u64 fileHash = ContentHash::HashBytes(
+			data.data(),
+			data.size());
+
+		vector<ModelBlock> blocks{};
+		vector<ModelTable> tables{};
+		ImportResult result{};
+
+		if (skipCached)
+		{
+			result = ImportUncachedBlocks(
+				data,
+				fileHash,
+				blocks,
+				tables);
+		}
+		else
+		{
+			ModelHeader header{};
+
+			result = ImportKMD(
+				data.data(),
+				data.size(),
+				header,
+				tables,
+				blocks);
+		}
 			
 		if (result != ImportResult::RESULT_SUCCESS)
+		{
+			return "Failed to import model from path '" + modelPath + "'! Reason: " + ResultToString(result);
+		}
+
+		outBlocks = move(blocks);
+
+		outFile.path = modelPath;
+		outFile.hash = fileHash;
+		outFile.tables = move(tables);
+
+		return{};
+	}
+
+	string OpenGL_Model::StreamFile(
+		const string& modelPath,
+		const vector<ModelTable>& modelTables,
+		vector<ModelBlock>& outBlocks)
+	{
+		ImportResult result{};
+
+		//packed models are parsed straight from the mapped pack, loose models seek per block
+		if (AssetPack::FindEntry(modelPath))
+		{
+			u64 size{};
+			const u8* data = AssetPack::GetMappedData(modelPath, size);
+			if (!data)
+			{
+				return "Failed to stream packed model from path '" + modelPath + "'! Reason: streamed models must be stored uncompressed.";
+			}
+
+			result = ParseBlockData(
+				data,
+				scast<size_t>(size),
+				0,
+				modelTables,
+				outBlocks);
+		}
+		else
+		{
+			result = KalaHeaders::KalaModelData::StreamModels(
+				path(modelPath),
+				modelTables,
+				outBlocks);
+		}
+
+		if (result != ImportResult::RESULT_SUCCESS)
+		{
+			return "Failed to stream models from path '" + modelPath + "'! Reason: " + ResultToString(result);
+		}
+
+		return{};
+	}
+
+	vector<OpenGL_Model*> OpenGL_Model::InitializeBlocks(
+		vector<ModelBlock> blocks,
+		OpenGL_Context* context,
+		OpenGL_Shader* shader,
+		bool isQueued,
+		const MeshFile& file)
+	{
+		if (!OpenGL_Global::IsContextValid(context))
 		{
 			Log::Print(
-				"Failed to import model from path '" + modelPath + "'! Reason: " + ResultToString(result),
+				"Cannot load imported models because the gl context is invalid!",
 				"OPENGL_MODEL",
 				LogType::LOG_ERROR,
 				2);
-			
+
 			return {};
 		}
 		
+		//shader is required
+		if (!shader
+			|| !shader->IsInitialized())
+		{
+			Log::Print(
+				"Failed to load imported models because the shader context is invalid!",
+				"OPENGL_MODEL",
+				LogType::LOG_ERROR,
+				2);
+
+			return {};
+		}
+
 		vector<OpenGL_Model*> models{};
 		
-		for (auto& b : blocks)
+		for (size_t i = 0; i < blocks.size(); ++i)
 		{
-			string nodeName = string(b.nodeName);
-			vector<Vertex> vertices = b.vertices;
-			vector<u32> indices = b.indices;
-			
+			ModelBlock& b = blocks[i];
+
+			//the table gives the block offset, without it the mesh is only shared by content
+			u64 key = file.hash != 0
+				&& i < file.tables.size()
+				? OpenGL_Mesh::MakeKey(
+					file.hash,
+					file.tables[i].blockOffset,
+					string_view(b.meshName, sizeof(b.meshName)))
+				: 0;
+
+			//blocks skipped by ImportFile carry no geometry, their mesh is already cached
+			shared_ptr<OpenGL_Mesh> mesh = key != 0 ? OpenGL_Mesh::Find(key) : nullptr;
+
+			size_t blockVertexCount = b.vertices.empty()
+				? b.verticesSize / sizeof(Vertex)
+				: b.vertices.size();
+
+			//a cached mesh of another size means the key aliased two different blocks
+			if (mesh
+				&& mesh->GetVertexCount() != blockVertexCount)
+			{
+				Log::Print(
+					"Cached mesh for block '" + string(b.nodeName) + "' of model '" + file.path + "' has "
+					+ to_string(mesh->GetVertexCount()) + " vertices but the block has " + to_string(blockVertexCount) + "!",
+					"OPENGL_MODEL",
+					LogType::LOG_ERROR,
+					2);
+
+				if (b.vertices.empty()) continue;
+
+				mesh = nullptr;
+				key = 0;
+			}
+
+			if (!mesh)
+			{
+				//the mesh pages its cpu copy back in from this block after releasing it
+				MeshSource source{};
+				bool hasSource = !file.path.empty()
+					&& i < file.tables.size();
+				if (hasSource)
+				{
+					source.path = file.path;
+					source.table = file.tables[i];
+				}
+
+				mesh = OpenGL_Mesh::Acquire(
+					key,
+					move(b.vertices),
+					move(b.indices),
+					hasSource ? &source : nullptr);
+			}
+
 			OpenGL_Model* result = Initialize(
-				move(nodeName),
-				move(vertices),
-				move(indices),
+				string(b.nodeName),
+				move(mesh),
 				context,
-				shader);
+				shader,
+				isQueued);
 				
 			models.push_back(result);
 		}
@@ -221,16 +564,42 @@ namespace GameTest::GameObject
 
 			return {};
 		}
+
+		vector<ModelBlock> blocks{};
+
+		string result = StreamFile(
+			modelPath,
+			modelTables,
+			blocks);
+		if (!result.empty())
+		{
+			Log::Print(
+				result,
+				"OPENGL_MODEL",
+				LogType::LOG_ERROR,
+				2);
+
+			return {};
+		}
 		
-		return {};
+		MeshFile file{};
+		file.path = modelPath;
+		file.tables = modelTables;
+
+		return InitializeBlocks(
+			move(blocks),
+			context,
+			shader,
+			false,
+			file);
 	}
 	
 	OpenGL_Model* OpenGL_Model::Initialize(
 		string name,
-		vector<Vertex> vertices,
-		vector<u32> indices,
+		shared_ptr<OpenGL_Mesh> mesh,
 		OpenGL_Context* context,
-		OpenGL_Shader* shader)
+		OpenGL_Shader* shader,
+		bool isQueued)
 	{
 		u32 newID = KalaWindowCore::GetGlobalID() + 1;
 		KalaWindowCore::SetGlobalID(newID);
@@ -245,15 +614,7 @@ namespace GameTest::GameObject
 			
 		modelPtr->render.shader = shader;
 		
-		modelPtr->render.vertices = move(vertices);
-		modelPtr->render.indices = move(indices);
-		
-		CreateModelGeometry(
-			modelPtr->render.vertices,
-			modelPtr->render.indices,
-			modelPtr->render.VAO,
-			modelPtr->render.VBO,
-			modelPtr->render.EBO);
+		modelPtr->render.mesh = move(mesh);
 
 		//always called, ignored internally if ubo is already assigned
 		InitializePointLightUBO(modelPtr->render.shader);
@@ -264,7 +625,8 @@ namespace GameTest::GameObject
 		
 		modelPtr->isInitialized = true;
 		
-		registry.AddContent(newID, move(newModel));
+		if (isQueued) registry.GetCommandBuffer().Create(newID, move(newModel));
+		else registry.AddContent(newID, move(newModel));
 		
 		Log::Print(
 			"Loaded model '" + name + "' with ID '" + to_string(newID) + "'!",
@@ -294,7 +656,18 @@ namespace GameTest::GameObject
             return false;
 		}
 		
-		if (!render.shader)
+		bool isAlpha = IsTransparent();
+
+		//opaque models write material data instead of lighting while the g-buffer is bound
+		bool isDeferred =
+			!isAlpha
+			&& DeferredRenderer::IsGeometryPassActive();
+
+		OpenGL_Shader* shader = isDeferred
+			? DeferredRenderer::GetGeometryShader()
+			: render.shader;
+
+		if (!shader)
 		{
 			Log::Print(
 				"Failed to render model '" + name + "' because its shader is invalid!",
@@ -305,10 +678,10 @@ namespace GameTest::GameObject
 			return false;
 		}
 
-		if (!render.shader->Bind())
+		if (!shader->Bind())
 		{
 			Log::Print(
-				"Failed to render model '" + name + "' because its shader '" + render.shader->GetName() + "' failed to bind!",
+				"Failed to render model '" + name + "' because its shader '" + shader->GetName() + "' failed to bind!",
 				"OPENGL_MODEL",
 				LogType::LOG_ERROR,
 				2);
@@ -322,24 +695,26 @@ namespace GameTest::GameObject
 
 		mat4 model = createumodel(pos, rot, size);
 
-		render.shader->SetMat4("uModel", model);
-		render.shader->SetMat4("uView", view);
-		render.shader->SetMat4("uProjection", projection);
+		shader->SetMat4("uModel", model);
+		shader->SetMat4("uView", view);
+		shader->SetMat4("uProjection", projection);
 		
-		render.shader->SetVec3("uViewPos", activeCameraPos);
-
-		bool isOpaque = isnear(render.opacity, 1.0f);
-		bool isTransparentDiffuseTex = 
-			render.diffuseTex
-			&& render.diffuseTex->GetFormat() == TextureFormat::Format_RGBA8;
-
-		bool isAlpha = 
-			!isOpaque 
-			|| isTransparentDiffuseTex;
+		//the weighted OIT pass owns the blend state, models only switch their outputs
+		bool isWeighted =
+			isAlpha
+			&& WeightedOIT::IsActive();
 
 		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
 
-		if (isAlpha)
+		//lighting uniforms only exist in the forward shader
+		if (!isDeferred)
+		{
+			shader->SetVec3("uViewPos", activeCameraPos);
+			shader->SetBool("uWeightedOIT", isWeighted);
+		}
+
+		if (isAlpha
+			&& !isWeighted)
 		{
 			coreFunc->glEnable(GL_BLEND);
 			coreFunc->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -348,105 +723,106 @@ namespace GameTest::GameObject
 
 		//diffuse data
 		
-		render.shader->SetVec3("uDiffuseColor", kclamp(render.diffuseColor, 0.0f, 1.0f));
+		shader->SetVec3("uDiffuseColor", kclamp(render.diffuseColor, 0.0f, 1.0f));
+		//textures that are still uploading sample the fallback texture
 		if (render.diffuseTex)
 		{
 			coreFunc->glActiveTexture(GL_TEXTURE0);
-			coreFunc->glBindTexture(GL_TEXTURE_2D, render.diffuseTex->GetTextureID());
-			render.shader->SetInt("uDiffuseTex", 0);
-			render.shader->SetBool("uHasDiffuseTex", true);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, render.diffuseTex->GetSampleID());
+			shader->SetInt("uDiffuseTex", 0);
+			shader->SetBool("uHasDiffuseTex", true);
 		}
-		else render.shader->SetBool("uHasDiffuseTex", false);
+		else shader->SetBool("uHasDiffuseTex", false);
 		
 		//normal data
 		
 		if (render.normalTex)
 		{
 			coreFunc->glActiveTexture(GL_TEXTURE1);
-			coreFunc->glBindTexture(GL_TEXTURE_2D, render.normalTex->GetTextureID());
-			render.shader->SetInt("uNormalTex", 1);
-			render.shader->SetBool("uHasNormalTex", true);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, render.normalTex->GetSampleID());
+			shader->SetInt("uNormalTex", 1);
+			shader->SetBool("uHasNormalTex", true);
 		}
-		else render.shader->SetBool("uHasNormalTex", false);
+		else shader->SetBool("uHasNormalTex", false);
 		
 		//specular data
 		
-		render.shader->SetVec3("uSpecularColor", kclamp(render.specularColor, 0.0f, 1.0f));
+		shader->SetVec3("uSpecularColor", kclamp(render.specularColor, 0.0f, 1.0f));
 		if (render.specularTex)
 		{
 			coreFunc->glActiveTexture(GL_TEXTURE2);
-			coreFunc->glBindTexture(GL_TEXTURE_2D, render.specularTex->GetTextureID());
-			render.shader->SetInt("uSpecularTex", 2);
-			render.shader->SetBool("uHasSpecularTex", true);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, render.specularTex->GetSampleID());
+			shader->SetInt("uSpecularTex", 2);
+			shader->SetBool("uHasSpecularTex", true);
 		}
-		else render.shader->SetBool("uHasSpecularTex", false);
+		else shader->SetBool("uHasSpecularTex", false);
 		
 		//emissive data
 		
-		render.shader->SetVec3( "uEmissiveColor", kclamp(render.emissiveColor, 0.0f, 1.0f));
+		shader->SetVec3( "uEmissiveColor", kclamp(render.emissiveColor, 0.0f, 1.0f));
 		if (render.emissiveTex)
 		{
 			coreFunc->glActiveTexture(GL_TEXTURE3);
-			coreFunc->glBindTexture(GL_TEXTURE_2D, render.emissiveTex->GetTextureID());
-			render.shader->SetInt("uEmissiveTex", 3);
-			render.shader->SetBool("uHasEmissiveTex", true);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, render.emissiveTex->GetSampleID());
+			shader->SetInt("uEmissiveTex", 3);
+			shader->SetBool("uHasEmissiveTex", true);
 		}
-		else render.shader->SetBool("uHasEmissiveTex", false);
+		else shader->SetBool("uHasEmissiveTex", false);
 
 		//other data
-		render.shader->SetFloat("uOpacity",   clamp(render.opacity, 0.0f, 1.0f));
-		render.shader->SetFloat("uShininess", clamp(render.shininess, 1.0f, 64.0f));
-		render.shader->SetBool("uTwoSided",   render.twoSided);
+		shader->SetFloat("uOpacity",   clamp(render.opacity, 0.0f, 1.0f));
+		shader->SetFloat("uShininess", clamp(render.shininess, 1.0f, 64.0f));
+		shader->SetBool("uTwoSided",   render.twoSided);
 		
-		u8 plCount = (u8)OpenGL_PointLight::GetRegistry().runtimeContent.size();
-		
-		if (plUBO != 0)
-		{
-			coreFunc->glBindBuffer(GL_UNIFORM_BUFFER, plUBO);
-
-			for (u8 i = 0; i < plCount; i++)
-			{
-				OpenGL_PointLight* pl = OpenGL_PointLight::GetRegistry().runtimeContent[i];
-
-				//skip invalid lights
-				if (!pl
-					|| !pl->CanRenderLight()
-					|| isnear(pl->GetIntensity())
-					|| isnear(pl->GetMaxRange()))
-				{
-					OpenGL_PointLight_Data data{};
-					data.canRender = 0;
+		//light data is uploaded once per frame by UploadPointLights
+		if (!isDeferred) shader->SetInt("uPointLightCount", plCount);
 
-					coreFunc->glBufferSubData(
-						GL_UNIFORM_BUFFER,
-						sizeof(OpenGL_PointLight_Data) * i,
-						sizeof(OpenGL_PointLight_Data),
-						&data);
+		const OpenGL_Mesh& mesh = *render.mesh;
 
-					continue;
-				}
-
-				coreFunc->glBufferSubData(
-					GL_UNIFORM_BUFFER,
-					sizeof(OpenGL_PointLight_Data) * i,
-					sizeof(OpenGL_PointLight_Data),
-					pl->GetDataPtr());
+		coreFunc->glBindVertexArray(mesh.GetVAO());
+		if (mesh.GetMeshlets().empty())
+		{
+			coreFunc->glDrawElements(
+				GL_TRIANGLES,
+				mesh.GetIndexCount(),
+				GL_UNSIGNED_INT,
+				0);
+		}
+		else
+		{
+			//back faces are culled by gl for every model, so only two-sided models keep theirs
+			MeshletCuller::Cull(
+				mesh.GetMeshlets(),
+				projection * view,
+				model,
+				activeCameraPos,
+				!render.twoSided,
+				meshletRanges,
+				&meshletStats);
+
+			meshletCounts.clear();
+			meshletOffsets.clear();
+
+			for (const MeshletDrawRange& range : meshletRanges)
+			{
+				meshletCounts.push_back(scast<GLsizei>(range.indexCount));
+				meshletOffsets.push_back(reinterpret_cast<const void*>(scast<uintptr_t>(range.firstIndex) * sizeof(u32)));
 			}
 
-			coreFunc->glBindBuffer(GL_UNIFORM_BUFFER, 0);
-			render.shader->SetInt("uPointLightCount", plCount);
+			if (!meshletCounts.empty())
+			{
+				OpenGL_Functions_Extra::GetGLExtra()->glMultiDrawElements(
+					GL_TRIANGLES,
+					meshletCounts.data(),
+					GL_UNSIGNED_INT,
+					meshletOffsets.data(),
+					scast<GLsizei>(meshletCounts.size()));
+			}
 		}
-		else render.shader->SetInt("uPointLightCount", 0);
-
-		coreFunc->glBindVertexArray(render.VAO);
-		coreFunc->glDrawElements(
-			GL_TRIANGLES,
-			render.indices.size(),
-			GL_UNSIGNED_INT,
-			0);
 		coreFunc->glBindVertexArray(0);
 
-		if (isAlpha)
+		if (isAlpha
+			&& !isWeighted)
 		{
 			coreFunc->glDisable(GL_BLEND);
 			coreFunc->glDepthMask(GL_TRUE);
@@ -457,6 +833,8 @@ namespace GameTest::GameObject
 
 	u32 OpenGL_Model::GetID() const { return ID; }
 
+	u64 OpenGL_Model::GetAssetHash() const { return render.mesh->GetAssetHash(); }
+
 	OpenGL_Context* OpenGL_Model::GetContext() const { return context; }
 
 	void OpenGL_Model::SetName(const string& newName)
@@ -473,8 +851,30 @@ namespace GameTest::GameObject
 	void OpenGL_Model::SetUpdateState(bool newValue) { render.canUpdate = newValue; }
 	bool OpenGL_Model::CanUpdate() const { return render.canUpdate; }
 
-	const vector<Vertex>& OpenGL_Model::GetVertices() const { return render.vertices; }
-	const vector<u32>& OpenGL_Model::GetIndices() const { return render.indices; }
+	void OpenGL_Model::SetStaticState(bool newValue) { render.isStatic = newValue; }
+	bool OpenGL_Model::IsStatic() const { return render.isStatic; }
+
+	const shared_ptr<OpenGL_Mesh>& OpenGL_Model::GetMesh() const { return render.mesh; }
+
+	void OpenGL_Model::SetCpuAccess(bool newValue)
+	{
+		if (render.hasCpuAccess == newValue) return;
+
+		render.hasCpuAccess = newValue;
+
+		if (newValue) render.mesh->AddCpuAccess();
+		else render.mesh->RemoveCpuAccess();
+	}
+	bool OpenGL_Model::HasCpuAccess() const { return render.hasCpuAccess; }
+
+	u32 OpenGL_Model::GetVertexCount() const { return render.mesh->GetVertexCount(); }
+	u32 OpenGL_Model::GetIndexCount() const { return render.mesh->GetIndexCount(); }
+
+	const vector<Vertex>& OpenGL_Model::GetVertices() const { return render.mesh->GetVertices(); }
+	const vector<u32>& OpenGL_Model::GetIndices() const { return render.mesh->GetIndices(); }
+
+	const vector<Meshlet>& OpenGL_Model::GetMeshlets() const { return render.mesh->GetMeshlets(); }
+	const MeshletCullStats& OpenGL_Model::GetMeshletStats() const { return meshletStats; }
 
 	vec3 OpenGL_Model::GetFront() { return getdirfront(transform); }
 	vec3 OpenGL_Model::GetRight() { return getdirright(transform); }
@@ -567,6 +967,9 @@ namespace GameTest::GameObject
 			type);
 	}
 
+	void OpenGL_Model::SetTransform(const Transform3D& newTransform) { transform = newTransform; }
+	const Transform3D& OpenGL_Model::GetTransform() const { return transform; }
+
 	void OpenGL_Model::SetNormalizedDiffuseColor(const vec3& newValue)
 	{
 		render.diffuseColor = kclamp(newValue, 0.0f, 1.0f);
@@ -601,10 +1004,21 @@ namespace GameTest::GameObject
 	}
 	f32 OpenGL_Model::GetOpacity() const { return render.opacity; }
 
-	u32 OpenGL_Model::GetVAO() const { return render.VAO; }
-	u32 OpenGL_Model::GetVBO() const { return render.VBO; }
-	u32 OpenGL_Model::GetEBO() const { return render.EBO; }
+	bool OpenGL_Model::IsTransparent() const
+	{
+		bool isTransparentDiffuseTex =
+			render.diffuseTex
+			&& render.diffuseTex->GetFormat() == TextureFormat::Format_RGBA8;
+
+		return !isnear(render.opacity, 1.0f)
+			|| isTransparentDiffuseTex;
+	}
+
+	u32 OpenGL_Model::GetVAO() const { return render.mesh->GetVAO(); }
+	u32 OpenGL_Model::GetVBO() const { return render.mesh->GetVBO(); }
+	u32 OpenGL_Model::GetEBO() const { return render.mesh->GetEBO(); }
 
+	OpenGL_Shader* OpenGL_Model::GetShader() { return render.shader; }
 	const OpenGL_Shader* OpenGL_Model::GetShader() const { return render.shader; }
 
 	void OpenGL_Model::SetDiffuseTexture(OpenGL_Texture* newTexture)
@@ -617,6 +1031,42 @@ namespace GameTest::GameObject
 	}
 	void OpenGL_Model::ClearDiffuseTexture() { render.diffuseTex = nullptr; }
 	const OpenGL_Texture* OpenGL_Model::GetDiffuseTexture() const { return render.diffuseTex; }
+
+	bool OpenGL_Model::HasSameMaterial(const OpenGL_Model& other) const
+	{
+		const OpenGL_Model_Render& a = render;
+		const OpenGL_Model_Render& b = other.render;
+
+		return a.shader == b.shader
+			&& a.diffuseTex == b.diffuseTex
+			&& a.normalTex == b.normalTex
+			&& a.specularTex == b.specularTex
+			&& a.emissiveTex == b.emissiveTex
+			&& a.twoSided == b.twoSided
+			&& isnear(a.opacity, b.opacity)
+			&& isnear(a.shininess, b.shininess)
+			&& isnear(a.diffuseColor, b.diffuseColor)
+			&& isnear(a.specularColor, b.specularColor)
+			&& isnear(a.emissiveColor, b.emissiveColor);
+	}
+	void OpenGL_Model::CopyMaterial(const OpenGL_Model& other)
+	{
+		const OpenGL_Model_Render& source = other.render;
+
+		render.opacity = source.opacity;
+		render.shininess = source.shininess;
+		render.twoSided = source.twoSided;
+
+		render.shader = source.shader;
+
+		render.diffuseTex = source.diffuseTex;
+		render.diffuseColor = source.diffuseColor;
+		render.normalTex = source.normalTex;
+		render.specularTex = source.specularTex;
+		render.specularColor = source.specularColor;
+		render.emissiveTex = source.emissiveTex;
+		render.emissiveColor = source.emissiveColor;
+	}
 	
 	OpenGL_Model::~OpenGL_Model()
 	{
@@ -636,23 +1086,10 @@ namespace GameTest::GameObject
 			"OPENGL_MODEL",
 			LogType::LOG_INFO);
 
-		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+		if (render.hasCpuAccess) render.mesh->RemoveCpuAccess();
 
-		if (render.VAO != 0)
-		{
-			coreFunc->glDeleteVertexArrays(1, &render.VAO);
-			render.VAO = 0;
-		}
-		if (render.VBO != 0)
-		{
-			coreFunc->glDeleteBuffers(1, &render.VBO);
-			render.VBO = 0;
-		}
-		if (render.EBO != 0)
-		{
-			coreFunc->glDeleteBuffers(1, &render.EBO);
-			render.EBO = 0;
-		}
+		//the buffers go with the mesh once no other model draws it
+		render.mesh.reset();
 	}
 
 	void OpenGL_Model::InitializePointLightUBO(OpenGL_Shader* shader)
@@ -702,72 +1139,105 @@ namespace GameTest::GameObject
 	}
 }
 
-void CreateModelGeometry(
-	const vector<Vertex>& vertices,
-	const vector<u32>& indices,
-	u32& outVAO,
-	u32& outVBO,
-	u32& outEBO)
+ImportResult ImportUncachedBlocks(
+	const vector<u8>& data,
+	u64 fileHash,
+	vector<ModelBlock>& outBlocks,
+	vector<ModelTable>& outTables)
 {
-	if (vertices.empty()
-		|| indices.empty())
+	if (data.size() < MIN_TOTAL_SIZE
+		|| data.size() > MAX_TOTAL_SIZE)
 	{
-		KalaWindowCore::ForceClose(
-			"OpenGL model error",
-			"Failed to create model geometry because vertices or indices were empty");
+		return ImportResult::RESULT_UNSUPPORTED_FILE_SIZE;
 	}
 
-	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
-	
-	coreFunc->glGenVertexArrays(1, &outVAO);
-	coreFunc->glGenBuffers(1, &outVBO);
-	coreFunc->glGenBuffers(1, &outEBO);
-	
-	coreFunc->glBindVertexArray(outVAO);
-	
-	//VBO
-	coreFunc->glBindBuffer(GL_ARRAY_BUFFER, outVBO);
-	coreFunc->glBufferData(
-		GL_ARRAY_BUFFER,
-		vertices.size() * sizeof(Vertex),
-		vertices.data(),
-		GL_STATIC_DRAW);
-		
-	//EBO
-	coreFunc->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, outEBO);
-	coreFunc->glBufferData(
-		GL_ELEMENT_ARRAY_BUFFER,
-		indices.size() * sizeof(u32),
-		indices.data(),
-		GL_STATIC_DRAW);
-		
-	//position - layout 0
-	coreFunc->glEnableVertexAttribArray(0);
-	coreFunc->glVertexAttribPointer(
-		0, 3, GL_FLOAT, GL_FALSE,
-		sizeof(Vertex),
-		(void*)offsetof(Vertex, position));
-		
-	//normal - layout 1
-	coreFunc->glEnableVertexAttribArray(1);
-	coreFunc->glVertexAttribPointer(
-		1, 3, GL_FLOAT, GL_FALSE,
-		sizeof(Vertex),
-		(void*)offsetof(Vertex, normal));
-		
-	//texcoord - layout 2
-	coreFunc->glEnableVertexAttribArray(2);
-	coreFunc->glVertexAttribPointer(
-		2, 2, GL_FLOAT, GL_FALSE,
-		sizeof(Vertex),
-		(void*)offsetof(Vertex, texCoord));
-		
-	//tangent - layout 3
-	coreFunc->glEnableVertexAttribArray(3);
-	coreFunc->glVertexAttribPointer(
-		3, 4, GL_FLOAT, GL_FALSE,
-		sizeof(Vertex),
-		(void*)offsetof(Vertex, tangent));
-		
-	coreFunc->glBindVertexArray(0);
-}
\ No newline at end of file
+	ModelHeader header{};
+
+	ImportResult headerResult = ParseHeaderData(data.data(), header);
+	if (headerResult != ImportResult::RESULT_SUCCESS) return headerResult;
+
+	size_t blockRegionStart = CORRECT_MODEL_HEADER_SIZE + header.modelTablesSize;
+	if (blockRegionStart + header.modelBlocksSize > data.size())
+	{
+		return ImportResult::RESULT_UNEXPECTED_EOF;
+	}
+
+	vector<ModelTable> tables{};
+
+	ParseTableData(
+		data.data() + CORRECT_MODEL_HEADER_SIZE,
+		header,
+		tables);
+
+	vector<u8> isCached(tables.size());
+	vector<ModelTable> uncachedTables{};
+
+	for (size_t i = 0; i < tables.size(); ++i)
+	{
+		const ModelTable& t = tables[i];
+
+		//only the mesh name and vertex size are read from blocks that may be skipped
+		if (u64{ t.blockOffset } + VERTICE_DATA_OFFSET > data.size()) return ImportResult::RESULT_UNEXPECTED_EOF;
+
+		const u8* block = data.data() + t.blockOffset;
+
+		u32 verticesSize{};
+		memcpy(&verticesSize, block + BLOCK_VERTICES_SIZE_OFFSET, sizeof(verticesSize));
+
+		u64 key = OpenGL_Mesh::MakeKey(
+			fileHash,
+			t.blockOffset,
+			string_view(rcast<const char*>(block + BLOCK_MESH_NAME_OFFSET), BLOCK_NAME_SIZE));
+
+		//a cached mesh of another size is read again so InitializeBlocks can report and replace it
+		shared_ptr<OpenGL_Mesh> mesh = OpenGL_Mesh::Find(key);
+		isCached[i] = mesh
+			&& mesh->GetVertexCount() == verticesSize / sizeof(Vertex);
+
+		if (!isCached[i]) uncachedTables.push_back(t);
+	}
+
+	vector<ModelBlock> parsedBlocks{};
+
+	try
+	{
+		ImportResult blockResult = ParseBlockData(
+			data.data() + blockRegionStart,
+			header.modelBlocksSize,
+			blockRegionStart,
+			uncachedTables,
+			parsedBlocks);
+
+		if (blockResult != ImportResult::RESULT_SUCCESS) return blockResult;
+	}
+	catch (...)
+	{
+		return ImportResult::RESULT_UNEXPECTED_EOF;
+	}
+
+	vector<ModelBlock> blocks{};
+	blocks.reserve(tables.size());
+
+	size_t nextParsed{};
+	for (size_t i = 0; i < tables.size(); ++i)
+	{
+		if (!isCached[i])
+		{
+			blocks.push_back(move(parsedBlocks[nextParsed++]));
+			continue;
+		}
+
+		const u8* block = data.data() + tables[i].blockOffset;
+
+		ModelBlock& b = blocks.emplace_back();
+		memcpy(b.nodeName, tables[i].nodeName, sizeof(b.nodeName));
+		memcpy(b.meshName, block + BLOCK_MESH_NAME_OFFSET, sizeof(b.meshName));
+		memcpy(&b.verticesSize, block + BLOCK_VERTICES_SIZE_OFFSET, sizeof(b.verticesSize));
+		memcpy(&b.indicesSize, block + BLOCK_INDICES_SIZE_OFFSET, sizeof(b.indicesSize));
+	}
+
+	outBlocks = move(blocks);
+	outTables = move(tables);
+
+	return ImportResult::RESULT_SUCCESS;
+}
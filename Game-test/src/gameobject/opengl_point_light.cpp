@@ -15,12 +15,12 @@
 #include "opengl/kw_opengl_functions_core.hpp"
 
 #include "gameobject/opengl_point_light.hpp"
+#include "gameobject/opengl_mesh.hpp"
 
 using KalaHeaders::KalaLog::Log;
 using KalaHeaders::KalaLog::LogType;
 using KalaHeaders::KalaMath::vec3;
 using KalaHeaders::KalaMath::mat4;
-using KalaHeaders::KalaMath::isnear;
 using KalaHeaders::KalaMath::kclamp;
 using KalaHeaders::KalaMath::addpos;
 using KalaHeaders::KalaMath::setpos;
@@ -41,6 +41,8 @@ using KalaWindow::OpenGL::OpenGL_Global;
 using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
 using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
 
+using GameTest::GameObject::OpenGL_Mesh;
+
 using std::string;
 using std::to_string;
 using std::vector;
@@ -112,12 +114,13 @@ namespace GameTest::GameObject
 		{
 			lightPtr->render.shader = shader;
 		
-			lightPtr->render.vertices = move(vertices);
-			lightPtr->render.indices = move(indices);
+			lightPtr->render.vertexCount = scast<u32>(vertices.size());
+			lightPtr->render.indexCount = scast<u32>(indices.size());
 			
+			//the cpu copy is dropped once it is uploaded
 			CreateLightGeometry(
-				lightPtr->render.vertices,
-				lightPtr->render.indices,
+				vertices,
+				indices,
 				lightPtr->render.VAO,
 				lightPtr->render.VBO,
 				lightPtr->render.EBO);
@@ -141,93 +144,6 @@ namespace GameTest::GameObject
 
 	bool OpenGL_PointLight::IsInitialized() const { return isInitialized; }
 	
-	bool OpenGL_PointLight::Render(
-		const mat4& view,
-		const mat4& projection)
-	{
-		if (!render.canUpdate
-			|| render.vertices.empty()
-			|| render.indices.empty())
-		{
-			return false;
-		}
-		
-		if (!OpenGL_Global::IsContextValid(context))
-		{
-			Log::Print(
-                "Failed to render point light '" + name + "' because its gl context is invalid!",
-                "OPENGL_POINT_LIGHT",
-                LogType::LOG_ERROR,
-                2);
-
-            return false;
-		}
-		
-		if (!render.shader)
-		{
-			Log::Print(
-				"Failed to render point light '" + name + "' because its shader is invalid!",
-				"OPENGL_POINT_LIGHT",
-				LogType::LOG_ERROR,
-				2);
-
-			return false;
-		}
-
-		if (!render.shader->Bind())
-		{
-			Log::Print(
-				"Failed to render point light '" + name + "' because its shader '" + render.shader->GetName() + "' failed to bind!",
-				"OPENGL_POINT_LIGHT",
-				LogType::LOG_ERROR,
-				2);
-
-			return false;
-		}
-		
-		u32 programID = render.shader->GetProgramID();
-
-		vec3 pos = GetPos(PosTarget::POS_COMBINED);
-		quat rot = GetRotQuat(RotTarget::ROT_COMBINED);
-		vec3 size = GetSize(SizeTarget::SIZE_COMBINED);
-		
-		mat4 model = createumodel(pos, rot, size);
-
-		render.shader->SetMat4("uModel", model);
-		render.shader->SetMat4("uView", view);
-		render.shader->SetMat4("uProjection", projection);
-
-		bool isAlpha = isnear(render.opacity, 1.0f);
-
-		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
-
-		if (isAlpha)
-		{
-			coreFunc->glEnable(GL_BLEND);
-			coreFunc->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-			coreFunc->glDepthMask(GL_FALSE);
-		}
-
-		render.shader->SetVec3("uColor", render.color);
-		render.shader->SetFloat("uOpacity", render.opacity);
-
-		coreFunc->glBindVertexArray(render.VAO);
-		coreFunc->glDrawElements(
-			GL_TRIANGLES,
-			render.indices.size(),
-			GL_UNSIGNED_INT,
-			0);
-		coreFunc->glBindVertexArray(0);
-
-		if (isAlpha)
-		{
-			coreFunc->glDisable(GL_BLEND);
-			coreFunc->glDepthMask(GL_TRUE);
-		}
-
-		return true;
-	}
-
 	u32 OpenGL_PointLight::GetID() const { return ID; }
 
 	OpenGL_Context* OpenGL_PointLight::GetContext() const { return context; }
@@ -256,8 +172,37 @@ namespace GameTest::GameObject
 	}
 	bool OpenGL_PointLight::CanRenderLight() const { return data.canRender; }
 
-	const vector<vec3>& OpenGL_PointLight::GetVertices() const { return render.vertices; }
-	const vector<u32>& OpenGL_PointLight::GetIndices() const { return render.indices; }
+	u32 OpenGL_PointLight::GetVertexCount() const { return render.vertexCount; }
+	u32 OpenGL_PointLight::GetIndexCount() const { return render.indexCount; }
+
+	vector<vec3> OpenGL_PointLight::GetVertices() const
+	{
+		vector<vec3> vertices(render.vertexCount);
+		if (vertices.empty()
+			|| !OpenGL_Mesh::ReadBuffer(
+				render.VBO,
+				vertices.size() * sizeof(vec3),
+				vertices.data()))
+		{
+			return {};
+		}
+
+		return vertices;
+	}
+	vector<u32> OpenGL_PointLight::GetIndices() const
+	{
+		vector<u32> indices(render.indexCount);
+		if (indices.empty()
+			|| !OpenGL_Mesh::ReadBuffer(
+				render.EBO,
+				indices.size() * sizeof(u32),
+				indices.data()))
+		{
+			return {};
+		}
+
+		return indices;
+	}
 	
 	vec3 OpenGL_PointLight::GetFront() { return getdirfront(transform); }
 	vec3 OpenGL_PointLight::GetRight() { return getdirright(transform); }
@@ -358,6 +303,16 @@ namespace GameTest::GameObject
 			type);
 	}
 
+	void OpenGL_PointLight::SetTransform(const Transform3D& newTransform)
+	{
+		transform = newTransform;
+
+		data.pos = getpos(
+			transform,
+			PosTarget::POS_COMBINED);
+	}
+	const Transform3D& OpenGL_PointLight::GetTransform() const { return transform; }
+
 	void OpenGL_PointLight::SetNormalizedDebugColor(const vec3& newValue)
 	{
 		render.color = kclamp(newValue, 0.0f, 1.0f);
@@ -460,6 +415,14 @@ namespace GameTest::GameObject
 	}
 	f32 OpenGL_PointLight::GetQuadratic() const { return data.quadratic; }
 
+	void OpenGL_PointLight::SetData(const OpenGL_PointLight_Data& newData)
+	{
+		data = newData;
+
+		data.pos = getpos(
+			transform,
+			PosTarget::POS_COMBINED);
+	}
 	const OpenGL_PointLight_Data* OpenGL_PointLight::GetDataPtr() const { return &data; }
 
 	OpenGL_PointLight::~OpenGL_PointLight()
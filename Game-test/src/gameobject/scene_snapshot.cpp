@@ -0,0 +1,389 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstring>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "gameobject/scene_snapshot.hpp"
+#include "gameobject/opengl_model.hpp"
+#include "gameobject/opengl_point_light.hpp"
+#include "gameobject/camera.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::quat;
+using KalaHeaders::KalaMath::Transform3D;
+
+using GameTest::GameObject::SceneSnapshot;
+using GameTest::GameObject::SceneSnapshotReader;
+using GameTest::GameObject::SceneSnapshotData;
+using GameTest::GameObject::SceneTransformRecord;
+using GameTest::GameObject::SceneModelRecord;
+using GameTest::GameObject::SceneLightRecord;
+using GameTest::GameObject::SceneCameraRecord;
+using GameTest::GameObject::OpenGL_Model;
+using GameTest::GameObject::OpenGL_PointLight;
+using GameTest::GameObject::OpenGL_PointLight_Data;
+using GameTest::GameObject::Camera;
+using GameTest::GameObject::KSN_MODEL_FLAG_STATIC;
+using GameTest::GameObject::KSN_MODEL_FLAG_CAN_UPDATE;
+using GameTest::GameObject::KSN_LIGHT_FLAG_DEBUG_SHAPE;
+using GameTest::GameObject::KSN_LIGHT_DATA_FLOATS;
+
+using std::string;
+using std::string_view;
+using std::to_string;
+using std::vector;
+using std::unordered_map;
+using std::memcpy;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+using std::filesystem::path;
+
+static_assert(sizeof(OpenGL_PointLight_Data) == KSN_LIGHT_DATA_FLOATS * sizeof(f32));
+
+static SceneTransformRecord PackTransform(const Transform3D& transform);
+static Transform3D UnpackTransform(const SceneTransformRecord& record);
+
+static void PackVec3(
+	const vec3& value,
+	f32 (&out)[3]);
+static vec3 UnpackVec3(const f32 (&value)[3]);
+
+static void CaptureScene(SceneSnapshotData& data);
+
+//Returns how many model records had no live model with the same asset hash
+static u32 ApplyModels(const SceneSnapshotReader& reader);
+static void ApplyLights(const SceneSnapshotReader& reader);
+static void ApplyCameras(const SceneSnapshotReader& reader);
+
+static f64 GetMilliseconds(steady_clock::time_point start);
+
+namespace GameTest::GameObject
+{
+	string SceneSnapshot::Save(const path& snapshotPath)
+	{
+		auto start = steady_clock::now();
+
+		SceneSnapshotData data{};
+		CaptureScene(data);
+
+		string result = Write(snapshotPath, data);
+		if (!result.empty()) return result;
+
+		Log::Print(
+			"Saved " + to_string(data.models.size()) + " models, "
+			+ to_string(data.lights.size()) + " lights and "
+			+ to_string(data.cameras.size()) + " cameras to '" + snapshotPath.string()
+			+ "' in " + to_string(GetMilliseconds(start)) + " ms.",
+			"SCENE_SNAPSHOT",
+			LogType::LOG_SUCCESS);
+
+		return {};
+	}
+
+	string SceneSnapshot::Load(const path& snapshotPath)
+	{
+		auto start = steady_clock::now();
+
+		SceneSnapshotReader reader{};
+
+		string result = reader.Open(snapshotPath);
+		if (!result.empty()) return result;
+
+		u32 missing = ApplyModels(reader);
+		ApplyLights(reader);
+		ApplyCameras(reader);
+
+		if (missing > 0)
+		{
+			Log::Print(
+				to_string(missing) + " models in scene snapshot '" + snapshotPath.string()
+				+ "' were skipped because no loaded model has their asset hash!",
+				"SCENE_SNAPSHOT",
+				LogType::LOG_WARNING);
+		}
+
+		Log::Print(
+			"Loaded " + to_string(reader.GetHeader().modelCount) + " models, "
+			+ to_string(reader.GetHeader().lightCount) + " lights and "
+			+ to_string(reader.GetHeader().cameraCount) + " cameras from '" + snapshotPath.string()
+			+ "' in " + to_string(GetMilliseconds(start)) + " ms.",
+			"SCENE_SNAPSHOT",
+			LogType::LOG_SUCCESS);
+
+		return {};
+	}
+}
+
+void CaptureScene(SceneSnapshotData& data)
+{
+	const vector<OpenGL_Model*>& models = OpenGL_Model::GetRegistry().runtimeContent;
+	const vector<OpenGL_PointLight*>& lights = OpenGL_PointLight::GetRegistry().runtimeContent;
+	const vector<Camera*>& cameras = Camera::GetRegistry().runtimeContent;
+
+	data.models.resize(models.size());
+	data.lights.resize(lights.size());
+	data.cameras.resize(cameras.size());
+
+	for (size_t i = 0; i < models.size(); ++i)
+	{
+		OpenGL_Model* model = models[i];
+		SceneModelRecord& record = data.models[i];
+
+		const string& name = model->GetName();
+		record.nameOffset = data.AddString(name);
+		record.nameLength = scast<u32>(name.size());
+
+		record.assetHash = model->GetAssetHash();
+
+		if (model->IsStatic()) record.flags |= KSN_MODEL_FLAG_STATIC;
+		if (model->CanUpdate()) record.flags |= KSN_MODEL_FLAG_CAN_UPDATE;
+
+		record.opacity = model->GetOpacity();
+		PackVec3(model->GetNormalizedDiffuseColor(), record.diffuseColor);
+
+		record.transform = PackTransform(model->GetTransform());
+	}
+
+	for (size_t i = 0; i < lights.size(); ++i)
+	{
+		OpenGL_PointLight* light = lights[i];
+		SceneLightRecord& record = data.lights[i];
+
+		const string& name = light->GetName();
+		record.nameOffset = data.AddString(name);
+		record.nameLength = scast<u32>(name.size());
+
+		if (light->CanRenderDebugShape()) record.flags |= KSN_LIGHT_FLAG_DEBUG_SHAPE;
+
+		record.debugOpacity = light->GetOpacity();
+		PackVec3(light->GetNormalizedDebugColor(), record.debugColor);
+
+		memcpy(record.data, light->GetDataPtr(), sizeof(record.data));
+
+		record.transform = PackTransform(light->GetTransform());
+	}
+
+	for (size_t i = 0; i < cameras.size(); ++i)
+	{
+		Camera* camera = cameras[i];
+		SceneCameraRecord& record = data.cameras[i];
+
+		const string& name = camera->GetName();
+		record.nameOffset = data.AddString(name);
+		record.nameLength = scast<u32>(name.size());
+
+		PackVec3(camera->GetPos(), record.pos);
+		PackVec3(camera->GetRot(), record.rot);
+
+		record.fov = camera->GetFOV();
+		record.speed = camera->GetSpeed();
+		record.nearClip = camera->GetNearClip();
+		record.farClip = camera->GetFarClip();
+		record.sensitivity = camera->GetSensitivity();
+	}
+}
+
+u32 ApplyModels(const SceneSnapshotReader& reader)
+{
+	auto& registry = OpenGL_Model::GetRegistry();
+
+	//live models per asset hash in registry order, the first record of a hash claims the first model
+	unordered_map<u64, vector<OpenGL_Model*>> liveModels{};
+	liveModels.reserve(registry.runtimeContent.size());
+
+	for (OpenGL_Model* model : registry.runtimeContent)
+	{
+		liveModels[model->GetAssetHash()].push_back(model);
+	}
+
+	unordered_map<u64, size_t> claimedCounts{};
+	claimedCounts.reserve(liveModels.size());
+
+	u32 missing{};
+
+	const SceneModelRecord* records = reader.GetModels();
+	for (u32 i = 0; i < reader.GetHeader().modelCount; ++i)
+	{
+		const SceneModelRecord& record = records[i];
+
+		auto live = liveModels.find(record.assetHash);
+		if (live == liveModels.end())
+		{
+			++missing;
+			continue;
+		}
+
+		size_t& claimed = claimedCounts[record.assetHash];
+		string_view name = reader.GetString(record.nameOffset, record.nameLength);
+
+		OpenGL_Model* model{};
+
+		if (claimed < live->second.size())
+		{
+			model = live->second[claimed++];
+			if (model->GetName() != name) model->SetName(string(name));
+		}
+		else
+		{
+			//more records than live models of this asset, the extra ones share the mesh of the first live model
+			model = OpenGL_Model::InitializeInstance(
+				string(name),
+				*live->second.front(),
+				true);
+
+			if (!model)
+			{
+				++missing;
+				continue;
+			}
+		}
+
+		model->SetTransform(UnpackTransform(record.transform));
+		model->SetStaticState(record.flags & KSN_MODEL_FLAG_STATIC);
+		model->SetUpdateState(record.flags & KSN_MODEL_FLAG_CAN_UPDATE);
+		model->SetOpacity(record.opacity);
+		model->SetNormalizedDiffuseColor(UnpackVec3(record.diffuseColor));
+	}
+
+	//live models the snapshot has no record for are not part of the restored scene
+	auto& commands = registry.GetCommandBuffer();
+
+	for (const auto& [hash, models] : liveModels)
+	{
+		auto claimed = claimedCounts.find(hash);
+		size_t first = claimed != claimedCounts.end() ? claimed->second : 0;
+
+		for (size_t i = first; i < models.size(); ++i) commands.Destroy(models[i]);
+	}
+
+	return missing;
+}
+
+void ApplyLights(const SceneSnapshotReader& reader)
+{
+	const vector<OpenGL_PointLight*>& lights = OpenGL_PointLight::GetRegistry().runtimeContent;
+	const SceneLightRecord* records = reader.GetLights();
+
+	u32 count = scast<u32>(lights.size()) < reader.GetHeader().lightCount
+		? scast<u32>(lights.size())
+		: reader.GetHeader().lightCount;
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		OpenGL_PointLight* light = lights[i];
+		const SceneLightRecord& record = records[i];
+
+		string_view name = reader.GetString(record.nameOffset, record.nameLength);
+		if (light->GetName() != name) light->SetName(string(name));
+
+		//transform first, SetData takes the light position from it
+		light->SetTransform(UnpackTransform(record.transform));
+
+		OpenGL_PointLight_Data data{};
+		memcpy(static_cast<void*>(&data), record.data, sizeof(record.data));
+		light->SetData(data);
+
+		light->SetRenderDebugShapeState(record.flags & KSN_LIGHT_FLAG_DEBUG_SHAPE);
+		light->SetOpacity(record.debugOpacity);
+		light->SetNormalizedDebugColor(UnpackVec3(record.debugColor));
+	}
+}
+
+void ApplyCameras(const SceneSnapshotReader& reader)
+{
+	const vector<Camera*>& cameras = Camera::GetRegistry().runtimeContent;
+	const SceneCameraRecord* records = reader.GetCameras();
+
+	u32 count = scast<u32>(cameras.size()) < reader.GetHeader().cameraCount
+		? scast<u32>(cameras.size())
+		: reader.GetHeader().cameraCount;
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		Camera* camera = cameras[i];
+		const SceneCameraRecord& record = records[i];
+
+		string_view name = reader.GetString(record.nameOffset, record.nameLength);
+		if (camera->GetName() != name) camera->SetName(string(name));
+
+		camera->SetPos(UnpackVec3(record.pos));
+		camera->SetRot(UnpackVec3(record.rot));
+
+		camera->SetFOV(record.fov);
+		camera->SetSpeed(record.speed);
+		camera->SetNearClip(record.nearClip);
+		camera->SetFarClip(record.farClip);
+		camera->SetSensitivity(record.sensitivity);
+	}
+}
+
+SceneTransformRecord PackTransform(const Transform3D& transform)
+{
+	SceneTransformRecord record{};
+
+	const vec3* positions[3] = { &transform.pos_world, &transform.pos_local, &transform.pos_combined };
+	const quat* rotations[3] = { &transform.rot_world, &transform.rot_local, &transform.rot_combined };
+	const vec3* sizes[3] = { &transform.size_world, &transform.size_local, &transform.size_combined };
+
+	for (u32 i = 0; i < 3; ++i)
+	{
+		PackVec3(*positions[i], record.pos[i]);
+		PackVec3(*sizes[i], record.size[i]);
+
+		record.rot[i][0] = rotations[i]->w;
+		record.rot[i][1] = rotations[i]->x;
+		record.rot[i][2] = rotations[i]->y;
+		record.rot[i][3] = rotations[i]->z;
+	}
+
+	return record;
+}
+
+Transform3D UnpackTransform(const SceneTransformRecord& record)
+{
+	Transform3D transform{};
+
+	vec3* positions[3] = { &transform.pos_world, &transform.pos_local, &transform.pos_combined };
+	quat* rotations[3] = { &transform.rot_world, &transform.rot_local, &transform.rot_combined };
+	vec3* sizes[3] = { &transform.size_world, &transform.size_local, &transform.size_combined };
+
+	for (u32 i = 0; i < 3; ++i)
+	{
+		*positions[i] = UnpackVec3(record.pos[i]);
+		*sizes[i] = UnpackVec3(record.size[i]);
+		*rotations[i] = quat(record.rot[i]);
+	}
+
+	return transform;
+}
+
+void PackVec3(
+	const vec3& value,
+	f32 (&out)[3])
+{
+	out[0] = value.x;
+	out[1] = value.y;
+	out[2] = value.z;
+}
+
+vec3 UnpackVec3(const f32 (&value)[3])
+{
+	return vec3(value[0], value[1], value[2]);
+}
+
+f64 GetMilliseconds(steady_clock::time_point start)
+{
+	return duration<f64, std::milli>(steady_clock::now() - start).count();
+}
@@ -0,0 +1,238 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <system_error>
+#include <cstring>
+
+#include "KalaHeaders/core_utils.hpp"
+
+#include "core/content_hash.hpp"
+#include "core/mapped_file.hpp"
+#include "gameobject/scene_snapshot.hpp"
+
+using GameTest::Core::ContentHash;
+using GameTest::Core::FileMapping;
+using GameTest::GameObject::SceneSnapshot;
+using GameTest::GameObject::SceneSnapshotReader;
+using GameTest::GameObject::SceneSnapshotData;
+using GameTest::GameObject::SceneSnapshotHeader;
+using GameTest::GameObject::SceneModelRecord;
+using GameTest::GameObject::SceneLightRecord;
+using GameTest::GameObject::SceneCameraRecord;
+using GameTest::GameObject::KSN_MAGIC;
+using GameTest::GameObject::KSN_VERSION;
+using GameTest::GameObject::KSN_HEADER_SIZE;
+using GameTest::GameObject::KSN_SECTION_ALIGNMENT;
+
+using std::string;
+using std::string_view;
+using std::to_string;
+using std::vector;
+using std::ofstream;
+using std::ios;
+using std::streamsize;
+using std::error_code;
+using std::memcpy;
+using std::filesystem::path;
+using std::filesystem::rename;
+using std::filesystem::remove;
+
+static u64 AlignSection(u64 offset);
+
+//True if count records of recordSize starting at offset fit inside the file
+static bool IsSectionValid(
+	u64 offset,
+	u64 count,
+	u64 recordSize,
+	u64 fileSize);
+
+namespace GameTest::GameObject
+{
+	string SceneSnapshot::Write(
+		const path& snapshotPath,
+		const SceneSnapshotData& data)
+	{
+		SceneSnapshotHeader header{};
+		header.modelCount = scast<u32>(data.models.size());
+		header.lightCount = scast<u32>(data.lights.size());
+		header.cameraCount = scast<u32>(data.cameras.size());
+		header.stringTableSize = scast<u32>(data.strings.size());
+
+		header.modelsOffset = AlignSection(KSN_HEADER_SIZE);
+		header.lightsOffset = AlignSection(header.modelsOffset + data.models.size() * sizeof(SceneModelRecord));
+		header.camerasOffset = AlignSection(header.lightsOffset + data.lights.size() * sizeof(SceneLightRecord));
+		header.stringTableOffset = AlignSection(header.camerasOffset + data.cameras.size() * sizeof(SceneCameraRecord));
+
+		u64 totalSize = header.stringTableOffset + data.strings.size();
+
+		//the whole file is built in memory so it reaches the disk in one write
+		vector<u8> buffer(scast<size_t>(totalSize));
+
+		if (!data.models.empty())
+		{
+			memcpy(
+				buffer.data() + header.modelsOffset,
+				data.models.data(),
+				data.models.size() * sizeof(SceneModelRecord));
+		}
+		if (!data.lights.empty())
+		{
+			memcpy(
+				buffer.data() + header.lightsOffset,
+				data.lights.data(),
+				data.lights.size() * sizeof(SceneLightRecord));
+		}
+		if (!data.cameras.empty())
+		{
+			memcpy(
+				buffer.data() + header.camerasOffset,
+				data.cameras.data(),
+				data.cameras.size() * sizeof(SceneCameraRecord));
+		}
+		if (!data.strings.empty())
+		{
+			memcpy(
+				buffer.data() + header.stringTableOffset,
+				data.strings.data(),
+				data.strings.size());
+		}
+
+		header.contentHash = ContentHash::HashBytes(
+			buffer.data() + KSN_HEADER_SIZE,
+			buffer.size() - KSN_HEADER_SIZE);
+
+		memcpy(buffer.data(), &header, sizeof(header));
+
+		//a crash mid-write never leaves a broken snapshot behind, the old one stays until the rename
+		path tempPath = snapshotPath;
+		tempPath += ".tmp";
+
+		{
+			ofstream out(tempPath, ios::binary | ios::trunc);
+			if (!out)
+			{
+				return "Failed to open scene snapshot '" + tempPath.string() + "' for writing!";
+			}
+
+			out.write(
+				reinterpret_cast<const char*>(buffer.data()),
+				scast<streamsize>(buffer.size()));
+
+			if (!out)
+			{
+				out.close();
+
+				error_code ec{};
+				remove(tempPath, ec);
+
+				return "Failed to write scene snapshot '" + tempPath.string() + "'!";
+			}
+		}
+
+		error_code ec{};
+		rename(tempPath, snapshotPath, ec);
+		if (ec)
+		{
+			remove(tempPath, ec);
+			return "Failed to replace scene snapshot '" + snapshotPath.string() + "'! Reason: " + ec.message();
+		}
+
+		return {};
+	}
+
+	string SceneSnapshotReader::Open(const path& snapshotPath)
+	{
+		Close();
+
+		if (!FileMapping::Map(snapshotPath, file))
+		{
+			return "Failed to map scene snapshot '" + snapshotPath.string() + "'!";
+		}
+
+		auto fail = [this, &snapshotPath](const string& reason)
+			{
+				Close();
+				return "Invalid scene snapshot '" + snapshotPath.string() + "'! Reason: " + reason;
+			};
+
+		if (file.size < KSN_HEADER_SIZE) return fail("file is smaller than the header");
+
+		memcpy(&header, file.data, sizeof(header));
+
+		if (header.magic != KSN_MAGIC) return fail("wrong magic word");
+		if (header.version != KSN_VERSION)
+		{
+			return fail("version " + to_string(header.version) + " is not supported, expected " + to_string(KSN_VERSION));
+		}
+		if (header.headerSize != KSN_HEADER_SIZE) return fail("wrong header size");
+
+		if (!IsSectionValid(header.modelsOffset, header.modelCount, sizeof(SceneModelRecord), file.size)
+			|| !IsSectionValid(header.lightsOffset, header.lightCount, sizeof(SceneLightRecord), file.size)
+			|| !IsSectionValid(header.camerasOffset, header.cameraCount, sizeof(SceneCameraRecord), file.size)
+			|| header.stringTableOffset < KSN_HEADER_SIZE
+			|| header.stringTableOffset + header.stringTableSize > file.size)
+		{
+			return fail("a section is out of bounds");
+		}
+
+		u64 hash = ContentHash::HashBytes(
+			file.data + KSN_HEADER_SIZE,
+			scast<size_t>(file.size - KSN_HEADER_SIZE));
+		if (hash != header.contentHash) return fail("content hash mismatch");
+
+		//the mapping is page aligned and every section is 8 byte aligned inside it
+		models = reinterpret_cast<const SceneModelRecord*>(file.data + header.modelsOffset);
+		lights = reinterpret_cast<const SceneLightRecord*>(file.data + header.lightsOffset);
+		cameras = reinterpret_cast<const SceneCameraRecord*>(file.data + header.camerasOffset);
+		strings = reinterpret_cast<const char*>(file.data + header.stringTableOffset);
+
+		return {};
+	}
+
+	void SceneSnapshotReader::Close()
+	{
+		FileMapping::Unmap(file);
+
+		header = {};
+		models = nullptr;
+		lights = nullptr;
+		cameras = nullptr;
+		strings = nullptr;
+	}
+
+	string_view SceneSnapshotReader::GetString(
+		u32 offset,
+		u32 length) const
+	{
+		if (!strings
+			|| scast<u64>(offset) + length > header.stringTableSize)
+		{
+			return {};
+		}
+
+		return string_view(strings + offset, length);
+	}
+}
+
+u64 AlignSection(u64 offset)
+{
+	return (offset + KSN_SECTION_ALIGNMENT - 1) & ~scast<u64>(KSN_SECTION_ALIGNMENT - 1);
+}
+
+bool IsSectionValid(
+	u64 offset,
+	u64 count,
+	u64 recordSize,
+	u64 fileSize)
+{
+	return offset >= KSN_HEADER_SIZE
+		&& offset % KSN_SECTION_ALIGNMENT == 0
+		&& offset <= fileSize
+		&& count <= (fileSize - offset) / recordSize;
+}
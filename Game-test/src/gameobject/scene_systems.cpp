@@ -0,0 +1,228 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <cstring>
+
+#include "KalaHeaders/math_utils.hpp"
+
+#include "gameobject/scene_systems.hpp"
+
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::quat;
+using KalaHeaders::KalaMath::mat4;
+using KalaHeaders::KalaMath::createumodel;
+using KalaHeaders::KalaMath::isnear;
+using KalaHeaders::KalaMath::PosTarget;
+using KalaHeaders::KalaMath::RotTarget;
+using KalaHeaders::KalaMath::SizeTarget;
+
+using GameTest::GameObject::SceneSystems;
+using GameTest::GameObject::OpenGL_Model;
+using GameTest::GameObject::TransformComponent;
+using GameTest::GameObject::WorldMatrixComponent;
+using GameTest::GameObject::RenderableComponent;
+using GameTest::GameObject::RenderItem;
+using GameTest::Core::EcsWorld;
+using GameTest::Core::EcsEntity;
+using GameTest::Core::EcsChunkView;
+using GameTest::Core::ThreadPool;
+
+using std::vector;
+using std::unordered_map;
+using std::atomic;
+using std::memcmp;
+
+static EcsWorld world{};
+static unordered_map<OpenGL_Model*, EcsEntity> modelEntities{};
+
+static vector<RenderItem> renderItems{};
+
+//tick each system last ran at, chunks that didn't change after it are skipped
+static u32 transformTick{};
+static u32 extractionTick{};
+
+//entities were added or removed, so draw list offsets moved and every chunk is extracted again
+static bool isStructureDirty = true;
+
+static u32 lastTransformChunkCount{};
+
+static void SyncModels(ThreadPool* workers);
+static void UpdateWorldMatrices(ThreadPool* workers);
+static void ExtractRenderItems(ThreadPool* workers);
+
+namespace GameTest::GameObject
+{
+	EcsEntity SceneSystems::AddModel(OpenGL_Model* model)
+	{
+		if (!model) return {};
+
+		auto it = modelEntities.find(model);
+		if (it != modelEntities.end()) return it->second;
+
+		RenderableComponent renderable{};
+		renderable.model = model;
+
+		EcsEntity entity = world.Create(
+			renderable,
+			TransformComponent{},
+			WorldMatrixComponent{});
+
+		modelEntities.emplace(model, entity);
+		isStructureDirty = true;
+
+		return entity;
+	}
+
+	void SceneSystems::RemoveModel(OpenGL_Model* model)
+	{
+		auto it = modelEntities.find(model);
+		if (it == modelEntities.end()) return;
+
+		world.Destroy(it->second);
+		modelEntities.erase(it);
+
+		isStructureDirty = true;
+	}
+
+	const vector<RenderItem>& SceneSystems::Update(ThreadPool* workers)
+	{
+		SyncModels(workers);
+		UpdateWorldMatrices(workers);
+		ExtractRenderItems(workers);
+
+		return renderItems;
+	}
+
+	EcsWorld& SceneSystems::GetWorld() { return world; }
+
+	u32 SceneSystems::GetLastTransformChunkCount() { return lastTransformChunkCount; }
+
+	void SceneSystems::Clear()
+	{
+		world.Clear();
+		modelEntities.clear();
+		renderItems.clear();
+
+		transformTick = 0;
+		extractionTick = 0;
+		lastTransformChunkCount = 0;
+		isStructureDirty = true;
+	}
+}
+
+void SyncModels(ThreadPool* workers)
+{
+	//models still own their transforms, this is the one place that reads them,
+	//columns are only marked when a value actually differs so static models cost no downstream work
+	world.ParallelForEachChunk<RenderableComponent, TransformComponent>(
+		workers,
+		[](EcsChunkView& chunk)
+		{
+			RenderableComponent* renderables = chunk.Peek<RenderableComponent>();
+			TransformComponent* transforms = chunk.Peek<TransformComponent>();
+
+			bool isTransformChanged{};
+			bool isRenderableChanged{};
+
+			for (u32 i = 0; i < chunk.GetCount(); ++i)
+			{
+				OpenGL_Model* model = renderables[i].model;
+
+				TransformComponent current{};
+				current.pos = model->GetPos(PosTarget::POS_COMBINED);
+				current.rot = model->GetRotQuat(RotTarget::ROT_COMBINED);
+				current.size = model->GetSize(SizeTarget::SIZE_COMBINED);
+
+				if (memcmp(&current, &transforms[i], sizeof(TransformComponent)) != 0)
+				{
+					transforms[i] = current;
+					isTransformChanged = true;
+				}
+
+				bool isOccluder = isnear(model->GetOpacity(), 1.0f);
+				bool isTransparent = model->IsTransparent();
+
+				if (isOccluder != renderables[i].isOccluder
+					|| isTransparent != renderables[i].isTransparent)
+				{
+					renderables[i].isOccluder = isOccluder;
+					renderables[i].isTransparent = isTransparent;
+					isRenderableChanged = true;
+				}
+			}
+
+			if (isTransformChanged) chunk.MarkChanged<TransformComponent>();
+			if (isRenderableChanged) chunk.MarkChanged<RenderableComponent>();
+		});
+}
+
+void UpdateWorldMatrices(ThreadPool* workers)
+{
+	u32 since = transformTick;
+	transformTick = world.AdvanceTick();
+
+	atomic<u32> updatedChunks{};
+
+	world.ParallelForEachChunk<TransformComponent, WorldMatrixComponent>(
+		workers,
+		[since, &updatedChunks](EcsChunkView& chunk)
+		{
+			if (!chunk.HasChanged<TransformComponent>(since)) return;
+
+			const TransformComponent* transforms = chunk.Read<TransformComponent>();
+			WorldMatrixComponent* matrices = chunk.Write<WorldMatrixComponent>();
+
+			for (u32 i = 0; i < chunk.GetCount(); ++i)
+			{
+				matrices[i].value = createumodel(
+					transforms[i].pos,
+					transforms[i].rot,
+					transforms[i].size);
+			}
+
+			updatedChunks.fetch_add(1, std::memory_order_relaxed);
+		});
+
+	lastTransformChunkCount = updatedChunks.load();
+}
+
+void ExtractRenderItems(ThreadPool* workers)
+{
+	u32 since = extractionTick;
+	extractionTick = world.AdvanceTick();
+
+	bool isFullExtract = isStructureDirty;
+	isStructureDirty = false;
+
+	renderItems.resize(world.Count<RenderableComponent, WorldMatrixComponent>());
+
+	world.ParallelForEachChunk<RenderableComponent, WorldMatrixComponent>(
+		workers,
+		[since, isFullExtract](EcsChunkView& chunk)
+		{
+			if (!isFullExtract
+				&& !chunk.HasChanged<RenderableComponent>(since)
+				&& !chunk.HasChanged<WorldMatrixComponent>(since))
+			{
+				return;
+			}
+
+			const RenderableComponent* renderables = chunk.Read<RenderableComponent>();
+			const WorldMatrixComponent* matrices = chunk.Read<WorldMatrixComponent>();
+
+			RenderItem* out = renderItems.data() + chunk.GetQueryOffset();
+
+			for (u32 i = 0; i < chunk.GetCount(); ++i)
+			{
+				out[i].model = renderables[i].model;
+				out[i].world = matrices[i].value;
+				out[i].isOccluder = renderables[i].isOccluder;
+				out[i].isTransparent = renderables[i].isTransparent;
+			}
+		});
+}
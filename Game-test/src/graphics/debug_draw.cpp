@@ -0,0 +1,794 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <cstring>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_functions_core.hpp"
+
+#include "graphics/debug_draw.hpp"
+#include "graphics/gl_extra_functions.hpp"
+#include "graphics/stream_ring.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::vec4;
+using KalaHeaders::KalaMath::mat4;
+using KalaHeaders::KalaMath::PosTarget;
+using KalaHeaders::KalaMath::SizeTarget;
+
+using KalaWindow::OpenGL::OpenGL_Shader;
+using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
+using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
+
+using GameTest::Graphics::DebugDraw;
+using GameTest::GameObject::OpenGL_PointLight;
+using GameTest::Graphics::GL_Extra;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+using GameTest::Graphics::StreamRing;
+using GameTest::Graphics::StreamAllocation;
+using GameTest::Graphics::DEBUG_SPHERE_SEGMENTS;
+using GameTest::Graphics::DEBUG_MAX_LINE_VERTICES;
+using GameTest::Graphics::DEBUG_MAX_INSTANCES;
+
+using std::vector;
+using std::max;
+using std::min;
+using std::cos;
+using std::sin;
+
+constexpr f32 PI = 3.14159265358979f;
+
+//gizmo size of a point light with a unit transform size
+constexpr f32 LIGHT_GIZMO_SIZE = 0.1f;
+
+//one end of a line, color is rgba8 with red in the lowest byte
+struct DebugVertex
+{
+	vec3 pos{};
+	u32 color{};
+};
+static_assert(sizeof(DebugVertex) == 16);
+
+//per instance data of spheres and gizmos, the mesh is scaled by radius
+struct DebugInstance
+{
+	vec3 center{};
+	f32 radius{};
+	u32 color{};
+};
+static_assert(sizeof(DebugInstance) == 20);
+
+//gpu side of one streamed array
+struct StreamBuffer
+{
+	u32 VBO{};
+	size_t capacity{};
+};
+
+static bool isInitialized{};
+static bool isEnabled = true;
+static bool hasWarnedOverflow{};
+
+static OpenGL_Shader* lineShader{};
+static StreamRing* uploadRing{};
+
+static vector<DebugVertex> lineVertices{};
+static vector<DebugInstance> sphereInstances{};
+static vector<DebugInstance> gizmoInstances{};
+
+static u32 lineVAO{};
+static u32 sphereVAO{};
+static u32 gizmoVAO{};
+
+static StreamBuffer lineStream{};
+static StreamBuffer sphereStream{};
+static StreamBuffer gizmoStream{};
+
+//static meshes, a unit radius sphere of three circles and a unit octahedron
+static u32 ringVBO{};
+static u32 octahedronVBO{};
+static u32 ringVertexCount{};
+static u32 octahedronVertexCount{};
+
+static u32 lastLineCount{};
+static u32 lastSphereCount{};
+static u32 lastGizmoCount{};
+
+static u32 PackColor(const vec3& color);
+
+static vec3 TransformPoint(
+	const mat4& m,
+	const vec3& p);
+
+static bool Inverse(
+	const mat4& m,
+	mat4& outInverse);
+
+//returns false and warns once if the frame limit has been reached
+static bool HasRoom(
+	size_t count,
+	size_t limit);
+
+//writes into the upload ring if it has room, otherwise into the stream buffer
+static void Upload(
+	StreamBuffer& stream,
+	const void* data,
+	size_t size,
+	u32& outBuffer,
+	size_t& outOffset);
+
+//attribute pointers are set per flush because the data may live in the upload ring
+static void SetLineAttributes(
+	u32 buffer,
+	size_t offset);
+static void SetInstanceAttributes(
+	u32 buffer,
+	size_t offset);
+
+namespace GameTest::Graphics
+{
+	bool DebugDraw::Initialize(
+		OpenGL_Shader* shader,
+		StreamRing* ring)
+	{
+		if (isInitialized) return true;
+
+		if (!shader
+			|| !shader->IsInitialized())
+		{
+			Log::Print(
+				"Failed to initialize debug draw because its shader is invalid!",
+				"DEBUG_DRAW",
+				LogType::LOG_ERROR,
+				2);
+
+			return false;
+		}
+
+		lineShader = shader;
+		uploadRing = ring;
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		//
+		// STATIC MESHES
+		//
+
+		vector<vec3> circles{};
+		circles.reserve(DEBUG_SPHERE_SEGMENTS * 6);
+
+		auto circlePoint = [](u32 plane, u32 segment)
+			{
+				f32 angle = 2.0f * PI * scast<f32>(segment % DEBUG_SPHERE_SEGMENTS) / scast<f32>(DEBUG_SPHERE_SEGMENTS);
+				f32 c = cos(angle);
+				f32 s = sin(angle);
+
+				if (plane == 0) return vec3(c, s, 0.0f);
+				if (plane == 1) return vec3(c, 0.0f, s);
+				return vec3(0.0f, c, s);
+			};
+
+		for (u32 plane = 0; plane < 3; ++plane)
+		{
+			for (u32 i = 0; i < DEBUG_SPHERE_SEGMENTS; ++i)
+			{
+				circles.push_back(circlePoint(plane, i));
+				circles.push_back(circlePoint(plane, i + 1));
+			}
+		}
+
+		const vec3 axis[6] =
+		{
+			vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f),
+			vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f),
+			vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f)
+		};
+
+		vector<vec3> octahedron{};
+		octahedron.reserve(24);
+
+		//one face per octant, counter clockwise seen from outside
+		for (u32 i = 0; i < 8; ++i)
+		{
+			const vec3& x = axis[(i & 1) ? 1 : 0];
+			const vec3& y = axis[(i & 2) ? 3 : 2];
+			const vec3& z = axis[(i & 4) ? 5 : 4];
+
+			bool isFlipped = ((i & 1) ^ ((i >> 1) & 1) ^ ((i >> 2) & 1)) != 0;
+
+			octahedron.push_back(x);
+			octahedron.push_back(isFlipped ? z : y);
+			octahedron.push_back(isFlipped ? y : z);
+		}
+
+		ringVertexCount = scast<u32>(circles.size());
+		octahedronVertexCount = scast<u32>(octahedron.size());
+
+		coreFunc->glGenBuffers(1, &ringVBO);
+		coreFunc->glBindBuffer(GL_ARRAY_BUFFER, ringVBO);
+		coreFunc->glBufferData(
+			GL_ARRAY_BUFFER,
+			circles.size() * sizeof(vec3),
+			circles.data(),
+			GL_STATIC_DRAW);
+
+		coreFunc->glGenBuffers(1, &octahedronVBO);
+		coreFunc->glBindBuffer(GL_ARRAY_BUFFER, octahedronVBO);
+		coreFunc->glBufferData(
+			GL_ARRAY_BUFFER,
+			octahedron.size() * sizeof(vec3),
+			octahedron.data(),
+			GL_STATIC_DRAW);
+
+		coreFunc->glGenBuffers(1, &lineStream.VBO);
+		coreFunc->glGenBuffers(1, &sphereStream.VBO);
+		coreFunc->glGenBuffers(1, &gizmoStream.VBO);
+
+		//
+		// LINES
+		//
+
+		coreFunc->glGenVertexArrays(1, &lineVAO);
+		coreFunc->glBindVertexArray(lineVAO);
+		SetLineAttributes(lineStream.VBO, 0);
+
+		//
+		// INSTANCED SHAPES
+		//
+
+		coreFunc->glGenVertexArrays(1, &sphereVAO);
+		coreFunc->glBindVertexArray(sphereVAO);
+		coreFunc->glBindBuffer(GL_ARRAY_BUFFER, ringVBO);
+		coreFunc->glEnableVertexAttribArray(0);
+		coreFunc->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (void*)0);
+		SetInstanceAttributes(sphereStream.VBO, 0);
+
+		coreFunc->glGenVertexArrays(1, &gizmoVAO);
+		coreFunc->glBindVertexArray(gizmoVAO);
+		coreFunc->glBindBuffer(GL_ARRAY_BUFFER, octahedronVBO);
+		coreFunc->glEnableVertexAttribArray(0);
+		coreFunc->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (void*)0);
+		SetInstanceAttributes(gizmoStream.VBO, 0);
+
+		coreFunc->glBindVertexArray(0);
+		coreFunc->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		//the queues keep their capacity between frames so steady use never allocates
+		lineVertices.reserve(4096);
+		sphereInstances.reserve(64);
+		gizmoInstances.reserve(64);
+
+		isInitialized = true;
+
+		Log::Print(
+			"Initialized debug draw.",
+			"DEBUG_DRAW",
+			LogType::LOG_SUCCESS);
+
+		return true;
+	}
+	bool DebugDraw::IsInitialized() { return isInitialized; }
+
+	void DebugDraw::SetEnabled(bool newValue) { isEnabled = newValue; }
+	bool DebugDraw::IsEnabled() { return isEnabled; }
+
+	void DebugDraw::Line(
+		const vec3& start,
+		const vec3& end,
+		const vec3& color)
+	{
+		if (!isInitialized
+			|| !isEnabled
+			|| !HasRoom(lineVertices.size() + 2, DEBUG_MAX_LINE_VERTICES))
+		{
+			return;
+		}
+
+		u32 packed = PackColor(color);
+
+		lineVertices.push_back({ start, packed });
+		lineVertices.push_back({ end, packed });
+	}
+
+	void DebugDraw::Box(
+		const vec3& boundsMin,
+		const vec3& boundsMax,
+		const vec3& color)
+	{
+		Box(
+			boundsMin,
+			boundsMax,
+			mat4(1.0f),
+			color);
+	}
+
+	void DebugDraw::Box(
+		const vec3& boundsMin,
+		const vec3& boundsMax,
+		const mat4& model,
+		const vec3& color)
+	{
+		if (!isInitialized
+			|| !isEnabled)
+		{
+			return;
+		}
+
+		vec3 corners[8]{};
+		for (u32 i = 0; i < 8; ++i)
+		{
+			vec3 p(
+				(i & 1) ? boundsMax.x : boundsMin.x,
+				(i & 2) ? boundsMax.y : boundsMin.y,
+				(i & 4) ? boundsMax.z : boundsMin.z);
+
+			corners[i] = TransformPoint(model, p);
+		}
+
+		//corners that differ in exactly one bit share an edge
+		for (u32 i = 0; i < 8; ++i)
+		{
+			for (u32 bit = 1; bit < 8; bit <<= 1)
+			{
+				if (i & bit) continue;
+
+				Line(corners[i], corners[i | bit], color);
+			}
+		}
+	}
+
+	void DebugDraw::Sphere(
+		const vec3& center,
+		f32 radius,
+		const vec3& color)
+	{
+		if (!isInitialized
+			|| !isEnabled
+			|| !HasRoom(sphereInstances.size() + 1, DEBUG_MAX_INSTANCES))
+		{
+			return;
+		}
+
+		sphereInstances.push_back({ center, radius, PackColor(color) });
+	}
+
+	void DebugDraw::Frustum(
+		const mat4& viewProjection,
+		const vec3& color)
+	{
+		if (!isInitialized
+			|| !isEnabled)
+		{
+			return;
+		}
+
+		mat4 inverseViewProjection{};
+		if (!Inverse(viewProjection, inverseViewProjection)) return;
+
+		vec3 corners[8]{};
+		for (u32 i = 0; i < 8; ++i)
+		{
+			vec3 ndc(
+				(i & 1) ? 1.0f : -1.0f,
+				(i & 2) ? 1.0f : -1.0f,
+				(i & 4) ? 1.0f : -1.0f);
+
+			corners[i] = TransformPoint(inverseViewProjection, ndc);
+		}
+
+		for (u32 i = 0; i < 8; ++i)
+		{
+			for (u32 bit = 1; bit < 8; bit <<= 1)
+			{
+				if (i & bit) continue;
+
+				Line(corners[i], corners[i | bit], color);
+			}
+		}
+	}
+
+	void DebugDraw::LightGizmo(
+		const vec3& center,
+		f32 size,
+		const vec3& color)
+	{
+		if (!isInitialized
+			|| !isEnabled
+			|| !HasRoom(gizmoInstances.size() + 1, DEBUG_MAX_INSTANCES))
+		{
+			return;
+		}
+
+		gizmoInstances.push_back({ center, size, PackColor(color) });
+	}
+
+	void DebugDraw::LightRange(OpenGL_PointLight* light)
+	{
+		if (!light
+			|| !isInitialized
+			|| !isEnabled)
+		{
+			return;
+		}
+
+		vec3 pos = light->GetPos(PosTarget::POS_COMBINED);
+
+		//replaces the old per-light mesh draw, scaled by the light transform like that mesh was
+		if (light->CanRenderDebugShape())
+		{
+			vec3 size = light->GetSize(SizeTarget::SIZE_COMBINED);
+
+			LightGizmo(
+				pos,
+				LIGHT_GIZMO_SIZE * max(size.x, max(size.y, size.z)),
+				light->GetNormalizedDebugColor());
+		}
+
+		Sphere(
+			pos,
+			light->GetMaxRange(),
+			light->GetNormalizedColor());
+	}
+
+	void DebugDraw::Flush(
+		const mat4& view,
+		const mat4& projection)
+	{
+		if (!isInitialized) return;
+
+		lastLineCount = scast<u32>(lineVertices.size() / 2);
+		lastSphereCount = scast<u32>(sphereInstances.size());
+		lastGizmoCount = scast<u32>(gizmoInstances.size());
+
+		if (!isEnabled
+			|| (lineVertices.empty()
+			&& sphereInstances.empty()
+			&& gizmoInstances.empty()))
+		{
+			lineVertices.clear();
+			sphereInstances.clear();
+			gizmoInstances.clear();
+
+			return;
+		}
+
+		if (!lineShader->Bind())
+		{
+			Log::Print(
+				"Failed to flush debug draw because shader '" + lineShader->GetName() + "' failed to bind!",
+				"DEBUG_DRAW",
+				LogType::LOG_ERROR,
+				2);
+
+			lineVertices.clear();
+			sphereInstances.clear();
+			gizmoInstances.clear();
+
+			return;
+		}
+
+		lineShader->SetMat4("uView", view);
+		lineShader->SetMat4("uProjection", projection);
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+		const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+		//depth tested against the scene but never written,
+		//so overlapping debug shapes don't hide each other
+		coreFunc->glEnable(GL_BLEND);
+		coreFunc->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		coreFunc->glDepthMask(GL_FALSE);
+		coreFunc->glDisable(GL_CULL_FACE);
+
+		u32 buffer{};
+		size_t offset{};
+
+		if (!lineVertices.empty())
+		{
+			lineShader->SetInt("uInstanced", 0);
+
+			Upload(
+				lineStream,
+				lineVertices.data(),
+				lineVertices.size() * sizeof(DebugVertex),
+				buffer,
+				offset);
+
+			coreFunc->glBindVertexArray(lineVAO);
+			SetLineAttributes(buffer, offset);
+			coreFunc->glDrawArrays(
+				GL_LINES,
+				0,
+				scast<GLsizei>(lineVertices.size()));
+		}
+
+		if (!sphereInstances.empty()
+			|| !gizmoInstances.empty())
+		{
+			lineShader->SetInt("uInstanced", 1);
+		}
+
+		if (!sphereInstances.empty())
+		{
+			Upload(
+				sphereStream,
+				sphereInstances.data(),
+				sphereInstances.size() * sizeof(DebugInstance),
+				buffer,
+				offset);
+
+			coreFunc->glBindVertexArray(sphereVAO);
+			SetInstanceAttributes(buffer, offset);
+			extraFunc->glDrawArraysInstanced(
+				GL_LINES,
+				0,
+				scast<GLsizei>(ringVertexCount),
+				scast<GLsizei>(sphereInstances.size()));
+		}
+
+		if (!gizmoInstances.empty())
+		{
+			Upload(
+				gizmoStream,
+				gizmoInstances.data(),
+				gizmoInstances.size() * sizeof(DebugInstance),
+				buffer,
+				offset);
+
+			coreFunc->glBindVertexArray(gizmoVAO);
+			SetInstanceAttributes(buffer, offset);
+			extraFunc->glDrawArraysInstanced(
+				GL_TRIANGLES,
+				0,
+				scast<GLsizei>(octahedronVertexCount),
+				scast<GLsizei>(gizmoInstances.size()));
+		}
+
+		coreFunc->glBindVertexArray(0);
+		coreFunc->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		coreFunc->glEnable(GL_CULL_FACE);
+		coreFunc->glDepthMask(GL_TRUE);
+		coreFunc->glDisable(GL_BLEND);
+
+		lineVertices.clear();
+		sphereInstances.clear();
+		gizmoInstances.clear();
+	}
+
+	u32 DebugDraw::GetLineCount() { return lastLineCount; }
+	u32 DebugDraw::GetSphereCount() { return lastSphereCount; }
+	u32 DebugDraw::GetGizmoCount() { return lastGizmoCount; }
+
+	void DebugDraw::Shutdown()
+	{
+		if (!isInitialized) return;
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		u32 vaos[3] = { lineVAO, sphereVAO, gizmoVAO };
+		coreFunc->glDeleteVertexArrays(3, vaos);
+
+		u32 vbos[5] = { lineStream.VBO, sphereStream.VBO, gizmoStream.VBO, ringVBO, octahedronVBO };
+		coreFunc->glDeleteBuffers(5, vbos);
+
+		lineVAO = sphereVAO = gizmoVAO = 0;
+		ringVBO = octahedronVBO = 0;
+		lineStream = {};
+		sphereStream = {};
+		gizmoStream = {};
+
+		lineVertices = {};
+		sphereInstances = {};
+		gizmoInstances = {};
+
+		lineShader = nullptr;
+		uploadRing = nullptr;
+		isInitialized = false;
+	}
+}
+
+u32 PackColor(const vec3& color)
+{
+	auto channel = [](f32 value)
+		{
+			return scast<u32>(min(max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+		};
+
+	return channel(color.x)
+		| (channel(color.y) << 8)
+		| (channel(color.z) << 16)
+		| (255u << 24);
+}
+
+vec3 TransformPoint(
+	const mat4& m,
+	const vec3& p)
+{
+	f32 x = m.m00 * p.x + m.m01 * p.y + m.m02 * p.z + m.m03;
+	f32 y = m.m10 * p.x + m.m11 * p.y + m.m12 * p.z + m.m13;
+	f32 z = m.m20 * p.x + m.m21 * p.y + m.m22 * p.z + m.m23;
+	f32 w = m.m30 * p.x + m.m31 * p.y + m.m32 * p.z + m.m33;
+
+	if (fabsf(w) < 1e-8f) w = 1e-8f;
+
+	return vec3(x / w, y / w, z / w);
+}
+
+bool Inverse(
+	const mat4& m,
+	mat4& outInverse)
+{
+	//cofactor expansion, the layout of a and the result only has to match
+	const f32 a[16] =
+	{
+		m.m00, m.m01, m.m02, m.m03,
+		m.m10, m.m11, m.m12, m.m13,
+		m.m20, m.m21, m.m22, m.m23,
+		m.m30, m.m31, m.m32, m.m33
+	};
+
+	f32 inv[16]{};
+
+	inv[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+	inv[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+	inv[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+	inv[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+	inv[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+	inv[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+	inv[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+	inv[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+	inv[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+	inv[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+	inv[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+	inv[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+	inv[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+	inv[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+	inv[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+	inv[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+	f32 det = a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12];
+	if (fabsf(det) < 1e-12f) return false;
+
+	f32 invDet = 1.0f / det;
+
+	outInverse.m00 = inv[0] * invDet;  outInverse.m01 = inv[1] * invDet;  outInverse.m02 = inv[2] * invDet;  outInverse.m03 = inv[3] * invDet;
+	outInverse.m10 = inv[4] * invDet;  outInverse.m11 = inv[5] * invDet;  outInverse.m12 = inv[6] * invDet;  outInverse.m13 = inv[7] * invDet;
+	outInverse.m20 = inv[8] * invDet;  outInverse.m21 = inv[9] * invDet;  outInverse.m22 = inv[10] * invDet; outInverse.m23 = inv[11] * invDet;
+	outInverse.m30 = inv[12] * invDet; outInverse.m31 = inv[13] * invDet; outInverse.m32 = inv[14] * invDet; outInverse.m33 = inv[15] * invDet;
+
+	return true;
+}
+
+bool HasRoom(
+	size_t count,
+	size_t limit)
+{
+	if (count <= limit) return true;
+
+	if (!hasWarnedOverflow)
+	{
+		hasWarnedOverflow = true;
+
+		Log::Print(
+			"Debug draw frame limit reached, extra primitives are dropped!",
+			"DEBUG_DRAW",
+			LogType::LOG_WARNING);
+	}
+
+	return false;
+}
+
+void Upload(
+	StreamBuffer& stream,
+	const void* data,
+	size_t size,
+	u32& outBuffer,
+	size_t& outOffset)
+{
+	if (uploadRing)
+	{
+		StreamAllocation allocation = uploadRing->Allocate(size);
+		if (allocation.IsValid())
+		{
+			memcpy(allocation.data, data, size);
+			uploadRing->Flush();
+
+			outBuffer = allocation.buffer;
+			outOffset = allocation.offset;
+
+			return;
+		}
+	}
+
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+	coreFunc->glBindBuffer(GL_ARRAY_BUFFER, stream.VBO);
+
+	//grows geometrically so the store is reallocated only a few times,
+	//otherwise the old store is orphaned so the driver never waits on last frame's draw
+	if (size > stream.capacity) stream.capacity = max(size, stream.capacity * 2);
+
+	coreFunc->glBufferData(
+		GL_ARRAY_BUFFER,
+		scast<GLsizeiptr>(stream.capacity),
+		nullptr,
+		GL_STREAM_DRAW);
+	coreFunc->glBufferSubData(
+		GL_ARRAY_BUFFER,
+		0,
+		scast<GLsizeiptr>(size),
+		data);
+
+	outBuffer = stream.VBO;
+	outOffset = 0;
+}
+
+void SetLineAttributes(
+	u32 buffer,
+	size_t offset)
+{
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+	coreFunc->glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+	coreFunc->glEnableVertexAttribArray(0);
+	coreFunc->glVertexAttribPointer(
+		0,
+		3,
+		GL_FLOAT,
+		GL_FALSE,
+		sizeof(DebugVertex),
+		(void*)(offset + offsetof(DebugVertex, pos)));
+
+	coreFunc->glEnableVertexAttribArray(1);
+	coreFunc->glVertexAttribPointer(
+		1,
+		4,
+		GL_UNSIGNED_BYTE,
+		GL_TRUE,
+		sizeof(DebugVertex),
+		(void*)(offset + offsetof(DebugVertex, color)));
+}
+
+void SetInstanceAttributes(
+	u32 buffer,
+	size_t offset)
+{
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+	const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+	coreFunc->glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+	//center in xyz and radius in w
+	coreFunc->glEnableVertexAttribArray(2);
+	coreFunc->glVertexAttribPointer(
+		2,
+		4,
+		GL_FLOAT,
+		GL_FALSE,
+		sizeof(DebugInstance),
+		(void*)(offset + offsetof(DebugInstance, center)));
+	extraFunc->glVertexAttribDivisor(2, 1);
+
+	coreFunc->glEnableVertexAttribArray(3);
+	coreFunc->glVertexAttribPointer(
+		3,
+		4,
+		GL_UNSIGNED_BYTE,
+		GL_TRUE,
+		sizeof(DebugInstance),
+		(void*)(offset + offsetof(DebugInstance, color)));
+	extraFunc->glVertexAttribDivisor(3, 1);
+}
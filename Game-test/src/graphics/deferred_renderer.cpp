@@ -0,0 +1,542 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <utility>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_functions_core.hpp"
+
+#include "graphics/deferred_renderer.hpp"
+#include "graphics/gl_extra_functions.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec2;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::mat4;
+using KalaHeaders::KalaMath::normalize;
+
+using KalaWindow::OpenGL::OpenGL_Shader;
+using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
+using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
+
+using GameTest::Graphics::DeferredRenderer;
+using GameTest::Graphics::DeferredShaders;
+using GameTest::Graphics::GL_Extra;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::array;
+using std::map;
+using std::pair;
+using std::min;
+using std::max;
+
+//the once subdivided icosahedron has its faces no closer than 0.93 to the center,
+//scaling by this keeps every face outside the unit sphere
+constexpr f32 LIGHT_VOLUME_SCALE = 1.08f;
+
+enum GBufferTarget : u32
+{
+	GBUFFER_ALBEDO,
+	GBUFFER_NORMAL,
+	GBUFFER_SPECULAR,
+	GBUFFER_EMISSIVE,
+	GBUFFER_COUNT
+};
+
+static bool isInitialized{};
+static bool isEnabled{};
+static bool isGeometryPassActive{};
+
+static DeferredShaders shaders{};
+
+static u32 width{};
+static u32 height{};
+
+static u32 FBO{};
+static array<u32, GBUFFER_COUNT> targets{};
+static u32 depthTex{};
+
+//unit light volume
+static u32 volumeVAO{};
+static u32 volumeVBO{};
+static u32 volumeEBO{};
+static u32 volumeIndexCount{};
+
+//fullscreen triangle is generated from gl_VertexID, gl still wants a vertex array bound
+static u32 emptyVAO{};
+
+static string CreateTargets();
+static void DeleteTargets();
+
+//Icosahedron with every face split in four, projected onto the unit sphere
+static void CreateLightVolume();
+
+namespace GameTest::Graphics
+{
+	string DeferredRenderer::Initialize(
+		const DeferredShaders& newShaders,
+		const vec2& size)
+	{
+		if (isInitialized) return {};
+
+		for (OpenGL_Shader* shader : { newShaders.geometry, newShaders.ambient, newShaders.light })
+		{
+			if (!shader
+				|| !shader->IsInitialized())
+			{
+				return "Failed to initialize the deferred renderer because one of its shaders is invalid!";
+			}
+		}
+
+		shaders = newShaders;
+		width = scast<u32>(size.x);
+		height = scast<u32>(size.y);
+
+		string result = CreateTargets();
+		if (!result.empty())
+		{
+			DeleteTargets();
+			return result;
+		}
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		//light volumes read the same point light block as the forward model shader
+		u32 lightProgram = shaders.light->GetProgramID();
+		coreFunc->glUniformBlockBinding(
+			lightProgram,
+			coreFunc->glGetUniformBlockIndex(lightProgram, "PointLightBlock"),
+			0);
+
+		CreateLightVolume();
+		coreFunc->glGenVertexArrays(1, &emptyVAO);
+
+		isInitialized = true;
+
+		Log::Print(
+			"Initialized deferred renderer at " + to_string(width) + "x" + to_string(height) + ".",
+			"DEFERRED",
+			LogType::LOG_SUCCESS);
+
+		return {};
+	}
+	bool DeferredRenderer::IsInitialized() { return isInitialized; }
+
+	void DeferredRenderer::SetEnabled(bool newValue)
+	{
+		if (newValue
+			&& !isInitialized)
+		{
+			Log::Print(
+				"Cannot enable deferred shading because the deferred renderer is not initialized!",
+				"DEFERRED",
+				LogType::LOG_ERROR,
+				2);
+
+			return;
+		}
+
+		if (isEnabled == newValue) return;
+
+		isEnabled = newValue;
+
+		Log::Print(
+			isEnabled ? "Switched to deferred shading." : "Switched to forward shading.",
+			"DEFERRED",
+			LogType::LOG_INFO);
+	}
+	bool DeferredRenderer::IsEnabled() { return isEnabled && isInitialized; }
+
+	void DeferredRenderer::Resize(const vec2& size)
+	{
+		if (!isInitialized) return;
+
+		u32 newWidth = scast<u32>(size.x);
+		u32 newHeight = scast<u32>(size.y);
+
+		//minimized windows report an empty client rect
+		if (newWidth == 0
+			|| newHeight == 0
+			|| (newWidth == width
+			&& newHeight == height))
+		{
+			return;
+		}
+
+		width = newWidth;
+		height = newHeight;
+
+		DeleteTargets();
+
+		string result = CreateTargets();
+		if (!result.empty())
+		{
+			//everything falls back to forward lighting
+			Log::Print(
+				result,
+				"DEFERRED",
+				LogType::LOG_ERROR,
+				2);
+
+			Shutdown();
+		}
+	}
+
+	void DeferredRenderer::BeginGeometryPass()
+	{
+		if (!IsEnabled()) return;
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+		const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+		coreFunc->glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+		const GLenum drawBuffers[GBUFFER_COUNT] =
+		{
+			GL_COLOR_ATTACHMENT0,
+			GL_COLOR_ATTACHMENT1,
+			GL_COLOR_ATTACHMENT2,
+			GL_COLOR_ATTACHMENT3
+		};
+		extraFunc->glDrawBuffers(GBUFFER_COUNT, drawBuffers);
+
+		//cleared per attachment so the clear color of the default framebuffer is left alone
+		const f32 zero[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		const f32 farDepth[] = { 1.0f };
+		for (u32 i = 0; i < GBUFFER_COUNT; ++i)
+		{
+			extraFunc->glClearBufferfv(GL_COLOR, scast<GLint>(i), zero);
+		}
+		extraFunc->glClearBufferfv(GL_DEPTH, 0, farDepth);
+
+		isGeometryPassActive = true;
+	}
+	bool DeferredRenderer::IsGeometryPassActive() { return isGeometryPassActive; }
+	OpenGL_Shader* DeferredRenderer::GetGeometryShader() { return shaders.geometry; }
+
+	void DeferredRenderer::EndGeometryPass(
+		const mat4& view,
+		const mat4& projection,
+		const vec3& cameraPos,
+		u32 lightCount)
+	{
+		if (!isGeometryPassActive) return;
+
+		isGeometryPassActive = false;
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+		const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+		coreFunc->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		//
+		// AMBIENT, EMISSIVE AND DEPTH
+		//
+
+		if (shaders.ambient->Bind())
+		{
+			coreFunc->glActiveTexture(GL_TEXTURE0);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, targets[GBUFFER_EMISSIVE]);
+			shaders.ambient->SetInt("uEmissiveTex", 0);
+
+			coreFunc->glActiveTexture(GL_TEXTURE1);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, depthTex);
+			shaders.ambient->SetInt("uDepthTex", 1);
+
+			coreFunc->glDepthFunc(GL_ALWAYS);
+
+			coreFunc->glBindVertexArray(emptyVAO);
+			coreFunc->glDrawArrays(GL_TRIANGLES, 0, 3);
+
+			coreFunc->glDepthFunc(GL_LESS);
+		}
+
+		if (lightCount == 0
+			|| !shaders.light->Bind())
+		{
+			coreFunc->glBindVertexArray(0);
+			return;
+		}
+
+		//
+		// LIGHT VOLUMES
+		//
+
+		shaders.light->SetMat4("uView", view);
+		shaders.light->SetMat4("uProjection", projection);
+		shaders.light->SetFloat("uVolumeScale", LIGHT_VOLUME_SCALE);
+		shaders.light->SetVec3("uViewPos", cameraPos);
+		shaders.light->SetVec2("uScreenSize", vec2(scast<f32>(width), scast<f32>(height)));
+
+		const GBufferTarget inputs[] = { GBUFFER_ALBEDO, GBUFFER_NORMAL, GBUFFER_SPECULAR };
+		const char* inputNames[] = { "uAlbedoTex", "uNormalTex", "uSpecularTex" };
+		for (u32 i = 0; i < 3; ++i)
+		{
+			coreFunc->glActiveTexture(GL_TEXTURE0 + i);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, targets[inputs[i]]);
+			shaders.light->SetInt(inputNames[i], scast<i32>(i));
+		}
+
+		coreFunc->glActiveTexture(GL_TEXTURE3);
+		coreFunc->glBindTexture(GL_TEXTURE_2D, depthTex);
+		shaders.light->SetInt("uDepthTex", 3);
+
+		//back faces behind the scene depth mark the pixels inside the volume, this also works with the
+		//camera inside the volume, depth clamp keeps back faces beyond the far plane from being clipped
+		coreFunc->glEnable(GL_BLEND);
+		coreFunc->glBlendFunc(GL_ONE, GL_ONE);
+		coreFunc->glDepthMask(GL_FALSE);
+		coreFunc->glDepthFunc(GL_GREATER);
+		coreFunc->glCullFace(GL_FRONT);
+		coreFunc->glEnable(GL_DEPTH_CLAMP);
+
+		coreFunc->glBindVertexArray(volumeVAO);
+		extraFunc->glDrawElementsInstanced(
+			GL_TRIANGLES,
+			scast<GLsizei>(volumeIndexCount),
+			GL_UNSIGNED_INT,
+			nullptr,
+			scast<GLsizei>(lightCount));
+		coreFunc->glBindVertexArray(0);
+
+		coreFunc->glDisable(GL_DEPTH_CLAMP);
+		coreFunc->glCullFace(GL_BACK);
+		coreFunc->glDepthFunc(GL_LESS);
+		coreFunc->glDepthMask(GL_TRUE);
+		coreFunc->glDisable(GL_BLEND);
+	}
+
+	void DeferredRenderer::Shutdown()
+	{
+		if (!isInitialized) return;
+
+		DeleteTargets();
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		if (volumeVAO != 0)
+		{
+			coreFunc->glDeleteVertexArrays(1, &volumeVAO);
+			volumeVAO = 0;
+		}
+		if (volumeVBO != 0)
+		{
+			coreFunc->glDeleteBuffers(1, &volumeVBO);
+			volumeVBO = 0;
+		}
+		if (volumeEBO != 0)
+		{
+			coreFunc->glDeleteBuffers(1, &volumeEBO);
+			volumeEBO = 0;
+		}
+		if (emptyVAO != 0)
+		{
+			coreFunc->glDeleteVertexArrays(1, &emptyVAO);
+			emptyVAO = 0;
+		}
+
+		shaders = {};
+		isGeometryPassActive = false;
+		isEnabled = false;
+		isInitialized = false;
+	}
+}
+
+string CreateTargets()
+{
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+	auto CreateTarget = [coreFunc](
+		u32& outTexture,
+		GLint internalFormat,
+		GLenum format,
+		GLenum type)
+		{
+			coreFunc->glGenTextures(1, &outTexture);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, outTexture);
+			coreFunc->glTexImage2D(
+				GL_TEXTURE_2D,
+				0,
+				internalFormat,
+				width,
+				height,
+				0,
+				format,
+				type,
+				nullptr);
+
+			coreFunc->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			coreFunc->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			coreFunc->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			coreFunc->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		};
+
+	//normals and light need the range of half floats, colors fit in 8 bits
+	CreateTarget(targets[GBUFFER_ALBEDO], GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+	CreateTarget(targets[GBUFFER_NORMAL], GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT);
+	CreateTarget(targets[GBUFFER_SPECULAR], GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+	CreateTarget(targets[GBUFFER_EMISSIVE], GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT);
+	CreateTarget(depthTex, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT);
+	coreFunc->glBindTexture(GL_TEXTURE_2D, 0);
+
+	coreFunc->glGenFramebuffers(1, &FBO);
+	coreFunc->glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+	for (u32 i = 0; i < GBUFFER_COUNT; ++i)
+	{
+		coreFunc->glFramebufferTexture2D(
+			GL_FRAMEBUFFER,
+			GL_COLOR_ATTACHMENT0 + i,
+			GL_TEXTURE_2D,
+			targets[i],
+			0);
+	}
+	coreFunc->glFramebufferTexture2D(
+		GL_FRAMEBUFFER,
+		GL_DEPTH_ATTACHMENT,
+		GL_TEXTURE_2D,
+		depthTex,
+		0);
+
+	GLenum status = coreFunc->glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+	coreFunc->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		return "Deferred g-buffer is incomplete, status '" + to_string(status) + "'!";
+	}
+
+	return {};
+}
+
+void DeleteTargets()
+{
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+	if (FBO != 0)
+	{
+		OpenGL_Functions_Extra::GetGLExtra()->glDeleteFramebuffers(1, &FBO);
+		FBO = 0;
+	}
+
+	for (u32& target : targets)
+	{
+		if (target == 0) continue;
+
+		coreFunc->glDeleteTextures(1, &target);
+		target = 0;
+	}
+
+	if (depthTex != 0)
+	{
+		coreFunc->glDeleteTextures(1, &depthTex);
+		depthTex = 0;
+	}
+}
+
+void CreateLightVolume()
+{
+	const f32 t = 1.61803398875f;
+
+	vector<vec3> vertices =
+	{
+		{ -1,  t,  0 }, {  1,  t,  0 }, { -1, -t,  0 }, {  1, -t,  0 },
+		{  0, -1,  t }, {  0,  1,  t }, {  0, -1, -t }, {  0,  1, -t },
+		{  t,  0, -1 }, {  t,  0,  1 }, { -t,  0, -1 }, { -t,  0,  1 }
+	};
+
+	vector<u32> indices =
+	{
+		0, 11, 5,   0, 5, 1,    0, 1, 7,    0, 7, 10,   0, 10, 11,
+		1, 5, 9,    5, 11, 4,   11, 10, 2,  10, 7, 6,   7, 1, 8,
+		3, 9, 4,    3, 4, 2,    3, 2, 6,    3, 6, 8,    3, 8, 9,
+		4, 9, 5,    2, 4, 11,   6, 2, 10,   8, 6, 7,    9, 8, 1
+	};
+
+	for (vec3& v : vertices) v = normalize(v);
+
+	//one shared midpoint per edge keeps the subdivided mesh watertight
+	map<pair<u32, u32>, u32> midpoints{};
+	auto GetMidpoint = [&](u32 a, u32 b)
+		{
+			pair<u32, u32> key(min(a, b), max(a, b));
+
+			auto it = midpoints.find(key);
+			if (it != midpoints.end()) return it->second;
+
+			vertices.push_back(normalize((vertices[a] + vertices[b]) * 0.5f));
+			u32 index = scast<u32>(vertices.size() - 1);
+
+			midpoints.emplace(key, index);
+			return index;
+		};
+
+	vector<u32> subdivided{};
+	subdivided.reserve(indices.size() * 4);
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		u32 a = indices[i];
+		u32 b = indices[i + 1];
+		u32 c = indices[i + 2];
+
+		u32 ab = GetMidpoint(a, b);
+		u32 bc = GetMidpoint(b, c);
+		u32 ca = GetMidpoint(c, a);
+
+		subdivided.insert(subdivided.end(), { a, ab, ca });
+		subdivided.insert(subdivided.end(), { b, bc, ab });
+		subdivided.insert(subdivided.end(), { c, ca, bc });
+		subdivided.insert(subdivided.end(), { ab, bc, ca });
+	}
+
+	volumeIndexCount = scast<u32>(subdivided.size());
+
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+	coreFunc->glGenVertexArrays(1, &volumeVAO);
+	coreFunc->glGenBuffers(1, &volumeVBO);
+	coreFunc->glGenBuffers(1, &volumeEBO);
+
+	coreFunc->glBindVertexArray(volumeVAO);
+
+	coreFunc->glBindBuffer(GL_ARRAY_BUFFER, volumeVBO);
+	coreFunc->glBufferData(
+		GL_ARRAY_BUFFER,
+		vertices.size() * sizeof(vec3),
+		vertices.data(),
+		GL_STATIC_DRAW);
+
+	coreFunc->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, volumeEBO);
+	coreFunc->glBufferData(
+		GL_ELEMENT_ARRAY_BUFFER,
+		subdivided.size() * sizeof(u32),
+		subdivided.data(),
+		GL_STATIC_DRAW);
+
+	coreFunc->glEnableVertexAttribArray(0);
+	coreFunc->glVertexAttribPointer(
+		0,
+		3,
+		GL_FLOAT,
+		GL_FALSE,
+		sizeof(vec3),
+		nullptr);
+
+	coreFunc->glBindVertexArray(0);
+}
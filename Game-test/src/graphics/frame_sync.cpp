@@ -0,0 +1,291 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <array>
+#include <deque>
+#include <chrono>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+
+#include "graphics/frame_sync.hpp"
+#include "graphics/gl_extra_functions.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using KalaWindow::OpenGL::OpenGL_Context;
+
+using GameTest::Graphics::FrameSync;
+using GameTest::Graphics::FrameTimings;
+using GameTest::Graphics::GL_Extra;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+using GameTest::Graphics::FRAME_SYNC_MAX_FRAMES;
+using GameTest::Graphics::FRAME_SYNC_HISTORY;
+
+using std::string;
+using std::to_string;
+using std::array;
+using std::deque;
+using std::clamp;
+using std::min;
+using std::ostringstream;
+using std::fixed;
+using std::setprecision;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+//how long a single fence wait blocks before it is retried, in nanoseconds
+constexpr GLuint64 FENCE_WAIT_STEP = 1'000'000;
+
+static bool isInitialized{};
+static bool isReportEnabled{};
+
+static u32 maxFramesInFlight = 2u;
+
+//fences of presented frames, oldest first
+static deque<GLsync> frameFences{};
+
+static steady_clock::time_point frameStart{};
+static steady_clock::time_point cpuStart{};
+static bool hasFrameStarted{};
+
+static FrameTimings currentTimings{};
+static FrameTimings lastTimings{};
+
+static array<FrameTimings, FRAME_SYNC_HISTORY> history{};
+static u32 historyCount{};
+static u32 historyNext{};
+
+static f64 ElapsedMs(
+	steady_clock::time_point start,
+	steady_clock::time_point end);
+
+//drops fences the gpu has already passed without blocking
+static void RetireSignaledFences();
+
+//blocks until the oldest fence is signaled
+static void WaitOldestFence();
+
+static void Report();
+
+namespace GameTest::Graphics
+{
+	void FrameSync::Initialize(u32 newMaxFramesInFlight)
+	{
+		if (isInitialized) return;
+
+		isInitialized = true;
+		SetMaxFramesInFlight(newMaxFramesInFlight);
+
+		Log::Print(
+			"Initialized frame sync with up to " + to_string(maxFramesInFlight) + " frames in flight.",
+			"FRAME_SYNC",
+			LogType::LOG_SUCCESS);
+	}
+	bool FrameSync::IsInitialized() { return isInitialized; }
+
+	void FrameSync::SetMaxFramesInFlight(u32 newValue)
+	{
+		u32 clamped = clamp(newValue, 1u, FRAME_SYNC_MAX_FRAMES);
+
+		if (clamped != newValue)
+		{
+			Log::Print(
+				"Frames in flight '" + to_string(newValue) + "' is out of range, it was clamped to '" + to_string(clamped) + "'.",
+				"FRAME_SYNC",
+				LogType::LOG_WARNING);
+		}
+
+		maxFramesInFlight = clamped;
+	}
+	u32 FrameSync::GetMaxFramesInFlight() { return maxFramesInFlight; }
+
+	void FrameSync::BeginFrame()
+	{
+		if (!isInitialized) return;
+
+		steady_clock::time_point now = steady_clock::now();
+
+		if (hasFrameStarted)
+		{
+			currentTimings.frameMs = ElapsedMs(frameStart, now);
+			lastTimings = currentTimings;
+
+			history[historyNext] = lastTimings;
+			historyNext = (historyNext + 1) % FRAME_SYNC_HISTORY;
+			historyCount = min(historyCount + 1, FRAME_SYNC_HISTORY);
+
+			if (isReportEnabled
+				&& historyNext == 0)
+			{
+				Report();
+			}
+		}
+
+		frameStart = now;
+		hasFrameStarted = true;
+		currentTimings = {};
+
+		RetireSignaledFences();
+
+		currentTimings.framesInFlight = scast<u32>(frameFences.size());
+
+		//the frame about to start would be one more than the limit
+		while (frameFences.size() >= maxFramesInFlight)
+		{
+			WaitOldestFence();
+		}
+
+		cpuStart = steady_clock::now();
+		currentTimings.fenceWaitMs = ElapsedMs(frameStart, cpuStart);
+	}
+
+	void FrameSync::Present(
+		OpenGL_Context* context,
+		uintptr_t handle)
+	{
+		steady_clock::time_point swapStart = steady_clock::now();
+
+		context->SwapOpenGLBuffers(handle);
+
+		if (!isInitialized) return;
+
+		steady_clock::time_point swapEnd = steady_clock::now();
+
+		currentTimings.cpuMs = ElapsedMs(cpuStart, swapStart);
+		currentTimings.swapMs = ElapsedMs(swapStart, swapEnd);
+
+		//fenced after the swap so the fence also covers presenting
+		frameFences.push_back(OpenGL_Functions_Extra::GetGLExtra()->glFenceSync(
+			GL_SYNC_GPU_COMMANDS_COMPLETE,
+			0));
+	}
+
+	void FrameSync::SetReportState(bool newValue) { isReportEnabled = newValue; }
+	bool FrameSync::IsReportEnabled() { return isReportEnabled; }
+
+	const FrameTimings& FrameSync::GetLastTimings() { return lastTimings; }
+
+	FrameTimings FrameSync::GetAverageTimings()
+	{
+		FrameTimings average{};
+		if (historyCount == 0) return average;
+
+		u64 framesInFlight{};
+
+		for (u32 i = 0; i < historyCount; ++i)
+		{
+			const FrameTimings& t = history[i];
+
+			average.frameMs += t.frameMs;
+			average.cpuMs += t.cpuMs;
+			average.fenceWaitMs += t.fenceWaitMs;
+			average.swapMs += t.swapMs;
+			framesInFlight += t.framesInFlight;
+		}
+
+		f64 count = scast<f64>(historyCount);
+
+		average.frameMs /= count;
+		average.cpuMs /= count;
+		average.fenceWaitMs /= count;
+		average.swapMs /= count;
+		average.framesInFlight = scast<u32>((framesInFlight + historyCount / 2) / historyCount);
+
+		return average;
+	}
+
+	void FrameSync::Shutdown()
+	{
+		if (!isInitialized) return;
+
+		const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+		for (GLsync fence : frameFences)
+		{
+			extraFunc->glDeleteSync(fence);
+		}
+		frameFences.clear();
+
+		hasFrameStarted = false;
+		historyCount = 0;
+		historyNext = 0;
+
+		isInitialized = false;
+	}
+}
+
+f64 ElapsedMs(
+	steady_clock::time_point start,
+	steady_clock::time_point end)
+{
+	return duration<f64, std::milli>(end - start).count();
+}
+
+void RetireSignaledFences()
+{
+	const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+	while (!frameFences.empty())
+	{
+		GLenum result = extraFunc->glClientWaitSync(frameFences.front(), 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED) break;
+
+		extraFunc->glDeleteSync(frameFences.front());
+		frameFences.pop_front();
+	}
+}
+
+void WaitOldestFence()
+{
+	const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+	GLsync fence = frameFences.front();
+
+	GLenum result{};
+	do
+	{
+		result = extraFunc->glClientWaitSync(
+			fence,
+			GL_SYNC_FLUSH_COMMANDS_BIT,
+			FENCE_WAIT_STEP);
+	} while (result == GL_TIMEOUT_EXPIRED);
+
+	if (result == GL_WAIT_FAILED)
+	{
+		Log::Print(
+			"Waiting on a frame fence failed, the frame is started without waiting!",
+			"FRAME_SYNC",
+			LogType::LOG_ERROR,
+			2);
+	}
+
+	extraFunc->glDeleteSync(fence);
+	frameFences.pop_front();
+}
+
+void Report()
+{
+	FrameTimings average = FrameSync::GetAverageTimings();
+
+	ostringstream oss{};
+	oss << fixed << setprecision(2)
+		<< "frame " << average.frameMs << "ms"
+		<< " | cpu " << average.cpuMs << "ms"
+		<< " | fence wait " << average.fenceWaitMs << "ms"
+		<< " | swap " << average.swapMs << "ms"
+		<< " | in flight " << average.framesInFlight << "/" << maxFramesInFlight;
+
+	Log::Print(
+		oss.str(),
+		"FRAME_SYNC",
+		LogType::LOG_INFO);
+}
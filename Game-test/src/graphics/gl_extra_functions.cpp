@@ -0,0 +1,109 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+
+#ifdef _WIN32
+	#include <windows.h>
+#endif
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "core/kw_core.hpp"
+#include "opengl/kw_opengl.hpp"
+
+#include "graphics/gl_extra_functions.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using KalaWindow::Core::KalaWindowCore;
+using KalaWindow::OpenGL::OpenGL_Global;
+
+using GameTest::Graphics::GL_Extra;
+
+using std::string;
+
+static GL_Extra glExtra{};
+
+//wglGetProcAddress only knows extension and post 1.1 functions,
+//everything older has to come straight from opengl32.dll
+static void* GetFunction(const char* name);
+
+template<typename T>
+static bool LoadFunction(
+	T& outFunction,
+	const char* name)
+{
+	outFunction = reinterpret_cast<T>(GetFunction(name));
+
+	if (!outFunction)
+	{
+		KalaWindowCore::ForceClose(
+			"OpenGL function error",
+			"Failed to load OpenGL function '" + string(name) + "'!");
+
+		return false;
+	}
+
+	return true;
+}
+
+namespace GameTest::Graphics
+{
+	const GL_Extra* OpenGL_Functions_Extra::GetGLExtra() { return &glExtra; }
+
+	void OpenGL_Functions_Extra::LoadAllExtraFunctions()
+	{
+		bool isLoaded =
+			LoadFunction(glExtra.glVertexAttribDivisor, "glVertexAttribDivisor")
+			&& LoadFunction(glExtra.glDrawArraysInstanced, "glDrawArraysInstanced")
+			&& LoadFunction(glExtra.glDrawElementsInstanced, "glDrawElementsInstanced")
+			&& LoadFunction(glExtra.glMultiDrawElements, "glMultiDrawElements")
+			&& LoadFunction(glExtra.glUnmapBuffer, "glUnmapBuffer")
+			&& LoadFunction(glExtra.glBindBufferRange, "glBindBufferRange")
+			&& LoadFunction(glExtra.glDrawBuffers, "glDrawBuffers")
+			&& LoadFunction(glExtra.glClearBufferfv, "glClearBufferfv")
+			&& LoadFunction(glExtra.glBlitFramebuffer, "glBlitFramebuffer")
+			&& LoadFunction(glExtra.glDeleteFramebuffers, "glDeleteFramebuffers")
+			&& LoadFunction(glExtra.glDeleteRenderbuffers, "glDeleteRenderbuffers")
+			&& LoadFunction(glExtra.glBlendFuncSeparate, "glBlendFuncSeparate")
+			&& LoadFunction(glExtra.glFenceSync, "glFenceSync")
+			&& LoadFunction(glExtra.glClientWaitSync, "glClientWaitSync")
+			&& LoadFunction(glExtra.glDeleteSync, "glDeleteSync");
+
+		if (!isLoaded) return;
+
+		Log::Print(
+			"Loaded extra OpenGL functions.",
+			"OPENGL_EXTRA",
+			LogType::LOG_SUCCESS);
+	}
+}
+
+void* GetFunction(const char* name)
+{
+#ifdef _WIN32
+	void* function = reinterpret_cast<void*>(wglGetProcAddress(name));
+
+	//some drivers return small sentinel values instead of null
+	uintptr_t value = reinterpret_cast<uintptr_t>(function);
+	if (value == 0
+		|| value == 1
+		|| value == 2
+		|| value == 3
+		|| value == static_cast<uintptr_t>(-1))
+	{
+		HMODULE library = reinterpret_cast<HMODULE>(OpenGL_Global::GetOpenGLLibrary());
+		function = library
+			? reinterpret_cast<void*>(GetProcAddress(library, name))
+			: nullptr;
+	}
+
+	return function;
+#else
+	return nullptr;
+#endif
+}
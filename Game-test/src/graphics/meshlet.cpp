@@ -0,0 +1,338 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+#include "graphics/meshlet.hpp"
+
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::vec4;
+using KalaHeaders::KalaMath::mat4;
+using KalaHeaders::KalaMath::dot;
+using KalaHeaders::KalaMath::cross;
+using KalaHeaders::KalaMath::length;
+using KalaHeaders::KalaModelData::Vertex;
+
+using GameTest::Graphics::Meshlet;
+using GameTest::Graphics::MeshletDrawRange;
+using GameTest::Graphics::MeshletCullStats;
+using GameTest::Graphics::MeshletBuilder;
+using GameTest::Graphics::MeshletCuller;
+
+using std::vector;
+using std::array;
+using std::min;
+using std::max;
+using std::fabs;
+using std::sqrt;
+
+//largest relative difference between axis scales that still counts as uniform scale
+constexpr f32 UNIFORM_SCALE_TOLERANCE = 1e-3f;
+
+//Fills the bounding sphere and normal cone of a meshlet from its triangles and unique vertices
+static void ComputeBounds(
+	Meshlet& meshlet,
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices,
+	const vector<u32>& meshletVertices);
+
+static vec3 GetPos(
+	const vector<Vertex>& vertices,
+	u32 index);
+
+namespace GameTest::Graphics
+{
+	vector<Meshlet> MeshletBuilder::Build(
+		const vector<Vertex>& vertices,
+		const vector<u32>& indices,
+		u32 maxVertices,
+		u32 maxTriangles)
+	{
+		vector<Meshlet> meshlets{};
+
+		if (vertices.empty()
+			|| indices.size() < 3
+			|| maxVertices < 3
+			|| maxTriangles == 0)
+		{
+			return meshlets;
+		}
+
+		size_t triangleCount = indices.size() / 3;
+
+		//rough guess, most meshlets fill their vertex limit before their triangle limit
+		meshlets.reserve(triangleCount / (maxTriangles / 2) + 1);
+
+		//index of the meshlet that last referenced each vertex
+		vector<u32> vertexOwner(vertices.size(), UINT32_MAX);
+		vector<u32> meshletVertices{};
+		meshletVertices.reserve(maxVertices);
+
+		Meshlet current{};
+		u32 currentID{};
+
+		auto Flush = [&]()
+			{
+				if (current.indexCount == 0) return;
+
+				current.vertexCount = scast<u32>(meshletVertices.size());
+				ComputeBounds(current, vertices, indices, meshletVertices);
+				meshlets.push_back(current);
+
+				current = {};
+				current.firstIndex = scast<u32>(meshlets.back().firstIndex + meshlets.back().indexCount);
+				meshletVertices.clear();
+				++currentID;
+			};
+
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			array<u32, 3> tri =
+			{
+				indices[t * 3],
+				indices[t * 3 + 1],
+				indices[t * 3 + 2]
+			};
+
+			//out of range triangles would read past the vertex buffer on the gpu as well
+			if (tri[0] >= vertices.size()
+				|| tri[1] >= vertices.size()
+				|| tri[2] >= vertices.size())
+			{
+				Flush();
+				current.firstIndex = scast<u32>((t + 1) * 3);
+				continue;
+			}
+
+			auto CountNew = [&]()
+				{
+					u32 count{};
+					if (vertexOwner[tri[0]] != currentID) ++count;
+					if (vertexOwner[tri[1]] != currentID
+						&& tri[1] != tri[0]) ++count;
+					if (vertexOwner[tri[2]] != currentID
+						&& tri[2] != tri[0]
+						&& tri[2] != tri[1]) ++count;
+					return count;
+				};
+
+			if (meshletVertices.size() + CountNew() > maxVertices
+				|| current.indexCount / 3 + 1 > maxTriangles)
+			{
+				Flush();
+			}
+
+			for (u32 index : tri)
+			{
+				if (vertexOwner[index] == currentID) continue;
+
+				vertexOwner[index] = currentID;
+				meshletVertices.push_back(index);
+			}
+
+			current.indexCount += 3;
+		}
+
+		Flush();
+
+		return meshlets;
+	}
+
+	void MeshletCuller::Cull(
+		const vector<Meshlet>& meshlets,
+		const mat4& viewProjection,
+		const mat4& model,
+		const vec3& cameraPos,
+		bool canConeCull,
+		vector<MeshletDrawRange>& outRanges,
+		MeshletCullStats* outStats)
+	{
+		outRanges.clear();
+
+		MeshletCullStats stats{};
+		stats.meshletCount = scast<u32>(meshlets.size());
+
+		//planes of the combined matrix are in model space, so spheres are tested without transforming them
+		mat4 m = viewProjection * model;
+
+		vec4 row0(m.m00, m.m01, m.m02, m.m03);
+		vec4 row1(m.m10, m.m11, m.m12, m.m13);
+		vec4 row2(m.m20, m.m21, m.m22, m.m23);
+		vec4 row3(m.m30, m.m31, m.m32, m.m33);
+
+		array<vec4, 6> planes =
+		{
+			row3 + row0,
+			row3 - row0,
+			row3 + row1,
+			row3 - row1,
+			row3 + row2,
+			row3 - row2
+		};
+
+		for (vec4& p : planes)
+		{
+			f32 len = length(vec3(p.x, p.y, p.z));
+			if (len > 0.0f) p = p / len;
+		}
+
+		//camera in model space, only exact for rotation, translation and uniform positive scale
+		vec3 axisX(model.m00, model.m10, model.m20);
+		vec3 axisY(model.m01, model.m11, model.m21);
+		vec3 axisZ(model.m02, model.m12, model.m22);
+
+		f32 scaleX = dot(axisX, axisX);
+		f32 scaleY = dot(axisY, axisY);
+		f32 scaleZ = dot(axisZ, axisZ);
+
+		bool isUniform =
+			scaleX > 0.0f
+			&& fabs(scaleY - scaleX) <= scaleX * UNIFORM_SCALE_TOLERANCE
+			&& fabs(scaleZ - scaleX) <= scaleX * UNIFORM_SCALE_TOLERANCE
+			&& dot(cross(axisX, axisY), axisZ) > 0.0f;
+
+		bool useCone = canConeCull && isUniform;
+
+		vec3 localCamera{};
+		if (useCone)
+		{
+			vec3 d = cameraPos - vec3(model.m03, model.m13, model.m23);
+			localCamera = vec3(dot(axisX, d), dot(axisY, d), dot(axisZ, d)) / scaleX;
+		}
+
+		for (const Meshlet& meshlet : meshlets)
+		{
+			bool isInside = true;
+			for (const vec4& p : planes)
+			{
+				f32 distance =
+					p.x * meshlet.center.x
+					+ p.y * meshlet.center.y
+					+ p.z * meshlet.center.z
+					+ p.w;
+
+				if (distance < -meshlet.radius)
+				{
+					isInside = false;
+					break;
+				}
+			}
+
+			if (!isInside)
+			{
+				++stats.frustumCulled;
+				continue;
+			}
+
+			//every direction from the camera into the sphere stays within the back side of every normal in the cone
+			if (useCone
+				&& meshlet.coneCutoff < 1.0f)
+			{
+				vec3 d = meshlet.center - localCamera;
+
+				if (dot(d, meshlet.coneAxis) >= meshlet.coneCutoff * length(d) + meshlet.radius)
+				{
+					++stats.coneCulled;
+					continue;
+				}
+			}
+
+			if (!outRanges.empty()
+				&& outRanges.back().firstIndex + outRanges.back().indexCount == meshlet.firstIndex)
+			{
+				outRanges.back().indexCount += meshlet.indexCount;
+			}
+			else outRanges.push_back({ meshlet.firstIndex, meshlet.indexCount });
+		}
+
+		stats.rangeCount = scast<u32>(outRanges.size());
+
+		if (outStats) *outStats = stats;
+	}
+}
+
+void ComputeBounds(
+	Meshlet& meshlet,
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices,
+	const vector<u32>& meshletVertices)
+{
+	vec3 boundsMin(1e30f);
+	vec3 boundsMax(-1e30f);
+
+	for (u32 index : meshletVertices)
+	{
+		vec3 p = GetPos(vertices, index);
+
+		boundsMin = vec3(min(boundsMin.x, p.x), min(boundsMin.y, p.y), min(boundsMin.z, p.z));
+		boundsMax = vec3(max(boundsMax.x, p.x), max(boundsMax.y, p.y), max(boundsMax.z, p.z));
+	}
+
+	meshlet.center = (boundsMin + boundsMax) * 0.5f;
+
+	f32 radiusSq{};
+	for (u32 index : meshletVertices)
+	{
+		vec3 d = GetPos(vertices, index) - meshlet.center;
+		radiusSq = max(radiusSq, dot(d, d));
+	}
+	meshlet.radius = sqrt(radiusSq);
+
+	//unit face normals, degenerate triangles have no facing and are skipped
+	vector<vec3> normals{};
+	normals.reserve(meshlet.indexCount / 3);
+
+	vec3 axis{};
+
+	for (u32 i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; i += 3)
+	{
+		vec3 a = GetPos(vertices, indices[i]);
+		vec3 b = GetPos(vertices, indices[i + 1]);
+		vec3 c = GetPos(vertices, indices[i + 2]);
+
+		vec3 n = cross(b - a, c - a);
+		f32 len = length(n);
+		if (len <= 1e-12f) continue;
+
+		n = n / len;
+		normals.push_back(n);
+		axis = axis + n;
+	}
+
+	f32 axisLength = length(axis);
+	if (normals.empty()
+		|| axisLength <= 1e-6f)
+	{
+		meshlet.coneAxis = {};
+		meshlet.coneCutoff = 1.0f;
+		return;
+	}
+
+	axis = axis / axisLength;
+
+	f32 minDot = 1.0f;
+	for (const vec3& n : normals)
+	{
+		minDot = min(minDot, dot(axis, n));
+	}
+
+	meshlet.coneAxis = axis;
+
+	//a cone of 90 degrees or wider always has a front facing triangle
+	meshlet.coneCutoff = minDot <= 0.0f
+		? 1.0f
+		: sqrt(1.0f - minDot * minDot);
+}
+
+vec3 GetPos(
+	const vector<Vertex>& vertices,
+	u32 index)
+{
+	const f32* p = vertices[index].position;
+	return vec3(p[0], p[1], p[2]);
+}
@@ -0,0 +1,310 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <mutex>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "graphics/model_index.hpp"
+#include "core/asset_pack.hpp"
+#include "core/content_hash.hpp"
+#include "core/mapped_file.hpp"
+
+using KalaHeaders::KalaModelData::ModelHeader;
+using KalaHeaders::KalaModelData::ModelTable;
+using KalaHeaders::KalaModelData::ModelBlock;
+using KalaHeaders::KalaModelData::ImportResult;
+using KalaHeaders::KalaModelData::ResultToString;
+using KalaHeaders::KalaModelData::ParseHeaderData;
+using KalaHeaders::KalaModelData::ParseTableData;
+using KalaHeaders::KalaModelData::ParseBlockData;
+using KalaHeaders::KalaModelData::CORRECT_MODEL_HEADER_SIZE;
+using KalaHeaders::KalaModelData::VERTICE_DATA_OFFSET;
+
+using GameTest::Graphics::ModelIndex;
+using GameTest::Graphics::ModelIndexEntry;
+using GameTest::Core::AssetPack;
+using GameTest::Core::ContentHash;
+using GameTest::Core::FileMapping;
+using GameTest::GameObject::MeshFile;
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::move;
+using std::memchr;
+using std::lock_guard;
+using std::filesystem::path;
+
+//byte offset and size of the mesh name inside a kmd model block
+constexpr u32 BLOCK_MESH_NAME_OFFSET = 20u;
+constexpr u32 BLOCK_NAME_SIZE = 20u;
+
+//returned by the lookups when nothing matches
+static const vector<u32> noMatches{};
+
+//Name up to the first null, names that fill the whole field have none
+static string_view TrimName(const char* name);
+
+static bool MatchPattern(
+	string_view pattern,
+	string_view text);
+
+namespace GameTest::Graphics
+{
+	string ModelIndex::Open(const path& modelPath)
+	{
+		Close();
+
+		string pathString = modelPath.string();
+
+		//packed files are indexed straight from the mounted pack, compressed entries have to be decoded whole
+		if (AssetPack::FindEntry(modelPath))
+		{
+			data = AssetPack::GetMappedData(modelPath, size);
+			if (!data)
+			{
+				string result = AssetPack::ReadBinary(modelPath, decoded);
+				if (!result.empty()) return "Failed to index model '" + pathString + "'! Reason: " + result;
+
+				data = decoded.data();
+				size = decoded.size();
+			}
+		}
+		else
+		{
+			if (!FileMapping::Map(modelPath, file)) return "Failed to index model '" + pathString + "'! Reason: file could not be mapped.";
+
+			data = file.data;
+			size = file.size;
+		}
+
+		auto Fail = [this, &pathString](ImportResult result)
+			{
+				Close();
+				return "Failed to index model '" + pathString + "'! Reason: " + ResultToString(result);
+			};
+
+		if (size < CORRECT_MODEL_HEADER_SIZE) return Fail(ImportResult::RESULT_UNSUPPORTED_FILE_SIZE);
+
+		ModelHeader header{};
+
+		ImportResult result = ParseHeaderData(data, header);
+		if (result != ImportResult::RESULT_SUCCESS) return Fail(result);
+
+		if (CORRECT_MODEL_HEADER_SIZE + u64{ header.modelTablesSize } > size) return Fail(ImportResult::RESULT_UNEXPECTED_EOF);
+
+		vector<ModelTable> tables{};
+		ParseTableData(
+			data + CORRECT_MODEL_HEADER_SIZE,
+			header,
+			tables);
+
+		entries.reserve(tables.size());
+
+		//only the mesh name is read from each block, the rest of the block stays untouched
+		for (const ModelTable& t : tables)
+		{
+			if (t.blockSize < VERTICE_DATA_OFFSET
+				|| u64{ t.blockOffset } + t.blockSize > size)
+			{
+				return Fail(ImportResult::RESULT_UNEXPECTED_EOF);
+			}
+
+			ModelIndexEntry& entry = entries.emplace_back();
+			entry.nodeName = string(TrimName(t.nodeName));
+			entry.meshName = string(TrimName(rcast<const char*>(data + t.blockOffset + BLOCK_MESH_NAME_OFFSET)));
+			entry.table = t;
+
+			u32 index = scast<u32>(entries.size() - 1);
+			nodeLookup[entry.nodeName].push_back(index);
+			meshLookup[entry.meshName].push_back(index);
+		}
+
+		filePath = move(pathString);
+
+		return{};
+	}
+
+	void ModelIndex::Close()
+	{
+		FileMapping::Unmap(file);
+
+		decoded.clear();
+		decoded.shrink_to_fit();
+
+		data = nullptr;
+		size = 0;
+		hash = 0;
+
+		filePath.clear();
+		entries.clear();
+		nodeLookup.clear();
+		meshLookup.clear();
+	}
+
+	const vector<u32>& ModelIndex::FindNode(string_view nodeName) const
+	{
+		auto it = nodeLookup.find(string(nodeName));
+		return it != nodeLookup.end() ? it->second : noMatches;
+	}
+
+	const vector<u32>& ModelIndex::FindMesh(string_view meshName) const
+	{
+		auto it = meshLookup.find(string(meshName));
+		return it != meshLookup.end() ? it->second : noMatches;
+	}
+
+	vector<u32> ModelIndex::FindMatching(string_view pattern) const
+	{
+		vector<u32> indices{};
+
+		for (u32 i = 0; i < scast<u32>(entries.size()); ++i)
+		{
+			const ModelIndexEntry& entry = entries[i];
+
+			if (MatchPattern(pattern, entry.nodeName)
+				|| MatchPattern(pattern, entry.meshName))
+			{
+				indices.push_back(i);
+			}
+		}
+
+		return indices;
+	}
+
+	string ModelIndex::ReadBlocks(
+		const vector<u32>& indices,
+		vector<ModelBlock>& outBlocks) const
+	{
+		if (!IsOpen()) return "Cannot read blocks because the model index is not open!";
+
+		vector<ModelTable> tables{};
+		tables.reserve(indices.size());
+
+		for (u32 i : indices)
+		{
+			if (i >= entries.size()) return "Cannot read blocks from model '" + filePath + "' because a block index is out of range!";
+
+			tables.push_back(entries[i].table);
+		}
+
+		vector<ModelBlock> blocks{};
+		ImportResult result{};
+
+		try
+		{
+			result = ParseBlockData(
+				data,
+				scast<size_t>(size),
+				0,
+				tables,
+				blocks);
+		}
+		catch (...)
+		{
+			return "Failed to read blocks from model '" + filePath + "'! Reason: block data could not be parsed.";
+		}
+
+		if (result != ImportResult::RESULT_SUCCESS)
+		{
+			return "Failed to read blocks from model '" + filePath + "'! Reason: " + ResultToString(result);
+		}
+
+		outBlocks = move(blocks);
+
+		return{};
+	}
+
+	u64 ModelIndex::GetHash() const
+	{
+		if (!IsOpen()) return 0;
+
+		lock_guard<mutex> lock(hashMutex);
+
+		if (hash == 0)
+		{
+			hash = ContentHash::HashBytes(
+				data,
+				scast<size_t>(size));
+		}
+
+		return hash;
+	}
+
+	MeshFile ModelIndex::GetFile(const vector<u32>& indices) const
+	{
+		MeshFile meshFile{};
+		meshFile.path = filePath;
+		meshFile.hash = GetHash();
+
+		meshFile.tables.reserve(indices.size());
+		for (u32 i : indices)
+		{
+			if (i < entries.size()) meshFile.tables.push_back(entries[i].table);
+		}
+
+		return meshFile;
+	}
+}
+
+string_view TrimName(const char* name)
+{
+	const void* end = memchr(name, '\0', BLOCK_NAME_SIZE);
+
+	return string_view(
+		name,
+		end ? scast<size_t>(scast<const char*>(end) - name) : BLOCK_NAME_SIZE);
+}
+
+bool MatchPattern(
+	string_view pattern,
+	string_view text)
+{
+	size_t p{};
+	size_t t{};
+
+	//position of the last '*' and the text it was tried against, for backtracking
+	size_t starPattern = string_view::npos;
+	size_t starText{};
+
+	while (t < text.size())
+	{
+		if (p < pattern.size()
+			&& (pattern[p] == '?'
+			|| pattern[p] == text[t]))
+		{
+			++p;
+			++t;
+		}
+		else if (p < pattern.size()
+			&& pattern[p] == '*')
+		{
+			starPattern = p++;
+			starText = t;
+		}
+		else if (starPattern != string_view::npos)
+		{
+			//let the last '*' swallow one more character
+			p = starPattern + 1;
+			t = ++starText;
+		}
+		else return false;
+	}
+
+	while (p < pattern.size()
+		&& pattern[p] == '*')
+	{
+		++p;
+	}
+
+	return p == pattern.size();
+}
@@ -0,0 +1,576 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define OCCLUSION_SSE2 1
+#endif
+
+#include "graphics/occlusion_culler.hpp"
+
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::vec4;
+using KalaHeaders::KalaMath::mat4;
+using KalaHeaders::KalaModelData::Vertex;
+
+using GameTest::Graphics::OcclusionCuller;
+using GameTest::Graphics::OccluderMesh;
+using GameTest::Graphics::OCCLUSION_TILE_SIZE;
+using GameTest::Core::ThreadPool;
+
+using std::vector;
+using std::unordered_map;
+using std::min;
+using std::max;
+using std::partial_sort;
+using std::iota;
+using std::floor;
+using std::ceil;
+using std::fill;
+using std::swap;
+
+//rows of tiles handed to one worker at a time
+constexpr u32 BAND_TILE_ROWS = 2u;
+
+//column vector transform in gl convention, mat4 stores m<row><col>
+static vec4 TransformPoint(
+	const mat4& m,
+	const vec3& p);
+
+static f32 TriangleArea(
+	const vec3& a,
+	const vec3& b,
+	const vec3& c);
+
+namespace GameTest::Graphics
+{
+	OcclusionCuller::OcclusionCuller(
+		u32 newWidth,
+		u32 newHeight)
+	{
+		tilesX = max(1u, (newWidth + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE);
+		tilesY = max(1u, (newHeight + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE);
+
+		width = tilesX * OCCLUSION_TILE_SIZE;
+		height = tilesY * OCCLUSION_TILE_SIZE;
+
+		depth.assign(scast<size_t>(width) * height, 1.0f);
+		tileMaxDepth.assign(scast<size_t>(tilesX) * tilesY, 1.0f);
+	}
+
+	OccluderMesh OcclusionCuller::BuildOccluder(
+		const vector<Vertex>& vertices,
+		const vector<u32>& indices,
+		u32 maxTriangles)
+	{
+		size_t triangleCount = indices.size() / 3;
+
+		auto GetPos = [&vertices](u32 index)
+			{
+				const f32* p = vertices[index].position;
+				return vec3(p[0], p[1], p[2]);
+			};
+
+		vector<f32> areas(triangleCount);
+		for (size_t i = 0; i < triangleCount; ++i)
+		{
+			u32 a = indices[i * 3];
+			u32 b = indices[i * 3 + 1];
+			u32 c = indices[i * 3 + 2];
+
+			areas[i] =
+				a < vertices.size()
+				&& b < vertices.size()
+				&& c < vertices.size()
+				? TriangleArea(GetPos(a), GetPos(b), GetPos(c))
+				: 0.0f;
+		}
+
+		vector<u32> order(triangleCount);
+		iota(order.begin(), order.end(), 0u);
+
+		size_t keep = min(triangleCount, scast<size_t>(maxTriangles));
+		partial_sort(
+			order.begin(),
+			order.begin() + keep,
+			order.end(),
+			[&areas](u32 a, u32 b) { return areas[a] > areas[b]; });
+
+		//keep the original winding and only the vertices that are still referenced
+		OccluderMesh mesh{};
+		unordered_map<u32, u32> remap{};
+
+		for (size_t i = 0; i < keep; ++i)
+		{
+			u32 tri = order[i];
+			if (areas[tri] <= 0.0f) break;
+
+			for (u32 corner = 0; corner < 3; ++corner)
+			{
+				u32 index = indices[tri * 3 + corner];
+
+				auto [it, isNew] = remap.try_emplace(index, scast<u32>(mesh.positions.size()));
+				if (isNew) mesh.positions.push_back(GetPos(index));
+
+				mesh.indices.push_back(it->second);
+			}
+		}
+
+		return mesh;
+	}
+
+	void OcclusionCuller::BeginFrame(const mat4& newViewProjection)
+	{
+		viewProjection = newViewProjection;
+
+		fill(depth.begin(), depth.end(), 1.0f);
+		fill(tileMaxDepth.begin(), tileMaxDepth.end(), 1.0f);
+
+		triangles.clear();
+	}
+
+	void OcclusionCuller::AddOccluder(
+		const OccluderMesh& mesh,
+		const mat4& model)
+	{
+		mat4 mvp = viewProjection * model;
+
+		vector<vec4> clip(mesh.positions.size());
+		for (size_t i = 0; i < mesh.positions.size(); ++i)
+		{
+			clip[i] = TransformPoint(mvp, mesh.positions[i]);
+		}
+
+		for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+		{
+			const vec4 tri[3] =
+			{
+				clip[mesh.indices[i]],
+				clip[mesh.indices[i + 1]],
+				clip[mesh.indices[i + 2]]
+			};
+
+			AddClipTriangle(tri);
+		}
+	}
+
+	void OcclusionCuller::Rasterize(ThreadPool* workers)
+	{
+		u32 bandRows = BAND_TILE_ROWS * OCCLUSION_TILE_SIZE;
+		u32 bandCount = (height + bandRows - 1) / bandRows;
+
+		auto RunBand = [this, bandRows](size_t band)
+			{
+				u32 firstRow = scast<u32>(band) * bandRows;
+				RasterizeBand(firstRow, min(firstRow + bandRows, height));
+			};
+
+		//bands never share a row, so workers write without locks
+		if (workers) workers->ParallelFor(bandCount, RunBand);
+		else for (u32 band = 0; band < bandCount; ++band) RunBand(band);
+	}
+
+	bool OcclusionCuller::IsVisible(
+		const vec3& boundsMin,
+		const vec3& boundsMax,
+		const mat4& model) const
+	{
+		mat4 mvp = viewProjection * model;
+
+		f32 minX = 1e30f;
+		f32 minY = 1e30f;
+		f32 maxX = -1e30f;
+		f32 maxY = -1e30f;
+		f32 minZ = 1e30f;
+
+		//count corners outside each frustum plane, all 8 outside one plane means off screen
+		u32 outside[6]{};
+
+		for (u32 corner = 0; corner < 8; ++corner)
+		{
+			vec3 p(
+				(corner & 1) ? boundsMax.x : boundsMin.x,
+				(corner & 2) ? boundsMax.y : boundsMin.y,
+				(corner & 4) ? boundsMax.z : boundsMin.z);
+
+			vec4 c = TransformPoint(mvp, p);
+
+			if (c.x < -c.w) ++outside[0];
+			if (c.x > c.w) ++outside[1];
+			if (c.y < -c.w) ++outside[2];
+			if (c.y > c.w) ++outside[3];
+			if (c.z > c.w) ++outside[4];
+
+			//corners behind the near plane can't be projected
+			if (c.z < -c.w)
+			{
+				++outside[5];
+				continue;
+			}
+
+			f32 invW = 1.0f / c.w;
+			f32 sx = (c.x * invW * 0.5f + 0.5f) * width;
+			f32 sy = (c.y * invW * 0.5f + 0.5f) * height;
+			f32 sz = c.z * invW * 0.5f + 0.5f;
+
+			minX = min(minX, sx);
+			maxX = max(maxX, sx);
+			minY = min(minY, sy);
+			maxY = max(maxY, sy);
+			minZ = min(minZ, sz);
+		}
+
+		for (u32 count : outside)
+		{
+			if (count == 8) return false;
+		}
+
+		//a box crossing the near plane is too close to test, assume visible
+		if (outside[5] > 0) return true;
+
+		//every pixel the box touches
+		i32 px0 = max(0, scast<i32>(floor(minX)));
+		i32 py0 = max(0, scast<i32>(floor(minY)));
+		i32 px1 = min(scast<i32>(width), scast<i32>(ceil(maxX)));
+		i32 py1 = min(scast<i32>(height), scast<i32>(ceil(maxY)));
+
+		px1 = max(px1, min(px0 + 1, scast<i32>(width)));
+		py1 = max(py1, min(py0 + 1, scast<i32>(height)));
+
+		i32 tx0 = px0 / scast<i32>(OCCLUSION_TILE_SIZE);
+		i32 ty0 = py0 / scast<i32>(OCCLUSION_TILE_SIZE);
+		i32 tx1 = (px1 - 1) / scast<i32>(OCCLUSION_TILE_SIZE);
+		i32 ty1 = (py1 - 1) / scast<i32>(OCCLUSION_TILE_SIZE);
+
+		for (i32 ty = ty0; ty <= ty1; ++ty)
+		{
+			for (i32 tx = tx0; tx <= tx1; ++tx)
+			{
+				//the whole tile is nearer than the box
+				if (tileMaxDepth[scast<size_t>(ty) * tilesX + tx] < minZ) continue;
+
+				i32 x0 = max(px0, tx * scast<i32>(OCCLUSION_TILE_SIZE));
+				i32 y0 = max(py0, ty * scast<i32>(OCCLUSION_TILE_SIZE));
+				i32 x1 = min(px1, (tx + 1) * scast<i32>(OCCLUSION_TILE_SIZE));
+				i32 y1 = min(py1, (ty + 1) * scast<i32>(OCCLUSION_TILE_SIZE));
+
+				for (i32 y = y0; y < y1; ++y)
+				{
+					const f32* row = depth.data() + scast<size_t>(y) * width;
+					for (i32 x = x0; x < x1; ++x)
+					{
+						if (row[x] >= minZ) return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	void OcclusionCuller::AddClipTriangle(const vec4 (&clip)[3])
+	{
+		//trivially reject triangles fully outside one of the side or far planes
+		auto AllOutside = [&clip](auto test)
+			{
+				return test(clip[0]) && test(clip[1]) && test(clip[2]);
+			};
+
+		if (AllOutside([](const vec4& c) { return c.x < -c.w; })
+			|| AllOutside([](const vec4& c) { return c.x > c.w; })
+			|| AllOutside([](const vec4& c) { return c.y < -c.w; })
+			|| AllOutside([](const vec4& c) { return c.y > c.w; })
+			|| AllOutside([](const vec4& c) { return c.z > c.w; }))
+		{
+			return;
+		}
+
+		//clip against the near plane z = -w, which leaves at most 4 vertices
+		vec4 poly[4]{};
+		u32 count{};
+
+		for (u32 i = 0; i < 3; ++i)
+		{
+			const vec4& a = clip[i];
+			const vec4& b = clip[(i + 1) % 3];
+
+			f32 da = a.z + a.w;
+			f32 db = b.z + b.w;
+
+			if (da >= 0.0f) poly[count++] = a;
+			if ((da >= 0.0f) != (db >= 0.0f))
+			{
+				f32 t = da / (da - db);
+				poly[count++] = a + (b - a) * t;
+			}
+		}
+
+		if (count < 3) return;
+
+		vec3 screen[4]{};
+		for (u32 i = 0; i < count; ++i)
+		{
+			f32 invW = 1.0f / poly[i].w;
+			screen[i] = vec3(
+				(poly[i].x * invW * 0.5f + 0.5f) * width,
+				(poly[i].y * invW * 0.5f + 0.5f) * height,
+				poly[i].z * invW * 0.5f + 0.5f);
+		}
+
+		for (u32 i = 1; i + 1 < count; ++i)
+		{
+			const vec3& v0 = screen[0];
+			const vec3& v1 = screen[i];
+			const vec3& v2 = screen[i + 1];
+
+			//counter clockwise is front facing, the same as the gl state in Render
+			f32 area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+			if (area <= 0.0f) continue;
+
+			ScreenTriangle tri{};
+			tri.x[0] = v0.x; tri.y[0] = v0.y; tri.z[0] = v0.z;
+			tri.x[1] = v1.x; tri.y[1] = v1.y; tri.z[1] = v1.z;
+			tri.x[2] = v2.x; tri.y[2] = v2.y; tri.z[2] = v2.z;
+
+			tri.minY = min({ v0.y, v1.y, v2.y });
+			tri.maxY = max({ v0.y, v1.y, v2.y });
+
+			if (tri.maxY < 0.0f
+				|| tri.minY > scast<f32>(height))
+			{
+				continue;
+			}
+
+			triangles.push_back(tri);
+		}
+	}
+
+	void OcclusionCuller::RasterizeBand(
+		u32 firstRow,
+		u32 endRow)
+	{
+		for (const auto& tri : triangles)
+		{
+			if (tri.maxY < scast<f32>(firstRow)
+				|| tri.minY > scast<f32>(endRow))
+			{
+				continue;
+			}
+
+			RasterizeTriangle(tri, firstRow, endRow);
+		}
+
+		//refresh the farthest depth of every tile in this band
+		for (u32 ty = firstRow / OCCLUSION_TILE_SIZE; ty < endRow / OCCLUSION_TILE_SIZE; ++ty)
+		{
+			for (u32 tx = 0; tx < tilesX; ++tx)
+			{
+				f32 farthest{};
+				for (u32 y = 0; y < OCCLUSION_TILE_SIZE; ++y)
+				{
+					const f32* row = depth.data()
+						+ scast<size_t>(ty * OCCLUSION_TILE_SIZE + y) * width
+						+ tx * OCCLUSION_TILE_SIZE;
+
+					for (u32 x = 0; x < OCCLUSION_TILE_SIZE; ++x) farthest = max(farthest, row[x]);
+				}
+
+				tileMaxDepth[scast<size_t>(ty) * tilesX + tx] = farthest;
+			}
+		}
+	}
+
+	void OcclusionCuller::RasterizeTriangle(
+		const ScreenTriangle& tri,
+		u32 firstRow,
+		u32 endRow)
+	{
+		//edge i is opposite vertex i, positive inside for counter clockwise triangles
+		f32 edgeA[3]{};
+		f32 edgeB[3]{};
+		f32 edgeC[3]{};
+
+		//pixel centers exactly on an edge go to one side only, the neighbour sharing the edge
+		//sees it flipped and leaves them out, so meshes have no cracks along their diagonals
+		bool isOwnEdge[3]{};
+
+		for (u32 i = 0; i < 3; ++i)
+		{
+			u32 a = (i + 1) % 3;
+			u32 b = (i + 2) % 3;
+
+			//both triangles of a shared edge build it from the same end so their
+			//edge values are exact negatives of each other, not just close
+			bool isSwapped = tri.x[b] < tri.x[a]
+				|| (tri.x[b] == tri.x[a]
+				&& tri.y[b] < tri.y[a]);
+			if (isSwapped) swap(a, b);
+
+			edgeA[i] = tri.y[a] - tri.y[b];
+			edgeB[i] = tri.x[b] - tri.x[a];
+			edgeC[i] = -(edgeA[i] * tri.x[a] + edgeB[i] * tri.y[a]);
+
+			if (isSwapped)
+			{
+				edgeA[i] = -edgeA[i];
+				edgeB[i] = -edgeB[i];
+				edgeC[i] = -edgeC[i];
+			}
+
+			isOwnEdge[i] = edgeA[i] > 0.0f
+				|| (edgeA[i] == 0.0f
+				&& edgeB[i] > 0.0f);
+		}
+
+		f32 area = edgeC[0] + edgeC[1] + edgeC[2];
+		if (area <= 0.0f) return;
+
+		//depth as a plane over the screen
+		f32 invArea = 1.0f / area;
+		f32 zA = (edgeA[0] * tri.z[0] + edgeA[1] * tri.z[1] + edgeA[2] * tri.z[2]) * invArea;
+		f32 zB = (edgeB[0] * tri.z[0] + edgeB[1] * tri.z[1] + edgeB[2] * tri.z[2]) * invArea;
+		f32 zC = (edgeC[0] * tri.z[0] + edgeC[1] * tri.z[1] + edgeC[2] * tri.z[2]) * invArea;
+
+		f32 minX = min({ tri.x[0], tri.x[1], tri.x[2] });
+		f32 maxX = max({ tri.x[0], tri.x[1], tri.x[2] });
+
+		i32 x0 = max(0, scast<i32>(floor(minX)));
+		i32 x1 = min(scast<i32>(width) - 1, scast<i32>(ceil(maxX)));
+		i32 y0 = max(scast<i32>(firstRow), scast<i32>(floor(tri.minY)));
+		i32 y1 = min(scast<i32>(endRow) - 1, scast<i32>(ceil(tri.maxY)));
+
+		if (x0 > x1
+			|| y0 > y1)
+		{
+			return;
+		}
+
+		//the buffer width is a multiple of 8, so aligned groups of 4 never leave the row
+		x0 &= ~3;
+
+#ifdef OCCLUSION_SSE2
+		const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 zero = _mm_setzero_ps();
+
+		const __m128 stepX = _mm_set1_ps(4.0f);
+
+		__m128 laneA[3]{};
+		for (u32 i = 0; i < 3; ++i) laneA[i] = _mm_set1_ps(edgeA[i]);
+		__m128 stepZ = _mm_set1_ps(zA * 4.0f);
+
+		__m128 edge[3]{};
+
+		auto Covers = [&edge, &isOwnEdge, zero](u32 i)
+			{
+				return isOwnEdge[i]
+					? _mm_cmpge_ps(edge[i], zero)
+					: _mm_cmpgt_ps(edge[i], zero);
+			};
+
+		for (i32 y = y0; y <= y1; ++y)
+		{
+			f32 py = scast<f32>(y) + 0.5f;
+			__m128 px = _mm_add_ps(_mm_set1_ps(scast<f32>(x0)), laneOffsets);
+
+			__m128 rowEdge[3]{};
+			for (u32 i = 0; i < 3; ++i) rowEdge[i] = _mm_set1_ps(edgeB[i] * py + edgeC[i]);
+
+			__m128 z = _mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(zA), px),
+				_mm_set1_ps(zB * py + zC));
+
+			f32* row = depth.data() + scast<size_t>(y) * width;
+
+			for (i32 x = x0; x <= x1; x += 4)
+			{
+				//evaluated fresh per group instead of stepped, stepping would round
+				//differently in each triangle and open the cracks again
+				for (u32 i = 0; i < 3; ++i) edge[i] = _mm_add_ps(_mm_mul_ps(laneA[i], px), rowEdge[i]);
+
+				__m128 inside = _mm_and_ps(
+					_mm_and_ps(
+						Covers(0),
+						Covers(1)),
+					Covers(2));
+
+				if (_mm_movemask_ps(inside) != 0)
+				{
+					__m128 old = _mm_loadu_ps(row + x);
+					__m128 nearer = _mm_min_ps(old, z);
+
+					_mm_storeu_ps(
+						row + x,
+						_mm_or_ps(
+							_mm_and_ps(inside, nearer),
+							_mm_andnot_ps(inside, old)));
+				}
+
+				px = _mm_add_ps(px, stepX);
+				z = _mm_add_ps(z, stepZ);
+			}
+		}
+#else
+		for (i32 y = y0; y <= y1; ++y)
+		{
+			f32 py = scast<f32>(y) + 0.5f;
+			f32* row = depth.data() + scast<size_t>(y) * width;
+
+			for (i32 x = x0; x <= x1; ++x)
+			{
+				f32 px = scast<f32>(x) + 0.5f;
+
+				bool isInside = true;
+				for (u32 i = 0; i < 3; ++i)
+				{
+					f32 e = edgeA[i] * px + edgeB[i] * py + edgeC[i];
+					if (e < 0.0f
+						|| (e == 0.0f
+						&& !isOwnEdge[i]))
+					{
+						isInside = false;
+					}
+				}
+
+				if (!isInside) continue;
+
+				row[x] = min(row[x], zA * px + zB * py + zC);
+			}
+		}
+#endif
+	}
+}
+
+vec4 TransformPoint(
+	const mat4& m,
+	const vec3& p)
+{
+	return vec4(
+		m.m00 * p.x + m.m01 * p.y + m.m02 * p.z + m.m03,
+		m.m10 * p.x + m.m11 * p.y + m.m12 * p.z + m.m13,
+		m.m20 * p.x + m.m21 * p.y + m.m22 * p.z + m.m23,
+		m.m30 * p.x + m.m31 * p.y + m.m32 * p.z + m.m33);
+}
+
+f32 TriangleArea(
+	const vec3& a,
+	const vec3& b,
+	const vec3& c)
+{
+	vec3 ab = b - a;
+	vec3 ac = c - a;
+
+	vec3 cross(
+		ab.y * ac.z - ab.z * ac.y,
+		ab.z * ac.x - ab.x * ac.z,
+		ab.x * ac.y - ab.y * ac.x);
+
+	return 0.5f * sqrtf(cross.x * cross.x + cross.y * cross.y + cross.z * cross.z);
+}
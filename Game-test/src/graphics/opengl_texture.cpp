@@ -24,7 +24,9 @@
 #include "opengl/kw_opengl.hpp"
 #include "opengl/kw_opengl_functions_core.hpp"
 
+#include "core/asset_pack.hpp"
 #include "graphics/opengl_texture.hpp"
+#include "graphics/texture_uploader.hpp"
 
 using KalaHeaders::KalaMath::vec2;
 using KalaHeaders::KalaLog::Log;
@@ -36,8 +38,11 @@ using KalaWindow::OpenGL::OpenGL_Global;
 using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
 using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
 
+using GameTest::Core::AssetPack;
 using GameTest::Graphics::OpenGL_Texture;
 using GameTest::Graphics::TextureFormat;
+using GameTest::Graphics::TexturePixels;
+using GameTest::Graphics::TextureUploader;
 
 using std::string;
 using std::string_view;
@@ -46,7 +51,6 @@ using std::unordered_map;
 using std::unique_ptr;
 using std::make_unique;
 using std::filesystem::path;
-using std::filesystem::exists;
 using std::vector;
 using std::ostringstream;
 using std::clamp;
@@ -86,6 +90,14 @@ static bool CheckTextureData(
 	vector<u8>& outData,
 	int& outNrChannels);
 
+//creates the gl texture object and sets its sampling state,
+//the size is checked here because the limit has to be queried from the gl context
+static bool GenerateTexture(
+	const string& name,
+	vec2 size,
+	u8 mipMapLevels,
+	u32& outTextureID);
+
 static bool IsValidTexture(
 	const string& textureName,
 	const string& texturePath);
@@ -164,6 +176,7 @@ namespace GameTest::Graphics
 			format,
 			flipVertically,
 			mipMapLevels,
+			false,
 			[&](u32& outTextureID,
 				vector<vector<u8>>& outData,
 				vec2& outSize,
@@ -186,55 +199,80 @@ namespace GameTest::Graphics
 					newData,
 					newNrChannels)) return false;
 
-				//
-				// BIND TEXTURE
-				//
+				if (!GenerateTexture(
+					name,
+					newSize,
+					mipMapLevels,
+					newTextureID)) return false;
 
-				const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+				outTextureID = newTextureID;
+				outData = { move(newData) };
+				outSize = newSize;
+				outFormat = newFormat;
 
-				coreFunc->glGenTextures(1, &newTextureID);
+				return true;
+			});
+	}
 
-				GLenum target = GL_TEXTURE_2D;
-				GLFormatInfo fmt = ToGLFormat(newFormat);
+	string OpenGL_Texture::DecodeFile(
+		const string& name,
+		const string& path,
+		TextureFormat format,
+		bool flipVertically,
+		TexturePixels& outPixels)
+	{
+		int nrChannels{};
 
-				coreFunc->glBindTexture(target, newTextureID);
+		if (!CheckTextureData(
+			name,
+			path,
+			flipVertically,
+			format,
+			outPixels.format,
+			outPixels.size,
+			outPixels.data,
+			nrChannels))
+		{
+			return "Failed to decode texture '" + name + "' from path '" + path + "'!";
+		}
 
-				coreFunc->glTexParameteri(
-					target,
-					GL_TEXTURE_WRAP_S,
-					GL_REPEAT);
-				coreFunc->glTexParameteri(
-					target,
-					GL_TEXTURE_WRAP_T,
-					GL_REPEAT);
+		return{};
+	}
 
-				if (target == GL_TEXTURE_3D)
-				{
-					coreFunc->glTexParameteri(
-						target,
-						GL_TEXTURE_WRAP_R,
-						GL_REPEAT);
-				}
-
-				//
-				// FILTERING
-				//
-
-				coreFunc->glTexParameteri(
-					target,
-					GL_TEXTURE_MIN_FILTER,
-					mipMapLevels > 1
-					? GL_LINEAR_MIPMAP_LINEAR
-					: GL_LINEAR);
-				coreFunc->glTexParameteri(
-					target,
-					GL_TEXTURE_MAG_FILTER,
-					GL_LINEAR);
+	OpenGL_Texture* OpenGL_Texture::InitializeFromPixels(
+		OpenGL_Context* glContext,
+		const string& name,
+		const string& path,
+		TexturePixels pixels,
+		u8 mipMapLevels,
+		bool isAsync)
+	{
+		return TextureBody(
+			glContext,
+			name,
+			{ path },
+			pixels.format,
+			false,
+			mipMapLevels,
+			isAsync,
+			[&](u32& outTextureID,
+				vector<vector<u8>>& outData,
+				vec2& outSize,
+				TextureFormat& outFormat)
+			{
+				u32 newTextureID{};
+
+				if (pixels.data.empty()
+					|| !GenerateTexture(
+					name,
+					pixels.size,
+					mipMapLevels,
+					newTextureID)) return false;
 
 				outTextureID = newTextureID;
-				outData = { move(newData) };
-				outSize = newSize;
-				outFormat = newFormat;
+				outData = { move(pixels.data) };
+				outSize = pixels.size;
+				outFormat = pixels.format;
 
 				return true;
 			});
@@ -242,6 +280,16 @@ namespace GameTest::Graphics
 
 	bool OpenGL_Texture::IsInitialized() const { return isInitialized; }
 
+	bool OpenGL_Texture::IsUploaded() const { return isUploaded; }
+
+	u32 OpenGL_Texture::GetSampleID() const
+	{
+		if (isUploaded) return textureID;
+
+		OpenGL_Texture* fallback = GetFallbackTexture();
+		return fallback ? fallback->textureID : 0;
+	}
+
 	OpenGL_Texture* OpenGL_Texture::GetFallbackTexture()
 	{
 		if (!fallbackTexture)
@@ -296,6 +344,7 @@ namespace GameTest::Graphics
 			const auto& pixelData = GetFallbackPixels();
 			newTexture->pixels.assign(pixelData.begin(), pixelData.end());
 			newTexture->format = TextureFormat::Format_RGBA8;
+			newTexture->isUploaded = true;
 
 			string errorVal = OpenGL_Global::GetError();
 			if (!errorVal.empty())
@@ -364,6 +413,7 @@ namespace GameTest::Graphics
 		TextureFormat format,
 		bool flipVertically,
 		u8 mipMapLevels,
+		bool isAsync,
 		const function<bool(
 			u32& outTextureID,
 			vector<vector<u8>>& outData,
@@ -475,18 +525,32 @@ namespace GameTest::Graphics
 				static_cast<GLsizei>(newSize.x),
 				static_cast<GLsizei>(newSize.y));
 
-			coreFunc->glTexSubImage2D(
-				GL_TEXTURE_2D,
-				0,
-				0,
-				0,
-				static_cast<GLsizei>(newSize.x),
-				static_cast<GLsizei>(newSize.y),
-				fmt.format,
-				fmt.type,
-				texturePtr->pixels.data());
+			//the uploader copies and uploads level 0 and the mips over the next frames
+			bool isQueued =
+				isAsync
+				&& TextureUploader::Queue(
+					texturePtr,
+					fmt.format,
+					fmt.type,
+					mipMapLevels);
 
-			if (mipMapLevels > 1) coreFunc->glGenerateMipmap(targetType);
+			if (!isQueued)
+			{
+				coreFunc->glTexSubImage2D(
+					GL_TEXTURE_2D,
+					0,
+					0,
+					0,
+					static_cast<GLsizei>(newSize.x),
+					static_cast<GLsizei>(newSize.y),
+					fmt.format,
+					fmt.type,
+					texturePtr->pixels.data());
+
+				if (mipMapLevels > 1) coreFunc->glGenerateMipmap(targetType);
+
+				texturePtr->isUploaded = true;
+			}
 
 			string errorVal = OpenGL_Global::GetError();
 			if (!errorVal.empty())
@@ -518,6 +582,9 @@ namespace GameTest::Graphics
 			"OPENGL_TEXTURE",
 			LogType::LOG_INFO);
 
+		//a pending upload still reads from pixels
+		if (!isUploaded) TextureUploader::Cancel(this);
+
 		if (textureID != 0)
 		{
 			const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
@@ -593,14 +660,36 @@ bool CheckTextureData(
 
 	int width{};
 	int height{};
-	stbi_set_flip_vertically_on_load(flipVertically);
+	//per thread so textures can be decoded on workers
+	stbi_set_flip_vertically_on_load_thread(flipVertically);
+
+	unsigned char* stbiData{};
 
-	unsigned char* stbiData = stbi_load(
-		(filePath).c_str(),
-		&width,
-		&height,
-		&newNrChannels,
-		0);
+	//packed textures are decoded straight from the pack instead of the disk
+	if (AssetPack::FindEntry(filePath))
+	{
+		vector<u8> fileData{};
+		string readResult = AssetPack::ReadBinary(filePath, fileData);
+		if (readResult.empty())
+		{
+			stbiData = stbi_load_from_memory(
+				fileData.data(),
+				scast<int>(fileData.size()),
+				&width,
+				&height,
+				&newNrChannels,
+				0);
+		}
+	}
+	else
+	{
+		stbiData = stbi_load(
+			(filePath).c_str(),
+			&width,
+			&height,
+			&newNrChannels,
+			0);
+	}
 
 	if (!stbiData)
 	{
@@ -693,11 +782,25 @@ bool CheckTextureData(
 		return false;
 	}
 
+	outformat = newFormat;
+	outSize = vec2(width, height);
+	outData = newData;
+	outNrChannels = newNrChannels;
+
+	return true;
+}
+
+bool GenerateTexture(
+	const string& name,
+	vec2 size,
+	u8 mipMapLevels,
+	u32& outTextureID)
+{
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
 	//clamp to gpu texture resolution upper bound
 	if (TEXTURE_MAX_SIZE == 0)
 	{
-		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
-
 		GLint maxSize{};
 		coreFunc->glGetIntegerv(
 			GL_MAX_TEXTURE_SIZE,
@@ -706,6 +809,9 @@ bool CheckTextureData(
 		TEXTURE_MAX_SIZE = maxSize;
 	}
 
+	u32 width = static_cast<u32>(size.x);
+	u32 height = static_cast<u32>(size.y);
+
 	if (width > TEXTURE_MAX_SIZE
 		|| height > TEXTURE_MAX_SIZE)
 	{
@@ -713,7 +819,7 @@ bool CheckTextureData(
 
 		ostringstream oss{};
 		oss << "failed to load texture '" << name
-			<< "' because the texture size '" << widthStr << "x" << heightStr
+			<< "' because the texture size '" << to_string(width) << "x" << to_string(height)
 			<< "' is too big! Size cannot be above '" 
 			<< maxSizeStr << "x" << maxSizeStr << "' pixels!";
 
@@ -726,10 +832,42 @@ bool CheckTextureData(
 		return false;
 	}
 
-	outformat = newFormat;
-	outSize = vec2(width, height);
-	outData = newData;
-	outNrChannels = newNrChannels;
+	//
+	// BIND TEXTURE
+	//
+
+	u32 newTextureID{};
+	coreFunc->glGenTextures(1, &newTextureID);
+
+	GLenum target = GL_TEXTURE_2D;
+
+	coreFunc->glBindTexture(target, newTextureID);
+
+	coreFunc->glTexParameteri(
+		target,
+		GL_TEXTURE_WRAP_S,
+		GL_REPEAT);
+	coreFunc->glTexParameteri(
+		target,
+		GL_TEXTURE_WRAP_T,
+		GL_REPEAT);
+
+	//
+	// FILTERING
+	//
+
+	coreFunc->glTexParameteri(
+		target,
+		GL_TEXTURE_MIN_FILTER,
+		mipMapLevels > 1
+		? GL_LINEAR_MIPMAP_LINEAR
+		: GL_LINEAR);
+	coreFunc->glTexParameteri(
+		target,
+		GL_TEXTURE_MAG_FILTER,
+		GL_LINEAR);
+
+	outTextureID = newTextureID;
 
 	return true;
 }
@@ -764,7 +902,7 @@ bool IsValidTexture(
 	}
 
 	//texture file must exist
-	if (!exists(texturePath))
+	if (!AssetPack::Exists(texturePath))
 	{
 		Log::Print(
 			"Cannot load texture '" + textureName + "' because its path '" + texturePath + "' does not exist!",
@@ -0,0 +1,602 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <array>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define PARTICLE_SSE2 1
+#endif
+
+#include "KalaHeaders/core_utils.hpp"
+
+#include "graphics/particle_emitter.hpp"
+
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::vec4;
+
+using GameTest::Graphics::ParticleEmitter;
+using GameTest::Graphics::ParticleEmitterSettings;
+using GameTest::Graphics::ParticleInstance;
+using GameTest::Graphics::PARTICLE_CHUNK_SIZE;
+using GameTest::Core::ThreadPool;
+
+using std::vector;
+using std::array;
+using std::min;
+using std::max;
+using std::clamp;
+using std::fill;
+
+static_assert(PARTICLE_CHUNK_SIZE % 4 == 0, "particle chunks must hold whole simd groups");
+
+#ifdef PARTICLE_SSE2
+using f32x4 = __m128;
+using u32x4 = __m128i;
+#else
+struct f32x4 { f32 v[4]; };
+struct u32x4 { u32 v[4]; };
+#endif
+
+static f32x4 Set1(f32 value);
+static f32x4 Load(const f32* src);
+static void Store(
+	f32* dst,
+	f32x4 value);
+
+//Writes only the first laneCount lanes, for spawn ranges that end mid group
+static void StoreLanes(
+	f32* dst,
+	f32x4 value,
+	u32 laneCount);
+
+static f32x4 Add(f32x4 a, f32x4 b);
+static f32x4 Sub(f32x4 a, f32x4 b);
+static f32x4 Mul(f32x4 a, f32x4 b);
+static f32x4 Div(f32x4 a, f32x4 b);
+static f32x4 Min(f32x4 a, f32x4 b);
+static f32x4 Max(f32x4 a, f32x4 b);
+
+//bit i is set if lane i is zero or less
+static u32 NonPositiveMask(f32x4 value);
+
+//xoshiro128+ step for all four lanes, returns uniform floats in [0, 1)
+static f32x4 NextRandom(u32x4 state[4]);
+
+static void LoadRandom(
+	const array<u32, 16>& src,
+	u32x4 outState[4]);
+static void StoreRandom(
+	const u32x4 state[4],
+	array<u32, 16>& dst);
+
+static u64 SplitMix64(u64& state);
+
+static u8 ToUnorm8(f32 value);
+
+namespace GameTest::Graphics
+{
+	ParticleEmitter::ParticleEmitter(
+		const ParticleEmitterSettings& newSettings,
+		u64 seed)
+	{
+		u32 chunkCount = max(1u, (newSettings.maxParticles + PARTICLE_CHUNK_SIZE - 1) / PARTICLE_CHUNK_SIZE);
+		capacity = chunkCount * PARTICLE_CHUNK_SIZE;
+
+		settings = newSettings;
+		settings.maxParticles = capacity;
+
+		chunkCounts.assign(chunkCount, 0);
+		chunkOffsets.assign(chunkCount, 0);
+
+		for (vector<f32>* pool : {
+			&posX, &posY, &posZ,
+			&velX, &velY, &velZ,
+			&life, &invLifetime,
+			&colorR, &colorG, &colorB, &colorA,
+			&size })
+		{
+			pool->assign(capacity, 0.0f);
+		}
+
+		for (u32& word : rngState) word = scast<u32>(SplitMix64(seed) >> 32);
+
+		//an all zero lane would only ever return zero
+		for (u32 lane = 0; lane < 4; ++lane)
+		{
+			if ((rngState[lane] | rngState[4 + lane] | rngState[8 + lane] | rngState[12 + lane]) == 0)
+			{
+				rngState[lane] = 1;
+			}
+		}
+	}
+
+	void ParticleEmitter::SetSettings(const ParticleEmitterSettings& newSettings)
+	{
+		settings = newSettings;
+		settings.maxParticles = capacity;
+	}
+	const ParticleEmitterSettings& ParticleEmitter::GetSettings() const { return settings; }
+
+	void ParticleEmitter::SetPosition(const vec3& newPos) { settings.position = newPos; }
+
+	void ParticleEmitter::Burst(u32 count)
+	{
+		pendingBurst = scast<u32>(min(scast<u64>(pendingBurst) + count, scast<u64>(capacity)));
+	}
+
+	void ParticleEmitter::Update(
+		f32 deltaTime,
+		ThreadPool* workers)
+	{
+		deltaTime = max(deltaTime, 0.0f);
+
+		u32 chunkCount = scast<u32>(chunkCounts.size());
+
+		//
+		// SIMULATE AND COMPACT
+		//
+
+		if (aliveCount > 0)
+		{
+			auto RunChunk = [this, deltaTime](size_t chunk)
+				{
+					SimulateChunk(scast<u32>(chunk), deltaTime);
+				};
+
+			//chunks never share particles, so workers write without locks
+			if (workers
+				&& chunkCount > 1)
+			{
+				workers->ParallelFor(chunkCount, RunChunk);
+			}
+			else
+			{
+				for (u32 c = 0; c < chunkCount; ++c) RunChunk(c);
+			}
+		}
+
+		//
+		// SPAWN
+		//
+
+		//a long frame can't ask for more than the whole pool
+		f32 toSpawn = min(
+			settings.spawnRate * deltaTime + spawnRemainder,
+			scast<f32>(capacity));
+		toSpawn = max(toSpawn, 0.0f);
+
+		u32 spawnCount = scast<u32>(toSpawn);
+		spawnRemainder = toSpawn - scast<f32>(spawnCount);
+
+		u64 remaining = scast<u64>(spawnCount) + pendingBurst;
+		pendingBurst = 0;
+
+		for (u32 c = 0;
+			c < chunkCount
+			&& remaining > 0;
+			++c)
+		{
+			u32 count = min(PARTICLE_CHUNK_SIZE - chunkCounts[c], scast<u32>(min(remaining, scast<u64>(PARTICLE_CHUNK_SIZE))));
+			if (count == 0) continue;
+
+			SpawnRange(c * PARTICLE_CHUNK_SIZE + chunkCounts[c], count);
+
+			chunkCounts[c] += count;
+			remaining -= count;
+		}
+
+		droppedCount += remaining;
+
+		aliveCount = 0;
+		for (u32 c = 0; c < chunkCount; ++c)
+		{
+			chunkOffsets[c] = aliveCount;
+			aliveCount += chunkCounts[c];
+		}
+	}
+
+	void ParticleEmitter::WriteInstances(
+		ParticleInstance* out,
+		ThreadPool* workers) const
+	{
+		if (!out
+			|| aliveCount == 0)
+		{
+			return;
+		}
+
+		u32 chunkCount = scast<u32>(chunkCounts.size());
+
+		auto WriteChunk = [this, out](size_t chunk)
+			{
+				u32 count = chunkCounts[chunk];
+				size_t base = chunk * PARTICLE_CHUNK_SIZE;
+
+				ParticleInstance* dst = out + chunkOffsets[chunk];
+
+				for (u32 i = 0; i < count; ++i)
+				{
+					size_t p = base + i;
+
+					dst[i].position[0] = posX[p];
+					dst[i].position[1] = posY[p];
+					dst[i].position[2] = posZ[p];
+					dst[i].size = size[p];
+
+					dst[i].color[0] = ToUnorm8(colorR[p]);
+					dst[i].color[1] = ToUnorm8(colorG[p]);
+					dst[i].color[2] = ToUnorm8(colorB[p]);
+					dst[i].color[3] = ToUnorm8(colorA[p]);
+				}
+			};
+
+		if (workers
+			&& chunkCount > 1)
+		{
+			workers->ParallelFor(chunkCount, WriteChunk);
+		}
+		else
+		{
+			for (u32 c = 0; c < chunkCount; ++c) WriteChunk(c);
+		}
+	}
+
+	void ParticleEmitter::Clear()
+	{
+		fill(chunkCounts.begin(), chunkCounts.end(), 0);
+		fill(chunkOffsets.begin(), chunkOffsets.end(), 0);
+
+		aliveCount = 0;
+		pendingBurst = 0;
+		spawnRemainder = 0.0f;
+	}
+
+	u32 ParticleEmitter::GetAliveCount() const { return aliveCount; }
+	u32 ParticleEmitter::GetCapacity() const { return capacity; }
+	u64 ParticleEmitter::GetDroppedCount() const { return droppedCount; }
+
+	void ParticleEmitter::SimulateChunk(
+		u32 chunk,
+		f32 deltaTime)
+	{
+		u32 count = chunkCounts[chunk];
+		if (count == 0) return;
+
+		size_t base = scast<size_t>(chunk) * PARTICLE_CHUNK_SIZE;
+
+		f32* px = &posX[base];
+		f32* py = &posY[base];
+		f32* pz = &posZ[base];
+		f32* vx = &velX[base];
+		f32* vy = &velY[base];
+		f32* vz = &velZ[base];
+		f32* lf = &life[base];
+		f32* il = &invLifetime[base];
+		f32* cr = &colorR[base];
+		f32* cg = &colorG[base];
+		f32* cb = &colorB[base];
+		f32* ca = &colorA[base];
+		f32* sz = &size[base];
+
+		const f32x4 dt = Set1(deltaTime);
+		const f32x4 zero = Set1(0.0f);
+		const f32x4 one = Set1(1.0f);
+
+		const f32x4 gravityX = Set1(settings.gravity.x * deltaTime);
+		const f32x4 gravityY = Set1(settings.gravity.y * deltaTime);
+		const f32x4 gravityZ = Set1(settings.gravity.z * deltaTime);
+		const f32x4 damping = Set1(max(1.0f - settings.drag * deltaTime, 0.0f));
+
+		const vec4& c0 = settings.startColor;
+		const vec4& c1 = settings.endColor;
+		const f32x4 startR = Set1(c0.x);
+		const f32x4 startG = Set1(c0.y);
+		const f32x4 startB = Set1(c0.z);
+		const f32x4 startA = Set1(c0.w);
+		const f32x4 deltaR = Set1(c1.x - c0.x);
+		const f32x4 deltaG = Set1(c1.y - c0.y);
+		const f32x4 deltaB = Set1(c1.z - c0.z);
+		const f32x4 deltaA = Set1(c1.w - c0.w);
+		const f32x4 startSize = Set1(settings.startSize);
+		const f32x4 deltaSize = Set1(settings.endSize - settings.startSize);
+
+		//index of every alive particle in order, the cursor only moves past alive ones,
+		//so the list is built without a branch per particle
+		u32 alive[PARTICLE_CHUNK_SIZE];
+		u32 aliveInChunk{};
+
+		//the last group may run past count, those lanes hold stale particles and stay inside the chunk
+		for (u32 i = 0; i < count; i += 4)
+		{
+			f32x4 newVX = Mul(Add(Load(vx + i), gravityX), damping);
+			f32x4 newVY = Mul(Add(Load(vy + i), gravityY), damping);
+			f32x4 newVZ = Mul(Add(Load(vz + i), gravityZ), damping);
+
+			Store(vx + i, newVX);
+			Store(vy + i, newVY);
+			Store(vz + i, newVZ);
+
+			Store(px + i, Add(Load(px + i), Mul(newVX, dt)));
+			Store(py + i, Add(Load(py + i), Mul(newVY, dt)));
+			Store(pz + i, Add(Load(pz + i), Mul(newVZ, dt)));
+
+			f32x4 newLife = Sub(Load(lf + i), dt);
+			Store(lf + i, newLife);
+
+			//0 at spawn, 1 at death
+			f32x4 t = Min(Max(Sub(one, Mul(newLife, Load(il + i))), zero), one);
+
+			Store(cr + i, Add(startR, Mul(deltaR, t)));
+			Store(cg + i, Add(startG, Mul(deltaG, t)));
+			Store(cb + i, Add(startB, Mul(deltaB, t)));
+			Store(ca + i, Add(startA, Mul(deltaA, t)));
+			Store(sz + i, Add(startSize, Mul(deltaSize, t)));
+
+			u32 laneMask = (1u << min(count - i, 4u)) - 1u;
+			u32 aliveMask = ~NonPositiveMask(newLife) & laneMask;
+
+			for (u32 lane = 0; lane < 4; ++lane)
+			{
+				alive[aliveInChunk] = i + lane;
+				aliveInChunk += (aliveMask >> lane) & 1u;
+			}
+		}
+
+		if (aliveInChunk == count) return;
+
+		//particles before the first dead one stay where they are,
+		//bounded since the entry past the last alive one can also match when only the tail died
+		u32 first{};
+		while (first < aliveInChunk
+			&& alive[first] == first)
+		{
+			++first;
+		}
+
+		//alive[k] is never below k, so every read happens before that slot is overwritten
+		for (f32* pool : { px, py, pz, vx, vy, vz, lf, il, cr, cg, cb, ca, sz })
+		{
+			for (u32 k = first; k < aliveInChunk; ++k) pool[k] = pool[alive[k]];
+		}
+
+		chunkCounts[chunk] = aliveInChunk;
+	}
+
+	void ParticleEmitter::SpawnRange(
+		u32 first,
+		u32 count)
+	{
+		u32x4 rng[4]{};
+		LoadRandom(rngState, rng);
+
+		const vec3& pos = settings.position;
+		const vec3& extents = settings.spawnExtents;
+		const vec3& vMin = settings.velocityMin;
+		const vec3& vMax = settings.velocityMax;
+
+		const f32x4 posBaseX = Set1(pos.x - extents.x);
+		const f32x4 posBaseY = Set1(pos.y - extents.y);
+		const f32x4 posBaseZ = Set1(pos.z - extents.z);
+		const f32x4 posRangeX = Set1(extents.x * 2.0f);
+		const f32x4 posRangeY = Set1(extents.y * 2.0f);
+		const f32x4 posRangeZ = Set1(extents.z * 2.0f);
+
+		const f32x4 velBaseX = Set1(vMin.x);
+		const f32x4 velBaseY = Set1(vMin.y);
+		const f32x4 velBaseZ = Set1(vMin.z);
+		const f32x4 velRangeX = Set1(vMax.x - vMin.x);
+		const f32x4 velRangeY = Set1(vMax.y - vMin.y);
+		const f32x4 velRangeZ = Set1(vMax.z - vMin.z);
+
+		//particles always live for at least a millisecond so one over life stays finite
+		f32 lifeMin = max(settings.lifeMin, 0.001f);
+		const f32x4 lifeBase = Set1(lifeMin);
+		const f32x4 lifeRange = Set1(max(settings.lifeMax - lifeMin, 0.0f));
+		const f32x4 one = Set1(1.0f);
+
+		const vec4& color = settings.startColor;
+		const f32x4 startR = Set1(color.x);
+		const f32x4 startG = Set1(color.y);
+		const f32x4 startB = Set1(color.z);
+		const f32x4 startA = Set1(color.w);
+		const f32x4 startSize = Set1(settings.startSize);
+
+		for (u32 i = 0; i < count; i += 4)
+		{
+			u32 lanes = min(count - i, 4u);
+			u32 p = first + i;
+
+			StoreLanes(&posX[p], Add(posBaseX, Mul(NextRandom(rng), posRangeX)), lanes);
+			StoreLanes(&posY[p], Add(posBaseY, Mul(NextRandom(rng), posRangeY)), lanes);
+			StoreLanes(&posZ[p], Add(posBaseZ, Mul(NextRandom(rng), posRangeZ)), lanes);
+
+			StoreLanes(&velX[p], Add(velBaseX, Mul(NextRandom(rng), velRangeX)), lanes);
+			StoreLanes(&velY[p], Add(velBaseY, Mul(NextRandom(rng), velRangeY)), lanes);
+			StoreLanes(&velZ[p], Add(velBaseZ, Mul(NextRandom(rng), velRangeZ)), lanes);
+
+			f32x4 newLife = Add(lifeBase, Mul(NextRandom(rng), lifeRange));
+			StoreLanes(&life[p], newLife, lanes);
+			StoreLanes(&invLifetime[p], Div(one, newLife), lanes);
+
+			StoreLanes(&colorR[p], startR, lanes);
+			StoreLanes(&colorG[p], startG, lanes);
+			StoreLanes(&colorB[p], startB, lanes);
+			StoreLanes(&colorA[p], startA, lanes);
+			StoreLanes(&size[p], startSize, lanes);
+		}
+
+		StoreRandom(rng, rngState);
+	}
+}
+
+#ifdef PARTICLE_SSE2
+
+f32x4 Set1(f32 value) { return _mm_set1_ps(value); }
+f32x4 Load(const f32* src) { return _mm_loadu_ps(src); }
+void Store(
+	f32* dst,
+	f32x4 value)
+{
+	_mm_storeu_ps(dst, value);
+}
+
+void StoreLanes(
+	f32* dst,
+	f32x4 value,
+	u32 laneCount)
+{
+	if (laneCount == 4)
+	{
+		_mm_storeu_ps(dst, value);
+		return;
+	}
+
+	alignas(16) f32 lanes[4];
+	_mm_store_ps(lanes, value);
+	for (u32 i = 0; i < laneCount; ++i) dst[i] = lanes[i];
+}
+
+f32x4 Add(f32x4 a, f32x4 b) { return _mm_add_ps(a, b); }
+f32x4 Sub(f32x4 a, f32x4 b) { return _mm_sub_ps(a, b); }
+f32x4 Mul(f32x4 a, f32x4 b) { return _mm_mul_ps(a, b); }
+f32x4 Div(f32x4 a, f32x4 b) { return _mm_div_ps(a, b); }
+f32x4 Min(f32x4 a, f32x4 b) { return _mm_min_ps(a, b); }
+f32x4 Max(f32x4 a, f32x4 b) { return _mm_max_ps(a, b); }
+
+u32 NonPositiveMask(f32x4 value)
+{
+	return scast<u32>(_mm_movemask_ps(_mm_cmple_ps(value, _mm_setzero_ps())));
+}
+
+f32x4 NextRandom(u32x4 state[4])
+{
+	u32x4 result = _mm_add_epi32(state[0], state[3]);
+	u32x4 t = _mm_slli_epi32(state[1], 9);
+
+	state[2] = _mm_xor_si128(state[2], state[0]);
+	state[3] = _mm_xor_si128(state[3], state[1]);
+	state[1] = _mm_xor_si128(state[1], state[2]);
+	state[0] = _mm_xor_si128(state[0], state[3]);
+	state[2] = _mm_xor_si128(state[2], t);
+	state[3] = _mm_or_si128(
+		_mm_slli_epi32(state[3], 11),
+		_mm_srli_epi32(state[3], 21));
+
+	//the top 24 bits convert to float exactly
+	return _mm_mul_ps(
+		_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)),
+		_mm_set1_ps(1.0f / 16777216.0f));
+}
+
+void LoadRandom(
+	const array<u32, 16>& src,
+	u32x4 outState[4])
+{
+	for (u32 w = 0; w < 4; ++w)
+	{
+		outState[w] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[w * 4]));
+	}
+}
+void StoreRandom(
+	const u32x4 state[4],
+	array<u32, 16>& dst)
+{
+	for (u32 w = 0; w < 4; ++w)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[w * 4]), state[w]);
+	}
+}
+
+#else
+
+f32x4 Set1(f32 value) { return { { value, value, value, value } }; }
+f32x4 Load(const f32* src) { return { { src[0], src[1], src[2], src[3] } }; }
+void Store(
+	f32* dst,
+	f32x4 value)
+{
+	for (u32 i = 0; i < 4; ++i) dst[i] = value.v[i];
+}
+
+void StoreLanes(
+	f32* dst,
+	f32x4 value,
+	u32 laneCount)
+{
+	for (u32 i = 0; i < laneCount; ++i) dst[i] = value.v[i];
+}
+
+f32x4 Add(f32x4 a, f32x4 b) { for (u32 i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+f32x4 Sub(f32x4 a, f32x4 b) { for (u32 i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+f32x4 Mul(f32x4 a, f32x4 b) { for (u32 i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+f32x4 Div(f32x4 a, f32x4 b) { for (u32 i = 0; i < 4; ++i) a.v[i] /= b.v[i]; return a; }
+f32x4 Min(f32x4 a, f32x4 b) { for (u32 i = 0; i < 4; ++i) a.v[i] = min(a.v[i], b.v[i]); return a; }
+f32x4 Max(f32x4 a, f32x4 b) { for (u32 i = 0; i < 4; ++i) a.v[i] = max(a.v[i], b.v[i]); return a; }
+
+u32 NonPositiveMask(f32x4 value)
+{
+	u32 mask{};
+	for (u32 i = 0; i < 4; ++i) mask |= scast<u32>(value.v[i] <= 0.0f) << i;
+	return mask;
+}
+
+f32x4 NextRandom(u32x4 state[4])
+{
+	f32x4 out{};
+
+	for (u32 i = 0; i < 4; ++i)
+	{
+		u32 result = state[0].v[i] + state[3].v[i];
+		u32 t = state[1].v[i] << 9;
+
+		state[2].v[i] ^= state[0].v[i];
+		state[3].v[i] ^= state[1].v[i];
+		state[1].v[i] ^= state[2].v[i];
+		state[0].v[i] ^= state[3].v[i];
+		state[2].v[i] ^= t;
+		state[3].v[i] = (state[3].v[i] << 11) | (state[3].v[i] >> 21);
+
+		out.v[i] = scast<f32>(result >> 8) * (1.0f / 16777216.0f);
+	}
+
+	return out;
+}
+
+void LoadRandom(
+	const array<u32, 16>& src,
+	u32x4 outState[4])
+{
+	for (u32 w = 0; w < 4; ++w)
+	{
+		for (u32 i = 0; i < 4; ++i) outState[w].v[i] = src[w * 4 + i];
+	}
+}
+void StoreRandom(
+	const u32x4 state[4],
+	array<u32, 16>& dst)
+{
+	for (u32 w = 0; w < 4; ++w)
+	{
+		for (u32 i = 0; i < 4; ++i) dst[w * 4 + i] = state[w].v[i];
+	}
+}
+
+#endif
+
+u64 SplitMix64(u64& state)
+{
+	u64 z = (state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+u8 ToUnorm8(f32 value)
+{
+	return scast<u8>(clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
@@ -0,0 +1,224 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/log_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_functions_core.hpp"
+
+#include "graphics/particle_renderer.hpp"
+#include "graphics/stream_ring.hpp"
+#include "graphics/gl_extra_functions.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::mat4;
+
+using KalaWindow::OpenGL::OpenGL_Shader;
+using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
+using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
+
+using GameTest::Graphics::ParticleRenderer;
+using GameTest::Graphics::ParticleEmitter;
+using GameTest::Graphics::ParticleInstance;
+using GameTest::Graphics::StreamRing;
+using GameTest::Graphics::StreamAllocation;
+using GameTest::Graphics::GL_Extra;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+using GameTest::Core::ThreadPool;
+
+using std::string;
+using std::to_string;
+using std::vector;
+
+static bool isInitialized{};
+
+static OpenGL_Shader* shader{};
+
+static StreamRing instanceRing{};
+static u32 VAO{};
+
+static u32 lastParticleCount{};
+static bool hasWarnedOverflow{};
+
+static void SetInstanceAttributes(
+	u32 buffer,
+	size_t offset);
+
+namespace GameTest::Graphics
+{
+	string ParticleRenderer::Initialize(
+		OpenGL_Shader* newShader,
+		u32 maxParticles)
+	{
+		if (isInitialized) return {};
+
+		if (!newShader
+			|| !newShader->IsInitialized())
+		{
+			return "Failed to initialize particle renderer because its shader is invalid!";
+		}
+
+		if (maxParticles == 0)
+		{
+			return "Failed to initialize particle renderer because it was given no room for particles!";
+		}
+
+		string result = instanceRing.Initialize(scast<size_t>(maxParticles) * sizeof(ParticleInstance));
+		if (!result.empty()) return result;
+
+		OpenGL_Functions_Core::GetGLCore()->glGenVertexArrays(1, &VAO);
+
+		shader = newShader;
+		isInitialized = true;
+
+		Log::Print(
+			"Initialized particle renderer for " + to_string(maxParticles) + " particles per frame.",
+			"PARTICLES",
+			LogType::LOG_SUCCESS);
+
+		return {};
+	}
+	bool ParticleRenderer::IsInitialized() { return isInitialized; }
+
+	void ParticleRenderer::Render(
+		const vector<ParticleEmitter*>& emitters,
+		const mat4& view,
+		const mat4& projection,
+		ThreadPool* workers)
+	{
+		lastParticleCount = 0;
+
+		if (!isInitialized) return;
+
+		if (!shader->Bind())
+		{
+			Log::Print(
+				"Failed to render particles because shader '" + shader->GetName() + "' failed to bind!",
+				"PARTICLES",
+				LogType::LOG_ERROR,
+				2);
+
+			return;
+		}
+
+		shader->SetMat4("uView", view);
+		shader->SetMat4("uProjection", projection);
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+		const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+		//additive blending doesn't depend on draw order, so particles are never sorted
+		coreFunc->glEnable(GL_BLEND);
+		coreFunc->glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+		coreFunc->glDepthMask(GL_FALSE);
+		coreFunc->glDisable(GL_CULL_FACE);
+
+		coreFunc->glBindVertexArray(VAO);
+
+		instanceRing.BeginFrame();
+
+		for (ParticleEmitter* emitter : emitters)
+		{
+			u32 count = emitter ? emitter->GetAliveCount() : 0;
+			if (count == 0) continue;
+
+			StreamAllocation allocation = instanceRing.Allocate(scast<size_t>(count) * sizeof(ParticleInstance));
+			if (!allocation.IsValid())
+			{
+				if (!hasWarnedOverflow)
+				{
+					hasWarnedOverflow = true;
+
+					Log::Print(
+						"Particle frame limit reached, extra emitters are skipped!",
+						"PARTICLES",
+						LogType::LOG_WARNING);
+				}
+
+				continue;
+			}
+
+			emitter->WriteInstances(
+				reinterpret_cast<ParticleInstance*>(allocation.data),
+				workers);
+			instanceRing.Flush();
+
+			SetInstanceAttributes(allocation.buffer, allocation.offset);
+			extraFunc->glDrawArraysInstanced(
+				GL_TRIANGLE_STRIP,
+				0,
+				4,
+				scast<GLsizei>(count));
+
+			lastParticleCount += count;
+		}
+
+		instanceRing.EndFrame();
+
+		coreFunc->glBindVertexArray(0);
+		coreFunc->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		coreFunc->glEnable(GL_CULL_FACE);
+		coreFunc->glDepthMask(GL_TRUE);
+		coreFunc->glDisable(GL_BLEND);
+	}
+
+	u32 ParticleRenderer::GetLastParticleCount() { return lastParticleCount; }
+
+	void ParticleRenderer::Shutdown()
+	{
+		if (!isInitialized) return;
+
+		if (VAO != 0)
+		{
+			OpenGL_Functions_Core::GetGLCore()->glDeleteVertexArrays(1, &VAO);
+			VAO = 0;
+		}
+
+		instanceRing.Shutdown();
+
+		shader = nullptr;
+		lastParticleCount = 0;
+		hasWarnedOverflow = false;
+		isInitialized = false;
+	}
+}
+
+void SetInstanceAttributes(
+	u32 buffer,
+	size_t offset)
+{
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+	const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+	coreFunc->glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+	//center in xyz and size in w
+	coreFunc->glEnableVertexAttribArray(0);
+	coreFunc->glVertexAttribPointer(
+		0,
+		4,
+		GL_FLOAT,
+		GL_FALSE,
+		sizeof(ParticleInstance),
+		(void*)(offset + offsetof(ParticleInstance, position)));
+	extraFunc->glVertexAttribDivisor(0, 1);
+
+	coreFunc->glEnableVertexAttribArray(1);
+	coreFunc->glVertexAttribPointer(
+		1,
+		4,
+		GL_UNSIGNED_BYTE,
+		GL_TRUE,
+		sizeof(ParticleInstance),
+		(void*)(offset + offsetof(ParticleInstance, color)));
+	extraFunc->glVertexAttribDivisor(1, 1);
+}
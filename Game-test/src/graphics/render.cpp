@@ -5,12 +5,15 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <filesystem>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
 
 #include "KalaHeaders/core_utils.hpp"
 #include "KalaHeaders/log_utils.hpp"
 #include "KalaHeaders/math_utils.hpp"
-#include "KalaHeaders/file_utils.hpp"
 #include "KalaHeaders/import_kmd.hpp"
 
 #include "core/kw_core.hpp"
@@ -28,6 +31,24 @@
 #include "graphics/render.hpp"
 #include "core/core.hpp"
 #include "core/input.hpp"
+#include "core/input_queue.hpp"
+#include "core/asset_pack.hpp"
+#include "core/resource_manager.hpp"
+#include "core/thread_pool.hpp"
+#include "graphics/resource_loaders.hpp"
+#include "graphics/occlusion_culler.hpp"
+#include "graphics/gl_extra_functions.hpp"
+#include "graphics/debug_draw.hpp"
+#include "graphics/stream_ring.hpp"
+#include "graphics/texture_uploader.hpp"
+#include "graphics/frame_sync.hpp"
+#include "graphics/static_batcher.hpp"
+#include "graphics/weighted_oit.hpp"
+#include "graphics/deferred_renderer.hpp"
+#include "graphics/particle_emitter.hpp"
+#include "graphics/particle_renderer.hpp"
+#include "graphics/world_partition.hpp"
+#include "gameobject/scene_systems.hpp"
 #include "gameobject/camera.hpp"
 
 using KalaHeaders::KalaCore::FromVar;
@@ -37,12 +58,12 @@ using KalaHeaders::KalaMath::wrap;
 using KalaHeaders::KalaMath::radians;
 using KalaHeaders::KalaMath::vec2;
 using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::vec4;
 using KalaHeaders::KalaMath::mat4;
 using KalaHeaders::KalaMath::PosTarget;
 using KalaHeaders::KalaMath::RotTarget;
 using KalaHeaders::KalaMath::SizeTarget;
 using KalaHeaders::KalaModelData::Vertex;
-using KalaHeaders::KalaFile::ReadTextFromFile;
 
 using KalaWindow::Core::KalaWindowCore;
 using KalaWindow::Core::Input;
@@ -66,19 +87,110 @@ using KalaUI::OpenGL::OpenGLFunctions::OpenGL_Functions_UI;
 
 using GameTest::Core::GameTestCore;
 using GameTest::Core::GameTestInput;
+using GameTest::Core::InputQueue;
+using GameTest::Core::AssetPack;
+using GameTest::Core::ResourceManager;
+using GameTest::Core::ResourceRef;
+using GameTest::Core::ResourceHandle;
+using GameTest::Graphics::ResourceLoaders;
+using GameTest::Graphics::ModelSet;
+using GameTest::Graphics::OcclusionCuller;
+using GameTest::Graphics::OccluderMesh;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+using GameTest::Graphics::DebugDraw;
+using GameTest::Graphics::StreamRing;
+using GameTest::Graphics::TextureUploader;
+using GameTest::Graphics::FrameSync;
+using GameTest::Graphics::StaticBatcher;
+using GameTest::Graphics::StaticBatch;
+using GameTest::Graphics::WeightedOIT;
+using GameTest::Graphics::DeferredRenderer;
+using GameTest::Graphics::DeferredShaders;
+using GameTest::Graphics::ParticleEmitter;
+using GameTest::Graphics::ParticleEmitterSettings;
+using GameTest::Graphics::ParticleRenderer;
+using GameTest::Graphics::WorldPartition;
+using GameTest::Core::ThreadPool;
 using GameTest::Graphics::MainWindow;
 using GameTest::Graphics::Render;
 using GameTest::GameObject::Camera;
+using GameTest::GameObject::OpenGL_Model;
+using GameTest::GameObject::OpenGL_Mesh;
+using GameTest::GameObject::SceneSystems;
+using GameTest::GameObject::RenderItem;
 
 using std::string;
 using std::vector;
+using std::array;
+using std::unique_ptr;
+using std::make_unique;
+using std::shared_ptr;
+using std::weak_ptr;
+using std::unordered_map;
+using std::remove;
+using std::move;
+using std::to_string;
 using std::filesystem::path;
 using std::filesystem::current_path;
-using std::filesystem::exists;
 
 //light blue background color
 constexpr vec3 NORMALIZED_BACKGROUND_COLOR = vec3(0.29f, 0.36f, 0.85f);
 
+//most triangles kept per model when it is rasterized as an occluder
+constexpr u32 OCCLUDER_TRIANGLE_BUDGET = 512u;
+
+//bytes of dynamic gpu data each frame can stream through the upload ring
+constexpr size_t UPLOAD_RING_REGION_SIZE = 1u << 20;
+
+//most particles all emitters can draw in one frame
+constexpr u32 PARTICLE_FRAME_LIMIT = 1u << 20;
+
+//per mesh data for occlusion culling, built the first time a model of the mesh is drawn
+//and shared by every model drawing it
+struct CullData
+{
+	//a mesh freed by a direct registry removal expires here, so a new mesh at its address is rebuilt
+	weak_ptr<OpenGL_Mesh> mesh{};
+
+	OccluderMesh occluder{};
+	vec3 boundsMin{};
+	vec3 boundsMax{};
+};
+
+//shared by per-frame cpu work such as occlusion culling
+static unique_ptr<ThreadPool> jobWorkers{};
+
+//per-frame dynamic gpu data such as point lights and debug geometry
+static StreamRing uploadRing{};
+
+//merged static geometry, owned by the model registry
+static vector<StaticBatch> staticBatches{};
+//set when static models may have moved, the batches are rebuilt after the next command playback
+static bool isStaticRebuildPending{};
+
+//first model of the test model set, kept directly since batching can replace it in the render list,
+//null if the set has no models
+static OpenGL_Model* testModelRoot{};
+
+//visible transparent models of this frame, drawn after every opaque one
+static vector<OpenGL_Model*> transparentModels{};
+
+//cpu simulated effects, drawn after every model
+static vector<unique_ptr<ParticleEmitter>> particleEmitters{};
+static vector<ParticleEmitter*> activeEmitters{};
+
+static OcclusionCuller occlusionCuller{};
+static unordered_map<const OpenGL_Mesh*, CullData> cullData{};
+
+static const CullData& GetCullData(OpenGL_Model* model);
+
+//applies model creates and destroys recorded by systems since the last frame
+//and publishes the model list for worker threads
+static void ApplyModelCommands();
+
+//Puts the sources of the current batches back in the render list and batches every static model again
+static void RebuildStaticBatches();
+
 static void CreateNewWindow(const string& windowName);
 
 static void Redraw();
@@ -94,6 +206,16 @@ namespace GameTest::Graphics
 	static vector<OpenGL_Model*> models{};
 	static vector<OpenGL_PointLight*> pointLights{};
 
+	static ResourceHandle<OpenGL_Shader> modelShader{};
+	static ResourceHandle<OpenGL_Shader> debugShapeShader{};
+	static ResourceHandle<OpenGL_Shader> debugLineShader{};
+	static ResourceHandle<OpenGL_Shader> oitCompositeShader{};
+	static ResourceHandle<OpenGL_Shader> gbufferShader{};
+	static ResourceHandle<OpenGL_Shader> deferredAmbientShader{};
+	static ResourceHandle<OpenGL_Shader> deferredLightShader{};
+	static ResourceHandle<OpenGL_Shader> particleShader{};
+	static ResourceHandle<ModelSet> testModel{};
+
 	void Render::Initialize()
 	{
 		Log::Print(
@@ -108,6 +230,35 @@ namespace GameTest::Graphics
 		
 		CreateNewWindow("game test");
 
+		OpenGL_Functions_Extra::LoadAllExtraFunctions();
+
+		//two frames keep the gpu busy without letting input latency grow a whole extra frame
+		FrameSync::Initialize(2);
+
+		string ringResult = uploadRing.Initialize(UPLOAD_RING_REGION_SIZE);
+		if (!ringResult.empty())
+		{
+			//everything that streams through the ring has its own fallback buffer
+			Log::Print(
+				ringResult,
+				"RENDER",
+				LogType::LOG_ERROR,
+				2);
+		}
+
+		//textures are uploaded synchronously if the uploader fails to start
+		string uploaderResult = TextureUploader::Initialize();
+		if (!uploaderResult.empty())
+		{
+			Log::Print(
+				uploaderResult,
+				"RENDER",
+				LogType::LOG_ERROR,
+				2);
+		}
+
+		jobWorkers = make_unique<ThreadPool>();
+
 		GameTestCore::SyncID();
 
 		Camera* camera = Camera::Initialize(
@@ -135,145 +286,208 @@ namespace GameTest::Graphics
 		OpenGL_Context* context = mainWindow.context;
 
 		//
-		// LOAD MODEL SHADER
+		// LOAD SHADERS AND TEST MODEL
 		//
 
-		path vModel = current_path() / "files" / "shaders" / "model.vert";
-		if (!exists(vModel))
-		{
-			KalaWindowCore::ForceClose(
-				"Shader load error",
-				"Failed to initialize model shader because the model.vert shader file was not found!");
+		path shaderDir = current_path() / "files" / "shaders";
 
-			return;
-		}
+		modelShader = ResourceLoaders::LoadShader(
+			context,
+			"shader_model",
+			shaderDir / "model.vert",
+			shaderDir / "model.frag");
 
-		string vModelText{};
-		string vModelResult = ReadTextFromFile(vModel, vModelText);
+		debugShapeShader = ResourceLoaders::LoadShader(
+			context,
+			"shader_debug_shape",
+			shaderDir / "debug_shape.vert",
+			shaderDir / "debug_shape.frag");
 
-		if (!vModelResult.empty())
-		{
-			KalaWindowCore::ForceClose(
-				"Shader load error",
-				vModelResult);
+		debugLineShader = ResourceLoaders::LoadShader(
+			context,
+			"shader_debug_line",
+			shaderDir / "debug_line.vert",
+			shaderDir / "debug_line.frag");
 
-			return;
-		}
+		oitCompositeShader = ResourceLoaders::LoadShader(
+			context,
+			"shader_oit_composite",
+			shaderDir / "fullscreen.vert",
+			shaderDir / "oit_composite.frag");
 
-		path fModel = current_path() / "files" / "shaders" / "model.frag";
-		if (!exists(fModel))
-		{
-			KalaWindowCore::ForceClose(
-				"Shader load error",
-				"Failed to initialize model shader because the model.frag shader file was not found!");
+		gbufferShader = ResourceLoaders::LoadShader(
+			context,
+			"shader_model_gbuffer",
+			shaderDir / "model.vert",
+			shaderDir / "model_gbuffer.frag");
 
-			return;
-		}
+		deferredAmbientShader = ResourceLoaders::LoadShader(
+			context,
+			"shader_deferred_ambient",
+			shaderDir / "fullscreen.vert",
+			shaderDir / "deferred_ambient.frag");
 
-		string fModelText{};
-		string fModelResult = ReadTextFromFile(fModel, fModelText);
+		deferredLightShader = ResourceLoaders::LoadShader(
+			context,
+			"shader_deferred_light",
+			shaderDir / "deferred_light.vert",
+			shaderDir / "deferred_light.frag");
 
-		if (!fModelResult.empty())
-		{
-			KalaWindowCore::ForceClose(
-				"Shader load error",
-				fModelResult);
+		particleShader = ResourceLoaders::LoadShader(
+			context,
+			"shader_particle",
+			shaderDir / "particle.vert",
+			shaderDir / "particle.frag");
 
-			return;
-		}
-		
-		OpenGL_Shader* shader_model = OpenGL_Shader::Initialize(
+		//file reads and parsing run on the loader threads while the shaders compile here,
+		//the test level never moves so it is loaded as static geometry for batching
+		testModel = ResourceLoaders::LoadModel(
 			context,
-			"shader_model",
-			{ {
-				{.shaderData = vModelText, .type = OpenGL_ShaderType::SHADER_VERTEX },
-				{.shaderData = fModelText, .type = OpenGL_ShaderType::SHADER_FRAGMENT }
-			} });
+			current_path() / "files" / "models" / "crusher.kmd",
+			modelShader,
+			{},
+			true);
 
-		//
-		// LOAD DEBUG SHAPE SHADER
-		//
+		ResourceManager::WaitAll();
 
-		path vShape = current_path() / "files" / "shaders" / "debug_shape.vert";
-		if (!exists(vShape))
+		const array<ResourceRef, 9> startupResources
 		{
-			KalaWindowCore::ForceClose(
-				"Shader load error",
-				"Failed to initialize debug shape shader because debug_shape.vert was not found!");
-
-			return;
+			ResourceRef(modelShader),
+			ResourceRef(debugShapeShader),
+			ResourceRef(debugLineShader),
+			ResourceRef(oitCompositeShader),
+			ResourceRef(gbufferShader),
+			ResourceRef(deferredAmbientShader),
+			ResourceRef(deferredLightShader),
+			ResourceRef(particleShader),
+			ResourceRef(testModel)
+		};
+
+		for (const ResourceRef& resource : startupResources)
+		{
+			if (!resource.IsReady())
+			{
+				KalaWindowCore::ForceClose(
+					"Resource load error",
+					"Failed to load '" + resource.GetKey() + "'! Reason: " + resource.GetError());
+
+				return;
+			}
 		}
 
-		string vShapeText{};
-		string vShapeResult = ReadTextFromFile(vShape, vShapeText);
+		DebugDraw::Initialize(
+			debugLineShader.Get(),
+			&uploadRing);
 
-		if (!vShapeResult.empty())
+		//transparent models blend in draw order if the targets can't be created
+		string oitResult = WeightedOIT::Initialize(
+			oitCompositeShader.Get(),
+			mainWindow.window->GetClientRectSize());
+		if (!oitResult.empty())
 		{
-			KalaWindowCore::ForceClose(
-				"Shader load error",
-				vShapeResult);
-
-			return;
+			Log::Print(
+				oitResult,
+				"RENDER",
+				LogType::LOG_ERROR,
+				2);
 		}
 
-		path fShape = current_path() / "files" / "shaders" / "debug_shape.frag";
-		if (!exists(fShape))
+		//stays on forward lighting if the g-buffer can't be created, F2 switches paths at runtime
+		DeferredShaders deferredShaders{};
+		deferredShaders.geometry = gbufferShader.Get();
+		deferredShaders.ambient = deferredAmbientShader.Get();
+		deferredShaders.light = deferredLightShader.Get();
+
+		string deferredResult = DeferredRenderer::Initialize(
+			deferredShaders,
+			mainWindow.window->GetClientRectSize());
+		if (!deferredResult.empty())
 		{
-			KalaWindowCore::ForceClose(
-				"Shader load error",
-				"Failed to initialize debug shape shader because debug_shape.frag was not found!");
+			Log::Print(
+				deferredResult,
+				"RENDER",
+				LogType::LOG_ERROR,
+				2);
+		}
 
-			return;
+		string particleResult = ParticleRenderer::Initialize(
+			particleShader.Get(),
+			PARTICLE_FRAME_LIMIT);
+		if (!particleResult.empty())
+		{
+			Log::Print(
+				particleResult,
+				"RENDER",
+				LogType::LOG_ERROR,
+				2);
 		}
 
-		string fShapeText{};
-		string fShapeResult = ReadTextFromFile(fShape, fShapeText);
+		Render::GetModels() = testModel->models;
 
-		if (!fShapeResult.empty())
-		{
-			KalaWindowCore::ForceClose(
-				"Shader load error",
-				fShapeResult);
+		testModelRoot = testModel->models.empty()
+			? nullptr
+			: testModel->models[0];
 
-			return;
-		}
-			
-		OpenGL_Shader* shader_debug_shape = OpenGL_Shader::Initialize(
-			context,
-			"shader_debug_shape",
-			{ {
-				{.shaderData = string(vShapeText), .type = OpenGL_ShaderType::SHADER_VERTEX },
-				{.shaderData = string(fShapeText), .type = OpenGL_ShaderType::SHADER_FRAGMENT }
-			} });
+		//the test emitter sits above the model, at the origin if there is none
+		vec3 newPos{};
 
-		//
-		// LOAD TEST MODEL
-		//
-		
-		path testModel = current_path() / "files" / "models" / "crusher.kmd";
-		if (!exists(testModel))
+		if (testModelRoot)
 		{
-			KalaWindowCore::ForceClose(
-				"Model load error",
-				"Failed to initialize model because crusher.kmd was not found!");
+			OpenGL_Model* m = testModelRoot;
+
+			vec3 newSize = m->GetSize(SizeTarget::SIZE_WORLD) * 0.01f;
+			m->SetSize(SizeTarget::SIZE_WORLD, newSize);
+
+			newPos = m->GetPos(PosTarget::POS_WORLD) + vec3(0.0f, 0.0f, -0.05f);
+			m->SetPos(PosTarget::POS_WORLD, newPos);
 
-			return;
+			m->SetNormalizedDiffuseColor(0.2f);
 		}
 
-		Render::GetModels() = OpenGL_Model::InitializeAll(
-			testModel.string(),
-			context,
-			shader_model);
+		for (OpenGL_Model* model : Render::GetModels()) SceneSystems::AddModel(model);
 
-		OpenGL_Model* m = Render::GetModels()[0];
+		//static models sharing a material are merged into one draw per cell,
+		//the batches replace their sources in the render list
+		RebuildStaticBatches();
 
-		vec3 newSize = m->GetSize(SizeTarget::SIZE_WORLD) * 0.01f;
-		m->SetSize(SizeTarget::SIZE_WORLD, newSize);
+		//the world streams in around the camera, only if the game ships one
+		path worldPath = current_path() / "files" / "models" / "world.kmd";
+		if (AssetPack::Exists(worldPath))
+		{
+			string worldResult = WorldPartition::Open(
+				worldPath,
+				context,
+				modelShader.Get());
+			if (!worldResult.empty())
+			{
+				Log::Print(
+					worldResult,
+					"RENDER",
+					LogType::LOG_ERROR,
+					2);
+			}
+		}
 
-		vec3 newPos = m->GetPos(PosTarget::POS_WORLD) + vec3(0.0f, 0.0f, -0.05f);
-		m->SetPos(PosTarget::POS_WORLD, newPos);
+		//
+		// CREATE TEST EMITTER
+		//
 
-		m->SetNormalizedDiffuseColor(0.2f);
+		ParticleEmitterSettings sparks{};
+		sparks.position = newPos + vec3(0.0f, 0.5f, 0.0f);
+		sparks.spawnExtents = vec3(0.05f);
+		sparks.velocityMin = vec3(-1.0f, 2.0f, -1.0f);
+		sparks.velocityMax = vec3(1.0f, 4.0f, 1.0f);
+		sparks.drag = 0.5f;
+		sparks.lifeMin = 0.5f;
+		sparks.lifeMax = 1.5f;
+		sparks.startColor = vec4(1.0f, 0.8f, 0.3f, 1.0f);
+		sparks.endColor = vec4(1.0f, 0.2f, 0.0f, 0.0f);
+		sparks.startSize = 0.03f;
+		sparks.endSize = 0.01f;
+		sparks.spawnRate = 20000.0f;
+		sparks.maxParticles = 1u << 15;
+
+		particleEmitters.push_back(make_unique<ParticleEmitter>(sparks));
 
 		//
 		// LOAD POINT LIGHT
@@ -311,7 +525,51 @@ namespace GameTest::Graphics
 	MainWindow& Render::GetMainWindow() { return mainWindow; }
 	vector<Camera*>& Render::GetCameras() { return cameras; }
 	vector<OpenGL_Model*>& Render::GetModels() { return models; }
+
+	void Render::RequestStaticBatchRebuild() { isStaticRebuildPending = true; }
 	vector<OpenGL_PointLight*>& Render::GetPointLights() { return pointLights; }
+
+	void Render::ReleaseResources()
+	{
+		WorldPartition::Close();
+
+		models.clear();
+		cullData.clear();
+		SceneSystems::Clear();
+
+		for (const StaticBatch& batch : staticBatches)
+		{
+			OpenGL_Model::GetRegistry().RemoveContent(batch.model);
+		}
+		staticBatches.clear();
+
+		jobWorkers.reset();
+
+		transparentModels.clear();
+
+		particleEmitters.clear();
+		activeEmitters.clear();
+
+		DebugDraw::Shutdown();
+		WeightedOIT::Shutdown();
+		DeferredRenderer::Shutdown();
+		ParticleRenderer::Shutdown();
+		uploadRing.Shutdown();
+		TextureUploader::Shutdown();
+		FrameSync::Shutdown();
+
+		modelShader.Reset();
+		debugShapeShader.Reset();
+		debugLineShader.Reset();
+		oitCompositeShader.Reset();
+		gbufferShader.Reset();
+		deferredAmbientShader.Reset();
+		deferredLightShader.Reset();
+		particleShader.Reset();
+
+		testModelRoot = nullptr;
+		testModel.Reset();
+	}
 	
 	void Render::Update()
 	{
@@ -320,19 +578,21 @@ namespace GameTest::Graphics
 		if (!mw.window) return;
 		
 		Window* w = mw.window;
-		Input* i = mw.input;
 		
+		//messages must be pumped on the thread that created the window,
+		//everything after the pump only reads from the input queue
 		w->Update();
+		InputQueue::Pump();
 		
 		GameTestInput::Update();
+
+		ResourceManager::Update();
 		
 		if (!w->IsIdle()
 			&& !w->IsResizing())
 		{
 			Redraw();
 		}
-		
-		if (i) i->EndFrameUpdate();
 	}
 }
 
@@ -355,6 +615,9 @@ void CreateNewWindow(const string& name)
 	mw.context->SetVSyncState(VSyncState::VSYNC_ON);
 	
 	mw.input = Input::Initialize(windowID);
+
+	//input events are timestamped as their messages are handled instead of once per frame
+	InputQueue::HookWindow();
 	
 	Log::Print(
 		"Created new window '" + name + "'!",
@@ -383,6 +646,11 @@ void Redraw()
 	uintptr_t handle = wData.hdc;
 	
 	OpenGL_Global::MakeContextCurrent(c, handle);
+
+	//blocks here, not in the middle of the frame, when the cpu is too far ahead of the gpu
+	FrameSync::BeginFrame();
+
+	TextureUploader::Update();
 	
 	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
 
@@ -401,11 +669,54 @@ void Redraw()
 		
 	mat4 view = cam->GetViewMatrix();	
 	mat4 perspective = cam->GetPerspectiveMatrix(vpSize);
+
+	//waits only if the gpu is still reading the region from frames in flight ago
+	uploadRing.BeginFrame();
+
+	OpenGL_Model::UploadPointLights(&uploadRing);
 	
 	f32 deltaTime = static_cast<f32>(KalaWindowCore::GetDeltaTime());
 		
-	for (const auto& m : Render::GetModels())
+	//opaque models occlude each other, a model is never hidden by itself
+	//because its own surface can't be nearer than its bounding box
+	occlusionCuller.BeginFrame(perspective * view);
+
+	//queues this frame's budget of streamed model creates and destroys
+	WorldPartition::Update(cam->GetPos());
+
+	//sync point, nothing iterates the model registry here
+	ApplyModelCommands();
+
+	//world matrices are only rebuilt for chunks of models that moved
+	const vector<RenderItem>& renderItems = SceneSystems::Update(jobWorkers.get());
+
+	for (const RenderItem& item : renderItems)
+	{
+		if (item.isOccluder)
+		{
+			occlusionCuller.AddOccluder(GetCullData(item.model).occluder, item.world);
+		}
+	}
+
+	occlusionCuller.Rasterize(jobWorkers.get());
+
+	transparentModels.clear();
+
+	DeferredRenderer::BeginGeometryPass();
+		
+	for (const RenderItem& item : renderItems)
 	{
+		OpenGL_Model* m = item.model;
+
+		const CullData& data = GetCullData(m);
+		if (!occlusionCuller.IsVisible(
+			data.boundsMin,
+			data.boundsMax,
+			item.world))
+		{
+			continue;
+		}
+
 		/*
 		const vec3& right = m->GetRight();
 		vec3 rot = m->GetRot(RotTarget::ROT_COMBINED);
@@ -413,12 +724,29 @@ void Redraw()
 		
 		m->AddRot(RotTarget::ROT_WORLD, rot);
 		*/
+
+		//weighted OIT needs no sorting, transparent models only have to come after the opaque ones,
+		//they also can't be written into the g-buffer
+		if ((WeightedOIT::IsInitialized()
+			|| DeferredRenderer::IsGeometryPassActive())
+			&& item.isTransparent)
+		{
+			transparentModels.push_back(m);
+			continue;
+		}
 		
 		m->Render(
 			cam->GetPos(),
 			view,
 			perspective);
 	}
+
+	//lights, gizmos and transparent models are drawn forward on top of the resolved g-buffer
+	DeferredRenderer::EndGeometryPass(
+		view,
+		perspective,
+		cam->GetPos(),
+		OpenGL_Model::GetPointLightCount());
 	
 	for (const auto& pl : Render::GetPointLights())
 	{
@@ -430,7 +758,9 @@ void Redraw()
 		
 		f32 radius = 2.0f;
 		
-		vec3 center = Render::GetModels()[0]->GetPos(PosTarget::POS_COMBINED);
+		vec3 center = testModelRoot
+			? testModelRoot->GetPos(PosTarget::POS_COMBINED)
+			: vec3{};
 		
 		f32 angleRad = radians(angle);
 		
@@ -440,13 +770,158 @@ void Redraw()
 		newPos.y = center.y;
 		
 		pl->SetPos(PosTarget::POS_WORLD, newPos);
-		
-		pl->Render(
-			view,
-			perspective);
+
+		//every light shape goes into one instanced gizmo draw at DebugDraw::Flush
+		DebugDraw::LightRange(pl);
+	}
+
+	if (!transparentModels.empty())
+	{
+		WeightedOIT::Begin();
+
+		for (OpenGL_Model* m : transparentModels)
+		{
+			m->Render(
+				cam->GetPos(),
+				view,
+				perspective);
+		}
+
+		WeightedOIT::Composite();
+	}
+
+	activeEmitters.clear();
+	for (const auto& emitter : particleEmitters)
+	{
+		emitter->Update(deltaTime, jobWorkers.get());
+		activeEmitters.push_back(emitter.get());
 	}
+
+	ParticleRenderer::Render(
+		activeEmitters,
+		view,
+		perspective,
+		jobWorkers.get());
+
+	//everything queued this frame goes out in one draw per primitive type
+	DebugDraw::Flush(
+		view,
+		perspective);
+
+	uploadRing.EndFrame();
+
+	//geometry paged in for culling, batching or queries this frame goes back to the gpu only
+	OpenGL_Mesh::TrimCpuData();
 		
-	c->SwapOpenGLBuffers(handle);
+	FrameSync::Present(c, handle);
+}
+
+const CullData& GetCullData(OpenGL_Model* model)
+{
+	const shared_ptr<OpenGL_Mesh>& mesh = model->GetMesh();
+
+	auto it = cullData.find(mesh.get());
+	if (it != cullData.end()
+		&& !it->second.mesh.expired())
+	{
+		return it->second;
+	}
+
+	CullData data{};
+	data.mesh = mesh;
+	data.boundsMin = mesh->GetBoundsMin();
+	data.boundsMax = mesh->GetBoundsMax();
+
+	data.occluder = OcclusionCuller::BuildOccluder(
+		mesh->GetVertices(),
+		mesh->GetIndices(),
+		OCCLUDER_TRIANGLE_BUDGET);
+
+	return cullData.insert_or_assign(mesh.get(), move(data)).first->second;
+}
+
+void ApplyModelCommands()
+{
+	OpenGL_Model::GetRegistry().PlaybackCommands(
+		[](OpenGL_Model* model)
+		{
+			Render::GetModels().push_back(model);
+			SceneSystems::AddModel(model);
+		},
+		[](OpenGL_Model* model)
+		{
+			vector<OpenGL_Model*>& models = Render::GetModels();
+			models.erase(remove(models.begin(), models.end(), model), models.end());
+
+			SceneSystems::RemoveModel(model);
+
+			//a destroyed batch hands drawing back to its sources,
+			//a destroyed source is still drawn by its batch until the next rebuild
+			for (auto it = staticBatches.begin(); it != staticBatches.end(); ++it)
+			{
+				if (it->model == model)
+				{
+					for (OpenGL_Model* source : it->sources)
+					{
+						models.push_back(source);
+						SceneSystems::AddModel(source);
+					}
+
+					staticBatches.erase(it);
+					break;
+				}
+
+				it->sources.erase(remove(it->sources.begin(), it->sources.end(), model), it->sources.end());
+			}
+
+			//the last model of a mesh takes its cull data along
+			if (model->GetMesh().use_count() == 1) cullData.erase(model->GetMesh().get());
+		});
+
+	if (isStaticRebuildPending) RebuildStaticBatches();
+
+	//worker threads read models through snapshots, removed models stay alive until they're done
+	OpenGL_Model::GetRegistry().PublishSnapshot();
+}
+
+void RebuildStaticBatches()
+{
+	isStaticRebuildPending = false;
+
+	vector<OpenGL_Model*>& models = Render::GetModels();
+	auto& commands = OpenGL_Model::GetRegistry().GetCommandBuffer();
+
+	//old batches stop drawing right away but are only freed at the next playback,
+	//worker threads may still be reading them through the published snapshot
+	for (const StaticBatch& batch : staticBatches)
+	{
+		models.erase(remove(models.begin(), models.end(), batch.model), models.end());
+		SceneSystems::RemoveModel(batch.model);
+		commands.Destroy(batch.model);
+
+		for (OpenGL_Model* source : batch.sources)
+		{
+			models.push_back(source);
+			SceneSystems::AddModel(source);
+		}
+	}
+
+	u32 drawsBefore = scast<u32>(models.size());
+
+	staticBatches = StaticBatcher::Build(
+		models,
+		Render::GetMainWindow().context);
+
+	for (const StaticBatch& batch : staticBatches)
+	{
+		for (OpenGL_Model* source : batch.sources) SceneSystems::RemoveModel(source);
+		SceneSystems::AddModel(batch.model);
+	}
+
+	Log::Print(
+		"Static batching turned " + to_string(drawsBefore) + " model draws into " + to_string(models.size()) + ".",
+		"RENDER",
+		LogType::LOG_DEBUG);
 }
 
 void Resize()
@@ -460,6 +935,9 @@ void Resize()
 		0,
 		vpSize.x,
 		vpSize.y);
+
+	WeightedOIT::Resize(vpSize);
+	DeferredRenderer::Resize(vpSize);
 }
 
 void AssignUIFunctions()
@@ -0,0 +1,268 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <array>
+#include <any>
+
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_shader.hpp"
+
+#include "graphics/resource_loaders.hpp"
+#include "graphics/texture_uploader.hpp"
+#include "core/resource_manager.hpp"
+#include "core/asset_pack.hpp"
+
+using KalaHeaders::KalaModelData::ModelBlock;
+
+using KalaWindow::OpenGL::OpenGL_ShaderType;
+
+using GameTest::Graphics::ResourceLoaders;
+using GameTest::Graphics::ModelSet;
+using GameTest::Graphics::OpenGL_Texture;
+using GameTest::Graphics::TexturePixels;
+using GameTest::Graphics::TextureFormat;
+using GameTest::Graphics::TextureUploader;
+using GameTest::Core::ResourceManager;
+using GameTest::Core::ResourceRef;
+using GameTest::Core::ResourceHandle;
+using GameTest::Core::ResourceDesc;
+using GameTest::Core::AssetPack;
+using GameTest::GameObject::OpenGL_Model;
+using GameTest::GameObject::MeshFile;
+
+using std::string;
+using std::vector;
+using std::array;
+using std::any;
+using std::any_cast;
+using std::move;
+
+//cpu side result of the shader load stage
+struct ShaderSource
+{
+	string vertText{};
+	string fragText{};
+};
+
+//cpu side result of the model load stage, the file keys the shared meshes and pages their geometry back in
+struct ModelSource
+{
+	vector<ModelBlock> blocks{};
+	MeshFile file{};
+};
+
+namespace GameTest::Graphics
+{
+	ResourceHandle<OpenGL_Shader> ResourceLoaders::LoadShader(
+		OpenGL_Context* context,
+		const string& name,
+		const path& vertPath,
+		const path& fragPath)
+	{
+		ResourceDesc desc{};
+		desc.key = "shader:" + name;
+
+		desc.load = [vertPath, fragPath](any& outData)
+			{
+				ShaderSource source{};
+
+				string result = AssetPack::ReadText(vertPath, source.vertText);
+				if (!result.empty()) return result;
+
+				result = AssetPack::ReadText(fragPath, source.fragText);
+				if (!result.empty()) return result;
+
+				outData = move(source);
+
+				return string{};
+			};
+
+		desc.finalize = [context, name](
+			any& data,
+			const vector<ResourceRef>&,
+			void*& outObject)
+			{
+				ShaderSource& source = any_cast<ShaderSource&>(data);
+
+				OpenGL_Shader* shader = OpenGL_Shader::Initialize(
+					context,
+					name,
+					{ {
+						{.shaderData = move(source.vertText), .type = OpenGL_ShaderType::SHADER_VERTEX },
+						{.shaderData = move(source.fragText), .type = OpenGL_ShaderType::SHADER_FRAGMENT }
+					} });
+
+				if (!shader
+					|| !shader->IsInitialized())
+				{
+					return "Failed to compile shader '" + name + "'!";
+				}
+
+				outObject = shader;
+
+				return string{};
+			};
+
+		desc.destroy = [](void* object)
+			{
+				OpenGL_Shader::GetRegistry().RemoveContent(scast<OpenGL_Shader*>(object));
+			};
+
+		return ResourceManager::Load<OpenGL_Shader>(move(desc));
+	}
+
+	ResourceHandle<OpenGL_Texture> ResourceLoaders::LoadTexture(
+		OpenGL_Context* context,
+		const string& name,
+		const path& texturePath,
+		TextureFormat format,
+		bool flipVertically,
+		u8 mipMapLevels)
+	{
+		string virtualPath = AssetPack::ToVirtualPath(texturePath);
+
+		ResourceDesc desc{};
+		desc.key = "texture:" + virtualPath;
+
+		desc.load = [name, texturePath, format, flipVertically](any& outData)
+			{
+				TexturePixels pixels{};
+
+				string result = OpenGL_Texture::DecodeFile(
+					name,
+					texturePath.string(),
+					format,
+					flipVertically,
+					pixels);
+
+				if (!result.empty()) return result;
+
+				outData = move(pixels);
+
+				return string{};
+			};
+
+		desc.finalize = [context, name, texturePath, mipMapLevels](
+			any& data,
+			const vector<ResourceRef>&,
+			void*& outObject)
+			{
+				OpenGL_Texture* texture = OpenGL_Texture::InitializeFromPixels(
+					context,
+					name,
+					texturePath.string(),
+					move(any_cast<TexturePixels&>(data)),
+					mipMapLevels,
+					TextureUploader::IsInitialized());
+
+				if (!texture) return "Failed to upload texture '" + name + "'!";
+
+				//a failed upload still renders, with the shared fallback texture
+				outObject = texture;
+
+				return string{};
+			};
+
+		desc.destroy = [](void* object)
+			{
+				OpenGL_Texture* texture = scast<OpenGL_Texture*>(object);
+				if (texture == OpenGL_Texture::GetFallbackTexture()) return;
+
+				OpenGL_Texture::GetRegistry().RemoveContent(texture);
+			};
+
+		return ResourceManager::Load<OpenGL_Texture>(move(desc));
+	}
+
+	ResourceHandle<ModelSet> ResourceLoaders::LoadModel(
+		OpenGL_Context* context,
+		const path& modelPath,
+		const ResourceHandle<OpenGL_Shader>& shader,
+		const ResourceHandle<OpenGL_Texture>& diffuseTexture,
+		bool isStatic)
+	{
+		string virtualPath = AssetPack::ToVirtualPath(modelPath);
+
+		ResourceDesc desc{};
+		desc.key = "model:" + virtualPath + ":" + shader.GetKey() + ":" + diffuseTexture.GetKey();
+		if (isStatic) desc.key += ":static";
+
+		desc.dependencies.push_back(shader);
+		if (diffuseTexture.IsValid()) desc.dependencies.push_back(diffuseTexture);
+
+		desc.load = [modelPath](any& outData)
+			{
+				ModelSource source{};
+
+				string result = OpenGL_Model::ImportFile(
+					modelPath.string(),
+					source.blocks,
+					source.file);
+				if (!result.empty()) return result;
+
+				outData = move(source);
+
+				return string{};
+			};
+
+		desc.finalize = [context, virtualPath, isStatic](
+			any& data,
+			const vector<ResourceRef>& dependencies,
+			void*& outObject)
+			{
+				OpenGL_Shader* shader = scast<OpenGL_Shader*>(dependencies[0].GetObject());
+				OpenGL_Texture* diffuse = dependencies.size() > 1
+					? scast<OpenGL_Texture*>(dependencies[1].GetObject())
+					: nullptr;
+
+				ModelSource& source = any_cast<ModelSource&>(data);
+
+				//blocks whose mesh is already loaded drop their geometry here instead of uploading it again
+				ModelSet* set = new ModelSet();
+				set->models = OpenGL_Model::InitializeBlocks(
+					move(source.blocks),
+					context,
+					shader,
+					false,
+					source.file);
+
+				if (set->models.empty())
+				{
+					delete set;
+					return "Model '" + virtualPath + "' has no models that could be initialized!";
+				}
+
+				for (OpenGL_Model* model : set->models)
+				{
+					if (!model) continue;
+
+					if (diffuse) model->SetDiffuseTexture(diffuse);
+					model->SetStaticState(isStatic);
+				}
+
+				outObject = set;
+
+				return string{};
+			};
+
+		desc.destroy = [](void* object)
+			{
+				ModelSet* set = scast<ModelSet*>(object);
+
+				for (OpenGL_Model* model : set->models)
+				{
+					OpenGL_Model::GetRegistry().RemoveContent(model);
+				}
+
+				delete set;
+			};
+
+		return ResourceManager::Load<ModelSet>(move(desc));
+	}
+}
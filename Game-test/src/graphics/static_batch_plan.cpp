@@ -0,0 +1,123 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <array>
+#include <map>
+#include <cmath>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "graphics/static_batch_plan.hpp"
+
+using KalaHeaders::KalaMath::vec3;
+
+using GameTest::Graphics::StaticBatchPlan;
+using GameTest::Graphics::StaticBatchSource;
+
+using std::vector;
+using std::array;
+using std::map;
+using std::floor;
+using std::move;
+
+//integer coordinates of a batching cell
+using Cell = array<i32, 3>;
+
+//sources that share one material, sorted into cells by the center of their world bounds
+struct MaterialGroup
+{
+	u32 material{};
+	map<Cell, vector<u32>> cells{};
+};
+
+namespace GameTest::Graphics
+{
+	vector<vector<u32>> StaticBatchPlan::Plan(
+		const vector<StaticBatchSource>& sources,
+		f32 chunkSize,
+		u32 maxVertices)
+	{
+		vector<vector<u32>> batches{};
+
+		if (chunkSize <= 0.0f) return batches;
+
+		//groups keep the order their material first shows up in, so the plan is stable between runs
+		vector<MaterialGroup> groups{};
+
+		for (u32 i = 0; i < sources.size(); ++i)
+		{
+			const StaticBatchSource& source = sources[i];
+
+			if (source.vertexCount == 0
+				|| source.vertexCount > maxVertices)
+			{
+				continue;
+			}
+
+			MaterialGroup* group{};
+			for (MaterialGroup& g : groups)
+			{
+				if (g.material == source.material)
+				{
+					group = &g;
+					break;
+				}
+			}
+
+			if (!group)
+			{
+				groups.push_back({ source.material, {} });
+				group = &groups.back();
+			}
+
+			vec3 center = source.worldCenter / chunkSize;
+			Cell cell =
+			{
+				scast<i32>(floor(center.x)),
+				scast<i32>(floor(center.y)),
+				scast<i32>(floor(center.z))
+			};
+
+			group->cells[cell].push_back(i);
+		}
+
+		auto FlushBatch = [&batches](vector<u32>& batch)
+			{
+				//a single model is already one draw call
+				if (batch.size() > 1) batches.push_back(move(batch));
+
+				batch.clear();
+			};
+
+		for (MaterialGroup& group : groups)
+		{
+			for (auto& [cell, cellSources] : group.cells)
+			{
+				vector<u32> batch{};
+				size_t vertexCount{};
+
+				for (u32 index : cellSources)
+				{
+					size_t sourceVertices = sources[index].vertexCount;
+
+					if (vertexCount + sourceVertices > maxVertices)
+					{
+						FlushBatch(batch);
+						vertexCount = 0;
+					}
+
+					batch.push_back(index);
+					vertexCount += sourceVertices;
+				}
+
+				FlushBatch(batch);
+			}
+		}
+
+		return batches;
+	}
+}
@@ -0,0 +1,307 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "graphics/static_batcher.hpp"
+#include "graphics/weighted_oit.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::quat;
+using KalaHeaders::KalaMath::normalize;
+using KalaHeaders::KalaMath::normalize_q;
+using KalaHeaders::KalaMath::isnear;
+using KalaHeaders::KalaMath::PosTarget;
+using KalaHeaders::KalaMath::RotTarget;
+using KalaHeaders::KalaMath::SizeTarget;
+using KalaHeaders::KalaModelData::Vertex;
+
+using KalaWindow::OpenGL::OpenGL_Context;
+
+using GameTest::GameObject::OpenGL_Model;
+using GameTest::Graphics::StaticBatcher;
+using GameTest::Graphics::StaticBatch;
+using GameTest::Graphics::StaticBatchPlan;
+using GameTest::Graphics::StaticBatchSource;
+using GameTest::Graphics::WeightedOIT;
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::unordered_map;
+using std::unordered_set;
+using std::min;
+using std::max;
+using std::find_if;
+using std::move;
+
+//World space center of the model space bounds
+static vec3 GetWorldCenter(OpenGL_Model* model);
+
+//Pre-transforms every source into world space and uploads them as one identity transform model
+static StaticBatch MergeModels(
+	const vector<OpenGL_Model*>& sources,
+	const string& name,
+	OpenGL_Context* context);
+
+namespace GameTest::Graphics
+{
+	vector<StaticBatch> StaticBatcher::Build(
+		vector<OpenGL_Model*>& models,
+		OpenGL_Context* context,
+		f32 chunkSize,
+		u32 maxVertices)
+	{
+		if (chunkSize <= 0.0f)
+		{
+			Log::Print(
+				"Cannot build static batches because the chunk size '" + to_string(chunkSize) + "' is not above zero!",
+				"STATIC_BATCHER",
+				LogType::LOG_ERROR,
+				2);
+
+			return {};
+		}
+
+		//eligible models and the material each one shares with an earlier model
+		vector<OpenGL_Model*> candidates{};
+		vector<StaticBatchSource> sources{};
+		vector<OpenGL_Model*> materials{};
+
+		for (OpenGL_Model* model : models)
+		{
+			//without weighted OIT transparent models blend in draw order, which merging would change
+			if (!model
+				|| !model->IsInitialized()
+				|| !model->IsStatic()
+				|| (model->IsTransparent()
+				&& !WeightedOIT::IsInitialized())
+				|| model->GetVertexCount() == 0
+				|| model->GetVertexCount() > maxVertices)
+			{
+				continue;
+			}
+
+			auto it = find_if(
+				materials.begin(),
+				materials.end(),
+				[model](const OpenGL_Model* m) { return m->HasSameMaterial(*model); });
+
+			if (it == materials.end())
+			{
+				materials.push_back(model);
+				it = materials.end() - 1;
+			}
+
+			StaticBatchSource source{};
+			source.material = scast<u32>(it - materials.begin());
+			source.worldCenter = GetWorldCenter(model);
+			source.vertexCount = model->GetVertexCount();
+
+			candidates.push_back(model);
+			sources.push_back(source);
+		}
+
+		vector<StaticBatch> batches{};
+
+		//source model to the index of the batch that draws it
+		unordered_map<OpenGL_Model*, size_t> batchOf{};
+
+		u32 mergedCount{};
+
+		for (const vector<u32>& plan : StaticBatchPlan::Plan(sources, chunkSize, maxVertices))
+		{
+			vector<OpenGL_Model*> batchSources{};
+			batchSources.reserve(plan.size());
+
+			for (u32 index : plan) batchSources.push_back(candidates[index]);
+
+			StaticBatch batch = MergeModels(
+				batchSources,
+				"static_batch_" + to_string(batches.size()),
+				context);
+
+			if (!batch.model) continue;
+
+			for (OpenGL_Model* source : batch.sources) batchOf[source] = batches.size();
+
+			mergedCount += scast<u32>(batch.sources.size());
+			batches.push_back(move(batch));
+		}
+
+		if (batches.empty()) return batches;
+
+		//each batch takes the place of its first source, the other sources are dropped
+		vector<OpenGL_Model*> remaining{};
+		remaining.reserve(models.size() - mergedCount + batches.size());
+
+		unordered_set<size_t> placed{};
+
+		for (OpenGL_Model* model : models)
+		{
+			auto it = batchOf.find(model);
+			if (it == batchOf.end())
+			{
+				remaining.push_back(model);
+				continue;
+			}
+
+			if (placed.insert(it->second).second)
+			{
+				remaining.push_back(batches[it->second].model);
+			}
+		}
+
+		models = move(remaining);
+
+		Log::Print(
+			"Merged " + to_string(mergedCount) + " static models into " + to_string(batches.size()) + " batches.",
+			"STATIC_BATCHER",
+			LogType::LOG_SUCCESS);
+
+		return batches;
+	}
+}
+
+vec3 GetWorldCenter(OpenGL_Model* model)
+{
+	vec3 boundsMin(1e30f);
+	vec3 boundsMax(-1e30f);
+
+	for (const Vertex& v : model->GetVertices())
+	{
+		vec3 p(v.position);
+
+		boundsMin = vec3(min(boundsMin.x, p.x), min(boundsMin.y, p.y), min(boundsMin.z, p.z));
+		boundsMax = vec3(max(boundsMax.x, p.x), max(boundsMax.y, p.y), max(boundsMax.z, p.z));
+	}
+
+	vec3 localCenter = (boundsMin + boundsMax) * 0.5f;
+
+	return model->GetPos(PosTarget::POS_COMBINED)
+		+ normalize_q(model->GetRotQuat(RotTarget::ROT_COMBINED))
+		* (localCenter * model->GetSize(SizeTarget::SIZE_COMBINED));
+}
+
+StaticBatch MergeModels(
+	const vector<OpenGL_Model*>& sources,
+	const string& name,
+	OpenGL_Context* context)
+{
+	size_t vertexCount{};
+	size_t indexCount{};
+
+	for (OpenGL_Model* source : sources)
+	{
+		vertexCount += source->GetVertexCount();
+		indexCount += source->GetIndexCount();
+	}
+
+	vector<Vertex> vertices{};
+	vector<u32> indices{};
+	vertices.reserve(vertexCount);
+	indices.reserve(indexCount);
+
+	StaticBatch batch{};
+	batch.boundsMin = vec3(1e30f);
+	batch.boundsMax = vec3(-1e30f);
+
+	for (OpenGL_Model* source : sources)
+	{
+		vec3 pos = source->GetPos(PosTarget::POS_COMBINED);
+		quat rot = normalize_q(source->GetRotQuat(RotTarget::ROT_COMBINED));
+		vec3 size = source->GetSize(SizeTarget::SIZE_COMBINED);
+
+		//normals follow the inverse scale, tangents follow the scale like positions do
+		vec3 inverseSize(
+			isnear(size.x) ? 0.0f : 1.0f / size.x,
+			isnear(size.y) ? 0.0f : 1.0f / size.y,
+			isnear(size.z) ? 0.0f : 1.0f / size.z);
+
+		//an odd number of mirrored axes turns the winding around
+		bool isMirrored = size.x * size.y * size.z < 0.0f;
+
+		u32 baseVertex = scast<u32>(vertices.size());
+
+		for (const Vertex& v : source->GetVertices())
+		{
+			Vertex out = v;
+
+			vec3 p = pos + rot * (vec3(v.position) * size);
+			vec3 n = normalize(rot * (vec3(v.normal) * inverseSize));
+			vec3 t = normalize(rot * (vec3(v.tangent[0], v.tangent[1], v.tangent[2]) * size));
+
+			out.position[0] = p.x;
+			out.position[1] = p.y;
+			out.position[2] = p.z;
+
+			out.normal[0] = n.x;
+			out.normal[1] = n.y;
+			out.normal[2] = n.z;
+
+			//w keeps the bitangent sign, mirroring flips it
+			out.tangent[0] = t.x;
+			out.tangent[1] = t.y;
+			out.tangent[2] = t.z;
+			out.tangent[3] = isMirrored ? -v.tangent[3] : v.tangent[3];
+
+			batch.boundsMin = vec3(min(batch.boundsMin.x, p.x), min(batch.boundsMin.y, p.y), min(batch.boundsMin.z, p.z));
+			batch.boundsMax = vec3(max(batch.boundsMax.x, p.x), max(batch.boundsMax.y, p.y), max(batch.boundsMax.z, p.z));
+
+			vertices.push_back(out);
+		}
+
+		const vector<u32>& sourceIndices = source->GetIndices();
+
+		for (size_t i = 0; i + 2 < sourceIndices.size(); i += 3)
+		{
+			u32 a = baseVertex + sourceIndices[i];
+			u32 b = baseVertex + sourceIndices[i + 1];
+			u32 c = baseVertex + sourceIndices[i + 2];
+
+			indices.push_back(a);
+			indices.push_back(isMirrored ? c : b);
+			indices.push_back(isMirrored ? b : c);
+		}
+	}
+
+	OpenGL_Model* first = sources.front();
+
+	batch.model = OpenGL_Model::InitializeSingle(
+		name,
+		context,
+		vertices,
+		indices,
+		first->GetShader());
+
+	if (!batch.model)
+	{
+		Log::Print(
+			"Failed to create static batch '" + name + "', its " + to_string(sources.size()) + " models are drawn one by one!",
+			"STATIC_BATCHER",
+			LogType::LOG_ERROR,
+			2);
+
+		return {};
+	}
+
+	batch.model->CopyMaterial(*first);
+	batch.model->SetStaticState(true);
+	batch.sources = sources;
+
+	return batch;
+}
@@ -0,0 +1,324 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "graphics/stream_ring.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using GameTest::Graphics::StreamRing;
+using GameTest::Graphics::StreamRingGL;
+using GameTest::Graphics::StreamRingMode;
+using GameTest::Graphics::StreamAllocation;
+using GameTest::Graphics::STREAM_RING_MAX_FRAMES;
+using GameTest::Graphics::STREAM_RING_REGION_ALIGNMENT;
+
+using std::string;
+using std::to_string;
+using std::max;
+using std::min;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+//how long a single wait on a region fence blocks before it is retried, in nanoseconds
+constexpr GLuint64 FENCE_WAIT_STEP = 1'000'000;
+
+//buffer storage and mapping flags of the persistent path
+constexpr GLbitfield PERSISTENT_FLAGS =
+	GL_MAP_WRITE_BIT
+	| GL_MAP_PERSISTENT_BIT
+	| GL_MAP_COHERENT_BIT;
+
+static size_t AlignUp(
+	size_t value,
+	size_t alignment);
+
+namespace GameTest::Graphics
+{
+	string StreamRing::Initialize(
+		size_t newRegionSize,
+		u32 framesInFlight,
+		StreamRingMode mode,
+		const StreamRingGL& glTable)
+	{
+		if (isInitialized) return "Stream ring is already initialized!";
+
+		if (newRegionSize == 0) return "Stream ring region size must be above 0!";
+
+		if (framesInFlight == 0
+			|| framesInFlight > STREAM_RING_MAX_FRAMES)
+		{
+			return "Stream ring frames in flight must be between 1 and " + to_string(STREAM_RING_MAX_FRAMES) + "!";
+		}
+
+		gl = glTable;
+
+		if (mode == StreamRingMode::STREAM_AUTO)
+		{
+			bool canPersist =
+				gl.glBufferStorage
+				&& gl.glMapBufferRange
+				&& gl.hasBufferStorage;
+
+			mode = canPersist
+				? StreamRingMode::STREAM_PERSISTENT
+				: StreamRingMode::STREAM_ORPHAN;
+		}
+
+		isPersistent = mode == StreamRingMode::STREAM_PERSISTENT;
+
+		GLint alignment{};
+		gl.glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		if (alignment > 0) uniformAlignment = scast<size_t>(alignment);
+
+		regionSize = AlignUp(newRegionSize, max(STREAM_RING_REGION_ALIGNMENT, uniformAlignment));
+
+		//orphaning hands out fresh storage every frame, so one region is enough
+		frameCount = isPersistent ? framesInFlight : 1;
+
+		size_t totalSize = regionSize * frameCount;
+
+		//the copy write target is never read by draws, so binding it here disturbs no other state
+		gl.glGenBuffers(1, &buffer);
+		gl.glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+
+		if (isPersistent)
+		{
+			gl.glBufferStorage(
+				GL_COPY_WRITE_BUFFER,
+				scast<GLsizeiptr>(totalSize),
+				nullptr,
+				PERSISTENT_FLAGS);
+
+			mapped = scast<u8*>(gl.glMapBufferRange(
+				GL_COPY_WRITE_BUFFER,
+				0,
+				scast<GLsizeiptr>(totalSize),
+				PERSISTENT_FLAGS));
+
+			if (!mapped)
+			{
+				gl.glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+				gl.glDeleteBuffers(1, &buffer);
+				buffer = 0;
+
+				return "Failed to persistently map a stream ring of " + to_string(totalSize) + " bytes!";
+			}
+		}
+		else
+		{
+			gl.glBufferData(
+				GL_COPY_WRITE_BUFFER,
+				scast<GLsizeiptr>(totalSize),
+				nullptr,
+				GL_STREAM_DRAW);
+
+			shadow.resize(regionSize);
+		}
+
+		gl.glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		//the last region is the one before the first BeginFrame
+		region = frameCount - 1;
+		isInitialized = true;
+
+		Log::Print(
+			"Initialized " + string(isPersistent ? "persistent" : "orphaning")
+			+ " stream ring with " + to_string(frameCount) + " regions of " + to_string(regionSize) + " bytes.",
+			"STREAM_RING",
+			LogType::LOG_SUCCESS);
+
+		return {};
+	}
+
+	void StreamRing::BeginFrame()
+	{
+		if (!isInitialized) return;
+
+		if (isInFrame) EndFrame();
+
+		region = (region + 1) % frameCount;
+		used = 0;
+		flushed = 0;
+
+		if (isPersistent)
+		{
+			GLsync& fence = fences[region];
+			if (fence)
+			{
+				//a zero timeout poll tells a free region from a stall without blocking
+				GLenum result = gl.glClientWaitSync(fence, 0, 0);
+
+				if (result == GL_TIMEOUT_EXPIRED)
+				{
+					++stats.stallCount;
+
+					auto start = steady_clock::now();
+
+					do
+					{
+						result = gl.glClientWaitSync(
+							fence,
+							GL_SYNC_FLUSH_COMMANDS_BIT,
+							FENCE_WAIT_STEP);
+					} while (result == GL_TIMEOUT_EXPIRED);
+
+					stats.stallMilliseconds += duration<f64, std::milli>(steady_clock::now() - start).count();
+				}
+
+				if (result == GL_WAIT_FAILED)
+				{
+					Log::Print(
+						"Waiting on a stream ring fence failed, the region is reused without synchronization!",
+						"STREAM_RING",
+						LogType::LOG_ERROR,
+						2);
+				}
+
+				gl.glDeleteSync(fence);
+				fence = nullptr;
+			}
+		}
+		else
+		{
+			gl.glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			gl.glBufferData(
+				GL_COPY_WRITE_BUFFER,
+				scast<GLsizeiptr>(regionSize),
+				nullptr,
+				GL_STREAM_DRAW);
+			gl.glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+
+		isInFrame = true;
+	}
+
+	StreamAllocation StreamRing::Allocate(
+		size_t size,
+		size_t alignment)
+	{
+		if (!isInitialized
+			|| !isInFrame
+			|| size == 0)
+		{
+			return {};
+		}
+
+		//regions start on STREAM_RING_REGION_ALIGNMENT, so aligning inside the region aligns in the buffer
+		size_t start = AlignUp(used, max<size_t>(alignment, 1));
+
+		if (start + size > regionSize)
+		{
+			++stats.overflowCount;
+			return {};
+		}
+
+		used = start + size;
+		stats.peakFrameBytes = max(stats.peakFrameBytes, used);
+		++stats.allocationCount;
+
+		StreamAllocation allocation{};
+		allocation.buffer = buffer;
+		allocation.size = size;
+
+		if (isPersistent)
+		{
+			allocation.offset = region * regionSize + start;
+			allocation.data = mapped + allocation.offset;
+		}
+		else
+		{
+			allocation.offset = start;
+			allocation.data = shadow.data() + start;
+		}
+
+		return allocation;
+	}
+
+	void StreamRing::Flush()
+	{
+		if (!isInitialized
+			|| isPersistent
+			|| flushed == used)
+		{
+			return;
+		}
+
+		gl.glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		gl.glBufferSubData(
+			GL_COPY_WRITE_BUFFER,
+			scast<GLintptr>(flushed),
+			scast<GLsizeiptr>(used - flushed),
+			shadow.data() + flushed);
+		gl.glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		flushed = used;
+	}
+
+	void StreamRing::EndFrame()
+	{
+		if (!isInitialized
+			|| !isInFrame)
+		{
+			return;
+		}
+
+		Flush();
+
+		//an unused region has nothing for the gpu to finish
+		if (isPersistent
+			&& used > 0)
+		{
+			fences[region] = gl.glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+
+		++stats.frameCount;
+		isInFrame = false;
+	}
+
+	void StreamRing::Shutdown()
+	{
+		if (!isInitialized) return;
+
+		for (GLsync& fence : fences)
+		{
+			if (!fence) continue;
+
+			gl.glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		if (mapped)
+		{
+			gl.glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			gl.glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			gl.glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+			mapped = nullptr;
+		}
+
+		gl.glDeleteBuffers(1, &buffer);
+		buffer = 0;
+
+		shadow = {};
+		used = 0;
+		flushed = 0;
+		isInFrame = false;
+		isInitialized = false;
+	}
+}
+
+size_t AlignUp(
+	size_t value,
+	size_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
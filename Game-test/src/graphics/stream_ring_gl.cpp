@@ -0,0 +1,48 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_functions_core.hpp"
+
+#include "graphics/stream_ring.hpp"
+#include "graphics/gl_extra_functions.hpp"
+
+using KalaWindow::OpenGL::OpenGL_Global;
+using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
+using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
+
+using GameTest::Graphics::StreamRing;
+using GameTest::Graphics::StreamRingGL;
+using GameTest::Graphics::GL_Extra;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+
+namespace GameTest::Graphics
+{
+	StreamRingGL StreamRing::GetContextGL()
+	{
+		const GL_Core* core = OpenGL_Functions_Core::GetGLCore();
+		const GL_Extra* extra = OpenGL_Functions_Extra::GetGLExtra();
+
+		StreamRingGL gl{};
+
+		gl.glGenBuffers = core->glGenBuffers;
+		gl.glDeleteBuffers = core->glDeleteBuffers;
+		gl.glBindBuffer = core->glBindBuffer;
+		gl.glBufferData = core->glBufferData;
+		gl.glBufferSubData = core->glBufferSubData;
+		gl.glBufferStorage = core->glBufferStorage;
+		gl.glMapBufferRange = core->glMapBufferRange;
+		gl.glUnmapBuffer = extra->glUnmapBuffer;
+		gl.glGetIntegerv = core->glGetIntegerv;
+
+		gl.glFenceSync = extra->glFenceSync;
+		gl.glClientWaitSync = extra->glClientWaitSync;
+		gl.glDeleteSync = extra->glDeleteSync;
+
+		gl.hasBufferStorage = OpenGL_Global::IsExtensionSupported("GL_ARB_buffer_storage");
+
+		return gl;
+	}
+}
@@ -0,0 +1,441 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <cstring>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_functions_core.hpp"
+
+#include "graphics/texture_uploader.hpp"
+#include "graphics/gl_extra_functions.hpp"
+#include "core/thread_pool.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using KalaWindow::OpenGL::OpenGL_Global;
+using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
+using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
+
+using GameTest::Core::ThreadPool;
+using GameTest::Graphics::TextureUploader;
+using GameTest::Graphics::OpenGL_Texture;
+using GameTest::Graphics::GL_Extra;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+
+using std::string;
+using std::to_string;
+using std::deque;
+using std::unique_ptr;
+using std::make_unique;
+using std::shared_ptr;
+using std::make_shared;
+using std::move;
+using std::atomic;
+using std::memory_order_acquire;
+using std::memory_order_release;
+
+//staging offsets are kept aligned for any pixel format
+constexpr size_t STAGING_ALIGNMENT = 16u;
+
+constexpr GLbitfield PERSISTENT_FLAGS =
+	GL_MAP_WRITE_BIT
+	| GL_MAP_PERSISTENT_BIT
+	| GL_MAP_COHERENT_BIT;
+
+enum class UploadStage : u8
+{
+	//a worker is copying pixels into staging memory
+	STAGE_COPYING,
+	//glTexSubImage2D was issued, waiting on the fence
+	STAGE_UPLOADING
+};
+
+struct PendingUpload
+{
+	//null once the texture was destroyed before the upload finished
+	OpenGL_Texture* texture{};
+
+	u32 textureID{};
+	GLsizei width{};
+	GLsizei height{};
+	GLenum format{};
+	GLenum type{};
+	u8 mipMapLevels{};
+
+	//staging range, or a buffer of its own when transientPBO is set
+	size_t offset{};
+	size_t size{};
+	u32 transientPBO{};
+
+	shared_ptr<atomic<bool>> isCopied{};
+	GLsync fence{};
+
+	UploadStage stage = UploadStage::STAGE_COPYING;
+};
+
+static bool isInitialized{};
+static bool isPersistent{};
+
+static unique_ptr<ThreadPool> copyWorkers{};
+
+static u32 stagingBuffer{};
+static u8* stagingData{};
+static size_t stagingSize{};
+
+//uploads retire in queue order, so the used part of the staging ring
+//always runs from the front upload to stagingHead
+static size_t stagingHead{};
+static size_t stagingTail{};
+
+static deque<PendingUpload> uploads{};
+
+//returns false if the staging ring has no room for size bytes right now
+static bool AllocateStaging(
+	size_t size,
+	size_t& outOffset);
+
+static void ReleaseUpload(PendingUpload& upload);
+
+namespace GameTest::Graphics
+{
+	string TextureUploader::Initialize(
+		size_t newStagingSize,
+		u32 threadCount)
+	{
+		if (isInitialized) return "Texture uploader is already initialized!";
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		isPersistent =
+			coreFunc->glBufferStorage
+			&& OpenGL_Global::IsExtensionSupported("GL_ARB_buffer_storage");
+
+		if (isPersistent)
+		{
+			stagingSize = newStagingSize;
+
+			coreFunc->glGenBuffers(1, &stagingBuffer);
+			coreFunc->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+			coreFunc->glBufferStorage(
+				GL_PIXEL_UNPACK_BUFFER,
+				scast<GLsizeiptr>(stagingSize),
+				nullptr,
+				PERSISTENT_FLAGS);
+
+			stagingData = scast<u8*>(coreFunc->glMapBufferRange(
+				GL_PIXEL_UNPACK_BUFFER,
+				0,
+				scast<GLsizeiptr>(stagingSize),
+				PERSISTENT_FLAGS));
+
+			coreFunc->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+			if (!stagingData)
+			{
+				coreFunc->glDeleteBuffers(1, &stagingBuffer);
+				stagingBuffer = 0;
+
+				return "Failed to map " + to_string(stagingSize) + " bytes of texture staging memory!";
+			}
+		}
+
+		copyWorkers = make_unique<ThreadPool>(threadCount);
+
+		isInitialized = true;
+
+		Log::Print(
+			"Initialized texture uploader with "
+			+ (isPersistent
+				? to_string(stagingSize) + " bytes of persistent staging memory."
+				: string("a pixel buffer per upload.")),
+			"TEXTURE_UPLOADER",
+			LogType::LOG_SUCCESS);
+
+		return {};
+	}
+	bool TextureUploader::IsInitialized() { return isInitialized; }
+
+	bool TextureUploader::Queue(
+		OpenGL_Texture* texture,
+		u32 glFormat,
+		u32 glType,
+		u8 mipMapLevels)
+	{
+		if (!isInitialized
+			|| !texture
+			|| texture->pixels.empty())
+		{
+			return false;
+		}
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		PendingUpload upload{};
+		upload.texture = texture;
+		upload.textureID = texture->textureID;
+		upload.width = scast<GLsizei>(texture->size.x);
+		upload.height = scast<GLsizei>(texture->size.y);
+		upload.format = glFormat;
+		upload.type = glType;
+		upload.mipMapLevels = mipMapLevels;
+		upload.size = texture->pixels.size();
+		upload.isCopied = make_shared<atomic<bool>>(false);
+
+		u8* destination{};
+
+		if (isPersistent)
+		{
+			//textures larger than the whole ring, or a full ring, take the synchronous path
+			if (!AllocateStaging(upload.size, upload.offset)) return false;
+
+			destination = stagingData + upload.offset;
+		}
+		else
+		{
+			coreFunc->glGenBuffers(1, &upload.transientPBO);
+			coreFunc->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.transientPBO);
+			coreFunc->glBufferData(
+				GL_PIXEL_UNPACK_BUFFER,
+				scast<GLsizeiptr>(upload.size),
+				nullptr,
+				GL_STREAM_DRAW);
+
+			destination = scast<u8*>(coreFunc->glMapBufferRange(
+				GL_PIXEL_UNPACK_BUFFER,
+				0,
+				scast<GLsizeiptr>(upload.size),
+				GL_MAP_WRITE_BIT
+				| GL_MAP_INVALIDATE_BUFFER_BIT));
+
+			coreFunc->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+			if (!destination)
+			{
+				coreFunc->glDeleteBuffers(1, &upload.transientPBO);
+				return false;
+			}
+		}
+
+		//the texture keeps its cpu pixels, Cancel waits for this copy before they can be freed
+		const u8* source = texture->pixels.data();
+		size_t size = upload.size;
+		shared_ptr<atomic<bool>> isCopied = upload.isCopied;
+
+		copyWorkers->Submit([destination, source, size, isCopied]()
+			{
+				memcpy(destination, source, size);
+				isCopied->store(true, memory_order_release);
+			});
+
+		uploads.push_back(move(upload));
+
+		return true;
+	}
+
+	void TextureUploader::Update()
+	{
+		if (!isInitialized
+			|| uploads.empty())
+		{
+			return;
+		}
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+		const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+		bool isPBOBound{};
+
+		for (PendingUpload& upload : uploads)
+		{
+			if (upload.stage != UploadStage::STAGE_COPYING
+				|| !upload.isCopied->load(memory_order_acquire))
+			{
+				continue;
+			}
+
+			upload.stage = UploadStage::STAGE_UPLOADING;
+
+			if (!upload.texture) continue;
+
+			u32 pbo = upload.transientPBO ? upload.transientPBO : stagingBuffer;
+
+			coreFunc->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+			isPBOBound = true;
+
+			if (upload.transientPBO) extraFunc->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+			coreFunc->glBindTexture(GL_TEXTURE_2D, upload.textureID);
+
+			//rows are tightly packed for every format
+			coreFunc->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			//with a pixel unpack buffer bound the data pointer is a byte offset into it
+			coreFunc->glTexSubImage2D(
+				GL_TEXTURE_2D,
+				0,
+				0,
+				0,
+				upload.width,
+				upload.height,
+				upload.format,
+				upload.type,
+				reinterpret_cast<const void*>(upload.offset));
+
+			if (upload.mipMapLevels > 1) coreFunc->glGenerateMipmap(GL_TEXTURE_2D);
+
+			upload.fence = extraFunc->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+
+		//a bound unpack buffer would turn later client memory uploads into offsets
+		if (isPBOBound) coreFunc->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		while (!uploads.empty())
+		{
+			PendingUpload& upload = uploads.front();
+
+			if (upload.stage != UploadStage::STAGE_UPLOADING) break;
+
+			if (upload.fence)
+			{
+				//never blocks, an unfinished upload is checked again next frame
+				GLenum result = extraFunc->glClientWaitSync(upload.fence, 0, 0);
+				if (result == GL_TIMEOUT_EXPIRED) break;
+			}
+
+			if (upload.texture) upload.texture->isUploaded = true;
+
+			ReleaseUpload(upload);
+			uploads.pop_front();
+		}
+
+		if (uploads.empty())
+		{
+			stagingHead = 0;
+			stagingTail = 0;
+		}
+		else if (!uploads.front().transientPBO)
+		{
+			stagingTail = uploads.front().offset;
+		}
+	}
+
+	void TextureUploader::Cancel(OpenGL_Texture* texture)
+	{
+		if (!isInitialized) return;
+
+		for (PendingUpload& upload : uploads)
+		{
+			if (upload.texture != texture) continue;
+
+			//the copy reads from the texture's own pixels
+			while (!upload.isCopied->load(memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+
+			//still retired in order so the staging ring stays contiguous
+			upload.texture = nullptr;
+		}
+	}
+
+	u32 TextureUploader::GetPendingCount() { return scast<u32>(uploads.size()); }
+
+	void TextureUploader::Shutdown()
+	{
+		if (!isInitialized) return;
+
+		copyWorkers->WaitIdle();
+		copyWorkers.reset();
+
+		for (PendingUpload& upload : uploads)
+		{
+			ReleaseUpload(upload);
+		}
+		uploads.clear();
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		if (stagingBuffer != 0)
+		{
+			//deleting a buffer also releases its mapping
+			coreFunc->glDeleteBuffers(1, &stagingBuffer);
+			stagingBuffer = 0;
+		}
+
+		stagingData = nullptr;
+		stagingSize = 0;
+		stagingHead = 0;
+		stagingTail = 0;
+
+		isInitialized = false;
+	}
+}
+
+bool AllocateStaging(
+	size_t size,
+	size_t& outOffset)
+{
+	if (size > stagingSize) return false;
+
+	bool isRingEmpty = true;
+	for (const PendingUpload& upload : uploads)
+	{
+		if (!upload.transientPBO)
+		{
+			isRingEmpty = false;
+			break;
+		}
+	}
+
+	if (isRingEmpty)
+	{
+		stagingHead = 0;
+		stagingTail = 0;
+	}
+
+	size_t start = (stagingHead + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+
+	if (isRingEmpty
+		|| stagingHead > stagingTail)
+	{
+		//free space is after the head and before the tail
+		if (start + size <= stagingSize) outOffset = start;
+		else if (size < stagingTail) outOffset = 0;
+		else return false;
+	}
+	else
+	{
+		//wrapped, the only free space is between the head and the tail
+		if (start + size < stagingTail) outOffset = start;
+		else return false;
+	}
+
+	stagingHead = outOffset + size;
+
+	return true;
+}
+
+void ReleaseUpload(PendingUpload& upload)
+{
+	if (upload.fence)
+	{
+		OpenGL_Functions_Extra::GetGLExtra()->glDeleteSync(upload.fence);
+		upload.fence = nullptr;
+	}
+
+	if (upload.transientPBO)
+	{
+		OpenGL_Functions_Core::GetGLCore()->glDeleteBuffers(1, &upload.transientPBO);
+		upload.transientPBO = 0;
+	}
+}
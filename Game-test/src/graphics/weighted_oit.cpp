@@ -0,0 +1,314 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/log_utils.hpp"
+
+#include "opengl/kw_opengl.hpp"
+#include "opengl/kw_opengl_functions_core.hpp"
+
+#include "graphics/weighted_oit.hpp"
+#include "graphics/gl_extra_functions.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec2;
+
+using KalaWindow::OpenGL::OpenGL_Shader;
+using KalaWindow::OpenGL::OpenGLFunctions::GL_Core;
+using KalaWindow::OpenGL::OpenGLFunctions::OpenGL_Functions_Core;
+
+using GameTest::Graphics::WeightedOIT;
+using GameTest::Graphics::GL_Extra;
+using GameTest::Graphics::OpenGL_Functions_Extra;
+
+using std::string;
+using std::to_string;
+
+static bool isInitialized{};
+static bool isActive{};
+
+static OpenGL_Shader* compositeShader{};
+
+static u32 width{};
+static u32 height{};
+
+static u32 FBO{};
+//rgb is the weighted premultiplied color sum, a is the product of (1 - alpha), the revealage
+static u32 accumTex{};
+//r is the weighted alpha sum that normalizes the color sum
+static u32 weightTex{};
+//copy of the opaque depth so transparent surfaces behind opaque ones are rejected
+static u32 depthRBO{};
+
+//fullscreen triangle is generated from gl_VertexID, gl still wants a vertex array bound
+static u32 emptyVAO{};
+
+static string CreateTargets();
+static void DeleteTargets();
+
+namespace GameTest::Graphics
+{
+	string WeightedOIT::Initialize(
+		OpenGL_Shader* newCompositeShader,
+		const vec2& size)
+	{
+		if (isInitialized) return {};
+
+		if (!newCompositeShader
+			|| !newCompositeShader->IsInitialized())
+		{
+			return "Failed to initialize weighted OIT because the composite shader is invalid!";
+		}
+
+		compositeShader = newCompositeShader;
+		width = scast<u32>(size.x);
+		height = scast<u32>(size.y);
+
+		string result = CreateTargets();
+		if (!result.empty())
+		{
+			DeleteTargets();
+			return result;
+		}
+
+		OpenGL_Functions_Core::GetGLCore()->glGenVertexArrays(1, &emptyVAO);
+
+		isInitialized = true;
+
+		Log::Print(
+			"Initialized weighted OIT at " + to_string(width) + "x" + to_string(height) + ".",
+			"WEIGHTED_OIT",
+			LogType::LOG_SUCCESS);
+
+		return {};
+	}
+	bool WeightedOIT::IsInitialized() { return isInitialized; }
+
+	void WeightedOIT::Resize(const vec2& size)
+	{
+		if (!isInitialized) return;
+
+		u32 newWidth = scast<u32>(size.x);
+		u32 newHeight = scast<u32>(size.y);
+
+		//minimized windows report an empty client rect
+		if (newWidth == 0
+			|| newHeight == 0
+			|| (newWidth == width
+			&& newHeight == height))
+		{
+			return;
+		}
+
+		width = newWidth;
+		height = newHeight;
+
+		DeleteTargets();
+
+		string result = CreateTargets();
+		if (!result.empty())
+		{
+			//transparent models fall back to blending in draw order
+			Log::Print(
+				result,
+				"WEIGHTED_OIT",
+				LogType::LOG_ERROR,
+				2);
+
+			Shutdown();
+		}
+	}
+
+	void WeightedOIT::Begin()
+	{
+		if (!isInitialized) return;
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+		const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+		coreFunc->glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+		coreFunc->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+		extraFunc->glBlitFramebuffer(
+			0, 0, width, height,
+			0, 0, width, height,
+			GL_DEPTH_BUFFER_BIT,
+			GL_NEAREST);
+
+		coreFunc->glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+		const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+		extraFunc->glDrawBuffers(2, drawBuffers);
+
+		//nothing accumulated and everything behind fully revealed
+		const f32 accumClear[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		const f32 weightClear[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		extraFunc->glClearBufferfv(GL_COLOR, 0, accumClear);
+		extraFunc->glClearBufferfv(GL_COLOR, 1, weightClear);
+
+		//color and weight are summed, revealage is multiplied by (1 - alpha),
+		//one blend function for both targets keeps this on gl 3.3 without glBlendFunci
+		coreFunc->glEnable(GL_BLEND);
+		extraFunc->glBlendFuncSeparate(
+			GL_ONE,
+			GL_ONE,
+			GL_ZERO,
+			GL_ONE_MINUS_SRC_ALPHA);
+
+		//depth is tested against the opaque scene but transparent surfaces never occlude each other
+		coreFunc->glDepthMask(GL_FALSE);
+
+		isActive = true;
+	}
+	bool WeightedOIT::IsActive() { return isActive; }
+
+	void WeightedOIT::Composite()
+	{
+		if (!isActive) return;
+
+		isActive = false;
+
+		const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+		coreFunc->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		coreFunc->glDisable(GL_DEPTH_TEST);
+		coreFunc->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		if (compositeShader->Bind())
+		{
+			coreFunc->glActiveTexture(GL_TEXTURE0);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, accumTex);
+			compositeShader->SetInt("uAccumTex", 0);
+
+			coreFunc->glActiveTexture(GL_TEXTURE1);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, weightTex);
+			compositeShader->SetInt("uWeightTex", 1);
+
+			coreFunc->glBindVertexArray(emptyVAO);
+			coreFunc->glDrawArrays(GL_TRIANGLES, 0, 3);
+			coreFunc->glBindVertexArray(0);
+		}
+		else
+		{
+			Log::Print(
+				"Failed to composite transparency because the composite shader failed to bind!",
+				"WEIGHTED_OIT",
+				LogType::LOG_ERROR,
+				2);
+		}
+
+		coreFunc->glDisable(GL_BLEND);
+		coreFunc->glDepthMask(GL_TRUE);
+		coreFunc->glEnable(GL_DEPTH_TEST);
+	}
+
+	void WeightedOIT::Shutdown()
+	{
+		if (!isInitialized) return;
+
+		DeleteTargets();
+
+		if (emptyVAO != 0)
+		{
+			OpenGL_Functions_Core::GetGLCore()->glDeleteVertexArrays(1, &emptyVAO);
+			emptyVAO = 0;
+		}
+
+		compositeShader = nullptr;
+		isActive = false;
+		isInitialized = false;
+	}
+}
+
+string CreateTargets()
+{
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+
+	auto CreateTarget = [coreFunc](
+		u32& outTexture,
+		GLint internalFormat,
+		GLenum format)
+		{
+			coreFunc->glGenTextures(1, &outTexture);
+			coreFunc->glBindTexture(GL_TEXTURE_2D, outTexture);
+			coreFunc->glTexImage2D(
+				GL_TEXTURE_2D,
+				0,
+				internalFormat,
+				width,
+				height,
+				0,
+				format,
+				GL_HALF_FLOAT,
+				nullptr);
+
+			coreFunc->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			coreFunc->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			coreFunc->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			coreFunc->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		};
+
+	CreateTarget(accumTex, GL_RGBA16F, GL_RGBA);
+	CreateTarget(weightTex, GL_R16F, GL_RED);
+	coreFunc->glBindTexture(GL_TEXTURE_2D, 0);
+
+	//matches the 24 bit depth of the default framebuffer, blits between different formats fail
+	coreFunc->glGenRenderbuffers(1, &depthRBO);
+	coreFunc->glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+	coreFunc->glRenderbufferStorage(
+		GL_RENDERBUFFER,
+		GL_DEPTH_COMPONENT24,
+		width,
+		height);
+	coreFunc->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	coreFunc->glGenFramebuffers(1, &FBO);
+	coreFunc->glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+	coreFunc->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, accumTex, 0);
+	coreFunc->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, weightTex, 0);
+	coreFunc->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+	GLenum status = coreFunc->glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+	coreFunc->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		return "Weighted OIT framebuffer is incomplete, status '" + to_string(status) + "'!";
+	}
+
+	return {};
+}
+
+void DeleteTargets()
+{
+	const GL_Core* coreFunc = OpenGL_Functions_Core::GetGLCore();
+	const GL_Extra* extraFunc = OpenGL_Functions_Extra::GetGLExtra();
+
+	if (FBO != 0)
+	{
+		extraFunc->glDeleteFramebuffers(1, &FBO);
+		FBO = 0;
+	}
+	if (accumTex != 0)
+	{
+		coreFunc->glDeleteTextures(1, &accumTex);
+		accumTex = 0;
+	}
+	if (weightTex != 0)
+	{
+		coreFunc->glDeleteTextures(1, &weightTex);
+		weightTex = 0;
+	}
+	if (depthRBO != 0)
+	{
+		extraFunc->glDeleteRenderbuffers(1, &depthRBO);
+		depthRBO = 0;
+	}
+}
@@ -0,0 +1,647 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <any>
+#include <filesystem>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "graphics/world_partition.hpp"
+#include "core/resource_manager.hpp"
+#include "core/asset_pack.hpp"
+#include "gameobject/opengl_model.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::quat;
+using KalaHeaders::KalaMath::Transform3D;
+using KalaHeaders::KalaModelData::ModelHeader;
+using KalaHeaders::KalaModelData::ModelTable;
+using KalaHeaders::KalaModelData::ModelBlock;
+using KalaHeaders::KalaModelData::ImportResult;
+using KalaHeaders::KalaModelData::ResultToString;
+using KalaHeaders::KalaModelData::GetTableData;
+using KalaHeaders::KalaModelData::ParseHeaderData;
+using KalaHeaders::KalaModelData::ParseTableData;
+using KalaHeaders::KalaModelData::CORRECT_MODEL_HEADER_SIZE;
+using KalaHeaders::KalaModelData::VERTICE_DATA_OFFSET;
+
+using KalaWindow::OpenGL::OpenGL_Context;
+using KalaWindow::OpenGL::OpenGL_Shader;
+
+using GameTest::Graphics::WorldPartition;
+using GameTest::Graphics::WorldPartitionSettings;
+using GameTest::Graphics::WorldCellState;
+using GameTest::Core::ResourceManager;
+using GameTest::Core::ResourceRef;
+using GameTest::Core::ResourceHandle;
+using GameTest::Core::ResourceDesc;
+using GameTest::Core::ResourceState;
+using GameTest::Core::AssetPack;
+using GameTest::GameObject::OpenGL_Model;
+using GameTest::GameObject::MeshFile;
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::unordered_map;
+using std::sort;
+using std::remove_if;
+using std::min;
+using std::max;
+using std::move;
+using std::floor;
+using std::memcpy;
+using std::ifstream;
+using std::ios;
+using std::any;
+using std::any_cast;
+using std::filesystem::path;
+
+//byte offset of the block position inside a kmd model block
+constexpr u32 BLOCK_POSITION_OFFSET = 92u;
+
+//cpu side blocks of one cell, owned by the cell resource until every model is created
+struct CellBlocks
+{
+	vector<ModelBlock> blocks{};
+};
+
+struct WorldCell
+{
+	i32 x{};
+	i32 z{};
+
+	//indices into the world tables
+	vector<u32> tableIndices{};
+
+	WorldCellState state{};
+
+	ResourceHandle<CellBlocks> blocks{};
+	//next block to create a model from while uploading
+	size_t nextBlock{};
+
+	vector<OpenGL_Model*> models{};
+};
+
+//active cell and its distance to the camera this frame
+struct CellDistance
+{
+	u32 index{};
+	f32 distanceSq{};
+};
+
+static bool isOpen{};
+
+static path worldPath{};
+static string virtualPath{};
+static OpenGL_Context* context{};
+static OpenGL_Shader* shader{};
+static WorldPartitionSettings settings{};
+
+static vector<ModelTable> tables{};
+
+static vector<WorldCell> cells{};
+static unordered_map<u64, u32> cellLookup{};
+
+//every cell that isn't unloaded, the only cells Update walks over
+static vector<u32> activeCells{};
+
+static u32 loadingCount{};
+static u32 modelCount{};
+
+static string ReadBlockPositions(
+	const path& filePath,
+	vector<ModelTable>& outTables,
+	vector<vec3>& outPositions);
+
+static u64 GetCellKey(
+	i32 x,
+	i32 z);
+
+static f32 GetCellDistanceSq(
+	const WorldCell& cell,
+	const vec3& pos);
+
+static void StartLoad(u32 cellIndex);
+//Drops the cell data, created models are left for the destroy budget
+static void BeginUnload(WorldCell& cell);
+
+static void UploadModels(const vector<CellDistance>& nearestFirst);
+static void DestroyModels();
+
+namespace GameTest::Graphics
+{
+	string WorldPartition::Open(
+		const path& newWorldPath,
+		OpenGL_Context* newContext,
+		OpenGL_Shader* newShader,
+		const WorldPartitionSettings& newSettings)
+	{
+		if (isOpen) return "World partition is already open!";
+
+		if (!newShader
+			|| !newShader->IsInitialized())
+		{
+			return "Cannot open world '" + newWorldPath.string() + "' because the shader is invalid!";
+		}
+
+		if (newSettings.cellSize <= 0.0f
+			|| newSettings.loadRadius <= 0.0f
+			|| newSettings.unloadRadius < newSettings.loadRadius
+			|| newSettings.uploadBudget == 0
+			|| newSettings.destroyBudget == 0
+			|| newSettings.maxLoadingCells == 0)
+		{
+			return "Cannot open world '" + newWorldPath.string() + "' because the settings are invalid!";
+		}
+
+		vector<ModelTable> newTables{};
+		vector<vec3> positions{};
+
+		string result = ReadBlockPositions(
+			newWorldPath,
+			newTables,
+			positions);
+		if (!result.empty()) return result;
+
+		tables = move(newTables);
+		settings = newSettings;
+
+		for (u32 i = 0; i < scast<u32>(tables.size()); ++i)
+		{
+			i32 x = scast<i32>(floor(positions[i].x / settings.cellSize));
+			i32 z = scast<i32>(floor(positions[i].z / settings.cellSize));
+
+			auto [it, isNew] = cellLookup.try_emplace(
+				GetCellKey(x, z),
+				scast<u32>(cells.size()));
+
+			if (isNew)
+			{
+				WorldCell& cell = cells.emplace_back();
+				cell.x = x;
+				cell.z = z;
+			}
+
+			cells[it->second].tableIndices.push_back(i);
+		}
+
+		worldPath = newWorldPath;
+		virtualPath = AssetPack::ToVirtualPath(newWorldPath);
+		context = newContext;
+		shader = newShader;
+
+		isOpen = true;
+
+		Log::Print(
+			"Opened world '" + virtualPath + "' with '" + to_string(tables.size()) + "' models in '" + to_string(cells.size()) + "' cells.",
+			"WORLD_PARTITION",
+			LogType::LOG_DEBUG);
+
+		return{};
+	}
+
+	bool WorldPartition::IsOpen() { return isOpen; }
+
+	void WorldPartition::Update(const vec3& cameraPos)
+	{
+		if (!isOpen) return;
+
+		f32 loadRadiusSq = settings.loadRadius * settings.loadRadius;
+		f32 unloadRadiusSq = settings.unloadRadius * settings.unloadRadius;
+
+		//advance or drop every active cell, unloads happen first so their slots can load this frame
+		vector<CellDistance> nearestFirst{};
+		nearestFirst.reserve(activeCells.size());
+
+		for (u32 index : activeCells)
+		{
+			WorldCell& cell = cells[index];
+			f32 distanceSq = GetCellDistanceSq(cell, cameraPos);
+
+			if (distanceSq > unloadRadiusSq
+				&& cell.state != WorldCellState::CELL_UNLOADING)
+			{
+				BeginUnload(cell);
+				continue;
+			}
+
+			if (cell.state == WorldCellState::CELL_LOADING)
+			{
+				ResourceState state = cell.blocks.GetState();
+				if (state == ResourceState::STATE_READY)
+				{
+					cell.state = WorldCellState::CELL_UPLOADING;
+					cell.nextBlock = 0;
+					--loadingCount;
+				}
+				else if (state == ResourceState::STATE_FAILED)
+				{
+					//stays resident without models so it isn't read again until it leaves and comes back
+					Log::Print(
+						"Failed to stream world cell '" + to_string(cell.x) + ", " + to_string(cell.z) + "'! Reason: " + cell.blocks.GetError(),
+						"WORLD_PARTITION",
+						LogType::LOG_ERROR,
+						2);
+
+					cell.blocks.Reset();
+					cell.state = WorldCellState::CELL_RESIDENT;
+					--loadingCount;
+				}
+			}
+
+			nearestFirst.push_back({ index, distanceSq });
+		}
+
+		//only the cells around the camera are looked up, never the whole grid
+		i32 minX = scast<i32>(floor((cameraPos.x - settings.loadRadius) / settings.cellSize));
+		i32 maxX = scast<i32>(floor((cameraPos.x + settings.loadRadius) / settings.cellSize));
+		i32 minZ = scast<i32>(floor((cameraPos.z - settings.loadRadius) / settings.cellSize));
+		i32 maxZ = scast<i32>(floor((cameraPos.z + settings.loadRadius) / settings.cellSize));
+
+		vector<CellDistance> toLoad{};
+
+		for (i32 z = minZ; z <= maxZ; ++z)
+		{
+			for (i32 x = minX; x <= maxX; ++x)
+			{
+				auto it = cellLookup.find(GetCellKey(x, z));
+				if (it == cellLookup.end()) continue;
+
+				const WorldCell& cell = cells[it->second];
+				if (cell.state != WorldCellState::CELL_UNLOADED) continue;
+
+				f32 distanceSq = GetCellDistanceSq(cell, cameraPos);
+				if (distanceSq <= loadRadiusSq) toLoad.push_back({ it->second, distanceSq });
+			}
+		}
+
+		sort(toLoad.begin(), toLoad.end(),
+			[](const CellDistance& a, const CellDistance& b) { return a.distanceSq < b.distanceSq; });
+
+		for (const CellDistance& candidate : toLoad)
+		{
+			if (loadingCount >= settings.maxLoadingCells) break;
+
+			StartLoad(candidate.index);
+		}
+
+		sort(nearestFirst.begin(), nearestFirst.end(),
+			[](const CellDistance& a, const CellDistance& b) { return a.distanceSq < b.distanceSq; });
+
+		UploadModels(nearestFirst);
+		DestroyModels();
+
+		activeCells.erase(
+			remove_if(activeCells.begin(), activeCells.end(),
+				[](u32 index) { return cells[index].state == WorldCellState::CELL_UNLOADED; }),
+			activeCells.end());
+	}
+
+	const WorldPartitionSettings& WorldPartition::GetSettings() { return settings; }
+
+	u32 WorldPartition::GetCellCount() { return scast<u32>(cells.size()); }
+
+	u32 WorldPartition::GetCellCount(WorldCellState state)
+	{
+		if (state == WorldCellState::CELL_UNLOADED)
+		{
+			return scast<u32>(cells.size() - activeCells.size());
+		}
+
+		u32 count{};
+		for (u32 index : activeCells)
+		{
+			if (cells[index].state == state) ++count;
+		}
+
+		return count;
+	}
+
+	u32 WorldPartition::GetModelCount() { return modelCount; }
+
+	void WorldPartition::Close()
+	{
+		if (!isOpen) return;
+
+		auto& commands = OpenGL_Model::GetRegistry().GetCommandBuffer();
+
+		for (u32 index : activeCells)
+		{
+			WorldCell& cell = cells[index];
+
+			for (OpenGL_Model* model : cell.models) commands.Destroy(model);
+
+			cell.models.clear();
+			cell.blocks.Reset();
+		}
+
+		activeCells.clear();
+		cells.clear();
+		cellLookup.clear();
+		tables.clear();
+
+		loadingCount = 0;
+		modelCount = 0;
+
+		context = nullptr;
+		shader = nullptr;
+
+		isOpen = false;
+	}
+}
+
+string ReadBlockPositions(
+	const path& filePath,
+	vector<ModelTable>& outTables,
+	vector<vec3>& outPositions)
+{
+	vector<ModelTable> newTables{};
+	vector<vec3> positions{};
+
+	auto ReadPosition = [](const u8* data)
+		{
+			f32 pos[3]{};
+			memcpy(pos, data, sizeof(pos));
+
+			return vec3(pos[0], pos[1], pos[2]);
+		};
+
+	//packed worlds are indexed straight from the mapped pack, loose worlds read 12 bytes per block
+	if (AssetPack::FindEntry(filePath))
+	{
+		u64 size{};
+		const u8* data = AssetPack::GetMappedData(filePath, size);
+		if (!data)
+		{
+			return "Failed to open world '" + filePath.string() + "'! Reason: streamed worlds must be stored uncompressed.";
+		}
+
+		if (size < CORRECT_MODEL_HEADER_SIZE) return "Failed to open world '" + filePath.string() + "'! Reason: file is too small.";
+
+		ModelHeader header{};
+
+		ImportResult result = ParseHeaderData(data, header);
+		if (result != ImportResult::RESULT_SUCCESS)
+		{
+			return "Failed to open world '" + filePath.string() + "'! Reason: " + ResultToString(result);
+		}
+
+		if (CORRECT_MODEL_HEADER_SIZE + u64{ header.modelTablesSize } > size)
+		{
+			return "Failed to open world '" + filePath.string() + "'! Reason: " + ResultToString(ImportResult::RESULT_UNEXPECTED_EOF);
+		}
+
+		ParseTableData(
+			data + CORRECT_MODEL_HEADER_SIZE,
+			header,
+			newTables);
+
+		positions.reserve(newTables.size());
+
+		for (const ModelTable& t : newTables)
+		{
+			if (t.blockSize < VERTICE_DATA_OFFSET
+				|| u64{ t.blockOffset } + t.blockSize > size)
+			{
+				return "Failed to open world '" + filePath.string() + "'! Reason: " + ResultToString(ImportResult::RESULT_UNEXPECTED_EOF);
+			}
+
+			positions.push_back(ReadPosition(data + t.blockOffset + BLOCK_POSITION_OFFSET));
+		}
+	}
+	else
+	{
+		ImportResult result = GetTableData(filePath, newTables);
+		if (result != ImportResult::RESULT_SUCCESS)
+		{
+			return "Failed to open world '" + filePath.string() + "'! Reason: " + ResultToString(result);
+		}
+
+		ifstream in(filePath, ios::in | ios::binary);
+		if (!in) return "Failed to open world '" + filePath.string() + "'! Reason: file could not be opened.";
+
+		positions.reserve(newTables.size());
+
+		for (const ModelTable& t : newTables)
+		{
+			u8 posData[12]{};
+
+			in.seekg(t.blockOffset + BLOCK_POSITION_OFFSET);
+			in.read(rcast<char*>(posData), sizeof(posData));
+
+			if (t.blockSize < VERTICE_DATA_OFFSET
+				|| !in)
+			{
+				return "Failed to open world '" + filePath.string() + "'! Reason: " + ResultToString(ImportResult::RESULT_UNEXPECTED_EOF);
+			}
+
+			positions.push_back(ReadPosition(posData));
+		}
+	}
+
+	outTables = move(newTables);
+	outPositions = move(positions);
+
+	return{};
+}
+
+u64 GetCellKey(
+	i32 x,
+	i32 z)
+{
+	return (scast<u64>(scast<u32>(x)) << 32) | scast<u32>(z);
+}
+
+f32 GetCellDistanceSq(
+	const WorldCell& cell,
+	const vec3& pos)
+{
+	//distance to the nearest point of the cell on the xz plane
+	f32 minX = scast<f32>(cell.x) * settings.cellSize;
+	f32 minZ = scast<f32>(cell.z) * settings.cellSize;
+
+	f32 dx = max(max(minX - pos.x, 0.0f), pos.x - (minX + settings.cellSize));
+	f32 dz = max(max(minZ - pos.z, 0.0f), pos.z - (minZ + settings.cellSize));
+
+	return dx * dx + dz * dz;
+}
+
+void StartLoad(u32 cellIndex)
+{
+	WorldCell& cell = cells[cellIndex];
+
+	vector<ModelTable> cellTables{};
+	cellTables.reserve(cell.tableIndices.size());
+	for (u32 i : cell.tableIndices) cellTables.push_back(tables[i]);
+
+	ResourceDesc desc{};
+	desc.key = "worldcell:" + virtualPath + ":" + to_string(cell.x) + ":" + to_string(cell.z);
+
+	desc.load = [filePath = worldPath.string(), cellTables = move(cellTables)](any& outData)
+		{
+			vector<ModelBlock> blocks{};
+
+			string result = OpenGL_Model::StreamFile(
+				filePath,
+				cellTables,
+				blocks);
+			if (!result.empty()) return result;
+
+			outData = move(blocks);
+
+			return string{};
+		};
+
+	desc.finalize = [](
+		any& data,
+		const vector<ResourceRef>&,
+		void*& outObject)
+		{
+			//gl work is spread over frames by the upload budget, not done here
+			CellBlocks* cellBlocks = new CellBlocks();
+			cellBlocks->blocks = move(any_cast<vector<ModelBlock>&>(data));
+
+			outObject = cellBlocks;
+
+			return string{};
+		};
+
+	desc.destroy = [](void* object)
+		{
+			delete scast<CellBlocks*>(object);
+		};
+
+	cell.blocks = ResourceManager::Load<CellBlocks>(move(desc));
+	cell.state = WorldCellState::CELL_LOADING;
+
+	activeCells.push_back(cellIndex);
+	++loadingCount;
+}
+
+void BeginUnload(WorldCell& cell)
+{
+	if (cell.state == WorldCellState::CELL_LOADING) --loadingCount;
+
+	//a load that is still running is dropped by the resource manager once it finishes
+	cell.blocks.Reset();
+	cell.nextBlock = 0;
+
+	cell.state = cell.models.empty()
+		? WorldCellState::CELL_UNLOADED
+		: WorldCellState::CELL_UNLOADING;
+}
+
+void UploadModels(const vector<CellDistance>& nearestFirst)
+{
+	u32 budget = settings.uploadBudget;
+
+	for (const CellDistance& entry : nearestFirst)
+	{
+		if (budget == 0) break;
+
+		WorldCell& cell = cells[entry.index];
+		if (cell.state != WorldCellState::CELL_UPLOADING) continue;
+
+		vector<ModelBlock>& blocks = cell.blocks->blocks;
+
+		size_t count = min(scast<size_t>(budget), blocks.size() - cell.nextBlock);
+
+		vector<ModelBlock> batch{};
+		batch.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			batch.push_back(move(blocks[cell.nextBlock + i]));
+		}
+
+		//block transforms are copied before the batch is moved into the models
+		vector<Transform3D> transforms{};
+		transforms.reserve(count);
+		for (const ModelBlock& b : batch)
+		{
+			Transform3D& t = transforms.emplace_back();
+			t.pos_world = vec3(b.position[0], b.position[1], b.position[2]);
+			t.rot_world = quat(b.rotation);
+			t.size_world = vec3(b.size[0], b.size[1], b.size[2]);
+
+			t.pos_combined = t.pos_world;
+			t.rot_combined = t.rot_world;
+			t.size_combined = t.size_world;
+		}
+
+		//streamed blocks are in table order, the meshes page their geometry back in from them
+		MeshFile file{};
+		file.path = worldPath.string();
+		file.tables.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			file.tables.push_back(tables[cell.tableIndices[cell.nextBlock + i]]);
+		}
+
+		vector<OpenGL_Model*> created = OpenGL_Model::InitializeBlocks(
+			move(batch),
+			context,
+			shader,
+			true,
+			file);
+
+		for (size_t i = 0; i < created.size(); ++i)
+		{
+			created[i]->SetTransform(transforms[i]);
+			cell.models.push_back(created[i]);
+		}
+
+		modelCount += scast<u32>(created.size());
+		cell.nextBlock += count;
+		budget -= scast<u32>(count);
+
+		//an invalid context or shader creates nothing, the cell gives up instead of retrying every frame
+		if (cell.nextBlock == blocks.size()
+			|| created.size() != count)
+		{
+			cell.blocks.Reset();
+			cell.nextBlock = 0;
+			cell.state = WorldCellState::CELL_RESIDENT;
+		}
+	}
+}
+
+void DestroyModels()
+{
+	u32 budget = settings.destroyBudget;
+
+	auto& commands = OpenGL_Model::GetRegistry().GetCommandBuffer();
+
+	for (u32 index : activeCells)
+	{
+		if (budget == 0) break;
+
+		WorldCell& cell = cells[index];
+		if (cell.state != WorldCellState::CELL_UNLOADING) continue;
+
+		while (budget > 0
+			&& !cell.models.empty())
+		{
+			commands.Destroy(cell.models.back());
+			cell.models.pop_back();
+
+			--modelCount;
+			--budget;
+		}
+
+		if (cell.models.empty()) cell.state = WorldCellState::CELL_UNLOADED;
+	}
+}
@@ -0,0 +1,140 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//manifest layout, one record per line:
+//  version <cooker version>
+//  recipe <recipe string>
+//  dep <content hash> <path>
+//  out <content hash> <path>
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+
+#include "KalaHeaders/file_utils.hpp"
+
+#include "cooker.hpp"
+
+using KalaHeaders::KalaFile::ReadTextFromFile;
+using KalaHeaders::KalaFile::WriteTextToFile;
+
+using GameTest::Tools::CookManifest;
+using GameTest::Tools::COOKER_VERSION;
+
+using std::string;
+using std::vector;
+using std::ostringstream;
+using std::istringstream;
+using std::hex;
+using std::setw;
+using std::setfill;
+using std::getline;
+using std::filesystem::path;
+using std::filesystem::exists;
+
+static bool CheckRecords(
+	const vector<path>& files,
+	const vector<string>& lines,
+	const string& tag,
+	size_t& lineIndex);
+
+namespace GameTest::Tools
+{
+	bool CookManifest::IsUpToDate(
+		const path& manifestPath,
+		const string& recipe,
+		const vector<path>& dependencies,
+		const vector<path>& outputs)
+	{
+		if (!exists(manifestPath)) return false;
+
+		string text{};
+		if (!ReadTextFromFile(manifestPath, text).empty()) return false;
+
+		vector<string> lines{};
+		istringstream in(text);
+		for (string line{}; getline(in, line);)
+		{
+			if (!line.empty()) lines.push_back(line);
+		}
+
+		if (lines.size() != 2 + dependencies.size() + outputs.size()) return false;
+
+		if (lines[0] != "version " + std::to_string(COOKER_VERSION)) return false;
+		if (lines[1] != "recipe " + recipe) return false;
+
+		size_t lineIndex = 2;
+
+		return CheckRecords(dependencies, lines, "dep", lineIndex)
+			&& CheckRecords(outputs, lines, "out", lineIndex);
+	}
+
+	string CookManifest::Write(
+		const path& manifestPath,
+		const string& recipe,
+		const vector<path>& dependencies,
+		const vector<path>& outputs)
+	{
+		ostringstream oss{};
+		oss << "version " << COOKER_VERSION << "\n";
+		oss << "recipe " << recipe << "\n";
+
+		auto WriteRecords = [&oss, &manifestPath](
+			const vector<path>& files,
+			const string& tag) -> string
+			{
+				for (const auto& f : files)
+				{
+					u64 hash{};
+					if (!HashFile(f, hash))
+					{
+						return "Failed to hash '" + f.string() + "' for manifest '" + manifestPath.string() + "'!";
+					}
+
+					oss << tag << " " << hex << setw(16) << setfill('0') << hash << std::dec
+						<< " " << f.generic_string() << "\n";
+				}
+				return{};
+			};
+
+		string depResult = WriteRecords(dependencies, "dep");
+		if (!depResult.empty()) return depResult;
+
+		string outResult = WriteRecords(outputs, "out");
+		if (!outResult.empty()) return outResult;
+
+		return WriteTextToFile(manifestPath, oss.str(), false);
+	}
+
+	bool CookManifest::HashFile(
+		const path& file,
+		u64& outHash)
+	{
+		//mapped instead of read, so large sources aren't copied just to be hashed
+		return KalaHeaders::KalaFile::HashFile(file, outHash).empty();
+	}
+}
+
+bool CheckRecords(
+	const vector<path>& files,
+	const vector<string>& lines,
+	const string& tag,
+	size_t& lineIndex)
+{
+	for (const auto& f : files)
+	{
+		u64 hash{};
+		if (!CookManifest::HashFile(f, hash)) return false;
+
+		ostringstream expected{};
+		expected << tag << " " << hex << setw(16) << setfill('0') << hash
+			<< " " << f.generic_string();
+
+		if (lines[lineIndex++] != expected.str()) return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,575 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <unordered_map>
+
+#include "KalaHeaders/import_kmd.hpp"
+#include "KalaHeaders/file_utils.hpp"
+
+#include "graphics/cooked_formats.hpp"
+
+#include "cooker.hpp"
+
+using KalaHeaders::KalaModelData::ModelHeader;
+using KalaHeaders::KalaModelData::ModelTable;
+using KalaHeaders::KalaModelData::ModelBlock;
+using KalaHeaders::KalaModelData::Vertex;
+using KalaHeaders::KalaModelData::ImportResult;
+using KalaHeaders::KalaModelData::ImportKMD;
+using KalaHeaders::KalaModelData::ResultToString;
+using KalaHeaders::KalaFile::WriteBinaryLinesToFile;
+using KalaHeaders::KalaFile::WriteFixedString;
+using KalaHeaders::KalaFile::WriteU8;
+using KalaHeaders::KalaFile::WriteU16;
+using KalaHeaders::KalaFile::WriteU32;
+using KalaHeaders::KalaMath::vec2;
+using KalaHeaders::KalaMath::vec3;
+
+using GameTest::Tools::MeshCooker;
+using GameTest::Graphics::CookedVertex;
+using GameTest::Graphics::OctEncode;
+using GameTest::Graphics::ToSnorm16;
+using GameTest::Graphics::FloatToHalf;
+using GameTest::Graphics::KMS_MAGIC;
+using GameTest::Graphics::KMS_VERSION;
+using GameTest::Graphics::KMS_VERTEX_STRIDE;
+
+using std::vector;
+using std::unordered_map;
+using std::array;
+using std::string;
+using std::ostringstream;
+using std::fixed;
+using std::setprecision;
+using std::min;
+using std::max;
+using std::pow;
+using std::sqrt;
+using std::lround;
+using std::move;
+using std::find;
+using std::filesystem::path;
+
+struct Bounds
+{
+	vec3 min{};
+	vec3 max{};
+	vec3 center{};
+	f32 radius{};
+};
+
+static void WeldVertices(
+	vector<CookedVertex>& vertices,
+	vector<u32>& indices);
+static void OptimizeVertexCache(vector<u32>& indices, size_t vertexCount);
+static void OptimizeVertexFetch(
+	vector<CookedVertex>& vertices,
+	vector<u32>& indices);
+static f32 GetACMR(
+	const vector<u32>& indices,
+	size_t cacheSize);
+
+static Bounds GetBounds(const vector<Vertex>& vertices);
+static CookedVertex QuantizeVertex(
+	const Vertex& v,
+	const Bounds& b);
+
+static void AppendF32(vector<u8>& data, f32 value);
+
+namespace GameTest::Tools
+{
+	string MeshCooker::Cook(
+		const path& source,
+		const path& target,
+		string& outSummary)
+	{
+		ModelHeader header{};
+		vector<ModelTable> tables{};
+		vector<ModelBlock> blocks{};
+
+		ImportResult result = ImportKMD(
+			source,
+			header,
+			tables,
+			blocks);
+
+		if (result != ImportResult::RESULT_SUCCESS)
+		{
+			return "Failed to import '" + source.string() + "'! Reason: " + ResultToString(result);
+		}
+
+		vector<u8> out{};
+
+		WriteU32(out, scast<size_t>(-1), KMS_MAGIC);
+		WriteU8(out, scast<size_t>(-1), KMS_VERSION);
+		WriteU8(out, scast<size_t>(-1), 0);
+		WriteU16(out, scast<size_t>(-1), 0);
+		WriteU32(out, scast<size_t>(-1), scast<u32>(blocks.size()));
+
+		ostringstream summary{};
+		summary << fixed << setprecision(2);
+
+		for (auto& b : blocks)
+		{
+			if (!summary.str().empty()) summary << "\n";
+
+			vector<u32>& indices = b.indices;
+
+			if (indices.size() % 3 != 0)
+			{
+				return "Mesh '" + string(b.nodeName) + "' in '" + source.string() + "' is not a triangle list!";
+			}
+			for (u32 i : indices)
+			{
+				if (i >= b.vertices.size())
+				{
+					return "Mesh '" + string(b.nodeName) + "' in '" + source.string() + "' has out of range indices!";
+				}
+			}
+
+			size_t rawSize = b.vertices.size() * sizeof(Vertex) + indices.size() * sizeof(u32);
+			f32 acmrBefore = GetACMR(indices, 16);
+
+			Bounds bounds = GetBounds(b.vertices);
+
+			vector<CookedVertex> vertices{};
+			vertices.reserve(b.vertices.size());
+			for (const auto& v : b.vertices) vertices.push_back(QuantizeVertex(v, bounds));
+
+			//welding after quantization merges every vertex that would end up bit-identical anyway
+			WeldVertices(vertices, indices);
+			OptimizeVertexCache(indices, vertices.size());
+			OptimizeVertexFetch(vertices, indices);
+
+			f32 acmrAfter = GetACMR(indices, 16);
+
+			bool shortIndices = vertices.size() <= 0xFFFF;
+			u32 indexSize = shortIndices ? 2u : 4u;
+
+			u32 vertexDataSize = scast<u32>(vertices.size() * KMS_VERTEX_STRIDE);
+			u32 indexDataSize = scast<u32>(indices.size() * indexSize);
+			u32 indexPadding = (4u - (indexDataSize % 4u)) % 4u;
+
+			//block header
+
+			WriteFixedString(out, scast<size_t>(-1), b.nodeName, 20);
+			WriteU32(out, scast<size_t>(-1), scast<u32>(vertices.size()));
+			WriteU32(out, scast<size_t>(-1), scast<u32>(indices.size()));
+			WriteU8(out, scast<size_t>(-1), scast<u8>(indexSize));
+			WriteU8(out, scast<size_t>(-1), KMS_VERTEX_STRIDE);
+			WriteU16(out, scast<size_t>(-1), 0);
+
+			AppendF32(out, bounds.min.x);
+			AppendF32(out, bounds.min.y);
+			AppendF32(out, bounds.min.z);
+			AppendF32(out, bounds.max.x);
+			AppendF32(out, bounds.max.y);
+			AppendF32(out, bounds.max.z);
+			AppendF32(out, bounds.center.x);
+			AppendF32(out, bounds.center.y);
+			AppendF32(out, bounds.center.z);
+			AppendF32(out, bounds.radius);
+
+			for (f32 f : b.position) AppendF32(out, f);
+			for (f32 f : b.rotation) AppendF32(out, f);
+			for (f32 f : b.size) AppendF32(out, f);
+
+			WriteU32(out, scast<size_t>(-1), vertexDataSize);
+			WriteU32(out, scast<size_t>(-1), indexDataSize + indexPadding);
+
+			//vertex data
+
+			size_t vertexStart = out.size();
+			out.resize(vertexStart + vertexDataSize);
+
+			memcpy(out.data() + vertexStart, vertices.data(), vertexDataSize);
+
+			//index data
+
+			for (u32 i : indices)
+			{
+				if (shortIndices) WriteU16(out, scast<size_t>(-1), scast<u16>(i));
+				else WriteU32(out, scast<size_t>(-1), i);
+			}
+			for (u32 p = 0; p < indexPadding; ++p) WriteU8(out, scast<size_t>(-1), 0);
+
+			size_t cookedSize = vertexDataSize + indexDataSize;
+
+			summary << "'" << b.nodeName << "' "
+				<< b.vertices.size() << " -> " << vertices.size() << " verts, "
+				<< indices.size() / 3 << " tris, "
+				<< "acmr " << acmrBefore << " -> " << acmrAfter << ", "
+				<< rawSize << " -> " << cookedSize << " bytes";
+		}
+
+		string writeResult = WriteBinaryLinesToFile(target, out, false);
+		if (!writeResult.empty()) return writeResult;
+
+		outSummary = summary.str();
+
+		return{};
+	}
+}
+
+//
+// VERTEX CACHE OPTIMIZATION
+//
+
+//linear-speed vertex cache optimisation as described by Tom Forsyth,
+//greedily emits the triangle whose vertices score highest in a simulated lru cache
+
+constexpr u32 FORSYTH_CACHE_SIZE = 32;
+constexpr f32 FORSYTH_DECAY_POWER = 1.5f;
+constexpr f32 FORSYTH_LAST_TRI_SCORE = 0.75f;
+constexpr f32 FORSYTH_VALENCE_SCALE = 2.0f;
+constexpr f32 FORSYTH_VALENCE_POWER = 0.5f;
+
+static f32 ScoreVertex(
+	i32 cachePos,
+	u32 remainingValence)
+{
+	//no triangles left, never pick this vertex again
+	if (remainingValence == 0) return -1.0f;
+
+	f32 score = 0.0f;
+
+	if (cachePos >= 0)
+	{
+		//the three vertices of the last triangle get a fixed score
+		//so the optimizer doesnt just repeat the same strip direction
+		if (cachePos < 3) score = FORSYTH_LAST_TRI_SCORE;
+		else
+		{
+			f32 scaler = 1.0f / scast<f32>(FORSYTH_CACHE_SIZE - 3);
+			score = pow(1.0f - scast<f32>(cachePos - 3) * scaler, FORSYTH_DECAY_POWER);
+		}
+	}
+
+	//boost vertices with few triangles left so lone triangles get finished early
+	score += FORSYTH_VALENCE_SCALE * pow(scast<f32>(remainingValence), -FORSYTH_VALENCE_POWER);
+
+	return score;
+}
+
+void OptimizeVertexCache(vector<u32>& indices, size_t vertexCount)
+{
+	size_t triCount = indices.size() / 3;
+	if (triCount == 0) return;
+
+	//vertex to triangle adjacency in compressed rows
+
+	vector<u32> valence(vertexCount, 0);
+	for (u32 i : indices) ++valence[i];
+
+	vector<u32> adjOffset(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; ++v) adjOffset[v + 1] = adjOffset[v] + valence[v];
+
+	vector<u32> adjacency(indices.size());
+	vector<u32> adjFill(adjOffset.begin(), adjOffset.end() - 1);
+	for (size_t t = 0; t < triCount; ++t)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			u32 v = indices[t * 3 + k];
+			adjacency[adjFill[v]++] = scast<u32>(t);
+		}
+	}
+
+	vector<i32> cachePos(vertexCount, -1);
+	vector<f32> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v) vertexScore[v] = ScoreVertex(-1, valence[v]);
+
+	vector<f32> triScore(triCount);
+	vector<u8> emitted(triCount, 0);
+	for (size_t t = 0; t < triCount; ++t)
+	{
+		triScore[t] = vertexScore[indices[t * 3]]
+			+ vertexScore[indices[t * 3 + 1]]
+			+ vertexScore[indices[t * 3 + 2]];
+	}
+
+	vector<u32> output{};
+	output.reserve(indices.size());
+
+	array<u32, FORSYTH_CACHE_SIZE + 3> cache{};
+	size_t cacheCount = 0;
+
+	i64 bestTri = -1;
+	size_t scanCursor = 0;
+
+	for (size_t emittedCount = 0; emittedCount < triCount; ++emittedCount)
+	{
+		//nothing adjacent to the cache scored, fall back to a linear scan
+		if (bestTri < 0)
+		{
+			f32 bestScore = -1.0f;
+			for (size_t t = scanCursor; t < triCount; ++t)
+			{
+				if (emitted[t]) continue;
+
+				if (bestTri < 0) scanCursor = t;
+				if (triScore[t] > bestScore)
+				{
+					bestScore = triScore[t];
+					bestTri = scast<i64>(t);
+				}
+			}
+		}
+
+		size_t tri = scast<size_t>(bestTri);
+		emitted[tri] = 1;
+
+		u32 triVerts[3] =
+		{
+			indices[tri * 3],
+			indices[tri * 3 + 1],
+			indices[tri * 3 + 2]
+		};
+
+		for (u32 v : triVerts)
+		{
+			output.push_back(v);
+
+			//remove this triangle from the vertex adjacency
+			u32 begin = adjOffset[v];
+			u32 end = begin + valence[v];
+			for (u32 a = begin; a < end; ++a)
+			{
+				if (adjacency[a] == tri)
+				{
+					adjacency[a] = adjacency[end - 1];
+					break;
+				}
+			}
+			--valence[v];
+		}
+
+		//move the triangle vertices to the front of the lru cache
+
+		array<u32, FORSYTH_CACHE_SIZE + 3> newCache{};
+		size_t newCount = 0;
+
+		for (u32 v : triVerts) newCache[newCount++] = v;
+		for (size_t c = 0; c < cacheCount; ++c)
+		{
+			u32 v = cache[c];
+			if (v != triVerts[0]
+				&& v != triVerts[1]
+				&& v != triVerts[2])
+			{
+				newCache[newCount++] = v;
+			}
+		}
+
+		//rescore everything that was or is in the cache and their triangles
+
+		for (size_t c = 0; c < newCount; ++c)
+		{
+			u32 v = newCache[c];
+			cachePos[v] = c < FORSYTH_CACHE_SIZE ? scast<i32>(c) : -1;
+			vertexScore[v] = ScoreVertex(cachePos[v], valence[v]);
+		}
+
+		bestTri = -1;
+		f32 bestScore = -1.0f;
+
+		for (size_t c = 0; c < newCount; ++c)
+		{
+			u32 v = newCache[c];
+			u32 begin = adjOffset[v];
+			u32 end = begin + valence[v];
+
+			for (u32 a = begin; a < end; ++a)
+			{
+				u32 t = adjacency[a];
+
+				f32 score = vertexScore[indices[t * 3]]
+					+ vertexScore[indices[t * 3 + 1]]
+					+ vertexScore[indices[t * 3 + 2]];
+				triScore[t] = score;
+
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTri = t;
+				}
+			}
+		}
+
+		cacheCount = min(newCount, scast<size_t>(FORSYTH_CACHE_SIZE));
+		for (size_t c = 0; c < cacheCount; ++c) cache[c] = newCache[c];
+	}
+
+	indices = move(output);
+}
+
+void WeldVertices(
+	vector<CookedVertex>& vertices,
+	vector<u32>& indices)
+{
+	unordered_map<string, u32> unique{};
+	unique.reserve(vertices.size());
+
+	vector<CookedVertex> welded{};
+	welded.reserve(vertices.size());
+
+	vector<u32> remap(vertices.size());
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		string key(rcast<const char*>(&vertices[i]), sizeof(CookedVertex));
+
+		auto [it, inserted] = unique.try_emplace(move(key), scast<u32>(welded.size()));
+		if (inserted) welded.push_back(vertices[i]);
+
+		remap[i] = it->second;
+	}
+
+	for (u32& i : indices) i = remap[i];
+
+	vertices = move(welded);
+}
+
+void OptimizeVertexFetch(
+	vector<CookedVertex>& vertices,
+	vector<u32>& indices)
+{
+	//reorder vertices by first use so the index stream walks memory forwards,
+	//unreferenced vertices are dropped
+
+	constexpr u32 UNUSED = 0xFFFFFFFFu;
+
+	vector<u32> remap(vertices.size(), UNUSED);
+	vector<CookedVertex> reordered{};
+	reordered.reserve(vertices.size());
+
+	for (u32& i : indices)
+	{
+		if (remap[i] == UNUSED)
+		{
+			remap[i] = scast<u32>(reordered.size());
+			reordered.push_back(vertices[i]);
+		}
+		i = remap[i];
+	}
+
+	vertices = move(reordered);
+}
+
+f32 GetACMR(
+	const vector<u32>& indices,
+	size_t cacheSize)
+{
+	if (indices.size() < 3) return 0.0f;
+
+	//fifo cache like most post-transform caches
+	vector<u32> cache{};
+	size_t misses = 0;
+
+	for (u32 i : indices)
+	{
+		if (find(cache.begin(), cache.end(), i) != cache.end()) continue;
+
+		++misses;
+		cache.push_back(i);
+		if (cache.size() > cacheSize) cache.erase(cache.begin());
+	}
+
+	return scast<f32>(misses) / scast<f32>(indices.size() / 3);
+}
+
+//
+// QUANTIZATION
+//
+
+Bounds GetBounds(const vector<Vertex>& vertices)
+{
+	Bounds b{};
+	if (vertices.empty()) return b;
+
+	b.min = vec3(vertices[0].position[0], vertices[0].position[1], vertices[0].position[2]);
+	b.max = b.min;
+
+	for (const auto& v : vertices)
+	{
+		b.min.x = min(b.min.x, v.position[0]);
+		b.min.y = min(b.min.y, v.position[1]);
+		b.min.z = min(b.min.z, v.position[2]);
+		b.max.x = max(b.max.x, v.position[0]);
+		b.max.y = max(b.max.y, v.position[1]);
+		b.max.z = max(b.max.z, v.position[2]);
+	}
+
+	b.center = vec3(
+		(b.min.x + b.max.x) * 0.5f,
+		(b.min.y + b.max.y) * 0.5f,
+		(b.min.z + b.max.z) * 0.5f);
+
+	f32 radiusSq = 0.0f;
+	for (const auto& v : vertices)
+	{
+		f32 dx = v.position[0] - b.center.x;
+		f32 dy = v.position[1] - b.center.y;
+		f32 dz = v.position[2] - b.center.z;
+		radiusSq = max(radiusSq, dx * dx + dy * dy + dz * dz);
+	}
+	b.radius = sqrt(radiusSq);
+
+	return b;
+}
+
+static u16 QuantizeUnorm16(
+	f32 value,
+	f32 minValue,
+	f32 maxValue)
+{
+	f32 range = maxValue - minValue;
+	if (range <= 0.0f) return 0;
+
+	f32 t = (value - minValue) / range;
+	t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+
+	return scast<u16>(lround(t * 65535.0f));
+}
+
+CookedVertex QuantizeVertex(
+	const Vertex& v,
+	const Bounds& b)
+{
+	CookedVertex cv{};
+
+	cv.position[0] = QuantizeUnorm16(v.position[0], b.min.x, b.max.x);
+	cv.position[1] = QuantizeUnorm16(v.position[1], b.min.y, b.max.y);
+	cv.position[2] = QuantizeUnorm16(v.position[2], b.min.z, b.max.z);
+
+	cv.tangentSign = v.tangent[3] < 0.0f ? -32767 : 32767;
+
+	vec2 n = OctEncode(vec3(v.normal[0], v.normal[1], v.normal[2]));
+	cv.normal[0] = ToSnorm16(n.x);
+	cv.normal[1] = ToSnorm16(n.y);
+
+	cv.texCoord[0] = FloatToHalf(v.texCoord[0]);
+	cv.texCoord[1] = FloatToHalf(v.texCoord[1]);
+
+	vec2 t = OctEncode(vec3(v.tangent[0], v.tangent[1], v.tangent[2]));
+	cv.tangent[0] = ToSnorm16(t.x);
+	cv.tangent[1] = ToSnorm16(t.y);
+
+	return cv;
+}
+
+void AppendF32(vector<u8>& data, f32 value)
+{
+	u32 bits{};
+	memcpy(&bits, &value, sizeof(u32));
+	WriteU32(data, scast<size_t>(-1), bits);
+}
@@ -0,0 +1,418 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <vector>
+#include <array>
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb/stb_image.h"
+
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include "stb/stb_image_resize2.h"
+
+#include "KalaHeaders/file_utils.hpp"
+
+#include "graphics/cooked_formats.hpp"
+
+#include "cooker.hpp"
+
+using KalaHeaders::KalaFile::WriteBinaryLinesToFile;
+using KalaHeaders::KalaFile::WriteU8;
+using KalaHeaders::KalaFile::WriteU32;
+
+using GameTest::Tools::TextureCooker;
+using GameTest::Graphics::CookedTextureFormat;
+using GameTest::Graphics::KTX_MAGIC;
+using GameTest::Graphics::KTX_VERSION;
+using GameTest::Graphics::KTX_FLAG_SRGB;
+using GameTest::Graphics::KTX_FLAG_FLIPPED;
+
+using std::vector;
+using std::array;
+using std::string;
+using std::ostringstream;
+using std::min;
+using std::max;
+using std::swap;
+using std::move;
+using std::filesystem::path;
+
+struct MipLevel
+{
+	u32 width{};
+	u32 height{};
+	vector<u8> pixels{}; //rgba8
+};
+
+static void EncodeBC1Block(
+	const u8 block[64],
+	u8* out);
+static void EncodeBC3AlphaBlock(
+	const u8 block[64],
+	u8* out);
+
+static vector<u8> EncodeMip(
+	const MipLevel& mip,
+	CookedTextureFormat format);
+
+namespace GameTest::Tools
+{
+	string TextureCooker::Cook(
+		const path& source,
+		const path& target,
+		bool isSRGB,
+		string& outSummary)
+	{
+		//
+		// DECODE
+		//
+
+		vector<u8> fileData{};
+		string readResult = KalaHeaders::KalaFile::ReadBinaryLinesFromFile(source, fileData);
+		if (!readResult.empty()) return readResult;
+
+		int width{};
+		int height{};
+		int channels{};
+
+		//flipped once here so the runtime never has to flip on load
+		stbi_set_flip_vertically_on_load_thread(1);
+
+		u8* pixels = stbi_load_from_memory(
+			fileData.data(),
+			scast<int>(fileData.size()),
+			&width,
+			&height,
+			&channels,
+			4);
+
+		if (!pixels)
+		{
+			return "Failed to decode texture '" + source.string() + "'! Reason: " + stbi_failure_reason();
+		}
+
+		MipLevel base{};
+		base.width = scast<u32>(width);
+		base.height = scast<u32>(height);
+		base.pixels.assign(pixels, pixels + scast<size_t>(width) * height * 4);
+
+		stbi_image_free(pixels);
+
+		//any non-opaque pixel needs the bc3 alpha block
+		bool hasAlpha = false;
+		for (size_t i = 3; i < base.pixels.size(); i += 4)
+		{
+			if (base.pixels[i] != 255)
+			{
+				hasAlpha = true;
+				break;
+			}
+		}
+
+		CookedTextureFormat format = hasAlpha
+			? CookedTextureFormat::FORMAT_BC3
+			: CookedTextureFormat::FORMAT_BC1;
+
+		//
+		// MIP CHAIN
+		//
+
+		vector<MipLevel> mips{};
+		mips.push_back(move(base));
+
+		while (mips.back().width > 1
+			|| mips.back().height > 1)
+		{
+			const MipLevel& prev = mips.back();
+
+			MipLevel next{};
+			next.width = max(1u, prev.width / 2);
+			next.height = max(1u, prev.height / 2);
+			next.pixels.resize(scast<size_t>(next.width) * next.height * 4);
+
+			//srgb textures are filtered in linear space so mips dont darken
+			u8* resized = isSRGB
+				? stbir_resize_uint8_srgb(
+					prev.pixels.data(), scast<int>(prev.width), scast<int>(prev.height), 0,
+					next.pixels.data(), scast<int>(next.width), scast<int>(next.height), 0,
+					STBIR_RGBA)
+				: stbir_resize_uint8_linear(
+					prev.pixels.data(), scast<int>(prev.width), scast<int>(prev.height), 0,
+					next.pixels.data(), scast<int>(next.width), scast<int>(next.height), 0,
+					STBIR_RGBA);
+
+			if (!resized)
+			{
+				return "Failed to generate mip " + std::to_string(mips.size()) + " for texture '" + source.string() + "'!";
+			}
+
+			mips.push_back(move(next));
+		}
+
+		//
+		// ENCODE
+		//
+
+		vector<vector<u8>> encoded(mips.size());
+		for (size_t m = 0; m < mips.size(); ++m)
+		{
+			encoded[m] = EncodeMip(mips[m], format);
+		}
+
+		vector<u8> out{};
+
+		u8 flags = KTX_FLAG_FLIPPED;
+		if (isSRGB) flags |= KTX_FLAG_SRGB;
+
+		WriteU32(out, scast<size_t>(-1), KTX_MAGIC);
+		WriteU8(out, scast<size_t>(-1), KTX_VERSION);
+		WriteU8(out, scast<size_t>(-1), scast<u8>(format));
+		WriteU8(out, scast<size_t>(-1), flags);
+		WriteU8(out, scast<size_t>(-1), scast<u8>(mips.size()));
+		WriteU32(out, scast<size_t>(-1), mips[0].width);
+		WriteU32(out, scast<size_t>(-1), mips[0].height);
+
+		u32 offset = scast<u32>(16 + mips.size() * 8);
+		for (const auto& e : encoded)
+		{
+			WriteU32(out, scast<size_t>(-1), offset);
+			WriteU32(out, scast<size_t>(-1), scast<u32>(e.size()));
+			offset += scast<u32>(e.size());
+		}
+		for (const auto& e : encoded) out.insert(out.end(), e.begin(), e.end());
+
+		string writeResult = WriteBinaryLinesToFile(target, out, false);
+		if (!writeResult.empty()) return writeResult;
+
+		ostringstream summary{};
+		summary << width << "x" << height << " "
+			<< (hasAlpha ? "bc3" : "bc1") << (isSRGB ? " srgb" : " linear") << ", "
+			<< mips.size() << " mips, "
+			<< fileData.size() << " -> " << out.size() << " bytes";
+
+		outSummary = summary.str();
+
+		return{};
+	}
+}
+
+vector<u8> EncodeMip(
+	const MipLevel& mip,
+	CookedTextureFormat format)
+{
+	u32 blocksX = (mip.width + 3) / 4;
+	u32 blocksY = (mip.height + 3) / 4;
+	size_t blockSize = format == CookedTextureFormat::FORMAT_BC1 ? 8 : 16;
+
+	vector<u8> out(scast<size_t>(blocksX) * blocksY * blockSize);
+
+	u8 block[64]{};
+
+	for (u32 by = 0; by < blocksY; ++by)
+	{
+		for (u32 bx = 0; bx < blocksX; ++bx)
+		{
+			//edge blocks repeat the last row and column
+			for (u32 y = 0; y < 4; ++y)
+			{
+				u32 sy = min(by * 4 + y, mip.height - 1);
+				for (u32 x = 0; x < 4; ++x)
+				{
+					u32 sx = min(bx * 4 + x, mip.width - 1);
+					const u8* src = mip.pixels.data() + (scast<size_t>(sy) * mip.width + sx) * 4;
+					memcpy(block + (y * 4 + x) * 4, src, 4);
+				}
+			}
+
+			u8* dst = out.data() + (scast<size_t>(by) * blocksX + bx) * blockSize;
+
+			if (format == CookedTextureFormat::FORMAT_BC3)
+			{
+				EncodeBC3AlphaBlock(block, dst);
+				EncodeBC1Block(block, dst + 8);
+			}
+			else EncodeBC1Block(block, dst);
+		}
+	}
+
+	return out;
+}
+
+//
+// BLOCK COMPRESSION
+//
+
+//bounding box endpoints inset by 1/16 of the range with the diagonal picked from
+//the color covariance, as in J.M.P. van Waveren's real-time dxt compression
+
+static u16 ToRGB565(const u8 c[3])
+{
+	return scast<u16>(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+}
+
+static void FromRGB565(u16 v, u8 out[3])
+{
+	u8 r = scast<u8>((v >> 11) & 31);
+	u8 g = scast<u8>((v >> 5) & 63);
+	u8 b = scast<u8>(v & 31);
+
+	out[0] = scast<u8>((r << 3) | (r >> 2));
+	out[1] = scast<u8>((g << 2) | (g >> 4));
+	out[2] = scast<u8>((b << 3) | (b >> 2));
+}
+
+void EncodeBC1Block(
+	const u8 block[64],
+	u8* out)
+{
+	u8 minC[3] = { 255, 255, 255 };
+	u8 maxC[3] = { 0, 0, 0 };
+
+	for (u32 i = 0; i < 16; ++i)
+	{
+		for (u32 c = 0; c < 3; ++c)
+		{
+			minC[c] = min(minC[c], block[i * 4 + c]);
+			maxC[c] = max(maxC[c], block[i * 4 + c]);
+		}
+	}
+
+	//pick the box diagonal that follows the colors instead of always min to max
+
+	i32 mean[3]{};
+	for (u32 i = 0; i < 16; ++i)
+	{
+		for (u32 c = 0; c < 3; ++c) mean[c] += block[i * 4 + c];
+	}
+	for (u32 c = 0; c < 3; ++c) mean[c] = (mean[c] + 8) / 16;
+
+	i32 covRG = 0;
+	i32 covRB = 0;
+	for (u32 i = 0; i < 16; ++i)
+	{
+		i32 r = block[i * 4 + 0] - mean[0];
+		i32 g = block[i * 4 + 1] - mean[1];
+		i32 b = block[i * 4 + 2] - mean[2];
+		covRG += r * g;
+		covRB += r * b;
+	}
+	if (covRG < 0) swap(minC[1], maxC[1]);
+	if (covRB < 0) swap(minC[2], maxC[2]);
+
+	//inset to reduce the error from the endpoints sitting on outliers
+
+	for (u32 c = 0; c < 3; ++c)
+	{
+		i32 inset = (scast<i32>(maxC[c]) - scast<i32>(minC[c])) / 16;
+		maxC[c] = scast<u8>(std::clamp(scast<i32>(maxC[c]) - inset, 0, 255));
+		minC[c] = scast<u8>(std::clamp(scast<i32>(minC[c]) + inset, 0, 255));
+	}
+
+	u16 c0 = ToRGB565(maxC);
+	u16 c1 = ToRGB565(minC);
+
+	//c0 must be larger for the four color mode
+	if (c0 < c1) swap(c0, c1);
+
+	u32 indices = 0;
+
+	if (c0 != c1)
+	{
+		u8 palette[4][3]{};
+		FromRGB565(c0, palette[0]);
+		FromRGB565(c1, palette[1]);
+		for (u32 c = 0; c < 3; ++c)
+		{
+			palette[2][c] = scast<u8>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+			palette[3][c] = scast<u8>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+		}
+
+		for (u32 i = 0; i < 16; ++i)
+		{
+			u32 best = 0;
+			i32 bestDist = INT32_MAX;
+
+			for (u32 p = 0; p < 4; ++p)
+			{
+				i32 dr = scast<i32>(block[i * 4 + 0]) - palette[p][0];
+				i32 dg = scast<i32>(block[i * 4 + 1]) - palette[p][1];
+				i32 db = scast<i32>(block[i * 4 + 2]) - palette[p][2];
+				i32 dist = dr * dr + dg * dg + db * db;
+
+				if (dist < bestDist)
+				{
+					bestDist = dist;
+					best = p;
+				}
+			}
+
+			indices |= best << (i * 2);
+		}
+	}
+
+	out[0] = scast<u8>(c0 & 0xFF);
+	out[1] = scast<u8>(c0 >> 8);
+	out[2] = scast<u8>(c1 & 0xFF);
+	out[3] = scast<u8>(c1 >> 8);
+	out[4] = scast<u8>(indices & 0xFF);
+	out[5] = scast<u8>((indices >> 8) & 0xFF);
+	out[6] = scast<u8>((indices >> 16) & 0xFF);
+	out[7] = scast<u8>((indices >> 24) & 0xFF);
+}
+
+void EncodeBC3AlphaBlock(
+	const u8 block[64],
+	u8* out)
+{
+	u8 a0 = 0;
+	u8 a1 = 255;
+
+	for (u32 i = 0; i < 16; ++i)
+	{
+		a0 = max(a0, block[i * 4 + 3]);
+		a1 = min(a1, block[i * 4 + 3]);
+	}
+
+	u64 indices = 0;
+
+	//a0 > a1 selects the eight value mode
+	if (a0 != a1)
+	{
+		u8 palette[8]{};
+		palette[0] = a0;
+		palette[1] = a1;
+		for (u32 p = 1; p < 7; ++p)
+		{
+			palette[p + 1] = scast<u8>(((7 - p) * a0 + p * a1 + 3) / 7);
+		}
+
+		for (u32 i = 0; i < 16; ++i)
+		{
+			u32 best = 0;
+			i32 bestDist = INT32_MAX;
+
+			for (u32 p = 0; p < 8; ++p)
+			{
+				i32 d = scast<i32>(block[i * 4 + 3]) - palette[p];
+				if (d < 0) d = -d;
+
+				if (d < bestDist)
+				{
+					bestDist = d;
+					best = p;
+				}
+			}
+
+			indices |= scast<u64>(best) << (i * 3);
+		}
+	}
+
+	out[0] = a0;
+	out[1] = a1;
+	for (u32 b = 0; b < 6; ++b) out[2 + b] = scast<u8>((indices >> (b * 8)) & 0xFF);
+}
@@ -0,0 +1,69 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "KalaHeaders/math_utils.hpp"
+
+namespace GameTest::Tools
+{
+	using std::string;
+	using std::vector;
+	using std::filesystem::path;
+
+	//bump whenever any cooked output changes so every manifest goes stale
+	constexpr u32 COOKER_VERSION = 2;
+
+	class MeshCooker
+	{
+	public:
+		//Reads a kmd and writes a kms with cache-optimized, quantized meshes and bounds,
+		//returns an empty string on success and the reason on failure
+		static string Cook(
+			const path& source,
+			const path& target,
+			string& outSummary);
+	};
+
+	class TextureCooker
+	{
+	public:
+		//Reads a png or jpg and writes a ktx with a full mip chain in BC1 or BC3,
+		//returns an empty string on success and the reason on failure
+		static string Cook(
+			const path& source,
+			const path& target,
+			bool isSRGB,
+			string& outSummary);
+	};
+
+	//Records which inputs and settings produced an output so it can be skipped next time
+	class CookManifest
+	{
+	public:
+		//Returns true if the manifest exists, was written with the same recipe
+		//and every dependency and output still has the recorded content hash
+		static bool IsUpToDate(
+			const path& manifestPath,
+			const string& recipe,
+			const vector<path>& dependencies,
+			const vector<path>& outputs);
+
+		static string Write(
+			const path& manifestPath,
+			const string& recipe,
+			const vector<path>& dependencies,
+			const vector<path>& outputs);
+
+		//Returns false if the file could not be read
+		static bool HashFile(
+			const path& file,
+			u64& outHash);
+	};
+}
@@ -0,0 +1,319 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  asset-cooker <source dir> <output dir> [--jobs N] [--force]
+//
+//  --jobs N - worker thread count, defaults to one per hardware thread
+//  --force  - ignores manifests and recooks everything
+//
+//kmd models are cooked to kms, png and jpg textures are cooked to ktx,
+//everything else is copied as-is so the output dir can be fed straight to pack-builder.
+//manifests are kept next to the output dir in '<output dir>.manifests'
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "core/thread_pool.hpp"
+
+#include "cooker.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using GameTest::Core::ThreadPool;
+using GameTest::Tools::MeshCooker;
+using GameTest::Tools::TextureCooker;
+using GameTest::Tools::CookManifest;
+
+using std::string;
+using std::vector;
+using std::mutex;
+using std::lock_guard;
+using std::atomic;
+using std::transform;
+using std::tolower;
+using std::stoul;
+using std::to_string;
+using std::filesystem::path;
+using std::filesystem::exists;
+using std::filesystem::is_directory;
+using std::filesystem::is_regular_file;
+using std::filesystem::recursive_directory_iterator;
+using std::filesystem::create_directories;
+using std::filesystem::copy_file;
+using std::filesystem::copy_options;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+enum class CookKind
+{
+	COOK_MESH,
+	COOK_TEXTURE,
+	COOK_COPY
+};
+
+struct CookJob
+{
+	CookKind kind{};
+	path source{};
+	path target{};
+	path manifest{};
+	string recipe{};
+	bool isSRGB{};
+};
+
+static mutex logMutex{};
+
+static string ToLower(string value);
+static CookJob MakeJob(
+	const path& sourceDir,
+	const path& outputDir,
+	const path& manifestDir,
+	const path& file);
+static string RunJob(
+	const CookJob& job,
+	string& outSummary);
+static void PrintLocked(
+	const string& message,
+	LogType type);
+
+int main(int argc, char* argv[])
+{
+	vector<string> positional{};
+	u32 jobCount{};
+	bool force{};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+
+		if (arg == "--force") force = true;
+		else if (arg == "--jobs"
+			&& i + 1 < argc)
+		{
+			try { jobCount = scast<u32>(stoul(argv[++i])); }
+			catch (...) { jobCount = 0; }
+		}
+		else positional.push_back(arg);
+	}
+
+	if (positional.size() != 2)
+	{
+		Log::Print(
+			"usage: asset-cooker <source dir> <output dir> [--jobs N] [--force]",
+			"ASSET_COOKER",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	path sourceDir = positional[0];
+	path outputDir = positional[1];
+
+	if (!exists(sourceDir)
+		|| !is_directory(sourceDir))
+	{
+		Log::Print(
+			"Source dir '" + sourceDir.string() + "' does not exist!",
+			"ASSET_COOKER",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	//manifests live outside the output dir so they never end up in a pack
+	path manifestDir = outputDir;
+	manifestDir += ".manifests";
+
+	vector<CookJob> jobs{};
+	for (const auto& entry : recursive_directory_iterator(sourceDir))
+	{
+		if (!entry.is_regular_file()) continue;
+
+		jobs.push_back(MakeJob(
+			sourceDir,
+			outputDir,
+			manifestDir,
+			entry.path()));
+	}
+
+	atomic<u32> cooked{};
+	atomic<u32> skipped{};
+	atomic<u32> failed{};
+
+	auto start = steady_clock::now();
+
+	ThreadPool pool(jobCount);
+	pool.ParallelFor(
+		jobs.size(),
+		[&](size_t i)
+		{
+			const CookJob& job = jobs[i];
+
+			vector<path> deps{ job.source };
+			vector<path> outputs{ job.target };
+
+			if (!force
+				&& exists(job.target)
+				&& CookManifest::IsUpToDate(job.manifest, job.recipe, deps, outputs))
+			{
+				++skipped;
+				return;
+			}
+
+			string summary{};
+			string result = RunJob(job, summary);
+
+			if (result.empty())
+			{
+				result = CookManifest::Write(job.manifest, job.recipe, deps, outputs);
+			}
+
+			if (!result.empty())
+			{
+				++failed;
+				PrintLocked(result, LogType::LOG_ERROR);
+				return;
+			}
+
+			++cooked;
+			if (!summary.empty()) PrintLocked(summary, LogType::LOG_INFO);
+		});
+
+	f64 seconds = duration<f64>(steady_clock::now() - start).count();
+
+	Log::Print(
+		"Cooked " + to_string(cooked.load())
+		+ ", skipped " + to_string(skipped.load())
+		+ ", failed " + to_string(failed.load())
+		+ " of " + to_string(jobs.size()) + " files on "
+		+ to_string(pool.GetThreadCount()) + " threads in "
+		+ to_string(seconds) + " seconds.",
+		"ASSET_COOKER",
+		failed.load() == 0 ? LogType::LOG_SUCCESS : LogType::LOG_ERROR,
+		failed.load() == 0 ? 0 : 2);
+
+	return failed.load() == 0 ? 0 : 1;
+}
+
+string ToLower(string value)
+{
+	transform(
+		value.begin(),
+		value.end(),
+		value.begin(),
+		[](unsigned char c) { return scast<char>(tolower(c)); });
+
+	return value;
+}
+
+CookJob MakeJob(
+	const path& sourceDir,
+	const path& outputDir,
+	const path& manifestDir,
+	const path& file)
+{
+	CookJob job{};
+	job.source = file;
+
+	path relative = file.lexically_relative(sourceDir);
+	string extension = ToLower(file.extension().string());
+	string fileName = ToLower(file.filename().string());
+
+	job.target = outputDir / relative;
+
+	if (extension == ".kmd")
+	{
+		job.kind = CookKind::COOK_MESH;
+		job.target.replace_extension(".kms");
+		job.recipe = "mesh";
+	}
+	else if (extension == ".png"
+		|| extension == ".jpg"
+		|| extension == ".jpeg")
+	{
+		//normal maps and other data textures must not be treated as sRGB
+		job.isSRGB =
+			fileName.find("normal") == string::npos
+			&& fileName.find("_n.") == string::npos;
+
+		job.kind = CookKind::COOK_TEXTURE;
+		job.target.replace_extension(".ktx");
+		job.recipe = job.isSRGB ? "texture srgb" : "texture linear";
+	}
+	else
+	{
+		job.kind = CookKind::COOK_COPY;
+		job.recipe = "copy";
+	}
+
+	job.manifest = manifestDir / relative;
+	job.manifest += ".manifest";
+
+	return job;
+}
+
+string RunJob(
+	const CookJob& job,
+	string& outSummary)
+{
+	try
+	{
+		create_directories(job.target.parent_path());
+		create_directories(job.manifest.parent_path());
+	}
+	catch (const std::exception& e)
+	{
+		return "Failed to create output dirs for '" + job.source.string() + "'! Reason: " + e.what();
+	}
+
+	switch (job.kind)
+	{
+	case CookKind::COOK_MESH:
+		return MeshCooker::Cook(job.source, job.target, outSummary);
+	case CookKind::COOK_TEXTURE:
+		return TextureCooker::Cook(job.source, job.target, job.isSRGB, outSummary);
+	case CookKind::COOK_COPY:
+	{
+		try
+		{
+			copy_file(job.source, job.target, copy_options::overwrite_existing);
+		}
+		catch (const std::exception& e)
+		{
+			return "Failed to copy '" + job.source.string() + "'! Reason: " + e.what();
+		}
+
+		outSummary = "Copied '" + job.source.string() + "'.";
+		return{};
+	}
+	}
+
+	return "Unknown cook kind for '" + job.source.string() + "'!";
+}
+
+void PrintLocked(
+	const string& message,
+	LogType type)
+{
+	lock_guard<mutex> lock(logMutex);
+
+	Log::Print(
+		message,
+		"ASSET_COOKER",
+		type,
+		type == LogType::LOG_ERROR ? 2 : 0);
+}
@@ -0,0 +1,281 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  audio-bench <file or dir> [--iterations N]
+//
+//  --iterations N - how many times each file is fully decoded, defaults to 20
+//
+//runs without an audio device or window and reports per file:
+//  decode - whole-file decode into one buffer, the same path AudioCache uses for one-shots
+//  stream - AudioStream drained as fast as possible, the same path used for long ambience
+//and finally times AudioCache::LoadDirectory across all hardware threads for directories
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <thread>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/file_utils.hpp"
+
+#include "core/flac_decoder.hpp"
+#include "core/audio_stream.hpp"
+#include "core/audio_cache.hpp"
+#include "core/asset_pack.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaFile::ReadBinaryLinesFromFile;
+
+using GameTest::Core::FlacDecoder;
+using GameTest::Core::FlacInfo;
+using GameTest::Core::AudioStream;
+using GameTest::Core::AudioCache;
+using GameTest::Core::AssetPack;
+
+using std::string;
+using std::vector;
+using std::ostringstream;
+using std::fixed;
+using std::setprecision;
+using std::setw;
+using std::left;
+using std::stoul;
+using std::sort;
+using std::transform;
+using std::tolower;
+using std::this_thread::yield;
+using std::filesystem::path;
+using std::filesystem::exists;
+using std::filesystem::is_directory;
+using std::filesystem::recursive_directory_iterator;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+struct BenchResult
+{
+	f64 decodeSeconds{};
+	f64 streamSeconds{};
+	string error{};
+};
+
+static BenchResult BenchFile(
+	const vector<u8>& data,
+	u32 iterations,
+	FlacInfo& outInfo);
+static f64 GetSeconds(steady_clock::time_point start);
+
+int main(int argc, char* argv[])
+{
+	vector<string> positional{};
+	u32 iterations = 20;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+
+		if (arg == "--iterations"
+			&& i + 1 < argc)
+		{
+			try { iterations = scast<u32>(stoul(argv[++i])); }
+			catch (...) { iterations = 0; }
+		}
+		else positional.push_back(arg);
+	}
+
+	if (positional.size() != 1
+		|| iterations == 0)
+	{
+		Log::Print(
+			"usage: audio-bench <file or dir> [--iterations N]",
+			"AUDIO_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	path target = positional[0];
+	bool isDir = exists(target) && is_directory(target);
+
+	vector<path> files{};
+	if (isDir)
+	{
+		for (const auto& entry : recursive_directory_iterator(target))
+		{
+			string extension = entry.path().extension().string();
+			transform(
+				extension.begin(),
+				extension.end(),
+				extension.begin(),
+				[](unsigned char c) { return scast<char>(tolower(c)); });
+
+			if (entry.is_regular_file()
+				&& extension == ".flac")
+			{
+				files.push_back(entry.path());
+			}
+		}
+		sort(files.begin(), files.end());
+	}
+	else files.push_back(target);
+
+	f64 totalAudioSeconds{};
+	f64 totalDecodeSeconds{};
+	f64 totalStreamSeconds{};
+	u64 totalPcmBytes{};
+	bool hasFailed{};
+
+	for (const auto& file : files)
+	{
+		vector<u8> data{};
+		string result = ReadBinaryLinesFromFile(file, data);
+		if (!result.empty())
+		{
+			Log::Print(result, "AUDIO_BENCH", LogType::LOG_ERROR, 2);
+			hasFailed = true;
+			continue;
+		}
+
+		FlacInfo info{};
+		BenchResult bench = BenchFile(data, iterations, info);
+		if (!bench.error.empty())
+		{
+			Log::Print(
+				"'" + file.filename().string() + "' failed! Reason: " + bench.error,
+				"AUDIO_BENCH",
+				LogType::LOG_ERROR,
+				2);
+
+			hasFailed = true;
+			continue;
+		}
+
+		f64 audioSeconds = scast<f64>(info.totalFrames) / info.sampleRate;
+		u64 pcmBytes = info.totalFrames * info.channels * sizeof(f32);
+
+		totalAudioSeconds += audioSeconds * iterations;
+		totalDecodeSeconds += bench.decodeSeconds;
+		totalStreamSeconds += bench.streamSeconds;
+		totalPcmBytes += pcmBytes * iterations;
+
+		ostringstream oss{};
+		oss << fixed << setprecision(1)
+			<< left << setw(28) << file.filename().string()
+			<< info.sampleRate << "Hz " << scast<u32>(info.bitsPerSample) << "bit "
+			<< scast<u32>(info.channels) << "ch " << setprecision(2) << audioSeconds << "s"
+			<< setprecision(1)
+			<< " | decode " << audioSeconds * iterations / bench.decodeSeconds << "x realtime, "
+			<< pcmBytes * iterations / bench.decodeSeconds / (1024.0 * 1024.0) << " MB/s"
+			<< " | stream " << audioSeconds / bench.streamSeconds << "x realtime";
+
+		Log::Print(oss.str(), "AUDIO_BENCH", LogType::LOG_INFO);
+	}
+
+	if (totalDecodeSeconds > 0.0)
+	{
+		ostringstream oss{};
+		oss << fixed << setprecision(1)
+			<< "total decode " << totalAudioSeconds / totalDecodeSeconds << "x realtime, "
+			<< totalPcmBytes / totalDecodeSeconds / (1024.0 * 1024.0) << " MB/s of pcm, "
+			<< "stream " << (totalAudioSeconds / iterations) / totalStreamSeconds << "x realtime";
+
+		Log::Print(oss.str(), "AUDIO_BENCH", LogType::LOG_SUCCESS);
+	}
+
+	if (isDir)
+	{
+		AssetPack::SetRootPath(target.parent_path());
+
+		auto start = steady_clock::now();
+		string result = AudioCache::LoadDirectory(target);
+		f64 seconds = GetSeconds(start);
+
+		if (!result.empty())
+		{
+			Log::Print(result, "AUDIO_BENCH", LogType::LOG_ERROR, 2);
+			hasFailed = true;
+		}
+
+		ostringstream oss{};
+		oss << fixed << setprecision(2)
+			<< "AudioCache::LoadDirectory took " << seconds * 1000.0 << " ms, pool "
+			<< AudioCache::GetPoolUsage() / 1024 << " of " << AudioCache::GetPoolCapacity() / 1024 << " KB used";
+
+		Log::Print(oss.str(), "AUDIO_BENCH", LogType::LOG_INFO);
+
+		AudioCache::Clear();
+	}
+
+	return hasFailed ? 1 : 0;
+}
+
+BenchResult BenchFile(
+	const vector<u8>& data,
+	u32 iterations,
+	FlacInfo& outInfo)
+{
+	BenchResult bench{};
+
+	FlacDecoder decoder{};
+	bench.error = decoder.Open(data.data(), data.size());
+	if (!bench.error.empty()) return bench;
+
+	outInfo = decoder.GetInfo();
+	if (outInfo.totalFrames == 0)
+	{
+		bench.error = "Length is unknown.";
+		return bench;
+	}
+
+	vector<f32> pcm(scast<size_t>(outInfo.totalFrames) * outInfo.channels);
+
+	auto decodeStart = steady_clock::now();
+	for (u32 i = 0; i < iterations; ++i)
+	{
+		decoder.Rewind();
+
+		size_t framesRead{};
+		bench.error = decoder.ReadFrames(pcm.data(), scast<size_t>(outInfo.totalFrames), framesRead);
+		if (!bench.error.empty()) return bench;
+		if (framesRead != outInfo.totalFrames)
+		{
+			bench.error = "Decoded " + std::to_string(framesRead) + " of "
+				+ std::to_string(outInfo.totalFrames) + " frames.";
+			return bench;
+		}
+	}
+	bench.decodeSeconds = GetSeconds(decodeStart);
+
+	//drain the stream in playback-sized pulls as fast as the worker allows,
+	//so this measures decode plus ring handoff rather than playback pacing
+	AudioStream stream{};
+	bench.error = stream.Open(data.data(), data.size(), false);
+	if (!bench.error.empty()) return bench;
+
+	vector<f32> pull(1024u * outInfo.channels);
+
+	auto streamStart = steady_clock::now();
+	while (!stream.HasFinished())
+	{
+		if (stream.Read(pull.data(), 1024) == 0) yield();
+	}
+	bench.streamSeconds = GetSeconds(streamStart);
+
+	stream.Close();
+
+	return bench;
+}
+
+f64 GetSeconds(steady_clock::time_point start)
+{
+	return duration<f64>(steady_clock::now() - start).count();
+}
@@ -0,0 +1,376 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  hash-bench [--size MB] [--iterations N] [--file path]
+//
+//  --size MB      - largest buffer hashed, defaults to 256 so it can't stay in cache
+//  --iterations N - how many times the largest buffer is hashed, smaller ones scale up to the same byte count, defaults to 8
+//  --file path    - also hashes this file through KalaFile::HashFile
+//
+//runs without a window or gl context and reports:
+//  known answers - HashBytes64, HashBytes128 and HashStream against xxh3 hashes from the reference xxHash,
+//                  every length class with and without a seed, streams fed in uneven pieces
+//  throughput    - GB/s of HashBytes64, HashBytes128 and HashStream from 64 byte keys in cache to the
+//                  largest buffer in memory, with the path picked for this cpu
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+#include "KalaHeaders/hash_utils.hpp"
+#include "KalaHeaders/file_utils.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaHash::Hash128;
+using KalaHeaders::KalaHash::HashPath;
+using KalaHeaders::KalaHash::HashStream;
+using KalaHeaders::KalaHash::HashBytes64;
+using KalaHeaders::KalaHash::HashBytes128;
+using KalaHeaders::KalaHash::GetHashPath;
+using KalaHeaders::KalaFile::HashFile;
+
+using std::string;
+using std::vector;
+using std::ostringstream;
+using std::fixed;
+using std::setprecision;
+using std::setw;
+using std::left;
+using std::hex;
+using std::setfill;
+using std::stoul;
+using std::min;
+using std::max;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+//xxh3 of the first length bytes of CreateKnownInput, from the reference xxHash 0.8
+struct KnownAnswer
+{
+	size_t length{};
+	u64 seed{};
+	u64 hash64{};
+	u64 hash128Low{};
+	u64 hash128High{};
+};
+
+static const KnownAnswer knownAnswers[] =
+{
+	{ 0, 0x0000000000000000ULL, 0x2D06800538D394C2ULL, 0x6001C324468D497FULL, 0x99AA06D3014798D8ULL },
+	{ 1, 0x0000000000000000ULL, 0x4C5CCA45D0F4811FULL, 0x4C5CCA45D0F4811FULL, 0x495B62073EF70CA4ULL },
+	{ 3, 0x0000000000000000ULL, 0x6E3E2670E61106ACULL, 0x6E3E2670E61106ACULL, 0x390CDC5B4A895DD7ULL },
+	{ 4, 0x0000000000000000ULL, 0x5C4C63133443D03FULL, 0x3D668AF6F2A44D77ULL, 0xAA6E2F274640A3F4ULL },
+	{ 8, 0x0000000000000000ULL, 0xF9FD4DD0B04D78F5ULL, 0x61DDBE7F31A6100DULL, 0x6A86A3BDA6AF4E3DULL },
+	{ 9, 0x0000000000000000ULL, 0x7C20DF9712C26EDFULL, 0x8C7B67FD458A936BULL, 0x664C7CA18AFD6255ULL },
+	{ 16, 0x0000000000000000ULL, 0x86ABF6BACCEA0858ULL, 0xE2CE54A7C19C730DULL, 0x7F9A218B0425449AULL },
+	{ 17, 0x0000000000000000ULL, 0xB58BF5DC5022D071ULL, 0x8D96EF110FCDEBB4ULL, 0x66FC23F6439DBD77ULL },
+	{ 64, 0x0000000000000000ULL, 0x1291D2D4042330DDULL, 0xBA7E015A54F14BE1ULL, 0xE0FAF20E0E0FE0DDULL },
+	{ 128, 0x0000000000000000ULL, 0x10D17F72C0CCBA41ULL, 0xFF361DEC1385710AULL, 0xAEC730751478556CULL },
+	{ 129, 0x0000000000000000ULL, 0x1648BDC3DB49D1A2ULL, 0x4545B3A09738E31AULL, 0x98CD36CCBB557926ULL },
+	{ 240, 0x0000000000000000ULL, 0xB6CFAF343FAB81E6ULL, 0x3F2C53E72293711FULL, 0x5293E17BF553903DULL },
+	{ 241, 0x0000000000000000ULL, 0x956CAE592C67279EULL, 0x956CAE592C67279EULL, 0xB53840FE3FEDF161ULL },
+	{ 1024, 0x0000000000000000ULL, 0x9FB9947417C15B80ULL, 0x9FB9947417C15B80ULL, 0xEFAA73720EEC0A33ULL },
+	{ 1025, 0x0000000000000000ULL, 0xFE1B47100B1D79D8ULL, 0xFE1B47100B1D79D8ULL, 0xD42732DBB96B6C2BULL },
+	{ 10000, 0x0000000000000000ULL, 0x8CF4235729D63A12ULL, 0x8CF4235729D63A12ULL, 0x0C56AC0797944248ULL },
+	{ 0, 0x9E3779B185EBCA87ULL, 0x07F70F819703314DULL, 0xF9ECE1036ECBB2EDULL, 0x45EF6DDC7AFB225AULL },
+	{ 1, 0x9E3779B185EBCA87ULL, 0x69F37FE502A5CE84ULL, 0x69F37FE502A5CE84ULL, 0x0A5CF80E139619EBULL },
+	{ 3, 0x9E3779B185EBCA87ULL, 0x82EE0D8C3A491C38ULL, 0x82EE0D8C3A491C38ULL, 0xBCBF4BDFF464F81EULL },
+	{ 4, 0x9E3779B185EBCA87ULL, 0xCAF8AFA7BA97CB0EULL, 0xCDEEDFA866335572ULL, 0x77658E156C5EB04EULL },
+	{ 8, 0x9E3779B185EBCA87ULL, 0x3B4C70CBE3EBC00DULL, 0x48E77B403A836797ULL, 0x07E80027444D0D76ULL },
+	{ 9, 0x9E3779B185EBCA87ULL, 0x99FD9784F4EFDF49ULL, 0x86A7FF58815EFF5CULL, 0x3703BB5446997DBBULL },
+	{ 16, 0x9E3779B185EBCA87ULL, 0xFDE04540EAE27B52ULL, 0xB2FA7C53879D9CC5ULL, 0x80224CF530FB9FA4ULL },
+	{ 17, 0x9E3779B185EBCA87ULL, 0xC98530740C07E43BULL, 0x728A12B11263D007ULL, 0x91AD11EC4C50A863ULL },
+	{ 64, 0x9E3779B185EBCA87ULL, 0xE5E83586117A92E2ULL, 0x9E7B79904BDCE6DDULL, 0x5295991E9826FFBCULL },
+	{ 128, 0x9E3779B185EBCA87ULL, 0xD6B287B434C3EAC1ULL, 0x09AE600CC22338B4ULL, 0x0A40D412ABBF3F3DULL },
+	{ 129, 0x9E3779B185EBCA87ULL, 0xEFCB0A611944C6E1ULL, 0xD497B4531F9651AAULL, 0xD0BBBDAB5145636AULL },
+	{ 240, 0x9E3779B185EBCA87ULL, 0xC587312C2EC9D377ULL, 0xF3302D90F1B69291ULL, 0xEECC8FD9675ED8F7ULL },
+	{ 241, 0x9E3779B185EBCA87ULL, 0x033C6361AF37452EULL, 0x033C6361AF37452EULL, 0x167FD51A2FFD5AE4ULL },
+	{ 1024, 0x9E3779B185EBCA87ULL, 0x134948C03F96C946ULL, 0x134948C03F96C946ULL, 0xC5CDB9D399DF2234ULL },
+	{ 1025, 0x9E3779B185EBCA87ULL, 0x35A15DB1137328EBULL, 0x35A15DB1137328EBULL, 0xEC1D4CE4DF9D1900ULL },
+	{ 10000, 0x9E3779B185EBCA87ULL, 0xE5699BAD8812C275ULL, 0xE5699BAD8812C275ULL, 0x114FE44B236A5BBEULL }
+};
+
+//stream piece sizes, 1 byte, odd sizes across stripe and block boundaries and one big update
+static const size_t pieceSizes[] = { 1, 7, 63, 100, 1000, 1 << 20 };
+
+//byte i is ((i * 131 + 7) ^ (i >> 8)) & 0xFF
+static vector<u8> CreateKnownInput(size_t size);
+
+//Returns the number of failed checks, each failure is logged
+static u32 CheckKnownAnswers();
+
+static string ToHex(u64 value);
+static string GetPathName(HashPath path);
+static f64 GetSeconds(steady_clock::time_point start);
+
+int main(int argc, char* argv[])
+{
+	u32 sizeMB = 256;
+	u32 iterations = 8;
+	string filePath{};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+
+		if (arg == "--size"
+			&& i + 1 < argc)
+		{
+			try { sizeMB = scast<u32>(stoul(argv[++i])); }
+			catch (...) { sizeMB = 0; }
+		}
+		else if (arg == "--iterations"
+			&& i + 1 < argc)
+		{
+			try { iterations = scast<u32>(stoul(argv[++i])); }
+			catch (...) { iterations = 0; }
+		}
+		else if (arg == "--file"
+			&& i + 1 < argc)
+		{
+			filePath = argv[++i];
+		}
+		else sizeMB = 0;
+	}
+
+	if (sizeMB == 0
+		|| iterations == 0)
+	{
+		Log::Print(
+			"usage: hash-bench [--size MB] [--iterations N] [--file path]",
+			"HASH_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	Log::Print(
+		"hash path: " + GetPathName(GetHashPath()),
+		"HASH_BENCH",
+		LogType::LOG_INFO);
+
+	u32 failures = CheckKnownAnswers();
+	if (failures > 0)
+	{
+		Log::Print(
+			std::to_string(failures) + " known answer checks failed!",
+			"HASH_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	Log::Print(
+		"known answers: " + std::to_string(std::size(knownAnswers)) + " inputs match for one-shot and streamed hashing",
+		"HASH_BENCH",
+		LogType::LOG_SUCCESS);
+
+	size_t largest = scast<size_t>(sizeMB) * 1024 * 1024;
+
+	//random enough that nothing can shortcut it, touched once so page faults aren't timed
+	vector<u8> data(largest);
+	u64 state = 0x9E3779B97F4A7C15ULL;
+	for (u8& b : data)
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		b = scast<u8>(state >> 56);
+	}
+
+	vector<size_t> sizes = { 64, 1024, 64 * 1024, 1024 * 1024 };
+	sizes.erase(
+		std::remove_if(sizes.begin(), sizes.end(), [largest](size_t s) { return s >= largest; }),
+		sizes.end());
+	sizes.push_back(largest);
+
+	u64 totalBytes = scast<u64>(largest) * iterations;
+
+	//sum of every hash so the calls can't be optimized out
+	u64 checksum{};
+
+	for (size_t size : sizes)
+	{
+		u64 rounds = max<u64>(1, totalBytes / size);
+
+		//inputs below 1 MB walk through a window that stays in cache, the rest through the whole
+		//buffer, so small sizes show the hash itself and large ones the memory bandwidth
+		size_t window = size < 1024 * 1024 ? min<size_t>(largest, 256 * 1024) : largest;
+		size_t slots = max<size_t>(1, window / size);
+
+		auto start64 = steady_clock::now();
+		for (u64 r = 0; r < rounds; ++r)
+		{
+			checksum += HashBytes64(data.data() + (r % slots) * size, size);
+		}
+		f64 seconds64 = GetSeconds(start64);
+
+		auto start128 = steady_clock::now();
+		for (u64 r = 0; r < rounds; ++r)
+		{
+			checksum += HashBytes128(data.data() + (r % slots) * size, size).high;
+		}
+		f64 seconds128 = GetSeconds(start128);
+
+		//streams are fed 64 KB at a time, like reading a file in chunks
+		HashStream stream{};
+		auto startStream = steady_clock::now();
+		for (u64 r = 0; r < rounds; ++r)
+		{
+			const u8* p = data.data() + (r % slots) * size;
+
+			stream.Reset();
+			for (size_t offset = 0; offset < size; offset += 64 * 1024)
+			{
+				stream.Update(p + offset, min<size_t>(64 * 1024, size - offset));
+			}
+			checksum += stream.Digest64();
+		}
+		f64 secondsStream = GetSeconds(startStream);
+
+		f64 bytes = scast<f64>(rounds) * size;
+
+		string sizeName = size >= 1024 * 1024
+			? std::to_string(size / (1024 * 1024)) + " MB"
+			: size >= 1024
+			? std::to_string(size / 1024) + " KB"
+			: std::to_string(size) + " B";
+
+		ostringstream oss{};
+		oss << fixed << setprecision(2)
+			<< left << setw(8) << sizeName
+			<< "64-bit " << bytes / seconds64 / 1e9 << " GB/s"
+			<< " | 128-bit " << bytes / seconds128 / 1e9 << " GB/s"
+			<< " | stream " << bytes / secondsStream / 1e9 << " GB/s"
+			<< " | " << setprecision(1) << seconds64 / rounds * 1e9 << " ns per 64-bit hash";
+
+		Log::Print(oss.str(), "HASH_BENCH", LogType::LOG_INFO);
+	}
+
+	if (!filePath.empty())
+	{
+		u64 fileHash{};
+
+		auto fileStart = steady_clock::now();
+		string result = HashFile(filePath, fileHash);
+		f64 fileSeconds = GetSeconds(fileStart);
+
+		if (!result.empty())
+		{
+			Log::Print(result, "HASH_BENCH", LogType::LOG_ERROR, 2);
+			return 1;
+		}
+
+		uintmax_t fileSize = std::filesystem::file_size(filePath);
+
+		ostringstream oss{};
+		oss << fixed << setprecision(2)
+			<< "file " << filePath << " -> " << ToHex(fileHash)
+			<< " | " << scast<f64>(fileSize) / (1024.0 * 1024.0) << " MB in " << fileSeconds * 1000.0 << " ms, "
+			<< scast<f64>(fileSize) / max(fileSeconds, 1e-9) / 1e9 << " GB/s";
+
+		Log::Print(oss.str(), "HASH_BENCH", LogType::LOG_INFO);
+	}
+
+	if (checksum == 0) Log::Print("empty checksum", "HASH_BENCH", LogType::LOG_WARNING);
+
+	return 0;
+}
+
+vector<u8> CreateKnownInput(size_t size)
+{
+	vector<u8> data(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		data[i] = scast<u8>(((i * 131 + 7) ^ (i >> 8)) & 0xFF);
+	}
+	return data;
+}
+
+u32 CheckKnownAnswers()
+{
+	size_t longest{};
+	for (const KnownAnswer& answer : knownAnswers)
+	{
+		longest = max(longest, answer.length);
+	}
+
+	vector<u8> input = CreateKnownInput(longest);
+
+	u32 failures{};
+
+	auto Fail = [&failures](const KnownAnswer& answer, const string& what, u64 got, u64 expected)
+		{
+			++failures;
+
+			Log::Print(
+				what + " of " + std::to_string(answer.length) + " bytes with seed " + ToHex(answer.seed)
+				+ " is " + ToHex(got) + ", expected " + ToHex(expected),
+				"HASH_BENCH",
+				LogType::LOG_ERROR,
+				2);
+		};
+
+	for (const KnownAnswer& answer : knownAnswers)
+	{
+		u64 hash64 = HashBytes64(input.data(), answer.length, answer.seed);
+		if (hash64 != answer.hash64) Fail(answer, "HashBytes64", hash64, answer.hash64);
+
+		Hash128 hash128 = HashBytes128(input.data(), answer.length, answer.seed);
+		if (hash128.low != answer.hash128Low) Fail(answer, "HashBytes128 low", hash128.low, answer.hash128Low);
+		if (hash128.high != answer.hash128High) Fail(answer, "HashBytes128 high", hash128.high, answer.hash128High);
+
+		for (size_t pieceSize : pieceSizes)
+		{
+			HashStream stream(answer.seed);
+			for (size_t offset = 0; offset < answer.length; offset += pieceSize)
+			{
+				stream.Update(input.data() + offset, min(pieceSize, answer.length - offset));
+
+				//digests in the middle must not disturb the stream
+				if (offset % 3 == 0) (void)stream.Digest64();
+			}
+
+			string what = "HashStream in " + std::to_string(pieceSize) + " byte pieces";
+
+			u64 stream64 = stream.Digest64();
+			if (stream64 != answer.hash64) Fail(answer, what, stream64, answer.hash64);
+
+			Hash128 stream128 = stream.Digest128();
+			if (stream128 != hash128) Fail(answer, what + " 128-bit", stream128.high, answer.hash128High);
+		}
+	}
+
+	return failures;
+}
+
+string ToHex(u64 value)
+{
+	ostringstream oss{};
+	oss << "0x" << hex << setw(16) << setfill('0') << value;
+	return oss.str();
+}
+
+string GetPathName(HashPath path)
+{
+	switch (path)
+	{
+	case HashPath::PATH_AVX2: return "avx2";
+	case HashPath::PATH_SSE2: return "sse2";
+	default: return "scalar";
+	}
+}
+
+f64 GetSeconds(steady_clock::time_point start)
+{
+	return duration<f64>(steady_clock::now() - start).count();
+}
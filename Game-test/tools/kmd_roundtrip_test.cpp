@@ -0,0 +1,338 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  kmd-roundtrip-test [model.kmd ...]
+//
+//imports every given .kmd, every .kmd in files/models if none are given, writes it back
+//to the temp directory and checks that the written file matches the original byte for byte:
+//  export  - ExportKMD with all blocks at once
+//  add     - KmdStreamWriter with one AddBlock per block
+//  chunked - KmdStreamWriter with BeginBlock, the vertices and indices in small chunks and EndBlock
+//then exports the blocks of every model into one library and checks that the library
+//imports and writes back byte for byte the same three ways
+//exits with 1 if any check fails
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+
+#include "KalaHeaders/core_utils.hpp"
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+#include "KalaHeaders/file_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+#include "KalaHeaders/export_kmd.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaFile::ReadBinaryLinesFromFile;
+using KalaHeaders::KalaModelData::ModelHeader;
+using KalaHeaders::KalaModelData::ModelTable;
+using KalaHeaders::KalaModelData::ModelBlock;
+using KalaHeaders::KalaModelData::ImportKMD;
+using KalaHeaders::KalaModelData::ImportResult;
+using KalaHeaders::KalaModelData::ResultToString;
+using KalaHeaders::KalaModelData::ExportKMD;
+using KalaHeaders::KalaModelData::ExportResult;
+using KalaHeaders::KalaModelData::ExportResultToString;
+using KalaHeaders::KalaModelData::KmdStreamWriter;
+
+using std::string;
+using std::vector;
+using std::to_string;
+using std::min;
+using std::sort;
+using std::make_move_iterator;
+using std::error_code;
+using std::filesystem::path;
+using std::filesystem::directory_iterator;
+using std::filesystem::temp_directory_path;
+using std::filesystem::remove;
+
+//vertices or indices per write when a block is streamed in chunks,
+//small enough that every block of the test models is split
+constexpr size_t STREAM_CHUNK_SIZE = 100;
+
+static u32 failures{};
+
+static void Check(
+	bool condition,
+	const string& what);
+
+//Returns the offset of the first differing byte, or the shorter size if one is a prefix of the other
+static size_t FindMismatch(
+	const vector<u8>& a,
+	const vector<u8>& b);
+
+//Writes blocks with KmdStreamWriter, whole or in chunks of STREAM_CHUNK_SIZE
+static ExportResult StreamBlocks(
+	const path& outFile,
+	const vector<ModelBlock>& blocks,
+	u8 scaleFactor,
+	bool isChunked);
+
+//Reads written back and compares it against original, removes written afterwards
+static void CompareFile(
+	const string& name,
+	const vector<u8>& original,
+	const path& written);
+
+//Imports model and writes it back with every writer, returns its blocks
+static vector<ModelBlock> RoundTrip(
+	const string& name,
+	const path& model);
+
+int main(int argc, char* argv[])
+{
+	vector<path> models{};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		models.push_back(argv[i]);
+	}
+
+	if (models.empty())
+	{
+		error_code ec{};
+		for (const auto& entry : directory_iterator("files/models", ec))
+		{
+			if (entry.path().extension() == ".kmd") models.push_back(entry.path());
+		}
+
+		//directory order is not stable between platforms
+		sort(models.begin(), models.end());
+	}
+
+	if (models.empty())
+	{
+		Log::Print(
+			"usage: kmd-roundtrip-test [model.kmd ...], no models were given and files/models has none",
+			"KMD_ROUNDTRIP_TEST",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	vector<ModelBlock> library{};
+
+	for (const path& model : models)
+	{
+		vector<ModelBlock> blocks = RoundTrip(model.filename().string(), model);
+
+		library.insert(
+			library.end(),
+			make_move_iterator(blocks.begin()),
+			make_move_iterator(blocks.end()));
+	}
+
+	//the shipped models hold one block each, so a library of all of them
+	//is what covers the table and offsets of a file with several blocks
+	if (library.size() > 1)
+	{
+		path libraryPath = temp_directory_path() / "kmd_roundtrip_library.kmd";
+
+		ExportResult libraryResult = ExportKMD(libraryPath, library);
+		Check(libraryResult == ExportResult::RESULT_SUCCESS, "library: export failed, " + ExportResultToString(libraryResult));
+
+		if (libraryResult == ExportResult::RESULT_SUCCESS)
+		{
+			vector<ModelBlock> blocks = RoundTrip("library", libraryPath);
+			Check(blocks.size() == library.size(), "library: imported " + to_string(blocks.size()) + " of " + to_string(library.size()) + " blocks");
+
+			error_code ec{};
+			remove(libraryPath, ec);
+		}
+	}
+
+	if (failures > 0)
+	{
+		Log::Print(
+			to_string(failures) + " kmd round trip checks failed!",
+			"KMD_ROUNDTRIP_TEST",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	Log::Print(
+		"all " + to_string(models.size()) + " models were written back byte for byte",
+		"KMD_ROUNDTRIP_TEST",
+		LogType::LOG_SUCCESS);
+
+	return 0;
+}
+
+void Check(
+	bool condition,
+	const string& what)
+{
+	if (condition) return;
+
+	++failures;
+
+	Log::Print(
+		what,
+		"KMD_ROUNDTRIP_TEST",
+		LogType::LOG_ERROR,
+		2);
+}
+
+size_t FindMismatch(
+	const vector<u8>& a,
+	const vector<u8>& b)
+{
+	size_t size = min(a.size(), b.size());
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (a[i] != b[i]) return i;
+	}
+
+	return size;
+}
+
+ExportResult StreamBlocks(
+	const path& outFile,
+	const vector<ModelBlock>& blocks,
+	u8 scaleFactor,
+	bool isChunked)
+{
+	KmdStreamWriter writer{};
+
+	ExportResult result = writer.Open(
+		outFile,
+		scast<u32>(blocks.size()),
+		scaleFactor);
+	if (result != ExportResult::RESULT_SUCCESS) return result;
+
+	for (size_t i = 0; i < blocks.size(); ++i)
+	{
+		const ModelBlock& b = blocks[i];
+
+		if (!isChunked)
+		{
+			result = writer.AddBlock(b);
+			if (result != ExportResult::RESULT_SUCCESS) return result;
+
+			continue;
+		}
+
+		result = writer.BeginBlock(
+			b,
+			scast<u32>(b.vertices.size()),
+			scast<u32>(b.indices.size()));
+		if (result != ExportResult::RESULT_SUCCESS) return result;
+
+		for (size_t v = 0; v < b.vertices.size(); v += STREAM_CHUNK_SIZE)
+		{
+			result = writer.WriteVertices(
+				b.vertices.data() + v,
+				min(STREAM_CHUNK_SIZE, b.vertices.size() - v));
+			if (result != ExportResult::RESULT_SUCCESS) return result;
+		}
+
+		for (size_t n = 0; n < b.indices.size(); n += STREAM_CHUNK_SIZE)
+		{
+			result = writer.WriteIndices(
+				b.indices.data() + n,
+				min(STREAM_CHUNK_SIZE, b.indices.size() - n));
+			if (result != ExportResult::RESULT_SUCCESS) return result;
+		}
+
+		result = writer.EndBlock();
+		if (result != ExportResult::RESULT_SUCCESS) return result;
+	}
+
+	return writer.Close();
+}
+
+void CompareFile(
+	const string& name,
+	const vector<u8>& original,
+	const path& written)
+{
+	vector<u8> data{};
+	string readResult = ReadBinaryLinesFromFile(written, data);
+
+	error_code ec{};
+	remove(written, ec);
+
+	if (!readResult.empty())
+	{
+		Check(false, name + ": " + readResult);
+		return;
+	}
+
+	Check(data.size() == original.size(), name + ": wrote " + to_string(data.size()) + " bytes, original has " + to_string(original.size()));
+
+	size_t mismatch = FindMismatch(original, data);
+	Check(mismatch == min(original.size(), data.size()), name + ": first differing byte at offset " + to_string(mismatch));
+}
+
+vector<ModelBlock> RoundTrip(
+	const string& name,
+	const path& model)
+{
+	vector<u8> original{};
+	string readResult = ReadBinaryLinesFromFile(model, original);
+	if (!readResult.empty())
+	{
+		Check(false, name + ": " + readResult);
+		return {};
+	}
+
+	ModelHeader header{};
+	vector<ModelTable> tables{};
+	vector<ModelBlock> blocks{};
+
+	ImportResult importResult = ImportKMD(
+		model,
+		header,
+		tables,
+		blocks);
+	if (importResult != ImportResult::RESULT_SUCCESS)
+	{
+		Check(false, name + ": import failed, " + ResultToString(importResult));
+		return {};
+	}
+
+	string stem = model.stem().string();
+
+	path exported = temp_directory_path() / ("kmd_roundtrip_export_" + stem + ".kmd");
+	ExportResult exportResult = ExportKMD(
+		exported,
+		blocks,
+		header.scaleFactor);
+	Check(exportResult == ExportResult::RESULT_SUCCESS, name + ": export failed, " + ExportResultToString(exportResult));
+
+	if (exportResult == ExportResult::RESULT_SUCCESS) CompareFile(name + " export", original, exported);
+
+	for (bool isChunked : { false, true })
+	{
+		string writer = isChunked ? "chunked" : "add";
+
+		path streamed = temp_directory_path() / ("kmd_roundtrip_" + writer + "_" + stem + ".kmd");
+		ExportResult streamResult = StreamBlocks(
+			streamed,
+			blocks,
+			header.scaleFactor,
+			isChunked);
+		Check(streamResult == ExportResult::RESULT_SUCCESS, name + " " + writer + ": write failed, " + ExportResultToString(streamResult));
+
+		if (streamResult == ExportResult::RESULT_SUCCESS) CompareFile(name + " " + writer, original, streamed);
+	}
+
+	Log::Print(
+		name + ": " + to_string(blocks.size()) + " blocks, " + to_string(original.size()) + " bytes",
+		"KMD_ROUNDTRIP_TEST",
+		LogType::LOG_INFO);
+
+	return blocks;
+}
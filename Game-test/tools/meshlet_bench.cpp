@@ -0,0 +1,619 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  meshlet-bench [--segments N] [--iterations N]
+//
+//  --segments N   - slices of the generated sphere, the default 1448 gives about 2 million triangles
+//  --iterations N - how many times each camera is culled, defaults to 100
+//
+//runs without a window or gl context and reports:
+//  build - MeshletBuilder::Build over the whole sphere
+//  cull  - MeshletCuller::Cull from outside, from inside, from close to the surface with
+//          the edge of the view crossing the sphere and with the sphere off screen,
+//          with the share of meshlets rejected by the frustum and by their normal cones
+//exits with 1 before timing anything if a meshlet passes MESHLET_MAX_VERTICES or
+//MESHLET_MAX_TRIANGLES, the meshlets don't cover the index buffer or their spheres miss a vertex,
+//if a flat grid seen from the back isn't cone culled or seen from the front is,
+//or if any camera culls a meshlet that still has a vertex in view on a front facing triangle
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "graphics/meshlet.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec2;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::vec4;
+using KalaHeaders::KalaMath::mat4;
+using KalaHeaders::KalaMath::dot;
+using KalaHeaders::KalaMath::cross;
+using KalaHeaders::KalaMath::length;
+using KalaHeaders::KalaMath::perspective;
+using KalaHeaders::KalaMath::view;
+using KalaHeaders::KalaModelData::Vertex;
+
+using GameTest::Graphics::Meshlet;
+using GameTest::Graphics::MeshletDrawRange;
+using GameTest::Graphics::MeshletCullStats;
+using GameTest::Graphics::MeshletBuilder;
+using GameTest::Graphics::MeshletCuller;
+using GameTest::Graphics::MESHLET_MAX_VERTICES;
+using GameTest::Graphics::MESHLET_MAX_TRIANGLES;
+
+using std::string;
+using std::vector;
+using std::ostringstream;
+using std::fixed;
+using std::setprecision;
+using std::setw;
+using std::left;
+using std::stoul;
+using std::sinf;
+using std::cosf;
+using std::to_string;
+using std::sort;
+using std::unique;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+struct BenchCamera
+{
+	string name{};
+	vec3 pos{};
+	vec3 target{};
+	//the whole sphere is in view, so nothing may be frustum culled
+	bool isSphereInView{};
+	//the sphere is fully outside the view, so everything must be frustum culled
+	bool isSphereOffScreen{};
+};
+
+//unit sphere with the triangles of each ring next to each other, like a cooked mesh
+static void CreateSphere(
+	u32 segments,
+	vector<Vertex>& outVertices,
+	vector<u32>& outIndices);
+
+static f64 GetSeconds(steady_clock::time_point start);
+
+//Checks the meshlet limits, that the meshlets cover every triangle in order and that each sphere holds its vertices
+static bool CheckMeshlets(
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices,
+	const vector<Meshlet>& meshlets);
+
+//Known answer cone test, a flat grid facing +z has to be cone culled from behind and drawn whole from the front
+static bool CheckFlatGrid();
+
+//Checks that every meshlet left out of ranges is either fully outside one frustum plane
+//or has only back facing triangles as seen from cameraPos, and that the stats add up
+static bool CheckCull(
+	const string& name,
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices,
+	const vector<Meshlet>& meshlets,
+	const mat4& viewProjection,
+	const vec3& cameraPos,
+	const vector<MeshletDrawRange>& ranges,
+	const MeshletCullStats& stats);
+
+static void LogCheckFailure(const string& message);
+
+int main(int argc, char* argv[])
+{
+	u32 segments = 1448;
+	u32 iterations = 100;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+
+		if (arg == "--segments"
+			&& i + 1 < argc)
+		{
+			try { segments = scast<u32>(stoul(argv[++i])); }
+			catch (...) { segments = 0; }
+		}
+		else if (arg == "--iterations"
+			&& i + 1 < argc)
+		{
+			try { iterations = scast<u32>(stoul(argv[++i])); }
+			catch (...) { iterations = 0; }
+		}
+		else segments = 0;
+	}
+
+	if (segments < 3
+		|| iterations == 0)
+	{
+		Log::Print(
+			"usage: meshlet-bench [--segments N] [--iterations N]",
+			"MESHLET_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	if (!CheckFlatGrid()) return 1;
+
+	vector<Vertex> vertices{};
+	vector<u32> indices{};
+	CreateSphere(segments, vertices, indices);
+
+	size_t triangleCount = indices.size() / 3;
+
+	auto buildStart = steady_clock::now();
+	vector<Meshlet> meshlets = MeshletBuilder::Build(vertices, indices);
+	f64 buildSeconds = GetSeconds(buildStart);
+
+	u64 meshletVertices{};
+	u64 meshletTriangles{};
+	for (const Meshlet& meshlet : meshlets)
+	{
+		meshletVertices += meshlet.vertexCount;
+		meshletTriangles += meshlet.indexCount / 3;
+	}
+
+	if (meshlets.empty()
+		|| meshletTriangles != triangleCount)
+	{
+		Log::Print(
+			"Meshlets cover " + std::to_string(meshletTriangles) + " of " + std::to_string(triangleCount) + " triangles!",
+			"MESHLET_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	{
+		ostringstream oss{};
+		oss << fixed << setprecision(2)
+			<< triangleCount << " triangles, " << vertices.size() << " vertices -> "
+			<< meshlets.size() << " meshlets, avg "
+			<< scast<f64>(meshletTriangles) / meshlets.size() << " triangles and "
+			<< scast<f64>(meshletVertices) / meshlets.size() << " vertices"
+			<< " | build " << buildSeconds * 1000.0 << " ms, "
+			<< triangleCount / buildSeconds / 1'000'000.0 << " M triangles/s";
+
+		Log::Print(oss.str(), "MESHLET_BENCH", LogType::LOG_INFO);
+	}
+
+	if (!CheckMeshlets(vertices, indices, meshlets)) return 1;
+
+	mat4 projection = perspective(vec2(1920.0f, 1080.0f), 90.0f, 0.01f, 100.0f);
+	mat4 model{};
+
+	vector<BenchCamera> cameras =
+	{
+		{ "outside", vec3(0.0f, 0.0f, 3.0f), vec3(0.0f), true, false },
+		{ "inside", vec3(0.0f), vec3(0.0f, 0.0f, -1.0f), false, false },
+		{ "close edge", vec3(0.0f, 0.0f, 1.2f), vec3(1.0f, 0.0f, 0.6f), false, false },
+		{ "off screen", vec3(0.0f, 0.0f, 3.0f), vec3(0.0f, 0.0f, 6.0f), false, true }
+	};
+
+	vector<MeshletDrawRange> ranges{};
+	ranges.reserve(meshlets.size());
+
+	for (const BenchCamera& camera : cameras)
+	{
+		mat4 viewProjection = projection * view(camera.pos, camera.target, vec3(0.0f, 1.0f, 0.0f));
+
+		MeshletCullStats stats{};
+
+		MeshletCuller::Cull(
+			meshlets,
+			viewProjection,
+			model,
+			camera.pos,
+			true,
+			ranges,
+			&stats);
+
+		if (!CheckCull(
+			camera.name,
+			vertices,
+			indices,
+			meshlets,
+			viewProjection,
+			camera.pos,
+			ranges,
+			stats))
+		{
+			return 1;
+		}
+
+		if (camera.isSphereInView
+			&& (stats.frustumCulled != 0
+			|| stats.coneCulled == 0))
+		{
+			LogCheckFailure(camera.name + ": expected no frustum culled and some cone culled meshlets, got "
+				+ to_string(stats.frustumCulled) + " and " + to_string(stats.coneCulled) + "!");
+			return 1;
+		}
+
+		if (camera.isSphereOffScreen
+			&& stats.frustumCulled != stats.meshletCount)
+		{
+			LogCheckFailure(camera.name + ": only " + to_string(stats.frustumCulled) + " of "
+				+ to_string(stats.meshletCount) + " meshlets were frustum culled!");
+			return 1;
+		}
+
+		auto cullStart = steady_clock::now();
+		for (u32 i = 0; i < iterations; ++i)
+		{
+			MeshletCuller::Cull(
+				meshlets,
+				viewProjection,
+				model,
+				camera.pos,
+				true,
+				ranges,
+				&stats);
+		}
+		f64 cullSeconds = GetSeconds(cullStart) / iterations;
+
+		u64 drawnIndices{};
+		for (const MeshletDrawRange& range : ranges)
+		{
+			drawnIndices += range.indexCount;
+		}
+
+		ostringstream oss{};
+		oss << fixed << setprecision(1)
+			<< left << setw(12) << camera.name
+			<< "cull " << setprecision(3) << cullSeconds * 1000.0 << " ms" << setprecision(1)
+			<< " | frustum " << 100.0 * stats.frustumCulled / stats.meshletCount << "%"
+			<< " | cone " << 100.0 * stats.coneCulled / stats.meshletCount << "%"
+			<< " | " << stats.rangeCount << " ranges, "
+			<< 100.0 * drawnIndices / indices.size() << "% of triangles drawn";
+
+		Log::Print(oss.str(), "MESHLET_BENCH", LogType::LOG_INFO);
+	}
+
+	return 0;
+}
+
+void CreateSphere(
+	u32 segments,
+	vector<Vertex>& outVertices,
+	vector<u32>& outIndices)
+{
+	const f32 pi = 3.14159265358979f;
+
+	u32 rings = segments / 2;
+	u32 slices = segments;
+
+	outVertices.clear();
+	outIndices.clear();
+	outVertices.reserve(scast<size_t>(rings + 1) * (slices + 1));
+	outIndices.reserve(scast<size_t>(rings) * slices * 6);
+
+	for (u32 r = 0; r <= rings; ++r)
+	{
+		f32 phi = pi * r / rings;
+
+		for (u32 s = 0; s <= slices; ++s)
+		{
+			f32 theta = 2.0f * pi * s / slices;
+
+			vec3 n(sinf(phi) * cosf(theta), cosf(phi), sinf(phi) * sinf(theta));
+
+			Vertex v{};
+			v.position[0] = n.x;
+			v.position[1] = n.y;
+			v.position[2] = n.z;
+			v.normal[0] = n.x;
+			v.normal[1] = n.y;
+			v.normal[2] = n.z;
+			v.texCoord[0] = scast<f32>(s) / slices;
+			v.texCoord[1] = scast<f32>(r) / rings;
+
+			outVertices.push_back(v);
+		}
+	}
+
+	//counterclockwise seen from outside
+	for (u32 r = 0; r < rings; ++r)
+	{
+		for (u32 s = 0; s < slices; ++s)
+		{
+			u32 a = r * (slices + 1) + s;
+			u32 b = a + slices + 1;
+
+			outIndices.push_back(a);
+			outIndices.push_back(a + 1);
+			outIndices.push_back(b);
+
+			outIndices.push_back(a + 1);
+			outIndices.push_back(b + 1);
+			outIndices.push_back(b);
+		}
+	}
+}
+
+f64 GetSeconds(steady_clock::time_point start)
+{
+	return duration<f64>(steady_clock::now() - start).count();
+}
+
+bool CheckMeshlets(
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices,
+	const vector<Meshlet>& meshlets)
+{
+	u32 nextIndex{};
+	vector<u32> referenced{};
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const Meshlet& meshlet = meshlets[i];
+		string name = "meshlet " + to_string(i);
+
+		if (meshlet.firstIndex != nextIndex
+			|| meshlet.indexCount == 0
+			|| meshlet.indexCount % 3 != 0
+			|| meshlet.firstIndex + meshlet.indexCount > indices.size())
+		{
+			LogCheckFailure(name + " does not continue the index buffer where the last one ended!");
+			return false;
+		}
+		nextIndex = meshlet.firstIndex + meshlet.indexCount;
+
+		referenced.assign(
+			indices.begin() + meshlet.firstIndex,
+			indices.begin() + meshlet.firstIndex + meshlet.indexCount);
+		sort(referenced.begin(), referenced.end());
+		referenced.erase(unique(referenced.begin(), referenced.end()), referenced.end());
+
+		if (meshlet.indexCount / 3 > MESHLET_MAX_TRIANGLES
+			|| referenced.size() > MESHLET_MAX_VERTICES
+			|| referenced.size() != meshlet.vertexCount)
+		{
+			LogCheckFailure(name + " has " + to_string(meshlet.indexCount / 3) + " triangles and "
+				+ to_string(referenced.size()) + " vertices, it reports " + to_string(meshlet.vertexCount)
+				+ " and the limits are " + to_string(MESHLET_MAX_TRIANGLES) + " and " + to_string(MESHLET_MAX_VERTICES) + "!");
+			return false;
+		}
+
+		for (u32 index : referenced)
+		{
+			const f32* p = vertices[index].position;
+			vec3 d = vec3(p[0], p[1], p[2]) - meshlet.center;
+
+			if (length(d) > meshlet.radius * 1.0001f + 1e-6f)
+			{
+				LogCheckFailure(name + " has a vertex outside its bounding sphere!");
+				return false;
+			}
+		}
+	}
+
+	if (nextIndex != indices.size())
+	{
+		LogCheckFailure("meshlets end at index " + to_string(nextIndex) + " of " + to_string(indices.size()) + "!");
+		return false;
+	}
+
+	return true;
+}
+
+bool CheckFlatGrid()
+{
+	//128x128 quads on z 0, counter clockwise seen from +z, so every meshlet has a zero width cone
+	const u32 cells = 128;
+
+	vector<Vertex> vertices{};
+	vector<u32> indices{};
+
+	for (u32 y = 0; y <= cells; ++y)
+	{
+		for (u32 x = 0; x <= cells; ++x)
+		{
+			Vertex v{};
+			v.position[0] = scast<f32>(x) / cells - 0.5f;
+			v.position[1] = scast<f32>(y) / cells - 0.5f;
+			v.normal[2] = 1.0f;
+			vertices.push_back(v);
+		}
+	}
+
+	for (u32 y = 0; y < cells; ++y)
+	{
+		for (u32 x = 0; x < cells; ++x)
+		{
+			u32 a = y * (cells + 1) + x;
+			indices.insert(indices.end(), { a, a + 1, a + cells + 2, a, a + cells + 2, a + cells + 1 });
+		}
+	}
+
+	vector<Meshlet> meshlets = MeshletBuilder::Build(vertices, indices);
+	if (!CheckMeshlets(vertices, indices, meshlets)) return false;
+
+	mat4 projection = perspective(vec2(1920.0f, 1080.0f), 90.0f, 0.01f, 100.0f);
+	mat4 model{};
+
+	vector<MeshletDrawRange> ranges{};
+	MeshletCullStats stats{};
+
+	vec3 back(0.0f, 0.0f, -2.0f);
+	MeshletCuller::Cull(
+		meshlets,
+		projection * view(back, vec3(0.0f), vec3(0.0f, 1.0f, 0.0f)),
+		model,
+		back,
+		true,
+		ranges,
+		&stats);
+
+	if (stats.coneCulled != meshlets.size()
+		|| !ranges.empty())
+	{
+		LogCheckFailure("flat grid seen from behind: " + to_string(stats.coneCulled) + " of "
+			+ to_string(meshlets.size()) + " meshlets were cone culled!");
+		return false;
+	}
+
+	vec3 front(0.0f, 0.0f, 2.0f);
+	MeshletCuller::Cull(
+		meshlets,
+		projection * view(front, vec3(0.0f), vec3(0.0f, 1.0f, 0.0f)),
+		model,
+		front,
+		true,
+		ranges,
+		&stats);
+
+	if (stats.coneCulled != 0
+		|| stats.frustumCulled != 0
+		|| ranges.size() != 1
+		|| ranges[0].firstIndex != 0
+		|| ranges[0].indexCount != indices.size())
+	{
+		LogCheckFailure("flat grid seen from the front: " + to_string(stats.coneCulled) + " cone and "
+			+ to_string(stats.frustumCulled) + " frustum culled meshlets, drawn in " + to_string(ranges.size()) + " ranges!");
+		return false;
+	}
+
+	//backface culling disabled, the back view has to draw everything too
+	MeshletCuller::Cull(
+		meshlets,
+		projection * view(back, vec3(0.0f), vec3(0.0f, 1.0f, 0.0f)),
+		model,
+		back,
+		false,
+		ranges,
+		&stats);
+
+	if (stats.coneCulled != 0
+		|| ranges.size() != 1)
+	{
+		LogCheckFailure("flat grid seen from behind without cone culling still culled "
+			+ to_string(stats.coneCulled) + " meshlets!");
+		return false;
+	}
+
+	return true;
+}
+
+bool CheckCull(
+	const string& name,
+	const vector<Vertex>& vertices,
+	const vector<u32>& indices,
+	const vector<Meshlet>& meshlets,
+	const mat4& viewProjection,
+	const vec3& cameraPos,
+	const vector<MeshletDrawRange>& ranges,
+	const MeshletCullStats& stats)
+{
+	auto GetPos = [&vertices](u32 index)
+		{
+			const f32* p = vertices[index].position;
+			return vec3(p[0], p[1], p[2]);
+		};
+
+	const mat4& m = viewProjection;
+
+	size_t range{};
+	u32 drawnCount{};
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const Meshlet& meshlet = meshlets[i];
+
+		while (range < ranges.size()
+			&& ranges[range].firstIndex + ranges[range].indexCount <= meshlet.firstIndex)
+		{
+			++range;
+		}
+
+		if (range < ranges.size()
+			&& ranges[range].firstIndex <= meshlet.firstIndex)
+		{
+			++drawnCount;
+			continue;
+		}
+
+		//counts of vertices outside each clip plane, all of them outside one plane means off screen
+		u32 vertexCount{};
+		u32 outside[6]{};
+
+		bool hasFrontFace{};
+
+		for (u32 t = meshlet.firstIndex; t < meshlet.firstIndex + meshlet.indexCount; t += 3)
+		{
+			vec3 a = GetPos(indices[t]);
+			vec3 b = GetPos(indices[t + 1]);
+			vec3 c = GetPos(indices[t + 2]);
+
+			vec3 toCamera = cameraPos - a;
+			if (dot(cross(b - a, c - a), toCamera) > 1e-5f * length(toCamera)) hasFrontFace = true;
+
+			for (const vec3& p : { a, b, c })
+			{
+				vec4 clip(
+					m.m00 * p.x + m.m01 * p.y + m.m02 * p.z + m.m03,
+					m.m10 * p.x + m.m11 * p.y + m.m12 * p.z + m.m13,
+					m.m20 * p.x + m.m21 * p.y + m.m22 * p.z + m.m23,
+					m.m30 * p.x + m.m31 * p.y + m.m32 * p.z + m.m33);
+
+				++vertexCount;
+				if (clip.x < -clip.w) ++outside[0];
+				if (clip.x > clip.w) ++outside[1];
+				if (clip.y < -clip.w) ++outside[2];
+				if (clip.y > clip.w) ++outside[3];
+				if (clip.z < -clip.w) ++outside[4];
+				if (clip.z > clip.w) ++outside[5];
+			}
+		}
+
+		bool isOffScreen{};
+		for (u32 count : outside)
+		{
+			if (count == vertexCount) isOffScreen = true;
+		}
+
+		if (!isOffScreen
+			&& hasFrontFace)
+		{
+			LogCheckFailure(name + ": meshlet " + to_string(i) + " was culled but has a front facing triangle in view!");
+			return false;
+		}
+	}
+
+	if (drawnCount + stats.frustumCulled + stats.coneCulled != stats.meshletCount
+		|| stats.meshletCount != meshlets.size()
+		|| stats.rangeCount != ranges.size())
+	{
+		LogCheckFailure(name + ": " + to_string(drawnCount) + " drawn, " + to_string(stats.frustumCulled)
+			+ " frustum and " + to_string(stats.coneCulled) + " cone culled meshlets don't add up to "
+			+ to_string(stats.meshletCount) + "!");
+		return false;
+	}
+
+	return true;
+}
+
+void LogCheckFailure(const string& message)
+{
+	Log::Print(
+		message,
+		"MESHLET_BENCH",
+		LogType::LOG_ERROR,
+		2);
+}
@@ -0,0 +1,306 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  model-index-test
+//
+//writes a 1024 block .kmd library to the temp directory, indexes it with ModelIndex and checks:
+//  names   - every block is indexed under its node and mesh name, unknown names find nothing
+//  by name - five props found with FindNode read back with ReadBlocks match what was written
+//  pattern - FindMatching returns every block a '*' or '?' pattern matches, in table order
+//  file    - GetFile carries the tables and the same content hash ImportFile would use
+//  errors  - out of range indices and a closed index are rejected
+//exits with 1 if any check fails
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <cstdio>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+#include "KalaHeaders/export_kmd.hpp"
+
+#include "graphics/model_index.hpp"
+#include "core/content_hash.hpp"
+#include "core/asset_pack.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaModelData::Vertex;
+using KalaHeaders::KalaModelData::ModelBlock;
+using KalaHeaders::KalaModelData::ModelTable;
+using KalaHeaders::KalaModelData::ExportKMD;
+using KalaHeaders::KalaModelData::ExportResult;
+using KalaHeaders::KalaModelData::ExportResultToString;
+
+using GameTest::Graphics::ModelIndex;
+using GameTest::Core::ContentHash;
+using GameTest::Core::AssetPack;
+using GameTest::GameObject::MeshFile;
+
+using std::string;
+using std::vector;
+using std::to_string;
+using std::snprintf;
+using std::error_code;
+using std::filesystem::path;
+using std::filesystem::temp_directory_path;
+using std::filesystem::remove;
+
+//blocks in the generated library, every fourth one is a rock and the rest are crates
+constexpr u32 LIBRARY_BLOCK_COUNT = 1024u;
+
+static u32 failures{};
+
+static void Check(
+	bool condition,
+	const string& what);
+
+//small box-like block whose vertex and index values all depend on index
+static ModelBlock CreateBlock(u32 index);
+
+//true if block holds the same names and geometry as the one CreateBlock made for index
+static bool MatchesBlock(
+	const ModelBlock& block,
+	u32 index);
+
+int main()
+{
+	path libraryPath = temp_directory_path() / "model_index_test.kmd";
+
+	vector<ModelBlock> library{};
+	library.reserve(LIBRARY_BLOCK_COUNT);
+	for (u32 i = 0; i < LIBRARY_BLOCK_COUNT; ++i)
+	{
+		library.push_back(CreateBlock(i));
+	}
+
+	ExportResult exportResult = ExportKMD(libraryPath, library);
+	if (exportResult != ExportResult::RESULT_SUCCESS)
+	{
+		Log::Print(
+			"Failed to write test library '" + libraryPath.string() + "'! Reason: " + ExportResultToString(exportResult),
+			"MODEL_INDEX_TEST",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	ModelIndex index{};
+
+	string openResult = index.Open(libraryPath);
+	Check(openResult.empty(), "open: " + openResult);
+	Check(index.IsOpen(), "open: index is not open");
+	Check(index.GetEntries().size() == LIBRARY_BLOCK_COUNT, "open: indexed " + to_string(index.GetEntries().size()) + " blocks");
+
+	//names
+	for (u32 i = 0; i < index.GetEntries().size(); ++i)
+	{
+		const ModelBlock& b = library[i];
+
+		const vector<u32>& byNode = index.FindNode(b.nodeName);
+		const vector<u32>& byMesh = index.FindMesh(b.meshName);
+
+		if (byNode.size() != 1
+			|| byNode[0] != i
+			|| byMesh.size() != 1
+			|| byMesh[0] != i)
+		{
+			Check(false, "names: block " + to_string(i) + " is not indexed under '" + b.nodeName + "' and '" + b.meshName + "'");
+			break;
+		}
+	}
+	Check(index.FindNode("prop_9999").empty(), "names: unknown node name found a block");
+	Check(index.FindMesh("prop_0001").empty(), "names: node name found as a mesh name");
+
+	//by name
+	{
+		vector<u32> wanted{};
+		for (const char* name : { "prop_0003", "prop_0100", "prop_0511", "prop_0777", "prop_1023" })
+		{
+			const vector<u32>& found = index.FindNode(name);
+			Check(found.size() == 1, string("by name: '") + name + "' found " + to_string(found.size()) + " blocks");
+
+			if (!found.empty()) wanted.push_back(found[0]);
+		}
+
+		vector<ModelBlock> blocks{};
+		string readResult = index.ReadBlocks(wanted, blocks);
+		Check(readResult.empty(), "by name: " + readResult);
+		Check(blocks.size() == wanted.size(), "by name: read " + to_string(blocks.size()) + " of " + to_string(wanted.size()) + " blocks");
+
+		for (size_t i = 0; i < blocks.size() && i < wanted.size(); ++i)
+		{
+			Check(MatchesBlock(blocks[i], wanted[i]), "by name: block " + to_string(wanted[i]) + " differs from what was written");
+		}
+	}
+
+	//pattern
+	{
+		vector<u32> rocks = index.FindMatching("rock_*");
+		bool isRocksCorrect = rocks.size() == LIBRARY_BLOCK_COUNT / 4;
+		for (size_t i = 0; isRocksCorrect && i < rocks.size(); ++i)
+		{
+			isRocksCorrect = rocks[i] == i * 4;
+		}
+		Check(isRocksCorrect, "pattern: 'rock_*' matched " + to_string(rocks.size()) + " blocks instead of every fourth one");
+
+		vector<u32> sevens = index.FindMatching("prop_00?7");
+		bool isSevensCorrect = sevens.size() == 10;
+		for (size_t i = 0; isSevensCorrect && i < sevens.size(); ++i)
+		{
+			isSevensCorrect = sevens[i] == i * 10 + 7;
+		}
+		Check(isSevensCorrect, "pattern: 'prop_00?7' matched " + to_string(sevens.size()) + " blocks instead of 10");
+
+		Check(index.FindMatching("*").size() == LIBRARY_BLOCK_COUNT, "pattern: '*' did not match every block");
+		Check(index.FindMatching("rock_?").empty(), "pattern: 'rock_?' matched a longer name");
+
+		vector<ModelBlock> blocks{};
+		string readResult = index.ReadBlocks(sevens, blocks);
+		Check(readResult.empty(), "pattern: " + readResult);
+
+		for (size_t i = 0; i < blocks.size() && i < sevens.size(); ++i)
+		{
+			Check(MatchesBlock(blocks[i], sevens[i]), "pattern: block " + to_string(sevens[i]) + " differs from what was written");
+		}
+	}
+
+	//file
+	{
+		vector<u8> bytes{};
+		string readResult = AssetPack::ReadBinary(libraryPath, bytes);
+		Check(readResult.empty(), "file: " + readResult);
+
+		u64 expectedHash = ContentHash::HashBytes(
+			bytes.data(),
+			bytes.size());
+
+		vector<u32> wanted = { 2, 64, 1000 };
+		MeshFile file = index.GetFile(wanted);
+
+		Check(file.path == libraryPath.string(), "file: path is '" + file.path + "'");
+		Check(file.hash != 0, "file: hash was left at 0");
+		Check(file.hash == expectedHash, "file: hash differs from the content hash of the whole file");
+		Check(index.GetHash() == file.hash, "file: hash changed between calls");
+		Check(file.tables.size() == wanted.size(), "file: got " + to_string(file.tables.size()) + " tables");
+
+		for (size_t i = 0; i < file.tables.size(); ++i)
+		{
+			const ModelTable& expected = index.GetEntries()[wanted[i]].table;
+
+			Check(file.tables[i].blockOffset == expected.blockOffset
+				&& file.tables[i].blockSize == expected.blockSize,
+				"file: table " + to_string(i) + " does not point at block " + to_string(wanted[i]));
+		}
+	}
+
+	//errors
+	{
+		vector<ModelBlock> blocks{};
+		Check(!index.ReadBlocks({ 0, LIBRARY_BLOCK_COUNT }, blocks).empty(), "errors: out of range index was read");
+		Check(blocks.empty(), "errors: failed read still returned blocks");
+
+		index.Close();
+		Check(!index.IsOpen(), "errors: index is still open after Close");
+		Check(index.GetHash() == 0, "errors: closed index still has a hash");
+		Check(!index.ReadBlocks({ 0 }, blocks).empty(), "errors: closed index read a block");
+
+		ModelIndex missing{};
+		Check(!missing.Open(temp_directory_path() / "model_index_test_missing.kmd").empty(), "errors: missing file was indexed");
+	}
+
+	error_code ec{};
+	remove(libraryPath, ec);
+
+	if (failures > 0)
+	{
+		Log::Print(
+			to_string(failures) + " model index checks failed!",
+			"MODEL_INDEX_TEST",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	Log::Print(
+		"all model index checks passed",
+		"MODEL_INDEX_TEST",
+		LogType::LOG_SUCCESS);
+
+	return 0;
+}
+
+void Check(
+	bool condition,
+	const string& what)
+{
+	if (condition) return;
+
+	++failures;
+
+	Log::Print(
+		what,
+		"MODEL_INDEX_TEST",
+		LogType::LOG_ERROR,
+		2);
+}
+
+ModelBlock CreateBlock(u32 index)
+{
+	ModelBlock b{};
+
+	snprintf(b.nodeName, sizeof(b.nodeName), "prop_%04u", index);
+	snprintf(b.meshName, sizeof(b.meshName), index % 4 == 0 ? "rock_%04u" : "crate_%04u", index);
+
+	b.rotation[0] = 1.0f;
+	b.size[0] = 1.0f;
+	b.size[1] = 1.0f;
+	b.size[2] = 1.0f;
+
+	for (u32 v = 0; v < 8; ++v)
+	{
+		Vertex vertex{};
+		vertex.position[0] = scast<f32>(index);
+		vertex.position[1] = scast<f32>(v);
+		vertex.position[2] = scast<f32>(index * 8 + v);
+		b.vertices.push_back(vertex);
+	}
+
+	for (u32 i = 0; i < 12; ++i)
+	{
+		b.indices.push_back((index + i) % 8);
+	}
+
+	return b;
+}
+
+bool MatchesBlock(
+	const ModelBlock& block,
+	u32 index)
+{
+	ModelBlock expected = CreateBlock(index);
+
+	if (string(block.nodeName) != expected.nodeName
+		|| string(block.meshName) != expected.meshName
+		|| block.vertices.size() != expected.vertices.size()
+		|| block.indices != expected.indices)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < block.vertices.size(); ++i)
+	{
+		for (u32 c = 0; c < 3; ++c)
+		{
+			if (block.vertices[i].position[c] != expected.vertices[i].position[c]) return false;
+		}
+	}
+
+	return true;
+}
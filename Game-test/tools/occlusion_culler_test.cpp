@@ -0,0 +1,308 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  occlusion-culler-test
+//
+//runs OcclusionCuller without a window or gl context against a camera at z 5 looking down -z
+//at a 4x4 wall on z 0, and checks:
+//  occluded   - a box right behind the wall is hidden and a finely split wall leaves no
+//               pixel uncovered along the edges its triangles share
+//  visible    - boxes in front of the wall, beside it or poking out past its edge are kept
+//  backface   - the same wall wound the other way adds no triangles and hides nothing
+//  off screen - boxes behind the camera, past the far plane or to the side are rejected,
+//               a box crossing the near plane is kept
+//  workers    - rasterizing on a thread pool gives the same depth buffer as running inline
+//  occluder   - BuildOccluder keeps the largest triangles with their winding
+//exits with 1 if any check fails
+
+#include <string>
+#include <vector>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+#include "KalaHeaders/import_kmd.hpp"
+
+#include "graphics/occlusion_culler.hpp"
+#include "core/thread_pool.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec2;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::mat4;
+using KalaHeaders::KalaMath::perspective;
+using KalaHeaders::KalaMath::view;
+using KalaHeaders::KalaModelData::Vertex;
+
+using GameTest::Graphics::OcclusionCuller;
+using GameTest::Graphics::OccluderMesh;
+using GameTest::Core::ThreadPool;
+
+using std::string;
+using std::vector;
+using std::to_string;
+
+static u32 failures{};
+
+static void Check(
+	bool condition,
+	const string& what);
+
+//camera at z 5 looking at the origin with a 90 degree field of view
+static mat4 GetViewProjection();
+
+//4x4 quad on z 0 split into cells x cells quads,
+//counter clockwise seen from the camera unless isFlipped
+static OccluderMesh CreateWall(
+	bool isFlipped = false,
+	u32 cells = 1);
+
+//unit cube centered on center, as a model space box with an identity model
+static bool IsCubeVisible(
+	const OcclusionCuller& culler,
+	const vec3& center,
+	f32 halfSize = 0.5f);
+
+static void TestOccluded();
+static void TestVisible();
+static void TestBackface();
+static void TestOffScreen();
+static void TestWorkers();
+static void TestBuildOccluder();
+
+int main()
+{
+	TestOccluded();
+	TestVisible();
+	TestBackface();
+	TestOffScreen();
+	TestWorkers();
+	TestBuildOccluder();
+
+	if (failures > 0)
+	{
+		Log::Print(
+			to_string(failures) + " occlusion culler checks failed!",
+			"OCCLUSION_CULLER_TEST",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	Log::Print(
+		"all occlusion culler checks passed",
+		"OCCLUSION_CULLER_TEST",
+		LogType::LOG_SUCCESS);
+
+	return 0;
+}
+
+void TestOccluded()
+{
+	OcclusionCuller culler{};
+	culler.BeginFrame(GetViewProjection());
+	culler.AddOccluder(CreateWall(), mat4{});
+	culler.Rasterize();
+
+	Check(culler.GetTriangleCount() == 2, "occluded: wall queued " + to_string(culler.GetTriangleCount()) + " triangles");
+
+	Check(!IsCubeVisible(culler, vec3(0.0f, 0.0f, -5.0f)), "occluded: box behind the wall is visible");
+	Check(!IsCubeVisible(culler, vec3(0.0f, 0.0f, -1.0f), 0.25f), "occluded: box touching the back of the wall is visible");
+	Check(!IsCubeVisible(culler, vec3(1.0f, -1.0f, -3.0f), 0.25f), "occluded: box behind a corner of the wall is visible");
+
+	//the wall covers x and y from -2 to 2 at distance 5 with a 90 degree field of view,
+	//so a fifth of the buffer height each way from the center
+	OcclusionCuller splitCuller{};
+	splitCuller.BeginFrame(GetViewProjection());
+	splitCuller.AddOccluder(CreateWall(false, 16), mat4{});
+	splitCuller.Rasterize();
+
+	u32 w = splitCuller.GetWidth();
+	u32 h = splitCuller.GetHeight();
+	f32 halfExtent = 0.2f * h;
+
+	u32 holes{};
+	for (u32 y = scast<u32>(h * 0.5f - halfExtent) + 1; y + 1 < scast<u32>(h * 0.5f + halfExtent); ++y)
+	{
+		for (u32 x = scast<u32>(w * 0.5f - halfExtent) + 1; x + 1 < scast<u32>(w * 0.5f + halfExtent); ++x)
+		{
+			if (splitCuller.GetDepth()[scast<size_t>(y) * w + x] >= 1.0f) ++holes;
+		}
+	}
+	Check(holes == 0, "occluded: split wall left " + to_string(holes) + " pixels uncovered");
+}
+
+void TestVisible()
+{
+	OcclusionCuller culler{};
+	culler.BeginFrame(GetViewProjection());
+	culler.AddOccluder(CreateWall(), mat4{});
+	culler.Rasterize();
+
+	Check(IsCubeVisible(culler, vec3(0.0f, 0.0f, 2.0f)), "visible: box in front of the wall is hidden");
+	Check(IsCubeVisible(culler, vec3(6.0f, 0.0f, -5.0f)), "visible: box beside the wall is hidden");
+	Check(IsCubeVisible(culler, vec3(0.0f, 2.0f, -1.0f)), "visible: box poking out past the top edge is hidden");
+	Check(IsCubeVisible(culler, vec3(0.0f, 0.0f, -0.25f), 0.5f), "visible: box through the wall is hidden");
+}
+
+void TestBackface()
+{
+	OcclusionCuller culler{};
+	culler.BeginFrame(GetViewProjection());
+	culler.AddOccluder(CreateWall(true), mat4{});
+	culler.Rasterize();
+
+	Check(culler.GetTriangleCount() == 0, "backface: flipped wall queued " + to_string(culler.GetTriangleCount()) + " triangles");
+
+	bool isDepthClear = true;
+	for (f32 d : culler.GetDepth())
+	{
+		if (d != 1.0f)
+		{
+			isDepthClear = false;
+			break;
+		}
+	}
+	Check(isDepthClear, "backface: flipped wall wrote depth");
+
+	Check(IsCubeVisible(culler, vec3(0.0f, 0.0f, -5.0f)), "backface: box behind the flipped wall is hidden");
+}
+
+void TestOffScreen()
+{
+	//nothing rasterized, so only the frustum can reject a box
+	OcclusionCuller culler{};
+	culler.BeginFrame(GetViewProjection());
+	culler.Rasterize();
+
+	Check(IsCubeVisible(culler, vec3(0.0f)), "off screen: box in view is hidden");
+	Check(!IsCubeVisible(culler, vec3(0.0f, 0.0f, 10.0f)), "off screen: box behind the camera is visible");
+	Check(!IsCubeVisible(culler, vec3(0.0f, 0.0f, -200.0f)), "off screen: box past the far plane is visible");
+	Check(!IsCubeVisible(culler, vec3(50.0f, 0.0f, 0.0f)), "off screen: box right of the view is visible");
+	Check(!IsCubeVisible(culler, vec3(0.0f, -50.0f, 0.0f)), "off screen: box below the view is visible");
+	Check(IsCubeVisible(culler, vec3(0.0f, 0.0f, 5.0f)), "off screen: box around the camera is hidden");
+}
+
+void TestWorkers()
+{
+	//a tilted wall so the depth changes across every band
+	mat4 model(
+		0.8f, 0.0f, 0.6f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		-0.6f, 0.0f, 0.8f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f);
+
+	OcclusionCuller inlineCuller{};
+	inlineCuller.BeginFrame(GetViewProjection());
+	inlineCuller.AddOccluder(CreateWall(), model);
+	inlineCuller.Rasterize();
+
+	ThreadPool workers(4);
+
+	OcclusionCuller pooledCuller{};
+	pooledCuller.BeginFrame(GetViewProjection());
+	pooledCuller.AddOccluder(CreateWall(), model);
+	pooledCuller.Rasterize(&workers);
+
+	Check(inlineCuller.GetDepth() == pooledCuller.GetDepth(), "workers: pooled depth differs from inline depth");
+}
+
+void TestBuildOccluder()
+{
+	//the wall plus a sliver that should be the first triangle dropped
+	vector<Vertex> vertices(6);
+	const f32 positions[6][3] =
+	{
+		{ -2.0f, -2.0f, 0.0f }, { 2.0f, -2.0f, 0.0f }, { 2.0f, 2.0f, 0.0f }, { -2.0f, 2.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f }, { 0.01f, 0.0f, 1.0f }
+	};
+	for (u32 i = 0; i < 6; ++i)
+	{
+		for (u32 c = 0; c < 3; ++c) vertices[i].position[c] = positions[i][c];
+	}
+
+	vector<u32> indices = { 4, 5, 0, 0, 1, 2, 0, 2, 3 };
+
+	OccluderMesh mesh = OcclusionCuller::BuildOccluder(vertices, indices, 2);
+	Check(mesh.indices.size() == 6, "occluder: kept " + to_string(mesh.indices.size() / 3) + " triangles instead of 2");
+	Check(mesh.positions.size() == 4, "occluder: kept " + to_string(mesh.positions.size()) + " vertices instead of 4");
+
+	OcclusionCuller culler{};
+	culler.BeginFrame(GetViewProjection());
+	culler.AddOccluder(mesh, mat4{});
+	culler.Rasterize();
+
+	Check(culler.GetTriangleCount() == 2, "occluder: simplified wall lost its winding");
+	Check(!IsCubeVisible(culler, vec3(0.0f, 0.0f, -5.0f)), "occluder: simplified wall hides nothing");
+}
+
+void Check(
+	bool condition,
+	const string& what)
+{
+	if (condition) return;
+
+	++failures;
+
+	Log::Print(
+		what,
+		"OCCLUSION_CULLER_TEST",
+		LogType::LOG_ERROR,
+		2);
+}
+
+mat4 GetViewProjection()
+{
+	mat4 projection = perspective(vec2(320.0f, 192.0f), 90.0f, 0.1f, 100.0f);
+
+	return projection * view(vec3(0.0f, 0.0f, 5.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f));
+}
+
+OccluderMesh CreateWall(
+	bool isFlipped,
+	u32 cells)
+{
+	OccluderMesh mesh{};
+
+	for (u32 y = 0; y <= cells; ++y)
+	{
+		for (u32 x = 0; x <= cells; ++x)
+		{
+			mesh.positions.push_back(vec3(
+				-2.0f + 4.0f * x / cells,
+				-2.0f + 4.0f * y / cells,
+				0.0f));
+		}
+	}
+
+	for (u32 y = 0; y < cells; ++y)
+	{
+		for (u32 x = 0; x < cells; ++x)
+		{
+			u32 a = y * (cells + 1) + x;
+			u32 b = a + 1;
+			u32 c = a + cells + 2;
+			u32 d = a + cells + 1;
+
+			if (isFlipped) mesh.indices.insert(mesh.indices.end(), { a, c, b, a, d, c });
+			else mesh.indices.insert(mesh.indices.end(), { a, b, c, a, c, d });
+		}
+	}
+
+	return mesh;
+}
+
+bool IsCubeVisible(
+	const OcclusionCuller& culler,
+	const vec3& center,
+	f32 halfSize)
+{
+	return culler.IsVisible(
+		center - vec3(halfSize),
+		center + vec3(halfSize),
+		mat4{});
+}
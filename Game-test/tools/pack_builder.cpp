@@ -0,0 +1,111 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  pack-builder <source dir> <target pack> [--store] [--verify]
+//  pack-builder --verify <target pack>
+//
+//  --store  - disables per-entry compression
+//  --verify - reads back every entry and checks its content hash
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "core/asset_pack.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using GameTest::Core::AssetPack;
+using GameTest::Core::PackBuildSettings;
+
+using std::string;
+using std::vector;
+using std::filesystem::path;
+
+static int Verify(const path& packPath)
+{
+	string result = AssetPack::VerifyPack(packPath);
+	if (!result.empty())
+	{
+		Log::Print(
+			result,
+			"PACK_BUILDER",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	Log::Print(
+		"Verified pack '" + packPath.string() + "'.",
+		"PACK_BUILDER",
+		LogType::LOG_SUCCESS);
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	vector<string> positional{};
+	bool verify{};
+
+	PackBuildSettings settings{};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+
+		if (arg == "--store") settings.compress = false;
+		else if (arg == "--verify") verify = true;
+		else positional.push_back(arg);
+	}
+
+	if (verify
+		&& positional.size() == 1)
+	{
+		return Verify(positional[0]);
+	}
+
+	if (positional.size() != 2)
+	{
+		Log::Print(
+			"usage: pack-builder <source dir> <target pack> [--store] [--verify]",
+			"PACK_BUILDER",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	path sourceDir = positional[0];
+	path targetPack = positional[1];
+
+	string result = AssetPack::BuildPack(
+		sourceDir,
+		targetPack,
+		settings);
+
+	if (!result.empty())
+	{
+		Log::Print(
+			result,
+			"PACK_BUILDER",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	Log::Print(
+		"Built pack '" + targetPack.string() + "' from '" + sourceDir.string() + "'.",
+		"PACK_BUILDER",
+		LogType::LOG_SUCCESS);
+
+	return verify ? Verify(targetPack) : 0;
+}
@@ -0,0 +1,213 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  particle-bench [--particles N] [--frames N] [--threads N]
+//
+//  --particles N - pool size, defaults to 1048576
+//  --frames N    - simulated frames at 60 fps, defaults to 300
+//  --threads N   - worker threads, 0 uses one per hardware thread and 1 runs without a pool
+//
+//runs without a window or gl context, fills the pool and keeps it full with a spawn rate
+//that matches the average particle life, then reports per frame:
+//  update - ParticleEmitter::Update, simulation, compaction and spawning
+//  write  - ParticleEmitter::WriteInstances into a buffer the size of the pool
+//exits with 1 before benchmarking if the compaction checks fail
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "core/thread_pool.hpp"
+#include "graphics/particle_emitter.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::vec4;
+
+using GameTest::Core::ThreadPool;
+using GameTest::Graphics::ParticleEmitter;
+using GameTest::Graphics::ParticleEmitterSettings;
+using GameTest::Graphics::ParticleInstance;
+using GameTest::Graphics::PARTICLE_CHUNK_SIZE;
+
+using std::string;
+using std::vector;
+using std::unique_ptr;
+using std::make_unique;
+using std::ostringstream;
+using std::fixed;
+using std::setprecision;
+using std::stoul;
+using std::to_string;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+static f64 GetSeconds(steady_clock::time_point start);
+
+//Kills only the last particle of a full chunk, compaction must stop at the alive ones
+static bool CheckTailDeath();
+
+int main(int argc, char* argv[])
+{
+	u32 particles = 1u << 20;
+	u32 frames = 300;
+	u32 threads = 0;
+	bool isValid = true;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+
+		u32* target = nullptr;
+		if (arg == "--particles") target = &particles;
+		else if (arg == "--frames") target = &frames;
+		else if (arg == "--threads") target = &threads;
+
+		if (!target
+			|| i + 1 >= argc)
+		{
+			isValid = false;
+			break;
+		}
+
+		try { *target = scast<u32>(stoul(argv[++i])); }
+		catch (...) { isValid = false; }
+	}
+
+	if (!isValid
+		|| particles == 0
+		|| frames == 0)
+	{
+		Log::Print(
+			"usage: particle-bench [--particles N] [--frames N] [--threads N]",
+			"PARTICLE_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	if (!CheckTailDeath()) return 1;
+
+	unique_ptr<ThreadPool> workers{};
+	if (threads != 1) workers = make_unique<ThreadPool>(threads);
+
+	const f32 deltaTime = 1.0f / 60.0f;
+
+	ParticleEmitterSettings settings{};
+	settings.spawnExtents = vec3(1.0f);
+	settings.velocityMin = vec3(-2.0f, 4.0f, -2.0f);
+	settings.velocityMax = vec3(2.0f, 8.0f, 2.0f);
+	settings.drag = 0.2f;
+	settings.lifeMin = 1.0f;
+	settings.lifeMax = 3.0f;
+	settings.startColor = vec4(1.0f, 0.8f, 0.3f, 1.0f);
+	settings.endColor = vec4(0.8f, 0.1f, 0.0f, 0.0f);
+	settings.startSize = 0.05f;
+	settings.endSize = 0.2f;
+	settings.maxParticles = particles;
+	//particles live 2 seconds on average
+	settings.spawnRate = particles * 0.5f;
+
+	ParticleEmitter emitter(settings);
+	emitter.Burst(emitter.GetCapacity());
+	emitter.Update(0.0f, workers.get());
+
+	vector<ParticleInstance> instances(emitter.GetCapacity());
+
+	f64 updateSeconds{};
+	f64 writeSeconds{};
+	u64 simulated{};
+
+	for (u32 f = 0; f < frames; ++f)
+	{
+		simulated += emitter.GetAliveCount();
+
+		auto updateStart = steady_clock::now();
+		emitter.Update(deltaTime, workers.get());
+		updateSeconds += GetSeconds(updateStart);
+
+		auto writeStart = steady_clock::now();
+		emitter.WriteInstances(instances.data(), workers.get());
+		writeSeconds += GetSeconds(writeStart);
+	}
+
+	ostringstream oss{};
+	oss << fixed << setprecision(3)
+		<< emitter.GetCapacity() << " particle pool, "
+		<< (workers ? workers->GetThreadCount() : 1u) << " threads, "
+		<< simulated / frames << " alive on average"
+		<< " | update " << updateSeconds * 1000.0 / frames << " ms"
+		<< " | write " << writeSeconds * 1000.0 / frames << " ms"
+		<< " | " << setprecision(1) << simulated / updateSeconds / 1'000'000.0 << " M particles/s"
+		<< " | " << emitter.GetDroppedCount() << " dropped spawns";
+
+	Log::Print(oss.str(), "PARTICLE_BENCH", LogType::LOG_INFO);
+
+	return 0;
+}
+
+f64 GetSeconds(steady_clock::time_point start)
+{
+	return duration<f64>(steady_clock::now() - start).count();
+}
+
+bool CheckTailDeath()
+{
+	ParticleEmitterSettings settings{};
+	settings.lifeMin = 10.0f;
+	settings.lifeMax = 10.0f;
+	settings.maxParticles = PARTICLE_CHUNK_SIZE;
+
+	ParticleEmitter emitter(settings);
+	emitter.Burst(PARTICLE_CHUNK_SIZE - 1);
+	emitter.Update(0.0f);
+
+	//the last slot gets the only short lived particle
+	settings.lifeMin = 0.5f;
+	settings.lifeMax = 0.5f;
+	emitter.SetSettings(settings);
+	emitter.Burst(1);
+	emitter.Update(0.0f);
+
+	bool isFull = emitter.GetAliveCount() == PARTICLE_CHUNK_SIZE;
+
+	emitter.Update(0.6f);
+
+	vector<ParticleInstance> instances(emitter.GetAliveCount());
+	emitter.WriteInstances(instances.data());
+
+	//start and end size match, so survivors that were moved wrongly would show up as garbage sizes
+	bool isIntact = true;
+	for (const ParticleInstance& instance : instances)
+	{
+		if (instance.size != settings.startSize) isIntact = false;
+	}
+
+	if (!isFull
+		|| emitter.GetAliveCount() != PARTICLE_CHUNK_SIZE - 1
+		|| !isIntact)
+	{
+		Log::Print(
+			"compaction after the last particle of a full chunk died left "
+			+ to_string(emitter.GetAliveCount()) + " particles alive, expected "
+			+ to_string(PARTICLE_CHUNK_SIZE - 1) + "!",
+			"PARTICLE_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return false;
+	}
+
+	return true;
+}
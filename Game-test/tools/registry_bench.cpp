@@ -0,0 +1,261 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  registry-bench [--objects N] [--span N] [--max-threads N] [--duration N] [--publish N]
+//
+//  --objects N     - registry size, defaults to 4096
+//  --span N        - objects visited per read, defaults to 64
+//  --max-threads N - reader threads go 1, 2, 4 ... up to this, defaults to 32
+//  --duration N    - milliseconds per run, defaults to 500
+//  --publish N     - microseconds between writer changes, defaults to 1000
+//
+//one writer thread keeps replacing the oldest object while the readers sum a field
+//over a span of the content list, every reader count runs twice:
+//  snapshot     - Registry<T>::ReadSnapshot, writer calls PublishSnapshot after each change
+//  shared_mutex - readers take a shared lock around the span, writer an exclusive one
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <shared_mutex>
+#include <mutex>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "core/registry.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using GameTest::Core::Registry;
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::unique_ptr;
+using std::make_unique;
+using std::thread;
+using std::atomic;
+using std::shared_mutex;
+using std::shared_lock;
+using std::unique_lock;
+using std::ostringstream;
+using std::fixed;
+using std::setprecision;
+using std::stoul;
+using std::chrono::steady_clock;
+using std::chrono::milliseconds;
+using std::chrono::microseconds;
+using std::chrono::duration;
+using std::this_thread::sleep_for;
+
+struct BenchObject
+{
+	u32 id{};
+	u32 value{};
+
+	u32 GetID() const { return id; }
+};
+
+using BenchRegistry = Registry<BenchObject>;
+
+enum class ReadMode
+{
+	READ_SNAPSHOT,
+	READ_SHARED_MUTEX
+};
+
+struct BenchConfig
+{
+	u32 objects = 4096;
+	u32 span = 64;
+	u32 maxThreads = 32;
+	u32 durationMs = 500;
+	u32 publishUs = 1000;
+};
+
+//reads per second of one run
+static f64 RunBench(
+	const BenchConfig& config,
+	ReadMode mode,
+	u32 readerCount);
+
+int main(int argc, char* argv[])
+{
+	BenchConfig config{};
+	bool isValid = true;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+
+		u32* target = nullptr;
+		if (arg == "--objects") target = &config.objects;
+		else if (arg == "--span") target = &config.span;
+		else if (arg == "--max-threads") target = &config.maxThreads;
+		else if (arg == "--duration") target = &config.durationMs;
+		else if (arg == "--publish") target = &config.publishUs;
+
+		if (!target
+			|| i + 1 >= argc)
+		{
+			isValid = false;
+			break;
+		}
+
+		try { *target = scast<u32>(stoul(argv[++i])); }
+		catch (...) { isValid = false; }
+	}
+
+	if (!isValid
+		|| config.objects == 0
+		|| config.span == 0
+		|| config.span > config.objects
+		|| config.maxThreads == 0
+		|| config.durationMs == 0)
+	{
+		Log::Print(
+			"usage: registry-bench [--objects N] [--span N] [--max-threads N] [--duration N] [--publish N]",
+			"REGISTRY_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	Log::Print(
+		to_string(config.objects) + " objects, " + to_string(config.span) + " per read, writer change every "
+		+ to_string(config.publishUs) + " us, " + to_string(thread::hardware_concurrency()) + " hardware threads",
+		"REGISTRY_BENCH",
+		LogType::LOG_INFO);
+
+	for (u32 readers = 1; readers <= config.maxThreads; readers *= 2)
+	{
+		f64 snapshotRate = RunBench(config, ReadMode::READ_SNAPSHOT, readers);
+		f64 lockedRate = RunBench(config, ReadMode::READ_SHARED_MUTEX, readers);
+
+		ostringstream oss{};
+		oss << fixed << setprecision(2)
+			<< readers << " readers"
+			<< " | snapshot " << snapshotRate / 1'000'000.0 << " M reads/s"
+			<< " | shared_mutex " << lockedRate / 1'000'000.0 << " M reads/s"
+			<< " | " << snapshotRate / lockedRate << "x";
+
+		Log::Print(oss.str(), "REGISTRY_BENCH", LogType::LOG_INFO);
+	}
+
+	return 0;
+}
+
+f64 RunBench(
+	const BenchConfig& config,
+	ReadMode mode,
+	u32 readerCount)
+{
+	BenchRegistry::RemoveAllContent();
+
+	shared_mutex lockedMutex{};
+	vector<unique_ptr<BenchObject>> lockedContent{};
+
+	u32 nextID = 1;
+	for (u32 i = 0; i < config.objects; ++i, ++nextID)
+	{
+		if (mode == ReadMode::READ_SNAPSHOT) BenchRegistry::AddContent(nextID, make_unique<BenchObject>(BenchObject{ nextID, nextID }));
+		else lockedContent.push_back(make_unique<BenchObject>(BenchObject{ nextID, nextID }));
+	}
+
+	if (mode == ReadMode::READ_SNAPSHOT) BenchRegistry::PublishSnapshot();
+
+	atomic<bool> isStopping{};
+	atomic<u64> totalReads{};
+	atomic<u64> checksum{};
+
+	vector<thread> readers{};
+	readers.reserve(readerCount);
+
+	for (u32 r = 0; r < readerCount; ++r)
+	{
+		readers.emplace_back([&, r]()
+			{
+				u32 state = 0x9E3779B9u * (r + 1);
+				u64 reads{};
+				u64 sum{};
+
+				while (!isStopping.load(std::memory_order_relaxed))
+				{
+					//xorshift picks where the span starts
+					state ^= state << 13;
+					state ^= state >> 17;
+					state ^= state << 5;
+
+					if (mode == ReadMode::READ_SNAPSHOT)
+					{
+						auto view = BenchRegistry::ReadSnapshot();
+
+						size_t start = state % (view.size() - config.span + 1);
+						for (size_t i = start; i < start + config.span; ++i) sum += view[i]->value;
+					}
+					else
+					{
+						shared_lock<shared_mutex> lock(lockedMutex);
+
+						size_t start = state % (lockedContent.size() - config.span + 1);
+						for (size_t i = start; i < start + config.span; ++i) sum += lockedContent[i]->value;
+					}
+
+					++reads;
+				}
+
+				totalReads.fetch_add(reads);
+				checksum.fetch_add(sum);
+			});
+	}
+
+	//writer replaces the oldest object so the list keeps its size
+	thread writer([&]()
+		{
+			while (!isStopping.load(std::memory_order_relaxed))
+			{
+				if (mode == ReadMode::READ_SNAPSHOT)
+				{
+					BenchRegistry::RemoveContent(BenchRegistry::runtimeContent.front());
+					BenchRegistry::AddContent(nextID, make_unique<BenchObject>(BenchObject{ nextID, nextID }));
+					BenchRegistry::PublishSnapshot();
+				}
+				else
+				{
+					unique_lock<shared_mutex> lock(lockedMutex);
+
+					lockedContent.erase(lockedContent.begin());
+					lockedContent.push_back(make_unique<BenchObject>(BenchObject{ nextID, nextID }));
+				}
+
+				++nextID;
+
+				if (config.publishUs > 0) sleep_for(microseconds(config.publishUs));
+			}
+		});
+
+	auto start = steady_clock::now();
+	sleep_for(milliseconds(config.durationMs));
+	isStopping.store(true);
+
+	for (thread& reader : readers) reader.join();
+	writer.join();
+
+	f64 seconds = duration<f64>(steady_clock::now() - start).count();
+
+	//keeps the reads from being optimized away
+	if (checksum.load() == 0) Log::Print("empty checksum", "REGISTRY_BENCH", LogType::LOG_WARNING);
+
+	return scast<f64>(totalReads.load()) / seconds;
+}
@@ -0,0 +1,267 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  scene-snapshot-bench [--objects N] [--runs N] [--out PATH]
+//
+//  --objects N - model records, defaults to 100000
+//  --runs N    - save and load passes, the fastest one is reported, defaults to 5
+//  --out PATH  - snapshot file, defaults to bench_scene.ksn in the working directory
+//
+//runs without a window or gl context, fills a snapshot with synthetic models,
+//128 lights and a camera, then reports:
+//  save  - SceneSnapshot::Write, one buffer, one write and a rename
+//  open  - SceneSnapshotReader::Open, mapping, bounds checks and the content hash
+//  build - names and transforms of every record copied out into runtime objects
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "gameobject/scene_snapshot.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec3;
+using KalaHeaders::KalaMath::quat;
+
+using GameTest::GameObject::SceneSnapshot;
+using GameTest::GameObject::SceneSnapshotReader;
+using GameTest::GameObject::SceneSnapshotData;
+using GameTest::GameObject::SceneModelRecord;
+using GameTest::GameObject::SceneLightRecord;
+using GameTest::GameObject::SceneCameraRecord;
+using GameTest::GameObject::KSN_MODEL_FLAG_CAN_UPDATE;
+
+using std::string;
+using std::to_string;
+using std::vector;
+using std::ostringstream;
+using std::fixed;
+using std::setprecision;
+using std::stoul;
+using std::min;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+using std::filesystem::path;
+using std::filesystem::current_path;
+using std::filesystem::file_size;
+using std::filesystem::remove;
+
+//what a restored model needs before it is handed to the gl side
+struct BenchObject
+{
+	string name{};
+	u64 assetHash{};
+	vec3 pos{};
+	quat rot{};
+	vec3 size{};
+};
+
+static void FillSnapshot(
+	SceneSnapshotData& data,
+	u32 objectCount);
+
+static f64 GetMilliseconds(steady_clock::time_point start);
+
+int main(int argc, char* argv[])
+{
+	u32 objects = 100000;
+	u32 runs = 5;
+	path outPath = current_path() / "bench_scene.ksn";
+	bool isValid = true;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+
+		if (i + 1 >= argc)
+		{
+			isValid = false;
+			break;
+		}
+
+		if (arg == "--out")
+		{
+			outPath = argv[++i];
+			continue;
+		}
+
+		u32* target = nullptr;
+		if (arg == "--objects") target = &objects;
+		else if (arg == "--runs") target = &runs;
+
+		if (!target)
+		{
+			isValid = false;
+			break;
+		}
+
+		try { *target = scast<u32>(stoul(argv[++i])); }
+		catch (...) { isValid = false; }
+	}
+
+	if (!isValid
+		|| runs == 0)
+	{
+		Log::Print(
+			"usage: scene-snapshot-bench [--objects N] [--runs N] [--out PATH]",
+			"SNAPSHOT_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	SceneSnapshotData data{};
+	FillSnapshot(data, objects);
+
+	f64 bestSave = 1e30;
+	f64 bestOpen = 1e30;
+	f64 bestBuild = 1e30;
+
+	vector<BenchObject> restored{};
+
+	for (u32 r = 0; r < runs; ++r)
+	{
+		auto saveStart = steady_clock::now();
+		string result = SceneSnapshot::Write(outPath, data);
+		bestSave = min(bestSave, GetMilliseconds(saveStart));
+
+		if (!result.empty())
+		{
+			Log::Print(result, "SNAPSHOT_BENCH", LogType::LOG_ERROR, 2);
+			return 1;
+		}
+
+		restored.clear();
+
+		auto openStart = steady_clock::now();
+
+		SceneSnapshotReader reader{};
+		result = reader.Open(outPath);
+		bestOpen = min(bestOpen, GetMilliseconds(openStart));
+
+		if (!result.empty())
+		{
+			Log::Print(result, "SNAPSHOT_BENCH", LogType::LOG_ERROR, 2);
+			return 1;
+		}
+
+		auto buildStart = steady_clock::now();
+
+		u32 count = reader.GetHeader().modelCount;
+		const SceneModelRecord* records = reader.GetModels();
+
+		restored.resize(count);
+		for (u32 i = 0; i < count; ++i)
+		{
+			const SceneModelRecord& record = records[i];
+			BenchObject& object = restored[i];
+
+			object.name = reader.GetString(record.nameOffset, record.nameLength);
+			object.assetHash = record.assetHash;
+
+			const auto& t = record.transform;
+			object.pos = vec3(t.pos[2][0], t.pos[2][1], t.pos[2][2]);
+			object.rot = quat(t.rot[2]);
+			object.size = vec3(t.size[2][0], t.size[2][1], t.size[2][2]);
+		}
+
+		bestBuild = min(bestBuild, GetMilliseconds(buildStart));
+	}
+
+	u64 bytes = file_size(outPath);
+	remove(outPath);
+
+	ostringstream oss{};
+	oss << fixed << setprecision(2)
+		<< objects << " models, " << data.lights.size() << " lights, "
+		<< bytes / (1024.0 * 1024.0) << " MB"
+		<< " | save " << bestSave << " ms"
+		<< " | open " << bestOpen << " ms"
+		<< " | build " << bestBuild << " ms"
+		<< " | load total " << bestOpen + bestBuild << " ms";
+
+	Log::Print(oss.str(), "SNAPSHOT_BENCH", LogType::LOG_INFO);
+
+	//keeps the restored objects from being optimized away
+	if (!restored.empty()
+		&& restored.back().assetHash == 0)
+	{
+		Log::Print("empty asset hash", "SNAPSHOT_BENCH", LogType::LOG_WARNING);
+	}
+
+	return 0;
+}
+
+void FillSnapshot(
+	SceneSnapshotData& data,
+	u32 objectCount)
+{
+	data.models.resize(objectCount);
+	data.lights.resize(128);
+	data.cameras.resize(1);
+
+	for (u32 i = 0; i < objectCount; ++i)
+	{
+		SceneModelRecord& record = data.models[i];
+
+		string name = "model_" + to_string(i);
+		record.nameOffset = data.AddString(name);
+		record.nameLength = scast<u32>(name.size());
+
+		//a few hundred distinct meshes shared by every object
+		record.assetHash = 0x9E3779B97F4A7C15ULL * ((i % 397) + 1);
+		record.flags = KSN_MODEL_FLAG_CAN_UPDATE;
+		record.opacity = 1.0f;
+
+		for (u32 k = 0; k < 3; ++k)
+		{
+			record.diffuseColor[k] = 1.0f;
+
+			record.transform.pos[k][0] = scast<f32>(i % 1000);
+			record.transform.pos[k][1] = 0.0f;
+			record.transform.pos[k][2] = scast<f32>(i / 1000);
+
+			record.transform.rot[k][0] = 1.0f;
+
+			record.transform.size[k][0] = 1.0f;
+			record.transform.size[k][1] = 1.0f;
+			record.transform.size[k][2] = 1.0f;
+		}
+	}
+
+	for (size_t i = 0; i < data.lights.size(); ++i)
+	{
+		SceneLightRecord& record = data.lights[i];
+
+		string name = "light_" + to_string(i);
+		record.nameOffset = data.AddString(name);
+		record.nameLength = scast<u32>(name.size());
+		record.debugOpacity = 1.0f;
+	}
+
+	SceneCameraRecord& camera = data.cameras[0];
+	camera.nameOffset = data.AddString("main");
+	camera.nameLength = 4;
+	camera.fov = 90.0f;
+	camera.speed = 5.0f;
+	camera.nearClip = 0.001f;
+	camera.farClip = 512.0f;
+	camera.sensitivity = 0.1f;
+}
+
+f64 GetMilliseconds(steady_clock::time_point start)
+{
+	return duration<f64, std::milli>(steady_clock::now() - start).count();
+}
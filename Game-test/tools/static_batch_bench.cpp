@@ -0,0 +1,258 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  static-batch-bench [--models N] [--materials N] [--area F]
+//
+//  --models N    - static props scattered over the level, defaults to 20000
+//  --materials N - distinct materials shared by the props, defaults to 8
+//  --area F      - edge length of the square level in world units, defaults to 512
+//
+//runs StaticBatchPlan::Plan without a window or gl context, checks that every batch
+//holds one material in one cell under the vertex limit and that no prop is batched twice,
+//then reports the draw calls before and after batching and how long planning took
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+#include "KalaHeaders/log_utils.hpp"
+#include "KalaHeaders/math_utils.hpp"
+
+#include "graphics/static_batch_plan.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+using KalaHeaders::KalaMath::vec3;
+
+using GameTest::Graphics::StaticBatchSource;
+using GameTest::Graphics::StaticBatchPlan;
+using GameTest::Graphics::STATIC_BATCH_CHUNK_SIZE;
+using GameTest::Graphics::STATIC_BATCH_MAX_VERTICES;
+
+using std::string;
+using std::vector;
+using std::ostringstream;
+using std::fixed;
+using std::setprecision;
+using std::stoul;
+using std::stof;
+using std::to_string;
+using std::floor;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+//reports the first few broken invariants and returns false if any were found
+static bool ValidatePlan(
+	const vector<StaticBatchSource>& sources,
+	const vector<vector<u32>>& batches);
+
+static f64 GetSeconds(steady_clock::time_point start);
+
+int main(int argc, char* argv[])
+{
+	u32 modelCount = 20000;
+	u32 materialCount = 8;
+	f32 area = 512.0f;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+
+		if (arg == "--models"
+			&& i + 1 < argc)
+		{
+			try { modelCount = scast<u32>(stoul(argv[++i])); }
+			catch (...) { modelCount = 0; }
+		}
+		else if (arg == "--materials"
+			&& i + 1 < argc)
+		{
+			try { materialCount = scast<u32>(stoul(argv[++i])); }
+			catch (...) { materialCount = 0; }
+		}
+		else if (arg == "--area"
+			&& i + 1 < argc)
+		{
+			try { area = stof(argv[++i]); }
+			catch (...) { area = 0.0f; }
+		}
+		else modelCount = 0;
+	}
+
+	if (modelCount == 0
+		|| materialCount == 0
+		|| !(area > 0.0f))
+	{
+		Log::Print(
+			"usage: static-batch-bench [--models N] [--materials N] [--area F]",
+			"STATIC_BATCH_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	//same seed every run so the draw counts can be compared between builds
+	u64 state = 0x9E3779B97F4A7C15ULL;
+	auto Next = [&state]()
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return scast<u32>(state >> 32);
+		};
+	auto NextFloat = [&Next]() { return scast<f32>(Next() >> 8) / scast<f32>(1u << 24); };
+
+	//props sit on the ground with a few stacked higher up, between 24 and 4k vertices each
+	vector<StaticBatchSource> sources(modelCount);
+	for (StaticBatchSource& source : sources)
+	{
+		source.material = Next() % materialCount;
+		source.worldCenter = vec3(
+			NextFloat() * area,
+			NextFloat() * 8.0f,
+			NextFloat() * area);
+		source.vertexCount = 24 + Next() % 4096;
+	}
+
+	auto planStart = steady_clock::now();
+	vector<vector<u32>> batches = StaticBatchPlan::Plan(sources);
+	f64 planSeconds = GetSeconds(planStart);
+
+	if (!ValidatePlan(sources, batches)) return 1;
+
+	size_t batchedModels{};
+	for (const vector<u32>& batch : batches)
+	{
+		batchedModels += batch.size();
+	}
+
+	size_t drawsBefore = sources.size();
+	size_t drawsAfter = sources.size() - batchedModels + batches.size();
+
+	{
+		ostringstream oss{};
+		oss << fixed << setprecision(1)
+			<< modelCount << " models, " << materialCount << " materials, "
+			<< area << " units wide -> " << batches.size() << " batches holding "
+			<< batchedModels << " models"
+			<< " | draws " << drawsBefore << " -> " << drawsAfter
+			<< " (" << 100.0 * drawsAfter / drawsBefore << "%)"
+			<< " | plan " << setprecision(3) << planSeconds * 1000.0 << " ms";
+
+		Log::Print(oss.str(), "STATIC_BATCH_BENCH", LogType::LOG_INFO);
+	}
+
+	//with more models than material and cell combinations some have to share a batch
+	f64 cellsPerSide = floor(area / STATIC_BATCH_CHUNK_SIZE) + 1.0;
+	if (modelCount > cellsPerSide * cellsPerSide * materialCount
+		&& drawsAfter >= drawsBefore)
+	{
+		Log::Print(
+			"Batching did not reduce the draw count!",
+			"STATIC_BATCH_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	return 0;
+}
+
+bool ValidatePlan(
+	const vector<StaticBatchSource>& sources,
+	const vector<vector<u32>>& batches)
+{
+	u32 failures{};
+
+	auto Fail = [&failures](const string& message)
+		{
+			if (++failures > 8) return;
+
+			Log::Print(
+				message,
+				"STATIC_BATCH_BENCH",
+				LogType::LOG_ERROR,
+				2);
+		};
+
+	auto CellOf = [](const vec3& center, i32 axis)
+		{
+			f32 value = axis == 0 ? center.x : axis == 1 ? center.y : center.z;
+			return scast<i32>(floor(value / STATIC_BATCH_CHUNK_SIZE));
+		};
+
+	vector<u8> isBatched(sources.size());
+
+	for (size_t b = 0; b < batches.size(); ++b)
+	{
+		const vector<u32>& batch = batches[b];
+		string name = "batch " + to_string(b);
+
+		if (batch.size() < 2)
+		{
+			Fail(name + " has " + to_string(batch.size()) + " models, one model is already a single draw!");
+			continue;
+		}
+
+		const StaticBatchSource& first = sources[batch[0]];
+		u64 vertexCount{};
+
+		for (u32 index : batch)
+		{
+			if (index >= sources.size())
+			{
+				Fail(name + " points past the source list!");
+				continue;
+			}
+
+			if (isBatched[index]) Fail("model " + to_string(index) + " is in more than one batch!");
+			isBatched[index] = 1;
+
+			const StaticBatchSource& source = sources[index];
+			vertexCount += source.vertexCount;
+
+			if (source.material != first.material)
+			{
+				Fail(name + " mixes materials " + to_string(first.material) + " and " + to_string(source.material) + "!");
+			}
+
+			for (i32 axis = 0; axis < 3; ++axis)
+			{
+				if (CellOf(source.worldCenter, axis) != CellOf(first.worldCenter, axis))
+				{
+					Fail(name + " spans more than one cell!");
+					break;
+				}
+			}
+		}
+
+		if (vertexCount > STATIC_BATCH_MAX_VERTICES)
+		{
+			Fail(name + " holds " + to_string(vertexCount) + " vertices, over the limit of " + to_string(STATIC_BATCH_MAX_VERTICES) + "!");
+		}
+	}
+
+	if (failures > 0)
+	{
+		Log::Print(
+			to_string(failures) + " batch plan checks failed!",
+			"STATIC_BATCH_BENCH",
+			LogType::LOG_ERROR,
+			2);
+
+		return false;
+	}
+
+	return true;
+}
+
+f64 GetSeconds(steady_clock::time_point start)
+{
+	return duration<f64>(steady_clock::now() - start).count();
+}
@@ -0,0 +1,496 @@
+//Copyright(C) 2025 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//usage:
+//  stream-ring-test
+//
+//runs StreamRing against a stub gl table, no window or gl context is needed, and checks:
+//  wrap     - persistent regions are handed out in order and wrap back to the first one
+//  fences   - a region is fenced only when used, busy fences are waited on and counted as stalls,
+//             failed waits still release the fence and no more fences than regions are ever alive
+//  orphan   - the single region is orphaned every frame and Flush uploads only unflushed bytes
+//  auto     - STREAM_AUTO picks persistent only with buffer storage support
+//  shutdown - fences, the mapping and the buffer are all released
+//exits with 1 if any check fails
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "KalaHeaders/log_utils.hpp"
+
+#include "graphics/stream_ring.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using GameTest::Graphics::StreamRing;
+using GameTest::Graphics::StreamRingGL;
+using GameTest::Graphics::StreamRingMode;
+using GameTest::Graphics::StreamAllocation;
+using GameTest::Graphics::STREAM_RING_MAX_FRAMES;
+
+using std::string;
+using std::vector;
+using std::to_string;
+using std::memset;
+using std::memcpy;
+
+//what the fake gpu knows about one fence
+struct StubFence
+{
+	bool isAlive{};
+	//timeouts returned before the fence signals
+	u32 busyWaits{};
+	bool failsWait{};
+};
+
+//state of the fake context, reset by every test
+struct StubGL
+{
+	u32 nextBuffer = 1;
+	u32 liveBuffers{};
+	u32 boundBuffer{};
+
+	vector<u8> storage{};
+	bool isMapped{};
+	u32 orphanCount{};
+
+	//byte ranges uploaded with glBufferSubData
+	vector<size_t> uploadOffsets{};
+	vector<size_t> uploadSizes{};
+
+	GLint uniformAlignment = 256;
+
+	vector<StubFence> fences{};
+	u32 liveFences{};
+	u32 peakLiveFences{};
+	u32 waitCount{};
+	u32 flushWaitCount{};
+
+	//busyWaits given to every new fence
+	u32 nextBusyWaits{};
+	bool nextFailsWait{};
+};
+
+static StubGL stub{};
+
+static u32 failures{};
+
+static void Check(
+	bool condition,
+	const string& what);
+
+//GLsync handles are the fence index + 1 so null stays invalid
+static StubFence& GetFence(GLsync sync);
+
+static void APIENTRY StubGenBuffers(GLsizei n, GLuint* buffers);
+static void APIENTRY StubDeleteBuffers(GLsizei n, const GLuint* buffers);
+static void APIENTRY StubBindBuffer(GLenum target, GLuint buffer);
+static void APIENTRY StubBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+static void APIENTRY StubBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+static void APIENTRY StubBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+static void* APIENTRY StubMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+static GLboolean APIENTRY StubUnmapBuffer(GLenum target);
+static void APIENTRY StubGetIntegerv(GLenum pname, GLint* data);
+static GLsync APIENTRY StubFenceSync(GLenum condition, GLbitfield flags);
+static GLenum APIENTRY StubClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+static void APIENTRY StubDeleteSync(GLsync sync);
+
+static StreamRingGL CreateStubTable(bool hasBufferStorage);
+
+static void TestWrap();
+static void TestFences();
+static void TestOrphan();
+static void TestAuto();
+static void TestShutdown();
+
+int main()
+{
+	TestWrap();
+	TestFences();
+	TestOrphan();
+	TestAuto();
+	TestShutdown();
+
+	if (failures > 0)
+	{
+		Log::Print(
+			to_string(failures) + " stream ring checks failed!",
+			"STREAM_RING_TEST",
+			LogType::LOG_ERROR,
+			2);
+
+		return 1;
+	}
+
+	Log::Print(
+		"all stream ring checks passed",
+		"STREAM_RING_TEST",
+		LogType::LOG_SUCCESS);
+
+	return 0;
+}
+
+void TestWrap()
+{
+	stub = {};
+
+	StreamRing ring{};
+	string result = ring.Initialize(
+		1000,
+		3,
+		StreamRingMode::STREAM_PERSISTENT,
+		CreateStubTable(true));
+
+	Check(result.empty(), "wrap: persistent ring initializes, " + result);
+	Check(ring.IsPersistent(), "wrap: ring is persistent");
+	Check(ring.GetRegionSize() == 1024, "wrap: region size is rounded up to the region alignment");
+	Check(stub.storage.size() == 3 * 1024, "wrap: storage holds every region");
+
+	//regions go 0, 1, 2 and back to 0
+	for (u32 frame = 0; frame < 7; ++frame)
+	{
+		ring.BeginFrame();
+
+		StreamAllocation a = ring.Allocate(100);
+		StreamAllocation b = ring.Allocate(8, 64);
+
+		size_t regionStart = (frame % 3) * 1024;
+
+		Check(a.IsValid() && b.IsValid(), "wrap: allocations fit in frame " + to_string(frame));
+		Check(a.offset == regionStart, "wrap: frame " + to_string(frame) + " starts at its region");
+		Check(b.offset == regionStart + 128, "wrap: second allocation is aligned inside the region");
+		Check(a.data == stub.storage.data() + a.offset, "wrap: cpu pointer matches the buffer offset");
+
+		memset(a.data, scast<int>(frame), a.size);
+
+		ring.EndFrame();
+	}
+
+	ring.BeginFrame();
+
+	StreamAllocation full = ring.Allocate(1024);
+	StreamAllocation over = ring.Allocate(1);
+
+	Check(full.IsValid(), "wrap: a whole region can be allocated");
+	Check(!over.IsValid(), "wrap: allocating past the region fails");
+	Check(ring.GetStats().overflowCount == 1, "wrap: overflow is counted");
+
+	ring.EndFrame();
+	ring.Shutdown();
+}
+
+void TestFences()
+{
+	stub = {};
+
+	StreamRing ring{};
+	ring.Initialize(
+		256,
+		2,
+		StreamRingMode::STREAM_PERSISTENT,
+		CreateStubTable(true));
+
+	//frame 0 and 1 write, frame 2 leaves its region unused
+	ring.BeginFrame();
+	ring.Allocate(16);
+	ring.EndFrame();
+
+	ring.BeginFrame();
+	ring.Allocate(16);
+	ring.EndFrame();
+
+	Check(stub.liveFences == 2, "fences: every used region is fenced");
+
+	//region 0 is reused, its fence already signaled
+	ring.BeginFrame();
+	Check(ring.GetStats().stallCount == 0, "fences: a signaled fence is not a stall");
+	Check(stub.liveFences == 1, "fences: the reused region's fence is deleted");
+	ring.EndFrame();
+
+	Check(stub.liveFences == 1, "fences: an unused region is not fenced");
+
+	//region 1 is reused while the gpu still needs three waits for it
+	stub.nextBusyWaits = 3;
+
+	ring.BeginFrame();
+	ring.Allocate(16);
+	ring.EndFrame();
+
+	ring.BeginFrame();
+	ring.Allocate(16);
+	ring.EndFrame();
+
+	stub.waitCount = 0;
+	stub.flushWaitCount = 0;
+
+	ring.BeginFrame();
+	Check(ring.GetStats().stallCount == 1, "fences: a busy fence counts one stall");
+	Check(stub.waitCount == 4, "fences: the ring waits until the fence signals");
+	Check(stub.flushWaitCount == 3, "fences: blocking waits flush the command stream");
+	ring.EndFrame();
+
+	//a failed wait still releases the fence instead of leaking it
+	stub.nextBusyWaits = 0;
+	stub.nextFailsWait = true;
+
+	ring.BeginFrame();
+	ring.Allocate(16);
+	ring.EndFrame();
+
+	u32 liveBefore = stub.liveFences;
+
+	ring.BeginFrame();
+	ring.BeginFrame();
+	Check(stub.liveFences < liveBefore, "fences: a failed wait deletes the fence");
+
+	Check(stub.peakLiveFences <= 2, "fences: no more fences than regions are alive");
+
+	ring.EndFrame();
+	ring.Shutdown();
+}
+
+void TestOrphan()
+{
+	stub = {};
+
+	StreamRing ring{};
+	ring.Initialize(
+		512,
+		3,
+		StreamRingMode::STREAM_ORPHAN,
+		CreateStubTable(true));
+
+	Check(!ring.IsPersistent(), "orphan: ring is not persistent");
+	Check(ring.GetFramesInFlight() == 1, "orphan: one region is enough");
+	Check(!stub.isMapped, "orphan: nothing is mapped");
+
+	u32 orphansBefore = stub.orphanCount;
+
+	for (u32 frame = 0; frame < 4; ++frame)
+	{
+		ring.BeginFrame();
+
+		stub.uploadOffsets.clear();
+		stub.uploadSizes.clear();
+
+		StreamAllocation a = ring.Allocate(32);
+		memset(a.data, 0xA0 + scast<int>(frame), a.size);
+		Check(a.offset == 0, "orphan: every frame starts at offset 0");
+
+		ring.Flush();
+
+		StreamAllocation b = ring.Allocate(48, 16);
+		memset(b.data, 0xB0 + scast<int>(frame), b.size);
+
+		ring.EndFrame();
+
+		Check(stub.uploadOffsets.size() == 2, "orphan: flush and end of frame upload once each");
+		Check(stub.uploadOffsets.size() == 2
+			&& stub.uploadOffsets[0] == 0
+			&& stub.uploadSizes[0] == 32
+			&& stub.uploadOffsets[1] == 32
+			&& stub.uploadSizes[1] == 48,
+			"orphan: only unflushed bytes are uploaded");
+		Check(stub.storage[0] == 0xA0 + frame
+			&& stub.storage[32] == 0xB0 + frame,
+			"orphan: uploaded bytes reach the buffer");
+	}
+
+	Check(stub.orphanCount - orphansBefore == 4, "orphan: the region is orphaned every frame");
+
+	ring.Shutdown();
+}
+
+void TestAuto()
+{
+	stub = {};
+
+	StreamRing persistent{};
+	persistent.Initialize(256, 3, StreamRingMode::STREAM_AUTO, CreateStubTable(true));
+	Check(persistent.IsPersistent(), "auto: buffer storage support picks persistent");
+	persistent.Shutdown();
+
+	StreamRing orphan{};
+	orphan.Initialize(256, 3, StreamRingMode::STREAM_AUTO, CreateStubTable(false));
+	Check(!orphan.IsPersistent(), "auto: no buffer storage support picks orphan");
+	orphan.Shutdown();
+
+	//the uniform alignment of the context sets the region alignment when it is larger
+	stub.uniformAlignment = 1024;
+
+	StreamRing aligned{};
+	aligned.Initialize(300, 2, StreamRingMode::STREAM_PERSISTENT, CreateStubTable(true));
+	Check(aligned.GetRegionSize() == 1024, "auto: regions follow the uniform offset alignment");
+	aligned.Shutdown();
+}
+
+void TestShutdown()
+{
+	stub = {};
+
+	StreamRing ring{};
+	ring.Initialize(256, 3, StreamRingMode::STREAM_PERSISTENT, CreateStubTable(true));
+
+	for (u32 frame = 0; frame < 3; ++frame)
+	{
+		ring.BeginFrame();
+		ring.Allocate(16);
+		ring.EndFrame();
+	}
+
+	ring.Shutdown();
+
+	Check(stub.liveFences == 0, "shutdown: every fence is deleted");
+	Check(!stub.isMapped, "shutdown: the mapping is released");
+	Check(stub.liveBuffers == 0, "shutdown: the buffer is deleted");
+	Check(!ring.IsInitialized(), "shutdown: ring can be initialized again");
+}
+
+void Check(
+	bool condition,
+	const string& what)
+{
+	if (condition) return;
+
+	++failures;
+
+	Log::Print(
+		what,
+		"STREAM_RING_TEST",
+		LogType::LOG_ERROR,
+		2);
+}
+
+StubFence& GetFence(GLsync sync)
+{
+	return stub.fences[rcast<uintptr_t>(sync) - 1];
+}
+
+void APIENTRY StubGenBuffers(GLsizei n, GLuint* buffers)
+{
+	for (GLsizei i = 0; i < n; ++i)
+	{
+		buffers[i] = stub.nextBuffer++;
+		++stub.liveBuffers;
+	}
+}
+
+void APIENTRY StubDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	for (GLsizei i = 0; i < n; ++i)
+	{
+		if (buffers[i] != 0) --stub.liveBuffers;
+	}
+}
+
+void APIENTRY StubBindBuffer(GLenum, GLuint buffer) { stub.boundBuffer = buffer; }
+
+void APIENTRY StubBufferData(GLenum, GLsizeiptr size, const void*, GLenum)
+{
+	//fresh storage every call, like a driver orphaning the old one
+	stub.storage.assign(scast<size_t>(size), 0);
+	++stub.orphanCount;
+}
+
+void APIENTRY StubBufferSubData(GLenum, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	stub.uploadOffsets.push_back(scast<size_t>(offset));
+	stub.uploadSizes.push_back(scast<size_t>(size));
+
+	memcpy(stub.storage.data() + offset, data, scast<size_t>(size));
+}
+
+void APIENTRY StubBufferStorage(GLenum, GLsizeiptr size, const void*, GLbitfield)
+{
+	stub.storage.assign(scast<size_t>(size), 0);
+}
+
+void* APIENTRY StubMapBufferRange(GLenum, GLintptr offset, GLsizeiptr, GLbitfield)
+{
+	stub.isMapped = true;
+	return stub.storage.data() + offset;
+}
+
+GLboolean APIENTRY StubUnmapBuffer(GLenum)
+{
+	stub.isMapped = false;
+	return GL_TRUE;
+}
+
+void APIENTRY StubGetIntegerv(GLenum pname, GLint* data)
+{
+	if (pname == GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT) *data = stub.uniformAlignment;
+}
+
+GLsync APIENTRY StubFenceSync(GLenum, GLbitfield)
+{
+	StubFence& fence = stub.fences.emplace_back();
+	fence.isAlive = true;
+	fence.busyWaits = stub.nextBusyWaits;
+	fence.failsWait = stub.nextFailsWait;
+
+	++stub.liveFences;
+	if (stub.liveFences > stub.peakLiveFences) stub.peakLiveFences = stub.liveFences;
+
+	return rcast<GLsync>(stub.fences.size());
+}
+
+GLenum APIENTRY StubClientWaitSync(GLsync sync, GLbitfield flags, GLuint64)
+{
+	StubFence& fence = GetFence(sync);
+
+	++stub.waitCount;
+	if (flags & GL_SYNC_FLUSH_COMMANDS_BIT) ++stub.flushWaitCount;
+
+	if (!fence.isAlive
+		|| fence.failsWait)
+	{
+		return GL_WAIT_FAILED;
+	}
+
+	if (fence.busyWaits > 0)
+	{
+		--fence.busyWaits;
+		return GL_TIMEOUT_EXPIRED;
+	}
+
+	return GL_CONDITION_SATISFIED;
+}
+
+void APIENTRY StubDeleteSync(GLsync sync)
+{
+	if (!sync) return;
+
+	StubFence& fence = GetFence(sync);
+	if (!fence.isAlive) return;
+
+	fence.isAlive = false;
+	--stub.liveFences;
+}
+
+StreamRingGL CreateStubTable(bool hasBufferStorage)
+{
+	StreamRingGL gl{};
+
+	gl.glGenBuffers = StubGenBuffers;
+	gl.glDeleteBuffers = StubDeleteBuffers;
+	gl.glBindBuffer = StubBindBuffer;
+	gl.glBufferData = StubBufferData;
+	gl.glBufferSubData = StubBufferSubData;
+	gl.glBufferStorage = StubBufferStorage;
+	gl.glMapBufferRange = StubMapBufferRange;
+	gl.glUnmapBuffer = StubUnmapBuffer;
+	gl.glGetIntegerv = StubGetIntegerv;
+
+	gl.glFenceSync = StubFenceSync;
+	gl.glClientWaitSync = StubClientWaitSync;
+	gl.glDeleteSync = StubDeleteSync;
+
+	gl.hasBufferStorage = hasBufferStorage;
+
+	return gl;
+}